@@ -142,6 +142,86 @@ void AppSettings::setDefaultImageSize(int size)
     settings.sync();
 }
 
+int AppSettings::batchSize()
+{
+    QSettings settings = getSettings();
+    return settings.value("DL/batchSize", 8).toInt();
+}
+
+void AppSettings::setBatchSize(int size)
+{
+    QSettings settings = getSettings();
+    settings.setValue("DL/batchSize", size);
+    settings.sync();
+}
+
+int AppSettings::inferenceWorkerCount()
+{
+    QSettings settings = getSettings();
+    return settings.value("DL/workerCount", 1).toInt();
+}
+
+void AppSettings::setInferenceWorkerCount(int count)
+{
+    QSettings settings = getSettings();
+    settings.setValue("DL/workerCount", count);
+    settings.sync();
+}
+
+bool AppSettings::resultCacheEnabled()
+{
+    QSettings settings = getSettings();
+    return settings.value("DL/resultCacheEnabled", true).toBool();
+}
+
+void AppSettings::setResultCacheEnabled(bool enabled)
+{
+    QSettings settings = getSettings();
+    settings.setValue("DL/resultCacheEnabled", enabled);
+    settings.sync();
+}
+
+int AppSettings::resultCacheSizeMB()
+{
+    QSettings settings = getSettings();
+    return settings.value("DL/resultCacheSizeMB", 256).toInt();
+}
+
+void AppSettings::setResultCacheSizeMB(int megabytes)
+{
+    QSettings settings = getSettings();
+    settings.setValue("DL/resultCacheSizeMB", megabytes);
+    settings.sync();
+}
+
+// ========== 图像处理设置 ==========
+
+int AppSettings::imageProcessingThreadCount()
+{
+    QSettings settings = getSettings();
+    return settings.value("ImageProcessing/threadCount", 0).toInt();
+}
+
+void AppSettings::setImageProcessingThreadCount(int count)
+{
+    QSettings settings = getSettings();
+    settings.setValue("ImageProcessing/threadCount", count);
+    settings.sync();
+}
+
+int AppSettings::undoMemoryBudgetMB()
+{
+    QSettings settings = getSettings();
+    return settings.value("ImageProcessing/undoMemoryBudgetMB", 1024).toInt();
+}
+
+void AppSettings::setUndoMemoryBudgetMB(int megabytes)
+{
+    QSettings settings = getSettings();
+    settings.setValue("ImageProcessing/undoMemoryBudgetMB", megabytes);
+    settings.sync();
+}
+
 // ========== 导出设置 ==========
 
 QString AppSettings::exportFormat()
@@ -100,6 +100,68 @@ public:
      */
     static void setDefaultImageSize(int size);
 
+    /**
+     * @brief 获取批量推理的批大小（每次前向推理的图像数）
+     */
+    static int batchSize();
+
+    /**
+     * @brief 设置批量推理的批大小
+     */
+    static void setBatchSize(int size);
+
+    /**
+     * @brief 获取推理后端进程数（进程池大小）
+     */
+    static int inferenceWorkerCount();
+
+    /**
+     * @brief 设置推理后端进程数
+     */
+    static void setInferenceWorkerCount(int count);
+
+    /**
+     * @brief 获取是否缓存推理结果
+     */
+    static bool resultCacheEnabled();
+
+    /**
+     * @brief 设置是否缓存推理结果
+     */
+    static void setResultCacheEnabled(bool enabled);
+
+    /**
+     * @brief 获取推理结果缓存的磁盘上限（MB）
+     */
+    static int resultCacheSizeMB();
+
+    /**
+     * @brief 设置推理结果缓存的磁盘上限（MB）
+     */
+    static void setResultCacheSizeMB(int megabytes);
+
+    // ========== 图像处理设置 ==========
+
+    /**
+     * @brief 获取图像处理使用的线程数（0 表示按 CPU 核数自动选择）
+     */
+    static int imageProcessingThreadCount();
+
+    /**
+     * @brief 设置图像处理使用的线程数
+     */
+    static void setImageProcessingThreadCount(int count);
+
+    /**
+     * @brief 获取所有标签页撤销历史共用的内存上限（MB），超出部分写入磁盘
+     */
+    static int undoMemoryBudgetMB();
+
+    /**
+     * @brief 设置撤销历史的内存上限（MB）
+     */
+    static void setUndoMemoryBudgetMB(int megabytes);
+
     // ========== 导出设置 ==========
 
     /**
@@ -1,120 +1,226 @@
 #include "imagecontroller.h"
 #include <QImage>
-#include <QTransform>
 
 namespace GenPreCVSystem {
 namespace Controllers {
 
 ImageController::ImageController(QObject *parent)
     : QObject(parent)
-    , m_undoStack(nullptr)
 {
 }
 
-void ImageController::setCurrentImage(const QPixmap &pixmap, Models::UndoStack *undoStack)
+void ImageController::setEditGraph(const std::shared_ptr<Utils::EditGraph> &graph,
+                                   const std::shared_ptr<Utils::ImageHistory> &history)
 {
-    m_currentPixmap = pixmap;
-    m_undoStack = undoStack;
+    m_graph = graph;
+    m_history = history;
+    m_resultPixmap = QPixmap();
+}
+
+QPixmap ImageController::currentImage()
+{
+    if (m_resultPixmap.isNull() && hasImage()) {
+        m_resultPixmap = QPixmap::fromImage(m_graph->result());
+    }
+    return m_resultPixmap;
+}
+
+QImage ImageController::renderRegion(const QRect &region, double scale)
+{
+    if (!hasImage()) {
+        return QImage();
+    }
+    return m_graph->renderForScale(region, scale);
 }
 
 void ImageController::rotateLeft()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::rotate(img, -90); },
-        "向左旋转90°"
-    );
+    appendOperation(Utils::EditOperation::rotate(-90));
 }
 
 void ImageController::rotateRight()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::rotate(img, 90); },
-        "向右旋转90°"
-    );
+    appendOperation(Utils::EditOperation::rotate(90));
 }
 
 void ImageController::flipHorizontal()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::flipHorizontal(img); },
-        "水平翻转"
-    );
+    appendOperation(Utils::EditOperation::flipHorizontal());
 }
 
 void ImageController::flipVertical()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::flipVertical(img); },
-        "垂直翻转"
-    );
+    appendOperation(Utils::EditOperation::flipVertical());
 }
 
 void ImageController::toGrayscale()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::toGrayscale(img); },
-        "已转换为灰度图"
-    );
+    appendOperation(Utils::EditOperation::grayscale());
 }
 
 void ImageController::invert()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::invert(img); },
-        "已反色"
-    );
+    appendOperation(Utils::EditOperation::invert());
 }
 
 void ImageController::blur(int radius)
 {
-    applyImageOperation(
-        [radius](const QImage &img) { return Utils::ImageProcessor::gaussianBlur(img, radius); },
-        QString("模糊处理 (半径=%1)").arg(radius)
-    );
+    appendOperation(Utils::EditOperation::gaussianBlur(radius));
 }
 
 void ImageController::sharpen(double strength)
 {
-    applyImageOperation(
-        [strength](const QImage &img) { return Utils::ImageProcessor::sharpen(img, strength); },
-        QString("锐化处理 (强度=%1)").arg(strength)
-    );
+    appendOperation(Utils::EditOperation::sharpen(strength));
 }
 
 void ImageController::edgeDetection()
 {
-    applyImageOperation(
-        [](const QImage &img) { return Utils::ImageProcessor::sobelEdgeDetection(img); },
-        "Sobel边缘检测"
-    );
+    appendOperation(Utils::EditOperation::sobelEdges());
 }
 
 void ImageController::threshold(int value)
 {
-    applyImageOperation(
-        [value](const QImage &img) { return Utils::ImageProcessor::threshold(img, value); },
-        QString("二值化 (阈值=%1)").arg(value)
-    );
+    appendOperation(Utils::EditOperation::threshold(value));
+}
+
+bool ImageController::removeGrayscale()
+{
+    return removeOperation(Utils::EditOperation::grayscale());
+}
+
+bool ImageController::removeInvert()
+{
+    return removeOperation(Utils::EditOperation::invert());
+}
+
+bool ImageController::hasGrayscale() const
+{
+    return lastIndexOf(Utils::EditOperation::grayscale().name) >= 0;
+}
+
+bool ImageController::hasInvert() const
+{
+    return lastIndexOf(Utils::EditOperation::invert().name) >= 0;
+}
+
+bool ImageController::undo()
+{
+    if (!canUndo()) {
+        emit operationFailed("没有可撤销的操作");
+        return false;
+    }
+
+    if (m_graph->canUndo()) {
+        m_graph->undo();
+    } else {
+        // 编辑链已撤销到头，继续撤销已并入原图的操作
+        QImage source = m_graph->source();
+        m_history->undo(source);
+        m_graph->setSource(source);
+    }
+    m_resultPixmap = QPixmap();
+    emit imageChanged();
+    return true;
+}
+
+bool ImageController::redo()
+{
+    if (!canRedo()) {
+        emit operationFailed("没有可重做的操作");
+        return false;
+    }
+
+    // 先恢复并入原图的操作，编辑链的重做列表在其后
+    if (m_graph->count() == 0 && m_history && m_history->canRedo()) {
+        QImage source = m_graph->source();
+        if (!m_history->redo(source)) {
+            emit operationFailed("图片已被修改，无法重做");
+            return false;
+        }
+        m_graph->setSource(source);
+    } else {
+        m_graph->redo();
+    }
+    m_resultPixmap = QPixmap();
+    emit imageChanged();
+    return true;
+}
+
+bool ImageController::canUndo() const
+{
+    return m_graph && (m_graph->canUndo() || (m_history && m_history->canUndo()));
 }
 
-void ImageController::applyImageOperation(const std::function<QImage(const QImage&)> &operation, const QString &operationName)
+bool ImageController::canRedo() const
+{
+    return m_graph && (m_graph->canRedo()
+                       || (m_graph->count() == 0 && m_history && m_history->canRedo()));
+}
+
+int ImageController::undoCount() const
+{
+    if (!m_graph) {
+        return 0;
+    }
+    return m_graph->count() + (m_history ? m_history->undoCount() : 0);
+}
+
+int ImageController::redoCount() const
+{
+    if (!m_graph) {
+        return 0;
+    }
+    return m_graph->redoCount() + (m_history ? m_history->redoCount() : 0);
+}
+
+void ImageController::appendOperation(const Utils::EditOperation &operation)
 {
     if (!hasImage()) {
         emit operationFailed("请先打开图片");
         return;
     }
 
-    // 保存状态到撤销栈
-    if (m_undoStack) {
-        m_undoStack->push(m_currentPixmap);
+    if (m_history && m_graph->count() >= MAX_OPERATIONS) {
+        // 最早的操作并入原图，并入前的原图按变化的图块记入撤销历史（同时清空其重做历史）
+        m_history->push(m_graph->foldFirst());
+    } else if (m_history) {
+        m_history->discardRedo();
+    }
+
+    // 只记录操作，结果在视图请求时计算
+    m_graph->append(operation);
+    m_resultPixmap = QPixmap();
+
+    emit imageChanged();
+}
+
+bool ImageController::removeOperation(const Utils::EditOperation &operation)
+{
+    const int index = lastIndexOf(operation.name);
+    if (index < 0) {
+        emit operationFailed(QString("没有可取消的%1操作").arg(operation.name));
+        return false;
     }
 
-    // 应用操作
-    QImage image = m_currentPixmap.toImage();
-    QImage result = operation(image);
-    m_currentPixmap = QPixmap::fromImage(result);
+    // 只有该操作及其后的节点需要重新求值
+    m_graph->remove(index);
+    m_resultPixmap = QPixmap();
+
+    emit imageChanged();
+    return true;
+}
 
-    emit imageChanged(m_currentPixmap);
+int ImageController::lastIndexOf(const QString &name) const
+{
+    if (!m_graph) {
+        return -1;
+    }
+    for (int i = m_graph->count() - 1; i >= 0; --i) {
+        if (m_graph->operation(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
 }
 
 } // namespace Controllers
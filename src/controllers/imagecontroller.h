@@ -3,9 +3,10 @@
 
 #include <QObject>
 #include <QPixmap>
+#include <memory>
 
-#include "undostack.h"
-#include "imageprocessor.h"
+#include "editgraph.h"
+#include "imagehistory.h"
 
 namespace GenPreCVSystem {
 namespace Controllers {
@@ -13,7 +14,12 @@ namespace Controllers {
 /**
  * @brief 图像处理控制器
  *
- * 管理图像的编辑操作，包括滤镜、变换等
+ * 管理图像的编辑操作，包括滤镜、变换等。编辑不直接改写图片，而是追加到当前标签页的
+ * Utils::EditGraph 中，结果在需要显示时才计算；撤销 / 重做只移动编辑链的末尾，
+ * 不保存整幅图片副本。
+ *
+ * 编辑链超过 MAX_OPERATIONS 个操作时，最早的操作并入原图，并入前的原图交给
+ * Utils::ImageHistory 按图块增量保存；编辑链撤销到头后继续从该历史撤销。
  */
 class ImageController : public QObject
 {
@@ -23,14 +29,27 @@ public:
     explicit ImageController(QObject *parent = nullptr);
 
     /**
-     * @brief 设置当前图片和撤销栈
+     * @brief 设置当前标签页的编辑链和撤销历史（切换标签页时重新设置）
+     * @param history 保存已并入原图的操作之前的原图，为空时编辑链不限长度
+     */
+    void setEditGraph(const std::shared_ptr<Utils::EditGraph> &graph,
+                      const std::shared_ptr<Utils::ImageHistory> &history = nullptr);
+
+    std::shared_ptr<Utils::EditGraph> editGraph() const { return m_graph; }
+
+    /**
+     * @brief 获取当前处理后的完整图片
+     *
+     * 首次调用时求值，编辑链改变之前重复调用直接返回缓存的 QPixmap。
      */
-    void setCurrentImage(const QPixmap &pixmap, Models::UndoStack *undoStack);
+    QPixmap currentImage();
 
     /**
-     * @brief 获取当前处理后的图片
+     * @brief 只计算可见区域
+     * @param region 原图坐标系中的区域
+     * @param scale 视图缩放比例，小于 1 时在对应的金字塔缩小层上计算
      */
-    QPixmap currentImage() const { return m_currentPixmap; }
+    QImage renderRegion(const QRect &region, double scale);
 
     // 图像变换操作
     void rotateLeft();
@@ -46,16 +65,36 @@ public:
     void edgeDetection();
     void threshold(int value = 128);
 
+    /**
+     * @brief 移除编辑链中最后一个灰度化 / 反色操作，其后的操作保留
+     *
+     * @return 编辑链中没有该操作（已撤销或已并入原图）时返回 false
+     */
+    bool removeGrayscale();
+    bool removeInvert();
+    bool hasGrayscale() const;
+    bool hasInvert() const;
+
+    // 撤销 / 重做
+    bool undo();
+    bool redo();
+    bool canUndo() const;
+    bool canRedo() const;
+    int undoCount() const;
+    int redoCount() const;
+
     /**
      * @brief 检查是否有当前图片
      */
-    bool hasImage() const { return !m_currentPixmap.isNull(); }
+    bool hasImage() const { return m_graph && !m_graph->source().isNull(); }
+
+    static constexpr int MAX_OPERATIONS = 16;  ///< 编辑链保留的操作数
 
 signals:
     /**
-     * @brief 图片已改变信号
+     * @brief 编辑结果已改变信号（视图按需调用 currentImage() 或 renderRegion()）
      */
-    void imageChanged(const QPixmap &newPixmap);
+    void imageChanged();
 
     /**
      * @brief 操作失败信号
@@ -63,10 +102,13 @@ signals:
     void operationFailed(const QString &message);
 
 private:
-    void applyImageOperation(const std::function<QImage(const QImage&)> &operation, const QString &operationName);
+    void appendOperation(const Utils::EditOperation &operation);
+    bool removeOperation(const Utils::EditOperation &operation);
+    int lastIndexOf(const QString &name) const;
 
-    QPixmap m_currentPixmap;
-    Models::UndoStack *m_undoStack;
+    std::shared_ptr<Utils::EditGraph> m_graph;
+    std::shared_ptr<Utils::ImageHistory> m_history;
+    QPixmap m_resultPixmap;  ///< 完整结果的缓存，编辑链改变时清空
 };
 
 } // namespace Controllers
@@ -505,6 +505,12 @@ QWidget* ParameterPanelFactory::createImageEnhancementParams()
     sharpLayout->addLayout(sharpControl);
     layout->addWidget(sharpGroup);
 
+    // 实时预览：参数变化时在缩小的图像上处理并显示在当前视图中
+    QCheckBox *livePreviewCheck = new QCheckBox("实时预览", widget);
+    livePreviewCheck->setObjectName("chkLivePreview");
+    livePreviewCheck->setChecked(true);
+    layout->addWidget(livePreviewCheck);
+
     // 状态标签
     QLabel *statusLabel = new QLabel("状态: 就绪", widget);
     statusLabel->setObjectName("lblEnhanceStatus");
@@ -559,6 +565,12 @@ QWidget* ParameterPanelFactory::createImageDenoisingParams()
 
     layout->addWidget(paramGroup);
 
+    // 实时预览：参数变化时在缩小的图像上处理并显示在当前视图中
+    QCheckBox *livePreviewCheck = new QCheckBox("实时预览", widget);
+    livePreviewCheck->setObjectName("chkLivePreview");
+    livePreviewCheck->setChecked(true);
+    layout->addWidget(livePreviewCheck);
+
     // 状态标签
     QLabel *statusLabel = new QLabel("状态: 就绪", widget);
     statusLabel->setObjectName("lblDenoiseStatus");
@@ -714,6 +726,12 @@ QWidget* ParameterPanelFactory::createEdgeDetectionParams()
 
     layout->addWidget(sobelGroup);
 
+    // 实时预览：参数变化时在缩小的图像上处理并显示在当前视图中
+    QCheckBox *livePreviewCheck = new QCheckBox("实时预览", widget);
+    livePreviewCheck->setObjectName("chkLivePreview");
+    livePreviewCheck->setChecked(true);
+    layout->addWidget(livePreviewCheck);
+
     // 状态标签
     QLabel *statusLabel = new QLabel("状态: 就绪", widget);
     statusLabel->setObjectName("lblEdgeStatus");
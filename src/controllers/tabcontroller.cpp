@@ -1,4 +1,5 @@
 #include "tabcontroller.h"
+#include "dlservice.h"
 #include <QFileInfo>
 #include <QMessageBox>
 
@@ -16,18 +17,16 @@ TabController::TabController(QTabWidget *tabWidget, QObject *parent)
 
 TabController::~TabController()
 {
-    // m_tabData 中的 TabData 是值类型，会自动清理
+    // m_tabData 中的 TabData 是值类型，会自动清理；后台解码不再需要
+    for (const Models::TabData &tabData : m_tabData) {
+        if (tabData.loading) {
+            *tabData.loading = true;
+        }
+    }
 }
 
 bool TabController::loadImage(const QString &filePath)
 {
-    QPixmap pixmap(filePath);
-
-    if (pixmap.isNull()) {
-        emit imageLoaded(filePath, QPixmap());
-        return false;
-    }
-
     QFileInfo fileInfo(filePath);
     QString fileName = fileInfo.fileName();
 
@@ -36,36 +35,72 @@ bool TabController::loadImage(const QString &filePath)
     if (existingIndex >= 0) {
         // 已存在，切换到该标签页
         m_tabWidget->setCurrentIndex(existingIndex);
-        emit imageLoaded(filePath, pixmap);
+        emit imageLoaded(filePath, m_tabData[existingIndex].image.pixmap());
         return true;
     }
 
-    // 创建新的标签页
-    Views::ImageView *imageView = new Views::ImageView(m_tabWidget);
-    imageView->setPixmap(pixmap);
+    // 只读取文件头，无法解码的文件不创建标签页
+    if (!Utils::ImageLoader::canLoad(filePath)) {
+        emit imageLoaded(filePath, QPixmap());
+        return false;
+    }
 
-    // 添加标签页
+    // 创建新的标签页，图片在后台解码
+    Views::ImageView *imageView = new Views::ImageView(m_tabWidget);
     int index = m_tabWidget->addTab(imageView, fileName);
-    m_tabWidget->setCurrentIndex(index);
 
-    // 初始化标签页数据
-    Models::TabData tabData(filePath, pixmap);
-    tabData.undoStack = QStack<QPixmap>();
-    tabData.redoStack = QStack<QPixmap>();
-    m_tabData[index] = tabData;
+    // 初始化标签页数据（同时创建空的撤销历史），解码完成前图片为空
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    m_tabData[index] = Models::TabData(filePath, Utils::ImageBuffer());
+    m_tabData[index].loading = cancel;
 
-    // 创建撤销栈
-    m_tabData[index].undoStack = QStack<QPixmap>();
-    m_tabData[index].redoStack = QStack<QPixmap>();
-
-    // 更新当前引用
+    m_tabWidget->setCurrentIndex(index);
     updateCurrentTabRef();
 
-    emit imageLoaded(filePath, pixmap);
+    // 预览与原图同时解码；回调以视图为上下文，标签页关闭后不会被调用
+    Utils::onFutureFinished(
+        Utils::ImageLoader::loadPreviewAsync(filePath, Utils::ImageLoader::PREVIEW_SIZE, cancel), imageView,
+        [imageView, cancel](const Utils::ImageLoadResult &result) {
+            if (!*cancel && imageView->pixmap().isNull() && !result.image.isNull()) {
+                imageView->setPixmap(QPixmap::fromImage(result.image));
+            }
+        });
+    Utils::onFutureFinished(Utils::ImageLoader::loadAsync(filePath, cancel), imageView,
+                            [this, imageView](const Utils::ImageLoadResult &result) {
+        onImageLoaded(imageView, result);
+    });
 
     return true;
 }
 
+void TabController::onImageLoaded(Views::ImageView *imageView, const Utils::ImageLoadResult &result)
+{
+    const int index = m_tabWidget->indexOf(imageView);
+    if (index < 0 || !m_tabData.contains(index) || result.cancelled) {
+        return;
+    }
+
+    Models::TabData &tabData = m_tabData[index];
+    tabData.loading.reset();
+    const QString filePath = tabData.imagePath;
+    if (!result.success) {
+        closeTab(index);
+        emit imageLoaded(filePath, QPixmap());
+        return;
+    }
+
+    // 此视图只显示整幅图片，分块存储的超大图像在这里整幅读出
+    tabData.image = Utils::ImageBuffer(result.tiles ? result.tiles->toImage() : result.image);
+    const QPixmap pixmap = tabData.image.pixmap();
+    imageView->setPixmap(pixmap);
+
+    if (index == m_tabWidget->currentIndex()) {
+        updateCurrentTabRef();
+    }
+
+    emit imageLoaded(filePath, pixmap);
+}
+
 void TabController::closeCurrentTab()
 {
     int currentIndex = m_tabWidget->currentIndex();
@@ -80,18 +115,23 @@ void TabController::closeTab(int index)
         return;
     }
 
-    // 移除标签页数据
+    // 取消仍在进行的解码，移除标签页数据
+    if (m_tabData.contains(index) && m_tabData[index].loading) {
+        *m_tabData[index].loading = true;
+    }
     m_tabData.remove(index);
 
-    // 移除标签页
+    // 移除并销毁标签页（QTabWidget::removeTab 不会删除页面）
+    QWidget *page = m_tabWidget->widget(index);
     m_tabWidget->removeTab(index);
+    if (page) {
+        page->deleteLater();
+    }
 
-    // 重新映射标签页数据索引
+    // 重新映射标签页数据索引：其后的标签页前移一位
     QHash<int, Models::TabData> newTabData;
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        if (m_tabData.contains(i)) {
-            newTabData[i] = m_tabData[i];
-        }
+    for (auto it = m_tabData.cbegin(); it != m_tabData.cend(); ++it) {
+        newTabData[it.key() > index ? it.key() - 1 : it.key()] = it.value();
     }
     m_tabData = newTabData;
 
@@ -130,17 +170,22 @@ QString TabController::currentImagePath() const
 
 QPixmap TabController::currentPixmap() const
 {
-    return m_currentPixmap;
+    return m_currentImage.pixmap();
+}
+
+Utils::ImageBuffer TabController::currentImage() const
+{
+    return m_currentImage;
 }
 
 void TabController::updateCurrentPixmap(const QPixmap &pixmap)
 {
-    m_currentPixmap = pixmap;
+    m_currentImage = Utils::ImageBuffer(pixmap);
 
-    // 更新标签页数据
+    // 更新标签页数据（共享同一个句柄）
     int index = m_tabWidget->currentIndex();
     if (index >= 0 && m_tabData.contains(index)) {
-        m_tabData[index].pixmap = pixmap;
+        m_tabData[index].image = m_currentImage;
     }
 
     // 更新显示
@@ -171,14 +216,9 @@ void TabController::saveState()
 {
     int index = m_tabWidget->currentIndex();
     if (index >= 0 && m_tabData.contains(index)) {
-        if (!m_currentPixmap.isNull()) {
-            m_tabData[index].undoStack.push(m_currentPixmap);
-            // 限制撤销栈大小
-            if (m_tabData[index].undoStack.size() > 50) {
-                m_tabData[index].undoStack.remove(0);
-            }
-            // 清空重做栈
-            m_tabData[index].redoStack.clear();
+        if (!m_currentImage.isNull() && m_tabData[index].history) {
+            // 只保存与下一状态不同的图块，并清空重做历史
+            m_tabData[index].history->push(m_currentImage.image());
         }
     }
 }
@@ -200,10 +240,10 @@ void TabController::updateCurrentTabRef()
     if (index >= 0 && m_tabData.contains(index)) {
         const Models::TabData &tabData = m_tabData[index];
         m_currentImagePath = tabData.imagePath;
-        m_currentPixmap = tabData.pixmap;
+        m_currentImage = tabData.image;
     } else {
         m_currentImagePath.clear();
-        m_currentPixmap = QPixmap();
+        m_currentImage = Utils::ImageBuffer();
     }
 }
 
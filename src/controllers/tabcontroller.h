@@ -10,6 +10,7 @@
 #include "tabdata.h"
 #include "undostack.h"
 #include "imageview.h"
+#include "imageloader.h"
 
 namespace GenPreCVSystem {
 namespace Controllers {
@@ -29,8 +30,12 @@ public:
 
     /**
      * @brief 加载并显示图片
+     *
+     * 立即创建标签页并在后台解码：先显示低分辨率预览，原图解码完成后替换并发出
+     * imageLoaded。解码完成前关闭标签页会取消解码。
+     *
      * @param filePath 图片文件路径
-     * @return true 成功加载，false 加载失败
+     * @return true 已打开或开始加载，false 文件无法解码
      */
     bool loadImage(const QString &filePath);
 
@@ -76,6 +81,11 @@ public:
      */
     QPixmap currentPixmap() const;
 
+    /**
+     * @brief 获取当前图片的共享句柄（不复制像素）
+     */
+    Utils::ImageBuffer currentImage() const;
+
     /**
      * @brief 更新当前图片
      */
@@ -110,7 +120,7 @@ signals:
     void tabCloseRequested(int index);
 
     /**
-     * @brief 图片加载信号
+     * @brief 图片加载信号（后台解码完成时发出，失败时 pixmap 为空）
      */
     void imageLoaded(const QString &filePath, const QPixmap &pixmap);
 
@@ -120,6 +130,7 @@ private slots:
 
 private:
     void updateCurrentTabRef();
+    void onImageLoaded(Views::ImageView *imageView, const Utils::ImageLoadResult &result);
     QString getTabTitle(int index) const;
 
     QTabWidget *m_tabWidget;
@@ -127,7 +138,7 @@ private:
 
     // 当前活动标签页引用
     QString m_currentImagePath;
-    QPixmap m_currentPixmap;
+    Utils::ImageBuffer m_currentImage;
     Models::UndoStack *m_currentUndoStack;
 };
 
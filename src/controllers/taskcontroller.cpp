@@ -14,7 +14,11 @@
 #include "parameterpanelfactory.h"
 #include "tabcontroller.h"
 #include "dlservice.h"
+#include "detectionpostprocess.h"
 #include "imageprocessservice.h"
+#include "tiledexecutor.h"
+#include "tiledimage.h"
+#include "appsettings.h"
 #include "detectionresultdialog.h"
 #include "environmentservicewidget.h"
 #include "mainwindow.h"  // 包含 ImageView 定义
@@ -33,6 +37,7 @@
 #include <QPixmap>
 #include <QSlider>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QDebug>
 #include <QCoreApplication>
@@ -40,21 +45,19 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTabWidget>
-#include <QDateTime>
-#include <QRandomGenerator>
 #include <QDialog>
 #include <QGroupBox>
-#include <QThread>
-
-#ifdef Q_OS_WIN
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
 
 namespace GenPreCVSystem {
 namespace Controllers {
 
+namespace {
+
+// 参数停止变化多久后刷新预览
+constexpr int PREVIEW_DELAY_MS = 30;
+
+} // namespace
+
 TaskController::TaskController(QObject *parent)
     : QObject(parent)
     , m_paramScrollArea(nullptr)
@@ -73,10 +76,20 @@ TaskController::TaskController(QObject *parent)
 {
     // 创建 DL 服务
     m_dlService = new Utils::DLService(this);
+    m_dlService->setWorkerCount(Utils::AppSettings::inferenceWorkerCount());
+    m_dlService->setResultCacheEnabled(Utils::AppSettings::resultCacheEnabled());
+    m_dlService->setResultCacheLimit(Utils::AppSettings::resultCacheSizeMB());
 
     // 创建图像处理服务
+    Utils::TiledExecutor::setThreadCount(Utils::AppSettings::imageProcessingThreadCount());
     m_imageProcessService = new Utils::ImageProcessService(this);
 
+    // 参数连续变化时合并为一次预览
+    m_previewTimer = new QTimer(this);
+    m_previewTimer->setSingleShot(true);
+    m_previewTimer->setInterval(PREVIEW_DELAY_MS);
+    connect(m_previewTimer, &QTimer::timeout, this, &TaskController::updatePreview);
+
     // 创建检测结果对话框
     m_resultDialog = new Views::DetectionResultDialog(nullptr);
 
@@ -89,10 +102,20 @@ TaskController::TaskController(QObject *parent)
             this, &TaskController::logMessage);
     connect(m_dlService, &Utils::DLService::detectionCompleted,
             this, &TaskController::onDetectionCompleted);
+    connect(m_dlService, &Utils::DLService::segmentationChunk,
+            this, &TaskController::onSegmentationChunk);
+    connect(m_dlService, &Utils::DLService::keypointChunk,
+            this, &TaskController::onKeypointChunk);
 
     // 连接图像处理服务信号
     connect(m_imageProcessService, &Utils::ImageProcessService::logMessage,
             this, &TaskController::logMessage);
+    connect(m_imageProcessService, &Utils::ImageProcessService::progressChanged,
+            this, [this](int percent) {
+        if (m_processRunning) {
+            setProcessStatus(tr("状态: 处理中 %1%").arg(percent));
+        }
+    });
 
     // 连接共享控件信号
     connectSharedWidgetSignals();
@@ -315,123 +338,72 @@ QString TaskController::getCurrentImagePath() const
     return m_currentImagePath;
 }
 
-QString TaskController::getCurrentImageForInference()
+Utils::InferenceImage TaskController::getCurrentImageForInference()
 {
-    // 清理之前的临时文件
-    cleanupTempImage();
-
-    // 获取当前显示的图片（直接从 ImageView 获取，确保是处理后的图片）
-    QPixmap currentPixmap;
+    // 获取当前显示的图片（直接从 ImageView 获取，确保是处理后的图片）；
+    // 取得的是视图的句柄，不复制像素，也不在 QPixmap 与 QImage 之间转换
+    Utils::ImageBuffer current;
     ::ImageView *imageView = getCurrentImageView();
     if (imageView) {
-        currentPixmap = imageView->pixmap();
+        // 分块显示的大图直接从分块缓存写入共享内存，不整幅读入进程内存
+        if (std::shared_ptr<Utils::TiledImage> tiles = imageView->tiledImage()) {
+            m_currentImage = Utils::ImageBuffer();
+            emit logMessage(QString("使用当前显示的分块图像进行推理 (%1x%2)")
+                            .arg(tiles->width())
+                            .arg(tiles->height()));
+            return Utils::InferenceImage(tiles, getCurrentImagePath());
+        }
+        current = imageView->image();
     }
 
     // 如果无法从 ImageView 获取，尝试从 TabController 获取
-    if (currentPixmap.isNull() && m_tabController) {
-        currentPixmap = m_tabController->currentPixmap();
+    if (current.isNull() && m_tabController) {
+        current = m_tabController->currentImage();
     }
 
-    // 缓存当前 pixmap 用于结果显示
-    m_currentPixmap = currentPixmap;
+    // 保留当前句柄用于结果显示
+    m_currentImage = current;
+
+    QString imagePath = getCurrentImagePath();
 
     // 如果无法获取当前图片，回退到原始文件路径
-    if (currentPixmap.isNull()) {
+    if (current.isNull()) {
         // 尝试从文件路径加载并缓存
-        QString imagePath = getCurrentImagePath();
         if (!imagePath.isEmpty() && QFile::exists(imagePath)) {
-            m_currentPixmap.load(imagePath);
+            m_currentImage = Utils::ImageBuffer(QImage(imagePath));
         }
-        return imagePath;
+        return Utils::InferenceImage(imagePath);
     }
 
-    // 使用应用程序目录创建临时文件（避免中文路径问题）
-    QString appDir = QCoreApplication::applicationDirPath();
-    QString tempDirPath = appDir + "/temp";
-    QDir tempDir(tempDirPath);
-    if (!tempDir.exists()) {
-        tempDir.mkpath(".");
-    }
-
-    // 生成唯一的临时文件名（使用时间戳和随机数，确保只包含 ASCII 字符）
-    QString tempFileName = QString("inference_%1_%2.png")
-        .arg(QDateTime::currentMSecsSinceEpoch())
-        .arg(QRandomGenerator::global()->bounded(10000));
-    QString tempPath = tempDirPath + "/" + tempFileName;
-
-    // 保存图片到临时文件
-    if (!currentPixmap.save(tempPath, "PNG")) {
-        emit logMessage("无法保存临时图像");
-        return getCurrentImagePath();
-    }
-
-    // 确保文件已完全写入磁盘 - 使用平台特定API强制刷新
-#ifdef Q_OS_WIN
-    // Windows: 使用 FlushFileBuffers 确保写入物理磁盘
-    HANDLE hFile = CreateFileW(
-        reinterpret_cast<const wchar_t*>(tempPath.utf16()),
-        GENERIC_READ,
-        FILE_SHARE_READ | FILE_SHARE_WRITE,
-        nullptr,
-        OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
-        nullptr
-    );
-    if (hFile != INVALID_HANDLE_VALUE) {
-        FlushFileBuffers(hFile);
-        CloseHandle(hFile);
-    }
-#else
-    // Linux/Mac: 使用 fsync
-    QFile file(tempPath);
-    if (file.open(QIODevice::ReadOnly)) {
-        int fd = file.handle();
-        if (fd != -1) {
-            ::fsync(fd);
-        }
-        file.close();
-    }
-#endif
+    // 直接传递内存中的像素（经共享内存交给后端），无需编码为临时文件
+    emit logMessage(QString("使用当前显示的图像进行推理 (%1x%2)")
+                    .arg(current.width())
+                    .arg(current.height()));
 
-    // 等待一小段时间确保文件系统完成写入
-    QThread::msleep(50);
+    return Utils::InferenceImage(current.image(), imagePath);
+}
 
-    // 验证文件大小
-    QFileInfo fileInfo(tempPath);
-    qint64 fileSize = fileInfo.size();
-    int verifyRetries = 3;
-    while (fileSize == 0 && verifyRetries-- > 0) {
-        QThread::msleep(50);
-        fileInfo.refresh();
-        fileSize = fileInfo.size();
+// 推理输入转换为显示用的 pixmap
+static QPixmap inferenceImageToPixmap(const Utils::InferenceImage &image)
+{
+    if (image.tiles) {
+        return QPixmap::fromImage(image.tiles->toImage());
     }
-
-    if (fileSize == 0) {
-        emit logMessage("警告: 临时图像文件大小为0，重试保存");
-        // 重试一次
-        if (!currentPixmap.save(tempPath, "PNG")) {
-            emit logMessage("重试保存临时图像失败");
-            return getCurrentImagePath();
-        }
-        // 再次验证
-        fileInfo.refresh();
-        fileSize = fileInfo.size();
+    if (image.inMemory()) {
+        return QPixmap::fromImage(image.image);
     }
-
-    emit logMessage(QString("使用当前显示的图像进行推理: %1 (%2 KB)")
-                    .arg(tempPath)
-                    .arg(fileSize / 1024.0, 0, 'f', 2));
-
-    m_tempImagePath = tempPath;
-    return tempPath;
+    return QPixmap(image.path);
 }
 
-void TaskController::cleanupTempImage()
+void TaskController::finishInference()
 {
-    if (!m_tempImagePath.isEmpty() && QFile::exists(m_tempImagePath)) {
-        QFile::remove(m_tempImagePath);
-        m_tempImagePath.clear();
+    if (m_activeRunButton) {
+        m_activeRunButton->setEnabled(true);
+        m_activeRunButton->setText(m_activeRunButtonText);
     }
+    m_activeRunButton = nullptr;
+    m_activeRunButtonText.clear();
+    m_inferenceRunning = false;
 }
 
 void TaskController::setCurrentImagePath(const QString &imagePath)
@@ -441,7 +413,7 @@ void TaskController::setCurrentImagePath(const QString &imagePath)
 
 void TaskController::setCurrentPixmap(const QPixmap &pixmap)
 {
-    m_currentPixmap = pixmap;
+    m_currentImage = Utils::ImageBuffer(pixmap);
 }
 
 void TaskController::switchTask(Models::CVTask task)
@@ -545,6 +517,7 @@ void TaskController::updateParameterPanel(Models::CVTask task)
 
 void TaskController::clearParameterPanel()
 {
+    clearPreview();
     m_taskParamContainer = nullptr;
 
     if (m_paramScrollArea && m_paramScrollArea->widget()) {
@@ -603,61 +576,132 @@ bool TaskController::loadDLModel(const QString &modelPath, const QString &labels
     }
 
     emit logMessage(QString("正在加载模型: %1").arg(modelPath));
-    bool success = m_dlService->loadModel(modelPath, labelsPath);
-
-    return success;
+    m_dlService->loadModelAsync(modelPath, labelsPath);
+    return true;
 }
 
-void TaskController::runDetection(const QString &imagePath, float confThreshold,
+void TaskController::runDetection(const Utils::InferenceImage &image, float confThreshold,
                                    float iouThreshold, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     // 保存当前图像路径，用于显示结果
-    m_currentImagePath = imagePath;
+    m_currentImagePath = image.path;
+
+    emit logMessage(QString("执行目标检测: %1").arg(image.path));
+
+    // 获取原始候选框后在本地按阈值过滤，之后调整阈值无需重新推理
+    runCandidateDetection(image, confThreshold, iouThreshold, imageSize);
+}
+
+void TaskController::runCandidateDetection(const Utils::InferenceImage &image, float confThreshold,
+                                            float iouThreshold, int imageSize)
+{
+    clearCandidates();
 
-    emit logMessage(QString("执行目标检测: %1").arg(imagePath));
+    const QString modelPath = m_dlService->modelPath();
+    const Models::CVTask task = m_currentTask;
+    Utils::onFutureFinished(m_dlService->detectCandidatesAsync(image, imageSize), this,
+                            [this, modelPath, task, confThreshold, iouThreshold](const Utils::DetectionResult &candidates) {
+        finishInference();
 
-    // 同步调用检测（实际应用中可以考虑异步）
-    Utils::DetectionResult result = m_dlService->detect(
-        imagePath, confThreshold, iouThreshold, imageSize);
+        if (!candidates.success) {
+            onDetectionCompleted(candidates);
+            return;
+        }
+
+        // 记录候选框对应的图像、模型和任务，任一变化后不再复用
+        m_candidates = std::make_unique<Utils::DetectionResult>(candidates);
+        m_candidateModelPath = modelPath;
+        m_candidateTask = task;
+        m_candidateImageKey = m_currentImage.cacheKey();
+
+        Utils::DetectionResult result = candidates;
+        result.detections = Utils::DetectionPostProcess::filterCandidates(candidates.detections,
+                                                                          confThreshold, iouThreshold);
+        emit logMessage(QString("阈值过滤: %1 个候选框 -> %2 个目标")
+                        .arg(candidates.detections.size())
+                        .arg(result.detections.size()));
+        onDetectionCompleted(result);
+    });
+}
 
-    // 注意：信号 detectionCompleted 会在 detect() 内部发射，
-    // 触发 onDetectionCompleted() 显示结果对话框
+void TaskController::refilterCandidates(float confThreshold, float iouThreshold)
+{
+    // 仅在结果对话框仍显示同一图像、模型的检测结果时重新过滤
+    if (!m_candidates || m_inferenceRunning || m_candidateTask != m_currentTask
+        || !m_resultDialog || !m_resultDialog->isVisible()
+        || !m_dlService || m_dlService->modelPath() != m_candidateModelPath) {
+        return;
+    }
+
+    // 视图与推理时共享同一个句柄，内容未改变时版本号不变
+    ::ImageView *imageView = getCurrentImageView();
+    const Utils::ImageBuffer current = imageView ? imageView->image() : m_currentImage;
+    if (current.isNull() || current.cacheKey() != m_candidateImageKey) {
+        clearCandidates();
+        return;
+    }
+    const QPixmap pixmap = current.pixmap();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Utils::DetectionResult result = *m_candidates;
+    result.detections = Utils::DetectionPostProcess::filterCandidates(m_candidates->detections,
+                                                                      confThreshold, iouThreshold);
+    const double elapsedMs = static_cast<double>(timer.nsecsElapsed()) / 1.0e6;
+
+    m_resultDialog->setResult(pixmap, result, m_showLabels);
+    emit logMessage(QString("重新过滤 (置信度 %1, IOU %2): %3 个目标, 耗时 %4ms")
+                    .arg(confThreshold, 0, 'f', 2)
+                    .arg(iouThreshold, 0, 'f', 2)
+                    .arg(result.detections.size())
+                    .arg(elapsedMs, 0, 'f', 3));
+}
+
+void TaskController::clearCandidates()
+{
+    m_candidates.reset();
+    m_candidateModelPath.clear();
+    m_candidateImageKey = 0;
 }
 
-void TaskController::runSegmentation(const QString &imagePath, float confThreshold,
+void TaskController::runSegmentation(const Utils::InferenceImage &image, float confThreshold,
                                       float iouThreshold, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     // 保存当前图像路径，用于显示结果
-    m_currentImagePath = imagePath;
-
-    emit logMessage(QString("执行实例分割: %1").arg(imagePath));
+    m_currentImagePath = image.path;
 
-    // 同步调用分割
-    Utils::DetectionResult result = m_dlService->segment(
-        imagePath, confThreshold, iouThreshold, imageSize);
+    emit logMessage(QString("执行实例分割: %1").arg(image.path));
 
-    // 注意：信号 detectionCompleted 会在 segment() 内部发射，
-    // 触发 onDetectionCompleted() 显示结果对话框
+    // 异步提交，结果通过 detectionCompleted 信号触发 onDetectionCompleted() 显示
+    Utils::onFutureFinished(m_dlService->segmentAsync(image, confThreshold, iouThreshold, imageSize),
+                            this, [this](const Utils::DetectionResult &) {
+        finishInference();
+    });
 }
 
 void TaskController::connectParameterPanelSignals()
@@ -673,10 +717,16 @@ void TaskController::connectParameterPanelSignals()
 
     if (runDetectionBtn) {
         connect(runDetectionBtn, &QPushButton::clicked, this, [this, panel, runDetectionBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -698,15 +748,36 @@ void TaskController::connectParameterPanelSignals()
             // 保存显示设置
             m_showLabels = showLabelsCheck ? showLabelsCheck->isChecked() : true;
 
-            runDetection(imagePath, confThreshold, iouThreshold, imageSize);
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runDetectionBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行检测";
+            runDetection(image, confThreshold, iouThreshold, imageSize);
+        });
+    }
 
-            // 清理临时文件
-            cleanupTempImage();
+    // 检测类任务：只调整阈值时用上次的候选框在本地重新过滤，不再推理
+    if (runDetectionBtn || panel->findChild<QPushButton *>("btnRunRoadDamage")
+        || panel->findChild<QPushButton *>("btnRunManholeCover")) {
+        QDoubleSpinBox *confSpinBox = panel->findChild<QDoubleSpinBox *>("spinConfThreshold");
+        QDoubleSpinBox *iouSpinBox = panel->findChild<QDoubleSpinBox *>("spinIOUThreshold");
+        QSpinBox *sizeSpinBox = panel->findChild<QSpinBox *>("spinImageSize");
+
+        if (confSpinBox && iouSpinBox) {
+            auto refilter = [this, confSpinBox, iouSpinBox]() {
+                refilterCandidates(static_cast<float>(confSpinBox->value()),
+                                   static_cast<float>(iouSpinBox->value()));
+            };
+            connect(confSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, refilter);
+            connect(iouSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, refilter);
+        }
 
-            // 恢复按钮状态
-            runDetectionBtn->setEnabled(true);
-            runDetectionBtn->setText("执行检测");
-        });
+        // 输入尺寸改变后候选框失效，需要重新推理
+        if (sizeSpinBox) {
+            connect(sizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [this]() {
+                clearCandidates();
+            });
+        }
     }
 
     // 查找执行分割按钮
@@ -714,10 +785,16 @@ void TaskController::connectParameterPanelSignals()
 
     if (runSegmentationBtn) {
         connect(runSegmentationBtn, &QPushButton::clicked, this, [this, panel, runSegmentationBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -743,14 +820,11 @@ void TaskController::connectParameterPanelSignals()
             m_showBoxes = showBoxesCheck ? showBoxesCheck->isChecked() : false;
             m_showLabels = showLabelsCheck ? showLabelsCheck->isChecked() : true;
 
-            runSegmentation(imagePath, confThreshold, iouThreshold, imageSize);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runSegmentationBtn->setEnabled(true);
-            runSegmentationBtn->setText("执行语义分割");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runSegmentationBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行语义分割";
+            runSegmentation(image, confThreshold, iouThreshold, imageSize);
         });
     }
 
@@ -758,10 +832,16 @@ void TaskController::connectParameterPanelSignals()
     QPushButton *runClassificationBtn = panel->findChild<QPushButton *>("btnRunClassification");
     if (runClassificationBtn) {
         connect(runClassificationBtn, &QPushButton::clicked, this, [this, panel, runClassificationBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -774,14 +854,11 @@ void TaskController::connectParameterPanelSignals()
             QSpinBox *topKSpinBox = panel->findChild<QSpinBox *>("spinTopK");
             int topK = topKSpinBox ? topKSpinBox->value() : 5;
 
-            runClassification(imagePath, topK);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runClassificationBtn->setEnabled(true);
-            runClassificationBtn->setText("执行分类");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runClassificationBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行分类";
+            runClassification(image, topK);
         });
     }
 
@@ -789,10 +866,16 @@ void TaskController::connectParameterPanelSignals()
     QPushButton *runKeyPointBtn = panel->findChild<QPushButton *>("btnRunKeyPoint");
     if (runKeyPointBtn) {
         connect(runKeyPointBtn, &QPushButton::clicked, this, [this, panel, runKeyPointBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -814,14 +897,11 @@ void TaskController::connectParameterPanelSignals()
             m_showBoxes = showBoxesCheck ? showBoxesCheck->isChecked() : true;
             m_showLabels = showLabelsCheck ? showLabelsCheck->isChecked() : true;
 
-            runKeypointDetection(imagePath, confThreshold, 0.45f, imageSize);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runKeyPointBtn->setEnabled(true);
-            runKeyPointBtn->setText("执行关键点检测");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runKeyPointBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行关键点检测";
+            runKeypointDetection(image, confThreshold, 0.45f, imageSize);
         });
     }
 
@@ -829,10 +909,16 @@ void TaskController::connectParameterPanelSignals()
     QPushButton *runRoadDamageBtn = panel->findChild<QPushButton *>("btnRunRoadDamage");
     if (runRoadDamageBtn) {
         connect(runRoadDamageBtn, &QPushButton::clicked, this, [this, panel, runRoadDamageBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -854,14 +940,11 @@ void TaskController::connectParameterPanelSignals()
             // 保存显示设置
             m_showLabels = showLabelsCheck ? showLabelsCheck->isChecked() : true;
 
-            runRoadDamageDetection(imagePath, confThreshold, iouThreshold, imageSize);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runRoadDamageBtn->setEnabled(true);
-            runRoadDamageBtn->setText("执行病害检测");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runRoadDamageBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行病害检测";
+            runRoadDamageDetection(image, confThreshold, iouThreshold, imageSize);
         });
     }
 
@@ -869,10 +952,16 @@ void TaskController::connectParameterPanelSignals()
     QPushButton *runManholeCoverBtn = panel->findChild<QPushButton *>("btnRunManholeCover");
     if (runManholeCoverBtn) {
         connect(runManholeCoverBtn, &QPushButton::clicked, this, [this, panel, runManholeCoverBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -894,14 +983,11 @@ void TaskController::connectParameterPanelSignals()
             // 保存显示设置
             m_showLabels = showLabelsCheck ? showLabelsCheck->isChecked() : true;
 
-            runManholeCoverDamageDetection(imagePath, confThreshold, iouThreshold, imageSize);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runManholeCoverBtn->setEnabled(true);
-            runManholeCoverBtn->setText("执行井盖检测");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runManholeCoverBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行井盖检测";
+            runManholeCoverDamageDetection(image, confThreshold, iouThreshold, imageSize);
         });
     }
 
@@ -909,10 +995,16 @@ void TaskController::connectParameterPanelSignals()
     QPushButton *runFewShotBtn = panel->findChild<QPushButton *>("btnRunFewShotClassification");
     if (runFewShotBtn) {
         connect(runFewShotBtn, &QPushButton::clicked, this, [this, panel, runFewShotBtn]() {
+            // 上一次推理尚未返回时不重复提交
+            if (m_inferenceRunning) {
+                emit logMessage("上一次推理尚未完成，请稍候");
+                return;
+            }
+
             // 获取当前显示的图像用于推理（可能是处理后的图像）
-            QString imagePath = getCurrentImageForInference();
+            Utils::InferenceImage image = getCurrentImageForInference();
 
-            if (imagePath.isEmpty()) {
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
@@ -932,14 +1024,11 @@ void TaskController::connectParameterPanelSignals()
             int nQuery = nQuerySpinBox ? nQuerySpinBox->value() : 15;
             int imageSize = sizeSpinBox ? sizeSpinBox->value() : 84;
 
-            runFewShotClassification(imagePath, nWay, nShot, nQuery, imageSize);
-
-            // 清理临时文件
-            cleanupTempImage();
-
-            // 恢复按钮状态
-            runFewShotBtn->setEnabled(true);
-            runFewShotBtn->setText("执行小样本分类");
+            // 推理异步完成后由 finishInference() 恢复按钮
+            m_activeRunButton = runFewShotBtn;
+            m_inferenceRunning = true;
+            m_activeRunButtonText = "执行小样本分类";
+            runFewShotClassification(image, nWay, nShot, nQuery, imageSize);
         });
     }
 
@@ -951,87 +1040,30 @@ void TaskController::connectParameterPanelSignals()
         });
     }
 
-    // ========== 图像增强按钮 ==========
-    QPushButton *runEnhanceBtn = panel->findChild<QPushButton *>("btnRunEnhancement");
-    if (runEnhanceBtn) {
-        connect(runEnhanceBtn, &QPushButton::clicked, this, [this, panel]() {
+    // ========== 图像增强 / 去噪 / 边缘检测按钮 ==========
+    // 点击时在后台做全分辨率处理，参数调整期间只刷新预览
+    auto connectProcessButton = [this, panel](const char *buttonName, const QString &title) {
+        QPushButton *runProcessBtn = panel->findChild<QPushButton *>(buttonName);
+        if (!runProcessBtn) {
+            return;
+        }
+        connect(runProcessBtn, &QPushButton::clicked, this, [this, title]() {
             // 获取当前显示的图像用于处理（可能是已处理过的图像）
-            QString imagePath = getCurrentImageForInference();
-            if (imagePath.isEmpty()) {
-                emit logMessage("请先打开一张图像");
-                return;
-            }
-
-            QSlider *brightnessSlider = panel->findChild<QSlider *>("sliderBrightness");
-            QSlider *contrastSlider = panel->findChild<QSlider *>("sliderContrast");
-            QSlider *satSlider = panel->findChild<QSlider *>("sliderSaturation");
-            QSlider *sharpSlider = panel->findChild<QSlider *>("sliderSharpness");
-
-            int brightness = brightnessSlider ? brightnessSlider->value() : 0;
-            int contrast = contrastSlider ? contrastSlider->value() : 0;
-            int saturation = satSlider ? satSlider->value() : 0;
-            int sharpness = sharpSlider ? sharpSlider->value() : 0;
-
-            runImageEnhancement(imagePath, brightness, contrast, saturation, sharpness);
-
-            // 清理临时文件
-            cleanupTempImage();
-        });
-    }
-
-    // ========== 图像去噪按钮 ==========
-    QPushButton *runDenoiseBtn = panel->findChild<QPushButton *>("btnRunDenoising");
-    if (runDenoiseBtn) {
-        connect(runDenoiseBtn, &QPushButton::clicked, this, [this, panel]() {
-            // 获取当前显示的图像用于处理
-            QString imagePath = getCurrentImageForInference();
-            if (imagePath.isEmpty()) {
+            Utils::InferenceImage image = getCurrentImageForInference();
+            if (image.isEmpty()) {
                 emit logMessage("请先打开一张图像");
                 return;
             }
 
-            QComboBox *methodCombo = panel->findChild<QComboBox *>("cmbDenoiseMethod");
-            QSpinBox *kernelSpinBox = panel->findChild<QSpinBox *>("spinKernelSize");
-            QDoubleSpinBox *sigmaSpinBox = panel->findChild<QDoubleSpinBox *>("spinSigma");
-
-            int method = methodCombo ? methodCombo->currentIndex() : 0;
-            int kernelSize = kernelSpinBox ? kernelSpinBox->value() : 3;
-            double sigma = sigmaSpinBox ? sigmaSpinBox->value() : 1.0;
-
-            runImageDenoising(imagePath, method, kernelSize, sigma);
-
-            // 清理临时文件
-            cleanupTempImage();
+            emit logMessage(tr("执行%1...").arg(title));
+            runImageProcess(image, currentProcessRequest(), title);
         });
-    }
-
-    // ========== 边缘检测按钮 ==========
-    QPushButton *runEdgeBtn = panel->findChild<QPushButton *>("btnRunEdgeDetection");
-    if (runEdgeBtn) {
-        connect(runEdgeBtn, &QPushButton::clicked, this, [this, panel]() {
-            // 获取当前显示的图像用于处理
-            QString imagePath = getCurrentImageForInference();
-            if (imagePath.isEmpty()) {
-                emit logMessage("请先打开一张图像");
-                return;
-            }
-
-            QComboBox *methodCombo = panel->findChild<QComboBox *>("cmbEdgeMethod");
-            QDoubleSpinBox *threshold1SpinBox = panel->findChild<QDoubleSpinBox *>("spinCannyThreshold1");
-            QDoubleSpinBox *threshold2SpinBox = panel->findChild<QDoubleSpinBox *>("spinCannyThreshold2");
-            QSpinBox *apertureSpinBox = panel->findChild<QSpinBox *>("spinApertureSize");
-
-            int method = methodCombo ? methodCombo->currentIndex() : 0;
-            double threshold1 = threshold1SpinBox ? threshold1SpinBox->value() : 100.0;
-            double threshold2 = threshold2SpinBox ? threshold2SpinBox->value() : 200.0;
-            int apertureSize = apertureSpinBox ? apertureSpinBox->value() : 3;
-
-            runEdgeDetection(imagePath, method, threshold1, threshold2, apertureSize);
+    };
+    connectProcessButton("btnRunEnhancement", tr("图像增强"));
+    connectProcessButton("btnRunDenoising", tr("图像去噪"));
+    connectProcessButton("btnRunEdgeDetection", tr("边缘检测"));
 
-            // 清理临时文件
-            cleanupTempImage();
-        });
-    }
+    connectImageProcessPreview();
 }
 
 void TaskController::onDetectionCompleted(const Utils::DetectionResult &result)
@@ -1054,6 +1086,10 @@ void TaskController::showResultDialog(const Utils::DetectionResult &result)
 
     if (!result.success) {
         emit logMessage(tr("检测失败: %1").arg(result.message));
+        if (m_resultStreamed && m_resultDialog) {
+            m_resultStreamed = false;
+            m_resultDialog->finishSegmentationStream(result);  // 显示失败信息
+        }
         return;
     }
 
@@ -1061,23 +1097,60 @@ void TaskController::showResultDialog(const Utils::DetectionResult &result)
         m_resultDialog = new Views::DetectionResultDialog(nullptr);
     }
 
+    // 流式分块已显示在对话框中，只需补齐剩余实例
+    if (m_resultStreamed && m_currentTask == Models::CVTask::SemanticSegmentation) {
+        m_resultStreamed = false;
+        m_resultDialog->finishSegmentationStream(result);
+        emit logMessage(tr("语义分割结果已显示"));
+        return;
+    }
+
+    QPixmap pixmap = currentResultPixmap();
+
+    if (!pixmap.isNull()) {
+        // 根据任务类型使用不同的显示方式
+        if (m_currentTask == Models::CVTask::SemanticSegmentation) {
+            // 使用蒙版显示分割结果
+            m_resultDialog->setSegmentationResult(pixmap, result, m_maskAlpha, m_showBoxes, m_showLabels);
+            emit logMessage(tr("语义分割结果已显示"));
+        } else {
+            // 使用边界框显示检测结果
+            m_resultDialog->setResult(pixmap, result, m_showLabels);
+            emit logMessage(tr("检测结果已显示"));
+        }
+        m_resultDialog->show();
+        m_resultDialog->raise();
+        m_resultDialog->activateWindow();
+        return;
+    }
+
+    // 如果无法加载图像，显示错误
+    emit logMessage(tr("无法显示检测结果: 图像未加载或路径无效"));
+}
+
+QPixmap TaskController::currentResultPixmap()
+{
     // 获取当前显示的图片（从 ImageView 获取，确保是处理后的图片）
     QPixmap pixmap;
     ::ImageView *imageView = getCurrentImageView();
     if (imageView) {
-        pixmap = imageView->pixmap();
+        pixmap = imageView->image().pixmap();
+        // 结果按原图坐标绘制，分块显示的大图此时整幅读出
+        if (pixmap.isNull() && imageView->tiledImage()) {
+            pixmap = QPixmap::fromImage(imageView->tiledImage()->toImage());
+        }
         qDebug() << "Got pixmap from ImageView, null:" << pixmap.isNull() << "size:" << pixmap.size();
     }
 
     // 如果无法从 ImageView 获取，尝试从缓存的 pixmap 获取
-    if (pixmap.isNull() && !m_currentPixmap.isNull()) {
-        pixmap = m_currentPixmap;
+    if (pixmap.isNull() && !m_currentImage.isNull()) {
+        pixmap = m_currentImage.pixmap();
         qDebug() << "Got pixmap from cache, null:" << pixmap.isNull();
     }
 
     // 如果无法从 ImageView 获取，尝试从 TabController 获取
     if (pixmap.isNull() && m_tabController) {
-        pixmap = m_tabController->currentPixmap();
+        pixmap = m_tabController->currentImage().pixmap();
         qDebug() << "Got pixmap from TabController, null:" << pixmap.isNull();
     }
 
@@ -1091,334 +1164,565 @@ void TaskController::showResultDialog(const Utils::DetectionResult &result)
     }
 
     qDebug() << "Final pixmap for result display, null:" << pixmap.isNull() << "size:" << pixmap.size();
+    return pixmap;
+}
 
-    if (!pixmap.isNull()) {
-        // 根据任务类型使用不同的显示方式
-        if (m_currentTask == Models::CVTask::SemanticSegmentation) {
-            // 使用蒙版显示分割结果
-            m_resultDialog->setSegmentationResult(pixmap, result, m_maskAlpha, m_showBoxes, m_showLabels);
-            emit logMessage(tr("语义分割结果已显示"));
-        } else {
-            // 使用边界框显示检测结果
-            m_resultDialog->setResult(pixmap, result, m_showLabels);
-            emit logMessage(tr("检测结果已显示"));
+void TaskController::onSegmentationChunk(const QVector<Utils::Detection> &detections, int firstIndex)
+{
+    if (!m_showResultDialog || m_currentTask != Models::CVTask::SemanticSegmentation) {
+        return;
+    }
+
+    // 第一块到达时打开对话框并显示原图
+    if (firstIndex == 0) {
+        m_resultStreamed = false;
+        QPixmap pixmap = currentResultPixmap();
+        if (pixmap.isNull()) {
+            return;
         }
+        if (!m_resultDialog) {
+            m_resultDialog = new Views::DetectionResultDialog(nullptr);
+        }
+        m_resultDialog->beginSegmentationStream(pixmap, m_maskAlpha, m_showBoxes, m_showLabels);
         m_resultDialog->show();
         m_resultDialog->raise();
         m_resultDialog->activateWindow();
-        return;
+        m_resultStreamed = true;
     }
 
-    // 如果无法加载图像，显示错误
-    emit logMessage(tr("无法显示检测结果: 图像未加载或路径无效"));
+    if (m_resultStreamed) {
+        m_resultDialog->appendSegmentationDetections(detections);
+    }
 }
 
-void TaskController::runImageEnhancement(const QString &imagePath, int brightness,
-                                          int contrast, int saturation, int sharpness)
+void TaskController::onKeypointChunk(const QVector<Utils::KeypointDetection> &detections, int firstIndex)
 {
-    emit logMessage(tr("执行图像增强..."));
-
-    QPixmap pixmap(imagePath);
-    if (pixmap.isNull()) {
-        emit logMessage(tr("无法加载图像: %1").arg(imagePath));
+    if (!m_showResultDialog) {
         return;
     }
 
-    m_currentImagePath = imagePath;
-
-    Utils::ProcessResult result = m_imageProcessService->enhanceImage(
-        pixmap.toImage(), brightness, contrast, saturation, sharpness);
-
-    if (result.success) {
-        // 显示处理后的图像 - 使用对比视图
+    if (firstIndex == 0) {
+        m_resultStreamed = false;
+        QPixmap pixmap = currentResultPixmap();
+        if (pixmap.isNull()) {
+            return;
+        }
         if (!m_resultDialog) {
             m_resultDialog = new Views::DetectionResultDialog(nullptr);
         }
-
-        QPixmap resultPixmap = QPixmap::fromImage(result.processedImage);
-        m_resultDialog->setImageProcessResult(pixmap, resultPixmap, tr("图像增强"), result.processTime);
+        m_resultDialog->beginKeypointStream(pixmap, m_showBoxes, m_showLabels);
         m_resultDialog->show();
         m_resultDialog->raise();
         m_resultDialog->activateWindow();
+        m_resultStreamed = true;
+    }
 
-        emit logMessage(result.message);
-        emit imageProcessCompleted(result);
-    } else {
-        emit logMessage(tr("图像增强失败: %1").arg(result.message));
+    if (m_resultStreamed) {
+        m_resultDialog->appendKeypointDetections(detections);
     }
 }
 
-void TaskController::runImageDenoising(const QString &imagePath, int method,
+void TaskController::runImageEnhancement(const Utils::InferenceImage &image, int brightness,
+                                          int contrast, int saturation, int sharpness)
+{
+    emit logMessage(tr("执行图像增强..."));
+
+    Utils::ProcessRequest request;
+    request.type = Utils::ProcessRequest::Type::Enhance;
+    request.brightness = brightness;
+    request.contrast = contrast;
+    request.saturation = saturation;
+    request.sharpness = sharpness;
+    runImageProcess(image, request, tr("图像增强"));
+}
+
+void TaskController::runImageDenoising(const Utils::InferenceImage &image, int method,
                                         int kernelSize, double sigma)
 {
     emit logMessage(tr("执行图像去噪..."));
 
-    QPixmap pixmap(imagePath);
+    Utils::ProcessRequest request;
+    request.type = Utils::ProcessRequest::Type::Denoise;
+    request.method = method;
+    request.kernelSize = kernelSize;
+    request.sigma = sigma;
+    runImageProcess(image, request, tr("图像去噪"));
+}
+
+void TaskController::runEdgeDetection(const Utils::InferenceImage &image, int method,
+                                       double threshold1, double threshold2, int apertureSize)
+{
+    emit logMessage(tr("执行边缘检测..."));
+
+    Utils::ProcessRequest request;
+    request.type = Utils::ProcessRequest::Type::EdgeDetection;
+    request.method = method;
+    request.threshold1 = threshold1;
+    request.threshold2 = threshold2;
+    request.apertureSize = apertureSize;
+    runImageProcess(image, request, tr("边缘检测"));
+}
+
+void TaskController::runImageProcess(const Utils::InferenceImage &image,
+                                     const Utils::ProcessRequest &request, const QString &title)
+{
+    if (m_processRunning) {
+        emit logMessage(tr("上一次处理尚未完成，请稍候"));
+        return;
+    }
+
+    if (image.tiles) {
+        runTiledImageProcess(image, request, title);
+        return;
+    }
+
+    QPixmap pixmap = inferenceImageToPixmap(image);
     if (pixmap.isNull()) {
-        emit logMessage(tr("无法加载图像: %1").arg(imagePath));
+        emit logMessage(tr("无法加载图像: %1").arg(image.path));
         return;
     }
 
-    m_currentImagePath = imagePath;
+    m_currentImagePath = image.path;
 
-    Utils::ImageProcessService::DenoiseMethod denoiseMethod =
-        static_cast<Utils::ImageProcessService::DenoiseMethod>(method);
+    // 结果在对比视图中显示，当前视图恢复原图
+    clearPreview();
+    m_processRunning = true;
+    setProcessStatus(tr("状态: 处理中 0%"));
 
-    Utils::ProcessResult result = m_imageProcessService->denoiseImage(
-        pixmap.toImage(), denoiseMethod, kernelSize, sigma);
+    Utils::onFutureFinished(m_imageProcessService->processAsync(pixmap.toImage(), request), this,
+                            [this, pixmap, title](const Utils::ProcessResult &result) {
+        m_processRunning = false;
 
-    if (result.success) {
-        // 显示处理后的图像 - 使用对比视图
-        if (!m_resultDialog) {
-            m_resultDialog = new Views::DetectionResultDialog(nullptr);
-        }
+        if (result.success) {
+            // 显示处理后的图像 - 使用对比视图
+            if (!m_resultDialog) {
+                m_resultDialog = new Views::DetectionResultDialog(nullptr);
+            }
 
-        QPixmap resultPixmap = QPixmap::fromImage(result.processedImage);
-        m_resultDialog->setImageProcessResult(pixmap, resultPixmap, tr("图像去噪"), result.processTime);
-        m_resultDialog->show();
-        m_resultDialog->raise();
-        m_resultDialog->activateWindow();
+            QPixmap resultPixmap = QPixmap::fromImage(result.processedImage);
+            m_resultDialog->setImageProcessResult(pixmap, resultPixmap, title, result.processTime);
+            m_resultDialog->show();
+            m_resultDialog->raise();
+            m_resultDialog->activateWindow();
 
-        emit logMessage(result.message);
-        emit imageProcessCompleted(result);
-    } else {
-        emit logMessage(tr("图像去噪失败: %1").arg(result.message));
-    }
+            setProcessStatus(tr("状态: 完成，耗时 %1ms").arg(result.processTime));
+            emit logMessage(result.message);
+            emit imageProcessCompleted(result);
+        } else {
+            setProcessStatus(tr("状态: 失败"));
+            emit logMessage(tr("%1失败: %2").arg(title, result.message));
+        }
+    });
 }
 
-void TaskController::runEdgeDetection(const QString &imagePath, int method,
-                                       double threshold1, double threshold2, int apertureSize)
+void TaskController::runTiledImageProcess(const Utils::InferenceImage &image,
+                                          const Utils::ProcessRequest &request, const QString &title)
 {
-    emit logMessage(tr("执行边缘检测..."));
+    m_currentImagePath = image.path;
 
-    QPixmap pixmap(imagePath);
-    if (pixmap.isNull()) {
-        emit logMessage(tr("无法加载图像: %1").arg(imagePath));
+    clearPreview();
+    m_processRunning = true;
+    setProcessStatus(tr("状态: 处理中 0%"));
+
+    // 结果写入新的分块缓存；对比视图显示两者的缩略图
+    const std::shared_ptr<Utils::TiledImage> tiles = image.tiles;
+    Utils::onFutureFinished(m_imageProcessService->processAsync(tiles, request), this,
+                            [this, tiles, title](const Utils::ProcessResult &result) {
+        m_processRunning = false;
+
+        if (result.success) {
+            if (!m_resultDialog) {
+                m_resultDialog = new Views::DetectionResultDialog(nullptr);
+            }
+
+            m_resultDialog->setImageProcessResult(QPixmap::fromImage(tiles->overview()),
+                                                  QPixmap::fromImage(result.processedTiles->overview()),
+                                                  title, result.processTime);
+            m_resultDialog->show();
+            m_resultDialog->raise();
+            m_resultDialog->activateWindow();
+
+            setProcessStatus(tr("状态: 完成，耗时 %1ms").arg(result.processTime));
+            emit logMessage(result.message);
+            emit imageProcessCompleted(result);
+        } else {
+            setProcessStatus(tr("状态: 失败"));
+            emit logMessage(tr("%1失败: %2").arg(title, result.message));
+        }
+    });
+}
+
+void TaskController::connectImageProcessPreview()
+{
+    QWidget *panel = m_taskParamContainer;
+    QCheckBox *livePreviewCheck = panel ? panel->findChild<QCheckBox *>("chkLivePreview") : nullptr;
+    if (!livePreviewCheck) {
         return;
     }
 
-    m_currentImagePath = imagePath;
+    // 任一参数变化都重新预览，连续拖动由定时器合并为一次
+    auto schedulePreview = [this]() {
+        m_previewTimer->start();
+    };
+    for (QSlider *slider : panel->findChildren<QSlider *>()) {
+        connect(slider, &QSlider::valueChanged, this, schedulePreview);
+    }
+    for (QSpinBox *spinBox : panel->findChildren<QSpinBox *>()) {
+        connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, schedulePreview);
+    }
+    for (QDoubleSpinBox *spinBox : panel->findChildren<QDoubleSpinBox *>()) {
+        connect(spinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, schedulePreview);
+    }
+    for (QComboBox *comboBox : panel->findChildren<QComboBox *>()) {
+        connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, schedulePreview);
+    }
 
-    Utils::ImageProcessService::EdgeMethod edgeMethod =
-        static_cast<Utils::ImageProcessService::EdgeMethod>(method);
+    connect(livePreviewCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        if (checked) {
+            m_previewTimer->start();
+        } else {
+            clearPreview();
+            setProcessStatus(tr("状态: 就绪"));
+        }
+    });
+}
 
-    Utils::ProcessResult result = m_imageProcessService->detectEdges(
-        pixmap.toImage(), edgeMethod, threshold1, threshold2, apertureSize);
+Utils::ProcessRequest TaskController::currentProcessRequest() const
+{
+    Utils::ProcessRequest request;
+    QWidget *panel = m_taskParamContainer;
+    if (!panel) {
+        return request;
+    }
 
-    if (result.success) {
-        if (!m_resultDialog) {
-            m_resultDialog = new Views::DetectionResultDialog(nullptr);
+    switch (m_currentTask) {
+        case Models::CVTask::ImageEnhancement: {
+            QSlider *brightnessSlider = panel->findChild<QSlider *>("sliderBrightness");
+            QSlider *contrastSlider = panel->findChild<QSlider *>("sliderContrast");
+            QSlider *satSlider = panel->findChild<QSlider *>("sliderSaturation");
+            QSlider *sharpSlider = panel->findChild<QSlider *>("sliderSharpness");
+
+            request.type = Utils::ProcessRequest::Type::Enhance;
+            request.brightness = brightnessSlider ? brightnessSlider->value() : 0;
+            request.contrast = contrastSlider ? contrastSlider->value() : 0;
+            request.saturation = satSlider ? satSlider->value() : 0;
+            request.sharpness = sharpSlider ? sharpSlider->value() : 0;
+            break;
         }
+        case Models::CVTask::ImageDenoising: {
+            QComboBox *methodCombo = panel->findChild<QComboBox *>("cmbDenoiseMethod");
+            QSpinBox *kernelSpinBox = panel->findChild<QSpinBox *>("spinKernelSize");
+            QDoubleSpinBox *sigmaSpinBox = panel->findChild<QDoubleSpinBox *>("spinSigma");
 
-        QPixmap resultPixmap = QPixmap::fromImage(result.processedImage);
-        m_resultDialog->setImageProcessResult(pixmap, resultPixmap, tr("边缘检测"), result.processTime);
-        m_resultDialog->show();
-        m_resultDialog->raise();
-        m_resultDialog->activateWindow();
+            request.type = Utils::ProcessRequest::Type::Denoise;
+            request.method = methodCombo ? methodCombo->currentIndex() : 0;
+            request.kernelSize = kernelSpinBox ? kernelSpinBox->value() : 3;
+            request.sigma = sigmaSpinBox ? sigmaSpinBox->value() : 1.0;
+            break;
+        }
+        case Models::CVTask::EdgeDetection: {
+            QComboBox *methodCombo = panel->findChild<QComboBox *>("cmbEdgeMethod");
+            QDoubleSpinBox *threshold1SpinBox = panel->findChild<QDoubleSpinBox *>("spinCannyThreshold1");
+            QDoubleSpinBox *threshold2SpinBox = panel->findChild<QDoubleSpinBox *>("spinCannyThreshold2");
+            QSpinBox *apertureSpinBox = panel->findChild<QSpinBox *>("spinApertureSize");
 
-        emit logMessage(result.message);
-        emit imageProcessCompleted(result);
+            request.type = Utils::ProcessRequest::Type::EdgeDetection;
+            request.method = methodCombo ? methodCombo->currentIndex() : 0;
+            request.threshold1 = threshold1SpinBox ? threshold1SpinBox->value() : 100.0;
+            request.threshold2 = threshold2SpinBox ? threshold2SpinBox->value() : 200.0;
+            request.apertureSize = apertureSpinBox ? apertureSpinBox->value() : 3;
+            break;
+        }
+        default:
+            break;
+    }
+    return request;
+}
+
+void TaskController::updatePreview()
+{
+    QCheckBox *livePreviewCheck = m_taskParamContainer
+        ? m_taskParamContainer->findChild<QCheckBox *>("chkLivePreview") : nullptr;
+    if (!livePreviewCheck || !livePreviewCheck->isChecked() || m_processRunning) {
+        return;
+    }
+
+    ::ImageView *imageView = getCurrentImageView();
+    if (!imageView || !imageView->hasImage()) {
+        return;
+    }
+
+    // 切换标签页后，上一个视图恢复原图
+    if (m_previewView && m_previewView != imageView) {
+        m_previewView->clearPreview();
+    }
+    m_previewView = imageView;
+
+    Utils::ProcessResult result;
+    if (std::shared_ptr<Utils::TiledImage> tiles = imageView->tiledImage()) {
+        // 分块图像在缩略图上预览
+        result = m_imageProcessService->preview(*tiles, currentProcessRequest(), imageView->currentScale());
     } else {
-        emit logMessage(tr("边缘检测失败: %1").arg(result.message));
+        // 预览期间 pixmap() 仍返回原图，只在换图后重新转换
+        const QPixmap pixmap = imageView->pixmap();
+        if (pixmap.cacheKey() != m_previewPixmapKey) {
+            m_previewSource = pixmap.toImage();
+            m_previewPixmapKey = pixmap.cacheKey();
+        }
+        result = m_imageProcessService->preview(m_previewSource, currentProcessRequest(),
+                                                imageView->currentScale());
+    }
+    if (!result.success) {
+        return;
     }
+
+    imageView->setPreviewPixmap(QPixmap::fromImage(result.processedImage));
+    setProcessStatus(tr("状态: 预览 %1% 分辨率，耗时 %2ms")
+                     .arg(qRound(result.scale * 100))
+                     .arg(result.processTime));
 }
 
-void TaskController::runClassification(const QString &imagePath, int topK)
+void TaskController::clearPreview()
+{
+    if (m_previewTimer) {
+        m_previewTimer->stop();
+    }
+    if (m_previewView) {
+        m_previewView->clearPreview();
+    }
+    m_previewView = nullptr;
+    m_previewSource = QImage();
+    m_previewPixmapKey = 0;
+    m_imageProcessService->clearPreviewCache();
+}
+
+void TaskController::setProcessStatus(const QString &status)
+{
+    if (!m_taskParamContainer) {
+        return;
+    }
+
+    for (const char *name : {"lblEnhanceStatus", "lblDenoiseStatus", "lblEdgeStatus"}) {
+        if (QLabel *label = m_taskParamContainer->findChild<QLabel *>(name)) {
+            label->setText(status);
+            return;
+        }
+    }
+}
+
+void TaskController::runClassification(const Utils::InferenceImage &image, int topK)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     emit logMessage(QString("执行图像分类"));
 
-    // 同步调用分类
-    Utils::ClassificationResultList result = m_dlService->classify(imagePath, topK);
+    // 异步提交，完成后显示分类结果
+    Utils::onFutureFinished(m_dlService->classifyAsync(image, topK), this,
+                            [this, image](const Utils::ClassificationResultList &result) {
+        if (result.success) {
+            // 显示分类结果
+            if (!m_resultDialog) {
+                m_resultDialog = new Views::DetectionResultDialog(nullptr);
+            }
 
-    if (result.success) {
-        // 显示分类结果
-        if (!m_resultDialog) {
-            m_resultDialog = new Views::DetectionResultDialog(nullptr);
-        }
+            // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
+            QPixmap pixmap;
+            ::ImageView *imageView = getCurrentImageView();
+            if (imageView) {
+                pixmap = imageView->pixmap();
+            }
 
-        // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
-        QPixmap pixmap;
-        ::ImageView *imageView = getCurrentImageView();
-        if (imageView) {
-            pixmap = imageView->pixmap();
-        }
+            // 如果无法从 ImageView 获取，使用推理输入图像
+            if (pixmap.isNull()) {
+                pixmap = inferenceImageToPixmap(image);
+            }
 
-        // 如果无法从 ImageView 获取，尝试从文件加载
-        if (pixmap.isNull()) {
-            pixmap.load(imagePath);
-        }
+            m_resultDialog->setClassificationResult(pixmap, result);
+            m_resultDialog->show();
+            m_resultDialog->raise();
+            m_resultDialog->activateWindow();
 
-        m_resultDialog->setClassificationResult(pixmap, result);
-        m_resultDialog->show();
-        m_resultDialog->raise();
-        m_resultDialog->activateWindow();
+            emit logMessage(result.message);
+        } else {
+            emit logMessage(tr("分类失败: %1").arg(result.message));
+        }
 
-        emit logMessage(result.message);
-    } else {
-        emit logMessage(tr("分类失败: %1").arg(result.message));
-    }
+        finishInference();
+    });
 }
 
-void TaskController::runKeypointDetection(const QString &imagePath, float confThreshold,
+void TaskController::runKeypointDetection(const Utils::InferenceImage &image, float confThreshold,
                                            float iouThreshold, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     emit logMessage(QString("执行关键点检测"));
 
-    // 同步调用关键点检测
-    Utils::KeypointResult result = m_dlService->keypoint(imagePath, confThreshold, iouThreshold, imageSize);
+    // 异步提交，完成后显示关键点检测结果
+    Utils::onFutureFinished(m_dlService->keypointAsync(image, confThreshold, iouThreshold, imageSize), this,
+                            [this, image](const Utils::KeypointResult &result) {
+        const bool streamed = m_resultStreamed;
+        m_resultStreamed = false;
+
+        if (result.success && streamed && m_resultDialog) {
+            // 流式分块已显示，只需补齐剩余目标
+            m_resultDialog->finishKeypointStream(result);
+            emit logMessage(result.message);
+        } else if (result.success) {
+            // 显示关键点检测结果
+            if (!m_resultDialog) {
+                m_resultDialog = new Views::DetectionResultDialog(nullptr);
+            }
 
-    if (result.success) {
-        // 显示关键点检测结果
-        if (!m_resultDialog) {
-            m_resultDialog = new Views::DetectionResultDialog(nullptr);
-        }
+            // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
+            QPixmap pixmap;
+            ::ImageView *imageView = getCurrentImageView();
+            if (imageView) {
+                pixmap = imageView->pixmap();
+            }
 
-        // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
-        QPixmap pixmap;
-        ::ImageView *imageView = getCurrentImageView();
-        if (imageView) {
-            pixmap = imageView->pixmap();
-        }
+            // 如果无法从 ImageView 获取，使用推理输入图像
+            if (pixmap.isNull()) {
+                pixmap = inferenceImageToPixmap(image);
+            }
 
-        // 如果无法从 ImageView 获取，尝试从文件加载
-        if (pixmap.isNull()) {
-            pixmap.load(imagePath);
-        }
+            m_resultDialog->setKeypointResult(pixmap, result, m_showBoxes, m_showLabels);
+            m_resultDialog->show();
+            m_resultDialog->raise();
+            m_resultDialog->activateWindow();
 
-        m_resultDialog->setKeypointResult(pixmap, result, m_showBoxes, m_showLabels);
-        m_resultDialog->show();
-        m_resultDialog->raise();
-        m_resultDialog->activateWindow();
+            emit logMessage(result.message);
+        } else {
+            emit logMessage(tr("关键点检测失败: %1").arg(result.message));
+        }
 
-        emit logMessage(result.message);
-    } else {
-        emit logMessage(tr("关键点检测失败: %1").arg(result.message));
-    }
+        finishInference();
+    });
 }
 
-void TaskController::runRoadDamageDetection(const QString &imagePath, float confThreshold,
+void TaskController::runRoadDamageDetection(const Utils::InferenceImage &image, float confThreshold,
                                              float iouThreshold, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     // 保存当前图像路径，用于显示结果
-    m_currentImagePath = imagePath;
+    m_currentImagePath = image.path;
 
-    emit logMessage(QString("执行道路病害检测: %1").arg(imagePath));
+    emit logMessage(QString("执行道路病害检测: %1").arg(image.path));
 
-    // 同步调用检测（使用 detect 方法，与目标检测相同）
-    Utils::DetectionResult result = m_dlService->detect(
-        imagePath, confThreshold, iouThreshold, imageSize);
-
-    // 注意：信号 detectionCompleted 会在 detect() 内部发射，
-    // 触发 onDetectionCompleted() 显示结果对话框
+    // 与目标检测相同：获取候选框后在本地按阈值过滤
+    runCandidateDetection(image, confThreshold, iouThreshold, imageSize);
 }
 
-void TaskController::runManholeCoverDamageDetection(const QString &imagePath, float confThreshold,
+void TaskController::runManholeCoverDamageDetection(const Utils::InferenceImage &image, float confThreshold,
                                                      float iouThreshold, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     // 保存当前图像路径，用于显示结果
-    m_currentImagePath = imagePath;
-
-    emit logMessage(QString("执行井盖病害检测: %1").arg(imagePath));
+    m_currentImagePath = image.path;
 
-    // 同步调用检测（使用 detect 方法，与目标检测相同）
-    Utils::DetectionResult result = m_dlService->detect(
-        imagePath, confThreshold, iouThreshold, imageSize);
+    emit logMessage(QString("执行井盖病害检测: %1").arg(image.path));
 
-    // 注意：信号 detectionCompleted 会在 detect() 内部发射，
-    // 触发 onDetectionCompleted() 显示结果对话框
+    // 与目标检测相同：获取候选框后在本地按阈值过滤
+    runCandidateDetection(image, confThreshold, iouThreshold, imageSize);
 }
 
-void TaskController::runFewShotClassification(const QString &imagePath, int nWay,
+void TaskController::runFewShotClassification(const Utils::InferenceImage &image, int nWay,
                                                int nShot, int nQuery, int imageSize)
 {
     if (!m_dlService) {
         emit logMessage("服务未初始化");
+        finishInference();
         return;
     }
 
     if (!m_dlService->isRunning()) {
         emit logMessage("服务未运行，请先启动服务");
+        finishInference();
         return;
     }
 
     // 保存当前图像路径，用于显示结果
-    m_currentImagePath = imagePath;
+    m_currentImagePath = image.path;
 
-    emit logMessage(QString("执行遥感影像小样本分类: %1").arg(imagePath));
+    emit logMessage(QString("执行遥感影像小样本分类: %1").arg(image.path));
     emit logMessage(QString("参数: N-way=%1, N-shot=%2, N-query=%3, ImageSize=%4")
                     .arg(nWay).arg(nShot).arg(nQuery).arg(imageSize));
 
-    // 同步调用小样本分类
-    Utils::ClassificationResultList result = m_dlService->fewShotClassify(
-        imagePath, nWay, nShot, nQuery, imageSize);
+    // 异步提交，完成后显示小样本分类结果
+    Utils::onFutureFinished(m_dlService->fewShotClassifyAsync(image, nWay, nShot, nQuery, imageSize), this,
+                            [this, image, nWay, nShot](const Utils::ClassificationResultList &result) {
+        if (result.success) {
+            // 显示小样本分类结果
+            if (!m_resultDialog) {
+                m_resultDialog = new Views::DetectionResultDialog(nullptr);
+            }
 
-    if (result.success) {
-        // 显示小样本分类结果
-        if (!m_resultDialog) {
-            m_resultDialog = new Views::DetectionResultDialog(nullptr);
-        }
+            // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
+            QPixmap pixmap;
+            ::ImageView *imageView = getCurrentImageView();
+            if (imageView) {
+                pixmap = imageView->pixmap();
+            }
 
-        // 获取当前显示的图像用于显示（从 ImageView 获取，确保是处理后的图片）
-        QPixmap pixmap;
-        ::ImageView *imageView = getCurrentImageView();
-        if (imageView) {
-            pixmap = imageView->pixmap();
-        }
+            // 如果无法从 ImageView 获取，使用推理输入图像
+            if (pixmap.isNull()) {
+                pixmap = inferenceImageToPixmap(image);
+            }
 
-        // 如果无法从 ImageView 获取，尝试从文件加载
-        if (pixmap.isNull()) {
-            pixmap.load(imagePath);
-        }
+            m_resultDialog->setFewShotClassificationResult(pixmap, result, nWay, nShot);
+            m_resultDialog->show();
+            m_resultDialog->raise();
+            m_resultDialog->activateWindow();
 
-        m_resultDialog->setFewShotClassificationResult(pixmap, result, nWay, nShot);
-        m_resultDialog->show();
-        m_resultDialog->raise();
-        m_resultDialog->activateWindow();
+            emit logMessage(result.message);
+        } else {
+            emit logMessage(tr("小样本分类失败: %1").arg(result.message));
+        }
 
-        emit logMessage(result.message);
-    } else {
-        emit logMessage(tr("小样本分类失败: %1").arg(result.message));
-    }
+        finishInference();
+    });
 }
 
 void TaskController::showFSLInfoDialog()
@@ -4,13 +4,18 @@
 #include <QObject>
 #include <QActionGroup>
 #include <QScrollArea>
+#include <QPointer>
+#include <QImage>
 #include <memory>
 #include <functional>
 
 #include "tasktypes.h"
+#include "imagebuffer.h"
 
 // 前向声明
 class QTabWidget;
+class QPushButton;
+class QTimer;
 class ImageView;  // 使用全局命名空间的 ImageView（定义在 mainwindow.h 中）
 
 namespace GenPreCVSystem {
@@ -25,6 +30,8 @@ struct Detection;
 struct ClassificationResultList;
 struct KeypointResult;
 struct ProcessResult;
+struct ProcessRequest;
+struct InferenceImage;
 }
 namespace Controllers {
 class TabController;
@@ -145,7 +152,8 @@ public slots:
     void stopDLService();
 
     /**
-     * @brief 加载 DL 模型
+     * @brief 在后台加载 DL 模型，结果由 DLService::modelLoaded 通知
+     * @return 是否已开始加载
      */
     bool loadDLModel(const QString &modelPath, const QString &labelsPath = QString());
 
@@ -162,59 +170,59 @@ public slots:
     /**
      * @brief 执行目标检测
      */
-    void runDetection(const QString &imagePath, float confThreshold = 0.25f,
+    void runDetection(const Utils::InferenceImage &image, float confThreshold = 0.25f,
                       float iouThreshold = 0.45f, int imageSize = 640);
 
     /**
      * @brief 执行实例分割
      */
-    void runSegmentation(const QString &imagePath, float confThreshold = 0.25f,
+    void runSegmentation(const Utils::InferenceImage &image, float confThreshold = 0.25f,
                          float iouThreshold = 0.45f, int imageSize = 640);
 
     /**
      * @brief 执行图像分类
      */
-    void runClassification(const QString &imagePath, int topK = 5);
+    void runClassification(const Utils::InferenceImage &image, int topK = 5);
 
     /**
      * @brief 执行关键点检测
      */
-    void runKeypointDetection(const QString &imagePath, float confThreshold = 0.25f,
+    void runKeypointDetection(const Utils::InferenceImage &image, float confThreshold = 0.25f,
                                float iouThreshold = 0.45f, int imageSize = 640);
 
     /**
      * @brief 执行道路病害检测
      */
-    void runRoadDamageDetection(const QString &imagePath, float confThreshold = 0.25f,
+    void runRoadDamageDetection(const Utils::InferenceImage &image, float confThreshold = 0.25f,
                                  float iouThreshold = 0.45f, int imageSize = 640);
 
     /**
      * @brief 执行井盖病害检测
      */
-    void runManholeCoverDamageDetection(const QString &imagePath, float confThreshold = 0.25f,
+    void runManholeCoverDamageDetection(const Utils::InferenceImage &image, float confThreshold = 0.25f,
                                          float iouThreshold = 0.45f, int imageSize = 640);
 
     /**
      * @brief 执行遥感影像小样本分类
      */
-    void runFewShotClassification(const QString &imagePath, int nWay = 5, int nShot = 5,
+    void runFewShotClassification(const Utils::InferenceImage &image, int nWay = 5, int nShot = 5,
                                    int nQuery = 15, int imageSize = 84);
 
     /**
      * @brief 执行图像增强
      */
-    void runImageEnhancement(const QString &imagePath, int brightness, int contrast,
+    void runImageEnhancement(const Utils::InferenceImage &image, int brightness, int contrast,
                               int saturation, int sharpness);
 
     /**
      * @brief 执行图像去噪
      */
-    void runImageDenoising(const QString &imagePath, int method, int kernelSize, double sigma);
+    void runImageDenoising(const Utils::InferenceImage &image, int method, int kernelSize, double sigma);
 
     /**
      * @brief 执行边缘检测
      */
-    void runEdgeDetection(const QString &imagePath, int method, double threshold1,
+    void runEdgeDetection(const Utils::InferenceImage &image, int method, double threshold1,
                            double threshold2, int apertureSize);
 
 private slots:
@@ -223,6 +231,16 @@ private slots:
      */
     void onDetectionCompleted(const Utils::DetectionResult &result);
 
+    /**
+     * @brief 流式分割结果到达：逐块追加到结果对话框
+     */
+    void onSegmentationChunk(const QVector<Utils::Detection> &detections, int firstIndex);
+
+    /**
+     * @brief 流式关键点结果到达：逐块追加到结果对话框
+     */
+    void onKeypointChunk(const QVector<Utils::KeypointDetection> &detections, int firstIndex);
+
 private:
     void updateParameterPanel(Models::CVTask task);
     void clearParameterPanel();
@@ -231,10 +249,24 @@ private:
     void enableRunButtons(bool enabled);
     ::ImageView* getCurrentImageView() const;  // 获取当前 ImageView（全局命名空间）
     QString getCurrentImagePath() const;
-    QString getCurrentImageForInference();  // 获取用于推理的图像路径（可能是临时文件）
-    void cleanupTempImage();  // 清理临时图像文件
+    Utils::InferenceImage getCurrentImageForInference();  // 获取用于推理的图像（当前显示的内存图像或文件路径）
+    void finishInference();   // 异步推理结束：恢复执行按钮
+    void runCandidateDetection(const Utils::InferenceImage &image, float confThreshold,
+                               float iouThreshold, int imageSize);  // 获取候选框并按阈值过滤显示
+    void refilterCandidates(float confThreshold, float iouThreshold);  // 阈值变化：本地重新过滤候选框
+    void clearCandidates();
     void showResultDialog(const Utils::DetectionResult &result);
+    QPixmap currentResultPixmap();  // 获取用于显示结果的当前图像
     void showFSLInfoDialog();  // 显示小样本分类详细说明对话框
+    void connectImageProcessPreview();  // 图像处理面板：参数变化时刷新预览
+    Utils::ProcessRequest currentProcessRequest() const;  // 从当前面板读取处理参数
+    void updatePreview();      // 在金字塔缩小层上处理并显示在当前视图中
+    void clearPreview();       // 恢复视图显示原图并释放预览缓存
+    void runImageProcess(const Utils::InferenceImage &image, const Utils::ProcessRequest &request,
+                         const QString &title);  // 后台全分辨率处理，完成后显示对比结果
+    void runTiledImageProcess(const Utils::InferenceImage &image, const Utils::ProcessRequest &request,
+                              const QString &title);  // 分块图像逐块处理，结果写入新的分块缓存
+    void setProcessStatus(const QString &status);  // 更新图像处理面板的状态标签
     bool isAITask(Models::CVTask task) const;
 
     QScrollArea *m_paramScrollArea;
@@ -256,15 +288,12 @@ private:
     // 当前图像路径（由 MainWindow 设置）
     QString m_currentImagePath;
 
-    // 当前图像（用于显示结果）
-    QPixmap m_currentPixmap;
+    // 当前图像（用于显示结果），与视图共享同一个句柄
+    Utils::ImageBuffer m_currentImage;
 
     // 当前模型路径
     QString m_currentModelPath;
 
-    // 临时图像文件路径（用于推理）
-    QString m_tempImagePath;
-
     // 检测结果对话框
     Views::DetectionResultDialog *m_resultDialog;
 
@@ -281,6 +310,29 @@ private:
 
     // 控制是否显示结果对话框（批量处理时禁用）
     bool m_showResultDialog = true;
+
+    // 正在等待异步推理结果的执行按钮及其原始文字
+    QPointer<QPushButton> m_activeRunButton;
+    QString m_activeRunButtonText;
+    bool m_inferenceRunning = false;
+
+    // 当前结果已通过流式分块显示在结果对话框中，最终结果只需补齐
+    bool m_resultStreamed = false;
+
+    // 上次检测的原始候选框（未经阈值过滤与 NMS），及其对应的模型、任务和图像
+    std::unique_ptr<Utils::DetectionResult> m_candidates;
+    QString m_candidateModelPath;
+    Models::CVTask m_candidateTask = Models::CVTask::ObjectDetection;
+    qint64 m_candidateImageKey = 0;
+
+    // 图像处理预览：合并连续的参数变化，原图转换结果按 pixmap 的 cacheKey 复用
+    QTimer *m_previewTimer = nullptr;
+    QPointer<::ImageView> m_previewView;
+    QImage m_previewSource;
+    qint64 m_previewPixmapKey = 0;
+
+    // 全分辨率处理正在后台进行
+    bool m_processRunning = false;
 };
 
 } // namespace Controllers
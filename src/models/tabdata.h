@@ -2,7 +2,11 @@
 #define TABDATA_H
 
 #include <QPixmap>
-#include <QStack>
+#include <atomic>
+#include <memory>
+
+#include "imagebuffer.h"
+#include "imagehistory.h"
 
 namespace GenPreCVSystem {
 namespace Models {
@@ -10,19 +14,19 @@ namespace Models {
 /**
  * @brief 标签页数据模型
  *
- * 存储每个标签页的图片数据、路径和撤销/重做栈
+ * 存储每个标签页的图片数据、路径和撤销/重做历史
  */
 struct TabData
 {
     QString imagePath;        ///< 图片文件路径
-    QPixmap pixmap;           ///< 图片数据
-    QStack<QPixmap> undoStack;///< 撤销栈
-    QStack<QPixmap> redoStack;///< 重做栈
+    Utils::ImageBuffer image; ///< 图片数据（与视图、控制器共享的句柄）
+    std::shared_ptr<Utils::ImageHistory> history; ///< 增量撤销/重做历史
+    std::shared_ptr<std::atomic<bool>> loading;  ///< 后台解码的取消标志，解码完成后为空
 
     TabData() = default;
 
-    TabData(const QString &path, const QPixmap &pix)
-        : imagePath(path), pixmap(pix)
+    TabData(const QString &path, const Utils::ImageBuffer &img)
+        : imagePath(path), image(img), history(std::make_shared<Utils::ImageHistory>())
     {}
 };
 
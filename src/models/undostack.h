@@ -2,27 +2,31 @@
 #define UNDOSTACK_H
 
 #include <QPixmap>
-#include <QStack>
 #include <QObject>
 
+#include "imagehistory.h"
+
 namespace GenPreCVSystem {
 namespace Models {
 
 /**
  * @brief 撤销/重做栈模型
  *
- * 管理图像编辑操作的撤销和重做状态
+ * 管理图像编辑操作的撤销和重做状态。各状态以与相邻状态不同的图块保存在
+ * Utils::ImageHistory 中，由全局 Utils::HistoryStore 统一压缩和换出。
  */
 class UndoStack : public QObject
 {
     Q_OBJECT
 
 public:
-    static const int MAX_UNDO_STEPS = 50;  ///< 最大撤销步数
+    static const int MAX_UNDO_STEPS = Utils::ImageHistory::DEFAULT_MAX_STEPS;  ///< 最大撤销步数
 
     explicit UndoStack(QObject *parent = nullptr)
         : QObject(parent)
-    {}
+    {
+        m_history.setMaxSteps(MAX_UNDO_STEPS);
+    }
 
     /**
      * @brief 保存当前状态到撤销栈
@@ -30,61 +34,43 @@ public:
      */
     void push(const QPixmap &pixmap)
     {
-        m_undoStack.push(pixmap);
-
-        // 限制栈的大小，避免内存占用过大
-        if (m_undoStack.size() > MAX_UNDO_STEPS) {
-            m_undoStack.remove(0);  // 移除最旧的状态
-        }
-
-        // 清空重做栈（新操作会使之前的重做历史失效）
-        m_redoStack.clear();
-
+        // 新操作会使之前的重做历史失效，超出步数时丢弃最旧的状态
+        m_history.push(pixmap.toImage());
         emit stateChanged();
     }
 
     /**
      * @brief 撤销上一步操作
-     * @param currentState 当前状态（将被保存到重做栈）
+     * @param currentState 当前状态（用于生成重做记录）
      * @return 撤销后的状态，如果栈为空返回空QPixmap
      */
     QPixmap undo(const QPixmap &currentState)
     {
-        if (m_undoStack.isEmpty()) {
+        QImage image = currentState.toImage();
+        if (!m_history.undo(image)) {
             return QPixmap();
         }
 
-        // 将当前状态保存到重做栈
-        m_redoStack.push(currentState);
-
-        // 从撤销栈弹出上一个状态
-        QPixmap previousState = m_undoStack.pop();
-
         emit stateChanged();
 
-        return previousState;
+        return QPixmap::fromImage(image);
     }
 
     /**
      * @brief 重做上一步撤销的操作
-     * @param currentState 当前状态（将被保存到撤销栈）
+     * @param currentState 当前状态（用于生成撤销记录）
      * @return 重做后的状态，如果栈为空返回空QPixmap
      */
     QPixmap redo(const QPixmap &currentState)
     {
-        if (m_redoStack.isEmpty()) {
+        QImage image = currentState.toImage();
+        if (!m_history.redo(image)) {
             return QPixmap();
         }
 
-        // 将当前状态保存到撤销栈
-        m_undoStack.push(currentState);
-
-        // 从重做栈弹出状态
-        QPixmap nextState = m_redoStack.pop();
-
         emit stateChanged();
 
-        return nextState;
+        return QPixmap::fromImage(image);
     }
 
     /**
@@ -92,37 +78,35 @@ public:
      */
     void clear()
     {
-        m_undoStack.clear();
-        m_redoStack.clear();
+        m_history.clear();
         emit stateChanged();
     }
 
     /**
      * @brief 是否可以撤销
      */
-    bool canUndo() const { return !m_undoStack.isEmpty(); }
+    bool canUndo() const { return m_history.canUndo(); }
 
     /**
      * @brief 是否可以重做
      */
-    bool canRedo() const { return !m_redoStack.isEmpty(); }
+    bool canRedo() const { return m_history.canRedo(); }
 
     /**
      * @brief 获取撤销步数
      */
-    int undoCount() const { return m_undoStack.size(); }
+    int undoCount() const { return m_history.undoCount(); }
 
     /**
      * @brief 获取重做步数
      */
-    int redoCount() const { return m_redoStack.size(); }
+    int redoCount() const { return m_history.redoCount(); }
 
 signals:
     void stateChanged();
 
 private:
-    QStack<QPixmap> m_undoStack;  ///< 撤销栈
-    QStack<QPixmap> m_redoStack;  ///< 重做栈
+    Utils::ImageHistory m_history;  ///< 增量撤销/重做历史
 };
 
 } // namespace Models
@@ -425,24 +425,24 @@ void EnvironmentCacheManager::clearCache()
     saveCache();
 }
 
-QString EnvironmentCacheManager::getCacheFilePath()
+QString EnvironmentCacheManager::cacheDirectory()
 {
     QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
     QDir dir(cacheDir);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
-    return cacheDir + "/environment_cache_v" + QString::number(CACHE_VERSION) + ".json";
+    return cacheDir;
+}
+
+QString EnvironmentCacheManager::getCacheFilePath()
+{
+    return cacheDirectory() + "/environment_cache_v" + QString::number(CACHE_VERSION) + ".json";
 }
 
 QString EnvironmentCacheManager::getStateFilePath()
 {
-    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QDir dir(cacheDir);
-    if (!dir.exists()) {
-        dir.mkpath(".");
-    }
-    return cacheDir + "/environment_state.json";
+    return cacheDirectory() + "/environment_state.json";
 }
 
 void EnvironmentCacheManager::saveCache()
@@ -235,6 +235,12 @@ public:
      */
     QString getLastUsedModel() const;
 
+    /**
+     * @brief 获取缓存目录（不存在时创建）
+     * @return 缓存目录路径
+     */
+    static QString cacheDirectory();
+
     /**
      * @brief 获取缓存文件路径
      * @return 缓存文件路径
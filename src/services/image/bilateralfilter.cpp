@@ -0,0 +1,334 @@
+/**
+ * @file bilateralfilter.cpp
+ * @brief 查找表直接计算与双边网格两种双边滤波实现
+ */
+
+#include "bilateralfilter.h"
+#include "pointoperations.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int LEVELS = 256;
+constexpr int BAND_ROWS = 64;    // 并行行带的最小行数
+constexpr int GRID_TAPS = 2;     // 网格模糊核 [1 4 6 4 1] / 16 的半径，方差为 1 个网格单元
+const float GRID_KERNEL[2 * GRID_TAPS + 1] = {1 / 16.0f, 4 / 16.0f, 6 / 16.0f, 4 / 16.0f, 1 / 16.0f};
+
+inline uchar toByte(float value)
+{
+    return static_cast<uchar>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+
+// 预先计算每个像素的亮度（与 qGray 一致），作为值域引导
+std::vector<uchar> luminancePlane(const QImage &image)
+{
+    const int width = image.width();
+    std::vector<uchar> luma(static_cast<size_t>(width) * image.height());
+    TiledExecutor::forEachRowBand(image.height(), BAND_ROWS, [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            PointOperations::grayscaleRow(reinterpret_cast<const QRgb *>(image.constScanLine(y)),
+                                          luma.data() + static_cast<size_t>(y) * width, width);
+        }
+    });
+    return luma;
+}
+
+/**
+ * 直接计算：圆形窗口内每个偏移一张 256 项权重表，
+ * 表项为空间权重与对应亮度差的值域权重之积。
+ */
+void filterDirect(const QImage &source, const std::vector<QRgb *> &result, const std::vector<uchar> &luma,
+                  int radius, double sigmaSpatial, double sigmaRange)
+{
+    struct Tap {
+        int dx;
+        int dy;
+    };
+
+    std::vector<Tap> taps;
+    std::vector<float> weights;
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            const int distance2 = dx * dx + dy * dy;
+            if (distance2 > radius * radius) {
+                continue;
+            }
+            const double spatial = std::exp(-distance2 / (2 * sigmaSpatial * sigmaSpatial));
+            for (int diff = 0; diff < LEVELS; ++diff) {
+                weights.push_back(static_cast<float>(
+                    spatial * std::exp(-diff * diff / (2 * sigmaRange * sigmaRange))));
+            }
+            taps.push_back({dx, dy});
+        }
+    }
+
+    const int width = source.width();
+    const int height = source.height();
+    const int tapCount = static_cast<int>(taps.size());
+
+    TiledExecutor::forEachRowBand(height, BAND_ROWS, [&](int y0, int y1) {
+        std::vector<const QRgb *> rows(2 * radius + 1);
+        std::vector<const uchar *> lumaRows(2 * radius + 1);
+
+        for (int y = y0; y < y1; ++y) {
+            for (int i = -radius; i <= radius; ++i) {
+                const int sy = std::min(std::max(y + i, 0), height - 1);
+                rows[i + radius] = reinterpret_cast<const QRgb *>(source.constScanLine(sy));
+                lumaRows[i + radius] = luma.data() + static_cast<size_t>(sy) * width;
+            }
+            const QRgb *center = rows[radius];
+            QRgb *out = result[y];
+
+            for (int x = 0; x < width; ++x) {
+                // 只有靠近左右边界的像素需要钳制列号
+                const bool interior = x >= radius && x < width - radius;
+                const int c = lumaRows[radius][x];
+                float r = 0, g = 0, b = 0, sum = 0;
+                for (int t = 0; t < tapCount; ++t) {
+                    const int row = taps[t].dy + radius;
+                    const int sx = interior ? x + taps[t].dx
+                                            : std::min(std::max(x + taps[t].dx, 0), width - 1);
+                    const QRgb pixel = rows[row][sx];
+                    const float w = weights[t * LEVELS + std::abs(lumaRows[row][sx] - c)];
+                    r += w * qRed(pixel);
+                    g += w * qGreen(pixel);
+                    b += w * qBlue(pixel);
+                    sum += w;
+                }
+                // 中心偏移的权重为 1，sum 不会为零
+                const float scale = 1.0f / sum;
+                out[x] = qRgba(toByte(r * scale), toByte(g * scale), toByte(b * scale), qAlpha(center[x]));
+            }
+        }
+    });
+}
+
+/**
+ * 双边网格：网格单元边长为 sigmaSpatial 个像素、sigmaRange 个亮度级，
+ * 每个单元累加 (R, G, B, 计数)。
+ *
+ * 每个行带按网格行流式处理：写入一行网格后立即在该行内做亮度和 x 方向模糊，
+ * 保留最近 5 行完成 y 方向模糊，再保留 2 行模糊结果供插值。
+ */
+class BilateralGrid
+{
+public:
+    BilateralGrid(const QImage &source, const std::vector<QRgb *> &result, const std::vector<uchar> &luma,
+                  double sigmaSpatial, double sigmaRange)
+        : m_source(source)
+        , m_result(result)
+        , m_luma(luma)
+        , m_width(source.width())
+        , m_height(source.height())
+        , m_cellSize(sigmaSpatial)
+        , m_columns(static_cast<int>((m_width - 1) / sigmaSpatial) + 2)
+        , m_depth(static_cast<int>((LEVELS - 1) / sigmaRange) + 2)
+        , m_planeSize(static_cast<size_t>(m_columns) * m_depth * 4)
+    {
+        // 写入时取最近单元，插值时取相邻两个单元及其权重
+        m_splatX.resize(m_width);
+        m_sliceX.resize(m_width);
+        m_fractionX.resize(m_width);
+        for (int x = 0; x < m_width; ++x) {
+            const double fx = x / sigmaSpatial;
+            m_splatX[x] = static_cast<int>(fx + 0.5);
+            m_sliceX[x] = static_cast<int>(fx);
+            m_fractionX[x] = static_cast<float>(fx - m_sliceX[x]);
+        }
+        for (int level = 0; level < LEVELS; ++level) {
+            const double fz = level / sigmaRange;
+            m_splatZ[level] = static_cast<int>(fz + 0.5);
+            m_sliceZ[level] = static_cast<int>(fz);
+            m_fractionZ[level] = static_cast<float>(fz - m_sliceZ[level]);
+        }
+    }
+
+    void run(int y0, int y1)
+    {
+        // 本行带插值需要模糊后的网格行 [first, last]，模糊又需要上下各 GRID_TAPS 行
+        const int first = static_cast<int>(y0 / m_cellSize);
+        const int last = static_cast<int>((y1 - 1) / m_cellSize) + 1;
+        const int rawFirst = first - GRID_TAPS;
+
+        std::vector<float> raw(m_planeSize * (2 * GRID_TAPS + 1));
+        std::vector<float> blurred(m_planeSize * 2);
+        std::vector<float> scratch(m_planeSize);
+
+        int splatY = std::max(static_cast<int>((rawFirst - 1) * m_cellSize), 0);
+        int sliceY = y0;
+
+        for (int g = rawFirst; g <= last + GRID_TAPS; ++g) {
+            float *plane = raw.data() + m_planeSize * static_cast<size_t>((g - rawFirst) % (2 * GRID_TAPS + 1));
+            std::fill(plane, plane + m_planeSize, 0.0f);
+
+            while (splatY < m_height && static_cast<int>(splatY / m_cellSize + 0.5) <= g) {
+                if (static_cast<int>(splatY / m_cellSize + 0.5) == g) {
+                    splatRow(plane, splatY);
+                }
+                ++splatY;
+            }
+
+            // 行内模糊：亮度方向每个单元为 4 个分量，x 方向每个单元为一整列亮度
+            for (int x = 0; x < m_columns; ++x) {
+                blurLine(plane + static_cast<size_t>(x) * m_depth * 4, m_depth, 4, scratch.data());
+            }
+            blurLine(plane, m_columns, static_cast<size_t>(m_depth) * 4, scratch.data());
+
+            const int row = g - GRID_TAPS;
+            if (row < first) {
+                continue;
+            }
+
+            // y 方向模糊：5 行原始网格的加权和
+            float *out = blurred.data() + m_planeSize * static_cast<size_t>(row % 2);
+            std::fill(out, out + m_planeSize, 0.0f);
+            for (int k = 0; k <= 2 * GRID_TAPS; ++k) {
+                const float *in = raw.data() + m_planeSize * static_cast<size_t>((row - GRID_TAPS + k - rawFirst) % (2 * GRID_TAPS + 1));
+                const float w = GRID_KERNEL[k];
+                for (size_t i = 0; i < m_planeSize; ++i) {
+                    out[i] += w * in[i];
+                }
+            }
+
+            if (row == first) {
+                continue;
+            }
+
+            // 网格行 row - 1 与 row 之间的像素行
+            const float *upper = blurred.data() + m_planeSize * static_cast<size_t>((row - 1) % 2);
+            while (sliceY < y1 && static_cast<int>(sliceY / m_cellSize) <= row - 1) {
+                sliceRow(upper, out, sliceY);
+                ++sliceY;
+            }
+        }
+    }
+
+private:
+    void splatRow(float *plane, int y)
+    {
+        const QRgb *line = reinterpret_cast<const QRgb *>(m_source.constScanLine(y));
+        const uchar *luma = m_luma.data() + static_cast<size_t>(y) * m_width;
+        for (int x = 0; x < m_width; ++x) {
+            float *cell = plane + (static_cast<size_t>(m_splatX[x]) * m_depth + m_splatZ[luma[x]]) * 4;
+            cell[0] += qRed(line[x]);
+            cell[1] += qGreen(line[x]);
+            cell[2] += qBlue(line[x]);
+            cell[3] += 1.0f;
+        }
+    }
+
+    // count 个长度为 span 的连续分量组沿排列方向做 [1 4 6 4 1] / 16 模糊，越界单元视为空
+    static void blurLine(float *line, int count, size_t span, float *scratch)
+    {
+        std::copy(line, line + count * span, scratch);
+        for (int i = 0; i < count; ++i) {
+            float *out = line + i * span;
+            std::fill(out, out + span, 0.0f);
+            for (int k = -GRID_TAPS; k <= GRID_TAPS; ++k) {
+                if (i + k < 0 || i + k >= count) {
+                    continue;
+                }
+                const float *in = scratch + (i + k) * span;
+                const float w = GRID_KERNEL[k + GRID_TAPS];
+                for (size_t j = 0; j < span; ++j) {
+                    out[j] += w * in[j];
+                }
+            }
+        }
+    }
+
+    void sliceRow(const float *upper, const float *lower, int y)
+    {
+        const double fy = y / m_cellSize;
+        const float wy = static_cast<float>(fy - static_cast<int>(fy));
+        const QRgb *line = reinterpret_cast<const QRgb *>(m_source.constScanLine(y));
+        const uchar *luma = m_luma.data() + static_cast<size_t>(y) * m_width;
+        QRgb *out = m_result[y];
+        const size_t stride = static_cast<size_t>(m_depth) * 4;
+
+        for (int x = 0; x < m_width; ++x) {
+            const int z = m_sliceZ[luma[x]];
+            const float wx = m_fractionX[x];
+            const float wz = m_fractionZ[luma[x]];
+            const size_t base = static_cast<size_t>(m_sliceX[x]) * stride + static_cast<size_t>(z) * 4;
+            const float corner[4] = {(1 - wx) * (1 - wz), (1 - wx) * wz, wx * (1 - wz), wx * wz};
+            const size_t offset[4] = {base, base + 4, base + stride, base + stride + 4};
+
+            float value[4] = {0, 0, 0, 0};
+            for (int i = 0; i < 4; ++i) {
+                const float *a = upper + offset[i];
+                const float *b = lower + offset[i];
+                const float wa = corner[i] * (1 - wy);
+                const float wb = corner[i] * wy;
+                for (int c = 0; c < 4; ++c) {
+                    value[c] += wa * a[c] + wb * b[c];
+                }
+            }
+
+            // 像素自身写入的单元总在插值的 8 个单元之内，权重和大于零
+            const float scale = 1.0f / value[3];
+            out[x] = qRgba(toByte(value[0] * scale), toByte(value[1] * scale),
+                           toByte(value[2] * scale), qAlpha(line[x]));
+        }
+    }
+
+    const QImage &m_source;
+    const std::vector<QRgb *> &m_result;
+    const std::vector<uchar> &m_luma;
+    int m_width;
+    int m_height;
+    double m_cellSize;
+    int m_columns;       // x 方向网格单元数
+    int m_depth;         // 亮度方向网格单元数
+    size_t m_planeSize;  // 一行网格的浮点数个数
+    std::vector<int> m_splatX;
+    std::vector<int> m_sliceX;
+    std::vector<float> m_fractionX;
+    int m_splatZ[LEVELS];
+    int m_sliceZ[LEVELS];
+    float m_fractionZ[LEVELS];
+};
+
+} // namespace
+
+QImage BilateralFilter::apply(const QImage &image, double sigmaSpatial, double sigmaRange)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    QImage source = image;
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32) {
+        source = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    const int radius = static_cast<int>(std::ceil(2 * sigmaSpatial));
+    if (radius <= 0 || sigmaSpatial < 0.25 || sigmaRange <= 0) {
+        return source;
+    }
+
+    QImage result(source.size(), source.format());
+    const std::vector<QRgb *> rows = TiledExecutor::writableRows(result);
+    const std::vector<uchar> luma = luminancePlane(source);
+
+    if (radius <= DIRECT_MAX_RADIUS) {
+        filterDirect(source, rows, luma, radius, sigmaSpatial, sigmaRange);
+    } else {
+        // 每个行带至少覆盖 16 个网格行，摊薄上下各 GRID_TAPS 行的重复计算
+        BilateralGrid grid(source, rows, luma, sigmaSpatial, sigmaRange);
+        const int bandRows = std::max(BAND_ROWS, static_cast<int>(std::ceil(16 * sigmaSpatial)));
+        TiledExecutor::forEachRowBand(source.height(), bandRows,
+                                      [&grid](int y0, int y1) { grid.run(y0, y1); });
+    }
+
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,39 @@
+#ifndef BILATERALFILTER_H
+#define BILATERALFILTER_H
+
+#include <QImage>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 快速双边滤波
+ *
+ * 值域权重按亮度差计算（联合双边滤波），RGB 三个通道共用同一组权重，
+ * 边缘两侧颜色不会相互渗透。按空间 sigma 自动选择实现：
+ * - 窗口半径不超过 DIRECT_MAX_RADIUS 时逐像素直接计算，
+ *   空间权重与值域权重合并为每个偏移一张 256 项查找表；
+ * - 更大的 sigma 使用双边网格（Paris–Durand）：像素按 (x, y, 亮度) 降采样写入三维网格，
+ *   网格上做可分离的高斯模糊后三线性插值取回，每像素代价与 sigma 无关。
+ *
+ * 两种实现都按行带分块并行，网格逐行流式计算，内存只与图像宽度成正比。
+ * 边界按复制边缘像素处理；输出为 Format_ARGB32（输入为 Format_RGB32 时保持该格式），
+ * alpha 通道保持原值。
+ */
+class BilateralFilter
+{
+public:
+    /**
+     * @brief 双边滤波
+     * @param sigmaSpatial 空间标准差（像素），过小时返回原图
+     * @param sigmaRange 值域标准差（亮度级，0-255）
+     */
+    static QImage apply(const QImage &image, double sigmaSpatial, double sigmaRange);
+
+    static constexpr int DIRECT_MAX_RADIUS = 3;  // 直接计算的最大窗口半径（7x7）
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // BILATERALFILTER_H
@@ -0,0 +1,404 @@
+/**
+ * @file cannydetector.cpp
+ * @brief Canny 边缘检测实现
+ */
+
+#include "cannydetector.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+#include <emmintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int BAND_ROWS = 64;
+constexpr float TAN_22_5 = 0.414213562f;
+constexpr float TAN_67_5 = 2.414213562f;
+
+// 梯度方向按 45° 分为四类，决定非极大值抑制比较的两个邻居
+enum Direction : uchar {
+    Horizontal = 0,    // 左、右
+    Diagonal = 1,      // 左上、右下（gx 与 gy 同号）
+    Vertical = 2,      // 上、下
+    AntiDiagonal = 3   // 右上、左下
+};
+
+// 边缘图取值，与 OpenCV 相同
+enum EdgeState : uchar {
+    Candidate = 0,     // 介于两个阈值之间，等待连接
+    NotEdge = 1,
+    Edge = 2
+};
+
+inline uchar directionOf(float gx, float gy)
+{
+    const float ax = std::fabs(gx);
+    const float ay = std::fabs(gy);
+    if (ay < ax * TAN_22_5) {
+        return Horizontal;
+    }
+    if (ay > ax * TAN_67_5) {
+        return Vertical;
+    }
+    return (gx < 0) == (gy < 0) ? Diagonal : AntiDiagonal;
+}
+
+/**
+ * 融合的梯度行处理：一趟内由垂直方向平滑、差分后的两行求出 gx、gy、幅值与方向。
+ * smoothed / differenced 左右各填充 radius 个复制值。
+ */
+struct GradientTaps {
+    std::vector<float> smooth;      // 二项式平滑
+    std::vector<float> derivative;  // 平滑后的中心差分
+};
+
+GradientTaps sobelTaps(int apertureSize)
+{
+    auto convolve = [](const std::vector<float> &a, const std::vector<float> &b) {
+        std::vector<float> out(a.size() + b.size() - 1, 0.0f);
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (size_t j = 0; j < b.size(); ++j) {
+                out[i + j] += a[i] * b[j];
+            }
+        }
+        return out;
+    };
+
+    GradientTaps taps;
+    taps.smooth = {1.0f};
+    taps.derivative = {-1.0f, 0.0f, 1.0f};
+    for (int i = 1; i < apertureSize; ++i) {
+        taps.smooth = convolve(taps.smooth, {1.0f, 1.0f});
+    }
+    for (int i = 3; i < apertureSize; ++i) {
+        taps.derivative = convolve(taps.derivative, {1.0f, 1.0f});
+    }
+    return taps;
+}
+
+void gradientRow(const GradientTaps &taps, const float *smoothed, const float *differenced,
+                 int width, bool l2Gradient, float *magnitude, uchar *direction)
+{
+    const int size = static_cast<int>(taps.smooth.size());
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    const float32x4_t tan22 = vdupq_n_f32(TAN_22_5);
+    const float32x4_t tan67 = vdupq_n_f32(TAN_67_5);
+    for (; x + 4 <= width; x += 4) {
+        float32x4_t gx = vdupq_n_f32(0.0f);
+        float32x4_t gy = vdupq_n_f32(0.0f);
+        for (int k = 0; k < size; ++k) {
+            if (taps.derivative[k] != 0.0f) {
+                gx = vmlaq_n_f32(gx, vld1q_f32(smoothed + x + k), taps.derivative[k]);
+            }
+            gy = vmlaq_n_f32(gy, vld1q_f32(differenced + x + k), taps.smooth[k]);
+        }
+        const float32x4_t ax = vabsq_f32(gx);
+        const float32x4_t ay = vabsq_f32(gy);
+        vst1q_f32(magnitude + x, l2Gradient ? vmlaq_f32(vmulq_f32(gx, gx), gy, gy) : vaddq_f32(ax, ay));
+
+        // 斜向时按符号选 1 或 3，再依次被垂直、水平覆盖
+        const uint32x4_t opposite = vshrq_n_u32(veorq_u32(vreinterpretq_u32_f32(gx), vreinterpretq_u32_f32(gy)), 31);
+        uint32x4_t code = vaddq_u32(vdupq_n_u32(Diagonal), vshlq_n_u32(opposite, 1));
+        code = vbslq_u32(vcgtq_f32(ay, vmulq_f32(ax, tan67)), vdupq_n_u32(Vertical), code);
+        code = vbslq_u32(vcltq_f32(ay, vmulq_f32(ax, tan22)), vdupq_n_u32(Horizontal), code);
+        const uint8x8_t bytes = vmovn_u16(vcombine_u16(vmovn_u32(code), vdup_n_u16(0)));
+        vst1_lane_u32(reinterpret_cast<uint32_t *>(direction + x), vreinterpret_u32_u8(bytes), 0);
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128 tan22 = _mm_set1_ps(TAN_22_5);
+    const __m128 tan67 = _mm_set1_ps(TAN_67_5);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; x + 4 <= width; x += 4) {
+        __m128 gx = _mm_setzero_ps();
+        __m128 gy = _mm_setzero_ps();
+        for (int k = 0; k < size; ++k) {
+            if (taps.derivative[k] != 0.0f) {
+                gx = _mm_add_ps(gx, _mm_mul_ps(_mm_loadu_ps(smoothed + x + k), _mm_set1_ps(taps.derivative[k])));
+            }
+            gy = _mm_add_ps(gy, _mm_mul_ps(_mm_loadu_ps(differenced + x + k), _mm_set1_ps(taps.smooth[k])));
+        }
+        const __m128 ax = _mm_and_ps(gx, absMask);
+        const __m128 ay = _mm_and_ps(gy, absMask);
+        _mm_storeu_ps(magnitude + x, l2Gradient ? _mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy))
+                                                : _mm_add_ps(ax, ay));
+
+        // 斜向时按符号选 1 或 3，再依次被垂直、水平覆盖
+        const __m128i opposite = _mm_srli_epi32(_mm_castps_si128(_mm_xor_ps(gx, gy)), 31);
+        __m128i code = _mm_add_epi32(_mm_set1_epi32(Diagonal), _mm_slli_epi32(opposite, 1));
+        const __m128i vertical = _mm_castps_si128(_mm_cmpgt_ps(ay, _mm_mul_ps(ax, tan67)));
+        code = _mm_or_si128(_mm_andnot_si128(vertical, code), _mm_and_si128(vertical, _mm_set1_epi32(Vertical)));
+        const __m128i horizontal = _mm_castps_si128(_mm_cmplt_ps(ay, _mm_mul_ps(ax, tan22)));
+        code = _mm_andnot_si128(horizontal, code);
+        const __m128i words = _mm_packs_epi32(code, code);
+        const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+        std::memcpy(direction + x, &bytes, sizeof(bytes));
+    }
+#endif
+    for (; x < width; ++x) {
+        float gx = 0.0f;
+        float gy = 0.0f;
+        for (int k = 0; k < size; ++k) {
+            gx += smoothed[x + k] * taps.derivative[k];
+            gy += differenced[x + k] * taps.smooth[k];
+        }
+        magnitude[x] = l2Gradient ? gx * gx + gy * gy : std::fabs(gx) + std::fabs(gy);
+        direction[x] = directionOf(gx, gy);
+    }
+}
+
+/**
+ * 一行的非极大值抑制。magnitude 三行左右各填充一个 0，direction 为本行方向。
+ * 相等时的取舍与 OpenCV 一致：水平、垂直方向与后一个邻居相等仍保留，避免平台状边缘整段丢失。
+ */
+void suppressRow(const float *above, const float *current, const float *below,
+                 const uchar *direction, int width, float *maxima)
+{
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    for (; x + 4 <= width; x += 4) {
+        const float32x4_t m = vld1q_f32(current + x + 1);
+        const uint32x4_t horizontal = vandq_u32(vcgtq_f32(m, vld1q_f32(current + x)),
+                                                vcgeq_f32(m, vld1q_f32(current + x + 2)));
+        const uint32x4_t vertical = vandq_u32(vcgtq_f32(m, vld1q_f32(above + x + 1)),
+                                              vcgeq_f32(m, vld1q_f32(below + x + 1)));
+        const uint32x4_t diagonal = vandq_u32(vcgtq_f32(m, vld1q_f32(above + x)),
+                                              vcgtq_f32(m, vld1q_f32(below + x + 2)));
+        const uint32x4_t antiDiagonal = vandq_u32(vcgtq_f32(m, vld1q_f32(above + x + 2)),
+                                                  vcgtq_f32(m, vld1q_f32(below + x)));
+
+        quint32 packed;
+        std::memcpy(&packed, direction + x, sizeof(packed));
+        const uint32x4_t code = vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)))));
+        uint32x4_t keep = vandq_u32(vceqq_u32(code, vdupq_n_u32(Horizontal)), horizontal);
+        keep = vorrq_u32(keep, vandq_u32(vceqq_u32(code, vdupq_n_u32(Vertical)), vertical));
+        keep = vorrq_u32(keep, vandq_u32(vceqq_u32(code, vdupq_n_u32(Diagonal)), diagonal));
+        keep = vorrq_u32(keep, vandq_u32(vceqq_u32(code, vdupq_n_u32(AntiDiagonal)), antiDiagonal));
+        vst1q_f32(maxima + x, vreinterpretq_f32_u32(vandq_u32(keep, vreinterpretq_u32_f32(m))));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= width; x += 4) {
+        const __m128 m = _mm_loadu_ps(current + x + 1);
+        const __m128 horizontal = _mm_and_ps(_mm_cmpgt_ps(m, _mm_loadu_ps(current + x)),
+                                             _mm_cmpge_ps(m, _mm_loadu_ps(current + x + 2)));
+        const __m128 vertical = _mm_and_ps(_mm_cmpgt_ps(m, _mm_loadu_ps(above + x + 1)),
+                                           _mm_cmpge_ps(m, _mm_loadu_ps(below + x + 1)));
+        const __m128 diagonal = _mm_and_ps(_mm_cmpgt_ps(m, _mm_loadu_ps(above + x)),
+                                           _mm_cmpgt_ps(m, _mm_loadu_ps(below + x + 2)));
+        const __m128 antiDiagonal = _mm_and_ps(_mm_cmpgt_ps(m, _mm_loadu_ps(above + x + 2)),
+                                               _mm_cmpgt_ps(m, _mm_loadu_ps(below + x)));
+
+        int packed;
+        std::memcpy(&packed, direction + x, sizeof(packed));
+        const __m128i code = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+        auto select = [code](Direction value, __m128 test) {
+            return _mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(code, _mm_set1_epi32(value))), test);
+        };
+        const __m128 keep = _mm_or_ps(_mm_or_ps(select(Horizontal, horizontal), select(Vertical, vertical)),
+                                      _mm_or_ps(select(Diagonal, diagonal), select(AntiDiagonal, antiDiagonal)));
+        _mm_storeu_ps(maxima + x, _mm_and_ps(keep, m));
+    }
+#endif
+    for (; x < width; ++x) {
+        const float m = current[x + 1];
+        bool keep = false;
+        switch (direction[x]) {
+            case Horizontal: keep = m > current[x] && m >= current[x + 2]; break;
+            case Vertical: keep = m > above[x + 1] && m >= below[x + 1]; break;
+            case Diagonal: keep = m > above[x] && m > below[x + 2]; break;
+            default: keep = m > above[x + 2] && m > below[x]; break;
+        }
+        maxima[x] = keep ? m : 0.0f;
+    }
+}
+
+/**
+ * 一个行带的梯度与非极大值抑制。幅值按行号保存在三行环形缓冲中，
+ * 图像上下之外的行幅值为 0。
+ */
+class SuppressionBand
+{
+public:
+    SuppressionBand(const QImage &gray, const GradientTaps &taps, bool l2Gradient)
+        : m_gray(gray)
+        , m_taps(taps)
+        , m_l2Gradient(l2Gradient)
+        , m_width(gray.width())
+        , m_height(gray.height())
+        , m_radius(static_cast<int>(taps.smooth.size()) / 2)
+        , m_smoothed(static_cast<size_t>(m_width + 2 * m_radius))
+        , m_differenced(static_cast<size_t>(m_width + 2 * m_radius))
+        , m_magnitude(static_cast<size_t>(m_width + 2) * 3, 0.0f)
+        , m_direction(static_cast<size_t>(m_width) * 3)
+    {
+    }
+
+    void run(int y0, int y1, float *maxima)
+    {
+        computeRow(y0 - 1);
+        computeRow(y0);
+        for (int y = y0; y < y1; ++y) {
+            computeRow(y + 1);
+            suppressRow(magnitudeRow(y - 1), magnitudeRow(y), magnitudeRow(y + 1),
+                        directionRow(y), m_width, maxima + static_cast<size_t>(y) * m_width);
+        }
+    }
+
+private:
+    int slot(int y) const { return (y + 3) % 3; }
+    float *magnitudeRow(int y) { return m_magnitude.data() + static_cast<size_t>(slot(y)) * (m_width + 2); }
+    uchar *directionRow(int y) { return m_direction.data() + static_cast<size_t>(slot(y)) * m_width; }
+
+    void computeRow(int y)
+    {
+        float *magnitude = magnitudeRow(y);
+        if (y < 0 || y >= m_height) {
+            std::fill(magnitude, magnitude + m_width + 2, 0.0f);
+            return;
+        }
+
+        // 垂直方向：平滑与差分同时累加，边界行复制
+        float *smoothed = m_smoothed.data() + m_radius;
+        float *differenced = m_differenced.data() + m_radius;
+        std::fill(smoothed, smoothed + m_width, 0.0f);
+        std::fill(differenced, differenced + m_width, 0.0f);
+        const int size = static_cast<int>(m_taps.smooth.size());
+        for (int k = 0; k < size; ++k) {
+            const uchar *line = m_gray.constScanLine(std::min(std::max(y + k - m_radius, 0), m_height - 1));
+            const float s = m_taps.smooth[k];
+            const float d = m_taps.derivative[k];
+            for (int x = 0; x < m_width; ++x) {
+                smoothed[x] += s * line[x];
+                differenced[x] += d * line[x];
+            }
+        }
+        // 列的复制边界等价于对垂直结果复制两端
+        std::fill(m_smoothed.begin(), m_smoothed.begin() + m_radius, smoothed[0]);
+        std::fill(m_smoothed.end() - m_radius, m_smoothed.end(), smoothed[m_width - 1]);
+        std::fill(m_differenced.begin(), m_differenced.begin() + m_radius, differenced[0]);
+        std::fill(m_differenced.end() - m_radius, m_differenced.end(), differenced[m_width - 1]);
+
+        magnitude[0] = 0.0f;
+        magnitude[m_width + 1] = 0.0f;
+        gradientRow(m_taps, m_smoothed.data(), m_differenced.data(), m_width, m_l2Gradient,
+                    magnitude + 1, directionRow(y));
+    }
+
+    const QImage &m_gray;
+    const GradientTaps &m_taps;
+    bool m_l2Gradient;
+    int m_width;
+    int m_height;
+    int m_radius;
+    std::vector<float> m_smoothed;
+    std::vector<float> m_differenced;
+    std::vector<float> m_magnitude;  // 三行，左右各填充一个 0
+    std::vector<uchar> m_direction;  // 三行
+};
+
+} // namespace
+
+CannyDetector::CannyDetector(const QImage &image, int apertureSize, bool l2Gradient)
+    : m_l2Gradient(l2Gradient)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    const QImage gray = image.format() == QImage::Format_Grayscale8
+                            ? image
+                            : image.convertToFormat(QImage::Format_Grayscale8);
+    m_width = gray.width();
+    m_height = gray.height();
+    m_maxima.resize(static_cast<size_t>(m_width) * m_height);
+
+    if (apertureSize % 2 == 0) {
+        ++apertureSize;
+    }
+    const GradientTaps taps = sobelTaps(std::min(std::max(apertureSize, 3), 7));
+
+    TiledExecutor::forEachRowBand(m_height, BAND_ROWS, [&](int y0, int y1) {
+        SuppressionBand band(gray, taps, l2Gradient);
+        band.run(y0, y1, m_maxima.data());
+    });
+}
+
+QImage CannyDetector::detect(double lowThreshold, double highThreshold) const
+{
+    if (m_maxima.empty()) {
+        return QImage();
+    }
+
+    if (lowThreshold > highThreshold) {
+        std::swap(lowThreshold, highThreshold);
+    }
+    // 非极大值的幅值为 0，阈值不能为负
+    float low = static_cast<float>(std::max(lowThreshold, 0.0));
+    float high = static_cast<float>(std::max(highThreshold, 0.0));
+    if (m_l2Gradient) {
+        low *= low;
+        high *= high;
+    }
+
+    // 紧凑边缘图四周留一圈 NotEdge，连接时不必判断越界
+    const int stride = m_width + 2;
+    std::vector<uchar> map(static_cast<size_t>(stride) * (m_height + 2), NotEdge);
+    std::vector<uchar *> stack;
+
+    for (int y = 0; y < m_height; ++y) {
+        const float *maxima = m_maxima.data() + static_cast<size_t>(y) * m_width;
+        uchar *row = map.data() + static_cast<size_t>(y + 1) * stride + 1;
+        for (int x = 0; x < m_width; ++x) {
+            const float m = maxima[x];
+            if (m > high) {
+                row[x] = Edge;
+                stack.push_back(row + x);
+            } else if (m > low) {
+                row[x] = Candidate;
+            }
+        }
+    }
+
+    // 滞后连接：从强边缘出发，把八邻域内的候选点逐个并入
+    const std::ptrdiff_t neighbors[8] = {-stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1};
+    while (!stack.empty()) {
+        uchar *pixel = stack.back();
+        stack.pop_back();
+        for (std::ptrdiff_t offset : neighbors) {
+            if (pixel[offset] == Candidate) {
+                pixel[offset] = Edge;
+                stack.push_back(pixel + offset);
+            }
+        }
+    }
+
+    QImage result(m_width, m_height, QImage::Format_Grayscale8);
+    for (int y = 0; y < m_height; ++y) {
+        const uchar *row = map.data() + static_cast<size_t>(y + 1) * stride + 1;
+        uchar *out = result.scanLine(y);
+        for (int x = 0; x < m_width; ++x) {
+            out[x] = row[x] == Edge ? 255 : 0;
+        }
+    }
+    return result;
+}
+
+QImage CannyDetector::detect(const QImage &image, double lowThreshold, double highThreshold,
+                             int apertureSize, bool l2Gradient)
+{
+    return CannyDetector(image, apertureSize, l2Gradient).detect(lowThreshold, highThreshold);
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,52 @@
+#ifndef CANNYDETECTOR_H
+#define CANNYDETECTOR_H
+
+#include <QImage>
+#include <vector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief Canny 边缘检测
+ *
+ * 构造时完成与阈值无关的部分：Sobel 梯度的幅值与方向在同一趟 SSE2/NEON 行处理中算出，
+ * 随即逐行做非极大值抑制，只保留局部极大值的幅值；各行带在线程池上并行处理。
+ * detect() 只需按阈值把极大值分类到紧凑的边缘图，再从强边缘出发用显式栈做滞后连接，
+ * 同一幅图像反复调节阈值时不必重算梯度。
+ *
+ * 约定与 OpenCV Canny 一致：梯度按复制边界计算，默认使用 L1 幅值 |gx| + |gy|，
+ * 幅值大于低阈值的极大值为候选，大于高阈值的为强边缘。
+ */
+class CannyDetector
+{
+public:
+    /**
+     * @param apertureSize Sobel 孔径，取 3、5 或 7（偶数加一并钳制到该范围）
+     * @param l2Gradient 为 true 时使用 sqrt(gx² + gy²) 作为幅值
+     */
+    explicit CannyDetector(const QImage &image, int apertureSize = 3, bool l2Gradient = false);
+
+    /**
+     * @brief 按阈值做滞后连接
+     * @return Format_Grayscale8 图像，边缘为 255，其余为 0；两个阈值顺序颠倒时自动交换
+     */
+    QImage detect(double lowThreshold, double highThreshold) const;
+
+    /**
+     * @brief 单次检测
+     */
+    static QImage detect(const QImage &image, double lowThreshold, double highThreshold,
+                         int apertureSize = 3, bool l2Gradient = false);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    bool m_l2Gradient = false;
+    std::vector<float> m_maxima;  // 非极大值抑制后的幅值，非极大值为 0（L2 时为平方）
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // CANNYDETECTOR_H
@@ -0,0 +1,590 @@
+/**
+ * @file convolution.cpp
+ * @brief 基于扫描行的卷积引擎实现
+ */
+
+#include "convolution.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(GPCV_SIMD_X86)
+#include <immintrin.h>
+#endif
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+// ========== 行内核 ==========
+// 所有卷积都归结为几种对整行浮点数的操作，按指令集各实现一份
+
+namespace {
+
+struct RowKernels {
+    void (*mul)(float *dst, const float *src, float weight, int n);   // dst = w * src
+    void (*axpy)(float *dst, const float *src, float weight, int n);  // dst += w * src
+    void (*store)(uchar *dst, const float *src, float scale, float offset, bool absolute, int n);
+    void (*magnitude)(float *dst, const float *gx, const float *gy, int n);
+};
+
+void mulScalar(float *dst, const float *src, float weight, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] = weight * src[i];
+    }
+}
+
+void axpyScalar(float *dst, const float *src, float weight, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] += weight * src[i];
+    }
+}
+
+// 与 SIMD 版本一致：钳制后按当前舍入模式（就近取偶）取整
+inline uchar storeOne(float v, float scale, float offset, bool absolute)
+{
+    if (absolute) {
+        v = std::fabs(v);
+    }
+    v = std::min(std::max(v * scale + offset, 0.0f), 255.0f);
+    return static_cast<uchar>(std::lrintf(v));
+}
+
+void storeScalar(uchar *dst, const float *src, float scale, float offset, bool absolute, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] = storeOne(src[i], scale, offset, absolute);
+    }
+}
+
+void magnitudeScalar(float *dst, const float *gx, const float *gy, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        dst[i] = std::sqrt(gx[i] * gx[i] + gy[i] * gy[i]);
+    }
+}
+
+#if defined(GPCV_SIMD_X86)
+
+GPCV_TARGET_SSE2 void mulSse2(float *dst, const float *src, float weight, int n)
+{
+    const __m128 w = _mm_set1_ps(weight);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(w, _mm_loadu_ps(src + i)));
+    }
+    mulScalar(dst + i, src + i, weight, n - i);
+}
+
+GPCV_TARGET_SSE2 void axpySse2(float *dst, const float *src, float weight, int n)
+{
+    const __m128 w = _mm_set1_ps(weight);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 acc = _mm_loadu_ps(dst + i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(w, _mm_loadu_ps(src + i)));
+        _mm_storeu_ps(dst + i, acc);
+    }
+    axpyScalar(dst + i, src + i, weight, n - i);
+}
+
+GPCV_TARGET_SSE2 void storeSse2(uchar *dst, const float *src, float scale, float offset, bool absolute, int n)
+{
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 o = _mm_set1_ps(offset);
+    const __m128 maxValue = _mm_set1_ps(255.0f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(absolute ? 0x7fffffff : -1));
+
+    auto convert = [&](const float *p) {
+        __m128 v = _mm_and_ps(_mm_loadu_ps(p), absMask);
+        v = _mm_min_ps(_mm_add_ps(_mm_mul_ps(v, s), o), maxValue);
+        return _mm_cvtps_epi32(v);
+    };
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        // 有符号/无符号饱和打包完成 0-255 钳制
+        const __m128i lo = _mm_packs_epi32(convert(src + i), convert(src + i + 4));
+        const __m128i hi = _mm_packs_epi32(convert(src + i + 8), convert(src + i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    storeScalar(dst + i, src + i, scale, offset, absolute, n - i);
+}
+
+GPCV_TARGET_SSE2 void magnitudeSse2(float *dst, const float *gx, const float *gy, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 x = _mm_loadu_ps(gx + i);
+        const __m128 y = _mm_loadu_ps(gy + i);
+        _mm_storeu_ps(dst + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+    }
+    magnitudeScalar(dst + i, gx + i, gy + i, n - i);
+}
+
+GPCV_TARGET_AVX2 void mulAvx2(float *dst, const float *src, float weight, int n)
+{
+    const __m256 w = _mm256_set1_ps(weight);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(w, _mm256_loadu_ps(src + i)));
+    }
+    mulScalar(dst + i, src + i, weight, n - i);
+}
+
+GPCV_TARGET_AVX2 void axpyAvx2(float *dst, const float *src, float weight, int n)
+{
+    const __m256 w = _mm256_set1_ps(weight);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_loadu_ps(dst + i);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(w, _mm256_loadu_ps(src + i)));
+        _mm256_storeu_ps(dst + i, acc);
+    }
+    axpyScalar(dst + i, src + i, weight, n - i);
+}
+
+GPCV_TARGET_AVX2 void storeAvx2(uchar *dst, const float *src, float scale, float offset, bool absolute, int n)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 o = _mm256_set1_ps(offset);
+    const __m256 maxValue = _mm256_set1_ps(255.0f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(absolute ? 0x7fffffff : -1));
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_and_ps(_mm256_loadu_ps(src + i), absMask);
+        v = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(v, s), o), maxValue);
+        const __m256i words = _mm256_cvtps_epi32(v);
+        const __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(words),
+                                               _mm256_extracti128_si256(words, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(packed, packed));
+    }
+    storeScalar(dst + i, src + i, scale, offset, absolute, n - i);
+}
+
+GPCV_TARGET_AVX2 void magnitudeAvx2(float *dst, const float *gx, const float *gy, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 x = _mm256_loadu_ps(gx + i);
+        const __m256 y = _mm256_loadu_ps(gy + i);
+        _mm256_storeu_ps(dst + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))));
+    }
+    magnitudeScalar(dst + i, gx + i, gy + i, n - i);
+}
+
+#endif // GPCV_SIMD_X86
+
+#if defined(GPCV_SIMD_NEON)
+
+void mulNeon(float *dst, const float *src, float weight, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), weight));
+    }
+    mulScalar(dst + i, src + i, weight, n - i);
+}
+
+void axpyNeon(float *dst, const float *src, float weight, int n)
+{
+    const float32x4_t w = vdupq_n_f32(weight);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), w, vld1q_f32(src + i)));
+    }
+    axpyScalar(dst + i, src + i, weight, n - i);
+}
+
+void storeNeon(uchar *dst, const float *src, float scale, float offset, bool absolute, int n)
+{
+    const float32x4_t s = vdupq_n_f32(scale);
+    const float32x4_t o = vdupq_n_f32(offset);
+    const float32x4_t maxValue = vdupq_n_f32(255.0f);
+
+    auto convert = [&](const float *p) {
+        float32x4_t v = vld1q_f32(p);
+        if (absolute) {
+            v = vabsq_f32(v);
+        }
+        v = vminq_f32(vmlaq_f32(o, v, s), maxValue);
+        return vqmovun_s32(vcvtnq_s32_f32(v));
+    };
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        vst1_u8(dst + i, vqmovn_u16(vcombine_u16(convert(src + i), convert(src + i + 4))));
+    }
+    storeScalar(dst + i, src + i, scale, offset, absolute, n - i);
+}
+
+void magnitudeNeon(float *dst, const float *gx, const float *gy, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t x = vld1q_f32(gx + i);
+        const float32x4_t y = vld1q_f32(gy + i);
+        vst1q_f32(dst + i, vsqrtq_f32(vmlaq_f32(vmulq_f32(x, x), y, y)));
+    }
+    magnitudeScalar(dst + i, gx + i, gy + i, n - i);
+}
+
+#endif // GPCV_SIMD_NEON
+
+const RowKernels &rowKernels()
+{
+    static const RowKernels scalar = {mulScalar, axpyScalar, storeScalar, magnitudeScalar};
+#if defined(GPCV_SIMD_X86)
+    static const RowKernels sse2 = {mulSse2, axpySse2, storeSse2, magnitudeSse2};
+    static const RowKernels avx2 = {mulAvx2, axpyAvx2, storeAvx2, magnitudeAvx2};
+#endif
+#if defined(GPCV_SIMD_NEON)
+    static const RowKernels neon = {mulNeon, axpyNeon, storeNeon, magnitudeNeon};
+#endif
+
+    switch (SimdSupport::activeLevel()) {
+#if defined(GPCV_SIMD_X86)
+        case SimdLevel::AVX2: return avx2;
+        case SimdLevel::SSE2: return sse2;
+#endif
+#if defined(GPCV_SIMD_NEON)
+        case SimdLevel::NEON: return neon;
+#endif
+        default: return scalar;
+    }
+}
+
+// ========== 行滤波器 ==========
+
+/**
+ * 逐行计算卷积结果（未缩放的浮点值）。
+ *
+ * 源行展开为左右各填充 radiusX 个复制像素的浮点行；可分离核缓存的是水平卷积后的行，
+ * 不可分离核缓存的是填充后的源行。缓存为 kernelHeight 行的环形缓冲，按行号顺序
+ * 计算时每行只读取一次源数据。
+ */
+class RowFilter
+{
+public:
+    RowFilter(const QImage &source, int channels, const ConvolutionKernel &kernel, const RowKernels &simd)
+        : m_source(source)
+        , m_channels(channels)
+        , m_width(source.width())
+        , m_height(source.height())
+        , m_kernel(kernel)
+        , m_simd(simd)
+        , m_radiusX(kernel.width / 2)
+        , m_radiusY(kernel.height / 2)
+        , m_rowLength(source.width() * channels)
+    {
+        // 3x3 及以上的秩一核拆成两次一维卷积更快
+        m_separable = kernel.width * kernel.height > kernel.width + kernel.height
+                      && kernel.decompose(m_row, m_column);
+
+        const int paddedLength = (m_width + 2 * m_radiusX) * m_channels;
+        m_preparedLength = m_separable ? m_rowLength : paddedLength;
+        m_padded.resize(static_cast<size_t>(paddedLength));
+        m_ring.resize(static_cast<size_t>(m_preparedLength) * kernel.height);
+        m_ringTag.assign(static_cast<size_t>(kernel.height), -1);
+    }
+
+    int rowLength() const { return m_rowLength; }
+
+    void compute(int y, float *out)
+    {
+        if (m_separable) {
+            for (int i = 0; i < m_kernel.height; ++i) {
+                const float *row = preparedRow(clampRow(y + i - m_radiusY));
+                if (i == 0) {
+                    m_simd.mul(out, row, m_column[i], m_rowLength);
+                } else if (m_column[i] != 0.0f) {
+                    m_simd.axpy(out, row, m_column[i], m_rowLength);
+                }
+            }
+            return;
+        }
+
+        std::fill(out, out + m_rowLength, 0.0f);
+        for (int i = 0; i < m_kernel.height; ++i) {
+            const float *row = preparedRow(clampRow(y + i - m_radiusY));
+            for (int j = 0; j < m_kernel.width; ++j) {
+                const float weight = m_kernel.at(j, i);
+                if (weight != 0.0f) {
+                    m_simd.axpy(out, row + j * m_channels, weight, m_rowLength);
+                }
+            }
+        }
+    }
+
+private:
+    int clampRow(int y) const { return std::min(std::max(y, 0), m_height - 1); }
+
+    // 源行转为浮点并在两端填充复制的边缘像素
+    void loadPadded(int y, float *padded) const
+    {
+        const uchar *line = m_source.constScanLine(y);
+        float *body = padded + m_radiusX * m_channels;
+        for (int i = 0; i < m_rowLength; ++i) {
+            body[i] = line[i];
+        }
+
+        const float *first = body;
+        const float *last = body + m_rowLength - m_channels;
+        for (int p = 0; p < m_radiusX; ++p) {
+            std::memcpy(padded + p * m_channels, first, sizeof(float) * m_channels);
+            std::memcpy(body + m_rowLength + p * m_channels, last, sizeof(float) * m_channels);
+        }
+    }
+
+    const float *preparedRow(int y)
+    {
+        const int slot = y % m_kernel.height;
+        float *cached = m_ring.data() + static_cast<size_t>(slot) * m_preparedLength;
+        if (m_ringTag[slot] == y) {
+            return cached;
+        }
+
+        if (m_separable) {
+            loadPadded(y, m_padded.data());
+            m_simd.mul(cached, m_padded.data(), m_row[0], m_rowLength);
+            for (int j = 1; j < m_row.size(); ++j) {
+                if (m_row[j] != 0.0f) {
+                    m_simd.axpy(cached, m_padded.data() + j * m_channels, m_row[j], m_rowLength);
+                }
+            }
+        } else {
+            loadPadded(y, cached);
+        }
+
+        m_ringTag[slot] = y;
+        return cached;
+    }
+
+    const QImage &m_source;
+    int m_channels;
+    int m_width;
+    int m_height;
+    const ConvolutionKernel &m_kernel;
+    const RowKernels &m_simd;
+    int m_radiusX;
+    int m_radiusY;
+    int m_rowLength;
+    int m_preparedLength = 0;
+    bool m_separable = false;
+    QVector<float> m_row;
+    QVector<float> m_column;
+    std::vector<float> m_padded;
+    std::vector<float> m_ring;
+    std::vector<int> m_ringTag;
+};
+
+// 统一为单通道灰度或四通道 32 位格式
+QImage normalizedSource(const QImage &image, int &channels)
+{
+    switch (image.format()) {
+        case QImage::Format_Grayscale8:
+            channels = 1;
+            return image;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            channels = 4;
+            return image;
+        default:
+            channels = 4;
+            return image.convertToFormat(QImage::Format_ARGB32);
+    }
+}
+
+} // namespace
+
+// ========== ConvolutionKernel ==========
+
+template <typename T>
+static ConvolutionKernel kernelFromMatrix(const QVector<QVector<T>> &matrix)
+{
+    ConvolutionKernel kernel;
+    kernel.height = matrix.size();
+    kernel.width = matrix.isEmpty() ? 0 : matrix[0].size();
+    kernel.weights.reserve(kernel.width * kernel.height);
+    for (const QVector<T> &row : matrix) {
+        if (row.size() != kernel.width) {
+            return ConvolutionKernel();
+        }
+        for (T value : row) {
+            kernel.weights.append(static_cast<float>(value));
+        }
+    }
+    return kernel;
+}
+
+ConvolutionKernel ConvolutionKernel::fromMatrix(const QVector<QVector<int>> &matrix)
+{
+    return kernelFromMatrix(matrix);
+}
+
+ConvolutionKernel ConvolutionKernel::fromMatrix(const QVector<QVector<double>> &matrix)
+{
+    return kernelFromMatrix(matrix);
+}
+
+ConvolutionKernel ConvolutionKernel::fromSeparable(const QVector<float> &row, const QVector<float> &column)
+{
+    ConvolutionKernel kernel;
+    kernel.width = row.size();
+    kernel.height = column.size();
+    kernel.weights.reserve(kernel.width * kernel.height);
+    for (float c : column) {
+        for (float r : row) {
+            kernel.weights.append(c * r);
+        }
+    }
+    return kernel;
+}
+
+bool ConvolutionKernel::isValid() const
+{
+    return width > 0 && height > 0 && width % 2 == 1 && height % 2 == 1
+           && weights.size() == width * height;
+}
+
+bool ConvolutionKernel::decompose(QVector<float> &row, QVector<float> &column) const
+{
+    if (!isValid()) {
+        return false;
+    }
+
+    // 以绝对值最大的元素为主元：row 取主元所在行，column 取主元所在列并归一化
+    int pivot = 0;
+    for (int i = 1; i < weights.size(); ++i) {
+        if (std::fabs(weights[i]) > std::fabs(weights[pivot])) {
+            pivot = i;
+        }
+    }
+    const float pivotValue = weights[pivot];
+    if (pivotValue == 0.0f) {
+        return false;
+    }
+    const int px = pivot % width;
+    const int py = pivot / width;
+
+    row.resize(width);
+    column.resize(height);
+    for (int x = 0; x < width; ++x) {
+        row[x] = at(x, py);
+    }
+    for (int y = 0; y < height; ++y) {
+        column[y] = at(px, y) / pivotValue;
+    }
+
+    const float tolerance = std::fabs(pivotValue) * 1e-5f;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (std::fabs(column[y] * row[x] - at(x, y)) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ========== ConvolutionEngine ==========
+
+QImage ConvolutionEngine::convolve(const QImage &image, const ConvolutionKernel &kernel,
+                                   const ConvolutionOptions &options)
+{
+    if (image.isNull() || !kernel.isValid()) {
+        return image;
+    }
+
+    int channels = 4;
+    const QImage source = normalizedSource(image, channels);
+    QImage result(source.size(), source.format());
+
+    const RowKernels &simd = rowKernels();
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(result);
+
+    // RGB32 的 alpha 必须保持 0xff
+    const bool keepAlpha = channels == 4
+                           && (options.preserveAlpha || source.format() == QImage::Format_RGB32);
+
+    // 每个行带各用一个行滤波器，环形缓冲从行带上方 radiusY 行开始填充
+    const int bandRows = TiledExecutor::bandRowsFor(source.height(), kernel.height / 2);
+    TiledExecutor::forEachRowBand(source.height(), bandRows, [&](int y0, int y1) {
+        RowFilter filter(source, channels, kernel, simd);
+        std::vector<float> row(static_cast<size_t>(filter.rowLength()));
+
+        for (int y = y0; y < y1; ++y) {
+            filter.compute(y, row.data());
+            uchar *dst = lines[y];
+            simd.store(dst, row.data(), options.scale, options.offset, options.absolute,
+                       filter.rowLength());
+
+            if (keepAlpha) {
+                const QRgb *srcLine = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+                QRgb *dstLine = reinterpret_cast<QRgb *>(dst);
+                for (int x = 0; x < source.width(); ++x) {
+                    dstLine[x] = (dstLine[x] & 0x00ffffffu) | (srcLine[x] & 0xff000000u);
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+QImage ConvolutionEngine::gradientMagnitude(const QImage &image, const ConvolutionKernel &kernelX,
+                                            const ConvolutionKernel &kernelY, float scale)
+{
+    if (image.isNull() || !kernelX.isValid() || !kernelY.isValid()) {
+        return QImage();
+    }
+
+    const QImage gray = image.format() == QImage::Format_Grayscale8
+                            ? image
+                            : image.convertToFormat(QImage::Format_Grayscale8);
+    QImage result(gray.size(), QImage::Format_Grayscale8);
+
+    const RowKernels &simd = rowKernels();
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(result);
+    const int length = gray.width();
+
+    const int halo = std::max(kernelX.height, kernelY.height) / 2;
+    TiledExecutor::forEachRowBand(gray.height(), TiledExecutor::bandRowsFor(gray.height(), halo),
+                                  [&](int y0, int y1) {
+        RowFilter filterX(gray, 1, kernelX, simd);
+        RowFilter filterY(gray, 1, kernelY, simd);
+        std::vector<float> gx(static_cast<size_t>(length));
+        std::vector<float> gy(static_cast<size_t>(length));
+
+        for (int y = y0; y < y1; ++y) {
+            filterX.compute(y, gx.data());
+            filterY.compute(y, gy.data());
+            simd.magnitude(gx.data(), gx.data(), gy.data(), length);
+            simd.store(lines[y], gx.data(), scale, 0.0f, false, length);
+        }
+    });
+
+    return result;
+}
+
+ConvolutionKernel ConvolutionEngine::sobelX()
+{
+    return ConvolutionKernel::fromSeparable({-1.0f, 0.0f, 1.0f}, {1.0f, 2.0f, 1.0f});
+}
+
+ConvolutionKernel ConvolutionEngine::sobelY()
+{
+    return ConvolutionKernel::fromSeparable({1.0f, 2.0f, 1.0f}, {-1.0f, 0.0f, 1.0f});
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
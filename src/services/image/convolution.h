@@ -0,0 +1,95 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <QImage>
+#include <QVector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 卷积核（行优先存储，宽高为奇数）
+ */
+struct ConvolutionKernel {
+    int width = 0;
+    int height = 0;
+    QVector<float> weights;
+
+    ConvolutionKernel() = default;
+    ConvolutionKernel(int kernelWidth, int kernelHeight, const QVector<float> &kernelWeights)
+        : width(kernelWidth), height(kernelHeight), weights(kernelWeights) {}
+
+    static ConvolutionKernel fromMatrix(const QVector<QVector<int>> &matrix);
+    static ConvolutionKernel fromMatrix(const QVector<QVector<double>> &matrix);
+
+    /**
+     * @brief 由行向量和列向量构造可分离核（column ⊗ row）
+     */
+    static ConvolutionKernel fromSeparable(const QVector<float> &row, const QVector<float> &column);
+
+    bool isValid() const;
+
+    float at(int x, int y) const { return weights[y * width + x]; }
+
+    /**
+     * @brief 尝试分解为 column ⊗ row（秩为 1 的核）
+     * @return 可分离时返回 true 并填写 row / column
+     */
+    bool decompose(QVector<float> &row, QVector<float> &column) const;
+};
+
+/**
+ * @brief 卷积输出选项
+ *
+ * 每个通道的输出为 clamp(round(v * scale + offset), 0, 255)，
+ * absolute 为 true 时 v 先取绝对值（Laplacian 等零和算子）。
+ */
+struct ConvolutionOptions {
+    float scale = 1.0f;
+    float offset = 0.0f;
+    bool absolute = false;
+    bool preserveAlpha = true;  // 32 位图像保留原 alpha，不参与卷积结果
+};
+
+/**
+ * @brief 基于扫描行的卷积引擎
+ *
+ * 逐行读取 scanLine 并展开为带边界填充的浮点行缓冲，边界按复制边缘像素处理，
+ * 不做逐像素的坐标钳制。可分离核先做水平一维卷积并缓存 kernelHeight 行，
+ * 再做垂直一维卷积；不可分离核逐行累加。内层循环按 SimdSupport::activeLevel()
+ * 选择 AVX2 / SSE2 / NEON / 标量实现。
+ * 图像按行带在 TiledExecutor 上并行处理，每个行带从上方 kernelHeight / 2 行开始填充行缓冲。
+ *
+ * 支持 Format_Grayscale8（单通道）和 32 位 RGB 格式（四通道），
+ * 其它格式先转换为 Format_ARGB32。
+ */
+class ConvolutionEngine
+{
+public:
+    /**
+     * @brief 对图像做二维卷积
+     * @return 格式与输入（转换后）相同的结果
+     */
+    static QImage convolve(const QImage &image, const ConvolutionKernel &kernel,
+                           const ConvolutionOptions &options = ConvolutionOptions());
+
+    /**
+     * @brief 梯度幅值 sqrt(gx² + gy²)
+     *
+     * 输入先转换为灰度，两个方向的卷积逐行同时计算。
+     * @return Format_Grayscale8 图像，幅值乘以 scale 后钳制到 0-255
+     */
+    static QImage gradientMagnitude(const QImage &image, const ConvolutionKernel &kernelX,
+                                    const ConvolutionKernel &kernelY, float scale = 1.0f);
+
+    /**
+     * @brief 3x3 Sobel 核
+     */
+    static ConvolutionKernel sobelX();
+    static ConvolutionKernel sobelY();
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // CONVOLUTION_H
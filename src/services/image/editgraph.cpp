@@ -0,0 +1,416 @@
+/**
+ * @file editgraph.cpp
+ * @brief 按需求值的编辑链实现
+ */
+
+#include "editgraph.h"
+#include "gaussianblur.h"
+#include "imageprocessor.h"
+#include "pointoperations.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+// 3x3 卷积核的邻域半径
+int unitHalo(double)
+{
+    return 1;
+}
+
+} // namespace
+
+// ==================== EditOperation ====================
+
+EditOperation EditOperation::rotate(qreal angle)
+{
+    EditOperation operation;
+    if (angle == -90) {
+        operation.name = "向左旋转90°";
+    } else if (angle == 90) {
+        operation.name = "向右旋转90°";
+    } else {
+        operation.name = QString("旋转 %1°").arg(angle);
+    }
+    operation.local = false;
+    operation.apply = [angle](const QImage &input, double) {
+        return ImageProcessor::rotate(input, angle);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::flipHorizontal()
+{
+    EditOperation operation;
+    operation.name = "水平翻转";
+    operation.local = false;
+    operation.apply = [](const QImage &input, double) {
+        return ImageProcessor::flipHorizontal(input);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::flipVertical()
+{
+    EditOperation operation;
+    operation.name = "垂直翻转";
+    operation.local = false;
+    operation.apply = [](const QImage &input, double) {
+        return ImageProcessor::flipVertical(input);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::grayscale()
+{
+    EditOperation operation;
+    operation.name = "灰度化";
+    operation.apply = [](const QImage &input, double) {
+        return ImageProcessor::toGrayscale(input);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::invert()
+{
+    EditOperation operation;
+    operation.name = "反色";
+    operation.apply = [](const QImage &input, double) {
+        return PointOperations::invert(input);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::gaussianBlur(int radius)
+{
+    // 与 ImageProcessor::gaussianBlur 一致：sigma² = radius，缩小层上 sigma 按比例缩小
+    const double sigma = qSqrt(std::max(radius, 0));
+
+    EditOperation operation;
+    operation.name = QString("模糊处理 (半径=%1)").arg(radius);
+    operation.halo = [sigma](double scale) {
+        int extent = 0;
+        for (const BoxFilter &box : GaussianBlur::boxFilters(sigma * scale)) {
+            extent += box.radius + 1;
+        }
+        return extent;
+    };
+    operation.apply = [sigma](const QImage &input, double scale) {
+        if (sigma <= 0.0) {
+            return input;
+        }
+        return GaussianBlur::blur(input.convertToFormat(QImage::Format_RGB32), sigma * scale);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::sharpen(double strength)
+{
+    EditOperation operation;
+    operation.name = QString("锐化处理 (强度=%1)").arg(strength);
+    operation.halo = unitHalo;
+    operation.apply = [strength](const QImage &input, double) {
+        return ImageProcessor::sharpen(input, strength);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::sobelEdges()
+{
+    EditOperation operation;
+    operation.name = "Sobel边缘检测";
+    operation.halo = unitHalo;
+    operation.apply = [](const QImage &input, double) {
+        return ImageProcessor::sobelEdgeDetection(input);
+    };
+    return operation;
+}
+
+EditOperation EditOperation::threshold(int value)
+{
+    EditOperation operation;
+    operation.name = QString("二值化 (阈值=%1)").arg(value);
+    operation.apply = [value](const QImage &input, double) {
+        return PointOperations::threshold(input, value);
+    };
+    return operation;
+}
+
+// ==================== EditGraph ====================
+
+EditGraph::EditGraph(const QImage &source)
+    : m_pyramid(source)
+{
+}
+
+void EditGraph::setSource(const QImage &source)
+{
+    m_pyramid.setBase(source);
+    invalidateFrom(0);
+}
+
+void EditGraph::append(const EditOperation &operation)
+{
+    m_redoOperations.clear();
+    m_nodes.append(Node{operation, {}});
+}
+
+void EditGraph::insert(int index, const EditOperation &operation)
+{
+    invalidateFrom(index);
+    m_nodes.insert(index, Node{operation, {}});
+}
+
+void EditGraph::replace(int index, const EditOperation &operation)
+{
+    invalidateFrom(index);
+    m_nodes[index].operation = operation;
+}
+
+void EditGraph::remove(int index)
+{
+    invalidateFrom(index);
+    m_nodes.remove(index);
+}
+
+void EditGraph::truncate(int count)
+{
+    if (count < m_nodes.size()) {
+        invalidateFrom(count);
+        m_nodes.resize(count);
+    }
+}
+
+bool EditGraph::undo()
+{
+    if (m_nodes.isEmpty()) {
+        return false;
+    }
+    m_redoOperations.append(m_nodes.last().operation);
+    truncate(m_nodes.size() - 1);
+    return true;
+}
+
+bool EditGraph::redo()
+{
+    if (m_redoOperations.isEmpty()) {
+        return false;
+    }
+    m_nodes.append(Node{m_redoOperations.takeLast(), {}});
+    return true;
+}
+
+QImage EditGraph::foldFirst()
+{
+    if (m_nodes.isEmpty() || source().isNull()) {
+        return QImage();
+    }
+
+    const QImage previous = source();
+    const QImage folded = evaluate(0, 0, QRect(QPoint(0, 0), nodeSize(0, 0)));
+
+    for (const CacheEntry &entry : m_nodes.first().cache) {
+        m_cachedBytes -= entry.image.sizeInBytes();
+    }
+    m_nodes.removeFirst();
+
+    // 缩小层由新原图重新生成，与原来逐层运算的结果不完全相同
+    for (Node &node : m_nodes) {
+        for (int i = node.cache.size() - 1; i >= 0; --i) {
+            if (node.cache[i].level > 0) {
+                m_cachedBytes -= node.cache[i].image.sizeInBytes();
+                node.cache.remove(i);
+            }
+        }
+    }
+    m_pyramid.setBase(folded);
+    return previous;
+}
+
+QImage EditGraph::result()
+{
+    return render(QRect(QPoint(0, 0), outputSize(0)), 0);
+}
+
+QSize EditGraph::outputSize(int level)
+{
+    if (source().isNull()) {
+        return QSize();
+    }
+    return nodeSize(m_nodes.size() - 1, std::min(std::max(level, 0), m_pyramid.maxLevel()));
+}
+
+QImage EditGraph::render(const QRect &region, int level)
+{
+    if (source().isNull()) {
+        return QImage();
+    }
+
+    level = std::min(std::max(level, 0), m_pyramid.maxLevel());
+    const QRect rect = region & QRect(QPoint(0, 0), nodeSize(m_nodes.size() - 1, level));
+    if (rect.isEmpty()) {
+        return QImage();
+    }
+    return evaluate(m_nodes.size() - 1, level, rect);
+}
+
+QImage EditGraph::renderForScale(const QRect &region, double scale)
+{
+    const int level = std::min(ImagePyramid::levelForScale(scale), m_pyramid.maxLevel());
+    const double factor = ImagePyramid::levelScale(level);
+
+    // 向外取整，保证缩小层上的区域覆盖原图区域
+    const int left = static_cast<int>(std::floor(region.left() * factor));
+    const int top = static_cast<int>(std::floor(region.top() * factor));
+    const int right = static_cast<int>(std::ceil((region.left() + region.width()) * factor));
+    const int bottom = static_cast<int>(std::ceil((region.top() + region.height()) * factor));
+    return render(QRect(left, top, right - left, bottom - top), level);
+}
+
+void EditGraph::setCacheBudget(qint64 bytes)
+{
+    m_cacheBudget = std::max<qint64>(bytes, 0);
+    evictToBudget();
+}
+
+void EditGraph::clearCache()
+{
+    invalidateFrom(0);
+}
+
+/**
+ * 计算第 node 个操作的输出在 rect 范围内的像素（node 为 -1 时为原图）。
+ *
+ * 局部运算只向上游请求按 halo 扩展后的区域，在扩展区域上运算后裁回 rect：
+ * 扩展部分吸收了区域边界的误差，结果与整幅图像运算后裁剪一致。
+ */
+QImage EditGraph::evaluate(int node, int level, const QRect &rect)
+{
+    if (node < 0) {
+        const QImage source = m_pyramid.level(level);
+        return source.rect() == rect ? source : source.copy(rect);
+    }
+
+    if (const CacheEntry *entry = findCached(node, level, rect)) {
+        return entry->rect == rect ? entry->image
+                                   : entry->image.copy(rect.translated(-entry->rect.topLeft()));
+    }
+
+    const EditOperation &operation = m_nodes[node].operation;
+    if (!operation.local) {
+        const QImage full = fullOutput(node, level);
+        return full.rect() == rect ? full : full.copy(rect);
+    }
+
+    const double scale = ImagePyramid::levelScale(level);
+    const int halo = operation.halo ? operation.halo(scale) : 0;
+    const QRect inputRect = rect.adjusted(-halo, -halo, halo, halo)
+                            & QRect(QPoint(0, 0), nodeSize(node - 1, level));
+
+    const QImage processed = operation.apply(evaluate(node - 1, level, inputRect), scale);
+    ++m_evaluations;
+    const QImage output = inputRect == rect ? processed
+                                            : processed.copy(rect.translated(-inputRect.topLeft()));
+    store(node, level, rect, output);
+    return output;
+}
+
+// 非局部运算总是对整幅输入求值，结果尺寸也由此确定
+QImage EditGraph::fullOutput(int node, int level)
+{
+    for (CacheEntry &entry : m_nodes[node].cache) {
+        if (entry.level == level) {
+            entry.lastUse = ++m_useCounter;
+            return entry.image;
+        }
+    }
+
+    const QImage input = evaluate(node - 1, level, QRect(QPoint(0, 0), nodeSize(node - 1, level)));
+    const QImage full = m_nodes[node].operation.apply(input, ImagePyramid::levelScale(level));
+    ++m_evaluations;
+    store(node, level, full.rect(), full);
+    return full;
+}
+
+QSize EditGraph::nodeSize(int node, int level)
+{
+    while (node >= 0 && m_nodes[node].operation.local) {
+        --node;
+    }
+    return node < 0 ? m_pyramid.level(level).size() : fullOutput(node, level).size();
+}
+
+const EditGraph::CacheEntry *EditGraph::findCached(int node, int level, const QRect &rect)
+{
+    for (CacheEntry &entry : m_nodes[node].cache) {
+        if (entry.level == level && entry.rect.contains(rect)) {
+            entry.lastUse = ++m_useCounter;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void EditGraph::store(int node, int level, const QRect &rect, const QImage &image)
+{
+    // 被新区域完全覆盖的旧缓存不再需要
+    QVector<CacheEntry> &cache = m_nodes[node].cache;
+    for (int i = cache.size() - 1; i >= 0; --i) {
+        if (cache[i].level == level && rect.contains(cache[i].rect)) {
+            m_cachedBytes -= cache[i].image.sizeInBytes();
+            cache.remove(i);
+        }
+    }
+
+    CacheEntry entry;
+    entry.level = level;
+    entry.rect = rect;
+    entry.image = image;
+    entry.lastUse = ++m_useCounter;
+    cache.append(entry);
+    m_cachedBytes += image.sizeInBytes();
+
+    evictToBudget();
+}
+
+void EditGraph::invalidateFrom(int node)
+{
+    for (int i = std::max(node, 0); i < m_nodes.size(); ++i) {
+        for (const CacheEntry &entry : m_nodes[i].cache) {
+            m_cachedBytes -= entry.image.sizeInBytes();
+        }
+        m_nodes[i].cache.clear();
+    }
+}
+
+// 按最久未使用的顺序淘汰，刚写入的一项总是保留
+void EditGraph::evictToBudget()
+{
+    while (m_cachedBytes > m_cacheBudget) {
+        Node *oldestNode = nullptr;
+        int oldestIndex = -1;
+        for (Node &node : m_nodes) {
+            for (int i = 0; i < node.cache.size(); ++i) {
+                if (node.cache[i].lastUse == m_useCounter) {
+                    continue;
+                }
+                if (!oldestNode || node.cache[i].lastUse < oldestNode->cache[oldestIndex].lastUse) {
+                    oldestNode = &node;
+                    oldestIndex = i;
+                }
+            }
+        }
+        if (!oldestNode) {
+            return;
+        }
+        m_cachedBytes -= oldestNode->cache[oldestIndex].image.sizeInBytes();
+        oldestNode->cache.remove(oldestIndex);
+    }
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,166 @@
+#ifndef EDITGRAPH_H
+#define EDITGRAPH_H
+
+#include "imagepyramid.h"
+#include <QImage>
+#include <QRect>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 编辑链中的一个带参数的操作
+ *
+ * apply 以输入图像和当前分辨率相对原图的比例调用，按比例缩放与像素距离相关的参数
+ * （如模糊半径），使缩小层上的结果与原图结果缩小后相近。
+ *
+ * 局部运算（local 为 true）的输出尺寸与输入相同，每个输出像素只依赖输入中
+ * 半径 halo(scale) 以内的像素，可以只计算可见区域；旋转、翻转等其它运算
+ * 总是处理整幅图像。
+ */
+struct EditOperation {
+    QString name;
+    bool local = true;
+    std::function<int(double scale)> halo;  // 为空时为逐像素运算
+    std::function<QImage(const QImage &input, double scale)> apply;
+
+    static EditOperation rotate(qreal angle);
+    static EditOperation flipHorizontal();
+    static EditOperation flipVertical();
+    static EditOperation grayscale();
+    static EditOperation invert();
+    static EditOperation gaussianBlur(int radius);
+    static EditOperation sharpen(double strength);
+    static EditOperation sobelEdges();
+    static EditOperation threshold(int value);
+};
+
+/**
+ * @brief 非破坏性、按需求值的编辑链
+ *
+ * 保存原图和按顺序排列的操作，结果只在被请求时计算：
+ * - render() 可只计算给定区域（局部运算的输入按 halo 向外扩展），并可在
+ *   金字塔缩小层上计算，与视图的可见范围和缩放比例对应；
+ * - 每个节点的输出按 (层, 区域) 缓存，修改第 i 个操作只丢弃 i 及其后节点的缓存，
+ *   重新求值从最近的可用缓存开始；
+ * - 缓存总量超过 cacheBudget() 时按最久未使用的顺序淘汰。
+ *
+ * 不是线程安全的，应在同一线程上使用；各操作内部仍按行带并行。
+ */
+class EditGraph
+{
+public:
+    EditGraph() = default;
+    explicit EditGraph(const QImage &source);
+
+    /**
+     * @brief 替换原图，清空全部缓存（操作保留）
+     */
+    void setSource(const QImage &source);
+    QImage source() const { return m_pyramid.base(); }
+
+    int count() const { return m_nodes.size(); }
+    const EditOperation &operation(int index) const { return m_nodes[index].operation; }
+
+    void append(const EditOperation &operation);
+    void insert(int index, const EditOperation &operation);
+    void replace(int index, const EditOperation &operation);
+    void remove(int index);
+
+    /**
+     * @brief 只保留前 count 个操作
+     */
+    void truncate(int count);
+
+    /**
+     * @brief 撤销最后一个操作，移入重做列表
+     *
+     * 上游节点的缓存不受影响，撤销后的结果通常可直接从缓存取得。
+     * append() 会清空重做列表。
+     */
+    bool undo();
+    bool redo();
+    bool canUndo() const { return !m_nodes.isEmpty(); }
+    bool canRedo() const { return !m_redoOperations.isEmpty(); }
+    int redoCount() const { return m_redoOperations.size(); }
+
+    /**
+     * @brief 把第一个操作的结果并入原图并移除该操作
+     *
+     * 用于限制编辑链长度。后续节点在原分辨率上的缓存仍然有效，缩小层上的缓存被丢弃；
+     * 重做列表不受影响。
+     * @return 并入前的原图；没有操作时返回空图像
+     */
+    QImage foldFirst();
+
+    /**
+     * @brief 全分辨率的完整结果
+     */
+    QImage result();
+
+    /**
+     * @brief 结果在金字塔第 level 层上的尺寸（可能需要先求值旋转等非局部运算）
+     */
+    QSize outputSize(int level = 0);
+
+    /**
+     * @brief 计算结果在第 level 层上 region 范围内的像素
+     * @param region 第 level 层结果坐标系中的区域，超出图像的部分被裁掉
+     * @return 尺寸为裁剪后区域的图像
+     */
+    QImage render(const QRect &region, int level = 0);
+
+    /**
+     * @brief 按视图比例选择金字塔层并计算（region 为原图坐标，返回缩小层上的像素）
+     */
+    QImage renderForScale(const QRect &region, double scale);
+
+    void setCacheBudget(qint64 bytes);
+    qint64 cacheBudget() const { return m_cacheBudget; }
+    qint64 cachedBytes() const { return m_cachedBytes; }
+    void clearCache();
+
+    /**
+     * @brief 累计执行操作的次数（用于确认缓存是否生效）
+     */
+    int evaluationCount() const { return m_evaluations; }
+
+    static constexpr qint64 DEFAULT_CACHE_BUDGET = qint64(512) << 20;
+
+private:
+    struct CacheEntry {
+        int level = 0;
+        QRect rect;
+        QImage image;
+        quint64 lastUse = 0;
+    };
+
+    struct Node {
+        EditOperation operation;
+        QVector<CacheEntry> cache;
+    };
+
+    QImage evaluate(int node, int level, const QRect &rect);
+    QImage fullOutput(int node, int level);
+    QSize nodeSize(int node, int level);
+    const CacheEntry *findCached(int node, int level, const QRect &rect);
+    void store(int node, int level, const QRect &rect, const QImage &image);
+    void invalidateFrom(int node);
+    void evictToBudget();
+
+    ImagePyramid m_pyramid;
+    QVector<Node> m_nodes;
+    QVector<EditOperation> m_redoOperations;
+    qint64 m_cacheBudget = DEFAULT_CACHE_BUDGET;
+    qint64 m_cachedBytes = 0;
+    quint64 m_useCounter = 0;
+    int m_evaluations = 0;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // EDITGRAPH_H
@@ -0,0 +1,405 @@
+/**
+ * @file gaussianblur.cpp
+ * @brief 基于级联扩展盒式滤波的高斯模糊实现
+ */
+
+#include "gaussianblur.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(GPCV_SIMD_X86)
+#include <immintrin.h>
+#endif
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int FRACTION_BITS = 8;   // 行缓冲的小数位数
+constexpr int STRIP_BYTES = 256;   // 垂直滤波的列条带宽度
+constexpr int BAND_ROWS = 16;      // 水平滤波每次转置的行数
+
+/**
+ * 扩展盒式滤波的一行输出：
+ * out = sums * inner + (above + below) * edge，随后 sums += below - leaving
+ */
+using BoxRowFunc = void (*)(quint16 *out, quint32 *sums, const quint16 *above, const quint16 *below,
+                            const quint16 *leaving, int n, float inner, float edge);
+
+void boxRowScalar(quint16 *out, quint32 *sums, const quint16 *above, const quint16 *below,
+                  const quint16 *leaving, int n, float inner, float edge)
+{
+    for (int x = 0; x < n; ++x) {
+        const quint32 edges = quint32(above[x]) + below[x];
+        out[x] = static_cast<quint16>(static_cast<float>(sums[x]) * inner
+                                      + (static_cast<float>(edges) * edge + 0.5f));
+        sums[x] = sums[x] + below[x] - leaving[x];
+    }
+}
+
+#if defined(GPCV_SIMD_X86)
+
+GPCV_TARGET_SSE2 void boxRowSse2(quint16 *out, quint32 *sums, const quint16 *above, const quint16 *below,
+                                 const quint16 *leaving, int n, float inner, float edge)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128 wi = _mm_set1_ps(inner);
+    const __m128 we = _mm_set1_ps(edge);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    auto weighted = [&](__m128i sum, __m128i edges) {
+        const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), wi),
+                                    _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(edges), we), half));
+        // SSE2 没有无符号饱和打包，先偏移到有符号范围
+        return _mm_sub_epi32(_mm_cvttps_epi32(v), bias32);
+    };
+
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + x));
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(leaving + x));
+        __m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + x));
+        __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sums + x + 4));
+
+        const __m128i b0 = _mm_unpacklo_epi16(b, zero);
+        const __m128i b1 = _mm_unpackhi_epi16(b, zero);
+        const __m128i e0 = _mm_add_epi32(_mm_unpacklo_epi16(a, zero), b0);
+        const __m128i e1 = _mm_add_epi32(_mm_unpackhi_epi16(a, zero), b1);
+
+        const __m128i packed = _mm_packs_epi32(weighted(s0, e0), weighted(s1, e1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_xor_si128(packed, bias16));
+
+        s0 = _mm_sub_epi32(_mm_add_epi32(s0, b0), _mm_unpacklo_epi16(l, zero));
+        s1 = _mm_sub_epi32(_mm_add_epi32(s1, b1), _mm_unpackhi_epi16(l, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + x), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + x + 4), s1);
+    }
+    boxRowScalar(out + x, sums + x, above + x, below + x, leaving + x, n - x, inner, edge);
+}
+
+// lambda 不继承 target 属性，AVX2 辅助函数单独声明
+GPCV_TARGET_AVX2 inline __m256i widenAvx2(const quint16 *p)
+{
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+
+GPCV_TARGET_AVX2 inline __m256i weightedAvx2(__m256i sum, __m256i edges, __m256 wi, __m256 we, __m256 half)
+{
+    const __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sum), wi),
+                                   _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(edges), we), half));
+    return _mm256_cvttps_epi32(v);
+}
+
+GPCV_TARGET_AVX2 void boxRowAvx2(quint16 *out, quint32 *sums, const quint16 *above, const quint16 *below,
+                                 const quint16 *leaving, int n, float inner, float edge)
+{
+    const __m256 wi = _mm256_set1_ps(inner);
+    const __m256 we = _mm256_set1_ps(edge);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    int x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m256i b0 = widenAvx2(below + x);
+        const __m256i b1 = widenAvx2(below + x + 8);
+        const __m256i e0 = _mm256_add_epi32(widenAvx2(above + x), b0);
+        const __m256i e1 = _mm256_add_epi32(widenAvx2(above + x + 8), b1);
+        __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + x));
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + x + 8));
+
+        // packus 按 128 位分组交错，再调整回顺序
+        const __m256i packed = _mm256_permute4x64_epi64(
+            _mm256_packus_epi32(weightedAvx2(s0, e0, wi, we, half), weightedAvx2(s1, e1, wi, we, half)), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), packed);
+
+        s0 = _mm256_sub_epi32(_mm256_add_epi32(s0, b0), widenAvx2(leaving + x));
+        s1 = _mm256_sub_epi32(_mm256_add_epi32(s1, b1), widenAvx2(leaving + x + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + x), s0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + x + 8), s1);
+    }
+    boxRowScalar(out + x, sums + x, above + x, below + x, leaving + x, n - x, inner, edge);
+}
+
+#endif // GPCV_SIMD_X86
+
+#if defined(GPCV_SIMD_NEON)
+
+void boxRowNeon(quint16 *out, quint32 *sums, const quint16 *above, const quint16 *below,
+                const quint16 *leaving, int n, float inner, float edge)
+{
+    const float32x4_t half = vdupq_n_f32(0.5f);
+
+    auto weighted = [&](uint32x4_t sum, uint32x4_t edges) {
+        const float32x4_t v = vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(sum), inner),
+                                        vmlaq_n_f32(half, vcvtq_f32_u32(edges), edge));
+        return vqmovn_u32(vcvtq_u32_f32(v));
+    };
+
+    int x = 0;
+    for (; x + 8 <= n; x += 8) {
+        const uint16x8_t a = vld1q_u16(above + x);
+        const uint16x8_t b = vld1q_u16(below + x);
+        const uint16x8_t l = vld1q_u16(leaving + x);
+        uint32x4_t s0 = vld1q_u32(sums + x);
+        uint32x4_t s1 = vld1q_u32(sums + x + 4);
+
+        const uint32x4_t e0 = vaddl_u16(vget_low_u16(a), vget_low_u16(b));
+        const uint32x4_t e1 = vaddl_u16(vget_high_u16(a), vget_high_u16(b));
+        vst1q_u16(out + x, vcombine_u16(weighted(s0, e0), weighted(s1, e1)));
+
+        s0 = vsubw_u16(vaddw_u16(s0, vget_low_u16(b)), vget_low_u16(l));
+        s1 = vsubw_u16(vaddw_u16(s1, vget_high_u16(b)), vget_high_u16(l));
+        vst1q_u32(sums + x, s0);
+        vst1q_u32(sums + x + 4, s1);
+    }
+    boxRowScalar(out + x, sums + x, above + x, below + x, leaving + x, n - x, inner, edge);
+}
+
+#endif // GPCV_SIMD_NEON
+
+BoxRowFunc boxRowFunc()
+{
+    switch (SimdSupport::activeLevel()) {
+#if defined(GPCV_SIMD_X86)
+        case SimdLevel::AVX2: return boxRowAvx2;
+        case SimdLevel::SSE2: return boxRowSse2;
+#endif
+#if defined(GPCV_SIMD_NEON)
+        case SimdLevel::NEON: return boxRowNeon;
+#endif
+        default: return boxRowScalar;
+    }
+}
+
+/**
+ * 沿行方向的扩展盒式滤波：rows 行、每行 width 个元素的缓冲，边界复制。
+ * 滑动和按整行更新，width 个元素互相独立，内层循环可向量化。
+ */
+void boxPass(const quint16 *src, quint16 *dst, int rows, int width, const BoxFilter &box,
+             quint32 *sums, BoxRowFunc boxRow)
+{
+    const int r = box.radius;
+    const int last = rows - 1;
+    auto row = [&](int y) { return src + static_cast<size_t>(std::min(std::max(y, 0), last)) * width; };
+
+    const quint16 *first = row(0);
+    for (int x = 0; x < width; ++x) {
+        sums[x] = static_cast<quint32>(r + 1) * first[x];
+    }
+    for (int i = 1; i <= r; ++i) {
+        const quint16 *line = row(i);
+        for (int x = 0; x < width; ++x) {
+            sums[x] += line[x];
+        }
+    }
+
+    for (int y = 0; y < rows; ++y) {
+        boxRow(dst + static_cast<size_t>(y) * width, sums, row(y - r - 1), row(y + r + 1), row(y - r),
+               width, box.innerWeight, box.edgeWeight);
+    }
+}
+
+inline uchar toByte(quint16 value)
+{
+    return static_cast<uchar>((value + (1u << (FRACTION_BITS - 1))) >> FRACTION_BITS);
+}
+
+inline quint16 toFixed(uchar value)
+{
+    return static_cast<quint16>(value << FRACTION_BITS);
+}
+
+// 一行像素写入转置缓冲的一列（列间距 stride 个元素）
+template <int C>
+void loadColumn(const uchar *src, quint16 *column, int width, int stride)
+{
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < C; ++c) {
+            column[x * stride + c] = toFixed(src[x * C + c]);
+        }
+    }
+}
+
+template <int C>
+void storeColumn(const quint16 *column, uchar *dst, int width, int stride)
+{
+    for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < C; ++c) {
+            dst[x * C + c] = toByte(column[x * stride + c]);
+        }
+    }
+}
+
+} // namespace
+
+QVector<BoxFilter> GaussianBlur::boxFilters(double sigma, int passes)
+{
+    QVector<BoxFilter> filters;
+    if (sigma <= 0.0 || passes <= 0) {
+        return filters;
+    }
+
+    // 每次滤波分担 sigma²/passes 的方差。半径 r 的盒式滤波方差为 r(r+1)/3，
+    // 取不超过目标的最大 r，再给 ±(r+1) 处加权 alpha 补足剩余方差（Gwosdek 等的扩展盒式滤波）
+    const double variance = sigma * sigma / passes;
+    const int r = static_cast<int>(std::floor((std::sqrt(12.0 * variance + 1.0) - 1.0) / 2.0));
+    const double boxVariance = r * (r + 1) / 3.0;
+    const double alpha = (2 * r + 1) * (boxVariance - variance)
+                         / (2.0 * (variance - (r + 1.0) * (r + 1.0)));
+    const double norm = 1.0 / (2 * r + 1 + 2 * alpha);
+
+    BoxFilter box;
+    box.radius = r;
+    box.innerWeight = static_cast<float>(norm);
+    box.edgeWeight = static_cast<float>(alpha * norm);
+    filters.fill(box, passes);
+    return filters;
+}
+
+double GaussianBlur::sigmaForKernelSize(int kernelSize)
+{
+    return 0.3 * ((kernelSize - 1) * 0.5 - 1.0) + 0.8;
+}
+
+QImage GaussianBlur::blur(const QImage &image, double sigma, bool blurAlpha)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    int channels = 4;
+    QImage source;
+    switch (image.format()) {
+        case QImage::Format_Grayscale8:
+            channels = 1;
+            source = image;
+            break;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            source = image;
+            break;
+        default:
+            source = image.convertToFormat(QImage::Format_ARGB32);
+            break;
+    }
+
+    // 1/512 以下的方差对 8 位输出没有影响
+    const QVector<BoxFilter> filters = boxFilters(sigma);
+    if (filters.isEmpty() || sigma * sigma < 1.0 / 512.0) {
+        return source;
+    }
+
+    const int width = source.width();
+    const int height = source.height();
+    const int rowLength = width * channels;
+    QImage result(source.size(), source.format());
+    const BoxRowFunc boxRow = boxRowFunc();
+
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(result);
+
+    // 水平方向：每次取 BAND_ROWS 行转置为 [x][行, 通道] 布局，
+    // 沿 x 的滑动和即可对多行多通道同时更新，避免逐元素串行依赖。
+    // 各行之间互不依赖，按 BAND_ROWS 的整数倍分给各线程
+    const int groupRows = (TiledExecutor::bandRowsFor(height, 0) + BAND_ROWS - 1) / BAND_ROWS
+                          * BAND_ROWS;
+    TiledExecutor::forEachRowBand(height, groupRows, [&](int g0, int g1) {
+        std::vector<quint16> bandA(static_cast<size_t>(width) * BAND_ROWS * channels);
+        std::vector<quint16> bandB(bandA.size());
+        std::vector<quint32> sums(static_cast<size_t>(std::max(BAND_ROWS * channels, STRIP_BYTES)));
+
+        for (int y0 = g0; y0 < g1; y0 += BAND_ROWS) {
+            const int rows = std::min(BAND_ROWS, g1 - y0);
+            const int w = rows * channels;
+
+            for (int r = 0; r < rows; ++r) {
+                if (channels == 1) {
+                    loadColumn<1>(source.constScanLine(y0 + r), bandA.data() + r, width, w);
+                } else {
+                    loadColumn<4>(source.constScanLine(y0 + r), bandA.data() + r * 4, width, w);
+                }
+            }
+
+            quint16 *in = bandA.data();
+            quint16 *out = bandB.data();
+            for (const BoxFilter &box : filters) {
+                boxPass(in, out, width, w, box, sums.data(), boxRow);
+                std::swap(in, out);
+            }
+
+            for (int r = 0; r < rows; ++r) {
+                if (channels == 1) {
+                    storeColumn<1>(in + r, lines[y0 + r], width, w);
+                } else {
+                    storeColumn<4>(in + r * 4, lines[y0 + r], width, w);
+                }
+            }
+        }
+    });
+
+    // 垂直方向：按列条带读入，条带内逐行更新滑动和，访存保持连续。
+    // 条带按组分给各线程，同组条带复用一份缓冲
+    const int stripWidth = std::min(STRIP_BYTES, rowLength);
+    const int strips = (rowLength + stripWidth - 1) / stripWidth;
+    const int groupStrips = std::max(strips / (4 * TiledExecutor::threadCount()), 1);
+    TiledExecutor::forEachRowBand(strips, groupStrips, [&](int s0, int s1) {
+        std::vector<quint16> stripA(static_cast<size_t>(stripWidth) * height);
+        std::vector<quint16> stripB(static_cast<size_t>(stripWidth) * height);
+        std::vector<quint32> sums(static_cast<size_t>(std::max(BAND_ROWS * channels, STRIP_BYTES)));
+
+        for (int x0 = s0 * stripWidth; x0 < std::min(s1 * stripWidth, rowLength); x0 += stripWidth) {
+            const int w = std::min(stripWidth, rowLength - x0);
+
+            for (int y = 0; y < height; ++y) {
+                const uchar *src = lines[y] + x0;
+                quint16 *line = stripA.data() + static_cast<size_t>(y) * w;
+                for (int i = 0; i < w; ++i) {
+                    line[i] = toFixed(src[i]);
+                }
+            }
+
+            quint16 *in = stripA.data();
+            quint16 *out = stripB.data();
+            for (const BoxFilter &box : filters) {
+                boxPass(in, out, height, w, box, sums.data(), boxRow);
+                std::swap(in, out);
+            }
+
+            for (int y = 0; y < height; ++y) {
+                const quint16 *line = in + static_cast<size_t>(y) * w;
+                uchar *dst = lines[y] + x0;
+                for (int i = 0; i < w; ++i) {
+                    dst[i] = toByte(line[i]);
+                }
+            }
+        }
+    });
+
+    // RGB32 的 alpha 必须保持 0xff
+    if (channels == 4 && (!blurAlpha || source.format() == QImage::Format_RGB32)) {
+        const int bandRows = TiledExecutor::bandRowsFor(height, 0);
+        TiledExecutor::forEachRowBand(height, bandRows, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const QRgb *srcLine = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+                QRgb *dstLine = reinterpret_cast<QRgb *>(lines[y]);
+                for (int x = 0; x < width; ++x) {
+                    dstLine[x] = (dstLine[x] & 0x00ffffffu) | (srcLine[x] & 0xff000000u);
+                }
+            }
+        });
+    }
+
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,56 @@
+#ifndef GAUSSIANBLUR_H
+#define GAUSSIANBLUR_H
+
+#include <QImage>
+#include <QVector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 扩展盒式滤波参数
+ *
+ * 输出 = innerWeight * Σ|i|≤radius v[i] + edgeWeight * (v[-radius-1] + v[radius+1])
+ */
+struct BoxFilter {
+    int radius = 0;
+    float innerWeight = 1.0f;
+    float edgeWeight = 0.0f;
+};
+
+/**
+ * @brief 与半径无关的高斯模糊
+ *
+ * 用三次扩展盒式滤波逼近高斯（中心极限定理），方差与 sigma² 精确相等，
+ * 每次滤波用滑动和实现，每像素代价与 sigma 无关。水平方向逐行处理，垂直方向按列条带处理以保持缓存局部性；
+ * 行缓冲为 16 位定点（8 位小数），只在水平和垂直两步之间各取整一次。
+ * 水平步骤的行带与垂直步骤的列条带分别在 TiledExecutor 上并行处理。
+ *
+ * 支持 Format_Grayscale8（单通道）和 32 位 RGB 格式（四通道），
+ * 其它格式先转换为 Format_ARGB32。
+ */
+class GaussianBlur
+{
+public:
+    /**
+     * @brief 高斯模糊
+     * @param sigma 标准差（像素），过小时返回原图
+     * @param blurAlpha 32 位图像是否同时模糊 alpha 通道
+     */
+    static QImage blur(const QImage &image, double sigma, bool blurAlpha = true);
+
+    /**
+     * @brief 逼近给定 sigma 的各次扩展盒式滤波，总方差等于 sigma²
+     */
+    static QVector<BoxFilter> boxFilters(double sigma, int passes = 3);
+
+    /**
+     * @brief 由卷积核大小推算 sigma（与 OpenCV getGaussianKernel 的约定一致）
+     */
+    static double sigmaForKernelSize(int kernelSize);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // GAUSSIANBLUR_H
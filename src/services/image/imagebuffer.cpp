@@ -0,0 +1,103 @@
+/**
+ * @file imagebuffer.cpp
+ * @brief 共享图像句柄实现
+ */
+
+#include "imagebuffer.h"
+#include <atomic>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+std::atomic<qint64> g_nextCacheKey{1};
+
+} // namespace
+
+ImageBuffer::ImageBuffer(const QImage &image)
+{
+    if (!image.isNull()) {
+        m_data = std::make_shared<Data>();
+        m_data->image = image;
+        m_data->cacheKey = g_nextCacheKey++;
+    }
+}
+
+ImageBuffer::ImageBuffer(const QPixmap &pixmap)
+{
+    if (!pixmap.isNull()) {
+        m_data = std::make_shared<Data>();
+        m_data->pixmap = pixmap;
+        m_data->cacheKey = g_nextCacheKey++;
+    }
+}
+
+bool ImageBuffer::isNull() const
+{
+    if (!m_data) {
+        return true;
+    }
+    QMutexLocker lock(&m_data->mutex);
+    return m_data->image.isNull() && m_data->pixmap.isNull();
+}
+
+QSize ImageBuffer::size() const
+{
+    if (!m_data) {
+        return QSize();
+    }
+    QMutexLocker lock(&m_data->mutex);
+    return m_data->image.isNull() ? m_data->pixmap.size() : m_data->image.size();
+}
+
+QImage ImageBuffer::image() const
+{
+    if (!m_data) {
+        return QImage();
+    }
+    QMutexLocker lock(&m_data->mutex);
+    if (m_data->image.isNull()) {
+        m_data->image = m_data->pixmap.toImage();
+    }
+    return m_data->image;
+}
+
+QPixmap ImageBuffer::pixmap() const
+{
+    if (!m_data) {
+        return QPixmap();
+    }
+    QMutexLocker lock(&m_data->mutex);
+    if (m_data->pixmap.isNull()) {
+        // 以右值转换，格式可直接使用时 QPixmap 与 QImage 共享像素而不复制
+        m_data->pixmap = QPixmap::fromImage(QImage(m_data->image));
+    }
+    return m_data->pixmap;
+}
+
+QImage &ImageBuffer::mutableImage()
+{
+    if (!m_data) {
+        m_data = std::make_shared<Data>();
+    }
+    image();
+
+    // 其它句柄仍引用该缓冲区时另建一个；QImage 本身隐式共享，写像素时才真正复制
+    if (m_data.use_count() > 1) {
+        auto data = std::make_shared<Data>();
+        data->image = m_data->image;
+        m_data = data;
+    }
+    m_data->pixmap = QPixmap();
+    m_data->cacheKey = g_nextCacheKey++;
+    return m_data->image;
+}
+
+qint64 ImageBuffer::cacheKey() const
+{
+    return m_data ? m_data->cacheKey : 0;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,76 @@
+#ifndef IMAGEBUFFER_H
+#define IMAGEBUFFER_H
+
+#include <QImage>
+#include <QMutex>
+#include <QPixmap>
+#include <memory>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 在标签页、控制器、视图和推理之间共享的图像句柄
+ *
+ * 复制句柄只增加引用计数；像素只在 mutableImage() 真正修改时才与其它句柄分离。
+ * 每个版本的 QImage 与 QPixmap 互相转换一次后缓存，之后各层取用同一份数据；
+ * 光栅绘制下像素格式相同时两者共享同一块像素，每幅打开的图像只占一份内存。
+ *
+ * 与推理使用的 SharedImageBuffer（进程间共享内存）无关。
+ */
+class ImageBuffer
+{
+public:
+    ImageBuffer() = default;
+    explicit ImageBuffer(const QImage &image);
+    explicit ImageBuffer(const QPixmap &pixmap);
+
+    bool isNull() const;
+    QSize size() const;
+    int width() const { return size().width(); }
+    int height() const { return size().height(); }
+
+    /**
+     * @brief CPU 端像素，由 QPixmap 创建的缓冲区首次调用时转换并缓存
+     *
+     * 由 QPixmap 创建时首次调用需在 GUI 线程。
+     */
+    QImage image() const;
+
+    /**
+     * @brief 显示用的 QPixmap，首次调用时转换并缓存，只能在 GUI 线程调用
+     */
+    QPixmap pixmap() const;
+
+    /**
+     * @brief 取得可写的像素，其它句柄仍看到修改前的内容
+     *
+     * 调用后版本号改变，缓存的 QPixmap 失效。返回的引用在下一次调用本对象的方法前有效。
+     */
+    QImage &mutableImage();
+
+    /**
+     * @brief 当前版本的标识，内容（版本）相同的句柄返回相同的值
+     */
+    qint64 cacheKey() const;
+
+    /**
+     * @brief 两个句柄是否共享同一个缓冲区（未分离）
+     */
+    bool isSharedWith(const ImageBuffer &other) const { return m_data && m_data == other.m_data; }
+
+private:
+    struct Data {
+        mutable QMutex mutex;
+        mutable QImage image;
+        mutable QPixmap pixmap;
+        qint64 cacheKey = 0;
+    };
+
+    std::shared_ptr<Data> m_data;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // IMAGEBUFFER_H
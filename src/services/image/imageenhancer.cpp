@@ -0,0 +1,247 @@
+/**
+ * @file imageenhancer.cpp
+ * @brief 查找表与滚动窗口锐化融合的图像增强实现
+ */
+
+#include "imageenhancer.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+#include <emmintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int BAND_ROWS = 64;
+constexpr int FIXED_SHIFT = 16;
+constexpr double FIXED_ONE = 1 << FIXED_SHIFT;
+// 四张表各自舍入带来的误差合计不超过 2 个单位，补偿后灰色像素调整饱和度时保持不变
+constexpr qint32 FIXED_BIAS = 8;
+
+inline int clampByte(int value)
+{
+    return std::min(std::max(value, 0), 255);
+}
+
+/**
+ * @brief 点运算查找表
+ *
+ * level 为亮度与对比度合成后的通道映射。调整饱和度时输出为
+ * s·level(c) + (1 − s)·(0.299·level(r) + 0.587·level(g) + 0.114·level(b))，
+ * 两部分以 Q16 定点数分别存入 scaled 与 gray*。
+ */
+struct PointTables {
+    bool saturate = false;
+    uchar level[256];
+    qint32 scaled[256];
+    qint32 grayR[256];
+    qint32 grayG[256];
+    qint32 grayB[256];
+
+    PointTables(int brightness, int contrast, int saturation)
+    {
+        const double factor = (259.0 * (contrast + 255)) / (255.0 * (259 - contrast));
+        for (int v = 0; v < 256; ++v) {
+            int value = v;
+            if (brightness != 0) {
+                value = clampByte(value + brightness);
+            }
+            if (contrast != 0) {
+                value = clampByte(static_cast<int>(factor * (value - 128) + 128));
+            }
+            level[v] = static_cast<uchar>(value);
+        }
+
+        saturate = saturation != 0;
+        const double s = 1.0 + saturation / 100.0;
+        for (int v = 0; v < 256; ++v) {
+            const double c = level[v] * FIXED_ONE;
+            scaled[v] = static_cast<qint32>(std::lround(s * c));
+            grayR[v] = static_cast<qint32>(std::lround((1 - s) * 0.299 * c));
+            grayG[v] = static_cast<qint32>(std::lround((1 - s) * 0.587 * c));
+            grayB[v] = static_cast<qint32>(std::lround((1 - s) * 0.114 * c));
+        }
+    }
+};
+
+template <bool Saturate>
+void mapRow(const QRgb *src, QRgb *dst, int width, const PointTables &tables)
+{
+    for (int x = 0; x < width; ++x) {
+        const QRgb pixel = src[x];
+        const int r = qRed(pixel);
+        const int g = qGreen(pixel);
+        const int b = qBlue(pixel);
+        if (Saturate) {
+            const qint32 gray = tables.grayR[r] + tables.grayG[g] + tables.grayB[b] + FIXED_BIAS;
+            dst[x] = qRgba(clampByte((tables.scaled[r] + gray) >> FIXED_SHIFT),
+                           clampByte((tables.scaled[g] + gray) >> FIXED_SHIFT),
+                           clampByte((tables.scaled[b] + gray) >> FIXED_SHIFT), qAlpha(pixel));
+        } else {
+            dst[x] = qRgba(tables.level[r], tables.level[g], tables.level[b], qAlpha(pixel));
+        }
+    }
+}
+
+void mapRow(const QRgb *src, QRgb *dst, int width, const PointTables &tables)
+{
+    if (tables.saturate) {
+        mapRow<true>(src, dst, width, tables);
+    } else {
+        mapRow<false>(src, dst, width, tables);
+    }
+}
+
+inline QRgb sharpenPixel(QRgb center, QRgb up, QRgb down, QRgb left, QRgb right, float amount)
+{
+    auto channel = [&](int shift) {
+        const int c = (center >> shift) & 0xff;
+        const int laplacian = 4 * c - ((up >> shift) & 0xff) - ((down >> shift) & 0xff)
+                              - ((left >> shift) & 0xff) - ((right >> shift) & 0xff);
+        return static_cast<QRgb>(clampByte(static_cast<int>(std::lrintf(c + amount * laplacian))))
+               << shift;
+    };
+    return (center & 0xff000000u) | channel(16) | channel(8) | channel(0);
+}
+
+/**
+ * @brief 3x3 锐化一行：c + amount·(4c − 上 − 下 − 左 − 右)
+ *
+ * 内部像素按 4 个一组同时处理全部通道，最后恢复 alpha；首尾像素按复制边界单独计算。
+ */
+void sharpenRow(const QRgb *up, const QRgb *center, const QRgb *down, QRgb *dst, int width,
+                float amount)
+{
+    if (width == 1) {
+        dst[0] = sharpenPixel(center[0], up[0], down[0], center[0], center[0], amount);
+        return;
+    }
+    dst[0] = sharpenPixel(center[0], up[0], down[0], center[0], center[1], amount);
+
+    int x = 1;
+#if defined(GPCV_SIMD_NEON)
+    const float32x4_t scale = vdupq_n_f32(amount);
+    const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xff000000u));
+    auto half = [&](uint8x8_t c8, uint8x8_t u8, uint8x8_t d8, uint8x8_t l8, uint8x8_t r8) {
+        const int16x8_t c = vreinterpretq_s16_u16(vmovl_u8(c8));
+        int16x8_t laplacian = vshlq_n_s16(c, 2);
+        laplacian = vsubq_s16(laplacian, vreinterpretq_s16_u16(vmovl_u8(u8)));
+        laplacian = vsubq_s16(laplacian, vreinterpretq_s16_u16(vmovl_u8(d8)));
+        laplacian = vsubq_s16(laplacian, vreinterpretq_s16_u16(vmovl_u8(l8)));
+        laplacian = vsubq_s16(laplacian, vreinterpretq_s16_u16(vmovl_u8(r8)));
+        const float32x4_t lo = vmlaq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(c))),
+                                         vcvtq_f32_s32(vmovl_s16(vget_low_s16(laplacian))), scale);
+        const float32x4_t hi = vmlaq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(c))),
+                                         vcvtq_f32_s32(vmovl_s16(vget_high_s16(laplacian))), scale);
+        return vqmovun_s16(vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(lo)), vqmovn_s32(vcvtnq_s32_f32(hi))));
+    };
+    for (; x + 4 < width; x += 4) {
+        const uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t *>(center + x));
+        const uint8x16_t u = vld1q_u8(reinterpret_cast<const uint8_t *>(up + x));
+        const uint8x16_t d = vld1q_u8(reinterpret_cast<const uint8_t *>(down + x));
+        const uint8x16_t l = vld1q_u8(reinterpret_cast<const uint8_t *>(center + x - 1));
+        const uint8x16_t r = vld1q_u8(reinterpret_cast<const uint8_t *>(center + x + 1));
+        const uint8x16_t result = vcombine_u8(
+            half(vget_low_u8(c), vget_low_u8(u), vget_low_u8(d), vget_low_u8(l), vget_low_u8(r)),
+            half(vget_high_u8(c), vget_high_u8(u), vget_high_u8(d), vget_high_u8(l), vget_high_u8(r)));
+        vst1q_u8(reinterpret_cast<uint8_t *>(dst + x), vbslq_u8(alphaMask, c, result));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128 scale = _mm_set1_ps(amount);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+    auto half = [&](__m128i c, __m128i u, __m128i d, __m128i l, __m128i r) {
+        __m128i laplacian = _mm_slli_epi16(c, 2);
+        laplacian = _mm_sub_epi16(laplacian, _mm_add_epi16(_mm_add_epi16(u, d), _mm_add_epi16(l, r)));
+        const __m128 lo = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c, zero)),
+                                     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(
+                                                    _mm_unpacklo_epi16(laplacian, laplacian), 16)),
+                                                scale));
+        const __m128 hi = _mm_add_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(c, zero)),
+                                     _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(
+                                                    _mm_unpackhi_epi16(laplacian, laplacian), 16)),
+                                                scale));
+        return _mm_packs_epi32(_mm_cvtps_epi32(lo), _mm_cvtps_epi32(hi));
+    };
+    for (; x + 4 < width; x += 4) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + x));
+        const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i *>(up + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(down + x));
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + x - 1));
+        const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + x + 1));
+        const __m128i lo = half(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(u, zero),
+                                _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(l, zero),
+                                _mm_unpacklo_epi8(r, zero));
+        const __m128i hi = half(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(u, zero),
+                                _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(l, zero),
+                                _mm_unpackhi_epi8(r, zero));
+        const __m128i result = _mm_packus_epi16(lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x),
+                         _mm_or_si128(_mm_and_si128(alphaMask, c), _mm_andnot_si128(alphaMask, result)));
+    }
+#endif
+    for (; x < width - 1; ++x) {
+        dst[x] = sharpenPixel(center[x], up[x], down[x], center[x - 1], center[x + 1], amount);
+    }
+    dst[width - 1] = sharpenPixel(center[width - 1], up[width - 1], down[width - 1],
+                                  center[width - 2], center[width - 1], amount);
+}
+
+} // namespace
+
+QImage ImageEnhancer::apply(const QImage &image, int brightness, int contrast, int saturation,
+                            int sharpness)
+{
+    const QImage source = image.format() == QImage::Format_RGB32 ? image
+                          : image.convertToFormat(QImage::Format_ARGB32);
+    if (source.isNull() || (brightness == 0 && contrast == 0 && saturation == 0 && sharpness <= 0)) {
+        return source.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    const int width = source.width();
+    const int height = source.height();
+    const PointTables tables(brightness, contrast, saturation);
+
+    QImage result(width, height, QImage::Format_ARGB32);
+    const std::vector<QRgb *> dstRows = TiledExecutor::writableRows(result);
+    auto srcRow = [&source](int y) { return reinterpret_cast<const QRgb *>(source.constScanLine(y)); };
+
+    if (sharpness <= 0) {
+        TiledExecutor::forEachRowBand(height, BAND_ROWS, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                mapRow(srcRow(y), dstRows[y], width, tables);
+            }
+        });
+        return result;
+    }
+
+    const float amount = sharpness / 100.0f;
+    TiledExecutor::forEachRowBand(height, BAND_ROWS, [&](int y0, int y1) {
+        // 点运算后的上、中、下三行；行带首尾各多算一行作为重叠
+        std::vector<QRgb> ring(3 * static_cast<size_t>(width));
+        QRgb *up = ring.data();
+        QRgb *center = up + width;
+        QRgb *down = center + width;
+        mapRow(srcRow(std::max(y0 - 1, 0)), up, width, tables);
+        mapRow(srcRow(y0), center, width, tables);
+        for (int y = y0; y < y1; ++y) {
+            mapRow(srcRow(std::min(y + 1, height - 1)), down, width, tables);
+            sharpenRow(up, center, down, dstRows[y], width, amount);
+            std::swap(up, center);
+            std::swap(center, down);
+        }
+    });
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
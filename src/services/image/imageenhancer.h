@@ -0,0 +1,37 @@
+#ifndef IMAGEENHANCER_H
+#define IMAGEENHANCER_H
+
+#include <QImage>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 亮度 / 对比度 / 饱和度 / 锐化的融合增强
+ *
+ * 亮度与对比度合成为一张逐通道查找表；饱和度调整所需的 s·c 与 (1 − s)·灰度权重
+ * 也预先乘进查找表，每像素只剩查表、整数加法和移位。锐化使用 3 行滚动窗口：
+ * 点运算后的行写入环形缓冲，随即做 3x3 锐化写出，整幅图像只读写各一次，
+ * 不产生中间图像。各行带在线程池上并行处理，带边界处多算一行作为重叠。
+ *
+ * 结果与依次执行亮度、对比度、饱和度、锐化四个单独步骤一致（每通道至多相差 1），
+ * 锐化边界按复制边缘像素处理，alpha 通道保持原值。
+ */
+class ImageEnhancer
+{
+public:
+    /**
+     * @param brightness 亮度偏移，加到每个通道上
+     * @param contrast 对比度，-255 到 255，以 128 为中心缩放
+     * @param saturation 饱和度百分比，-100 到 100
+     * @param sharpness 锐化强度百分比，不大于 0 时不锐化
+     * @return Format_ARGB32 图像
+     */
+    static QImage apply(const QImage &image, int brightness, int contrast, int saturation,
+                        int sharpness);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // IMAGEENHANCER_H
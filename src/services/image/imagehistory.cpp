@@ -0,0 +1,576 @@
+/**
+ * @file imagehistory.cpp
+ * @brief 增量撤销历史与全局撤销数据存储实现
+ */
+
+#include "imagehistory.h"
+#include "tiledexecutor.h"
+#include <QTemporaryFile>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+// ==================== HistoryBlock ====================
+
+HistoryBlock::HistoryBlock(const QByteArray &raw)
+    : m_payload(raw)
+    , m_rawSize(raw.size())
+{
+}
+
+HistoryBlock::~HistoryBlock()
+{
+    if (m_spilled) {
+        HistoryStore::instance().releaseSpilled(m_fileLength);
+    }
+}
+
+QByteArray HistoryBlock::data() const
+{
+    HistoryStore &store = HistoryStore::instance();
+    QByteArray payload;
+    bool compressed = false;
+    {
+        // 锁顺序总是先存储后记录，与换出时一致
+        QMutexLocker storeLock(&store.m_mutex);
+        QMutexLocker lock(&m_mutex);
+        compressed = m_compressed;
+        if (!m_spilled) {
+            payload = m_payload;
+        } else if (store.m_spillFile && store.m_spillFile->seek(m_fileOffset)) {
+            payload = store.m_spillFile->read(m_fileLength);
+        }
+    }
+    return compressed ? qUncompress(payload) : payload;
+}
+
+qint64 HistoryBlock::memoryUsage() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_spilled ? 0 : m_payload.size();
+}
+
+bool HistoryBlock::isCompressed() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_compressed;
+}
+
+bool HistoryBlock::isSpilled() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_spilled;
+}
+
+// ==================== HistoryStore ====================
+
+HistoryStore &HistoryStore::instance()
+{
+    static HistoryStore store;
+    return store;
+}
+
+HistoryStore::HistoryStore() = default;
+
+HistoryStore::~HistoryStore()
+{
+    waitForIdle();
+}
+
+std::shared_ptr<HistoryBlock> HistoryStore::create(const QByteArray &raw)
+{
+    auto block = std::make_shared<HistoryBlock>(raw);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_blocks.erase(std::remove_if(m_blocks.begin(), m_blocks.end(),
+                                      [](const std::weak_ptr<HistoryBlock> &weak) { return weak.expired(); }),
+                       m_blocks.end());
+        block->m_sequence = m_nextSequence++;
+        m_blocks.push_back(block);
+    }
+
+    // 除最近使用的几条外，其余未压缩的记录交给后台压缩
+    const BlockList blocks = liveBlocks();
+    const int cold = static_cast<int>(blocks.size()) - HOT_BLOCKS;
+    for (int i = 0; i < cold; ++i) {
+        HistoryBlock *candidate = blocks[i].get();
+        {
+            QMutexLocker lock(&candidate->m_mutex);
+            if (candidate->m_compressed || candidate->m_spilled || candidate->m_queued
+                || candidate->m_keepRaw || candidate->m_payload.isEmpty()) {
+                continue;
+            }
+            candidate->m_queued = true;
+        }
+        startJob(blocks[i], &HistoryStore::compress);
+    }
+
+    enforceBudget(blocks);
+    return block;
+}
+
+void HistoryStore::setMemoryBudget(qint64 bytes)
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_memoryBudget = std::max<qint64>(bytes, 0);
+    }
+    enforceBudget(liveBlocks());
+}
+
+qint64 HistoryStore::memoryBudget() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_memoryBudget;
+}
+
+qint64 HistoryStore::memoryUsage() const
+{
+    qint64 total = 0;
+    for (const std::shared_ptr<HistoryBlock> &block : liveBlocks()) {
+        total += block->memoryUsage();
+    }
+    return total;
+}
+
+qint64 HistoryStore::diskUsage() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_spilledBytes;
+}
+
+void HistoryStore::prefetch(const std::shared_ptr<HistoryBlock> &block)
+{
+    if (!block) {
+        return;
+    }
+
+    {
+        QMutexLocker storeLock(&m_mutex);
+        QMutexLocker lock(&block->m_mutex);
+        // 即将被使用的记录视为最新，避免随后又被压缩或换出
+        block->m_sequence = m_nextSequence++;
+        if ((!block->m_compressed && !block->m_spilled) || block->m_queued) {
+            return;
+        }
+        block->m_queued = true;
+    }
+    startJob(block, &HistoryStore::makeResident);
+}
+
+void HistoryStore::waitForIdle()
+{
+    QMutexLocker lock(&m_mutex);
+    while (m_pendingJobs > 0) {
+        m_idle.wait(&m_mutex);
+    }
+}
+
+void HistoryStore::startJob(const std::shared_ptr<HistoryBlock> &block,
+                            void (HistoryStore::*work)(HistoryBlock *))
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        ++m_pendingJobs;
+    }
+    (void)QtConcurrent::run([this, held = block, work]() mutable {
+        (this->*work)(held.get());
+        // 记录可能在任务期间被撤销栈丢弃，须在持锁之前释放
+        held.reset();
+        QMutexLocker lock(&m_mutex);
+        if (--m_pendingJobs == 0) {
+            m_idle.wakeAll();
+        }
+    });
+}
+
+void HistoryStore::compress(HistoryBlock *block)
+{
+    QByteArray raw;
+    {
+        QMutexLocker lock(&block->m_mutex);
+        if (block->m_compressed || block->m_spilled) {
+            block->m_queued = false;
+            return;
+        }
+        raw = block->m_payload;
+    }
+
+    const QByteArray packed = qCompress(raw, 1);
+
+    QMutexLocker lock(&block->m_mutex);
+    block->m_queued = false;
+    // 压缩期间可能已被换出或预取，此时放弃结果
+    if (block->m_compressed || block->m_spilled || block->m_payload.constData() != raw.constData()) {
+        return;
+    }
+    if (packed.size() < raw.size()) {
+        block->m_payload = packed;
+        block->m_compressed = true;
+    } else {
+        block->m_keepRaw = true;
+    }
+}
+
+void HistoryStore::makeResident(HistoryBlock *block)
+{
+    const QByteArray raw = block->data();
+
+    QMutexLocker storeLock(&m_mutex);
+    QMutexLocker lock(&block->m_mutex);
+    block->m_queued = false;
+    if (block->m_spilled) {
+        block->m_spilled = false;
+        m_spilledBytes -= block->m_fileLength;
+        if (m_spilledBytes == 0 && m_spillFile) {
+            m_spillFile->resize(0);
+        }
+    }
+    block->m_payload = raw;
+    block->m_compressed = false;
+}
+
+// 从最久未使用的记录开始换出，最近使用的 HOT_BLOCKS 条总是保留在内存中
+void HistoryStore::enforceBudget(const BlockList &blocks)
+{
+    qint64 total = 0;
+    for (const std::shared_ptr<HistoryBlock> &block : blocks) {
+        total += block->memoryUsage();
+    }
+
+    const qint64 budget = memoryBudget();
+    const int candidates = static_cast<int>(blocks.size()) - HOT_BLOCKS;
+    for (int i = 0; i < candidates && total > budget; ++i) {
+        const qint64 freed = spill(blocks[i].get());
+        if (freed < 0) {
+            return;
+        }
+        total -= freed;
+    }
+}
+
+/**
+ * 把记录当前的数据（压缩或未压缩）追加到交换文件末尾。
+ * 文件空间不单独回收，没有记录引用时整体清空。
+ * @return 释放的内存字节数，写入失败时返回 -1
+ */
+qint64 HistoryStore::spill(HistoryBlock *block)
+{
+    QMutexLocker storeLock(&m_mutex);
+    QMutexLocker lock(&block->m_mutex);
+    if (block->m_spilled || block->m_payload.isEmpty()) {
+        return 0;
+    }
+
+    if (!m_spillFile) {
+        m_spillFile = std::make_unique<QTemporaryFile>();
+        if (!m_spillFile->open()) {
+            m_spillFile.reset();
+            return -1;
+        }
+    }
+
+    const qint64 offset = m_spillFile->size();
+    if (!m_spillFile->seek(offset)
+        || m_spillFile->write(block->m_payload) != block->m_payload.size()) {
+        return -1;
+    }
+
+    const qint64 length = block->m_payload.size();
+    block->m_spilled = true;
+    block->m_fileOffset = offset;
+    block->m_fileLength = length;
+    block->m_payload = QByteArray();
+    m_spilledBytes += length;
+    return length;
+}
+
+void HistoryStore::releaseSpilled(qint64 length)
+{
+    QMutexLocker lock(&m_mutex);
+    m_spilledBytes -= length;
+    if (m_spilledBytes == 0 && m_spillFile) {
+        m_spillFile->resize(0);
+    }
+}
+
+// 按最近使用顺序（由旧到新）返回仍被引用的记录
+HistoryStore::BlockList HistoryStore::liveBlocks() const
+{
+    BlockList blocks;
+    QMutexLocker lock(&m_mutex);
+    for (const std::weak_ptr<HistoryBlock> &weak : m_blocks) {
+        if (std::shared_ptr<HistoryBlock> block = weak.lock()) {
+            blocks.push_back(std::move(block));
+        }
+    }
+    std::sort(blocks.begin(), blocks.end(),
+              [](const std::shared_ptr<HistoryBlock> &a, const std::shared_ptr<HistoryBlock> &b) {
+                  return a->m_sequence < b->m_sequence;
+              });
+    return blocks;
+}
+
+// ==================== ImageHistory ====================
+
+void ImageHistory::push(const QImage &state)
+{
+    if (state.isNull()) {
+        return;
+    }
+
+    // 上一次保存的状态此时才知道之后变成了什么，只保留变化的块
+    if (!m_pending.isNull()) {
+        Entry entry = diff(m_pending, state);
+        if (m_pendingIsStep || !isEmpty(entry)) {
+            m_undo.append(entry);
+        }
+    }
+    m_pending = state;
+    m_pendingIsStep = true;
+    m_redo.clear();
+    trim();
+}
+
+bool ImageHistory::undo(QImage &image)
+{
+    if (!m_pending.isNull()) {
+        Entry back = diff(image, m_pending);
+        if (m_pendingIsStep || !isEmpty(back)) {
+            m_redo.append(back);
+            image = m_pending;
+            m_pendingIsStep = false;
+            prefetchNext();
+            return true;
+        }
+    }
+    if (m_undo.isEmpty()) {
+        return false;
+    }
+
+    const Entry entry = m_undo.takeLast();
+    m_redo.append(capture(image, entry));
+    // 先放开保留的引用，让 image 可以原地修改而不必复制整幅图像
+    m_pending = QImage();
+    apply(entry, image);
+    m_pending = image;
+
+    prefetchNext();
+    return true;
+}
+
+bool ImageHistory::redo(QImage &image)
+{
+    if (m_redo.isEmpty()) {
+        return false;
+    }
+
+    // 撤销后图像又被直接修改过，重做记录已不再适用
+    if (!m_pending.isNull()) {
+        Entry changed = diff(m_pending, image);
+        if (!isEmpty(changed)) {
+            m_undo.append(changed);
+            m_redo.clear();
+            m_pending = image;
+            trim();
+            return false;
+        }
+    }
+
+    const Entry entry = m_redo.takeLast();
+    m_undo.append(capture(image, entry));
+    m_pending = QImage();
+    apply(entry, image);
+    m_pending = image;
+    trim();
+
+    prefetchNext();
+    return true;
+}
+
+void ImageHistory::clear()
+{
+    m_pending = QImage();
+    m_pendingIsStep = false;
+    m_undo.clear();
+    m_redo.clear();
+}
+
+void ImageHistory::setMaxSteps(int steps)
+{
+    m_maxSteps = std::max(steps, 1);
+    trim();
+}
+
+qint64 ImageHistory::storedBytes() const
+{
+    qint64 total = 0;
+    for (const QVector<Entry> *entries : {&m_undo, &m_redo}) {
+        for (const Entry &entry : *entries) {
+            total += entry.block ? entry.block->rawSize() : 0;
+        }
+    }
+    return total;
+}
+
+ImageHistory::Entry ImageHistory::diff(const QImage &from, const QImage &to)
+{
+    if (from.size() != to.size() || from.format() != to.format() || from.depth() % 8 != 0) {
+        return fullEntry(from);
+    }
+    return tileEntry(from, changedTiles(from, to));
+}
+
+ImageHistory::Entry ImageHistory::capture(const QImage &image, const Entry &entry)
+{
+    if (entry.full || image.size() != entry.size || image.format() != entry.format) {
+        return fullEntry(image);
+    }
+    return tileEntry(image, entry.tiles);
+}
+
+ImageHistory::Entry ImageHistory::fullEntry(const QImage &image)
+{
+    Entry entry;
+    entry.size = image.size();
+    entry.format = image.format();
+    entry.colorTable = image.colorTable();
+    entry.full = true;
+    entry.block = HistoryStore::instance().create(
+        QByteArray(reinterpret_cast<const char *>(image.constBits()), static_cast<int>(image.sizeInBytes())));
+    return entry;
+}
+
+ImageHistory::Entry ImageHistory::tileEntry(const QImage &image, const QVector<QRect> &tiles)
+{
+    Entry entry;
+    entry.size = image.size();
+    entry.format = image.format();
+    entry.tiles = tiles;
+    if (tiles.isEmpty()) {
+        return entry;
+    }
+
+    const int bytesPerPixel = image.depth() / 8;
+    QVector<qint64> offsets(tiles.size() + 1, 0);
+    for (int i = 0; i < tiles.size(); ++i) {
+        offsets[i + 1] = offsets[i] + qint64(tiles[i].width()) * bytesPerPixel * tiles[i].height();
+    }
+
+    QByteArray raw(static_cast<int>(offsets.last()), Qt::Uninitialized);
+    char *out = raw.data();
+    TiledExecutor::forEachIndex(tiles.size(), [&](int i) {
+        const QRect &tile = tiles[i];
+        const int rowBytes = tile.width() * bytesPerPixel;
+        char *dst = out + offsets[i];
+        for (int y = tile.top(); y <= tile.bottom(); ++y, dst += rowBytes) {
+            std::memcpy(dst, image.constScanLine(y) + tile.left() * bytesPerPixel, rowBytes);
+        }
+    });
+
+    entry.block = HistoryStore::instance().create(raw);
+    return entry;
+}
+
+void ImageHistory::apply(const Entry &entry, QImage &image)
+{
+    if (entry.full) {
+        QImage restored(entry.size, entry.format);
+        const QByteArray raw = entry.block->data();
+        std::memcpy(restored.bits(), raw.constData(),
+                    static_cast<size_t>(std::min<qint64>(raw.size(), restored.sizeInBytes())));
+        restored.setColorTable(entry.colorTable);
+        image = restored;
+        return;
+    }
+    if (entry.tiles.isEmpty()) {
+        return;
+    }
+
+    const QByteArray raw = entry.block->data();
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(image);
+    const int bytesPerPixel = image.depth() / 8;
+
+    QVector<qint64> offsets(entry.tiles.size() + 1, 0);
+    for (int i = 0; i < entry.tiles.size(); ++i) {
+        offsets[i + 1] = offsets[i] + qint64(entry.tiles[i].width()) * bytesPerPixel * entry.tiles[i].height();
+    }
+
+    TiledExecutor::forEachIndex(entry.tiles.size(), [&](int i) {
+        const QRect &tile = entry.tiles[i];
+        const int rowBytes = tile.width() * bytesPerPixel;
+        const char *src = raw.constData() + offsets[i];
+        for (int y = tile.top(); y <= tile.bottom(); ++y, src += rowBytes) {
+            std::memcpy(lines[y] + tile.left() * bytesPerPixel, src, rowBytes);
+        }
+    });
+}
+
+// 按块行并行比较，结果按先行后列排列
+QVector<QRect> ImageHistory::changedTiles(const QImage &a, const QImage &b)
+{
+    if (a.constBits() == b.constBits()) {
+        return {};
+    }
+
+    const int width = a.width();
+    const int height = a.height();
+    const int bytesPerPixel = a.depth() / 8;
+    const int columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    std::vector<QVector<QRect>> changed(rows);
+
+    TiledExecutor::forEachIndex(rows, [&](int row) {
+        const int y0 = row * TILE_SIZE;
+        const int y1 = std::min(y0 + TILE_SIZE, height);
+        std::vector<char> dirty(columns, 0);
+        for (int y = y0; y < y1; ++y) {
+            const uchar *lineA = a.constScanLine(y);
+            const uchar *lineB = b.constScanLine(y);
+            for (int column = 0; column < columns; ++column) {
+                if (dirty[column]) {
+                    continue;
+                }
+                const int x = column * TILE_SIZE * bytesPerPixel;
+                const int bytes = std::min(TILE_SIZE, width - column * TILE_SIZE) * bytesPerPixel;
+                dirty[column] = std::memcmp(lineA + x, lineB + x, bytes) != 0;
+            }
+        }
+        for (int column = 0; column < columns; ++column) {
+            if (dirty[column]) {
+                const int x = column * TILE_SIZE;
+                changed[row].append(QRect(x, y0, std::min(TILE_SIZE, width - x), y1 - y0));
+            }
+        }
+    });
+
+    QVector<QRect> tiles;
+    for (const QVector<QRect> &row : changed) {
+        tiles += row;
+    }
+    return tiles;
+}
+
+void ImageHistory::trim()
+{
+    while (undoCount() > m_maxSteps && !m_undo.isEmpty()) {
+        m_undo.removeFirst();
+    }
+}
+
+// 下一次撤销 / 重做要用的记录提前在后台解压或读回
+void ImageHistory::prefetchNext()
+{
+    if (!m_undo.isEmpty()) {
+        HistoryStore::instance().prefetch(m_undo.last().block);
+    }
+    if (!m_redo.isEmpty()) {
+        HistoryStore::instance().prefetch(m_redo.last().block);
+    }
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,236 @@
+#ifndef IMAGEHISTORY_H
+#define IMAGEHISTORY_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QRect>
+#include <QVector>
+#include <QWaitCondition>
+#include <memory>
+#include <vector>
+
+class QTemporaryFile;
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+class HistoryStore;
+
+/**
+ * @brief 一条撤销记录的像素数据
+ *
+ * 数据可能处于三种状态之一：未压缩、压缩后驻留内存、写入磁盘交换文件。
+ * 状态转换由 HistoryStore 在后台或按内存预算进行，data() 总是返回未压缩的字节。
+ */
+class HistoryBlock
+{
+public:
+    explicit HistoryBlock(const QByteArray &raw);
+    ~HistoryBlock();
+
+    /**
+     * @brief 未压缩的数据（必要时从压缩数据或交换文件恢复，不改变存储状态）
+     */
+    QByteArray data() const;
+
+    /**
+     * @brief 未压缩数据的字节数
+     */
+    qint64 rawSize() const { return m_rawSize; }
+
+    /**
+     * @brief 当前占用的内存字节数（写入交换文件后为 0）
+     */
+    qint64 memoryUsage() const;
+
+    bool isCompressed() const;
+    bool isSpilled() const;
+
+private:
+    friend class HistoryStore;
+
+    mutable QMutex m_mutex;
+    QByteArray m_payload;        ///< 未压缩或压缩后的数据，写入交换文件后为空
+    bool m_compressed = false;
+    bool m_spilled = false;
+    bool m_queued = false;       ///< 已提交后台压缩或预取
+    bool m_keepRaw = false;      ///< 压缩后没有变小，不再尝试压缩
+    qint64 m_fileOffset = 0;
+    qint64 m_fileLength = 0;
+    qint64 m_rawSize = 0;
+    quint64 m_sequence = 0;      ///< 创建顺序，越小越旧
+};
+
+/**
+ * @brief 所有标签页共享的撤销数据存储
+ *
+ * - 最新的 HOT_BLOCKS 条记录保持未压缩，保证常用的几步撤销不需要解压；
+ *   更旧的记录在后台线程用 qCompress（zlib 最快档）压缩；
+ * - 驻留内存的总量超过 memoryBudget() 时，从最旧的记录开始写入临时交换文件；
+ * - 记录被撤销栈丢弃时自动从存储中移除，交换文件在没有记录引用时清空。
+ */
+class HistoryStore
+{
+public:
+    static HistoryStore &instance();
+
+    /**
+     * @brief 创建并登记一条记录
+     */
+    std::shared_ptr<HistoryBlock> create(const QByteArray &raw);
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+
+    /**
+     * @brief 驻留内存的字节数（不含正在后台压缩的临时数据）
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * @brief 交换文件中仍被引用的字节数
+     */
+    qint64 diskUsage() const;
+
+    /**
+     * @brief 在后台把记录恢复为未压缩并驻留内存，供即将到来的撤销 / 重做使用
+     */
+    void prefetch(const std::shared_ptr<HistoryBlock> &block);
+
+    /**
+     * @brief 等待所有后台压缩 / 预取完成（测试和退出时使用）
+     */
+    void waitForIdle();
+
+    static constexpr int HOT_BLOCKS = 4;
+    static constexpr qint64 DEFAULT_MEMORY_BUDGET = qint64(1) << 30;
+
+private:
+    HistoryStore();
+    ~HistoryStore();
+    HistoryStore(const HistoryStore &) = delete;
+    HistoryStore &operator=(const HistoryStore &) = delete;
+
+    friend class HistoryBlock;
+
+    using BlockList = std::vector<std::shared_ptr<HistoryBlock>>;
+
+    void startJob(const std::shared_ptr<HistoryBlock> &block, void (HistoryStore::*work)(HistoryBlock *));
+    void compress(HistoryBlock *block);
+    void makeResident(HistoryBlock *block);
+    void enforceBudget(const BlockList &blocks);
+    qint64 spill(HistoryBlock *block);
+    void releaseSpilled(qint64 length);
+    BlockList liveBlocks() const;
+
+    mutable QMutex m_mutex;
+    std::vector<std::weak_ptr<HistoryBlock>> m_blocks;  ///< 按创建顺序
+    quint64 m_nextSequence = 0;
+    qint64 m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    qint64 m_spilledBytes = 0;
+    int m_pendingJobs = 0;
+    QWaitCondition m_idle;
+};
+
+/**
+ * @brief 单个图像的增量撤销 / 重做历史
+ *
+ * 每一步只保存与相邻状态不同的 TILE_SIZE x TILE_SIZE 块：
+ * - push() 记录修改前的状态；下一次 push() 或 undo() 时与之后的状态逐块比较，
+ *   只保留变化的块（尺寸或格式改变时保存整幅图像）；
+ * - undo() / redo() 把记录中的块写回当前图像，同时用被覆盖的块生成反方向的记录。
+ *
+ * 历史只额外保留一份完整图像（最近一次 push() 或撤销 / 重做得到的状态），其余
+ * 只占用变化区域的内存，且这些数据交给 HistoryStore 按全局预算压缩或换出。
+ * 当前图像在两次调用之间被改动而没有 push() 时，undo() 先回到改动前的状态，
+ * redo() 则放弃重做历史，避免把块写到不匹配的图像上。
+ */
+class ImageHistory
+{
+public:
+    ImageHistory() = default;
+    ImageHistory(const ImageHistory &) = delete;
+    ImageHistory &operator=(const ImageHistory &) = delete;
+
+    /**
+     * @brief 保存修改前的状态并清空重做历史
+     */
+    void push(const QImage &state);
+
+    /**
+     * @brief 撤销一步
+     * @param image 当前图像，原地替换为上一个状态
+     * @return 没有可撤销的步骤时返回 false
+     */
+    bool undo(QImage &image);
+
+    /**
+     * @brief 重做一步，image 原地替换为下一个状态
+     */
+    bool redo(QImage &image);
+
+    void clear();
+
+    /**
+     * @brief 放弃重做历史（图像之外的修改使重做不再适用时调用，撤销历史保留）
+     */
+    void discardRedo() { m_redo.clear(); }
+
+    bool canUndo() const { return !m_undo.isEmpty() || m_pendingIsStep; }
+    bool canRedo() const { return !m_redo.isEmpty(); }
+    int undoCount() const { return m_undo.size() + (m_pendingIsStep ? 1 : 0); }
+    int redoCount() const { return m_redo.size(); }
+
+    void setMaxSteps(int steps);
+    int maxSteps() const { return m_maxSteps; }
+
+    /**
+     * @brief 历史记录中未压缩数据的总字节数（不含保留的完整状态）
+     */
+    qint64 storedBytes() const;
+
+    static constexpr int TILE_SIZE = 256;
+    static constexpr int DEFAULT_MAX_STEPS = 50;
+
+private:
+    struct Entry {
+        QSize size;
+        QImage::Format format = QImage::Format_Invalid;
+        QVector<QRgb> colorTable;
+        bool full = false;           ///< 保存整幅图像（尺寸或格式与相邻状态不同）
+        QVector<QRect> tiles;        ///< 按顺序保存在 block 中的块
+        std::shared_ptr<HistoryBlock> block;
+    };
+
+    /**
+     * @brief 比较两个状态，记录把 to 恢复为 from 所需的数据
+     */
+    static Entry diff(const QImage &from, const QImage &to);
+
+    /**
+     * @brief 记录 image 中将被 entry 覆盖的数据，即 entry 的反向记录
+     */
+    static Entry capture(const QImage &image, const Entry &entry);
+
+    static Entry fullEntry(const QImage &image);
+    static Entry tileEntry(const QImage &image, const QVector<QRect> &tiles);
+    static void apply(const Entry &entry, QImage &image);
+    static QVector<QRect> changedTiles(const QImage &a, const QImage &b);
+    static bool isEmpty(const Entry &entry) { return !entry.full && entry.tiles.isEmpty(); }
+
+    void trim();
+    void prefetchNext();
+
+    QImage m_pending;                ///< 最近一次 push() 或撤销 / 重做后的完整状态
+    bool m_pendingIsStep = false;    ///< m_pending 来自 push()，尚未计入 m_undo
+    QVector<Entry> m_undo;           ///< 每项把下一个状态恢复为本状态
+    QVector<Entry> m_redo;           ///< 每项把上一个状态恢复为本状态
+    int m_maxSteps = DEFAULT_MAX_STEPS;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // IMAGEHISTORY_H
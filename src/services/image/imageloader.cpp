@@ -0,0 +1,209 @@
+/**
+ * @file imageloader.cpp
+ * @brief 后台渐进式图像解码实现
+ */
+
+#include "imageloader.h"
+#include <QFile>
+#include <QImageReader>
+#include <QtConcurrent>
+#include <cstdlib>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+bool isCancelled(const ImageLoader::CancelFlag &cancel)
+{
+    return cancel && *cancel;
+}
+
+/**
+ * @brief 取消标志置位后读操作失败的文件
+ */
+class CancellableFile : public QFile
+{
+public:
+    CancellableFile(const QString &filePath, const ImageLoader::CancelFlag &cancel)
+        : QFile(filePath)
+        , m_cancel(cancel)
+    {
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        if (isCancelled(m_cancel)) {
+            return -1;
+        }
+        return QFile::readData(data, maxSize);
+    }
+
+private:
+    ImageLoader::CancelFlag m_cancel;
+};
+
+/**
+ * @brief 按 EXIF 方向旋转后的尺寸（QImageReader::size() 为文件中存储的尺寸）
+ */
+QSize orientedSize(const QImageReader &reader)
+{
+    QSize size = reader.size();
+    if (reader.autoTransform() && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+        size.transpose();
+    }
+    return size;
+}
+
+ImageLoadResult cancelledResult()
+{
+    ImageLoadResult result;
+    result.cancelled = true;
+    result.message = "已取消";
+    return result;
+}
+
+/**
+ * @brief 多图文件（金字塔 TIFF）中与第一幅比例相同的缩小图，取分辨率不低于 target 的最小一幅
+ * @return 图像序号，没有时返回 -1
+ */
+int embeddedPreviewIndex(QImageReader &reader, const QSize &target)
+{
+    const QSize full = reader.size();
+    int best = -1;
+    QSize bestSize;
+    for (int index = 1; index < reader.imageCount() && reader.jumpToImage(index); ++index) {
+        const QSize size = reader.size();
+        if (!size.isValid() || size.width() >= full.width() || size.height() >= full.height()) {
+            continue;
+        }
+        // 宽高比相差 1% 以上的是另一幅图像（多页 TIFF），不是缩小图
+        if (std::abs(qint64(size.width()) * full.height() - qint64(size.height()) * full.width())
+            > qint64(full.width()) * full.height() / 100) {
+            continue;
+        }
+
+        // 分辨率足够的取最小一幅，都不够时取最大一幅
+        const bool enough = size.width() >= target.width();
+        const bool better = best < 0
+            || (enough ? bestSize.width() < target.width() || size.width() < bestSize.width()
+                       : bestSize.width() < target.width() && size.width() > bestSize.width());
+        if (better) {
+            best = index;
+            bestSize = size;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+bool ImageLoader::canLoad(const QString &filePath, QSize *imageSize, QString *errorMsg)
+{
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    if (!reader.canRead()) {
+        if (errorMsg) {
+            *errorMsg = QString("无法读取图像: %1").arg(reader.errorString());
+        }
+        return false;
+    }
+    if (imageSize) {
+        *imageSize = orientedSize(reader);
+    }
+    return true;
+}
+
+ImageLoadResult ImageLoader::loadPreview(const QString &filePath, int maxSize, const CancelFlag &cancel)
+{
+    ImageLoadResult result;
+    CancellableFile file(filePath, cancel);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.message = QString("无法打开文件: %1").arg(file.errorString());
+        return result;
+    }
+
+    QImageReader reader(&file);
+    reader.setAutoTransform(true);
+    result.imageSize = orientedSize(reader);
+    result.success = true;
+    if (!result.imageSize.isValid()
+        || (result.imageSize.width() <= maxSize && result.imageSize.height() <= maxSize)) {
+        return result;
+    }
+
+    const QSize target = result.imageSize.scaled(maxSize, maxSize, Qt::KeepAspectRatio);
+    const QByteArray format = reader.format();
+    if (format == "jpeg" || format == "jpg") {
+        // libjpeg 在 DCT 域按 1/2 ~ 1/8 缩小解码，只需原图解码的一小部分时间；
+        // 其它格式的 setScaledSize 仍先整幅解码，不适合作预览。缩放尺寸针对旋转前的图像
+        reader.setScaledSize(reader.size().scaled(maxSize, maxSize, Qt::KeepAspectRatio));
+        result.image = reader.read();
+    } else if (reader.imageCount() > 1) {
+        const int index = embeddedPreviewIndex(reader, target);
+        if (index >= 0 && reader.jumpToImage(index)) {
+            result.image = reader.read();
+        }
+    }
+
+    if (isCancelled(cancel)) {
+        return cancelledResult();
+    }
+    if (result.image.width() > target.width() || result.image.height() > target.height()) {
+        result.image = result.image.scaled(target, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return result;
+}
+
+ImageLoadResult ImageLoader::load(const QString &filePath, const CancelFlag &cancel)
+{
+    ImageLoadResult result;
+    CancellableFile file(filePath, cancel);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.message = QString("无法打开文件: %1").arg(file.errorString());
+        return result;
+    }
+
+    QImageReader reader(&file);
+    reader.setAutoTransform(true);
+    const QImage image = reader.read();
+    if (isCancelled(cancel)) {
+        return cancelledResult();
+    }
+    if (image.isNull()) {
+        result.message = QString("无法读取图像: %1").arg(reader.errorString());
+        return result;
+    }
+
+    result.imageSize = image.size();
+    if (TiledImage::shouldTile(image.size())) {
+        // 超大图像写入分块缓存，只有可见区域的块驻留内存
+        result.tiles = TiledImage::fromImage(image, &result.message);
+        if (!result.tiles) {
+            return result;
+        }
+    } else {
+        result.image = image;
+    }
+    result.success = true;
+    return result;
+}
+
+QFuture<ImageLoadResult> ImageLoader::loadPreviewAsync(const QString &filePath, int maxSize,
+                                                       const CancelFlag &cancel)
+{
+    return QtConcurrent::run([filePath, maxSize, cancel]() {
+        return loadPreview(filePath, maxSize, cancel);
+    });
+}
+
+QFuture<ImageLoadResult> ImageLoader::loadAsync(const QString &filePath, const CancelFlag &cancel)
+{
+    return QtConcurrent::run([filePath, cancel]() {
+        return load(filePath, cancel);
+    });
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
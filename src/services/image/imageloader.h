@@ -0,0 +1,73 @@
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <QFuture>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+#include "tiledimage.h"
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 图像解码结果
+ */
+struct ImageLoadResult {
+    bool success = false;
+    bool cancelled = false;
+    QString message;
+    QImage image;                       // 预览或原图；原图写入分块存储时为空
+    std::shared_ptr<TiledImage> tiles;  // 超大图像的分块存储
+    QSize imageSize;                    // 原图尺寸（已按 EXIF 方向旋转）
+};
+
+/**
+ * @brief 后台渐进式图像解码
+ *
+ * 打开图片分两步：loadPreview() 只取低分辨率预览（JPEG 按缩小尺寸解码，多图 TIFF
+ * 取内嵌的缩小图），通常在几十毫秒内完成；load() 解码原图，超大图像写入 TiledImage。
+ * 两步可以同时在后台运行。
+ *
+ * 解码器经由可取消的文件设备读取数据，取消标志置位后下一次读文件即失败，
+ * 解码随之中止，不必等整幅图像解码完。
+ */
+class ImageLoader
+{
+public:
+    using CancelFlag = std::shared_ptr<std::atomic<bool>>;
+
+    /**
+     * @brief 检查文件能否解码（只读取文件头）
+     * @param imageSize 可选，输出原图尺寸
+     */
+    static bool canLoad(const QString &filePath, QSize *imageSize = nullptr, QString *errorMsg = nullptr);
+
+    /**
+     * @brief 解码不超过 maxSize 的预览
+     *
+     * 格式只能整幅解码、或原图本身不超过 maxSize 时不生成预览：success 为 true，image 为空。
+     */
+    static ImageLoadResult loadPreview(const QString &filePath, int maxSize = PREVIEW_SIZE,
+                                       const CancelFlag &cancel = CancelFlag());
+
+    /**
+     * @brief 解码原图，TiledImage::shouldTile() 的图像写入分块存储
+     */
+    static ImageLoadResult load(const QString &filePath, const CancelFlag &cancel = CancelFlag());
+
+    static QFuture<ImageLoadResult> loadPreviewAsync(const QString &filePath, int maxSize = PREVIEW_SIZE,
+                                                     const CancelFlag &cancel = CancelFlag());
+    static QFuture<ImageLoadResult> loadAsync(const QString &filePath,
+                                              const CancelFlag &cancel = CancelFlag());
+
+    static constexpr int PREVIEW_SIZE = 1024;  ///< 预览的最大宽高
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // IMAGELOADER_H
@@ -1,11 +1,34 @@
 #include "imageprocessservice.h"
+#include "bilateralfilter.h"
+#include "cannydetector.h"
+#include "convolution.h"
+#include "gaussianblur.h"
+#include "imageenhancer.h"
+#include "medianfilter.h"
+#include "nonlocalmeans.h"
+#include "pointoperations.h"
 #include <QElapsedTimer>
+#include <QMetaObject>
+#include <QtConcurrent>
 #include <QtMath>
 #include <QDebug>
+#include <algorithm>
+#include <cstring>
 
 namespace GenPreCVSystem {
 namespace Utils {
 
+namespace {
+
+// 双边滤波和非局部均值中界面 sigma 每单位对应的灰度级（sigma = 1 时与 OpenCV 的默认强度 10 相当）
+constexpr double STRENGTH_LEVELS = 10.0;
+
+// 全分辨率处理分段的段数（决定进度的粒度）与每段最少行数
+constexpr int STRIP_COUNT = 32;
+constexpr int MIN_STRIP_ROWS = 64;
+
+} // namespace
+
 ImageProcessService::ImageProcessService(QObject *parent)
     : QObject(parent)
 {
@@ -34,27 +57,13 @@ ProcessResult ImageProcessService::enhanceImage(const QImage &image,
     emit logMessage(QString("图像增强: 亮度=%1, 对比度=%2, 饱和度=%3, 锐化=%4")
                     .arg(brightness).arg(contrast).arg(saturation).arg(sharpness));
 
-    QImage processed = image.convertToFormat(QImage::Format_ARGB32);
-
-    // 应用亮度
-    if (brightness != 0) {
-        processed = applyBrightness(processed, brightness);
-    }
-
-    // 应用对比度
-    if (contrast != 0) {
-        processed = applyContrast(processed, contrast);
-    }
-
-    // 应用饱和度
-    if (saturation != 0) {
-        processed = applySaturation(processed, saturation);
-    }
-
-    // 应用锐化
-    if (sharpness > 0) {
-        processed = applySharpness(processed, sharpness);
-    }
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::Enhance;
+    request.brightness = brightness;
+    request.contrast = contrast;
+    request.saturation = saturation;
+    request.sharpness = sharpness;
+    QImage processed = process(image, request);
 
     result.success = true;
     result.processedImage = processed;
@@ -91,28 +100,17 @@ ProcessResult ImageProcessService::denoiseImage(const QImage &image,
     emit logMessage(QString("图像去噪: 方法=%1, 卷积核=%2, sigma=%3")
                     .arg(methodName).arg(kernelSize).arg(sigma));
 
-    QImage processed = image.convertToFormat(QImage::Format_ARGB32);
-
-    switch (method) {
-        case DenoiseMethod::Gaussian:
-            processed = applyGaussianBlur(processed, kernelSize, sigma);
-            break;
-        case DenoiseMethod::Bilateral:
-            processed = applyBilateralFilter(processed, kernelSize, sigma);
-            break;
-        case DenoiseMethod::Median:
-            processed = applyMedianFilter(processed, kernelSize);
-            break;
-        case DenoiseMethod::NLM:
-            // NLM 比较复杂，暂时用高斯代替
-            processed = applyGaussianBlur(processed, kernelSize, sigma);
-            break;
-    }
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::Denoise;
+    request.method = static_cast<int>(method);
+    request.kernelSize = kernelSize;
+    request.sigma = sigma;
+    QImage processed = process(image, request);
 
     result.success = true;
     result.processedImage = processed;
     result.processTime = timer.elapsed();
-    result.message = QString("图像去噪完成，耗时 %1ms").arg(result.processTime);
+    result.message = QString("图像去噪完成（%1），耗时 %2ms").arg(methodName).arg(result.processTime);
 
     emit logMessage(result.message);
     return result;
@@ -145,23 +143,13 @@ ProcessResult ImageProcessService::detectEdges(const QImage &image,
     emit logMessage(QString("边缘检测: 方法=%1, 阈值1=%2, 阈值2=%3")
                     .arg(methodName).arg(threshold1).arg(threshold2));
 
-    QImage processed;
-
-    switch (method) {
-        case EdgeMethod::Sobel:
-            processed = applySobel(image, apertureSize);
-            break;
-        case EdgeMethod::Canny:
-            processed = applyCanny(image, threshold1, threshold2, apertureSize);
-            break;
-        case EdgeMethod::Laplacian:
-            processed = applyLaplacian(image, apertureSize);
-            break;
-        case EdgeMethod::Scharr:
-            // Scharr 是 Sobel 的变体，使用固定卷积核大小3
-            processed = applySobel(image, 3);
-            break;
-    }
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::EdgeDetection;
+    request.method = static_cast<int>(method);
+    request.threshold1 = threshold1;
+    request.threshold2 = threshold2;
+    request.apertureSize = apertureSize;
+    QImage processed = process(image, request);
 
     result.success = true;
     result.processedImage = processed;
@@ -172,386 +160,401 @@ ProcessResult ImageProcessService::detectEdges(const QImage &image,
     return result;
 }
 
-// 辅助函数实现
-
-QImage ImageProcessService::applyBrightness(const QImage &image, int brightness)
+ProcessResult ImageProcessService::preview(const QImage &image, const ProcessRequest &request,
+                                           double viewScale)
 {
-    QImage result(image.size(), QImage::Format_ARGB32);
-
-    for (int y = 0; y < image.height(); ++y) {
-        const QRgb *srcLine = reinterpret_cast<const QRgb*>(image.scanLine(y));
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-
-        for (int x = 0; x < image.width(); ++x) {
-            int r = qRed(srcLine[x]) + brightness;
-            int g = qGreen(srcLine[x]) + brightness;
-            int b = qBlue(srcLine[x]) + brightness;
-            int a = qAlpha(srcLine[x]);
+    QElapsedTimer timer;
+    timer.start();
 
-            r = qBound(0, r, 255);
-            g = qBound(0, g, 255);
-            b = qBound(0, b, 255);
+    if (image.isNull()) {
+        ProcessResult result;
+        result.success = false;
+        result.message = "输入图像为空";
+        return result;
+    }
 
-            dstLine[x] = qRgba(r, g, b, a);
-        }
+    // 拖动滑块时每次预览都是同一幅图像，金字塔只在换图后重建
+    if (image.cacheKey() != m_previewKey || m_previewPyramid.base().isNull()) {
+        m_previewPyramid.setBase(image);
+        m_previewKey = image.cacheKey();
+        m_previewTilesKey = 0;
     }
 
+    ProcessResult result = previewPyramidLevel(request, viewScale, 1.0);
+    result.processTime = timer.elapsed();
+    result.message = QString("预览完成（%1x%2），耗时 %3ms")
+                     .arg(result.processedImage.width())
+                     .arg(result.processedImage.height())
+                     .arg(result.processTime);
     return result;
 }
 
-QImage ImageProcessService::applyContrast(const QImage &image, int contrast)
+ProcessResult ImageProcessService::preview(const TiledImage &image, const ProcessRequest &request,
+                                           double viewScale)
 {
-    QImage result(image.size(), QImage::Format_ARGB32);
-    double factor = (259.0 * (contrast + 255)) / (255.0 * (259 - contrast));
-
-    for (int y = 0; y < image.height(); ++y) {
-        const QRgb *srcLine = reinterpret_cast<const QRgb*>(image.scanLine(y));
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-
-        for (int x = 0; x < image.width(); ++x) {
-            int r = static_cast<int>(factor * (qRed(srcLine[x]) - 128) + 128);
-            int g = static_cast<int>(factor * (qGreen(srcLine[x]) - 128) + 128);
-            int b = static_cast<int>(factor * (qBlue(srcLine[x]) - 128) + 128);
-            int a = qAlpha(srcLine[x]);
-
-            r = qBound(0, r, 255);
-            g = qBound(0, g, 255);
-            b = qBound(0, b, 255);
+    QElapsedTimer timer;
+    timer.start();
 
-            dstLine[x] = qRgba(r, g, b, a);
-        }
+    if (image.cacheKey() != m_previewTilesKey || m_previewPyramid.base().isNull()) {
+        m_previewPyramid.setBase(image.overview());
+        m_previewTilesKey = image.cacheKey();
+        m_previewKey = 0;
     }
 
+    ProcessResult result = previewPyramidLevel(request, viewScale, image.overviewScale());
+    result.processTime = timer.elapsed();
+    result.message = QString("预览完成（%1x%2），耗时 %3ms")
+                     .arg(result.processedImage.width())
+                     .arg(result.processedImage.height())
+                     .arg(result.processTime);
     return result;
 }
 
-QImage ImageProcessService::applySaturation(const QImage &image, int saturation)
+/**
+ * 在预览金字塔中选择分辨率不低于 viewScale 的最小一层处理。
+ * baseScale 为金字塔底层相对原图的比例，结果的 scale 相对原图。
+ */
+ProcessResult ImageProcessService::previewPyramidLevel(const ProcessRequest &request, double viewScale,
+                                                       double baseScale)
 {
-    QImage result(image.size(), QImage::Format_ARGB32);
-    double satFactor = 1.0 + saturation / 100.0;
-
-    for (int y = 0; y < image.height(); ++y) {
-        const QRgb *srcLine = reinterpret_cast<const QRgb*>(image.scanLine(y));
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-
-        for (int x = 0; x < image.width(); ++x) {
-            int r = qRed(srcLine[x]);
-            int g = qGreen(srcLine[x]);
-            int b = qBlue(srcLine[x]);
-            int a = qAlpha(srcLine[x]);
+    ProcessResult result;
+    const int level = std::min(ImagePyramid::levelForScale(viewScale / baseScale),
+                               m_previewPyramid.maxLevel());
+    result.scale = ImagePyramid::levelScale(level) * baseScale;
+    result.processedImage = process(m_previewPyramid.level(level), request, result.scale);
+    result.success = !result.processedImage.isNull();
+    return result;
+}
 
-            // 转换到 YUV 色彩空间调整饱和度
-            double gray = 0.299 * r + 0.587 * g + 0.114 * b;
+void ImageProcessService::clearPreviewCache()
+{
+    m_previewPyramid.setBase(QImage());
+    m_previewKey = 0;
+    m_previewTilesKey = 0;
+}
 
-            r = static_cast<int>(gray + satFactor * (r - gray));
-            g = static_cast<int>(gray + satFactor * (g - gray));
-            b = static_cast<int>(gray + satFactor * (b - gray));
+QFuture<ProcessResult> ImageProcessService::processAsync(const QImage &image,
+                                                         const ProcessRequest &request)
+{
+    return QtConcurrent::run([this, image, request]() {
+        ProcessResult result;
+        QElapsedTimer timer;
+        timer.start();
+
+        if (image.isNull()) {
+            result.success = false;
+            result.message = "输入图像为空";
+            return result;
+        }
 
-            r = qBound(0, r, 255);
-            g = qBound(0, g, 255);
-            b = qBound(0, b, 255);
+        // 进度在服务所在线程上发出，接收方无需考虑线程
+        result.processedImage = processInStrips(image, request, [this](int percent) {
+            QMetaObject::invokeMethod(this, [this, percent]() {
+                emit progressChanged(percent);
+            }, Qt::QueuedConnection);
+        });
+        result.success = !result.processedImage.isNull();
+        result.processTime = timer.elapsed();
+        result.message = QString("全分辨率处理完成（%1x%2），耗时 %3ms")
+                         .arg(image.width())
+                         .arg(image.height())
+                         .arg(result.processTime);
+        return result;
+    });
+}
 
-            dstLine[x] = qRgba(r, g, b, a);
+QFuture<ProcessResult> ImageProcessService::processAsync(const std::shared_ptr<TiledImage> &image,
+                                                         const ProcessRequest &request)
+{
+    return QtConcurrent::run([this, image, request]() {
+        ProcessResult result;
+        QElapsedTimer timer;
+        timer.start();
+
+        if (!image) {
+            result.success = false;
+            result.message = "输入图像为空";
+            return result;
         }
-    }
 
-    return result;
+        QString errorMsg;
+        result.processedTiles = processTiled(*image, request, [this](int percent) {
+            QMetaObject::invokeMethod(this, [this, percent]() {
+                emit progressChanged(percent);
+            }, Qt::QueuedConnection);
+        }, &errorMsg);
+        result.success = result.processedTiles != nullptr;
+        result.processTime = timer.elapsed();
+        result.message = result.success
+                         ? QString("全分辨率处理完成（%1x%2），耗时 %3ms")
+                               .arg(image->width())
+                               .arg(image->height())
+                               .arg(result.processTime)
+                         : errorMsg;
+        return result;
+    });
 }
 
-QImage ImageProcessService::applySharpness(const QImage &image, int sharpness)
+QImage ImageProcessService::process(const QImage &image, const ProcessRequest &request, double scale)
 {
-    QImage result(image.size(), QImage::Format_ARGB32);
-    double factor = sharpness / 100.0;
-
-    // 锐化卷积核
-    double kernel[3][3] = {
-        {0, -factor, 0},
-        {-factor, 1 + 4 * factor, -factor},
-        {0, -factor, 0}
-    };
-
-    for (int y = 1; y < image.height() - 1; ++y) {
-        const QRgb *srcPrev = reinterpret_cast<const QRgb*>(image.scanLine(y - 1));
-        const QRgb *srcCurr = reinterpret_cast<const QRgb*>(image.scanLine(y));
-        const QRgb *srcNext = reinterpret_cast<const QRgb*>(image.scanLine(y + 1));
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-
-        for (int x = 1; x < image.width() - 1; ++x) {
-            double r = 0, g = 0, b = 0;
-
-            for (int ky = -1; ky <= 1; ++ky) {
-                for (int kx = -1; kx <= 1; ++kx) {
-                    const QRgb *line;
-                    if (ky == -1) line = srcPrev;
-                    else if (ky == 0) line = srcCurr;
-                    else line = srcNext;
-
-                    QRgb pixel = line[x + kx];
-                    double k = kernel[ky + 1][kx + 1];
-
-                    r += qRed(pixel) * k;
-                    g += qGreen(pixel) * k;
-                    b += qBlue(pixel) * k;
-                }
-            }
+    if (image.isNull()) {
+        return image;
+    }
 
-            dstLine[x] = qRgba(qBound(0, static_cast<int>(r), 255),
-                               qBound(0, static_cast<int>(g), 255),
-                               qBound(0, static_cast<int>(b), 255),
-                               qAlpha(srcCurr[x]));
+    switch (request.type) {
+        case ProcessRequest::Type::Enhance:
+            // 四项调整在一趟融合处理中完成
+            return ImageEnhancer::apply(image, request.brightness, request.contrast,
+                                        request.saturation, request.sharpness);
+
+        case ProcessRequest::Type::Denoise: {
+            const QImage source = image.convertToFormat(QImage::Format_ARGB32);
+            switch (static_cast<DenoiseMethod>(request.method)) {
+                case DenoiseMethod::Gaussian:
+                    return applyGaussianBlur(source, request.kernelSize, request.sigma, scale);
+                case DenoiseMethod::Bilateral:
+                    return applyBilateralFilter(source, request.kernelSize, request.sigma, scale);
+                case DenoiseMethod::Median:
+                    return applyMedianFilter(source, request.kernelSize, scale);
+                case DenoiseMethod::NLM:
+                    return applyNonLocalMeans(source, request.kernelSize, request.sigma);
+            }
+            return source;
         }
-    }
 
-    // 复制边缘
-    for (int x = 0; x < image.width(); ++x) {
-        result.setPixel(x, 0, image.pixel(x, 0));
-        result.setPixel(x, image.height() - 1, image.pixel(x, image.height() - 1));
-    }
-    for (int y = 0; y < image.height(); ++y) {
-        result.setPixel(0, y, image.pixel(0, y));
-        result.setPixel(image.width() - 1, y, image.pixel(image.width() - 1, y));
+        case ProcessRequest::Type::EdgeDetection:
+            switch (static_cast<EdgeMethod>(request.method)) {
+                case EdgeMethod::Sobel:
+                    return applySobel(image, request.apertureSize);
+                case EdgeMethod::Canny:
+                    return applyCanny(image, request.threshold1, request.threshold2,
+                                      request.apertureSize);
+                case EdgeMethod::Laplacian:
+                    return applyLaplacian(image, request.apertureSize);
+                case EdgeMethod::Scharr:
+                    // Scharr 是 Sobel 的变体，使用固定卷积核大小3
+                    return applySobel(image, 3);
+            }
+            break;
     }
-
-    return result;
+    return image;
 }
 
-QImage ImageProcessService::applyGaussianBlur(const QImage &image, int kernelSize, double sigma)
+QImage ImageProcessService::processInStrips(const QImage &image, const ProcessRequest &request,
+                                            const std::function<void(int)> &progress)
 {
-    if (kernelSize < 3) kernelSize = 3;
-    if (kernelSize % 2 == 0) kernelSize++;
-
-    QImage result(image.size(), QImage::Format_ARGB32);
-    int half = kernelSize / 2;
+    const int halo = haloFor(request);
+    const int width = image.width();
+    const int height = image.height();
+    const int stripRows = std::max({(height + STRIP_COUNT - 1) / STRIP_COUNT, MIN_STRIP_ROWS, 8 * halo});
+
+    if (image.isNull() || halo < 0 || stripRows >= height) {
+        QImage result = process(image, request);
+        if (progress) {
+            progress(100);
+        }
+        return result;
+    }
 
-    // 创建高斯核
-    QVector<QVector<double>> kernel(kernelSize, QVector<double>(kernelSize));
-    double sum = 0;
+    // 各行条连同上下 halo 行一起处理，只保留中间部分：
+    // 行条边界处的复制边界只影响被丢弃的 halo 行
+    QImage result;
+    for (int y0 = 0; y0 < height; y0 += stripRows) {
+        const int y1 = std::min(y0 + stripRows, height);
+        const int top = std::max(y0 - halo, 0);
+        const int bottom = std::min(y1 + halo, height);
+        const QImage strip = process(image.copy(0, top, width, bottom - top), request);
+
+        if (result.isNull()) {
+            result = QImage(width, height, strip.format());
+        }
+        const size_t bytes = static_cast<size_t>(std::min(result.bytesPerLine(), strip.bytesPerLine()));
+        for (int y = y0; y < y1; ++y) {
+            std::memcpy(result.scanLine(y), strip.constScanLine(y - top), bytes);
+        }
 
-    for (int y = 0; y < kernelSize; ++y) {
-        for (int x = 0; x < kernelSize; ++x) {
-            int dx = x - half;
-            int dy = y - half;
-            kernel[y][x] = qExp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
-            sum += kernel[y][x];
+        if (progress) {
+            progress(static_cast<int>(static_cast<qint64>(y1) * 100 / height));
         }
     }
+    return result;
+}
 
-    // 归一化
-    for (int y = 0; y < kernelSize; ++y) {
-        for (int x = 0; x < kernelSize; ++x) {
-            kernel[y][x] /= sum;
+std::shared_ptr<TiledImage> ImageProcessService::processTiled(const TiledImage &image,
+                                                          const ProcessRequest &request,
+                                                          const std::function<void(int)> &progress,
+                                                          QString *errorMsg)
+{
+    const int halo = haloFor(request);
+    if (halo < 0) {
+        std::shared_ptr<TiledImage> result = TiledImage::fromImage(process(image.toImage(), request), errorMsg);
+        if (progress) {
+            progress(100);
         }
+        return result;
     }
 
-    // 应用卷积
-    QImage temp = image.convertToFormat(QImage::Format_ARGB32);
-
-    for (int y = 0; y < image.height(); ++y) {
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-
-        for (int x = 0; x < image.width(); ++x) {
-            double r = 0, g = 0, b = 0, a = 0;
-
-            for (int ky = 0; ky < kernelSize; ++ky) {
-                int sy = qBound(0, y + ky - half, image.height() - 1);
-                const QRgb *srcLine = reinterpret_cast<const QRgb*>(temp.scanLine(sy));
-
-                for (int kx = 0; kx < kernelSize; ++kx) {
-                    int sx = qBound(0, x + kx - half, image.width() - 1);
-                    QRgb pixel = srcLine[sx];
-                    double k = kernel[ky][kx];
-
-                    r += qRed(pixel) * k;
-                    g += qGreen(pixel) * k;
-                    b += qBlue(pixel) * k;
-                    a += qAlpha(pixel) * k;
-                }
-            }
+    std::shared_ptr<TiledImage> result = TiledImage::create(image.size(), image.format(), errorMsg);
+    if (!result) {
+        return result;
+    }
 
-            dstLine[x] = qRgba(static_cast<int>(r), static_cast<int>(g),
-                               static_cast<int>(b), static_cast<int>(a));
+    // 与 processInStrips() 相同：各组块连同四周 halo 像素一起处理，只写回中间部分
+    const int blockSize = BLOCK_TILES * TiledImage::TILE_SIZE;
+    const int blockColumns = (image.width() + blockSize - 1) / blockSize;
+    const int blockRows = (image.height() + blockSize - 1) / blockSize;
+    const int blockCount = blockColumns * blockRows;
+    for (int index = 0; index < blockCount; ++index) {
+        const QRect block = QRect((index % blockColumns) * blockSize, (index / blockColumns) * blockSize,
+                                  blockSize, blockSize) & image.rect();
+        const QRect input = block.adjusted(-halo, -halo, halo, halo) & image.rect();
+        const QImage processed = process(image.region(input), request);
+        result->writeRegion(block.topLeft(), processed.copy(block.translated(-input.topLeft())));
+
+        if (progress) {
+            progress(static_cast<int>(static_cast<qint64>(index + 1) * 100 / blockCount));
         }
     }
-
     return result;
 }
 
-QImage ImageProcessService::applyBilateralFilter(const QImage &image, int kernelSize, double sigma)
+int ImageProcessService::haloFor(const ProcessRequest &request)
 {
-    // 简化的双边滤波实现
-    if (kernelSize < 3) kernelSize = 3;
-    if (kernelSize % 2 == 0) kernelSize++;
+    switch (request.type) {
+        case ProcessRequest::Type::Enhance:
+            // 点运算加 3x3 锐化
+            return request.sharpness > 0 ? 1 : 0;
+
+        case ProcessRequest::Type::Denoise: {
+            const int kernelSize = request.kernelSize % 2 == 0 ? request.kernelSize + 1
+                                                               : std::max(request.kernelSize, 3);
+            switch (static_cast<DenoiseMethod>(request.method)) {
+                case DenoiseMethod::Gaussian: {
+                    int extent = 0;
+                    for (const BoxFilter &box : GaussianBlur::boxFilters(gaussianSigma(kernelSize, request.sigma))) {
+                        extent += box.radius + 1;
+                    }
+                    return extent;
+                }
+                case DenoiseMethod::Bilateral: {
+                    // 大 sigma 使用的双边网格按整幅图像对齐，分段后网格位置不同
+                    const int radius = static_cast<int>(
+                        std::ceil(2 * GaussianBlur::sigmaForKernelSize(kernelSize)));
+                    return radius <= BilateralFilter::DIRECT_MAX_RADIUS ? radius : -1;
+                }
+                case DenoiseMethod::Median:
+                    return std::min(kernelSize / 2, MedianFilter::MAX_RADIUS);
+                case DenoiseMethod::NLM:
+                    return qMin(kernelSize / 2, NonLocalMeans::MAX_PATCH_RADIUS)
+                           + NonLocalMeans::DEFAULT_SEARCH_RADIUS;
+            }
+            return -1;
+        }
 
-    QImage result = image.convertToFormat(QImage::Format_ARGB32);
-    // 双边滤波比较复杂，这里用高斯模糊近似
-    return applyGaussianBlur(result, kernelSize, sigma);
+        case ProcessRequest::Type::EdgeDetection:
+            // Canny 的滞后阈值沿边缘连通，不是局部运算
+            return static_cast<EdgeMethod>(request.method) == EdgeMethod::Canny ? -1 : 1;
+    }
+    return -1;
 }
 
-QImage ImageProcessService::applyMedianFilter(const QImage &image, int kernelSize)
+// 辅助函数实现
+
+double ImageProcessService::gaussianSigma(int kernelSize, double sigma)
 {
     if (kernelSize < 3) kernelSize = 3;
     if (kernelSize % 2 == 0) kernelSize++;
 
-    QImage result(image.size(), QImage::Format_ARGB32);
+    if (sigma <= 0) {
+        sigma = GaussianBlur::sigmaForKernelSize(kernelSize);
+    }
+
+    // 卷积核大小限定的是截断范围：取截断后离散核的实际标准差，
+    // sigma 远大于核宽时结果与原先的截断核一致，不会无限扩散
     int half = kernelSize / 2;
+    double sum = 0;
+    double moment = 0;
+    for (int d = -half; d <= half; ++d) {
+        double weight = qExp(-(d * d) / (2 * sigma * sigma));
+        sum += weight;
+        moment += weight * d * d;
+    }
+    return qSqrt(moment / sum);
+}
 
-    QImage temp = image.convertToFormat(QImage::Format_ARGB32);
+QImage ImageProcessService::applyGaussianBlur(const QImage &image, int kernelSize, double sigma,
+                                              double scale)
+{
+    return GaussianBlur::blur(image.convertToFormat(QImage::Format_ARGB32),
+                              gaussianSigma(kernelSize, sigma) * scale);
+}
 
-    for (int y = 0; y < image.height(); ++y) {
-        QRgb *dstLine = reinterpret_cast<QRgb*>(result.scanLine(y));
+QImage ImageProcessService::applyBilateralFilter(const QImage &image, int kernelSize, double sigma,
+                                                 double scale)
+{
+    if (kernelSize < 3) kernelSize = 3;
+    if (kernelSize % 2 == 0) kernelSize++;
 
-        for (int x = 0; x < image.width(); ++x) {
-            QVector<int> reds, greens, blues;
+    // 卷积核大小决定空间范围，sigma 决定值域宽度
+    return BilateralFilter::apply(image.convertToFormat(QImage::Format_ARGB32),
+                                  GaussianBlur::sigmaForKernelSize(kernelSize) * scale,
+                                  sigma * STRENGTH_LEVELS);
+}
 
-            for (int ky = -half; ky <= half; ++ky) {
-                int sy = qBound(0, y + ky, image.height() - 1);
-                const QRgb *srcLine = reinterpret_cast<const QRgb*>(temp.scanLine(sy));
+QImage ImageProcessService::applyNonLocalMeans(const QImage &image, int kernelSize, double sigma)
+{
+    if (kernelSize < 3) kernelSize = 3;
 
-                for (int kx = -half; kx <= half; ++kx) {
-                    int sx = qBound(0, x + kx, image.width() - 1);
-                    QRgb pixel = srcLine[sx];
-                    reds.append(qRed(pixel));
-                    greens.append(qGreen(pixel));
-                    blues.append(qBlue(pixel));
-                }
-            }
+    // 卷积核大小决定比较块的大小（块距离由积分图求得，不影响耗时），sigma 决定滤波强度
+    const int patchRadius = qMin(kernelSize / 2, NonLocalMeans::MAX_PATCH_RADIUS);
+    return NonLocalMeans::apply(image.convertToFormat(QImage::Format_ARGB32),
+                                sigma * STRENGTH_LEVELS, patchRadius);
+}
 
-            std::sort(reds.begin(), reds.end());
-            std::sort(greens.begin(), greens.end());
-            std::sort(blues.begin(), blues.end());
+QImage ImageProcessService::applyMedianFilter(const QImage &image, int kernelSize, double scale)
+{
+    if (kernelSize < 3) kernelSize = 3;
+    if (kernelSize % 2 == 0) kernelSize++;
 
-            int mid = reds.size() / 2;
-            dstLine[x] = qRgb(reds[mid], greens[mid], blues[mid]);
-        }
+    // 缩小层上窗口半径按比例缩小，缩到 0 时不再滤波
+    const int radius = qRound(kernelSize / 2 * scale);
+    if (radius <= 0) {
+        return image.convertToFormat(QImage::Format_ARGB32);
     }
-
-    return result;
+    return MedianFilter::apply(image.convertToFormat(QImage::Format_ARGB32), 2 * radius + 1);
 }
 
 QImage ImageProcessService::toGrayscale(const QImage &image)
 {
-    QImage result(image.size(), QImage::Format_Grayscale8);
-
-    for (int y = 0; y < image.height(); ++y) {
-        const QRgb *srcLine = reinterpret_cast<const QRgb*>(image.scanLine(y));
-        uchar *dstLine = result.scanLine(y);
-
-        for (int x = 0; x < image.width(); ++x) {
-            dstLine[x] = static_cast<uchar>(qGray(srcLine[x]));
-        }
-    }
-
-    return result;
+    return PointOperations::toGray8(image);
 }
 
 QImage ImageProcessService::applySobel(const QImage &image, int ksize)
 {
-    QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
-    QImage result(image.size(), QImage::Format_Grayscale8);
-
-    // 初始化整个结果图像为黑色
-    result.fill(0);
-
-    // Sobel kernels
-    int sobelX[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
-    int sobelY[3][3] = {{-1, -2, -1}, {0, 0, 0}, {1, 2, 1}};
-
-    for (int y = 1; y < gray.height() - 1; ++y) {
-        const uchar *prevLine = gray.scanLine(y - 1);
-        const uchar *currLine = gray.scanLine(y);
-        const uchar *nextLine = gray.scanLine(y + 1);
-        uchar *dstLine = result.scanLine(y);
-
-        for (int x = 1; x < gray.width() - 1; ++x) {
-            int gx = 0, gy = 0;
-
-            for (int ky = -1; ky <= 1; ++ky) {
-                const uchar *line;
-                if (ky == -1) line = prevLine;
-                else if (ky == 0) line = currLine;
-                else line = nextLine;
-
-                for (int kx = -1; kx <= 1; ++kx) {
-                    int pixel = line[x + kx];
-                    gx += pixel * sobelX[ky + 1][kx + 1];
-                    gy += pixel * sobelY[ky + 1][kx + 1];
-                }
-            }
+    Q_UNUSED(ksize)
 
-            int magnitude = static_cast<int>(qSqrt(gx * gx + gy * gy));
-            dstLine[x] = qBound(0, magnitude, 255);
-        }
-    }
-
-    return result;
+    return ConvolutionEngine::gradientMagnitude(image, ConvolutionEngine::sobelX(),
+                                                ConvolutionEngine::sobelY());
 }
 
 QImage ImageProcessService::applyCanny(const QImage &image, double threshold1, double threshold2, int apertureSize)
 {
-    // 简化的 Canny 实现：先 Sobel，然后阈值处理
-    QImage sobelResult = applySobel(image, apertureSize);
-
-    QImage result(sobelResult.size(), QImage::Format_Grayscale8);
-
-    // 初始化整个结果图像为黑色
-    result.fill(0);
-
-    for (int y = 0; y < sobelResult.height(); ++y) {
-        const uchar *srcLine = sobelResult.scanLine(y);
-        uchar *dstLine = result.scanLine(y);
-
-        for (int x = 0; x < sobelResult.width(); ++x) {
-            int val = srcLine[x];
-
-            if (val >= threshold2) {
-                dstLine[x] = 255;  // 强边缘
-            } else if (val >= threshold1) {
-                dstLine[x] = 128;  // 弱边缘
-            } else {
-                dstLine[x] = 0;    // 非边缘
-            }
-        }
-    }
-
-    return result;
+    return CannyDetector::detect(image, threshold1, threshold2, apertureSize);
 }
 
 QImage ImageProcessService::applyLaplacian(const QImage &image, int ksize)
 {
-    QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
-    QImage result(image.size(), QImage::Format_Grayscale8);
+    Q_UNUSED(ksize)
 
-    // 初始化整个结果图像为黑色
-    result.fill(0);
+    QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
 
     // Laplacian kernel
-    int laplacian[3][3] = {{0, 1, 0}, {1, -4, 1}, {0, 1, 0}};
-
-    for (int y = 1; y < gray.height() - 1; ++y) {
-        const uchar *prevLine = gray.scanLine(y - 1);
-        const uchar *currLine = gray.scanLine(y);
-        const uchar *nextLine = gray.scanLine(y + 1);
-        uchar *dstLine = result.scanLine(y);
-
-        for (int x = 1; x < gray.width() - 1; ++x) {
-            int sum = 0;
-
-            for (int ky = -1; ky <= 1; ++ky) {
-                const uchar *line;
-                if (ky == -1) line = prevLine;
-                else if (ky == 0) line = currLine;
-                else line = nextLine;
-
-                for (int kx = -1; kx <= 1; ++kx) {
-                    sum += line[x + kx] * laplacian[ky + 1][kx + 1];
-                }
-            }
+    QVector<QVector<int>> laplacian = {{0, 1, 0}, {1, -4, 1}, {0, 1, 0}};
 
-            dstLine[x] = qBound(0, qAbs(sum), 255);
-        }
-    }
+    ConvolutionOptions options;
+    options.absolute = true;
 
-    return result;
+    return ConvolutionEngine::convolve(gray, ConvolutionKernel::fromMatrix(laplacian), options);
 }
 
 } // namespace Utils
@@ -2,9 +2,15 @@
 #define IMAGEPROCESSSERVICE_H
 
 #include <QObject>
+#include <QFuture>
 #include <QImage>
 #include <QPixmap>
 #include <QString>
+#include <functional>
+#include <memory>
+
+#include "imagepyramid.h"
+#include "tiledimage.h"
 
 namespace GenPreCVSystem {
 namespace Utils {
@@ -16,13 +22,51 @@ struct ProcessResult {
     bool success = false;
     QString message;
     QImage processedImage;
+    std::shared_ptr<TiledImage> processedTiles;  // 输入为分块图像时的结果，processedImage 为空
     double processTime = 0.0;
+    double scale = 1.0;  // 结果相对输入图像的比例，预览结果小于 1
+};
+
+/**
+ * @brief 一次图像处理的类型与参数
+ *
+ * 预览和全分辨率处理使用同一份参数，保证二者结果一致（预览只是分辨率较低）。
+ */
+struct ProcessRequest {
+    enum class Type {
+        Enhance,
+        Denoise,
+        EdgeDetection
+    };
+    Type type = Type::Enhance;
+
+    // 图像增强
+    int brightness = 0;
+    int contrast = 0;
+    int saturation = 0;
+    int sharpness = 0;
+
+    // 去噪 / 边缘检测方法（ImageProcessService::DenoiseMethod / EdgeMethod 的下标）
+    int method = 0;
+
+    // 图像去噪
+    int kernelSize = 3;
+    double sigma = 1.0;
+
+    // 边缘检测
+    double threshold1 = 100.0;
+    double threshold2 = 200.0;
+    int apertureSize = 3;
 };
 
 /**
  * @brief 图像处理服务
  *
- * 提供图像增强、去噪、边缘检测等传统图像处理功能
+ * 提供图像增强、去噪、边缘检测等传统图像处理功能。
+ *
+ * 参数调整时用 preview() 在与视图缩放比例相当的金字塔缩小层上处理，
+ * 只有应用时才用 processAsync() 在后台线程上做全分辨率处理：局部运算
+ * 按行条分段完成并报告进度，结果与整幅处理一致。
  */
 class ImageProcessService : public QObject
 {
@@ -64,6 +108,70 @@ public:
                                double threshold2,
                                int apertureSize);
 
+    /**
+     * @brief 在缩小的金字塔层上预览处理结果
+     * @param viewScale 视图显示比例，选择分辨率不低于该比例的最小一层
+     *
+     * 同一幅图像（按 cacheKey 判断）的金字塔在连续预览间复用。
+     * 结果的 scale 为所用层相对原图的比例，与像素距离相关的参数按该比例缩小。
+     */
+    ProcessResult preview(const QImage &image, const ProcessRequest &request, double viewScale);
+
+    /**
+     * @brief 在分块图像的缩略图上预览处理结果
+     *
+     * 缩略图作为金字塔的底层，结果的 scale 仍是相对原图的比例。
+     */
+    ProcessResult preview(const TiledImage &image, const ProcessRequest &request, double viewScale);
+
+    /**
+     * @brief 释放预览用的金字塔
+     */
+    void clearPreviewCache();
+
+    /**
+     * @brief 在后台线程上做全分辨率处理，处理过程中发出 progressChanged
+     */
+    QFuture<ProcessResult> processAsync(const QImage &image, const ProcessRequest &request);
+
+    /**
+     * @brief 在后台线程上处理分块图像，结果写入新的分块图像（ProcessResult::processedTiles）
+     */
+    QFuture<ProcessResult> processAsync(const std::shared_ptr<TiledImage> &image,
+                                        const ProcessRequest &request);
+
+    /**
+     * @brief 按 request 处理图像（同步、线程安全）
+     * @param scale 图像相对原图的比例，用于缩放模糊半径等与像素距离相关的参数
+     */
+    static QImage process(const QImage &image, const ProcessRequest &request, double scale = 1.0);
+
+    /**
+     * @brief 按行条分段处理整幅图像
+     *
+     * 每个行条向上下各多取 haloFor() 行输入，结果与 process() 一致；
+     * 不是局部运算（如 Canny 的滞后阈值）时整幅处理。每完成一段以百分比调用 progress。
+     */
+    static QImage processInStrips(const QImage &image, const ProcessRequest &request,
+                                  const std::function<void(int)> &progress = {});
+
+    /**
+     * @brief 按块处理分块图像，结果写入新的分块图像
+     *
+     * 每次读入 BLOCK_TILES x BLOCK_TILES 块连同四周 haloFor() 像素，处理后只写回中间部分，
+     * 常驻内存的只有当前一组块；不是局部运算时读出整幅图像处理。
+     */
+    static std::shared_ptr<TiledImage> processTiled(const TiledImage &image, const ProcessRequest &request,
+                                                    const std::function<void(int)> &progress = {},
+                                                    QString *errorMsg = nullptr);
+
+    /**
+     * @brief 输出像素依赖的输入邻域半径，不是局部运算时返回 -1
+     */
+    static int haloFor(const ProcessRequest &request);
+
+    static constexpr int BLOCK_TILES = 4;  ///< processTiled() 每次处理的块数（每边）
+
     // 图像分类（使用 DL 服务）
     // 关键点检测（使用 DL-pose 服务）
     // 语义分割（使用 DL-seg 服务）
@@ -71,20 +179,26 @@ public:
 signals:
     void processCompleted(const ProcessResult &result);
     void logMessage(const QString &message);
+    void progressChanged(int percent);
 
 private:
     // 辅助函数
-    QImage applyBrightness(const QImage &image, int brightness);
-    QImage applyContrast(const QImage &image, int contrast);
-    QImage applySaturation(const QImage &image, int saturation);
-    QImage applySharpness(const QImage &image, int sharpness);
-    QImage applyGaussianBlur(const QImage &image, int kernelSize, double sigma);
-    QImage applyBilateralFilter(const QImage &image, int kernelSize, double sigma);
-    QImage applyMedianFilter(const QImage &image, int kernelSize);
-    QImage applySobel(const QImage &image, int ksize);
-    QImage applyCanny(const QImage &image, double threshold1, double threshold2, int apertureSize);
-    QImage applyLaplacian(const QImage &image, int ksize);
-    QImage toGrayscale(const QImage &image);
+    static QImage applyGaussianBlur(const QImage &image, int kernelSize, double sigma, double scale);
+    static QImage applyBilateralFilter(const QImage &image, int kernelSize, double sigma, double scale);
+    static QImage applyMedianFilter(const QImage &image, int kernelSize, double scale);
+    static QImage applyNonLocalMeans(const QImage &image, int kernelSize, double sigma);
+    static QImage applySobel(const QImage &image, int ksize);
+    static QImage applyCanny(const QImage &image, double threshold1, double threshold2, int apertureSize);
+    static QImage applyLaplacian(const QImage &image, int ksize);
+    static QImage toGrayscale(const QImage &image);
+    static double gaussianSigma(int kernelSize, double sigma);
+
+    ProcessResult previewPyramidLevel(const ProcessRequest &request, double viewScale, double baseScale);
+
+    // 预览用金字塔及其对应图像的 cacheKey（分块图像以缩略图为底层，另记其 cacheKey）
+    ImagePyramid m_previewPyramid;
+    qint64 m_previewKey = 0;
+    qint64 m_previewTilesKey = 0;
 };
 
 } // namespace Utils
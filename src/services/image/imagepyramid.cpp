@@ -0,0 +1,137 @@
+/**
+ * @file imagepyramid.cpp
+ * @brief 2x2 平均图像金字塔实现
+ */
+
+#include "imagepyramid.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+// 四个字节通道分别求 2x2 平均（四舍五入）
+inline QRgb average4(QRgb a, QRgb b, QRgb c, QRgb d)
+{
+    QRgb result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const quint32 sum = ((a >> shift) & 0xff) + ((b >> shift) & 0xff)
+                            + ((c >> shift) & 0xff) + ((d >> shift) & 0xff);
+        result |= ((sum + 2) >> 2) << shift;
+    }
+    return result;
+}
+
+} // namespace
+
+ImagePyramid::ImagePyramid(const QImage &base)
+{
+    setBase(base);
+}
+
+void ImagePyramid::setBase(const QImage &base)
+{
+    m_levels.clear();
+    if (!base.isNull()) {
+        m_levels.append(base);
+    }
+}
+
+QImage ImagePyramid::level(int level)
+{
+    if (m_levels.isEmpty()) {
+        return QImage();
+    }
+
+    level = std::min(std::max(level, 0), maxLevel());
+    while (m_levels.size() <= level) {
+        m_levels.append(halve(m_levels.last()));
+    }
+    return m_levels[level];
+}
+
+int ImagePyramid::maxLevel() const
+{
+    if (m_levels.isEmpty()) {
+        return 0;
+    }
+
+    int width = m_levels.first().width();
+    int height = m_levels.first().height();
+    int level = 0;
+    while (std::max(width, height) > MIN_LEVEL_SIZE) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        ++level;
+    }
+    return level;
+}
+
+double ImagePyramid::levelScale(int level)
+{
+    return std::ldexp(1.0, -level);
+}
+
+int ImagePyramid::levelForScale(double scale)
+{
+    if (scale >= 1.0 || scale <= 0.0) {
+        return 0;
+    }
+    // 容差避免 0.25 这类恰为 2 的幂的比例因舍入落到下一层
+    return static_cast<int>(std::floor(-std::log2(scale) + 1e-9));
+}
+
+QImage ImagePyramid::halve(const QImage &image)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    const bool gray = image.format() == QImage::Format_Grayscale8;
+    const bool direct = gray || image.format() == QImage::Format_RGB32
+                        || image.format() == QImage::Format_ARGB32
+                        || image.format() == QImage::Format_ARGB32_Premultiplied;
+    const QImage source = direct ? image : image.convertToFormat(QImage::Format_ARGB32);
+
+    const int srcWidth = source.width();
+    const int srcHeight = source.height();
+    const int width = (srcWidth + 1) / 2;
+    const int height = (srcHeight + 1) / 2;
+    QImage result(width, height, source.format());
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(result);
+
+    TiledExecutor::forEachRowBand(height, TiledExecutor::bandRowsFor(height, 0), [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            const int top = 2 * y;
+            const int bottom = std::min(top + 1, srcHeight - 1);
+            if (gray) {
+                const uchar *a = source.constScanLine(top);
+                const uchar *b = source.constScanLine(bottom);
+                uchar *out = lines[y];
+                for (int x = 0; x < width; ++x) {
+                    const int left = 2 * x;
+                    const int right = std::min(left + 1, srcWidth - 1);
+                    out[x] = static_cast<uchar>((a[left] + a[right] + b[left] + b[right] + 2) >> 2);
+                }
+            } else {
+                const QRgb *a = reinterpret_cast<const QRgb *>(source.constScanLine(top));
+                const QRgb *b = reinterpret_cast<const QRgb *>(source.constScanLine(bottom));
+                QRgb *out = reinterpret_cast<QRgb *>(lines[y]);
+                for (int x = 0; x < width; ++x) {
+                    const int left = 2 * x;
+                    const int right = std::min(left + 1, srcWidth - 1);
+                    out[x] = average4(a[left], a[right], b[left], b[right]);
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,65 @@
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <QImage>
+#include <QVector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 按 2 的幂缩小的图像金字塔
+ *
+ * 第 0 层为原图，第 k 层的宽高为第 k-1 层的一半（向上取整），每个像素为上一层
+ * 2x2 块的平均值。各层在首次访问时生成并缓存。
+ */
+class ImagePyramid
+{
+public:
+    ImagePyramid() = default;
+    explicit ImagePyramid(const QImage &base);
+
+    /**
+     * @brief 替换原图并丢弃已生成的各层
+     */
+    void setBase(const QImage &base);
+
+    QImage base() const { return m_levels.isEmpty() ? QImage() : m_levels.first(); }
+
+    /**
+     * @brief 获取第 level 层，超出 maxLevel() 时返回最小一层
+     */
+    QImage level(int level);
+
+    /**
+     * @brief 最小一层的编号（该层宽高均不超过 MIN_LEVEL_SIZE）
+     */
+    int maxLevel() const;
+
+    /**
+     * @brief 第 level 层相对原图的缩放比例 2^-level
+     */
+    static double levelScale(int level);
+
+    /**
+     * @brief 显示比例 scale 对应的层：分辨率不低于 scale 的最小一层
+     */
+    static int levelForScale(double scale);
+
+    /**
+     * @brief 宽高各缩小一半，奇数边的最后一行 / 列单独取平均
+     *
+     * 32 位 RGB 格式与 Grayscale8 保持原格式，其它格式先转换为 Format_ARGB32。
+     */
+    static QImage halve(const QImage &image);
+
+    static constexpr int MIN_LEVEL_SIZE = 32;
+
+private:
+    QVector<QImage> m_levels;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // IMAGEPYRAMID_H
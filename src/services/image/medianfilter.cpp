@@ -0,0 +1,271 @@
+/**
+ * @file medianfilter.cpp
+ * @brief 基于滑动列直方图的中值滤波实现
+ */
+
+#include "medianfilter.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <QSysInfo>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <vector>
+
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+#include <emmintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int BINS = 256;
+constexpr int COARSE_BINS = 16;
+constexpr int SEGMENT = BINS / COARSE_BINS;  // 每个粗桶包含的细桶数
+constexpr int STRIP_COLUMNS = 256;           // 条带宽度：细直方图约 128KB
+
+// 固定长度（16 的倍数）的直方图加减。x86-64 的 SSE2 和 ARM64 的 NEON 都是基础指令集，
+// 直接使用而不走运行时分派，以便内联到逐像素循环中
+template <int N>
+inline void addHistogram(quint16 *dst, const quint16 *src)
+{
+    static_assert(N % 16 == 0, "histogram length must be a multiple of 16");
+    for (int i = 0; i < N; i += 8) {
+#if defined(GPCV_SIMD_NEON)
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(dst + i), vld1q_u16(src + i)));
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+        __m128i *d = reinterpret_cast<__m128i *>(dst + i);
+        _mm_storeu_si128(d, _mm_add_epi16(_mm_loadu_si128(d),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+#else
+        for (int j = i; j < i + 8; ++j) {
+            dst[j] = static_cast<quint16>(dst[j] + src[j]);
+        }
+#endif
+    }
+}
+
+template <int N>
+inline void slideHistogram(quint16 *dst, const quint16 *entering, const quint16 *leaving)
+{
+    static_assert(N % 16 == 0, "histogram length must be a multiple of 16");
+    for (int i = 0; i < N; i += 8) {
+#if defined(GPCV_SIMD_NEON)
+        vst1q_u16(dst + i, vsubq_u16(vaddq_u16(vld1q_u16(dst + i), vld1q_u16(entering + i)),
+                                     vld1q_u16(leaving + i)));
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+        __m128i *d = reinterpret_cast<__m128i *>(dst + i);
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(entering + i));
+        const __m128i out = _mm_loadu_si128(reinterpret_cast<const __m128i *>(leaving + i));
+        _mm_storeu_si128(d, _mm_sub_epi16(_mm_add_epi16(_mm_loadu_si128(d), in), out));
+#else
+        for (int j = i; j < i + 8; ++j) {
+            dst[j] = static_cast<quint16>(dst[j] + entering[j] - leaving[j]);
+        }
+#endif
+    }
+}
+
+/**
+ * 单通道中值滤波：对 channels 个交错通道中的第 channel 个通道处理 [y0, y1) 行。
+ *
+ * 图像按列分为若干条带，每个条带只保存自身及左右 radius 列的列直方图，
+ * 使直方图常驻缓存。列直方图从 y0 上下各 radius 行的输入建立，各行带可独立处理。
+ */
+class ChannelMedian
+{
+public:
+    ChannelMedian(const QImage &source, const std::vector<uchar *> &result, int channels, int radius)
+        : m_source(source)
+        , m_result(result)
+        , m_channels(channels)
+        , m_width(source.width())
+        , m_height(source.height())
+        , m_radius(radius)
+        , m_window(2 * radius + 1)
+        , m_rank(m_window * m_window / 2)
+        , m_stripWidth(std::max(STRIP_COLUMNS, 4 * radius))
+    {
+        const int columns = std::min(m_stripWidth + 2 * radius, m_width);
+        m_fine.resize(static_cast<size_t>(columns) * BINS);
+        m_coarse.resize(static_cast<size_t>(columns) * COARSE_BINS);
+    }
+
+    void run(int channel, int y0, int y1)
+    {
+        for (int x0 = 0; x0 < m_width; x0 += m_stripWidth) {
+            const int x1 = std::min(x0 + m_stripWidth, m_width);
+            m_first = std::max(x0 - m_radius, 0);
+            m_last = std::min(x1 + m_radius, m_width) - 1;
+
+            initColumns(channel, y0);
+            for (int y = y0; y < y1; ++y) {
+                if (y > y0) {
+                    // 窗口下移一行：每列加入新进入的行，移除离开的行
+                    const uchar *entering = m_source.constScanLine(std::min(y + m_radius, m_height - 1)) + channel;
+                    const uchar *leaving = m_source.constScanLine(std::max(y - m_radius - 1, 0)) + channel;
+                    for (int x = m_first; x <= m_last; ++x) {
+                        addPixel(x, entering[x * m_channels], 1);
+                        addPixel(x, leaving[x * m_channels], -1);
+                    }
+                }
+                filterRow(m_result[y] + channel, x0, x1);
+            }
+        }
+    }
+
+private:
+    // 图像列号（可越界，按复制边界钳制）到条带内直方图下标
+    int columnIndex(int x) const { return std::min(std::max(x, 0), m_width - 1) - m_first; }
+
+    quint16 *fineColumn(int x) { return m_fine.data() + static_cast<size_t>(columnIndex(x)) * BINS; }
+    quint16 *coarseColumn(int x) { return m_coarse.data() + static_cast<size_t>(columnIndex(x)) * COARSE_BINS; }
+
+    void addPixel(int x, uchar value, int delta)
+    {
+        const size_t column = static_cast<size_t>(x - m_first);
+        m_fine[column * BINS + value] += delta;
+        m_coarse[column * COARSE_BINS + value / SEGMENT] += delta;
+    }
+
+    // 第 y 行的列直方图，越出上下边界的行按复制边界计入
+    void initColumns(int channel, int y)
+    {
+        std::fill(m_fine.begin(), m_fine.end(), 0);
+        std::fill(m_coarse.begin(), m_coarse.end(), 0);
+        for (int i = y - m_radius; i <= y + m_radius; ++i) {
+            const uchar *line = m_source.constScanLine(std::min(std::max(i, 0), m_height - 1)) + channel;
+            for (int x = m_first; x <= m_last; ++x) {
+                addPixel(x, line[x * m_channels], 1);
+            }
+        }
+    }
+
+    void filterRow(uchar *out, int x0, int x1)
+    {
+        std::array<quint16, COARSE_BINS> coarse{};
+        std::array<quint16, BINS> fine{};
+        std::array<int, COARSE_BINS> updatedAt;
+        updatedAt.fill(INT_MIN / 2);
+        int bucket = 0;
+
+        for (int i = x0 - m_radius; i <= x0 + m_radius; ++i) {
+            addHistogram<COARSE_BINS>(coarse.data(), coarseColumn(i));
+        }
+
+        for (int x = x0; x < x1; ++x) {
+            if (x > x0) {
+                slideHistogram<COARSE_BINS>(coarse.data(), coarseColumn(x + m_radius),
+                                            coarseColumn(x - m_radius - 1));
+            }
+
+            // 粗桶定位中值所在的段：相邻像素的中值通常相近，从上一个像素的桶开始上下移动
+            int count = 0;
+            for (int i = 0; i < bucket; ++i) {
+                count += coarse[i];
+            }
+            while (count > m_rank) {
+                --bucket;
+                count -= coarse[bucket];
+            }
+            while (count + coarse[bucket] <= m_rank) {
+                count += coarse[bucket];
+                ++bucket;
+            }
+
+            // 只补齐该段的细桶：落后太多时直接重算窗口内各列之和
+            const int offset = bucket * SEGMENT;
+            quint16 *segment = fine.data() + offset;
+            if (x - updatedAt[bucket] >= m_window) {
+                std::fill(segment, segment + SEGMENT, 0);
+                for (int i = x - m_radius; i <= x + m_radius; ++i) {
+                    addHistogram<SEGMENT>(segment, fineColumn(i) + offset);
+                }
+            } else {
+                for (int j = updatedAt[bucket] + 1; j <= x; ++j) {
+                    slideHistogram<SEGMENT>(segment, fineColumn(j + m_radius) + offset,
+                                            fineColumn(j - m_radius - 1) + offset);
+                }
+            }
+            updatedAt[bucket] = x;
+
+            int bin = 0;
+            while (count + segment[bin] <= m_rank) {
+                count += segment[bin];
+                ++bin;
+            }
+            out[x * m_channels] = static_cast<uchar>(offset + bin);
+        }
+    }
+
+    const QImage &m_source;
+    const std::vector<uchar *> &m_result;
+    int m_channels;
+    int m_width;
+    int m_height;
+    int m_radius;
+    int m_window;
+    int m_rank;
+    int m_stripWidth;
+    int m_first = 0;                // 当前条带直方图覆盖的第一列
+    int m_last = 0;                 // 当前条带直方图覆盖的最后一列
+    std::vector<quint16> m_fine;    // 每列 256 个细桶
+    std::vector<quint16> m_coarse;  // 每列 16 个粗桶
+};
+
+} // namespace
+
+QImage MedianFilter::apply(const QImage &image, int kernelSize)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    const int radius = std::min(kernelSize / 2, MAX_RADIUS);
+
+    int channels = 4;
+    QImage source;
+    switch (image.format()) {
+        case QImage::Format_Grayscale8:
+            channels = 1;
+            source = image;
+            break;
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            source = image;
+            break;
+        default:
+            source = image.convertToFormat(QImage::Format_ARGB32);
+            break;
+    }
+
+    if (radius <= 0) {
+        return source;
+    }
+
+    // 先整体复制，alpha 通道（QRgb 的最高字节）不参与滤波
+    QImage result = source.copy();
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(result);
+    const int alphaByte = QSysInfo::ByteOrder == QSysInfo::LittleEndian ? 3 : 0;
+
+    // 每个行带重新建立列直方图，行带不低于 4 * radius 行以摊薄建立的开销
+    const int bandRows = TiledExecutor::bandRowsFor(source.height(), radius);
+    TiledExecutor::forEachRowBand(source.height(), bandRows, [&](int y0, int y1) {
+        ChannelMedian median(source, lines, channels, radius);
+        for (int channel = 0; channel < channels; ++channel) {
+            if (channels == 1 || channel != alphaByte) {
+                median.run(channel, y0, y1);
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
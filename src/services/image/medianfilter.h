@@ -0,0 +1,36 @@
+#ifndef MEDIANFILTER_H
+#define MEDIANFILTER_H
+
+#include <QImage>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 常数时间中值滤波（Perreault–Hébert）
+ *
+ * 每列维护覆盖当前窗口高度的直方图，逐行下移时每列只加减一个像素；
+ * 窗口直方图沿行滑动时加上进入的列、减去离开的列。直方图分为 16 个粗桶和
+ * 256 个细桶两级，细桶只在中值落入对应粗桶时才补齐更新，
+ * 每像素代价与窗口大小无关，处理过程中不做逐像素的内存分配。
+ * 图像按行带在 TiledExecutor 上并行处理，每个行带从上下 radius 行的输入重新建立列直方图。
+ *
+ * 边界按复制边缘像素处理。支持 Format_Grayscale8 和 32 位 RGB 格式，
+ * 其它格式先转换为 Format_ARGB32；alpha 通道保持原值。
+ */
+class MedianFilter
+{
+public:
+    /**
+     * @brief 中值滤波
+     * @param kernelSize 窗口边长，偶数时加一，上限 2 * MAX_RADIUS + 1
+     */
+    static QImage apply(const QImage &image, int kernelSize);
+
+    static constexpr int MAX_RADIUS = 127;  // 窗口计数需放入 16 位
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // MEDIANFILTER_H
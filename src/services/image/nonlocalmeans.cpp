@@ -0,0 +1,321 @@
+/**
+ * @file nonlocalmeans.cpp
+ * @brief 基于块距离积分图的非局部均值去噪实现
+ */
+
+#include "nonlocalmeans.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+#include <emmintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+constexpr int BAND_ROWS = 32;
+constexpr int TILE_COLUMNS = 512;      // 行带再按列分块，使一个分块的积分图与累加缓冲常驻二级缓存
+constexpr float WEIGHT_CUTOFF = 8.0f;  // d / h² 超过该值的权重（< e^-8）视为零
+
+// exp(-t) 的多项式近似所用常数：2^-v 拆为整数部分（直接写入指数位）
+// 与小数部分（在 0.5 处展开的四次多项式，相对误差约 4e-5）
+constexpr float LOG2_E = 1.44269504f;
+constexpr float LN_2 = 0.693147181f;
+constexpr float SQRT_HALF = 0.707106781f;
+
+inline uchar toByte(float value)
+{
+    return static_cast<uchar>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+
+inline float negativeExp(float t)
+{
+    const float v = t * LOG2_E;
+    const int n = static_cast<int>(v);
+    const float g = (v - static_cast<float>(n) - 0.5f) * -LN_2;
+    const float p = SQRT_HALF * (1.0f + g * (1.0f + g * (0.5f + g * (1.0f / 6 + g * (1.0f / 24)))));
+    const qint32 bits = (127 - n) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// 一行像素在当前偏移下的权重累加
+struct RowAccumulator {
+    const quint32 *top;     // 块上边界所在的积分图行
+    const quint32 *bottom;  // 块下边界所在的积分图行
+    int patchSide;
+    const uchar *red;       // 平移后的邻域像素
+    const uchar *green;
+    const uchar *blue;
+    float *sumR;
+    float *sumG;
+    float *sumB;
+    float *weightSum;
+    float *weightMax;
+};
+
+inline void accumulatePixel(const RowAccumulator &row, int x, float distanceScale)
+{
+    const quint32 distance = row.bottom[x + row.patchSide] - row.bottom[x]
+                             - row.top[x + row.patchSide] + row.top[x];
+    const float t = static_cast<float>(distance) * distanceScale;
+    const float w = t < WEIGHT_CUTOFF ? negativeExp(t) : 0.0f;
+    row.sumR[x] += w * row.red[x];
+    row.sumG[x] += w * row.green[x];
+    row.sumB[x] += w * row.blue[x];
+    row.weightSum[x] += w;
+    row.weightMax[x] = std::max(row.weightMax[x], w);
+}
+
+// 逐像素查权重会阻止向量化；x86-64 的 SSE2 和 ARM64 的 NEON 都是基础指令集，直接使用
+void accumulateRow(const RowAccumulator &row, int count, float distanceScale)
+{
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    const float32x4_t scale = vdupq_n_f32(distanceScale);
+    const float32x4_t cutoff = vdupq_n_f32(WEIGHT_CUTOFF);
+    for (; x + 4 <= count; x += 4) {
+        const uint32x4_t distance = vaddq_u32(vsubq_u32(vld1q_u32(row.bottom + x + row.patchSide),
+                                                        vld1q_u32(row.bottom + x)),
+                                              vsubq_u32(vld1q_u32(row.top + x),
+                                                        vld1q_u32(row.top + x + row.patchSide)));
+        const float32x4_t t = vminq_f32(vmulq_f32(vcvtq_f32_u32(distance), scale), cutoff);
+        const float32x4_t v = vmulq_n_f32(t, LOG2_E);
+        const int32x4_t n = vcvtq_s32_f32(v);
+        const float32x4_t g = vmulq_n_f32(vsubq_f32(vsubq_f32(v, vcvtq_f32_s32(n)), vdupq_n_f32(0.5f)), -LN_2);
+        float32x4_t p = vmlaq_f32(vdupq_n_f32(1.0f / 6), g, vdupq_n_f32(1.0f / 24));
+        p = vmlaq_f32(vdupq_n_f32(0.5f), g, p);
+        p = vmlaq_f32(vdupq_n_f32(1.0f), g, p);
+        p = vmlaq_f32(vdupq_n_f32(1.0f), g, p);
+        const float32x4_t exponent = vreinterpretq_f32_s32(vshlq_n_s32(vsubq_s32(vdupq_n_s32(127), n), 23));
+        const uint32x4_t inside = vcltq_f32(t, cutoff);
+        const float32x4_t w = vreinterpretq_f32_u32(vandq_u32(
+            vreinterpretq_u32_f32(vmulq_f32(vmulq_n_f32(p, SQRT_HALF), exponent)), inside));
+
+        auto load = [x](const uchar *plane) {
+            quint32 packed;
+            std::memcpy(&packed, plane + x, sizeof(packed));
+            const uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(packed)));
+            return vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+        };
+        vst1q_f32(row.sumR + x, vmlaq_f32(vld1q_f32(row.sumR + x), w, load(row.red)));
+        vst1q_f32(row.sumG + x, vmlaq_f32(vld1q_f32(row.sumG + x), w, load(row.green)));
+        vst1q_f32(row.sumB + x, vmlaq_f32(vld1q_f32(row.sumB + x), w, load(row.blue)));
+        vst1q_f32(row.weightSum + x, vaddq_f32(vld1q_f32(row.weightSum + x), w));
+        vst1q_f32(row.weightMax + x, vmaxq_f32(vld1q_f32(row.weightMax + x), w));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128 scale = _mm_set1_ps(distanceScale);
+    const __m128 cutoff = _mm_set1_ps(WEIGHT_CUTOFF);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= count; x += 4) {
+        auto load = [x](const quint32 *line) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(line + x));
+        };
+        const __m128i distance = _mm_add_epi32(_mm_sub_epi32(load(row.bottom + row.patchSide), load(row.bottom)),
+                                               _mm_sub_epi32(load(row.top), load(row.top + row.patchSide)));
+        // 块内平方差之和小于 2^31，可按有符号数转换
+        const __m128 t = _mm_min_ps(_mm_mul_ps(_mm_cvtepi32_ps(distance), scale), cutoff);
+        const __m128 v = _mm_mul_ps(t, _mm_set1_ps(LOG2_E));
+        const __m128i n = _mm_cvttps_epi32(v);
+        const __m128 g = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(v, _mm_cvtepi32_ps(n)), _mm_set1_ps(0.5f)),
+                                    _mm_set1_ps(-LN_2));
+        __m128 p = _mm_add_ps(_mm_set1_ps(1.0f / 6), _mm_mul_ps(g, _mm_set1_ps(1.0f / 24)));
+        p = _mm_add_ps(_mm_set1_ps(0.5f), _mm_mul_ps(g, p));
+        p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(g, p));
+        p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(g, p));
+        const __m128 exponent = _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(127), n), 23));
+        const __m128 w = _mm_and_ps(_mm_mul_ps(_mm_mul_ps(p, _mm_set1_ps(SQRT_HALF)), exponent),
+                                    _mm_cmplt_ps(t, cutoff));
+
+        auto pixels = [x, zero](const uchar *plane) {
+            qint32 packed;
+            std::memcpy(&packed, plane + x, sizeof(packed));
+            const __m128i bytes = _mm_cvtsi32_si128(packed);
+            return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+        };
+        auto accumulate = [x](float *sum, __m128 value) {
+            _mm_storeu_ps(sum + x, _mm_add_ps(_mm_loadu_ps(sum + x), value));
+        };
+        accumulate(row.sumR, _mm_mul_ps(w, pixels(row.red)));
+        accumulate(row.sumG, _mm_mul_ps(w, pixels(row.green)));
+        accumulate(row.sumB, _mm_mul_ps(w, pixels(row.blue)));
+        accumulate(row.weightSum, w);
+        _mm_storeu_ps(row.weightMax + x, _mm_max_ps(_mm_loadu_ps(row.weightMax + x), w));
+    }
+#endif
+    for (; x < count; ++x) {
+        accumulatePixel(row, x, distanceScale);
+    }
+}
+
+class BandDenoiser
+{
+public:
+    BandDenoiser(const QImage &source, const std::vector<QRgb *> &result,
+                 double h, int patchRadius, int searchRadius)
+        : m_source(source)
+        , m_result(result)
+        , m_width(source.width())
+        , m_height(source.height())
+        , m_patchRadius(patchRadius)
+        , m_searchRadius(searchRadius)
+        , m_margin(patchRadius + searchRadius)
+    {
+        // 块内平方差之和换算为 d / h²，其中 d = sum / (3 * 块像素数)
+        const int patchSide = 2 * patchRadius + 1;
+        m_distanceScale = static_cast<float>(1.0 / (3.0 * patchSide * patchSide * h * h));
+    }
+
+    void run(int y0, int y1)
+    {
+        for (int x0 = 0; x0 < m_width; x0 += TILE_COLUMNS) {
+            runTile(x0, std::min(x0 + TILE_COLUMNS, m_width), y0, y1);
+        }
+    }
+
+private:
+    void runTile(int x0, int x1, int y0, int y1)
+    {
+        const int columns = x1 - x0;
+        const int rows = y1 - y0;
+        const int paddedWidth = columns + 2 * m_margin;
+        const int paddedHeight = rows + 2 * m_margin;
+
+        // 分块及其四周 margin 的通道平面，边界复制，之后的访问无需钳制
+        std::vector<uchar> planes[3];
+        for (auto &plane : planes) {
+            plane.resize(static_cast<size_t>(paddedWidth) * paddedHeight);
+        }
+        for (int i = 0; i < paddedHeight; ++i) {
+            const int sy = std::min(std::max(y0 - m_margin + i, 0), m_height - 1);
+            const QRgb *line = reinterpret_cast<const QRgb *>(m_source.constScanLine(sy));
+            const size_t offset = static_cast<size_t>(i) * paddedWidth;
+            for (int j = 0; j < paddedWidth; ++j) {
+                const QRgb pixel = line[std::min(std::max(x0 + j - m_margin, 0), m_width - 1)];
+                planes[0][offset + j] = static_cast<uchar>(qRed(pixel));
+                planes[1][offset + j] = static_cast<uchar>(qGreen(pixel));
+                planes[2][offset + j] = static_cast<uchar>(qBlue(pixel));
+            }
+        }
+
+        // 平方差图覆盖输出区域四周各 patchRadius 个像素
+        const int patchSide = 2 * m_patchRadius + 1;
+        const int diffWidth = columns + 2 * m_patchRadius;
+        const int diffHeight = rows + 2 * m_patchRadius;
+        const size_t integralStride = static_cast<size_t>(diffWidth) + 1;
+        std::vector<quint32> integral(integralStride * (diffHeight + 1), 0);
+
+        const size_t pixels = static_cast<size_t>(columns) * rows;
+        std::vector<float> sumR(pixels, 0.0f);
+        std::vector<float> sumG(pixels, 0.0f);
+        std::vector<float> sumB(pixels, 0.0f);
+        std::vector<float> weightSum(pixels, 0.0f);
+        std::vector<float> weightMax(pixels, 0.0f);
+
+        for (int dy = -m_searchRadius; dy <= m_searchRadius; ++dy) {
+            for (int dx = -m_searchRadius; dx <= m_searchRadius; ++dx) {
+                if (dx == 0 && dy == 0) {
+                    continue;
+                }
+
+                // 平移 (dx, dy) 后的逐像素平方差及其积分图（模 2^32）
+                for (int i = 0; i < diffHeight; ++i) {
+                    const ptrdiff_t a = static_cast<ptrdiff_t>(i + m_searchRadius) * paddedWidth + m_searchRadius;
+                    const ptrdiff_t b = a + static_cast<ptrdiff_t>(dy) * paddedWidth + dx;
+                    const quint32 *above = integral.data() + i * integralStride + 1;
+                    quint32 *current = integral.data() + (i + 1) * integralStride + 1;
+                    quint32 rowSum = 0;
+                    for (int j = 0; j < diffWidth; ++j) {
+                        const int d0 = planes[0][a + j] - planes[0][b + j];
+                        const int d1 = planes[1][a + j] - planes[1][b + j];
+                        const int d2 = planes[2][a + j] - planes[2][b + j];
+                        rowSum += static_cast<quint32>(d0 * d0 + d1 * d1 + d2 * d2);
+                        current[j] = above[j] + rowSum;
+                    }
+                }
+
+                for (int y = 0; y < rows; ++y) {
+                    const quint32 *top = integral.data() + y * integralStride;
+                    const size_t neighbor = static_cast<size_t>(y + m_margin + dy) * paddedWidth + m_margin + dx;
+                    const size_t out = static_cast<size_t>(y) * columns;
+                    const RowAccumulator row = {
+                        top, top + patchSide * integralStride, patchSide,
+                        planes[0].data() + neighbor, planes[1].data() + neighbor, planes[2].data() + neighbor,
+                        sumR.data() + out, sumG.data() + out, sumB.data() + out,
+                        weightSum.data() + out, weightMax.data() + out
+                    };
+                    accumulateRow(row, columns, m_distanceScale);
+                }
+            }
+        }
+
+        for (int y = 0; y < rows; ++y) {
+            const QRgb *line = reinterpret_cast<const QRgb *>(m_source.constScanLine(y0 + y)) + x0;
+            QRgb *out = m_result[y0 + y] + x0;
+            const size_t base = static_cast<size_t>(y) * columns;
+            for (int x = 0; x < columns; ++x) {
+                const size_t i = base + x;
+                const float self = weightMax[i];
+                if (self <= 0.0f) {
+                    // 没有相似块，保持原值
+                    out[x] = line[x];
+                    continue;
+                }
+                const float scale = 1.0f / (weightSum[i] + self);
+                out[x] = qRgba(toByte((sumR[i] + self * qRed(line[x])) * scale),
+                               toByte((sumG[i] + self * qGreen(line[x])) * scale),
+                               toByte((sumB[i] + self * qBlue(line[x])) * scale),
+                               qAlpha(line[x]));
+            }
+        }
+    }
+
+    const QImage &m_source;
+    const std::vector<QRgb *> &m_result;
+    int m_width;
+    int m_height;
+    int m_patchRadius;
+    int m_searchRadius;
+    int m_margin;
+    float m_distanceScale = 0.0f;
+};
+
+} // namespace
+
+QImage NonLocalMeans::apply(const QImage &image, double h, int patchRadius, int searchRadius)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    QImage source = image;
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32) {
+        source = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    patchRadius = std::min(std::max(patchRadius, 0), MAX_PATCH_RADIUS);
+    if (h <= 0 || searchRadius <= 0) {
+        return source;
+    }
+
+    QImage result(source.size(), source.format());
+    const std::vector<QRgb *> rows = TiledExecutor::writableRows(result);
+    BandDenoiser denoiser(source, rows, h, patchRadius, searchRadius);
+    TiledExecutor::forEachRowBand(source.height(), BAND_ROWS,
+                                  [&denoiser](int y0, int y1) { denoiser.run(y0, y1); });
+
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
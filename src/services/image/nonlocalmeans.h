@@ -0,0 +1,43 @@
+#ifndef NONLOCALMEANS_H
+#define NONLOCALMEANS_H
+
+#include <QImage>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 快速非局部均值去噪
+ *
+ * 按搜索窗口内的偏移逐个处理：对每个偏移先求整幅图与平移图的逐像素平方差，
+ * 再建立其积分图，任意像素的块距离只需四次查表，每像素代价与块大小无关。
+ * 积分图按 32 位无符号数回绕累加，块内真实和不超过 2^32 时差分结果仍然精确。
+ *
+ * 图像按行带划分，每个行带独立建立积分图并在线程池上并行处理。
+ * 块距离取 RGB 三通道平方差的均值，权重 exp(-d / h²) 用多项式近似并以 SSE2/NEON
+ * 每次计算 4 个像素；像素自身的权重取其它候选块中的最大权重。
+ * 边界按复制边缘像素处理；输出为 Format_ARGB32（输入为 Format_RGB32 时保持该格式），
+ * alpha 通道保持原值。
+ */
+class NonLocalMeans
+{
+public:
+    /**
+     * @brief 非局部均值去噪
+     * @param h 滤波强度（灰度级），越大越平滑，不大于零时返回原图
+     * @param patchRadius 比较块半径，块边长为 2 * patchRadius + 1
+     * @param searchRadius 搜索窗口半径
+     */
+    static QImage apply(const QImage &image, double h,
+                        int patchRadius = DEFAULT_PATCH_RADIUS,
+                        int searchRadius = DEFAULT_SEARCH_RADIUS);
+
+    static constexpr int DEFAULT_PATCH_RADIUS = 1;
+    static constexpr int DEFAULT_SEARCH_RADIUS = 5;
+    static constexpr int MAX_PATCH_RADIUS = 7;  // 块内平方差之和需小于 2^31
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // NONLOCALMEANS_H
@@ -0,0 +1,395 @@
+/**
+ * @file pointoperations.cpp
+ * @brief 按整行处理的点运算实现
+ */
+
+#include "pointoperations.h"
+#include "simdsupport.h"
+#include "tiledexecutor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(GPCV_SIMD_NEON)
+#include <arm_neon.h>
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+#include <emmintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+// qGray 的定点权重：(11·r + 16·g + 5·b) >> 5
+constexpr int WEIGHT_R = 11;
+constexpr int WEIGHT_G = 16;
+constexpr int WEIGHT_B = 5;
+constexpr int WEIGHT_SHIFT = 5;
+
+constexpr quint32 RGB_MASK = 0x00ffffffu;
+
+inline bool isDirect32(QImage::Format format)
+{
+    return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32;
+}
+
+// 32 位处理格式：RGB32 / ARGB32 原样使用，其余格式按是否含 alpha 转换
+QImage to32(const QImage &image)
+{
+    if (isDirect32(image.format())) {
+        return image;
+    }
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32
+                                                         : QImage::Format_RGB32);
+}
+
+inline uchar grayOf(QRgb pixel)
+{
+    return static_cast<uchar>((qRed(pixel) * WEIGHT_R + qGreen(pixel) * WEIGHT_G
+                               + qBlue(pixel) * WEIGHT_B) >> WEIGHT_SHIFT);
+}
+
+#if defined(GPCV_SIMD_NEON)
+// 16 个解交织的 BGRA 像素的灰度
+inline uint8x16_t gray16(const uint8x16x4_t &bgra)
+{
+    uint16x8_t lo = vmull_u8(vget_low_u8(bgra.val[0]), vdup_n_u8(WEIGHT_B));
+    lo = vmlal_u8(lo, vget_low_u8(bgra.val[1]), vdup_n_u8(WEIGHT_G));
+    lo = vmlal_u8(lo, vget_low_u8(bgra.val[2]), vdup_n_u8(WEIGHT_R));
+    uint16x8_t hi = vmull_u8(vget_high_u8(bgra.val[0]), vdup_n_u8(WEIGHT_B));
+    hi = vmlal_u8(hi, vget_high_u8(bgra.val[1]), vdup_n_u8(WEIGHT_G));
+    hi = vmlal_u8(hi, vget_high_u8(bgra.val[2]), vdup_n_u8(WEIGHT_R));
+    return vcombine_u8(vshrn_n_u16(lo, WEIGHT_SHIFT), vshrn_n_u16(hi, WEIGHT_SHIFT));
+}
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+// 4 个像素的灰度，每个 32 位通道一个
+inline __m128i gray4(__m128i pixels)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    // 通道值的高 16 位为 0，16 位乘法的结果不超过 255 × 11
+    __m128i sum = _mm_mullo_epi16(_mm_and_si128(pixels, byteMask), _mm_set1_epi32(WEIGHT_B));
+    sum = _mm_add_epi32(sum, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask), 4));
+    sum = _mm_add_epi32(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask),
+                                             _mm_set1_epi32(WEIGHT_R)));
+    return _mm_srli_epi32(sum, WEIGHT_SHIFT);
+}
+#endif
+
+/**
+ * 对 target 的每一行调用 rowFunction(源行, 目标行)。
+ *
+ * 目标行指针在调用线程上一次取好（可能触发 detach），source 与 target
+ * 为同一图像时即为原地处理。
+ */
+template <typename RowFunction>
+void forEachLine(const QImage &source, QImage &target, RowFunction rowFunction)
+{
+    const std::vector<uchar *> lines = TiledExecutor::writableLines(target);
+    const int height = target.height();
+    TiledExecutor::forEachRowBand(height, TiledExecutor::bandRowsFor(height, 0), [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            rowFunction(source.constScanLine(y), lines[y]);
+        }
+    });
+}
+
+// 三个颜色通道写入同一灰度，alpha 保持不变
+void grayscaleRgbRow(const QRgb *src, QRgb *dst, int width)
+{
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    for (; x + 16 <= width; x += 16) {
+        const uint8x16x4_t bgra = vld4q_u8(reinterpret_cast<const uint8_t *>(src + x));
+        const uint8x16_t gray = gray16(bgra);
+        uint8x16x4_t out;
+        out.val[0] = gray;
+        out.val[1] = gray;
+        out.val[2] = gray;
+        out.val[3] = bgra.val[3];
+        vst4q_u8(reinterpret_cast<uint8_t *>(dst + x), out);
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+    for (; x + 4 <= width; x += 4) {
+        const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        const __m128i gray = gray4(p);
+        const __m128i rgb = _mm_or_si128(_mm_or_si128(gray, _mm_slli_epi32(gray, 8)), _mm_slli_epi32(gray, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_or_si128(_mm_and_si128(p, alphaMask), rgb));
+    }
+#endif
+    for (; x < width; ++x) {
+        const QRgb gray = grayOf(src[x]);
+        dst[x] = (src[x] & 0xff000000u) | (gray << 16) | (gray << 8) | gray;
+    }
+}
+
+// 按 4 字节循环的掩码异或，32 位图像以 RGB_MASK 反转颜色通道
+void xorRow(const uchar *src, uchar *dst, int bytes, quint32 pattern)
+{
+    int i = 0;
+#if defined(GPCV_SIMD_NEON)
+    const uint8x16_t mask = vreinterpretq_u8_u32(vdupq_n_u32(pattern));
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(src + i), mask));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(pattern));
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_xor_si128(value, mask));
+    }
+#endif
+    for (; i < bytes; ++i) {
+        dst[i] = src[i] ^ static_cast<uchar>(pattern >> (8 * (i & 3)));
+    }
+}
+
+void toneCurveRow32(const QRgb *src, QRgb *dst, int width, const uchar *curve)
+{
+    // 没有字节查表指令可用，逐像素查表；256 字节的表常驻 L1
+    for (int x = 0; x < width; ++x) {
+        const QRgb p = src[x];
+        dst[x] = (p & 0xff000000u) | (static_cast<QRgb>(curve[qRed(p)]) << 16)
+                 | (static_cast<QRgb>(curve[qGreen(p)]) << 8) | curve[qBlue(p)];
+    }
+}
+
+void toneCurveRow8(const uchar *src, uchar *dst, int width, const uchar *curve)
+{
+    for (int x = 0; x < width; ++x) {
+        dst[x] = curve[src[x]];
+    }
+}
+
+} // namespace
+
+void PointOperations::grayscaleRow(const QRgb *src, uchar *dst, int width)
+{
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    for (; x + 16 <= width; x += 16) {
+        vst1q_u8(dst + x, gray16(vld4q_u8(reinterpret_cast<const uint8_t *>(src + x))));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    auto quad = [](const QRgb *pixels) {
+        return gray4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels)));
+    };
+    for (; x + 16 <= width; x += 16) {
+        const __m128i lo = _mm_packs_epi32(quad(src + x), quad(src + x + 4));
+        const __m128i hi = _mm_packs_epi32(quad(src + x + 8), quad(src + x + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; ++x) {
+        dst[x] = grayOf(src[x]);
+    }
+}
+
+void PointOperations::thresholdRow(const uchar *src, uchar *dst, int width, int threshold)
+{
+    if (threshold <= 0 || threshold > 255) {
+        std::memset(dst, threshold <= 0 ? 255 : 0, static_cast<size_t>(width));
+        return;
+    }
+
+    int x = 0;
+#if defined(GPCV_SIMD_NEON)
+    const uint8x16_t level = vdupq_n_u8(static_cast<uint8_t>(threshold));
+    for (; x + 16 <= width; x += 16) {
+        vst1q_u8(dst + x, vcgeq_u8(vld1q_u8(src + x), level));
+    }
+#elif defined(GPCV_SIMD_SSE2_BASELINE)
+    // SSE2 没有无符号字节比较：max(v, t) == v 即 v >= t
+    const __m128i level = _mm_set1_epi8(static_cast<char>(threshold));
+    for (; x + 16 <= width; x += 16) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x),
+                         _mm_cmpeq_epi8(_mm_max_epu8(value, level), value));
+    }
+#endif
+    for (; x < width; ++x) {
+        dst[x] = src[x] >= threshold ? 255 : 0;
+    }
+}
+
+QImage PointOperations::toGray8(const QImage &image)
+{
+    if (image.isNull() || image.format() == QImage::Format_Grayscale8) {
+        return image;
+    }
+
+    const QImage source = to32(image);
+    QImage result(source.size(), QImage::Format_Grayscale8);
+    const int width = source.width();
+    forEachLine(source, result, [width](const uchar *src, uchar *dst) {
+        grayscaleRow(reinterpret_cast<const QRgb *>(src), dst, width);
+    });
+    return result;
+}
+
+QImage PointOperations::grayscale(const QImage &image)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    const QImage source = to32(image);
+    QImage result(source.size(), source.format());
+    const int width = source.width();
+    forEachLine(source, result, [width](const uchar *src, uchar *dst) {
+        grayscaleRgbRow(reinterpret_cast<const QRgb *>(src), reinterpret_cast<QRgb *>(dst), width);
+    });
+    return result;
+}
+
+void PointOperations::grayscaleInPlace(QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    if (!isDirect32(image.format())) {
+        image = to32(image);
+    }
+    const int width = image.width();
+    forEachLine(image, image, [width](const uchar *src, uchar *dst) {
+        grayscaleRgbRow(reinterpret_cast<const QRgb *>(src), reinterpret_cast<QRgb *>(dst), width);
+    });
+}
+
+QImage PointOperations::invert(const QImage &image)
+{
+    const QImage::Format format = image.format();
+    if (image.isNull() || !(isDirect32(format) || format == QImage::Format_Grayscale8)) {
+        QImage result = image;
+        result.invertPixels();
+        return result;
+    }
+
+    QImage result(image.size(), format);
+    const int bytes = format == QImage::Format_Grayscale8 ? image.width() : image.width() * 4;
+    const quint32 pattern = format == QImage::Format_Grayscale8 ? 0xffffffffu : RGB_MASK;
+    forEachLine(image, result, [bytes, pattern](const uchar *src, uchar *dst) {
+        xorRow(src, dst, bytes, pattern);
+    });
+    return result;
+}
+
+void PointOperations::invertInPlace(QImage &image)
+{
+    const QImage::Format format = image.format();
+    if (image.isNull() || !(isDirect32(format) || format == QImage::Format_Grayscale8)) {
+        image.invertPixels();
+        return;
+    }
+
+    const int bytes = format == QImage::Format_Grayscale8 ? image.width() : image.width() * 4;
+    const quint32 pattern = format == QImage::Format_Grayscale8 ? 0xffffffffu : RGB_MASK;
+    forEachLine(image, image, [bytes, pattern](const uchar *src, uchar *dst) {
+        xorRow(src, dst, bytes, pattern);
+    });
+}
+
+QImage PointOperations::threshold(const QImage &image, int threshold)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    QImage result(image.size(), QImage::Format_Grayscale8);
+    const int width = image.width();
+    if (image.format() == QImage::Format_Grayscale8) {
+        forEachLine(image, result, [width, threshold](const uchar *src, uchar *dst) {
+            thresholdRow(src, dst, width, threshold);
+        });
+        return result;
+    }
+
+    // 灰度化与比较在同一行上接连完成，不生成中间灰度图
+    const QImage source = to32(image);
+    forEachLine(source, result, [width, threshold](const uchar *src, uchar *dst) {
+        grayscaleRow(reinterpret_cast<const QRgb *>(src), dst, width);
+        thresholdRow(dst, dst, width, threshold);
+    });
+    return result;
+}
+
+void PointOperations::thresholdInPlace(QImage &image, int threshold)
+{
+    if (image.format() != QImage::Format_Grayscale8) {
+        // 像素大小改变，无法原地完成
+        image = PointOperations::threshold(image, threshold);
+        return;
+    }
+
+    const int width = image.width();
+    forEachLine(image, image, [width, threshold](const uchar *src, uchar *dst) {
+        thresholdRow(src, dst, width, threshold);
+    });
+}
+
+QImage PointOperations::applyToneCurve(const QImage &image, const ToneCurve &curve)
+{
+    if (image.isNull()) {
+        return image;
+    }
+
+    const int width = image.width();
+    if (image.format() == QImage::Format_Grayscale8) {
+        QImage result(image.size(), QImage::Format_Grayscale8);
+        forEachLine(image, result, [width, &curve](const uchar *src, uchar *dst) {
+            toneCurveRow8(src, dst, width, curve.data());
+        });
+        return result;
+    }
+
+    const QImage source = to32(image);
+    QImage result(source.size(), source.format());
+    forEachLine(source, result, [width, &curve](const uchar *src, uchar *dst) {
+        toneCurveRow32(reinterpret_cast<const QRgb *>(src), reinterpret_cast<QRgb *>(dst), width,
+                       curve.data());
+    });
+    return result;
+}
+
+void PointOperations::applyToneCurveInPlace(QImage &image, const ToneCurve &curve)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    const int width = image.width();
+    if (image.format() == QImage::Format_Grayscale8) {
+        forEachLine(image, image, [width, &curve](const uchar *src, uchar *dst) {
+            toneCurveRow8(src, dst, width, curve.data());
+        });
+        return;
+    }
+
+    if (!isDirect32(image.format())) {
+        image = to32(image);
+    }
+    forEachLine(image, image, [width, &curve](const uchar *src, uchar *dst) {
+        toneCurveRow32(reinterpret_cast<const QRgb *>(src), reinterpret_cast<QRgb *>(dst), width,
+                       curve.data());
+    });
+}
+
+PointOperations::ToneCurve PointOperations::levelsCurve(int black, int white, double gamma)
+{
+    black = std::min(std::max(black, 0), 254);
+    white = std::min(std::max(white, black + 1), 255);
+    const double exponent = gamma > 0 ? 1.0 / gamma : 1.0;
+
+    ToneCurve curve;
+    for (int v = 0; v < 256; ++v) {
+        const double t = std::min(std::max((v - black) / double(white - black), 0.0), 1.0);
+        curve[v] = static_cast<uchar>(std::lround(255.0 * std::pow(t, exponent)));
+    }
+    return curve;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,81 @@
+#ifndef POINTOPERATIONS_H
+#define POINTOPERATIONS_H
+
+#include <QImage>
+#include <array>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 逐像素点运算：灰度化、反色、二值化与查找表色调曲线
+ *
+ * 所有运算按整行处理，SIMD 实现（SSE2 / NEON）之外的尾部像素由标量代码完成。
+ * 灰度化使用与 qGray 相同的定点权重 (11·r + 16·g + 5·b) / 32，结果与逐像素
+ * 调用 qGray 完全一致。各行带在 TiledExecutor 上并行处理。
+ *
+ * 带 InPlace 后缀的版本直接改写传入图像：图像未被共享且格式已符合时不分配新内存，
+ * 适合处理流程中由调用方独占的中间图像。
+ */
+class PointOperations
+{
+public:
+    /**
+     * @brief 256 项通道映射表
+     */
+    using ToneCurve = std::array<uchar, 256>;
+
+    /**
+     * @brief 灰度化，结果为 Format_Grayscale8
+     */
+    static QImage toGray8(const QImage &image);
+
+    /**
+     * @brief 灰度化，结果保持 32 位格式（RGB32 或 ARGB32），三个通道写入相同灰度，alpha 保持不变
+     */
+    static QImage grayscale(const QImage &image);
+    static void grayscaleInPlace(QImage &image);
+
+    /**
+     * @brief 反色，alpha 保持不变
+     *
+     * RGB32 / ARGB32 / Grayscale8 以异或掩码按整行处理，其余格式交给 QImage::invertPixels。
+     */
+    static QImage invert(const QImage &image);
+    static void invertInPlace(QImage &image);
+
+    /**
+     * @brief 二值化，灰度不小于 threshold 的像素为 255，否则为 0，结果为 Format_Grayscale8
+     */
+    static QImage threshold(const QImage &image, int threshold);
+    static void thresholdInPlace(QImage &image, int threshold);
+
+    /**
+     * @brief 按查找表映射各颜色通道，alpha 保持不变
+     *
+     * Grayscale8 图像直接映射，其余格式按 RGB32 / ARGB32 处理。
+     */
+    static QImage applyToneCurve(const QImage &image, const ToneCurve &curve);
+    static void applyToneCurveInPlace(QImage &image, const ToneCurve &curve);
+
+    /**
+     * @brief 色阶曲线：[black, white] 线性拉伸到 [0, 255]，再做 gamma 校正
+     * @param gamma 大于 1 时提亮中间调
+     */
+    static ToneCurve levelsCurve(int black, int white, double gamma = 1.0);
+
+    /**
+     * @brief 单行灰度化（与 qGray 一致），dst 为 width 个字节
+     */
+    static void grayscaleRow(const QRgb *src, uchar *dst, int width);
+
+    /**
+     * @brief 单行二值化，src 与 dst 可以相同
+     */
+    static void thresholdRow(const uchar *src, uchar *dst, int width, int threshold);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // POINTOPERATIONS_H
@@ -0,0 +1,96 @@
+/**
+ * @file simdsupport.cpp
+ * @brief 运行时 SIMD 指令集检测
+ */
+
+#include "simdsupport.h"
+#include <atomic>
+
+#if defined(GPCV_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+static std::atomic<int> s_levelOverride(-1);
+
+static SimdLevel probeLevel()
+{
+#if defined(GPCV_SIMD_X86)
+#if defined(_MSC_VER)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX2 还需要操作系统保存 YMM 寄存器
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) {
+        return SimdLevel::AVX2;
+    }
+    if (sse2) {
+        return SimdLevel::SSE2;
+    }
+    return SimdLevel::Scalar;
+#elif defined(GPCV_SIMD_NEON)
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel SimdSupport::detectedLevel()
+{
+    static const SimdLevel level = probeLevel();
+    return level;
+}
+
+SimdLevel SimdSupport::activeLevel()
+{
+    const int forced = s_levelOverride.load(std::memory_order_relaxed);
+    return forced < 0 ? detectedLevel() : static_cast<SimdLevel>(forced);
+}
+
+void SimdSupport::setLevelOverride(SimdLevel level)
+{
+    const SimdLevel detected = detectedLevel();
+    bool supported = (level == SimdLevel::Scalar || level == detected);
+    if (detected == SimdLevel::AVX2 && level == SimdLevel::SSE2) {
+        supported = true;
+    }
+    s_levelOverride.store(static_cast<int>(supported ? level : detected), std::memory_order_relaxed);
+}
+
+void SimdSupport::clearLevelOverride()
+{
+    s_levelOverride.store(-1, std::memory_order_relaxed);
+}
+
+QString SimdSupport::levelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+    }
+    return QString();
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
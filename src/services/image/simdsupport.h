@@ -0,0 +1,81 @@
+#ifndef SIMDSUPPORT_H
+#define SIMDSUPPORT_H
+
+#include <QString>
+
+// 编译目标架构：x86 上按运行时检测选择 SSE2 / AVX2，ARM64 上 NEON 为基础指令集
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GPCV_SIMD_X86 1
+#endif
+
+// x86-64 上 SSE2 总是可用，可不经运行时分派直接内联使用
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GPCV_SIMD_SSE2_BASELINE 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__ARM_ARCH_ISA_A64))
+#define GPCV_SIMD_NEON 1
+#endif
+
+// GCC / Clang 需要为使用高级指令集的函数单独声明目标，MSVC 不需要
+#if defined(GPCV_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define GPCV_TARGET_SSE2 __attribute__((target("sse2")))
+#define GPCV_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GPCV_TARGET_SSE2
+#define GPCV_TARGET_AVX2
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief SIMD 指令集级别
+ */
+enum class SimdLevel {
+    Scalar,  // 纯 C++ 实现
+    SSE2,
+    AVX2,
+    NEON
+};
+
+/**
+ * @brief 运行时 SIMD 分派
+ *
+ * 图像处理内核在首次使用时按 activeLevel() 选择实现。
+ */
+class SimdSupport
+{
+public:
+    /**
+     * @brief 当前 CPU 支持的最高级别
+     */
+    static SimdLevel detectedLevel();
+
+    /**
+     * @brief 实际使用的级别（未设置覆盖时等于 detectedLevel）
+     */
+    static SimdLevel activeLevel();
+
+    /**
+     * @brief 限制使用的级别（用于对比测试和性能测量）
+     *
+     * 超出 CPU 支持范围的级别会被降为 detectedLevel()。
+     */
+    static void setLevelOverride(SimdLevel level);
+
+    /**
+     * @brief 取消级别覆盖
+     */
+    static void clearLevelOverride();
+
+    /**
+     * @brief 级别名称（用于日志）
+     */
+    static QString levelName(SimdLevel level);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // SIMDSUPPORT_H
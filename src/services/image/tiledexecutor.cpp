@@ -0,0 +1,168 @@
+/**
+ * @file tiledexecutor.cpp
+ * @brief 分块并行执行器实现
+ */
+
+#include "tiledexecutor.h"
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+std::atomic<int> s_threadCount{0};
+
+int resolvedThreadCount(int count)
+{
+    return count > 0 ? count : std::max(QThread::idealThreadCount(), 1);
+}
+
+// 调用线程也参与计算，池中只需 threadCount - 1 个线程
+QThreadPool *workerPool()
+{
+    static QThreadPool *pool = [] {
+        QThreadPool *created = new QThreadPool();
+        created->setMaxThreadCount(std::max(resolvedThreadCount(s_threadCount.load()) - 1, 1));
+        return created;
+    }();
+    return pool;
+}
+
+/**
+ * 一次 forEachIndex 调用共享的任务队列。
+ *
+ * 由 shared_ptr 持有：调用线程返回后才被调度到的池任务仍可安全地发现队列已空并退出。
+ */
+struct TaskQueue {
+    const std::function<void(int)> *task = nullptr;
+    int count = 0;
+    std::atomic<int> next{0};
+    QMutex mutex;
+    QWaitCondition idle;
+    int active = 0;
+
+    // 还有未领取的下标时登记为活动线程
+    bool enter()
+    {
+        QMutexLocker locker(&mutex);
+        if (next.load() >= count) {
+            return false;
+        }
+        ++active;
+        return true;
+    }
+
+    void leave()
+    {
+        QMutexLocker locker(&mutex);
+        if (--active == 0) {
+            idle.wakeAll();
+        }
+    }
+
+    void drain()
+    {
+        for (int index = next.fetch_add(1); index < count; index = next.fetch_add(1)) {
+            (*task)(index);
+        }
+    }
+};
+
+class TaskRunner : public QRunnable
+{
+public:
+    explicit TaskRunner(std::shared_ptr<TaskQueue> queue)
+        : m_queue(std::move(queue))
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override
+    {
+        if (m_queue->enter()) {
+            m_queue->drain();
+            m_queue->leave();
+        }
+    }
+
+private:
+    std::shared_ptr<TaskQueue> m_queue;
+};
+
+} // namespace
+
+int TiledExecutor::threadCount()
+{
+    return resolvedThreadCount(s_threadCount.load());
+}
+
+void TiledExecutor::setThreadCount(int count)
+{
+    s_threadCount.store(std::max(count, 0));
+    workerPool()->setMaxThreadCount(std::max(threadCount() - 1, 1));
+}
+
+void TiledExecutor::forEachIndex(int count, const std::function<void(int)> &task)
+{
+    const int helpers = std::min(threadCount(), count) - 1;
+    if (helpers <= 0) {
+        for (int index = 0; index < count; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    auto queue = std::make_shared<TaskQueue>();
+    queue->task = &task;
+    queue->count = count;
+
+    QThreadPool *pool = workerPool();
+    for (int i = 0; i < helpers; ++i) {
+        pool->start(new TaskRunner(queue));
+    }
+
+    if (queue->enter()) {
+        queue->drain();
+        queue->leave();
+    }
+
+    QMutexLocker locker(&queue->mutex);
+    while (queue->active > 0) {
+        queue->idle.wait(&queue->mutex);
+    }
+}
+
+int TiledExecutor::bandRowsFor(int height, int halo)
+{
+    const int bands = 4 * threadCount();
+    const int balanced = (height + bands - 1) / bands;
+    return std::max({balanced, MIN_BAND_ROWS, 4 * halo});
+}
+
+std::vector<QRgb *> TiledExecutor::writableRows(QImage &image)
+{
+    std::vector<QRgb *> rows(image.height());
+    for (int y = 0; y < image.height(); ++y) {
+        rows[y] = reinterpret_cast<QRgb *>(image.scanLine(y));
+    }
+    return rows;
+}
+
+std::vector<uchar *> TiledExecutor::writableLines(QImage &image)
+{
+    std::vector<uchar *> lines(image.height());
+    for (int y = 0; y < image.height(); ++y) {
+        lines[y] = image.scanLine(y);
+    }
+    return lines;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
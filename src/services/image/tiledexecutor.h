@@ -0,0 +1,82 @@
+#ifndef TILEDEXECUTOR_H
+#define TILEDEXECUTOR_H
+
+#include <QImage>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 图像处理的分块并行执行器
+ *
+ * 图像按行切分为行带，在专用的 QThreadPool 上并行处理，结果由各行带直接写入目标图像。
+ * 任务按下标动态领取：调用线程与池中线程从同一计数器取下一个行带，先做完的线程
+ * 自动多分担，行带耗时不均时也能保持负载均衡。调用线程自身参与计算且只等待
+ * 已领取到任务的线程，在池线程中嵌套调用也不会死锁。
+ *
+ * 邻域运算的行带需要读取上下 halo 行（通常为卷积核半径）的输入，由各行带自行按
+ * 复制边界读取；bandRowsFor() 按 halo 选择足够高的行带，使重叠带来的重复计算可以忽略。
+ */
+class TiledExecutor
+{
+public:
+    /**
+     * @brief 实际使用的线程数（含调用线程）
+     */
+    static int threadCount();
+
+    /**
+     * @brief 设置线程数，不大于 0 时使用 QThread::idealThreadCount()，为 1 时在调用线程上串行执行
+     */
+    static void setThreadCount(int count);
+
+    /**
+     * @brief 对 [0, count) 的每个下标调用一次 task，各下标之间不应写入相同的数据
+     */
+    static void forEachIndex(int count, const std::function<void(int)> &task);
+
+    /**
+     * @brief 把 [0, height) 切分为每段 bandRows 行的行带并行处理
+     *
+     * function 以 (起始行, 结束行) 调用。
+     */
+    template <typename Function>
+    static void forEachRowBand(int height, int bandRows, Function function)
+    {
+        bandRows = std::max(bandRows, 1);
+        const int bands = (height + bandRows - 1) / bandRows;
+        forEachIndex(bands, [&](int band) {
+            const int y0 = band * bandRows;
+            function(y0, std::min(y0 + bandRows, height));
+        });
+    }
+
+    /**
+     * @brief 按上下各需 halo 行重叠输入的邻域运算选择行带高度
+     *
+     * 行带数约为线程数的 4 倍以便均衡负载，高度不低于 MIN_BAND_ROWS 与 4 * halo。
+     */
+    static int bandRowsFor(int height, int halo);
+
+    /**
+     * @brief 32 位图像各行的可写指针
+     *
+     * 非 const 的 scanLine 会触发 detach，多线程写入前在调用线程一次取好。
+     */
+    static std::vector<QRgb *> writableRows(QImage &image);
+
+    /**
+     * @brief 任意格式图像各行的可写字节指针
+     */
+    static std::vector<uchar *> writableLines(QImage &image);
+
+    static constexpr int MIN_BAND_ROWS = 16;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // TILEDEXECUTOR_H
@@ -0,0 +1,315 @@
+/**
+ * @file tiledimage.cpp
+ * @brief 磁盘分块图像实现
+ */
+
+#include "tiledimage.h"
+#include "imagepyramid.h"
+#include "tiledexecutor.h"
+#include <QFile>
+#include <QImageReader>
+#include <QTemporaryFile>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+namespace {
+
+std::atomic<qint64> g_nextCacheKey{1};
+
+QImage::Format storageFormat(const QImage &image)
+{
+    return image.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32;
+}
+
+} // namespace
+
+TiledImage::TiledImage(const QSize &size, QImage::Format format)
+    : m_size(size)
+    , m_format(format == QImage::Format_ARGB32 ? QImage::Format_ARGB32 : QImage::Format_RGB32)
+    , m_columns((size.width() + TILE_SIZE - 1) / TILE_SIZE)
+    , m_rows((size.height() + TILE_SIZE - 1) / TILE_SIZE)
+    , m_cacheKey(g_nextCacheKey++)
+{
+    int width = size.width();
+    int height = size.height();
+    while (width > OVERVIEW_SIZE || height > OVERVIEW_SIZE) {
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+        ++m_overviewLevel;
+    }
+    m_overview = QImage(width, height, m_format);
+    m_overview.fill(0);
+}
+
+TiledImage::~TiledImage()
+{
+    QMutexLocker lock(&m_mutex);
+    for (const MappedTile &tile : m_mapped) {
+        m_file->unmap(tile.data);
+    }
+}
+
+std::shared_ptr<TiledImage> TiledImage::create(const QSize &size, QImage::Format format,
+                                               QString *errorMsg)
+{
+    if (size.isEmpty()) {
+        if (errorMsg) {
+            *errorMsg = "图像尺寸无效";
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<TiledImage> image(new TiledImage(size, format));
+    if (!image->open(errorMsg)) {
+        return nullptr;
+    }
+    return image;
+}
+
+std::shared_ptr<TiledImage> TiledImage::fromImage(const QImage &image, QString *errorMsg)
+{
+    if (image.isNull()) {
+        if (errorMsg) {
+            *errorMsg = "图像为空";
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<TiledImage> tiled = create(image.size(), storageFormat(image), errorMsg);
+    if (tiled) {
+        tiled->writeRegion(QPoint(0, 0), image);
+    }
+    return tiled;
+}
+
+std::shared_ptr<TiledImage> TiledImage::load(const QString &filePath, QString *errorMsg)
+{
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        if (errorMsg) {
+            *errorMsg = QString("无法读取图像: %1").arg(reader.errorString());
+        }
+        return nullptr;
+    }
+    return fromImage(image, errorMsg);
+}
+
+std::shared_ptr<TiledImage> TiledImage::halve(const TiledImage &source, QString *errorMsg)
+{
+    const QSize size((source.width() + 1) / 2, (source.height() + 1) / 2);
+    std::shared_ptr<TiledImage> result = create(size, source.format(), errorMsg);
+    if (!result) {
+        return result;
+    }
+
+    // 块边界是偶数，源图像 2x2 块缩小后恰为一个输出块，边缘块的奇数行列与整幅缩小的处理相同
+    const int columns = result->columns();
+    TiledExecutor::forEachIndex(columns * result->rows(), [&](int index) {
+        const int column = index % columns;
+        const int row = index / columns;
+        const QImage block = source.region(QRect(2 * column * TILE_SIZE, 2 * row * TILE_SIZE,
+                                                 2 * TILE_SIZE, 2 * TILE_SIZE));
+        result->writeRegion(QPoint(column * TILE_SIZE, row * TILE_SIZE), ImagePyramid::halve(block));
+    });
+    return result;
+}
+
+bool TiledImage::shouldTile(const QSize &size)
+{
+    return qint64(size.width()) * size.height() >= LARGE_IMAGE_PIXELS;
+}
+
+bool TiledImage::open(QString *errorMsg)
+{
+    // 每块占固定大小，块号即文件中的位置；文件按稀疏方式扩展，未写入的块不占磁盘
+    m_file = std::make_unique<QTemporaryFile>();
+    if (!m_file->open() || !m_file->resize(qint64(m_columns) * m_rows * tileBytes())) {
+        if (errorMsg) {
+            *errorMsg = QString("无法创建图像缓存文件: %1").arg(m_file->errorString());
+        }
+        m_file.reset();
+        return false;
+    }
+    return true;
+}
+
+QRect TiledImage::tileRect(int column, int row) const
+{
+    return QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE) & rect();
+}
+
+/**
+ * 映射第 index 块并更新其使用顺序；超过驻留上限时解除最久未使用的其他块的映射。
+ * 返回的指针在下一次 mapTile() 之前有效。
+ */
+uchar *TiledImage::mapTile(int index) const
+{
+    auto it = m_mapped.find(index);
+    if (it == m_mapped.end()) {
+        uchar *data = m_file->map(qint64(index) * tileBytes(), tileBytes());
+        if (!data) {
+            return nullptr;
+        }
+        it = m_mapped.insert(index, MappedTile{data, 0});
+    }
+    it->lastUse = ++m_useCounter;
+    uchar *data = it->data;
+
+    while (m_mapped.size() > m_residentLimit) {
+        auto oldest = m_mapped.end();
+        for (auto candidate = m_mapped.begin(); candidate != m_mapped.end(); ++candidate) {
+            if (candidate.key() != index
+                && (oldest == m_mapped.end() || candidate->lastUse < oldest->lastUse)) {
+                oldest = candidate;
+            }
+        }
+        if (oldest == m_mapped.end()) {
+            break;
+        }
+        m_file->unmap(oldest->data);
+        m_mapped.erase(oldest);
+    }
+    return data;
+}
+
+void TiledImage::writeRegion(const QPoint &topLeft, const QImage &image)
+{
+    const QRect target = QRect(topLeft, image.size()) & rect();
+    if (target.isEmpty()) {
+        return;
+    }
+    const QImage source = image.format() == m_format ? image : image.convertToFormat(m_format);
+
+    QMutexLocker lock(&m_mutex);
+    const int firstColumn = target.left() / TILE_SIZE;
+    const int lastColumn = target.right() / TILE_SIZE;
+    const int firstRow = target.top() / TILE_SIZE;
+    const int lastRow = target.bottom() / TILE_SIZE;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            uchar *data = mapTile(row * m_columns + column);
+            if (!data) {
+                continue;
+            }
+
+            const QRect bounds = tileRect(column, row);
+            const QRect part = bounds & target;
+            for (int y = part.top(); y <= part.bottom(); ++y) {
+                const uchar *src = source.constScanLine(y - topLeft.y()) + (part.left() - topLeft.x()) * 4;
+                uchar *dst = data + (y - bounds.top()) * TILE_SIZE * 4 + (part.left() - bounds.left()) * 4;
+                std::memcpy(dst, src, size_t(part.width()) * 4);
+            }
+
+            const QImage written(data, bounds.width(), bounds.height(), TILE_SIZE * 4, m_format);
+            updateOverview(column, row, written);
+        }
+    }
+    m_cacheKey = g_nextCacheKey++;
+}
+
+/**
+ * 把一块缩小后写入缩略图。块边界是 TILE_SIZE 的倍数，缩小不超过 TILE_SIZE 倍时
+ * 仍落在整像素上，因此逐块缩小的结果与整幅图像缩小一致（更大的比例下为近似）。
+ */
+void TiledImage::updateOverview(int column, int row, const QImage &tile)
+{
+    QImage reduced = tile;
+    for (int level = 0; level < m_overviewLevel; ++level) {
+        reduced = ImagePyramid::halve(reduced);
+    }
+
+    const int x0 = (column * TILE_SIZE) >> m_overviewLevel;
+    const int y0 = (row * TILE_SIZE) >> m_overviewLevel;
+    const int width = std::min(reduced.width(), m_overview.width() - x0);
+    const int height = std::min(reduced.height(), m_overview.height() - y0);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(m_overview.scanLine(y0 + y) + x0 * 4, reduced.constScanLine(y), size_t(width) * 4);
+    }
+}
+
+QImage TiledImage::tile(int column, int row) const
+{
+    return region(tileRect(column, row));
+}
+
+QImage TiledImage::region(const QRect &area) const
+{
+    const QRect target = area & rect();
+    if (target.isEmpty()) {
+        return QImage();
+    }
+
+    QImage result(target.size(), m_format);
+    if (result.isNull()) {
+        return result;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    for (int row = target.top() / TILE_SIZE; row <= target.bottom() / TILE_SIZE; ++row) {
+        for (int column = target.left() / TILE_SIZE; column <= target.right() / TILE_SIZE; ++column) {
+            const uchar *data = mapTile(row * m_columns + column);
+            if (!data) {
+                continue;
+            }
+
+            const QRect bounds = tileRect(column, row);
+            const QRect part = bounds & target;
+            for (int y = part.top(); y <= part.bottom(); ++y) {
+                const uchar *src = data + (y - bounds.top()) * TILE_SIZE * 4 + (part.left() - bounds.left()) * 4;
+                uchar *dst = result.scanLine(y - target.top()) + (part.left() - target.left()) * 4;
+                std::memcpy(dst, src, size_t(part.width()) * 4);
+            }
+        }
+    }
+    return result;
+}
+
+QImage TiledImage::toImage() const
+{
+    return region(rect());
+}
+
+QImage TiledImage::overview() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_overview;
+}
+
+double TiledImage::overviewScale() const
+{
+    return ImagePyramid::levelScale(m_overviewLevel);
+}
+
+void TiledImage::setResidentTileLimit(int tiles)
+{
+    QMutexLocker lock(&m_mutex);
+    m_residentLimit = std::max(tiles, 1);
+}
+
+int TiledImage::residentTileLimit() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_residentLimit;
+}
+
+int TiledImage::residentTiles() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_mapped.size();
+}
+
+qint64 TiledImage::cacheKey() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_cacheKey;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,169 @@
+#ifndef TILEDIMAGE_H
+#define TILEDIMAGE_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QRect>
+#include <QString>
+#include <memory>
+
+class QTemporaryFile;
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 按 TILE_SIZE x TILE_SIZE 分块、存放在磁盘缓存文件中的图像
+ *
+ * 解码后的像素按块顺序写入临时文件，每块占固定大小（边缘块补齐），读取时按需
+ * 内存映射单个块；映射的块按最近使用顺序最多保留 residentTileLimit() 个，其余
+ * 由系统换出。因此打开很大的图像时常驻内存只有可见区域附近的块和一幅不超过
+ * OVERVIEW_SIZE 的缩略图。
+ *
+ * 像素格式总是 Format_RGB32 或 Format_ARGB32。读写都是线程安全的。
+ */
+class TiledImage
+{
+public:
+    ~TiledImage();
+
+    TiledImage(const TiledImage &) = delete;
+    TiledImage &operator=(const TiledImage &) = delete;
+
+    /**
+     * @brief 创建指定尺寸的空白分块图像（像素未初始化）
+     * @param size 图像尺寸
+     * @param format 有透明通道时为 Format_ARGB32，否则为 Format_RGB32
+     * @param errorMsg 失败时的错误信息
+     */
+    static std::shared_ptr<TiledImage> create(const QSize &size, QImage::Format format,
+                                              QString *errorMsg = nullptr);
+
+    /**
+     * @brief 把内存中的图像写入分块缓存
+     */
+    static std::shared_ptr<TiledImage> fromImage(const QImage &image, QString *errorMsg = nullptr);
+
+    /**
+     * @brief 解码图像文件并写入分块缓存，解码出的整幅图像在写入后即释放
+     */
+    static std::shared_ptr<TiledImage> load(const QString &filePath, QString *errorMsg = nullptr);
+
+    /**
+     * @brief 宽高各缩小一半的分块图像，与 ImagePyramid::halve(source.toImage()) 一致
+     *
+     * 每个输出块由源图像对应的 2x2 块计算，多个块并行处理，不整幅读出源图像。
+     */
+    static std::shared_ptr<TiledImage> halve(const TiledImage &source, QString *errorMsg = nullptr);
+
+    /**
+     * @brief 该尺寸的图像是否应使用分块存储，而不是整幅放在内存中
+     */
+    static bool shouldTile(const QSize &size);
+
+    QSize size() const { return m_size; }
+    int width() const { return m_size.width(); }
+    int height() const { return m_size.height(); }
+    QRect rect() const { return QRect(QPoint(0, 0), m_size); }
+    QImage::Format format() const { return m_format; }
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+
+    /**
+     * @brief 第 (column, row) 块在图像中的范围（边缘块可能小于 TILE_SIZE）
+     */
+    QRect tileRect(int column, int row) const;
+
+    /**
+     * @brief 把 image 写到 topLeft 处，超出图像的部分被忽略
+     *
+     * 写入的块同时更新缩略图，cacheKey() 随之改变。
+     */
+    void writeRegion(const QPoint &topLeft, const QImage &image);
+
+    /**
+     * @brief 读取一块（拷贝）
+     */
+    QImage tile(int column, int row) const;
+
+    /**
+     * @brief 读取任意区域（拷贝），超出图像的部分被裁掉
+     */
+    QImage region(const QRect &rect) const;
+
+    /**
+     * @brief 读取整幅图像（只在确实需要全部像素时使用）
+     */
+    QImage toImage() const;
+
+    /**
+     * @brief 宽高均不超过 OVERVIEW_SIZE 的缩略图，按 2 的幂缩小
+     */
+    QImage overview() const;
+
+    /**
+     * @brief 缩略图相对原图的比例
+     */
+    double overviewScale() const;
+
+    /**
+     * @brief 缩略图对应的金字塔层号，overviewScale() == 2^-overviewLevel()
+     */
+    int overviewLevel() const { return m_overviewLevel; }
+
+    /**
+     * @brief 最多同时映射的块数
+     */
+    void setResidentTileLimit(int tiles);
+    int residentTileLimit() const;
+
+    /**
+     * @brief 当前映射在内存中的块数
+     */
+    int residentTiles() const;
+
+    /**
+     * @brief 内容标识，不同图像或写入后的同一图像取值不同
+     */
+    qint64 cacheKey() const;
+
+    static constexpr int TILE_SIZE = 256;
+    static constexpr int OVERVIEW_SIZE = 2048;
+    static constexpr int DEFAULT_RESIDENT_TILES = 256;  ///< 32 位像素时约 64 MB
+    static constexpr qint64 LARGE_IMAGE_PIXELS = qint64(64) * 1000 * 1000;
+
+private:
+    TiledImage(const QSize &size, QImage::Format format);
+
+    struct MappedTile {
+        uchar *data = nullptr;
+        quint64 lastUse = 0;
+    };
+
+    static qint64 tileBytes() { return qint64(TILE_SIZE) * TILE_SIZE * 4; }
+
+    bool open(QString *errorMsg);
+    uchar *mapTile(int index) const;   // 调用方持有 m_mutex
+    void updateOverview(int column, int row, const QImage &tile);
+
+    QSize m_size;
+    QImage::Format m_format;
+    int m_columns = 0;
+    int m_rows = 0;
+    int m_overviewLevel = 0;
+
+    mutable QMutex m_mutex;
+    std::unique_ptr<QTemporaryFile> m_file;
+    mutable QHash<int, MappedTile> m_mapped;
+    mutable quint64 m_useCounter = 0;
+    int m_residentLimit = DEFAULT_RESIDENT_TILES;
+    QImage m_overview;
+    qint64 m_cacheKey = 0;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // TILEDIMAGE_H
@@ -0,0 +1,254 @@
+/**
+ * @file detectionpostprocess.cpp
+ * @brief 检测结果后处理实现
+ */
+
+#include "detectionpostprocess.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+// 避免零面积框的 IoU 除以零
+static const float MIN_UNION_AREA = 1e-6f;
+
+void DetectionPostProcess::BoxArrays::assign(const QVector<Detection> &detections,
+                                             const QVector<int> &order, NmsMode mode)
+{
+    const size_t n = static_cast<size_t>(order.size());
+    x1.resize(n);
+    y1.resize(n);
+    x2.resize(n);
+    y2.resize(n);
+    area.resize(n);
+    score.resize(n);
+    classId.resize(n);
+    index.resize(n);
+
+    for (size_t k = 0; k < n; ++k) {
+        const Detection &det = detections[order[static_cast<int>(k)]];
+        x1[k] = static_cast<float>(det.x);
+        y1[k] = static_cast<float>(det.y);
+        x2[k] = static_cast<float>(det.x + det.width);
+        y2[k] = static_cast<float>(det.y + det.height);
+        area[k] = std::max(0.0f, x2[k] - x1[k]) * std::max(0.0f, y2[k] - y1[k]);
+        score[k] = det.confidence;
+        classId[k] = (mode == NmsMode::ClassAware) ? det.classId : 0;
+        index[k] = order[static_cast<int>(k)];
+    }
+}
+
+static void swapBoxes(DetectionPostProcess::BoxArrays &boxes, int a, int b)
+{
+    std::swap(boxes.x1[a], boxes.x1[b]);
+    std::swap(boxes.y1[a], boxes.y1[b]);
+    std::swap(boxes.x2[a], boxes.x2[b]);
+    std::swap(boxes.y2[a], boxes.y2[b]);
+    std::swap(boxes.area[a], boxes.area[b]);
+    std::swap(boxes.score[a], boxes.score[b]);
+    std::swap(boxes.classId[a], boxes.classId[b]);
+    std::swap(boxes.index[a], boxes.index[b]);
+}
+
+void DetectionPostProcess::iouRow(const BoxArrays &boxes, int i, int begin, int end, float *out)
+{
+    const float bx1 = boxes.x1[i], by1 = boxes.y1[i], bx2 = boxes.x2[i], by2 = boxes.y2[i];
+    const float barea = boxes.area[i];
+    const float *x1 = boxes.x1.data();
+    const float *y1 = boxes.y1.data();
+    const float *x2 = boxes.x2.data();
+    const float *y2 = boxes.y2.data();
+    const float *area = boxes.area.data();
+
+    for (int j = begin; j < end; ++j) {
+        const float w = std::max(0.0f, std::min(bx2, x2[j]) - std::max(bx1, x1[j]));
+        const float h = std::max(0.0f, std::min(by2, y2[j]) - std::max(by1, y1[j]));
+        const float inter = w * h;
+        out[j - begin] = inter / std::max(barea + area[j] - inter, MIN_UNION_AREA);
+    }
+}
+
+QVector<int> DetectionPostProcess::sortedByConfidence(const QVector<Detection> &detections,
+                                                      float confThreshold, int topK)
+{
+    QVector<int> order;
+    order.reserve(detections.size());
+    for (int i = 0; i < detections.size(); ++i) {
+        if (detections[i].confidence >= confThreshold) {
+            order.append(i);
+        }
+    }
+
+    // 同分按原下标排序，结果与输入顺序无关地确定
+    auto higher = [&detections](int a, int b) {
+        if (detections[a].confidence != detections[b].confidence) {
+            return detections[a].confidence > detections[b].confidence;
+        }
+        return a < b;
+    };
+
+    if (topK > 0 && topK < order.size()) {
+        std::partial_sort(order.begin(), order.begin() + topK, order.end(), higher);
+        order.resize(topK);
+    } else {
+        std::sort(order.begin(), order.end(), higher);
+    }
+    return order;
+}
+
+QVector<Detection> DetectionPostProcess::topK(const QVector<Detection> &detections, int k)
+{
+    QVector<Detection> result;
+    if (k <= 0) {
+        return result;
+    }
+
+    const QVector<int> order = sortedByConfidence(detections, -1.0f, k);
+    result.reserve(order.size());
+    for (int index : order) {
+        result.append(detections[index]);
+    }
+    return result;
+}
+
+QVector<int> DetectionPostProcess::nms(const QVector<Detection> &detections, const QVector<int> &order,
+                                       float iouThreshold, NmsMode mode)
+{
+    QVector<int> kept;
+    if (order.isEmpty()) {
+        return kept;
+    }
+
+    BoxArrays boxes;
+    boxes.assign(detections, order, mode);
+    const int n = boxes.size();
+    const float *x1 = boxes.x1.data();
+    const float *y1 = boxes.y1.data();
+    const float *x2 = boxes.x2.data();
+    const float *y2 = boxes.y2.data();
+    const float *area = boxes.area.data();
+    const int *cls = boxes.classId.data();
+
+    std::vector<unsigned char> suppressed(static_cast<size_t>(n), 0);
+    for (int i = 0; i < n; ++i) {
+        if (suppressed[i]) {
+            continue;
+        }
+        kept.append(order[i]);
+
+        const float bx1 = x1[i], by1 = y1[i], bx2 = x2[i], by2 = y2[i], barea = area[i];
+        const int bcls = cls[i];
+        // IoU > t 等价于 inter > t * union，避免除法
+        for (int j = i + 1; j < n; ++j) {
+            const float w = std::max(0.0f, std::min(bx2, x2[j]) - std::max(bx1, x1[j]));
+            const float h = std::max(0.0f, std::min(by2, y2[j]) - std::max(by1, y1[j]));
+            const float inter = w * h;
+            const float uni = barea + area[j] - inter;
+            suppressed[j] |= static_cast<unsigned char>((inter > iouThreshold * uni) & (cls[j] == bcls));
+        }
+    }
+
+    return kept;
+}
+
+QVector<Detection> DetectionPostProcess::nms(const QVector<Detection> &detections, float iouThreshold,
+                                             NmsMode mode, int maxDetections)
+{
+    QVector<int> kept = nms(detections, sortedByConfidence(detections), iouThreshold, mode);
+    if (maxDetections > 0 && kept.size() > maxDetections) {
+        kept.resize(maxDetections);
+    }
+
+    QVector<Detection> result;
+    result.reserve(kept.size());
+    for (int index : kept) {
+        result.append(detections[index]);
+    }
+    return result;
+}
+
+QVector<Detection> DetectionPostProcess::softNms(const QVector<Detection> &detections,
+                                                 float iouThreshold,
+                                                 float sigma,
+                                                 float scoreThreshold,
+                                                 SoftNmsMethod method,
+                                                 NmsMode mode,
+                                                 int maxDetections)
+{
+    QVector<Detection> result;
+
+    BoxArrays boxes;
+    boxes.assign(detections, sortedByConfidence(detections, scoreThreshold), mode);
+    int n = boxes.size();
+    if (n == 0) {
+        return result;
+    }
+
+    const float invSigma = 1.0f / std::max(sigma, MIN_UNION_AREA);
+    std::vector<float> iou(static_cast<size_t>(n));
+
+    // [0, pos) 为已确定的结果，[pos, n) 为剩余框；每轮取剩余框中分数最高者，
+    // 衰减其余框的分数并移除低于阈值的框（与末尾交换，保持数组连续）
+    for (int pos = 0; pos < n; ++pos) {
+        int best = pos;
+        for (int j = pos + 1; j < n; ++j) {
+            if (boxes.score[j] > boxes.score[best]) {
+                best = j;
+            }
+        }
+        swapBoxes(boxes, pos, best);
+
+        Detection det = detections[boxes.index[pos]];
+        det.confidence = boxes.score[pos];
+        result.append(std::move(det));
+        if (maxDetections > 0 && result.size() >= maxDetections) {
+            break;
+        }
+
+        iouRow(boxes, pos, pos + 1, n, iou.data());
+        const int bcls = boxes.classId[pos];
+        float *score = boxes.score.data();
+        const int *cls = boxes.classId.data();
+        for (int j = pos + 1; j < n; ++j) {
+            const float overlap = iou[j - pos - 1];
+            float weight;
+            if (method == SoftNmsMethod::Linear) {
+                weight = overlap > iouThreshold ? 1.0f - overlap : 1.0f;
+            } else {
+                weight = std::exp(-overlap * overlap * invSigma);
+            }
+            score[j] *= (cls[j] == bcls) ? weight : 1.0f;
+        }
+
+        for (int j = n - 1; j > pos; --j) {
+            if (boxes.score[j] < scoreThreshold) {
+                swapBoxes(boxes, j, n - 1);
+                --n;
+            }
+        }
+    }
+
+    return result;
+}
+
+QVector<Detection> DetectionPostProcess::filterCandidates(const QVector<Detection> &candidates,
+                                                          float confThreshold, float iouThreshold)
+{
+    const QVector<int> order = sortedByConfidence(candidates, confThreshold);
+
+    // 两轮 NMS 都保持置信度降序，第二轮可直接使用第一轮的结果
+    const QVector<int> perClass = nms(candidates, order, iouThreshold, NmsMode::ClassAware);
+    const QVector<int> kept = nms(candidates, perClass, iouThreshold, NmsMode::Agnostic);
+
+    QVector<Detection> result;
+    result.reserve(kept.size());
+    for (int index : kept) {
+        result.append(candidates[index]);
+    }
+    return result;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,117 @@
+#ifndef DETECTIONPOSTPROCESS_H
+#define DETECTIONPOSTPROCESS_H
+
+#include <QVector>
+#include <vector>
+#include "dlservice.h"
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 检测结果后处理（置信度过滤、NMS、soft-NMS、top-K）
+ *
+ * 框坐标按结构数组（x1/y1/x2/y2/面积各一个连续数组）存放，
+ * 一个框对其余框的 IoU 计算是无分支的循环，可被编译器向量化。
+ * 单图、批量推理结果和本地缓存的候选框都经由这里处理。
+ */
+class DetectionPostProcess
+{
+public:
+    /**
+     * @brief NMS 的抑制范围
+     */
+    enum class NmsMode {
+        ClassAware,  // 只抑制同类别的框
+        Agnostic     // 不区分类别
+    };
+
+    /**
+     * @brief soft-NMS 的分数衰减方式
+     */
+    enum class SoftNmsMethod {
+        Linear,   // IoU 超过阈值时乘以 (1 - IoU)
+        Gaussian  // 乘以 exp(-IoU² / sigma)
+    };
+
+    /**
+     * @brief 结构数组形式的框
+     */
+    struct BoxArrays {
+        std::vector<float> x1, y1, x2, y2, area, score;
+        std::vector<int> classId;
+        std::vector<int> index;  // 在原检测列表中的下标
+
+        /**
+         * @brief 按 order 顺序展开检测结果
+         * @param mode 为 Agnostic 时类别统一记为 0
+         */
+        void assign(const QVector<Detection> &detections, const QVector<int> &order, NmsMode mode);
+        int size() const { return static_cast<int>(index.size()); }
+    };
+
+    /**
+     * @brief 计算第 i 个框与 [begin, end) 内各框的 IoU，写入 out[0 .. end-begin)
+     */
+    static void iouRow(const BoxArrays &boxes, int i, int begin, int end, float *out);
+
+    /**
+     * @brief 置信度不低于阈值的下标，按置信度降序
+     * @param topK 大于 0 时只保留分数最高的 topK 个（部分排序）
+     */
+    static QVector<int> sortedByConfidence(const QVector<Detection> &detections,
+                                           float confThreshold = 0.0f, int topK = 0);
+
+    /**
+     * @brief 分数最高的 k 个检测，按置信度降序
+     */
+    static QVector<Detection> topK(const QVector<Detection> &detections, int k);
+
+    /**
+     * @brief 贪心 NMS（下标形式）
+     * @param order 参与 NMS 的下标，需按置信度降序排列
+     * @return 保留的下标（保持 order 中的顺序）
+     */
+    static QVector<int> nms(const QVector<Detection> &detections, const QVector<int> &order,
+                            float iouThreshold, NmsMode mode);
+
+    /**
+     * @brief 贪心 NMS
+     * @param maxDetections 大于 0 时最多保留的检测数
+     * @return 按置信度降序排列的保留结果
+     */
+    static QVector<Detection> nms(const QVector<Detection> &detections, float iouThreshold,
+                                  NmsMode mode = NmsMode::Agnostic, int maxDetections = 0);
+
+    /**
+     * @brief soft-NMS：重叠框衰减分数而不是直接删除
+     * @param iouThreshold Linear 方式的衰减阈值
+     * @param sigma Gaussian 方式的衰减宽度
+     * @param scoreThreshold 衰减后低于该分数的框被删除
+     * @param maxDetections 大于 0 时最多保留的检测数
+     * @return 按衰减后置信度降序排列的结果（confidence 为衰减后的分数）
+     */
+    static QVector<Detection> softNms(const QVector<Detection> &detections,
+                                      float iouThreshold,
+                                      float sigma = 0.5f,
+                                      float scoreThreshold = 0.001f,
+                                      SoftNmsMethod method = SoftNmsMethod::Gaussian,
+                                      NmsMode mode = NmsMode::ClassAware,
+                                      int maxDetections = 0);
+
+    /**
+     * @brief 对后端返回的原始候选框重新应用阈值
+     *
+     * 与后端流程一致：先过滤低于 confThreshold 的候选框，再按类别 NMS
+     * （模型内置），最后跨类别 NMS（dl_service.py 的保险措施）。
+     * @param candidates 候选框（DLService::detectCandidatesAsync 的结果）
+     * @return 按置信度降序排列的保留结果
+     */
+    static QVector<Detection> filterCandidates(const QVector<Detection> &candidates,
+                                               float confThreshold, float iouThreshold);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // DETECTIONPOSTPROCESS_H
@@ -13,6 +13,9 @@
 
 #include "dlservice.h"
 #include "fileutils.h"
+#include "sharedimagebuffer.h"
+#include "tiledimage.h"
+#include "detectionpostprocess.h"
 #include <QCoreApplication>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -27,6 +30,7 @@
 #include <QRegularExpression>
 #include <QTextStream>
 #include <QSet>
+#include <QThread>
 #include <QThreadPool>
 #include <QtConcurrent/QtConcurrent>
 #include <QFuture>
@@ -37,6 +41,21 @@ namespace Utils {
 // 默认的 conda 环境名称
 static const QString DEFAULT_CONDA_ENV = "GenPreCVSystem";
 
+// 单个请求写入管道后等待响应的超时时间
+static const int REQUEST_TIMEOUT_MS = 30000;
+
+// 加载模型的超时时间（大模型首次加载较慢）
+static const int MODEL_LOAD_TIMEOUT_MS = 120000;
+
+// 进程池：最大进程数、单个进程的最大重启次数和退出后的重启延迟
+static const int MAX_WORKER_COUNT = 32;
+static const int MAX_WORKER_RESTARTS = 5;
+static const int WORKER_RESTART_DELAY_MS = 1000;
+
+// 最近加载模型的记录条数，以及服务启动后预取其中的前几个
+static const int MAX_RECENT_MODELS = 8;
+static const int STARTUP_PREFETCH_COUNT = 2;
+
 // 缓存文件路径（向后兼容）
 static QString getCacheFilePath() {
     QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
@@ -92,10 +111,21 @@ static QVector<PythonEnvironment> loadEnvironmentCache() {
 
 DLService::DLService(QObject *parent)
     : QObject(parent)
-    , m_process(nullptr)
     , m_modelLoaded(false)
     , m_taskType("dl")  // 默认使用 DL 服务
+    , m_workerCount(1)
+    , m_stopping(false)
+    , m_nextRequestId(1)
+    , m_maxInFlight(4)
+    , m_serviceMaxInFlight(0)
+    , m_binaryFrames(false)
+    , m_streaming(true)
+    , m_resultCacheEnabled(true)
+    , m_resultCacheLimit(InferenceResultCache::DEFAULT_MAX_DISK_BYTES)
+    , m_timeoutTimer(new QTimer(this))
 {
+    m_timeoutTimer->setInterval(1000);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &DLService::checkRequestTimeouts);
 }
 
 DLService::~DLService()
@@ -424,7 +454,7 @@ bool DLService::checkEnvironmentCapability(PythonEnvironment &env)
 // 快速启动服务（使用缓存验证）
 bool DLService::fastStart()
 {
-    if (m_process && m_process->state() == QProcess::Running) {
+    if (isRunning()) {
         emit logMessage("服务已在运行中");
         return true;
     }
@@ -506,7 +536,7 @@ void DLService::setEnvironmentPath(const QString &path)
 QString DLService::getDefaultScriptPath() const
 {
     // 如果是 FSL 任务，返回 FSL 服务脚本
-    if (m_taskType == "fsl" || m_taskType == "few_shot" || m_taskType == "RemoteSceneFewShotClassification") {
+    if (isFSLTask()) {
         return getFSLScriptPath();
     }
 
@@ -555,6 +585,11 @@ QString DLService::getDefaultScriptPath() const
     return QDir::cleanPath(possiblePaths.first());
 }
 
+bool DLService::isFSLTask() const
+{
+    return m_taskType == "fsl" || m_taskType == "few_shot" || m_taskType == "RemoteSceneFewShotClassification";
+}
+
 QString DLService::getFSLScriptPath() const
 {
     // 查找 FSL 服务脚本路径
@@ -648,14 +683,11 @@ QString DLService::findCondaPython() const
 
 bool DLService::start(const QString &pythonPath, const QString &scriptPath)
 {
-    if (m_process && m_process->state() == QProcess::Running) {
+    if (isRunning()) {
         emit logMessage("服务已在运行中");
         return true;
     }
 
-    // 创建进程
-    m_process = new QProcess(this);
-
     // 确定 Python 路径 (优先级: 参数 > m_environmentPath > 配置文件/自动检测)
     QString python;
     if (!pythonPath.isEmpty()) {
@@ -676,386 +708,1549 @@ bool DLService::start(const QString &pythonPath, const QString &scriptPath)
 
     if (!QFile::exists(script)) {
         emit logMessage(QString("错误: 服务脚本不存在: %1").arg(script));
-        delete m_process;
-        m_process = nullptr;
         return false;
     }
 
-    // 设置进程通道模式 - 分离 stderr 和 stdout
-    m_process->setProcessChannelMode(QProcess::SeparateChannels);
-
-    QStringList args;
-    bool useCondaRun = false;
-
     if (python == "conda") {
         // 使用 conda run 方式运行
-        useCondaRun = true;
-        args << "run" << "-n" << DEFAULT_CONDA_ENV << "python" << script;
+        m_program = "conda";
+        m_arguments = QStringList() << "run" << "-n" << DEFAULT_CONDA_ENV << "python" << script;
         emit logMessage(QString("启动服务: conda run -n %1 python %2").arg(DEFAULT_CONDA_ENV, script));
-        m_process->start("conda", args);
     } else {
         // 直接使用 Python 路径
-        args << script;
+        m_program = python;
+        m_arguments = QStringList() << script;
         emit logMessage(QString("启动服务: %1 %2").arg(python, script));
-        m_process->start(python, args);
     }
 
-    // 等待进程启动
-    if (!m_process->waitForStarted(10000)) {
-        QString errorMsg = m_process->errorString();
-        emit logMessage("服务启动失败: " + errorMsg);
-
-        // 如果使用 conda 失败，尝试直接使用 python
-        if (useCondaRun) {
-            emit logMessage("尝试使用系统 Python...");
-            delete m_process;
-            m_process = new QProcess(this);
-            m_process->setProcessChannelMode(QProcess::SeparateChannels);
-            QStringList fallbackArgs;
-            fallbackArgs << script;
-            m_process->start("python", fallbackArgs);
-
-            if (!m_process->waitForStarted(5000)) {
-                emit logMessage("系统 Python 也启动失败: " + m_process->errorString());
-                delete m_process;
-                m_process = nullptr;
-                return false;
-            }
+    m_workers.clear();
+    m_stopping = false;
+    m_serviceMaxInFlight = 0;
+    m_binaryFrames = true;
+
+    // 先启动全部进程，各进程并行初始化，再逐个等待就绪
+    for (int i = 0; i < m_workerCount; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        if (!launchWorker(*worker)) {
+            break;
+        }
+        m_workers.push_back(std::move(worker));
+    }
+
+    for (auto it = m_workers.begin(); it != m_workers.end();) {
+        if (handshakeWorker(**it)) {
+            ++it;
         } else {
-            delete m_process;
-            m_process = nullptr;
-            return false;
+            shutdownWorker(**it);
+            it = m_workers.erase(it);
+        }
+    }
+
+    if (m_workers.empty()) {
+        m_binaryFrames = false;
+        return false;
+    }
+
+    if (static_cast<int>(m_workers.size()) < m_workerCount) {
+        emit logMessage(QString("仅 %1/%2 个后端进程启动成功")
+                        .arg(m_workers.size())
+                        .arg(m_workerCount));
+    }
+
+    emit logMessage(QString("服务启动成功 (进程数: %1, 每进程最大在途请求: %2, 检测结果格式: %3)")
+                    .arg(m_workers.size())
+                    .arg(maxInFlight())
+                    .arg(m_binaryFrames ? "二进制帧" : "JSON"));
+    emit serviceStateChanged(true);
+
+    // 预热最近使用的模型，首次 loadModel 即可命中后端缓存
+    const QStringList recent = recentModels();
+    for (int i = 0; i < recent.size() && i < STARTUP_PREFETCH_COUNT; ++i) {
+        prefetchModel(recent[i]);
+    }
+    return true;
+}
+
+bool DLService::launchWorker(Worker &worker)
+{
+    worker.process = new QProcess(this);
+    // 设置进程通道模式 - 分离 stderr 和 stdout
+    worker.process->setProcessChannelMode(QProcess::SeparateChannels);
+    worker.process->start(m_program, m_arguments);
+
+    // 等待进程启动
+    if (worker.process->waitForStarted(10000)) {
+        return true;
+    }
+
+    emit logMessage("服务启动失败: " + worker.process->errorString());
+    delete worker.process;
+    worker.process = nullptr;
+
+    // 如果使用 conda 失败，尝试直接使用 python（后续进程和重启沿用）
+    if (m_program == "conda") {
+        emit logMessage("尝试使用系统 Python...");
+        m_program = "python";
+        m_arguments = QStringList() << m_arguments.last();
+
+        worker.process = new QProcess(this);
+        worker.process->setProcessChannelMode(QProcess::SeparateChannels);
+        worker.process->start(m_program, m_arguments);
+        if (worker.process->waitForStarted(5000)) {
+            return true;
         }
+
+        emit logMessage("系统 Python 也启动失败: " + worker.process->errorString());
+        delete worker.process;
+        worker.process = nullptr;
     }
 
+    return false;
+}
+
+bool DLService::handshakeWorker(Worker &worker)
+{
     // 等待就绪信号
-    if (!m_process->waitForReadyRead(10000)) {
+    if (!worker.process->waitForReadyRead(10000)) {
         emit logMessage("服务未响应 (可能 ultralytics 未安装)");
-        stop();
         return false;
     }
 
     // 读取就绪响应
-    QString response = QString::fromUtf8(m_process->readLine()).trimmed();
+    QString response = QString::fromUtf8(worker.process->readLine()).trimmed();
     QJsonDocument doc = QJsonDocument::fromJson(response.toUtf8());
     if (doc.isNull() || !doc.object()["success"].toBool()) {
         QString msg = doc.isNull() ? "无效响应" : doc.object()["message"].toString();
         emit logMessage("服务初始化失败: " + msg);
-        stop();
         return false;
     }
 
-    emit logMessage("服务启动成功");
-    emit serviceStateChanged(true);
+    // 后端声明的在途上限（旧版脚本未声明时不限制，由客户端设置决定）
+    QJsonObject readyData = doc.object()["data"].toObject();
+    const int serviceMaxInFlight = qMax(0, readyData["max_in_flight"].toInt(0));
+    if (serviceMaxInFlight > 0) {
+        m_serviceMaxInFlight = (m_serviceMaxInFlight > 0)
+                                   ? qMin(m_serviceMaxInFlight, serviceMaxInFlight)
+                                   : serviceMaxInFlight;
+    }
+    m_binaryFrames = m_binaryFrames
+                     && readyData["response_formats"].toArray().contains(QJsonValue("binary"));
+    worker.readBuffer.clear();
+
+    // 握手完成后再接管 readyRead，避免吞掉就绪响应
+    Worker *target = &worker;
+    connect(worker.process, &QProcess::readyRead, this, [this, target]() {
+        onWorkerReadyRead(target);
+    });
+    connect(worker.process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, target]() {
+        onWorkerFinished(target);
+    });
     return true;
 }
 
-void DLService::stop()
+void DLService::shutdownWorker(Worker &worker)
 {
-    if (m_process) {
-        if (m_process->state() == QProcess::Running) {
-            // 发送退出命令
-            QJsonObject exitCmd;
-            exitCmd["command"] = "exit";
-            QString jsonStr = QJsonDocument(exitCmd).toJson(QJsonDocument::Compact);
-            m_process->write(jsonStr.toUtf8() + "\n");
-            m_process->waitForBytesWritten(1000);
-            m_process->waitForFinished(3000);
-
-            if (m_process->state() == QProcess::Running) {
-                m_process->kill();
-                m_process->waitForFinished(1000);
-            }
-        }
-
-        m_process->deleteLater();
-        m_process = nullptr;
-        m_modelLoaded = false;
+    if (!worker.process) {
+        return;
+    }
 
-        emit logMessage("服务已停止");
-        emit serviceStateChanged(false);
+    // 先断开响应分发，退出命令的响应不属于任何在途请求
+    disconnect(worker.process, nullptr, this, nullptr);
+
+    if (worker.process->state() == QProcess::Running) {
+        // 发送退出命令
+        QJsonObject exitCmd;
+        exitCmd["command"] = "exit";
+        QString jsonStr = QJsonDocument(exitCmd).toJson(QJsonDocument::Compact);
+        worker.process->write(jsonStr.toUtf8() + "\n");
+        worker.process->waitForBytesWritten(1000);
+        worker.process->waitForFinished(3000);
+
+        if (worker.process->state() == QProcess::Running) {
+            worker.process->kill();
+            worker.process->waitForFinished(1000);
+        }
     }
-}
 
-bool DLService::isRunning() const
-{
-    return m_process && m_process->state() == QProcess::Running;
+    worker.process->deleteLater();
+    worker.process = nullptr;
 }
 
-QJsonObject DLService::sendRequest(const QJsonObject &request)
+void DLService::stop()
 {
-    if (!isRunning()) {
-        return QJsonObject{{"success", false}, {"message", "服务未运行"}};
+    if (m_workers.empty()) {
+        return;
     }
 
-    // 发送请求
-    QString jsonStr = QJsonDocument(request).toJson(QJsonDocument::Compact);
-    m_process->write(jsonStr.toUtf8() + "\n");
+    // 先标记停止，回调中提交的新请求会立即失败
+    m_stopping = true;
+    failAllPending("服务已停止");
 
-    if (!m_process->waitForBytesWritten(5000)) {
-        return QJsonObject{{"success", false}, {"message", "发送请求超时"}};
+    for (auto &worker : m_workers) {
+        shutdownWorker(*worker);
     }
+    m_workers.clear();
 
-    // 等待响应
-    if (!m_process->waitForReadyRead(30000)) {  // 30秒超时
-        return QJsonObject{{"success", false}, {"message", "等待响应超时"}};
-    }
+    m_modelLoaded = false;
+    m_binaryFrames = false;
+    m_serviceMaxInFlight = 0;
+    m_timeoutTimer->stop();
 
-    // 读取响应（循环读取直到获得有效 JSON）
-    QString response;
-    for (int i = 0; i < 10; ++i) {  // 最多尝试 10 次
-        response = QString::fromUtf8(m_process->readLine()).trimmed();
-        if (!response.isEmpty()) {
-            break;
-        }
-        // 如果空行，等待更多数据
-        if (!m_process->waitForReadyRead(1000)) {
-            break;
+    emit logMessage("服务已停止");
+    emit serviceStateChanged(false);
+}
+
+bool DLService::isRunning() const
+{
+    if (m_stopping) {
+        return false;
+    }
+    for (const auto &worker : m_workers) {
+        if (worker->process && worker->process->state() == QProcess::Running) {
+            return true;
         }
     }
+    return false;
+}
 
-    // 调试输出原始响应
-    emit logMessage(QString("[调试] 原始响应: %1").arg(response));
+QJsonObject DLService::sendRequest(const QJsonObject &request)
+{
+    return waitForResult(sendRequestAsync(request));
+}
 
-    QJsonDocument doc = QJsonDocument::fromJson(response.toUtf8());
+QFuture<QJsonObject> DLService::sendRequestAsync(const QJsonObject &request)
+{
+    return submitRequest<QJsonObject>(request, [](const ServiceResponse &response) {
+        return response.json;
+    });
+}
 
-    if (doc.isNull()) {
-        return QJsonObject{{"success", false}, {"message", "无效的 JSON 响应: " + response}};
+void DLService::setMaxInFlight(int count)
+{
+    m_maxInFlight = qMax(1, count);
+    dispatchQueued();
+}
+
+int DLService::maxInFlight() const
+{
+    if (m_serviceMaxInFlight > 0) {
+        return qMin(m_maxInFlight, m_serviceMaxInFlight);
     }
+    return m_maxInFlight;
+}
 
-    return doc.object();
+int DLService::capacity() const
+{
+    return maxInFlight() * qMax(1, readyWorkerCount());
 }
 
-bool DLService::loadModel(const QString &modelPath, const QString &labelsPath)
+int DLService::pendingRequestCount() const
 {
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidModelPath(modelPath, errorMsg)) {
-        emit logMessage("模型路径验证失败: " + errorMsg);
-        emit modelLoaded(false, errorMsg);
-        return false;
+    int count = m_queued.size();
+    for (const auto &worker : m_workers) {
+        count += worker->inFlight.size();
     }
+    return count;
+}
 
-    // 标签文件路径验证（如果提供）
-    if (!labelsPath.isEmpty()) {
-        if (!FileUtils::isValidFilePath(labelsPath)) {
-            emit logMessage("标签文件路径不安全: " + labelsPath);
-            emit modelLoaded(false, "标签文件路径不安全");
-            return false;
+void DLService::setWorkerCount(int count)
+{
+    m_workerCount = qBound(1, count, MAX_WORKER_COUNT);
+}
+
+int DLService::readyWorkerCount() const
+{
+    int count = 0;
+    for (const auto &worker : m_workers) {
+        if (worker->state == WorkerState::Ready && worker->process) {
+            ++count;
         }
     }
+    return count;
+}
 
-    QJsonObject request;
-    request["command"] = "load_model";
-    request["model_path"] = modelPath;
-
-    if (!labelsPath.isEmpty()) {
-        request["labels_path"] = labelsPath;
+qint64 DLService::enqueueRequest(QJsonObject request, ResponseHandler handler, int timeoutMs,
+                                 Worker *target, ResponseHandler partialHandler)
+{
+    if (!isRunning()) {
+        handler(QJsonObject{{"success", false}, {"message", "服务未运行"}});
+        return -1;
     }
 
-    QJsonObject response = sendRequest(request);
-    bool success = response["success"].toBool();
-
-    if (success) {
-        m_modelLoaded = true;
-        m_modelPath = modelPath;
-        emit logMessage("模型加载成功: " + modelPath);
+    const qint64 id = m_nextRequestId++;
+    request["request_id"] = id;
 
-        // 保存到缓存管理器
-        EnvironmentCacheManager::instance()->setLastUsedModel(modelPath);
-    } else {
-        m_modelLoaded = false;
-        emit logMessage("模型加载失败: " + response["message"].toString());
-    }
+    PendingRequest pending;
+    pending.id = id;
+    pending.handler = std::move(handler);
+    pending.partialHandler = std::move(partialHandler);
+    pending.timeoutMs = timeoutMs > 0 ? timeoutMs : REQUEST_TIMEOUT_MS;
+    pending.target = target;
+    pending.payload = QJsonDocument(request).toJson(QJsonDocument::Compact) + "\n";
 
-    emit modelLoaded(success, response["message"].toString());
-    return success;
+    m_queued.enqueue(std::move(pending));
+    dispatchQueued();
+    return id;
 }
 
-DetectionResult DLService::parseDetectionResult(const QJsonObject &response)
+DLService::Worker *DLService::leastLoadedWorker() const
 {
-    DetectionResult result;
-    result.success = response["success"].toBool();
-    result.message = response["message"].toString();
-
-    if (result.success && response.contains("data")) {
-        QJsonObject data = response["data"].toObject();
-        QJsonArray detections = data["detections"].toArray();
+    const int limit = maxInFlight();
+    Worker *best = nullptr;
+    for (const auto &worker : m_workers) {
+        if (worker->state != WorkerState::Ready || !worker->process
+            || worker->inFlight.size() >= limit) {
+            continue;
+        }
+        if (!best || worker->inFlight.size() < best->inFlight.size()) {
+            best = worker.get();
+        }
+    }
+    return best;
+}
 
-        for (const QJsonValue &val : detections) {
-            QJsonObject obj = val.toObject();
-            Detection det;
-            det.x = obj["x"].toInt();
-            det.y = obj["y"].toInt();
-            det.width = obj["width"].toInt();
-            det.height = obj["height"].toInt();
-            det.confidence = static_cast<float>(obj["confidence"].toDouble());
-            det.classId = obj["class_id"].toInt();
-            det.label = obj["label"].toString();
+void DLService::dispatchQueued()
+{
+    if (!isRunning()) {
+        return;
+    }
 
-            // 解析掩码多边形
-            if (obj.contains("mask_polygon")) {
-                QJsonArray maskArray = obj["mask_polygon"].toArray();
-                for (const QJsonValue &ptVal : maskArray) {
-                    QJsonObject ptObj = ptVal.toObject();
-                    MaskPoint pt;
-                    pt.x = static_cast<float>(ptObj["x"].toDouble());
-                    pt.y = static_cast<float>(ptObj["y"].toDouble());
-                    det.maskPolygon.append(pt);
-                }
+    // 指定进程的请求等待该进程空出窗口，其余请求派发给最空闲的进程；
+    // 暂时无法派发的请求保持原有顺序留在队列中
+    const int limit = maxInFlight();
+    QQueue<PendingRequest> deferred;
+    while (!m_queued.isEmpty()) {
+        PendingRequest pending = m_queued.dequeue();
+
+        Worker *worker = pending.target;
+        if (worker) {
+            if (worker->state == WorkerState::Failed) {
+                pending.handler(QJsonObject{{"success", false}, {"message", "服务进程已退出"}});
+                continue;
+            }
+            if (!worker->process || worker->inFlight.size() >= limit) {
+                deferred.enqueue(std::move(pending));
+                continue;
+            }
+        } else {
+            worker = leastLoadedWorker();
+            if (!worker) {
+                deferred.enqueue(std::move(pending));
+                continue;
             }
+        }
 
-            result.detections.append(det);
+        if (worker->process->write(pending.payload) != pending.payload.size()) {
+            pending.handler(QJsonObject{{"success", false}, {"message", "发送请求失败"}});
+            continue;
         }
+        pending.payload.clear();
+        pending.sentTimer.start();
+        worker->inFlightOrder.append(pending.id);
+        worker->inFlight.insert(pending.id, std::move(pending));
     }
+    m_queued = std::move(deferred);
 
-    return result;
+    updateHealthTimer();
 }
 
-DetectionResult DLService::detect(const QString &imagePath,
-                                         float confThreshold,
-                                         float iouThreshold,
-                                         int imageSize)
+void DLService::onWorkerReadyRead(Worker *worker)
 {
-    if (!m_modelLoaded) {
-        DetectionResult result;
-        result.success = false;
-        result.message = "模型未加载";
-        emit logMessage(result.message);
-        return result;
+    if (!worker->process) {
+        return;
     }
+    QByteArray &buffer = worker->readBuffer;
+    buffer.append(worker->process->readAll());
+
+    // stdout 中混合文本行和二进制帧：帧以 magic 开头且可能包含换行，需先识别帧
+    while (!buffer.isEmpty() && worker->process) {
+        if (DetectionFrameDecoder::isFrameStart(buffer)) {
+            auto frame = std::make_shared<DetectionFrame>();
+            qint64 frameSize = 0;
+            QString errorMsg;
+            const DetectionFrameDecoder::Status status =
+                DetectionFrameDecoder::decode(buffer, *frame, frameSize, errorMsg);
+
+            if (status == DetectionFrameDecoder::Status::Incomplete) {
+                break;
+            }
 
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidImagePath(imagePath, errorMsg)) {
-        DetectionResult result;
-        result.success = false;
-        result.message = errorMsg;
-        emit logMessage("检测失败: " + errorMsg);
-        emit detectionCompleted(result);
-        return result;
-    }
+            if (status == DetectionFrameDecoder::Status::Invalid) {
+                emit logMessage("丢弃无效响应帧: " + errorMsg);
+                if (frameSize <= 0 || frameSize > buffer.size()) {
+                    // 帧长度不可信，无法定位下一条响应的起点
+                    buffer.clear();
+                    break;
+                }
+                buffer.remove(0, static_cast<int>(frameSize));
+                continue;
+            }
 
-    QElapsedTimer timer;
-    timer.start();
+            buffer.remove(0, static_cast<int>(frameSize));
+            ServiceResponse response(frame->header);
+            response.frame = std::move(frame);
+            dispatchResponse(*worker, response, frameSize);
+            continue;
+        }
 
-    QJsonObject request;
-    request["command"] = "detect";
-    request["image_path"] = imagePath;
-    request["conf_threshold"] = confThreshold;
-    request["iou_threshold"] = iouThreshold;
-    request["image_size"] = imageSize;
+        // magic 未到齐时等待，避免把帧开头当成文本
+        if (buffer.size() < 4 && QByteArray("GPCF").startsWith(buffer)) {
+            break;
+        }
 
-    QJsonObject response = sendRequest(request);
-    DetectionResult result = parseDetectionResult(response);
-    result.inferenceTime = timer.elapsed();
+        const int newline = buffer.indexOf('\n');
+        if (newline < 0) {
+            break;
+        }
 
-    if (result.success) {
-        emit logMessage(QString("检测完成: %1 个目标, 耗时 %2ms")
-                        .arg(result.detections.size())
-                        .arg(result.inferenceTime));
+        const QByteArray line = buffer.left(newline).trimmed();
+        buffer.remove(0, newline + 1);
+        if (!line.isEmpty()) {
+            handleResponseLine(*worker, line);
+        }
     }
+}
 
-    emit detectionCompleted(result);
-    return result;
+void DLService::handleResponseLine(Worker &worker, const QByteArray &line)
+{
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        // 第三方库可能向 stdout 打印非协议内容，忽略即可
+        emit logMessage(QString("[调试] 忽略非 JSON 输出: %1").arg(QString::fromUtf8(line.left(200))));
+        return;
+    }
+
+    dispatchResponse(worker, ServiceResponse(doc.object()), line.size());
 }
 
-DetectionResult DLService::segment(const QString &imagePath,
-                                          float confThreshold,
-                                          float iouThreshold,
-                                          int imageSize)
+void DLService::dispatchResponse(Worker &worker, const ServiceResponse &response, qint64 byteSize)
 {
-    if (!m_modelLoaded) {
-        DetectionResult result;
-        result.success = false;
-        result.message = "模型未加载";
-        emit logMessage(result.message);
-        return result;
+    const QJsonObject &json = response.json;
+
+    qint64 id = -1;
+    if (json.contains("request_id")) {
+        id = static_cast<qint64>(json["request_id"].toDouble(-1));
+    } else if (!worker.inFlightOrder.isEmpty()) {
+        // 旧版后端不回传 ID，按顺序处理所以取最早的在途请求
+        id = worker.inFlightOrder.first();
     }
 
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidImagePath(imagePath, errorMsg)) {
-        DetectionResult result;
-        result.success = false;
-        result.message = errorMsg;
-        emit logMessage("分割失败: " + errorMsg);
-        emit detectionCompleted(result);
-        return result;
+    auto it = worker.inFlight.find(id);
+    if (it == worker.inFlight.end()) {
+        emit logMessage(QString("[调试] 收到无匹配请求的响应 (ID %1)").arg(id));
+        return;
     }
 
-    QElapsedTimer timer;
-    timer.start();
+    // 流式分块：请求仍在途，只重新计时并交给分块处理函数
+    if (json["partial"].toBool()) {
+        it->sentTimer.restart();
+        ResponseHandler partial = it->partialHandler;  // 处理函数可能提交新请求，先复制
+        if (partial) {
+            partial(response);
+        }
+        return;
+    }
 
-    QJsonObject request;
-    request["command"] = "segment";
-    request["image_path"] = imagePath;
-    request["conf_threshold"] = confThreshold;
-    request["iou_threshold"] = iouThreshold;
-    request["image_size"] = imageSize;
+    PendingRequest pending = std::move(it.value());
+    worker.inFlight.erase(it);
+    worker.inFlightOrder.removeOne(id);
 
-    QJsonObject response = sendRequest(request);
-    DetectionResult result = parseDetectionResult(response);
-    result.inferenceTime = timer.elapsed();
+    emit logMessage(QString("[调试] 响应 #%1 (进程 %2): %3 字节%4, %5")
+                    .arg(id)
+                    .arg(worker.index)
+                    .arg(byteSize)
+                    .arg(response.frame ? " (二进制帧)" : "")
+                    .arg(json["message"].toString()));
 
-    if (result.success) {
-        emit logMessage(QString("分割完成: %1 个实例, 耗时 %2ms")
-                        .arg(result.detections.size())
-                        .arg(result.inferenceTime));
+    // 先补足在途窗口，再处理结果，使后端不空闲
+    dispatchQueued();
+    pending.handler(response);
+}
+
+void DLService::failRequest(Worker &worker, qint64 id, const QString &message)
+{
+    auto it = worker.inFlight.find(id);
+    if (it == worker.inFlight.end()) {
+        return;
     }
 
-    emit detectionCompleted(result);
-    return result;
+    PendingRequest pending = std::move(it.value());
+    worker.inFlight.erase(it);
+    worker.inFlightOrder.removeOne(id);
+
+    pending.handler(QJsonObject{{"success", false}, {"message", message}});
 }
 
-ClassificationResultList DLService::parseClassificationResult(const QJsonObject &response)
+void DLService::failWorkerRequests(Worker &worker, const QString &message)
 {
-    ClassificationResultList result;
-    result.success = response["success"].toBool();
-    result.message = response["message"].toString();
+    // 先取出再回调，回调中可能提交新请求
+    QList<PendingRequest> pending;
+    for (qint64 id : worker.inFlightOrder) {
+        pending.append(worker.inFlight.take(id));
+    }
+    worker.inFlight.clear();
+    worker.inFlightOrder.clear();
 
-    if (result.success && response.contains("data")) {
-        QJsonObject data = response["data"].toObject();
-        QJsonArray classifications = data["classifications"].toArray();
+    const QJsonObject response{{"success", false}, {"message", message}};
+    for (const PendingRequest &request : pending) {
+        request.handler(response);
+    }
+}
 
-        for (const QJsonValue &val : classifications) {
-            QJsonObject obj = val.toObject();
-            ClassificationResult cls;
-            cls.rank = obj["rank"].toInt();
-            cls.confidence = static_cast<float>(obj["confidence"].toDouble());
-            cls.classId = obj["class_id"].toInt();
-            cls.label = obj["label"].toString();
-            // FSL 特有字段
-            if (obj.contains("avg_distance")) {
-                cls.avgDistance = static_cast<float>(obj["avg_distance"].toDouble());
-            }
-            if (obj.contains("episode_count")) {
-                cls.episodeCount = obj["episode_count"].toInt();
-            }
-            result.classifications.append(cls);
-        }
+void DLService::failAllPending(const QString &message)
+{
+    m_timeoutTimer->stop();
 
-        // Set top prediction
-        if (!result.classifications.isEmpty()) {
-            result.topPrediction = result.classifications.first();
+    // 先取出再回调，回调中可能提交新请求
+    QList<PendingRequest> pending;
+    for (auto &worker : m_workers) {
+        for (qint64 id : worker->inFlightOrder) {
+            pending.append(worker->inFlight.take(id));
         }
+        worker->inFlight.clear();
+        worker->inFlightOrder.clear();
+    }
+    while (!m_queued.isEmpty()) {
+        pending.append(m_queued.dequeue());
     }
 
-    return result;
+    const QJsonObject response{{"success", false}, {"message", message}};
+    for (const PendingRequest &request : pending) {
+        request.handler(response);
+    }
 }
 
-KeypointResult DLService::parseKeypointResult(const QJsonObject &response)
+void DLService::onWorkerFinished(Worker *worker)
 {
-    KeypointResult result;
-    result.success = response["success"].toBool();
-    result.message = response["message"].toString();
+    if (m_stopping || !worker->process) {
+        return;
+    }
 
-    if (result.success && response.contains("data")) {
-        QJsonObject data = response["data"].toObject();
-        QJsonArray detections = data["detections"].toArray();
+    emit logMessage(QString("后端进程 %1 已退出").arg(worker->index));
 
-        for (const QJsonValue &val : detections) {
-            QJsonObject obj = val.toObject();
+    disconnect(worker->process, nullptr, this, nullptr);
+    worker->process->deleteLater();
+    worker->process = nullptr;
+    worker->readBuffer.clear();
+    failWorkerRequests(*worker, "服务进程已退出");
+
+    if (worker->restartCount >= MAX_WORKER_RESTARTS) {
+        worker->state = WorkerState::Failed;
+        emit logMessage(QString("后端进程 %1 重启次数过多，已停用").arg(worker->index));
+    } else {
+        worker->state = WorkerState::Restarting;
+        worker->exitTimer.start();
+    }
+
+    bool alive = false;
+    for (const auto &w : m_workers) {
+        if (w->state != WorkerState::Failed) {
+            alive = true;
+            break;
+        }
+    }
+
+    if (!alive) {
+        // 所有进程都不可用，服务视为停止
+        failAllPending("服务进程已退出");
+        m_modelLoaded = false;
+        emit serviceStateChanged(false);
+        return;
+    }
+
+    // 其它进程继续处理排队的请求
+    dispatchQueued();
+    updateHealthTimer();
+}
+
+void DLService::restartWorker(Worker &worker)
+{
+    worker.restartCount++;
+    emit logMessage(QString("正在重启后端进程 %1 (第 %2 次)").arg(worker.index).arg(worker.restartCount));
+
+    if (!launchWorker(worker) || !handshakeWorker(worker)) {
+        shutdownWorker(worker);
+        if (worker.restartCount >= MAX_WORKER_RESTARTS) {
+            worker.state = WorkerState::Failed;
+            emit logMessage(QString("后端进程 %1 无法重启，已停用").arg(worker.index));
+        } else {
+            worker.exitTimer.start();
+        }
+        return;
+    }
+
+    if (!m_modelLoaded) {
+        worker.state = WorkerState::Ready;
+        dispatchQueued();
+        return;
+    }
+
+    // 重新加载当前模型，完成前只接收指定给它的请求
+    worker.state = WorkerState::Starting;
+    QJsonObject request;
+    request["command"] = "load_model";
+    request["model_path"] = m_modelPath;
+    if (!m_labelsPath.isEmpty()) {
+        request["labels_path"] = m_labelsPath;
+    }
+
+    Worker *target = &worker;
+    enqueueRequest(request, [this, target](const ServiceResponse &response) {
+        if (m_stopping || target->state != WorkerState::Starting) {
+            return;
+        }
+        if (response.json["success"].toBool()) {
+            target->state = WorkerState::Ready;
+            emit logMessage(QString("后端进程 %1 已恢复").arg(target->index));
+            dispatchQueued();
+        } else {
+            emit logMessage(QString("后端进程 %1 重新加载模型失败: %2")
+                            .arg(target->index)
+                            .arg(response.json["message"].toString()));
+            if (target->process) {
+                target->process->kill();
+            }
+        }
+    }, MODEL_LOAD_TIMEOUT_MS, target);
+}
+
+void DLService::updateHealthTimer()
+{
+    bool needed = false;
+    for (const auto &worker : m_workers) {
+        if (!worker->inFlight.isEmpty() || worker->state == WorkerState::Restarting) {
+            needed = true;
+            break;
+        }
+    }
+
+    if (needed && !m_timeoutTimer->isActive()) {
+        m_timeoutTimer->start();
+    } else if (!needed) {
+        m_timeoutTimer->stop();
+    }
+}
+
+void DLService::checkRequestTimeouts()
+{
+    for (auto &worker : m_workers) {
+        QList<qint64> expired;
+        for (qint64 id : worker->inFlightOrder) {
+            const PendingRequest &pending = worker->inFlight[id];
+            if (pending.sentTimer.hasExpired(pending.timeoutMs)) {
+                expired.append(id);
+            }
+        }
+
+        for (qint64 id : expired) {
+            failRequest(*worker, id, "等待响应超时");
+        }
+
+        // 请求超时说明进程已无响应，结束它并由重启流程接管
+        if (!expired.isEmpty() && worker->process) {
+            emit logMessage(QString("后端进程 %1 无响应，正在重启").arg(worker->index));
+            worker->process->kill();
+        }
+    }
+
+    // 退出的进程延迟一段时间后重启，避免崩溃后立即反复拉起
+    for (auto &worker : m_workers) {
+        if (m_stopping) {
+            return;
+        }
+        if (worker->state == WorkerState::Restarting && !worker->process
+            && worker->exitTimer.hasExpired(WORKER_RESTART_DELAY_MS)) {
+            restartWorker(*worker);
+        }
+    }
+
+    dispatchQueued();
+}
+
+void DLService::waitForWorkerOutput(int msecs)
+{
+    // 依次检查有在途请求的进程；都没有新数据时阻塞等待其中一个
+    Worker *busy = nullptr;
+    bool received = false;
+    for (const auto &worker : m_workers) {
+        if (!worker->process || worker->inFlight.isEmpty()) {
+            continue;
+        }
+        if (worker->process->waitForReadyRead(0)) {
+            received = true;
+        } else if (!busy) {
+            busy = worker.get();
+        }
+    }
+
+    if (received) {
+        return;
+    }
+
+    if (busy && busy->process) {
+        busy->process->waitForReadyRead(msecs);
+    } else {
+        // 没有在途请求（例如进程正在等待重启），稍后再检查
+        QThread::msleep(static_cast<unsigned long>(qMin(msecs, 50)));
+    }
+}
+
+template <typename Result>
+Result DLService::waitForResult(const QFuture<Result> &future)
+{
+    // 同步接口：在调用线程上驱动管道读取，响应由 onWorkerReadyRead 分发；
+    // 没有事件循环，等待中的后续步骤（如内容哈希算完后的提交）也在这里执行
+    while (!future.isFinished()) {
+        runContinuations();
+        if (future.isFinished()) {
+            break;
+        }
+        if (!isRunning()) {
+            failAllPending("服务未运行");
+            if (m_continuations.isEmpty()) {
+                break;
+            }
+            // 后续步骤在等待线程池中的哈希计算，提交时会立即失败
+            QThread::msleep(10);
+            continue;
+        }
+        waitForWorkerOutput(200);
+        checkRequestTimeouts();
+    }
+    return future.result();
+}
+
+template <typename Result>
+QFuture<Result> DLService::submitRequest(const QJsonObject &request,
+                                         std::function<Result(const ServiceResponse &)> finish,
+                                         int timeoutMs,
+                                         Worker *target,
+                                         ResponseHandler partialHandler)
+{
+    QFutureInterface<Result> promise;
+    promise.reportStarted();
+    QFuture<Result> future = promise.future();
+
+    enqueueRequest(request, [promise, finish](const ServiceResponse &response) mutable {
+        Result result = finish(response);
+        promise.reportResult(result);
+        promise.reportFinished();
+    }, timeoutMs, target, std::move(partialHandler));
+
+    return future;
+}
+
+template <typename Result>
+QFuture<Result> DLService::makeReadyFuture(const Result &result)
+{
+    QFutureInterface<Result> promise;
+    promise.reportStarted();
+    promise.reportResult(result);
+    promise.reportFinished();
+    return promise.future();
+}
+
+template <typename Result>
+bool DLService::prepareInferenceRequest(const InferenceImage &image, const QString &actionName,
+                                        QJsonObject &request,
+                                        std::shared_ptr<SharedImageBuffer> &sharedImage,
+                                        Result &errorResult)
+{
+    errorResult.success = false;
+
+    if (!m_modelLoaded) {
+        errorResult.message = "模型未加载";
+        emit logMessage(errorResult.message);
+        return false;
+    }
+
+    // 内存图像：像素写入共享内存，请求中只携带描述信息
+    if (image.inMemory()) {
+        auto buffer = std::make_shared<SharedImageBuffer>();
+        QString errorMsg;
+        const bool created = image.tiles ? buffer->create(*image.tiles, errorMsg)
+                                         : buffer->create(image.image, errorMsg);
+        if (!created) {
+            errorResult.message = errorMsg;
+            emit logMessage(actionName + "失败: " + errorMsg);
+            return false;
+        }
+        request["image_shm"] = buffer->descriptor();
+        sharedImage = buffer;
+        return true;
+    }
+
+    // 路径安全验证
+    QString errorMsg;
+    if (!FileUtils::isValidImagePath(image.path, errorMsg)) {
+        errorResult.message = errorMsg;
+        emit logMessage(actionName + "失败: " + errorMsg);
+        return false;
+    }
+
+    request["image_path"] = image.path;
+    return true;
+}
+
+// 优先使用后端统计的处理耗时，不含排队等待时间
+static double responseElapsed(const QJsonObject &response, const QElapsedTimer &timer)
+{
+    if (response.contains("elapsed_ms")) {
+        return response["elapsed_ms"].toDouble();
+    }
+    return static_cast<double>(timer.elapsed());
+}
+
+bool DLService::loadModel(const QString &modelPath, const QString &labelsPath)
+{
+    return waitForResult(loadModelAsync(modelPath, labelsPath));
+}
+
+QFuture<bool> DLService::loadModelAsync(const QString &modelPath, const QString &labelsPath)
+{
+    // 路径安全验证
+    QString errorMsg;
+    if (!FileUtils::isValidModelPath(modelPath, errorMsg)) {
+        emit logMessage("模型路径验证失败: " + errorMsg);
+        emit modelLoaded(false, errorMsg);
+        return makeReadyFuture(false);
+    }
+
+    // 标签文件路径验证（如果提供）
+    if (!labelsPath.isEmpty()) {
+        if (!FileUtils::isValidFilePath(labelsPath)) {
+            emit logMessage("标签文件路径不安全: " + labelsPath);
+            emit modelLoaded(false, "标签文件路径不安全");
+            return makeReadyFuture(false);
+        }
+    }
+
+    QJsonObject request;
+    request["command"] = "load_model";
+    request["model_path"] = modelPath;
+
+    if (!labelsPath.isEmpty()) {
+        request["labels_path"] = labelsPath;
+    }
+
+    // 进程池中每个进程各自加载模型，全部成功才算成功；最后一个响应到达时汇总
+    QVector<Worker *> targets;
+    for (const auto &worker : m_workers) {
+        if (worker->process && worker->state != WorkerState::Failed) {
+            targets.append(worker.get());
+        }
+    }
+
+    struct LoadState {
+        QFutureInterface<bool> promise;
+        QJsonObject response;
+        int remaining = 0;
+    };
+    auto state = std::make_shared<LoadState>();
+    state->remaining = qMax(1, targets.size());
+    state->promise.reportStarted();
+    QFuture<bool> future = state->promise.future();
+
+    ResponseHandler handler = [this, state, modelPath, labelsPath](const ServiceResponse &reply) {
+        if (state->response.isEmpty()
+            || (state->response["success"].toBool() && !reply.json["success"].toBool())) {
+            state->response = reply.json;
+        }
+        if (--state->remaining == 0) {
+            const bool success = finishModelLoad(state->response, modelPath, labelsPath);
+            state->promise.reportResult(success);
+            state->promise.reportFinished();
+        }
+    };
+
+    if (targets.isEmpty()) {
+        enqueueRequest(request, handler);
+    }
+    for (Worker *worker : targets) {
+        enqueueRequest(request, handler, MODEL_LOAD_TIMEOUT_MS, worker);
+    }
+    return future;
+}
+
+bool DLService::finishModelLoad(const QJsonObject &response, const QString &modelPath,
+                                const QString &labelsPath)
+{
+    bool success = response["success"].toBool();
+
+    if (success) {
+        m_modelLoaded = true;
+        m_modelPath = modelPath;
+        m_labelsPath = labelsPath;
+        emit logMessage("模型加载成功: " + modelPath);
+
+        // 保存到缓存管理器
+        EnvironmentCacheManager::instance()->setLastUsedModel(modelPath);
+        rememberModel(modelPath);
+
+        if (response["data"].toObject()["cached"].toBool()) {
+            emit logMessage("模型已在后端缓存中，直接切换");
+        }
+    } else {
+        m_modelLoaded = false;
+        emit logMessage("模型加载失败: " + response["message"].toString());
+    }
+
+    emit modelLoaded(success, response["message"].toString());
+    return success;
+}
+
+void DLService::prefetchModel(const QString &modelPath)
+{
+    if (!isRunning() || isFSLTask() || modelPath.isEmpty() || modelPath == m_modelPath) {
+        return;
+    }
+
+    QString errorMsg;
+    if (!FileUtils::isValidModelPath(modelPath, errorMsg)) {
+        return;
+    }
+
+    QJsonObject request;
+    request["command"] = "prefetch_model";
+    request["model_path"] = modelPath;
+
+    // 每个进程各自持有缓存，逐个指定发送
+    for (const auto &worker : m_workers) {
+        if (!worker->process || worker->state == WorkerState::Failed) {
+            continue;
+        }
+        const int index = worker->index;
+        enqueueRequest(request, [this, index, modelPath](const ServiceResponse &response) {
+            if (!response.json["success"].toBool()) {
+                emit logMessage(QString("后端进程 %1 预取模型失败: %2")
+                                .arg(index)
+                                .arg(response.json["message"].toString()));
+            } else if (response.json["data"].toObject()["started"].toBool()) {
+                emit logMessage(QString("后端进程 %1 开始预取模型: %2")
+                                .arg(index)
+                                .arg(QFileInfo(modelPath).fileName()));
+            }
+        }, 0, worker.get());
+    }
+}
+
+void DLService::setResultCacheLimit(int megabytes)
+{
+    m_resultCacheLimit = static_cast<qint64>(qMax(0, megabytes)) * 1024 * 1024;
+    if (m_resultCache) {
+        m_resultCache->setMaxDiskBytes(m_resultCacheLimit);
+    }
+}
+
+void DLService::clearResultCache()
+{
+    resultCache()->clear();
+    emit logMessage("推理结果缓存已清空");
+}
+
+InferenceResultCache *DLService::resultCache()
+{
+    if (!m_resultCache) {
+        m_resultCache = std::make_unique<InferenceResultCache>(
+            EnvironmentCacheManager::cacheDirectory() + "/inference_results", m_resultCacheLimit);
+    }
+    return m_resultCache.get();
+}
+
+QString DLService::contentHashMemoKey(const InferenceImage &image) const
+{
+    if (!m_resultCacheEnabled || !m_modelLoaded || m_resultCacheLimit <= 0) {
+        return QString();
+    }
+
+    if (image.inMemory()) {
+        return image.tiles ? InferenceResultCache::hashMemoKey(*image.tiles)
+                           : InferenceResultCache::hashMemoKey(image.image);
+    }
+
+    QString errorMsg;
+    if (!FileUtils::isValidImagePath(image.path, errorMsg)) {
+        return QString();
+    }
+    return InferenceResultCache::hashMemoKey(image.path);
+}
+
+QString DLService::resultCacheKey(const QString &task, const QString &contentHash, const QJsonObject &params) const
+{
+    if (!m_resultCacheEnabled || !m_modelLoaded || m_resultCacheLimit <= 0 || contentHash.isEmpty()) {
+        return QString();
+    }
+
+    QJsonObject keyParams = params;
+    keyParams["labels_path"] = m_labelsPath;
+    keyParams["service"] = m_taskType;
+    return InferenceResultCache::makeKey(contentHash, m_modelPath, task, keyParams);
+}
+
+// 在线程池中调用，只读取调用方传入的图像副本
+static QString computeContentHash(const InferenceImage &image)
+{
+    if (image.tiles) {
+        return InferenceResultCache::computeImageHash(*image.tiles);
+    }
+    if (!image.image.isNull()) {
+        return InferenceResultCache::computeImageHash(image.image);
+    }
+    return InferenceResultCache::computeFileHash(image.path);
+}
+
+template <typename T>
+void DLService::continueWith(const QFuture<T> &future, std::function<void(const T &)> next)
+{
+    m_continuations.append([future, next]() {
+        if (!future.isFinished()) {
+            return false;
+        }
+        next(future.result());
+        return true;
+    });
+
+    auto *watcher = new QFutureWatcher<T>(this);
+    connect(watcher, &QFutureWatcher<T>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        runContinuations();
+    });
+    watcher->setFuture(future);
+}
+
+void DLService::runContinuations()
+{
+    // 后续步骤中可能追加新的步骤（追加在末尾），先复制再执行
+    for (int i = 0; i < m_continuations.size();) {
+        const std::function<bool()> step = m_continuations[i];
+        if (step()) {
+            m_continuations.removeAt(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+template <typename Result>
+QFuture<Result> DLService::withResultCacheKeys(const QString &task,
+                                               const QVector<InferenceImage> &images,
+                                               const QJsonObject &params,
+                                               std::function<QFuture<Result>(const QStringList &)> submit)
+{
+    // 先查哈希记忆表，记下需要计算哈希的图像
+    QStringList memoKeys;
+    QStringList contentHashes;
+    QVector<InferenceImage> toHash;
+    for (const InferenceImage &image : images) {
+        const QString memoKey = contentHashMemoKey(image);
+        const QString known = memoKey.isEmpty() ? QString() : resultCache()->knownHash(memoKey);
+        memoKeys.append(memoKey);
+        contentHashes.append(known);
+        if (!memoKey.isEmpty() && known.isEmpty()) {
+            toHash.append(image);
+        }
+    }
+
+    auto makeKeys = [this, task, params](const QStringList &hashes) {
+        QStringList keys;
+        for (const QString &hash : hashes) {
+            keys.append(resultCacheKey(task, hash, params));
+        }
+        return keys;
+    };
+
+    if (toHash.isEmpty()) {
+        return submit(makeKeys(contentHashes));
+    }
+
+    QFuture<QStringList> hashing = QtConcurrent::run([toHash]() {
+        QStringList hashes;
+        for (const InferenceImage &image : toHash) {
+            hashes.append(computeContentHash(image));
+        }
+        return hashes;
+    });
+
+    auto promise = std::make_shared<QFutureInterface<Result>>();
+    promise->reportStarted();
+
+    continueWith<QStringList>(hashing,
+        [this, images, memoKeys, contentHashes, makeKeys, submit, promise](const QStringList &computed) {
+        QStringList hashes = contentHashes;
+        int next = 0;
+        for (int i = 0; i < images.size(); ++i) {
+            if (memoKeys[i].isEmpty() || !hashes[i].isEmpty()) {
+                continue;
+            }
+            const QString hash = computed.value(next++);
+            // 计算期间图像或文件被修改时哈希与当前内容不符，本次不使用缓存
+            if (contentHashMemoKey(images[i]) != memoKeys[i]) {
+                continue;
+            }
+            resultCache()->rememberHash(memoKeys[i], hash);
+            hashes[i] = hash;
+        }
+
+        continueWith<Result>(submit(makeKeys(hashes)), [promise](const Result &result) {
+            promise->reportResult(result);
+            promise->reportFinished();
+        });
+    });
+
+    return promise->future();
+}
+
+// 以后端响应的结构保存结果，命中时复用各 parse 函数解析
+static QJsonObject detectionResultToJson(const DetectionResult &result)
+{
+    QJsonArray detections;
+    for (const Detection &det : result.detections) {
+        QJsonObject obj;
+        obj["x"] = det.x;
+        obj["y"] = det.y;
+        obj["width"] = det.width;
+        obj["height"] = det.height;
+        obj["confidence"] = det.confidence;
+        obj["class_id"] = det.classId;
+        obj["label"] = det.label;
+        if (!det.maskPolygon.isEmpty()) {
+            QJsonArray polygon;
+            for (const MaskPoint &pt : det.maskPolygon) {
+                polygon.append(QJsonObject{{"x", pt.x}, {"y", pt.y}});
+            }
+            obj["mask_polygon"] = polygon;
+        }
+        detections.append(obj);
+    }
+
+    QJsonObject data;
+    data["detections"] = detections;
+
+    QJsonObject response;
+    response["success"] = result.success;
+    response["message"] = result.message;
+    response["data"] = data;
+    return response;
+}
+
+static QJsonObject classificationResultToJson(const ClassificationResultList &result)
+{
+    QJsonArray classifications;
+    for (const ClassificationResult &cls : result.classifications) {
+        QJsonObject obj;
+        obj["rank"] = cls.rank;
+        obj["confidence"] = cls.confidence;
+        obj["class_id"] = cls.classId;
+        obj["label"] = cls.label;
+        classifications.append(obj);
+    }
+
+    QJsonObject data;
+    data["classifications"] = classifications;
+
+    QJsonObject response;
+    response["success"] = result.success;
+    response["message"] = result.message;
+    response["data"] = data;
+    return response;
+}
+
+static QJsonObject keypointResultToJson(const KeypointResult &result)
+{
+    QJsonArray detections;
+    for (const KeypointDetection &det : result.detections) {
+        QJsonObject obj;
+        obj["x"] = det.x;
+        obj["y"] = det.y;
+        obj["width"] = det.width;
+        obj["height"] = det.height;
+        obj["confidence"] = det.confidence;
+        obj["class_id"] = det.classId;
+        obj["label"] = det.label;
+        QJsonArray keypoints;
+        for (const KeypointData &kp : det.keypoints) {
+            keypoints.append(QJsonObject{{"id", kp.id}, {"x", kp.x}, {"y", kp.y}, {"confidence", kp.confidence}});
+        }
+        obj["keypoints"] = keypoints;
+        detections.append(obj);
+    }
+
+    QJsonObject data;
+    data["detections"] = detections;
+
+    QJsonObject response;
+    response["success"] = result.success;
+    response["message"] = result.message;
+    response["data"] = data;
+    return response;
+}
+
+// 缓存命中的耗时（毫秒，保留小数）
+static double cacheElapsed(const QElapsedTimer &timer)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1.0e6;
+}
+
+static QString recentModelsKey(bool fsl)
+{
+    return fsl ? "model/recent_fsl" : "model/recent";
+}
+
+QStringList DLService::recentModels() const
+{
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    QSettings settings(configPath + "/dl_settings.ini", QSettings::IniFormat);
+
+    QStringList result;
+    for (const QString &path : settings.value(recentModelsKey(isFSLTask())).toStringList()) {
+        if (QFile::exists(path)) {
+            result.append(path);
+        }
+    }
+    return result;
+}
+
+void DLService::rememberModel(const QString &modelPath)
+{
+    QStringList recent = recentModels();
+    recent.removeAll(modelPath);
+    recent.prepend(modelPath);
+    while (recent.size() > MAX_RECENT_MODELS) {
+        recent.removeLast();
+    }
+
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    QDir configDir(configPath);
+    if (!configDir.exists()) {
+        configDir.mkpath(".");
+    }
+
+    QSettings settings(configPath + "/dl_settings.ini", QSettings::IniFormat);
+    settings.setValue(recentModelsKey(isFSLTask()), recent);
+    settings.sync();
+}
+
+// 从二进制帧读取第 imageIndex 张图像的检测，直接由紧凑数组构造
+static void readFrameDetections(const DetectionFrame &frame, const QJsonObject &labels,
+                                int imageIndex, QVector<Detection> &detections)
+{
+    if (imageIndex < 0 || imageIndex >= frame.imageCount()) {
+        return;
+    }
+
+    const int begin = static_cast<int>(frame.imageOffsets[imageIndex]);
+    const int end = static_cast<int>(frame.imageOffsets[imageIndex + 1]);
+    detections.reserve(end - begin);
+
+    for (int i = begin; i < end; ++i) {
+        const float *box = frame.boxes.constData() + i * 4;
+        Detection det;
+        det.x = static_cast<int>(box[0]);
+        det.y = static_cast<int>(box[1]);
+        det.width = static_cast<int>(box[2]);
+        det.height = static_cast<int>(box[3]);
+        det.confidence = frame.scores[i];
+        det.classId = frame.classIds[i];
+        det.label = labels[QString::number(det.classId)].toString();
+
+        const int vertexBegin = static_cast<int>(frame.vertexOffsets[i]);
+        const int vertexEnd = static_cast<int>(frame.vertexOffsets[i + 1]);
+        det.maskPolygon.resize(vertexEnd - vertexBegin);
+        const float *vertex = frame.vertices.constData() + vertexBegin * 2;
+        for (int k = 0; k < det.maskPolygon.size(); ++k) {
+            det.maskPolygon[k].x = vertex[k * 2];
+            det.maskPolygon[k].y = vertex[k * 2 + 1];
+        }
+
+        detections.append(std::move(det));
+    }
+}
+
+DetectionResult DLService::parseDetectionResult(const QJsonObject &response,
+                                                const DetectionFrame *frame,
+                                                int imageIndex)
+{
+    DetectionResult result;
+    result.success = response["success"].toBool();
+    result.message = response["message"].toString();
+
+    if (result.success && frame) {
+        readFrameDetections(*frame, frame->header["labels"].toObject(), imageIndex, result.detections);
+        return result;
+    }
+
+    if (result.success && response.contains("data")) {
+        QJsonObject data = response["data"].toObject();
+        QJsonArray detections = data["detections"].toArray();
+
+        for (const QJsonValue &val : detections) {
+            QJsonObject obj = val.toObject();
+            Detection det;
+            det.x = obj["x"].toInt();
+            det.y = obj["y"].toInt();
+            det.width = obj["width"].toInt();
+            det.height = obj["height"].toInt();
+            det.confidence = static_cast<float>(obj["confidence"].toDouble());
+            det.classId = obj["class_id"].toInt();
+            det.label = obj["label"].toString();
+
+            // 解析掩码多边形
+            if (obj.contains("mask_polygon")) {
+                QJsonArray maskArray = obj["mask_polygon"].toArray();
+                for (const QJsonValue &ptVal : maskArray) {
+                    QJsonObject ptObj = ptVal.toObject();
+                    MaskPoint pt;
+                    pt.x = static_cast<float>(ptObj["x"].toDouble());
+                    pt.y = static_cast<float>(ptObj["y"].toDouble());
+                    det.maskPolygon.append(pt);
+                }
+            }
+
+            result.detections.append(det);
+        }
+    }
+
+    return result;
+}
+
+// 请求携带 client_nms 时后端跳过 dl_service.py 的跨类别 NMS，改由本地完成。
+// 对已经过 NMS 的结果（旧版后端）再做一次不会删除任何框
+static DetectionResult applyClientNms(DetectionResult result, float iouThreshold)
+{
+    if (result.success && result.detections.size() > 1) {
+        result.detections = DetectionPostProcess::nms(result.detections, iouThreshold,
+                                                      DetectionPostProcess::NmsMode::Agnostic);
+    }
+    return result;
+}
+
+DetectionResult DLService::detect(const InferenceImage &image,
+                                         float confThreshold,
+                                         float iouThreshold,
+                                         int imageSize)
+{
+    return waitForResult(detectAsync(image, confThreshold, iouThreshold, imageSize));
+}
+
+DetectionResult DLService::segment(const InferenceImage &image,
+                                          float confThreshold,
+                                          float iouThreshold,
+                                          int imageSize)
+{
+    return waitForResult(segmentAsync(image, confThreshold, iouThreshold, imageSize));
+}
+
+QFuture<DetectionResult> DLService::detectAsync(const InferenceImage &image,
+                                                float confThreshold,
+                                                float iouThreshold,
+                                                int imageSize)
+{
+    return submitDetection("detect", "检测", image, confThreshold, iouThreshold, imageSize);
+}
+
+QFuture<DetectionResult> DLService::segmentAsync(const InferenceImage &image,
+                                                 float confThreshold,
+                                                 float iouThreshold,
+                                                 int imageSize)
+{
+    return submitDetection("segment", "分割", image, confThreshold, iouThreshold, imageSize);
+}
+
+QFuture<DetectionResult> DLService::detectCandidatesAsync(const InferenceImage &image, int imageSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QJsonObject params{{"raw_candidates", true},
+                             {"conf_threshold", CANDIDATE_CONF_THRESHOLD},
+                             {"image_size", imageSize}};
+    return withResultCacheKeys<DetectionResult>("detect", {image}, params,
+        [this, image, imageSize, timer](const QStringList &cacheKeys) {
+        const QString cacheKey = cacheKeys.first();
+        QJsonObject cached;
+        if (!cacheKey.isEmpty() && resultCache()->lookup(cacheKey, cached)) {
+            DetectionResult result = parseDetectionResult(cached);
+            result.inferenceTime = cacheElapsed(timer);
+            emit logMessage(QString("检测完成 (缓存): %1 个候选框").arg(result.detections.size()));
+            return makeReadyFuture(result);
+        }
+
+        DetectionResult errorResult;
+        QJsonObject request;
+        request["command"] = "detect";
+
+        std::shared_ptr<SharedImageBuffer> sharedImage;
+        if (!prepareInferenceRequest(image, "检测", request, sharedImage, errorResult)) {
+            return makeReadyFuture(errorResult);
+        }
+
+        request["raw_candidates"] = true;
+        request["conf_threshold"] = CANDIDATE_CONF_THRESHOLD;
+        request["image_size"] = imageSize;
+        if (m_binaryFrames) {
+            request["response_format"] = "binary";
+        }
+
+        return submitRequest<DetectionResult>(request, [this, timer, sharedImage, cacheKey](const ServiceResponse &response) {
+            DetectionResult result = parseDetectionResult(response.json, response.frame.get());
+            result.inferenceTime = responseElapsed(response.json, timer);
+            if (result.success && !cacheKey.isEmpty() && m_resultCache) {
+                m_resultCache->insert(cacheKey, detectionResultToJson(result));
+            }
+
+            if (result.success) {
+                emit logMessage(QString("检测完成: %1 个候选框, 耗时 %2ms")
+                                .arg(result.detections.size())
+                                .arg(result.inferenceTime));
+            }
+            return result;
+        });
+    });
+}
+
+QFuture<DetectionResult> DLService::submitDetection(const QString &command,
+                                                    const QString &actionName,
+                                                    const InferenceImage &image,
+                                                    float confThreshold,
+                                                    float iouThreshold,
+                                                    int imageSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 相同图像、模型和参数的结果直接取自缓存
+    const QJsonObject params{{"conf_threshold", confThreshold},
+                             {"iou_threshold", iouThreshold},
+                             {"image_size", imageSize}};
+    return withResultCacheKeys<DetectionResult>(command, {image}, params,
+        [this, command, actionName, image, confThreshold, iouThreshold, imageSize, timer](const QStringList &cacheKeys) {
+        const QString cacheKey = cacheKeys.first();
+        QJsonObject cached;
+        if (!cacheKey.isEmpty() && resultCache()->lookup(cacheKey, cached)) {
+            DetectionResult result = parseDetectionResult(cached);
+            result.inferenceTime = cacheElapsed(timer);
+            emit logMessage(QString("%1完成 (缓存): %2 个结果").arg(actionName).arg(result.detections.size()));
+            emit detectionCompleted(result);
+            return makeReadyFuture(result);
+        }
+
+        DetectionResult errorResult;
+        QJsonObject request;
+        request["command"] = command;
+
+        std::shared_ptr<SharedImageBuffer> sharedImage;
+        if (!prepareInferenceRequest(image, actionName, request, sharedImage, errorResult)) {
+            emit detectionCompleted(errorResult);
+            return makeReadyFuture(errorResult);
+        }
+
+        request["conf_threshold"] = confThreshold;
+        request["iou_threshold"] = iouThreshold;
+        request["image_size"] = imageSize;
+        if (m_binaryFrames) {
+            request["response_format"] = "binary";
+        }
+
+        // 流式分割：分块到达时先发出，最终响应只携带剩余实例。
+        // 已发出的分块不能再删除，流式请求仍由后端完成 NMS
+        auto streamed = std::make_shared<QVector<Detection>>();
+        ResponseHandler partialHandler;
+        const bool clientNms = !(m_streaming && command == "segment");
+        if (clientNms) {
+            request["client_nms"] = true;
+        } else {
+            request["stream"] = true;
+            partialHandler = [this, streamed](const ServiceResponse &chunk) {
+                DetectionResult part = parseDetectionResult(chunk.json, chunk.frame.get());
+                if (!part.success || part.detections.isEmpty()) {
+                    return;
+                }
+                const int firstIndex = streamed->size();
+                *streamed += part.detections;
+                emit segmentationChunk(part.detections, firstIndex);
+            };
+        }
+
+        const QString unit = (command == "segment") ? "个实例" : "个目标";
+        return submitRequest<DetectionResult>(request, [this, timer, actionName, unit, sharedImage, streamed, cacheKey,
+                                                        clientNms, iouThreshold](const ServiceResponse &response) {
+            DetectionResult result = parseDetectionResult(response.json, response.frame.get());
+            if (clientNms) {
+                result = applyClientNms(std::move(result), iouThreshold);
+            }
+            result.inferenceTime = responseElapsed(response.json, timer);
+            if (result.success && !streamed->isEmpty()) {
+                result.detections = *streamed + result.detections;
+            }
+            if (result.success && !cacheKey.isEmpty() && m_resultCache) {
+                m_resultCache->insert(cacheKey, detectionResultToJson(result));
+            }
+
+            if (result.success) {
+                emit logMessage(QString("%1完成: %2 %3, 耗时 %4ms")
+                                .arg(actionName)
+                                .arg(result.detections.size())
+                                .arg(unit)
+                                .arg(result.inferenceTime));
+            }
+
+            emit detectionCompleted(result);
+            return result;
+        }, 0, nullptr, partialHandler);
+    });
+}
+
+ClassificationResultList DLService::parseClassificationResult(const QJsonObject &response)
+{
+    ClassificationResultList result;
+    result.success = response["success"].toBool();
+    result.message = response["message"].toString();
+
+    if (result.success && response.contains("data")) {
+        QJsonObject data = response["data"].toObject();
+        QJsonArray classifications = data["classifications"].toArray();
+
+        for (const QJsonValue &val : classifications) {
+            QJsonObject obj = val.toObject();
+            ClassificationResult cls;
+            cls.rank = obj["rank"].toInt();
+            cls.confidence = static_cast<float>(obj["confidence"].toDouble());
+            cls.classId = obj["class_id"].toInt();
+            cls.label = obj["label"].toString();
+            // FSL 特有字段
+            if (obj.contains("avg_distance")) {
+                cls.avgDistance = static_cast<float>(obj["avg_distance"].toDouble());
+            }
+            if (obj.contains("episode_count")) {
+                cls.episodeCount = obj["episode_count"].toInt();
+            }
+            result.classifications.append(cls);
+        }
+
+        // Set top prediction
+        if (!result.classifications.isEmpty()) {
+            result.topPrediction = result.classifications.first();
+        }
+    }
+
+    return result;
+}
+
+KeypointResult DLService::parseKeypointResult(const QJsonObject &response)
+{
+    KeypointResult result;
+    result.success = response["success"].toBool();
+    result.message = response["message"].toString();
+
+    if (result.success && response.contains("data")) {
+        QJsonObject data = response["data"].toObject();
+        QJsonArray detections = data["detections"].toArray();
+
+        for (const QJsonValue &val : detections) {
+            QJsonObject obj = val.toObject();
             KeypointDetection det;
             det.x = obj["x"].toInt();
             det.y = obj["y"].toInt();
@@ -1084,154 +2279,416 @@ KeypointResult DLService::parseKeypointResult(const QJsonObject &response)
     return result;
 }
 
-ClassificationResultList DLService::classify(const QString &imagePath, int topK)
+ClassificationResultList DLService::classify(const InferenceImage &image, int topK)
 {
-    if (!m_modelLoaded) {
-        ClassificationResultList result;
-        result.success = false;
-        result.message = "模型未加载";
-        emit logMessage(result.message);
-        return result;
-    }
-
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidImagePath(imagePath, errorMsg)) {
-        ClassificationResultList result;
-        result.success = false;
-        result.message = errorMsg;
-        emit logMessage("分类失败: " + errorMsg);
-        emit classificationCompleted(result);
-        return result;
-    }
+    return waitForResult(classifyAsync(image, topK));
+}
 
+QFuture<ClassificationResultList> DLService::classifyAsync(const InferenceImage &image, int topK)
+{
     QElapsedTimer timer;
     timer.start();
 
-    QJsonObject request;
-    request["command"] = "classify";
-    request["image_path"] = imagePath;
-    request["top_k"] = topK;
+    return withResultCacheKeys<ClassificationResultList>("classify", {image}, QJsonObject{{"top_k", topK}},
+        [this, image, topK, timer](const QStringList &cacheKeys) {
+        const QString cacheKey = cacheKeys.first();
+        QJsonObject cached;
+        if (!cacheKey.isEmpty() && resultCache()->lookup(cacheKey, cached)) {
+            ClassificationResultList result = parseClassificationResult(cached);
+            result.inferenceTime = cacheElapsed(timer);
+            emit logMessage(QString("分类完成 (缓存): %1").arg(result.topPrediction.label));
+            emit classificationCompleted(result);
+            return makeReadyFuture(result);
+        }
 
-    QJsonObject response = sendRequest(request);
-    ClassificationResultList result = parseClassificationResult(response);
-    result.inferenceTime = timer.elapsed();
+        ClassificationResultList errorResult;
+        QJsonObject request;
+        request["command"] = "classify";
 
-    if (result.success) {
-        emit logMessage(QString("分类完成: %1 (%2%), 耗时 %3ms")
-                        .arg(result.topPrediction.label)
-                        .arg(static_cast<int>(result.topPrediction.confidence * 100))
-                        .arg(result.inferenceTime));
-    }
+        std::shared_ptr<SharedImageBuffer> sharedImage;
+        if (!prepareInferenceRequest(image, "分类", request, sharedImage, errorResult)) {
+            emit classificationCompleted(errorResult);
+            return makeReadyFuture(errorResult);
+        }
 
-    emit classificationCompleted(result);
-    return result;
+        request["top_k"] = topK;
+
+        return submitRequest<ClassificationResultList>(request, [this, timer, sharedImage, cacheKey](const ServiceResponse &response) {
+            ClassificationResultList result = parseClassificationResult(response.json);
+            result.inferenceTime = responseElapsed(response.json, timer);
+            if (result.success && !cacheKey.isEmpty() && m_resultCache) {
+                m_resultCache->insert(cacheKey, classificationResultToJson(result));
+            }
+
+            if (result.success) {
+                emit logMessage(QString("分类完成: %1 (%2%), 耗时 %3ms")
+                                .arg(result.topPrediction.label)
+                                .arg(static_cast<int>(result.topPrediction.confidence * 100))
+                                .arg(result.inferenceTime));
+            }
+
+            emit classificationCompleted(result);
+            return result;
+        });
+    });
 }
 
-ClassificationResultList DLService::fewShotClassify(const QString &imagePath,
+ClassificationResultList DLService::fewShotClassify(const InferenceImage &image,
                                                     int nWay,
                                                     int nShot,
                                                     int nQuery,
                                                     int imageSize)
 {
-    if (!m_modelLoaded) {
-        ClassificationResultList result;
-        result.success = false;
-        result.message = "模型未加载";
-        emit logMessage(result.message);
-        return result;
-    }
+    return waitForResult(fewShotClassifyAsync(image, nWay, nShot, nQuery, imageSize));
+}
 
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidImagePath(imagePath, errorMsg)) {
-        ClassificationResultList result;
-        result.success = false;
-        result.message = errorMsg;
-        emit logMessage("小样本分类失败: " + errorMsg);
-        emit classificationCompleted(result);
-        return result;
+QFuture<ClassificationResultList> DLService::fewShotClassifyAsync(const InferenceImage &image,
+                                                                  int nWay,
+                                                                  int nShot,
+                                                                  int nQuery,
+                                                                  int imageSize)
+{
+    ClassificationResultList errorResult;
+    QJsonObject request;
+    request["command"] = "few_shot_classify";
+
+    std::shared_ptr<SharedImageBuffer> sharedImage;
+    if (!prepareInferenceRequest(image, "小样本分类", request, sharedImage, errorResult)) {
+        emit classificationCompleted(errorResult);
+        return makeReadyFuture(errorResult);
     }
 
     QElapsedTimer timer;
     timer.start();
 
-    QJsonObject request;
-    request["command"] = "few_shot_classify";
-    request["image_path"] = imagePath;
     request["n_way"] = nWay;
     request["n_shot"] = nShot;
     request["n_query"] = nQuery;
     request["image_size"] = imageSize;
 
     // 调试：输出发送的请求
-    emit logMessage(QString("[调试] 发送请求: %1").arg(QJsonDocument(request).toJson(QJsonDocument::Compact)));
-
-    QJsonObject response = sendRequest(request);
-    ClassificationResultList result = parseClassificationResult(response);
-    result.inferenceTime = timer.elapsed();
-
-    if (result.success) {
-        // 使用 QString::number 保留小数位，避免 static_cast<int> 截断小数值
-        QString confidenceStr = QString::number(result.topPrediction.confidence * 100, 'f', 2);
-        emit logMessage(QString("小样本分类完成: %1 (%2%), 耗时 %3ms")
-                        .arg(result.topPrediction.label.isEmpty() ? "Unknown" : result.topPrediction.label)
-                        .arg(confidenceStr)
-                        .arg(result.inferenceTime));
-    } else {
-        emit logMessage(QString("小样本分类失败: %1").arg(result.message));
-    }
+    emit logMessage(QString("[调试] 发送请求: %1").arg(QString::fromUtf8(QJsonDocument(request).toJson(QJsonDocument::Compact))));
+
+    return submitRequest<ClassificationResultList>(request, [this, timer, sharedImage](const ServiceResponse &response) {
+        ClassificationResultList result = parseClassificationResult(response.json);
+        result.inferenceTime = responseElapsed(response.json, timer);
+
+        if (result.success) {
+            // 使用 QString::number 保留小数位，避免 static_cast<int> 截断小数值
+            QString confidenceStr = QString::number(result.topPrediction.confidence * 100, 'f', 2);
+            emit logMessage(QString("小样本分类完成: %1 (%2%), 耗时 %3ms")
+                            .arg(result.topPrediction.label.isEmpty() ? "Unknown" : result.topPrediction.label)
+                            .arg(confidenceStr)
+                            .arg(result.inferenceTime));
+        } else {
+            emit logMessage(QString("小样本分类失败: %1").arg(result.message));
+        }
 
-    emit classificationCompleted(result);
-    return result;
+        emit classificationCompleted(result);
+        return result;
+    });
 }
 
-KeypointResult DLService::keypoint(const QString &imagePath,
+KeypointResult DLService::keypoint(const InferenceImage &image,
                                           float confThreshold,
                                           float iouThreshold,
                                           int imageSize)
 {
-    if (!m_modelLoaded) {
-        KeypointResult result;
-        result.success = false;
-        result.message = "模型未加载";
-        emit logMessage(result.message);
-        return result;
-    }
+    return waitForResult(keypointAsync(image, confThreshold, iouThreshold, imageSize));
+}
 
-    // 路径安全验证
-    QString errorMsg;
-    if (!FileUtils::isValidImagePath(imagePath, errorMsg)) {
-        KeypointResult result;
-        result.success = false;
-        result.message = errorMsg;
-        emit logMessage("关键点检测失败: " + errorMsg);
-        emit keypointCompleted(result);
-        return result;
+QFuture<KeypointResult> DLService::keypointAsync(const InferenceImage &image,
+                                                 float confThreshold,
+                                                 float iouThreshold,
+                                                 int imageSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QJsonObject params{{"conf_threshold", confThreshold},
+                             {"iou_threshold", iouThreshold},
+                             {"image_size", imageSize}};
+    return withResultCacheKeys<KeypointResult>("keypoint", {image}, params,
+        [this, image, confThreshold, iouThreshold, imageSize, timer](const QStringList &cacheKeys) {
+        const QString cacheKey = cacheKeys.first();
+        QJsonObject cached;
+        if (!cacheKey.isEmpty() && resultCache()->lookup(cacheKey, cached)) {
+            KeypointResult result = parseKeypointResult(cached);
+            result.inferenceTime = cacheElapsed(timer);
+            emit logMessage(QString("关键点检测完成 (缓存): %1 个目标").arg(result.detections.size()));
+            emit keypointCompleted(result);
+            return makeReadyFuture(result);
+        }
+
+        KeypointResult errorResult;
+        QJsonObject request;
+        request["command"] = "keypoint";
+
+        std::shared_ptr<SharedImageBuffer> sharedImage;
+        if (!prepareInferenceRequest(image, "关键点检测", request, sharedImage, errorResult)) {
+            emit keypointCompleted(errorResult);
+            return makeReadyFuture(errorResult);
+        }
+
+        request["conf_threshold"] = confThreshold;
+        request["iou_threshold"] = iouThreshold;
+        request["image_size"] = imageSize;
+
+        auto streamed = std::make_shared<QVector<KeypointDetection>>();
+        ResponseHandler partialHandler;
+        if (m_streaming) {
+            request["stream"] = true;
+            partialHandler = [this, streamed](const ServiceResponse &chunk) {
+                KeypointResult part = parseKeypointResult(chunk.json);
+                if (!part.success || part.detections.isEmpty()) {
+                    return;
+                }
+                const int firstIndex = streamed->size();
+                *streamed += part.detections;
+                emit keypointChunk(part.detections, firstIndex);
+            };
+        }
+
+        return submitRequest<KeypointResult>(request, [this, timer, sharedImage, streamed, cacheKey](const ServiceResponse &response) {
+            KeypointResult result = parseKeypointResult(response.json);
+            result.inferenceTime = responseElapsed(response.json, timer);
+            if (result.success && !streamed->isEmpty()) {
+                result.detections = *streamed + result.detections;
+            }
+            if (result.success && !cacheKey.isEmpty() && m_resultCache) {
+                m_resultCache->insert(cacheKey, keypointResultToJson(result));
+            }
+
+            if (result.success) {
+                emit logMessage(QString("关键点检测完成: %1 个目标, 耗时 %2ms")
+                                .arg(result.detections.size())
+                                .arg(result.inferenceTime));
+            }
+
+            emit keypointCompleted(result);
+            return result;
+        }, 0, nullptr, partialHandler);
+    });
+}
+
+// ========== 批量接口 ==========
+
+template <typename Result>
+QFuture<QVector<Result>> DLService::submitBatch(const QString &command,
+                                                const QString &actionName,
+                                                const QVector<InferenceImage> &images,
+                                                int batchSize,
+                                                const QJsonObject &params,
+                                                std::function<Result(const QJsonObject &, const DetectionFrame *, int)> parse,
+                                                std::function<QJsonObject(const Result &)> toJson)
+{
+    QVector<Result> results(images.size());
+
+    if (!m_modelLoaded) {
+        for (Result &result : results) {
+            result.success = false;
+            result.message = "模型未加载";
+        }
+        emit logMessage("模型未加载");
+        return makeReadyFuture(results);
     }
 
     QElapsedTimer timer;
     timer.start();
 
-    QJsonObject request;
-    request["command"] = "keypoint";
-    request["image_path"] = imagePath;
-    request["conf_threshold"] = confThreshold;
-    request["iou_threshold"] = iouThreshold;
-    request["image_size"] = imageSize;
+    // 与单张接口共用缓存键：任务取单张命令名，参数不含只影响后端流程的 client_nms
+    QString cacheTask = command;
+    cacheTask.chop(QString("_batch").size());
+    QJsonObject cacheParams = params;
+    cacheParams.remove("client_nms");
+
+    return withResultCacheKeys<QVector<Result>>(cacheTask, images, cacheParams,
+        [this, command, actionName, images, batchSize, params, parse, toJson, timer](const QStringList &keys) {
+        // 逐张校验并写入图像字段，缓存命中的直接填入结果，无效图像直接记为失败，均不发送给后端
+        QJsonArray imageItems;
+        QVector<int> sentIndices;
+        QStringList cacheKeys;
+        QVector<std::shared_ptr<SharedImageBuffer>> sharedImages;
+        QVector<Result> results(images.size());
+        int cachedCount = 0;
+        for (int i = 0; i < images.size(); ++i) {
+            const QString &cacheKey = keys[i];
+            QJsonObject cached;
+            if (!cacheKey.isEmpty() && resultCache()->lookup(cacheKey, cached)) {
+                results[i] = parse(cached, nullptr, 0);
+                results[i].inferenceTime = cacheElapsed(timer);
+                ++cachedCount;
+                continue;
+            }
 
-    QJsonObject response = sendRequest(request);
-    KeypointResult result = parseKeypointResult(response);
-    result.inferenceTime = timer.elapsed();
+            QJsonObject item;
+            std::shared_ptr<SharedImageBuffer> sharedImage;
+            if (!prepareInferenceRequest(images[i], actionName, item, sharedImage, results[i])) {
+                continue;
+            }
+            imageItems.append(item);
+            sentIndices.append(i);
+            cacheKeys.append(cacheKey);
+            if (sharedImage) {
+                sharedImages.append(sharedImage);
+            }
+        }
 
-    if (result.success) {
-        emit logMessage(QString("关键点检测完成: %1 个目标, 耗时 %2ms")
-                        .arg(result.detections.size())
-                        .arg(result.inferenceTime));
-    }
+        if (sentIndices.isEmpty()) {
+            if (cachedCount > 0) {
+                emit logMessage(QString("批量%1完成 (缓存): %2/%3")
+                                .arg(actionName)
+                                .arg(cachedCount)
+                                .arg(results.size()));
+            }
+            return makeReadyFuture(results);
+        }
 
-    emit keypointCompleted(result);
-    return result;
+        const int chunkSize = qMax(1, batchSize);
+
+        QJsonObject request = params;
+        request["command"] = command;
+        request["images"] = imageItems;
+        request["batch_size"] = chunkSize;
+        if (m_binaryFrames && (command == "detect_batch" || command == "segment_batch")) {
+            request["response_format"] = "binary";
+        }
+
+        // 超时按小批次数放宽
+        const int chunkCount = (sentIndices.size() + chunkSize - 1) / chunkSize;
+
+        return submitRequest<QVector<Result>>(request,
+            [this, timer, actionName, results, sentIndices, cacheKeys, cachedCount, sharedImages,
+             parse, toJson](const ServiceResponse &response) {
+            QVector<Result> batchResults = results;
+            const bool success = response.json["success"].toBool();
+            const QJsonArray items = response.json["data"].toObject()["results"].toArray();
+            const double totalTime = responseElapsed(response.json, timer);
+            const double perImageTime = totalTime / sentIndices.size();
+
+            int successCount = cachedCount;
+            for (int k = 0; k < sentIndices.size(); ++k) {
+                Result &result = batchResults[sentIndices[k]];
+                if (!success || k >= items.size()) {
+                    result.success = false;
+                    result.message = success ? QString("批量响应缺少结果") : response.json["message"].toString();
+                    continue;
+                }
+
+                result = parse(items[k].toObject(), response.frame.get(), k);
+                result.inferenceTime = perImageTime;
+                if (result.success) {
+                    ++successCount;
+                    if (!cacheKeys[k].isEmpty() && m_resultCache) {
+                        m_resultCache->insert(cacheKeys[k], toJson(result));
+                    }
+                }
+            }
+
+            emit logMessage(QString("批量%1完成: 成功 %2/%3, 耗时 %4ms")
+                            .arg(actionName)
+                            .arg(successCount)
+                            .arg(batchResults.size())
+                            .arg(totalTime));
+            return batchResults;
+        }, REQUEST_TIMEOUT_MS * chunkCount);
+    });
+}
+
+static QJsonObject detectionParams(float confThreshold, float iouThreshold, int imageSize)
+{
+    QJsonObject params;
+    params["conf_threshold"] = confThreshold;
+    params["iou_threshold"] = iouThreshold;
+    params["image_size"] = imageSize;
+    return params;
+}
+
+QVector<DetectionResult> DLService::detectBatch(const QVector<InferenceImage> &images,
+                                                int batchSize,
+                                                float confThreshold,
+                                                float iouThreshold,
+                                                int imageSize)
+{
+    return waitForResult(detectBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize));
+}
+
+QVector<DetectionResult> DLService::segmentBatch(const QVector<InferenceImage> &images,
+                                                 int batchSize,
+                                                 float confThreshold,
+                                                 float iouThreshold,
+                                                 int imageSize)
+{
+    return waitForResult(segmentBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize));
+}
+
+QVector<ClassificationResultList> DLService::classifyBatch(const QVector<InferenceImage> &images,
+                                                           int batchSize,
+                                                           int topK)
+{
+    return waitForResult(classifyBatchAsync(images, batchSize, topK));
+}
+
+QVector<KeypointResult> DLService::keypointBatch(const QVector<InferenceImage> &images,
+                                                 int batchSize,
+                                                 float confThreshold,
+                                                 float iouThreshold,
+                                                 int imageSize)
+{
+    return waitForResult(keypointBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize));
+}
+
+QFuture<QVector<DetectionResult>> DLService::detectBatchAsync(const QVector<InferenceImage> &images,
+                                                              int batchSize,
+                                                              float confThreshold,
+                                                              float iouThreshold,
+                                                              int imageSize)
+{
+    QJsonObject params = detectionParams(confThreshold, iouThreshold, imageSize);
+    params["client_nms"] = true;
+    return submitBatch<DetectionResult>("detect_batch", "检测", images, batchSize, params,
+        [this, iouThreshold](const QJsonObject &item, const DetectionFrame *frame, int index) {
+            return applyClientNms(parseDetectionResult(item, frame, index), iouThreshold);
+        }, detectionResultToJson);
+}
+
+QFuture<QVector<DetectionResult>> DLService::segmentBatchAsync(const QVector<InferenceImage> &images,
+                                                               int batchSize,
+                                                               float confThreshold,
+                                                               float iouThreshold,
+                                                               int imageSize)
+{
+    QJsonObject params = detectionParams(confThreshold, iouThreshold, imageSize);
+    params["client_nms"] = true;
+    return submitBatch<DetectionResult>("segment_batch", "分割", images, batchSize, params,
+        [this, iouThreshold](const QJsonObject &item, const DetectionFrame *frame, int index) {
+            return applyClientNms(parseDetectionResult(item, frame, index), iouThreshold);
+        }, detectionResultToJson);
+}
+
+QFuture<QVector<ClassificationResultList>> DLService::classifyBatchAsync(const QVector<InferenceImage> &images,
+                                                                         int batchSize,
+                                                                         int topK)
+{
+    QJsonObject params;
+    params["top_k"] = topK;
+    return submitBatch<ClassificationResultList>("classify_batch", "分类", images, batchSize, params,
+        [this](const QJsonObject &item, const DetectionFrame *, int) {
+            return parseClassificationResult(item);
+        }, classificationResultToJson);
+}
+
+QFuture<QVector<KeypointResult>> DLService::keypointBatchAsync(const QVector<InferenceImage> &images,
+                                                               int batchSize,
+                                                               float confThreshold,
+                                                               float iouThreshold,
+                                                               int imageSize)
+{
+    return submitBatch<KeypointResult>("keypoint_batch", "关键点检测", images, batchSize,
+        detectionParams(confThreshold, iouThreshold, imageSize),
+        [this](const QJsonObject &item, const DetectionFrame *, int) {
+            return parseKeypointResult(item);
+        }, keypointResultToJson);
 }
 
 } // namespace Utils
@@ -8,13 +8,52 @@
 #include <QVariant>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QImage>
+#include <QHash>
+#include <QQueue>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <functional>
+#include <memory>
+#include <vector>
 #include "environmentcachemanager.h"
+#include "responseframe.h"
+#include "inferenceresultcache.h"
 
 namespace GenPreCVSystem {
 namespace Utils {
 
 // PythonEnvironment 从 environmentcachemanager.h 导入
 
+class SharedImageBuffer;
+class TiledImage;
+
+/**
+ * @brief 推理输入图像
+ *
+ * 可以是图像文件路径，也可以是内存中的 QImage 或分块图像。像素数据通过共享内存
+ * 传给后端，不经过编码和磁盘；此时 path 仅用于日志和结果显示。
+ */
+struct InferenceImage {
+    QString path;
+    QImage image;
+    std::shared_ptr<TiledImage> tiles;   ///< 分块显示的大图，image 为空
+
+    InferenceImage() = default;
+    InferenceImage(const QString &filePath) : path(filePath) {}
+    InferenceImage(const char *filePath) : path(QString::fromUtf8(filePath)) {}
+    InferenceImage(const QImage &pixels, const QString &sourcePath = QString())
+        : path(sourcePath), image(pixels) {}
+    InferenceImage(const std::shared_ptr<TiledImage> &pixels, const QString &sourcePath = QString())
+        : path(sourcePath), tiles(pixels) {}
+
+    bool isEmpty() const { return path.isEmpty() && !inMemory(); }
+    bool inMemory() const { return !image.isNull() || tiles != nullptr; }
+};
+
 /**
  * @brief 掩码点数据
  */
@@ -105,10 +144,34 @@ struct ClassificationResultList {
     double inferenceTime = 0.0;
 };
 
+/**
+ * @brief 在 future 完成后于 context 所在线程回调
+ *
+ * context 销毁时回调不会被调用，适合在界面对象中接收异步推理结果。
+ */
+template <typename Result, typename Callback>
+void onFutureFinished(const QFuture<Result> &future, QObject *context, Callback callback)
+{
+    auto *watcher = new QFutureWatcher<Result>(context);
+    QObject::connect(watcher, &QFutureWatcher<Result>::finished, context,
+                     [watcher, callback]() {
+        callback(watcher->future().result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
 /**
  * @brief 深度学习推理服务
  *
- * 管理 Python 后端服务进程，通过 stdin/stdout 进行通信
+ * 管理 Python 后端服务进程，通过 stdin/stdout 进行通信。
+ *
+ * 每个请求携带递增的 request_id，可同时有多个请求在途（流水线），
+ * 响应在 readyRead 时按 ID 匹配回对应的请求。*Async 接口立即返回
+ * QFuture，同步接口在其之上等待结果。
+ *
+ * 可以启动多个后端进程组成进程池（setWorkerCount），使用同一环境和模型；
+ * 请求派发给在途请求最少的进程，崩溃或无响应的进程会被自动重启并重新加载模型。
  */
 class DLService : public QObject
 {
@@ -206,13 +269,27 @@ public:
     QString getLastUsedModel() const;
 
     /**
-     * @brief 加载模型
+     * @brief 加载模型（同步，阻塞到所有进程加载完成；界面中使用 loadModelAsync）
      * @param modelPath 模型文件路径
      * @param labelsPath 标签文件路径（可选）
      * @return 是否加载成功
      */
     bool loadModel(const QString &modelPath, const QString &labelsPath = QString());
 
+    /**
+     * @brief 在后台预取模型
+     *
+     * 后端按路径和修改时间缓存最近加载的模型（LRU，受内存预算限制），
+     * 预取完成后 loadModel 只需切换当前模型。请求立即返回，服务未运行时忽略。
+     * @param modelPath 模型文件路径
+     */
+    void prefetchModel(const QString &modelPath);
+
+    /**
+     * @brief 获取当前任务类型最近加载过的模型（最近的在前）
+     */
+    QStringList recentModels() const;
+
     /**
      * @brief 设置当前任务类型（用于选择正确的服务脚本）
      * @param task 任务类型
@@ -226,48 +303,48 @@ public:
 
     /**
      * @brief 执行目标检测
-     * @param imagePath 图像文件路径
+     * @param image 图像文件路径或内存图像
      * @param confThreshold 置信度阈值
      * @param iouThreshold IOU 阈值
      * @param imageSize 输入图像尺寸
      * @return 检测结果
      */
-    DetectionResult detect(const QString &imagePath,
+    DetectionResult detect(const InferenceImage &image,
                                 float confThreshold = 0.25f,
                                 float iouThreshold = 0.45f,
                                 int imageSize = 640);
 
     /**
      * @brief 执行实例分割
-     * @param imagePath 图像文件路径
+     * @param image 图像文件路径或内存图像
      * @param confThreshold 置信度阈值
      * @param iouThreshold IOU 阈值
      * @param imageSize 输入图像尺寸
      * @return 分割结果
      */
-    DetectionResult segment(const QString &imagePath,
+    DetectionResult segment(const InferenceImage &image,
                                  float confThreshold = 0.25f,
                                  float iouThreshold = 0.45f,
                                  int imageSize = 640);
 
     /**
      * @brief 执行图像分类
-     * @param imagePath 图像文件路径
+     * @param image 图像文件路径或内存图像
      * @param topK 返回的 top-k 结果数量
      * @return 分类结果
      */
-    ClassificationResultList classify(const QString &imagePath, int topK = 5);
+    ClassificationResultList classify(const InferenceImage &image, int topK = 5);
 
     /**
      * @brief 执行遥感影像小样本分类
-     * @param imagePath 图像文件路径
+     * @param image 图像文件路径或内存图像
      * @param nWay 每轮类别数
      * @param nShot 每类支持样本数
      * @param nQuery 每类查询样本数
      * @param imageSize 输入图像尺寸
      * @return 分类结果
      */
-    ClassificationResultList fewShotClassify(const QString &imagePath,
+    ClassificationResultList fewShotClassify(const InferenceImage &image,
                                              int nWay = 5,
                                              int nShot = 5,
                                              int nQuery = 15,
@@ -275,17 +352,241 @@ public:
 
     /**
      * @brief 执行关键点/姿态检测
-     * @param imagePath 图像文件路径
+     * @param image 图像文件路径或内存图像
      * @param confThreshold 置信度阈值
      * @param iouThreshold IOU 阈值
      * @param imageSize 输入图像尺寸
      * @return 关键点检测结果
      */
-    KeypointResult keypoint(const QString &imagePath,
+    KeypointResult keypoint(const InferenceImage &image,
                                  float confThreshold = 0.25f,
                                  float iouThreshold = 0.45f,
                                  int imageSize = 640);
 
+    // ========== 异步接口 ==========
+
+    /**
+     * @brief 异步发送原始请求
+     * @param request 请求对象（request_id 由服务自动填写）
+     * @return 响应 future
+     */
+    QFuture<QJsonObject> sendRequestAsync(const QJsonObject &request);
+
+    /**
+     * @brief 异步加载模型（参数同 loadModel）
+     *
+     * 每个进程各自加载，全部响应后 future 完成，结果为是否全部成功；
+     * 完成时同样发出 modelLoaded 信号。
+     */
+    QFuture<bool> loadModelAsync(const QString &modelPath, const QString &labelsPath = QString());
+
+    /**
+     * @brief 异步执行目标检测（参数同 detect）
+     */
+    QFuture<DetectionResult> detectAsync(const InferenceImage &image,
+                                         float confThreshold = 0.25f,
+                                         float iouThreshold = 0.45f,
+                                         int imageSize = 640);
+
+    /**
+     * @brief 异步获取目标检测的原始候选框
+     *
+     * 后端以 CANDIDATE_CONF_THRESHOLD 运行模型并跳过 NMS，返回全部候选框。
+     * 之后只调整置信度/IOU 阈值时，用 DetectionPostProcess::filterCandidates
+     * 在本地重新过滤即可，不必再次推理。不发出 detectionCompleted。
+     * @param image 图像文件路径或内存图像
+     * @param imageSize 输入图像尺寸
+     */
+    QFuture<DetectionResult> detectCandidatesAsync(const InferenceImage &image, int imageSize = 640);
+
+    /**
+     * @brief 候选框请求使用的最低置信度（后端参数下限）
+     */
+    static constexpr float CANDIDATE_CONF_THRESHOLD = 0.01f;
+
+    /**
+     * @brief 异步执行实例分割（参数同 segment）
+     */
+    QFuture<DetectionResult> segmentAsync(const InferenceImage &image,
+                                          float confThreshold = 0.25f,
+                                          float iouThreshold = 0.45f,
+                                          int imageSize = 640);
+
+    /**
+     * @brief 异步执行图像分类（参数同 classify）
+     */
+    QFuture<ClassificationResultList> classifyAsync(const InferenceImage &image, int topK = 5);
+
+    /**
+     * @brief 异步执行小样本分类（参数同 fewShotClassify）
+     */
+    QFuture<ClassificationResultList> fewShotClassifyAsync(const InferenceImage &image,
+                                                           int nWay = 5,
+                                                           int nShot = 5,
+                                                           int nQuery = 15,
+                                                           int imageSize = 84);
+
+    /**
+     * @brief 异步执行关键点检测（参数同 keypoint）
+     */
+    QFuture<KeypointResult> keypointAsync(const InferenceImage &image,
+                                          float confThreshold = 0.25f,
+                                          float iouThreshold = 0.45f,
+                                          int imageSize = 640);
+
+    // ========== 批量接口 ==========
+    // images 中的图像按 batchSize 切分为小批次，后端每个小批次只做一次前向推理；
+    // 返回结果与 images 顺序一一对应，单张失败不影响其它图像。
+
+    /**
+     * @brief 批量目标检测
+     * @param images 图像列表（文件路径或内存图像）
+     * @param batchSize 每次前向推理的图像数
+     * @param confThreshold 置信度阈值
+     * @param iouThreshold IOU 阈值
+     * @param imageSize 输入图像尺寸
+     * @return 与 images 对应的检测结果
+     */
+    QVector<DetectionResult> detectBatch(const QVector<InferenceImage> &images,
+                                         int batchSize = 8,
+                                         float confThreshold = 0.25f,
+                                         float iouThreshold = 0.45f,
+                                         int imageSize = 640);
+
+    /**
+     * @brief 批量实例分割（参数同 detectBatch）
+     */
+    QVector<DetectionResult> segmentBatch(const QVector<InferenceImage> &images,
+                                          int batchSize = 8,
+                                          float confThreshold = 0.25f,
+                                          float iouThreshold = 0.45f,
+                                          int imageSize = 640);
+
+    /**
+     * @brief 批量图像分类
+     * @param images 图像列表
+     * @param batchSize 每次前向推理的图像数
+     * @param topK 每张图像返回的 top-k 结果数量
+     */
+    QVector<ClassificationResultList> classifyBatch(const QVector<InferenceImage> &images,
+                                                    int batchSize = 8,
+                                                    int topK = 5);
+
+    /**
+     * @brief 批量关键点检测（参数同 detectBatch）
+     */
+    QVector<KeypointResult> keypointBatch(const QVector<InferenceImage> &images,
+                                          int batchSize = 8,
+                                          float confThreshold = 0.25f,
+                                          float iouThreshold = 0.45f,
+                                          int imageSize = 640);
+
+    /**
+     * @brief 异步批量目标检测（参数同 detectBatch）
+     */
+    QFuture<QVector<DetectionResult>> detectBatchAsync(const QVector<InferenceImage> &images,
+                                                       int batchSize = 8,
+                                                       float confThreshold = 0.25f,
+                                                       float iouThreshold = 0.45f,
+                                                       int imageSize = 640);
+
+    /**
+     * @brief 异步批量实例分割（参数同 detectBatch）
+     */
+    QFuture<QVector<DetectionResult>> segmentBatchAsync(const QVector<InferenceImage> &images,
+                                                        int batchSize = 8,
+                                                        float confThreshold = 0.25f,
+                                                        float iouThreshold = 0.45f,
+                                                        int imageSize = 640);
+
+    /**
+     * @brief 异步批量图像分类（参数同 classifyBatch）
+     */
+    QFuture<QVector<ClassificationResultList>> classifyBatchAsync(const QVector<InferenceImage> &images,
+                                                                  int batchSize = 8,
+                                                                  int topK = 5);
+
+    /**
+     * @brief 异步批量关键点检测（参数同 detectBatch）
+     */
+    QFuture<QVector<KeypointResult>> keypointBatchAsync(const QVector<InferenceImage> &images,
+                                                        int batchSize = 8,
+                                                        float confThreshold = 0.25f,
+                                                        float iouThreshold = 0.45f,
+                                                        int imageSize = 640);
+
+    /**
+     * @brief 设置同时在途的最大请求数（实际值不超过后端声明的上限）
+     */
+    void setMaxInFlight(int count);
+
+    /**
+     * @brief 获取生效的最大在途请求数
+     */
+    int maxInFlight() const;
+
+    /**
+     * @brief 获取所有进程合计的在途请求上限（批量提交时的窗口大小）
+     */
+    int capacity() const;
+
+    /**
+     * @brief 获取尚未完成的请求数（在途 + 排队）
+     */
+    int pendingRequestCount() const;
+
+    /**
+     * @brief 设置后端进程数（下次启动服务时生效）
+     */
+    void setWorkerCount(int count);
+
+    /**
+     * @brief 获取设置的后端进程数
+     */
+    int workerCount() const { return m_workerCount; }
+
+    /**
+     * @brief 获取当前可接收请求的后端进程数
+     */
+    int readyWorkerCount() const;
+
+    /**
+     * @brief 设置分割/关键点请求是否使用流式响应
+     *
+     * 启用后后端在生成结果的过程中分块发回，每块到达时发出
+     * segmentationChunk / keypointChunk，最终结果仍包含全部检测。
+     */
+    void setStreamingEnabled(bool enabled) { m_streaming = enabled; }
+
+    /**
+     * @brief 是否使用流式响应
+     */
+    bool streamingEnabled() const { return m_streaming; }
+
+    /**
+     * @brief 设置是否使用推理结果缓存
+     *
+     * 启用后，同一图像内容、模型（含修改时间）、任务和参数的检测/分割/分类/关键点
+     * 结果保存在缓存目录下，再次请求时直接返回，不经过后端。
+     */
+    void setResultCacheEnabled(bool enabled) { m_resultCacheEnabled = enabled; }
+
+    /**
+     * @brief 是否使用推理结果缓存
+     */
+    bool resultCacheEnabled() const { return m_resultCacheEnabled; }
+
+    /**
+     * @brief 设置推理结果缓存的磁盘占用上限
+     * @param megabytes 上限（MB）
+     */
+    void setResultCacheLimit(int megabytes);
+
+    /**
+     * @brief 清空推理结果缓存
+     */
+    void clearResultCache();
+
 signals:
     /**
      * @brief 服务状态改变信号
@@ -312,21 +613,248 @@ signals:
      */
     void keypointCompleted(const KeypointResult &result);
 
+    /**
+     * @brief 流式分割请求收到一块结果
+     * @param detections 本块的实例
+     * @param firstIndex 本块第一个实例在完整结果中的序号（为 0 表示新的结果开始）
+     */
+    void segmentationChunk(const QVector<Detection> &detections, int firstIndex);
+
+    /**
+     * @brief 流式关键点请求收到一块结果
+     * @param detections 本块的目标
+     * @param firstIndex 本块第一个目标在完整结果中的序号（为 0 表示新的结果开始）
+     */
+    void keypointChunk(const QVector<KeypointDetection> &detections, int firstIndex);
+
     /**
      * @brief 日志消息信号
      */
     void logMessage(const QString &message);
 
+private slots:
+    /**
+     * @brief 检查在途请求是否超时，并重启已退出的后端进程
+     */
+    void checkRequestTimeouts();
+
 private:
+    struct Worker;
+
+    /**
+     * @brief 后端响应
+     *
+     * 文本响应只有 json；二进制帧响应的 json 为帧内元数据，
+     * 检测结果在 frame 中，不再经过 JSON 数组。
+     */
+    struct ServiceResponse {
+        QJsonObject json;
+        std::shared_ptr<const DetectionFrame> frame;
+
+        ServiceResponse(const QJsonObject &object) : json(object) {}
+    };
+
+    using ResponseHandler = std::function<void(const ServiceResponse &)>;
+
+    /**
+     * @brief 待完成的请求
+     */
+    struct PendingRequest {
+        qint64 id = 0;
+        QByteArray payload;
+        ResponseHandler handler;
+        ResponseHandler partialHandler; // 流式请求的分块结果（可为空）
+        QElapsedTimer sentTimer;  // 写入管道后开始计时，收到分块时重新计时
+        int timeoutMs = 0;        // 等待响应的超时时间
+        Worker *target = nullptr; // 指定进程（加载模型等），为空时派发给最空闲的进程
+    };
+
+    /**
+     * @brief 后端进程状态
+     */
+    enum class WorkerState {
+        Starting,    // 进程已就绪，正在重新加载模型，只接收指定给它的请求
+        Ready,       // 可接收任意请求
+        Restarting,  // 进程已退出，等待重启
+        Failed       // 重启次数用尽，不再使用
+    };
+
+    /**
+     * @brief 后端进程
+     */
+    struct Worker {
+        int index = 0;
+        QProcess *process = nullptr;
+        WorkerState state = WorkerState::Ready;
+        QHash<qint64, PendingRequest> inFlight;  // 已写入管道、等待响应
+        QList<qint64> inFlightOrder;             // 写入顺序（兼容不回传 ID 的后端）
+        QByteArray readBuffer;                   // 未处理完的 stdout 数据
+        QElapsedTimer exitTimer;                 // 进程退出后开始计时，用于延迟重启
+        int restartCount = 0;
+    };
+
     /**
      * @brief 发送请求并等待响应
      */
     QJsonObject sendRequest(const QJsonObject &request);
 
+    /**
+     * @brief 请求入队，窗口未满时立即写入管道
+     * @param timeoutMs 超时时间，0 表示使用默认值
+     * @param target 指定处理请求的进程，为空时由 dispatchQueued 选择
+     * @param partialHandler 流式请求的分块处理函数，最终响应仍交给 handler
+     * @return 请求 ID，服务未运行时返回 -1（handler 会立即收到错误响应）
+     */
+    qint64 enqueueRequest(QJsonObject request, ResponseHandler handler, int timeoutMs = 0,
+                          Worker *target = nullptr,
+                          ResponseHandler partialHandler = ResponseHandler());
+
+    /**
+     * @brief 在在途窗口允许的范围内写出排队的请求
+     */
+    void dispatchQueued();
+
+    /**
+     * @brief 选择可接收新请求且在途请求最少的进程
+     */
+    Worker *leastLoadedWorker() const;
+
+    /**
+     * @brief 启动后端进程（不等待就绪）
+     */
+    bool launchWorker(Worker &worker);
+
+    /**
+     * @brief 等待后端进程的就绪响应并接管其输出
+     */
+    bool handshakeWorker(Worker &worker);
+
+    /**
+     * @brief 结束后端进程
+     */
+    void shutdownWorker(Worker &worker);
+
+    /**
+     * @brief 重启已退出的后端进程，并重新加载当前模型
+     */
+    void restartWorker(Worker &worker);
+
+    /**
+     * @brief 后端进程退出：结束其在途请求并安排重启
+     */
+    void onWorkerFinished(Worker *worker);
+
+    /**
+     * @brief 读取后端输出的响应行/帧并分发给对应请求
+     */
+    void onWorkerReadyRead(Worker *worker);
+
+    /**
+     * @brief 处理一行响应
+     */
+    void handleResponseLine(Worker &worker, const QByteArray &line);
+
+    /**
+     * @brief 按 request_id 将响应交给对应的在途请求
+     */
+    void dispatchResponse(Worker &worker, const ServiceResponse &response, qint64 byteSize);
+
+    /**
+     * @brief 同步接口等待任一进程的输出
+     */
+    void waitForWorkerOutput(int msecs);
+
+    /**
+     * @brief 有在途请求或待重启进程时运行检查定时器
+     */
+    void updateHealthTimer();
+
+    /**
+     * @brief 以错误响应结束指定请求
+     */
+    void failRequest(Worker &worker, qint64 id, const QString &message);
+
+    /**
+     * @brief 以错误响应结束进程上的所有在途请求
+     */
+    void failWorkerRequests(Worker &worker, const QString &message);
+
+    /**
+     * @brief 以错误响应结束所有未完成请求
+     */
+    void failAllPending(const QString &message);
+
+    /**
+     * @brief 在当前线程等待 future 完成（同步接口使用）
+     */
+    template <typename Result>
+    Result waitForResult(const QFuture<Result> &future);
+
+    /**
+     * @brief 提交请求并将响应转换为结果 future
+     */
+    template <typename Result>
+    QFuture<Result> submitRequest(const QJsonObject &request,
+                                  std::function<Result(const ServiceResponse &)> finish,
+                                  int timeoutMs = 0,
+                                  Worker *target = nullptr,
+                                  ResponseHandler partialHandler = ResponseHandler());
+
+    /**
+     * @brief 批量请求的共用提交逻辑
+     *
+     * 与对应的单张接口共用推理结果缓存，命中的图像不发送给后端。
+     *
+     * @param params 命令参数（阈值、尺寸等）
+     * @param parse 单张图像响应的解析函数（参数为结果项、二进制帧和图像序号），也用于解析缓存结果
+     * @param toJson 写入缓存时的序列化函数
+     */
+    template <typename Result>
+    QFuture<QVector<Result>> submitBatch(const QString &command,
+                                         const QString &actionName,
+                                         const QVector<InferenceImage> &images,
+                                         int batchSize,
+                                         const QJsonObject &params,
+                                         std::function<Result(const QJsonObject &, const DetectionFrame *, int)> parse,
+                                         std::function<QJsonObject(const Result &)> toJson);
+
+    /**
+     * @brief 构造已完成的结果 future（用于参数校验失败等情况）
+     */
+    template <typename Result>
+    static QFuture<Result> makeReadyFuture(const Result &result);
+
+    /**
+     * @brief 检测与分割共用的提交逻辑
+     */
+    QFuture<DetectionResult> submitDetection(const QString &command,
+                                             const QString &actionName,
+                                             const InferenceImage &image,
+                                             float confThreshold,
+                                             float iouThreshold,
+                                             int imageSize);
+
+    /**
+     * @brief 校验输入并写入请求中的图像字段
+     *
+     * 内存图像写入共享内存并填写 image_shm，文件路径经安全校验后填写 image_path。
+     * sharedImage 需保持到响应返回。
+     * @return 失败时返回 false 并填写 errorResult
+     */
+    template <typename Result>
+    bool prepareInferenceRequest(const InferenceImage &image, const QString &actionName,
+                                 QJsonObject &request,
+                                 std::shared_ptr<SharedImageBuffer> &sharedImage,
+                                 Result &errorResult);
+
     /**
      * @brief 解析检测结果
+     * @param response 响应（或批量结果项）的 JSON
+     * @param frame 二进制帧，非空时从帧中读取第 imageIndex 张图像的检测
      */
-    DetectionResult parseDetectionResult(const QJsonObject &response);
+    DetectionResult parseDetectionResult(const QJsonObject &response,
+                                         const DetectionFrame *frame = nullptr,
+                                         int imageIndex = 0);
 
     /**
      * @brief 解析分类结果
@@ -354,11 +882,97 @@ private:
      */
     QString findCondaPython() const;
 
-    QProcess *m_process;
+    /**
+     * @brief 当前任务是否使用 FSL 服务脚本
+     */
+    bool isFSLTask() const;
+
+    /**
+     * @brief 获取推理结果缓存（首次使用时创建）
+     */
+    InferenceResultCache *resultCache();
+
+    /**
+     * @brief 图像内容哈希在记忆表中的键
+     * @return 缓存未启用、模型未加载或图像不可读时返回空字符串
+     */
+    QString contentHashMemoKey(const InferenceImage &image) const;
+
+    /**
+     * @brief 组合推理结果的缓存键
+     * @param task 命令名
+     * @param contentHash 图像内容哈希
+     * @param params 影响结果的参数
+     * @return 缓存未启用、模型未加载或内容哈希为空时返回空字符串
+     */
+    QString resultCacheKey(const QString &task, const QString &contentHash, const QJsonObject &params) const;
+
+    /**
+     * @brief 取得各图像的缓存键后提交请求
+     *
+     * 内容哈希已在记忆表中时直接调用 submit；否则在线程池中读取像素或文件计算哈希，
+     * 算完后回到主线程再调用 submit，大图和分块图像不在 GUI 线程上整幅读出。
+     *
+     * @param submit 按各图像的缓存键（不使用缓存时为空字符串）查找缓存并提交请求
+     */
+    template <typename Result>
+    QFuture<Result> withResultCacheKeys(const QString &task,
+                                        const QVector<InferenceImage> &images,
+                                        const QJsonObject &params,
+                                        std::function<QFuture<Result>(const QStringList &)> submit);
+
+    /**
+     * @brief future 完成后在主线程执行 next
+     *
+     * 异步调用时由 QFutureWatcher 触发；同步接口没有事件循环，由 waitForResult 轮询执行。
+     */
+    template <typename T>
+    void continueWith(const QFuture<T> &future, std::function<void(const T &)> next);
+
+    /**
+     * @brief 执行 future 已完成的后续步骤
+     */
+    void runContinuations();
+
+    /**
+     * @brief 记录最近加载的模型
+     */
+    void rememberModel(const QString &modelPath);
+
+    /**
+     * @brief 所有进程响应加载请求后更新模型状态并发出 modelLoaded
+     * @param response 汇总的响应（任一进程失败时为失败的响应）
+     * @return 是否加载成功
+     */
+    bool finishModelLoad(const QJsonObject &response, const QString &modelPath, const QString &labelsPath);
+
     bool m_modelLoaded;
     QString m_modelPath;
+    QString m_labelsPath;
     QString m_environmentPath;  // 当前选中的环境路径
     QString m_taskType;         // 当前任务类型（用于选择服务脚本）
+
+    // 进程池
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    int m_workerCount;                         // 设置的进程数
+    bool m_stopping;                           // 正在停止，不再接收和重启
+    QString m_program;                         // 启动后端的程序与参数（重启时复用）
+    QStringList m_arguments;
+
+    // 请求流水线
+    qint64 m_nextRequestId;
+    QQueue<PendingRequest> m_queued;           // 等待在途窗口空出
+    int m_maxInFlight;                         // 客户端设置的每进程在途上限
+    int m_serviceMaxInFlight;                  // 后端声明的在途上限（0 表示未声明）
+    bool m_binaryFrames;                       // 后端支持二进制检测结果帧
+    bool m_streaming;                          // 分割/关键点请求使用流式响应
+
+    // 推理结果缓存
+    std::unique_ptr<InferenceResultCache> m_resultCache;
+    bool m_resultCacheEnabled;
+    qint64 m_resultCacheLimit;                 // 磁盘占用上限（字节）
+    QList<std::function<bool()>> m_continuations;  // 等待 future 的后续步骤，完成时返回 true
+    QTimer *m_timeoutTimer;
 };
 
 } // namespace Utils
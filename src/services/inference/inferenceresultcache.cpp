@@ -0,0 +1,395 @@
+/**
+ * @file inferenceresultcache.cpp
+ * @brief 推理结果持久化缓存实现
+ */
+
+#include "inferenceresultcache.h"
+#include "tiledimage.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+static const int INDEX_VERSION = 1;
+
+// 累计多少次未保存的修改后写回索引
+static const int INDEX_SAVE_INTERVAL = 32;
+
+// 哈希记忆表的上限，超出后整体清空
+static const int MAX_MEMO_ENTRIES = 1024;
+
+// 淘汰后保留的磁盘占用比例，避免每次写入都触发淘汰
+static const double EVICT_TARGET_RATIO = 0.9;
+
+InferenceResultCache::InferenceResultCache(const QString &directory, qint64 maxDiskBytes)
+    : m_directory(directory)
+    , m_maxDiskBytes(maxDiskBytes)
+    , m_diskUsage(0)
+    , m_memory(MEMORY_ENTRIES)
+    , m_unsavedChanges(0)
+{
+    QDir dir(m_directory);
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+    loadIndex();
+}
+
+InferenceResultCache::~InferenceResultCache()
+{
+    if (m_unsavedChanges > 0) {
+        flush();
+    }
+}
+
+QString InferenceResultCache::imageHash(const QImage &image)
+{
+    const QString memoKey = hashMemoKey(image);
+    if (memoKey.isEmpty()) {
+        return QString();
+    }
+
+    QString result = knownHash(memoKey);
+    if (result.isEmpty()) {
+        result = computeImageHash(image);
+        rememberHash(memoKey, result);
+    }
+    return result;
+}
+
+QString InferenceResultCache::imageHash(const TiledImage &image)
+{
+    const QString memoKey = hashMemoKey(image);
+    QString result = knownHash(memoKey);
+    if (result.isEmpty()) {
+        result = computeImageHash(image);
+        rememberHash(memoKey, result);
+    }
+    return result;
+}
+
+QString InferenceResultCache::fileHash(const QString &filePath)
+{
+    const QString memoKey = hashMemoKey(filePath);
+    if (memoKey.isEmpty()) {
+        return QString();
+    }
+
+    QString result = knownHash(memoKey);
+    if (result.isEmpty()) {
+        result = computeFileHash(filePath);
+        rememberHash(memoKey, result);
+    }
+    return result;
+}
+
+QString InferenceResultCache::hashMemoKey(const QImage &image)
+{
+    // 同一份像素数据的 QImage 共享 cacheKey，修改后会变化
+    return image.isNull() ? QString() : QString("image|%1").arg(image.cacheKey());
+}
+
+QString InferenceResultCache::hashMemoKey(const TiledImage &image)
+{
+    return QString("tiled|%1").arg(image.cacheKey());
+}
+
+QString InferenceResultCache::hashMemoKey(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    if (!info.isFile()) {
+        return QString();
+    }
+
+    return QString("file|%1|%2|%3")
+        .arg(info.canonicalFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+QString InferenceResultCache::knownHash(const QString &memoKey) const
+{
+    return m_hashes.value(memoKey);
+}
+
+void InferenceResultCache::rememberHash(const QString &memoKey, const QString &hash)
+{
+    if (memoKey.isEmpty() || hash.isEmpty()) {
+        return;
+    }
+    if (m_hashes.size() >= MAX_MEMO_ENTRIES) {
+        m_hashes.clear();
+    }
+    m_hashes.insert(memoKey, hash);
+}
+
+QString InferenceResultCache::computeImageHash(const QImage &image)
+{
+    if (image.isNull()) {
+        return QString();
+    }
+
+    // 仅用于去重而非安全用途，取速度较快的 MD5
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    const QByteArray header = QString("%1x%2:%3")
+                                  .arg(image.width())
+                                  .arg(image.height())
+                                  .arg(static_cast<int>(image.format()))
+                                  .toLatin1();
+    hash.addData(header);
+
+    const int rowBytes = (image.width() * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y) {
+        hash.addData(reinterpret_cast<const char *>(image.constScanLine(y)), rowBytes);
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString InferenceResultCache::computeImageHash(const TiledImage &image)
+{
+    // 与 QImage 版本的字节序列相同：同样的头部，逐行的有效像素
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    const QByteArray header = QString("%1x%2:%3")
+                                  .arg(image.width())
+                                  .arg(image.height())
+                                  .arg(static_cast<int>(image.format()))
+                                  .toLatin1();
+    hash.addData(header);
+
+    const int rowBytes = image.width() * 4;
+    for (int y = 0; y < image.height(); y += TiledImage::TILE_SIZE) {
+        const QImage band = image.region(QRect(0, y, image.width(), TiledImage::TILE_SIZE));
+        for (int row = 0; row < band.height(); ++row) {
+            hash.addData(reinterpret_cast<const char *>(band.constScanLine(row)), rowBytes);
+        }
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString InferenceResultCache::computeFileHash(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (!hash.addData(&file)) {
+        return QString();
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString InferenceResultCache::makeKey(const QString &contentHash, const QString &modelPath,
+                                      const QString &task, const QJsonObject &params)
+{
+    // 模型文件被覆盖后修改时间或大小变化，旧结果自然失效
+    QFileInfo model(modelPath);
+    const QString modelId = QString("%1|%2|%3")
+                                .arg(model.exists() ? model.canonicalFilePath() : modelPath)
+                                .arg(model.lastModified().toMSecsSinceEpoch())
+                                .arg(model.size());
+
+    // QJsonObject 的键有序，序列化结果稳定
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(contentHash.toUtf8());
+    hash.addData("\n");
+    hash.addData(modelId.toUtf8());
+    hash.addData("\n");
+    hash.addData(task.toUtf8());
+    hash.addData("\n");
+    hash.addData(QJsonDocument(params).toJson(QJsonDocument::Compact));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool InferenceResultCache::lookup(const QString &key, QJsonObject &value)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return false;
+    }
+
+    it->lastAccess = QDateTime::currentMSecsSinceEpoch();
+    ++m_unsavedChanges;
+
+    if (const QJsonObject *cached = m_memory.object(key)) {
+        value = *cached;
+        return true;
+    }
+
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        removeEntry(key);
+        return false;
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (!doc.isObject()) {
+        removeEntry(key);
+        return false;
+    }
+
+    value = doc.object();
+    m_memory.insert(key, new QJsonObject(value));
+    return true;
+}
+
+void InferenceResultCache::insert(const QString &key, const QJsonObject &value)
+{
+    const QByteArray data = QJsonDocument(value).toJson(QJsonDocument::Compact);
+    if (m_maxDiskBytes <= 0 || data.size() > m_maxDiskBytes) {
+        return;
+    }
+
+    QSaveFile file(entryPath(key));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        return;
+    }
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_diskUsage -= it->size;
+    }
+
+    Entry entry;
+    entry.size = data.size();
+    entry.lastAccess = QDateTime::currentMSecsSinceEpoch();
+    m_index.insert(key, entry);
+    m_diskUsage += entry.size;
+    m_memory.insert(key, new QJsonObject(value));
+
+    evict();
+
+    if (++m_unsavedChanges >= INDEX_SAVE_INTERVAL) {
+        flush();
+    }
+}
+
+void InferenceResultCache::clear()
+{
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        QFile::remove(entryPath(it.key()));
+    }
+    m_index.clear();
+    m_memory.clear();
+    m_diskUsage = 0;
+    flush();
+}
+
+void InferenceResultCache::flush()
+{
+    QJsonObject entries;
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        QJsonObject obj;
+        obj["size"] = static_cast<double>(it->size);
+        obj["lastAccess"] = static_cast<double>(it->lastAccess);
+        entries[it.key()] = obj;
+    }
+
+    QJsonObject root;
+    root["version"] = INDEX_VERSION;
+    root["entries"] = entries;
+
+    QSaveFile file(m_directory + "/index.json");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        if (file.commit()) {
+            m_unsavedChanges = 0;
+        }
+    }
+}
+
+void InferenceResultCache::setMaxDiskBytes(qint64 bytes)
+{
+    m_maxDiskBytes = bytes;
+    evict();
+}
+
+QString InferenceResultCache::entryPath(const QString &key) const
+{
+    return m_directory + "/" + key + ".json";
+}
+
+void InferenceResultCache::loadIndex()
+{
+    QFile file(m_directory + "/index.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != INDEX_VERSION) {
+        return;
+    }
+
+    // 键来自 makeKey（SHA-1 十六进制），其余内容一律忽略，避免拼出目录外的路径
+    static const QRegularExpression keyPattern("^[0-9a-f]{40}$");
+
+    const QJsonObject entries = root["entries"].toObject();
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (!keyPattern.match(it.key()).hasMatch()) {
+            continue;
+        }
+        const QJsonObject obj = it.value().toObject();
+        Entry entry;
+        entry.size = static_cast<qint64>(obj["size"].toDouble());
+        entry.lastAccess = static_cast<qint64>(obj["lastAccess"].toDouble());
+        if (entry.size <= 0) {
+            continue;
+        }
+        m_index.insert(it.key(), entry);
+        m_diskUsage += entry.size;
+    }
+
+    evict();
+}
+
+void InferenceResultCache::removeEntry(const QString &key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return;
+    }
+    m_diskUsage -= it->size;
+    m_index.erase(it);
+    m_memory.remove(key);
+    QFile::remove(entryPath(key));
+    ++m_unsavedChanges;
+}
+
+void InferenceResultCache::evict()
+{
+    if (m_diskUsage <= m_maxDiskBytes) {
+        return;
+    }
+
+    QVector<QPair<qint64, QString>> byAccess;
+    byAccess.reserve(m_index.size());
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it) {
+        byAccess.append(qMakePair(it->lastAccess, it.key()));
+    }
+    std::sort(byAccess.begin(), byAccess.end());
+
+    const qint64 target = static_cast<qint64>(m_maxDiskBytes * EVICT_TARGET_RATIO);
+    for (const auto &item : byAccess) {
+        if (m_diskUsage <= target) {
+            break;
+        }
+        removeEntry(item.second);
+    }
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
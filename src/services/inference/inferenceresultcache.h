@@ -0,0 +1,144 @@
+#ifndef INFERENCERESULTCACHE_H
+#define INFERENCERESULTCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QJsonObject>
+#include <QString>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+class TiledImage;
+
+/**
+ * @brief 推理结果持久化缓存
+ *
+ * 以（图像内容哈希, 模型路径 + 修改时间, 任务, 推理参数）为键缓存推理结果，
+ * 同一张图像用相同模型和参数重复推理时直接返回，不再经过后端。
+ *
+ * 每个结果保存为缓存目录下的一个 JSON 文件，index.json 记录各条目的大小和
+ * 最近访问时间；磁盘总量超过上限时按最近最少使用淘汰。最近访问的结果
+ * 同时保留在内存中，命中时不读盘。
+ *
+ * 非线程安全，由 DLService 在主线程使用；只有 compute*Hash() 可在工作线程调用。
+ */
+class InferenceResultCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_DISK_BYTES = 256LL * 1024 * 1024;
+    static constexpr int MEMORY_ENTRIES = 256;
+
+    /**
+     * @param directory 缓存目录（不存在时创建）
+     * @param maxDiskBytes 磁盘占用上限
+     */
+    explicit InferenceResultCache(const QString &directory,
+                                  qint64 maxDiskBytes = DEFAULT_MAX_DISK_BYTES);
+    ~InferenceResultCache();
+
+    InferenceResultCache(const InferenceResultCache &) = delete;
+    InferenceResultCache &operator=(const InferenceResultCache &) = delete;
+
+    /**
+     * @brief 内存图像的内容哈希（按有效像素计算，忽略行尾填充）
+     */
+    QString imageHash(const QImage &image);
+
+    /**
+     * @brief 分块图像的内容哈希，按行条读取计算，与整幅读出后的 imageHash() 相同
+     */
+    QString imageHash(const TiledImage &image);
+
+    /**
+     * @brief 图像文件的内容哈希，文件未变化时复用上次的结果
+     * @return 文件不可读时返回空字符串
+     */
+    QString fileHash(const QString &filePath);
+
+    /**
+     * @brief 内容哈希记忆表的键（像素或文件变化后随之改变）
+     * @return 空图像或路径不是文件时返回空字符串
+     */
+    static QString hashMemoKey(const QImage &image);
+    static QString hashMemoKey(const TiledImage &image);
+    static QString hashMemoKey(const QString &filePath);
+
+    /**
+     * @brief 已记住的内容哈希，未计算过时返回空字符串（不读取像素或文件）
+     */
+    QString knownHash(const QString &memoKey) const;
+
+    /**
+     * @brief 记住在其他线程计算出的内容哈希
+     */
+    void rememberHash(const QString &memoKey, const QString &hash);
+
+    /**
+     * @brief 计算内容哈希，不经过记忆表，可在任意线程调用
+     */
+    static QString computeImageHash(const QImage &image);
+    static QString computeImageHash(const TiledImage &image);
+    static QString computeFileHash(const QString &filePath);
+
+    /**
+     * @brief 组合缓存键
+     * @param contentHash imageHash / fileHash 的结果
+     * @param modelPath 模型文件路径（键中包含其修改时间和大小）
+     * @param task 任务（命令名）
+     * @param params 影响结果的参数（阈值、尺寸、标签文件等）
+     */
+    static QString makeKey(const QString &contentHash, const QString &modelPath,
+                           const QString &task, const QJsonObject &params);
+
+    /**
+     * @brief 查找缓存结果
+     * @return 是否命中
+     */
+    bool lookup(const QString &key, QJsonObject &value);
+
+    /**
+     * @brief 写入缓存结果，超出上限时淘汰最久未访问的条目
+     */
+    void insert(const QString &key, const QJsonObject &value);
+
+    /**
+     * @brief 删除所有缓存结果
+     */
+    void clear();
+
+    /**
+     * @brief 将索引写回磁盘
+     */
+    void flush();
+
+    void setMaxDiskBytes(qint64 bytes);
+    qint64 maxDiskBytes() const { return m_maxDiskBytes; }
+    qint64 diskUsage() const { return m_diskUsage; }
+    int entryCount() const { return m_index.size(); }
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 lastAccess = 0;  // 毫秒时间戳
+    };
+
+    QString entryPath(const QString &key) const;
+    void loadIndex();
+    void removeEntry(const QString &key);
+    void evict();
+
+    QString m_directory;
+    qint64 m_maxDiskBytes;
+    qint64 m_diskUsage;
+    QHash<QString, Entry> m_index;
+    QCache<QString, QJsonObject> m_memory;
+    QHash<QString, QString> m_hashes;       // hashMemoKey() -> 内容哈希
+    int m_unsavedChanges;
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // INFERENCERESULTCACHE_H
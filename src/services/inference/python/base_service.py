@@ -3,8 +3,8 @@
 深度学习服务基类
 
 提供通用的服务功能，包括：
-- JSON IPC 通信协议
-- 请求/响应处理
+- JSON IPC 通信协议（检测结果可协商使用二进制帧）
+- 请求/响应处理（按 request_id 回传，支持多个请求同时在途）
 - 错误处理和日志
 - 服务生命周期管理
 
@@ -15,6 +15,12 @@
 import sys
 import json
 import os
+import queue
+import struct
+import threading
+import time
+from array import array
+from collections import OrderedDict
 from abc import ABC, abstractmethod
 from typing import Dict, Any
 
@@ -22,6 +28,141 @@ from typing import Dict, Any
 os.environ['KMP_DUPLICATE_LIB_OK'] = 'TRUE'
 
 
+# 二进制检测结果帧（布局见 C++ 端 responseframe.h）
+FRAME_MAGIC = b"GPCF"
+FRAME_VERSION = 1
+FRAME_HEADER = struct.Struct("<4sHHIIIIII")  # 32 字节，小端
+
+
+def _strip_detections(entry: Dict[str, Any]) -> Dict[str, Any]:
+    """复制响应并去掉 data.detections（检测结果改由帧内数组携带）"""
+    stripped = dict(entry)
+    data = entry.get("data")
+    if isinstance(data, dict):
+        stripped["data"] = {key: value for key, value in data.items() if key != "detections"}
+    return stripped
+
+
+def encode_detection_frame(response: Dict[str, Any]):
+    """
+    将检测/分割响应编码为二进制帧
+
+    支持单图响应（data.detections）和批量响应（data.results[*].data.detections）。
+    响应不是检测结构（或包含关键点等帧不承载的字段）时返回 None，调用方回退到 JSON。
+    """
+    data = response.get("data")
+    if not isinstance(data, dict):
+        return None
+
+    batched = isinstance(data.get("results"), list)
+    if batched:
+        entries = data["results"]
+    elif isinstance(data.get("detections"), list):
+        entries = [response]
+    else:
+        return None
+
+    image_offsets = array("I", [0])
+    boxes = array("f")
+    scores = array("f")
+    class_ids = array("i")
+    vertex_offsets = array("I", [0])
+    vertices = array("f")
+    labels = {}
+
+    for entry in entries:
+        entry_data = entry.get("data") if isinstance(entry, dict) else None
+        detections = entry_data.get("detections", []) if isinstance(entry_data, dict) else []
+        for det in detections:
+            if "keypoints" in det:
+                return None
+            boxes.extend((det["x"], det["y"], det["width"], det["height"]))
+            scores.append(det["confidence"])
+            class_ids.append(det["class_id"])
+            labels[str(det["class_id"])] = det.get("label", "")
+            for point in det.get("mask_polygon") or ():
+                vertices.append(point["x"])
+                vertices.append(point["y"])
+            vertex_offsets.append(len(vertices) // 2)
+        image_offsets.append(len(scores))
+
+    meta = _strip_detections(response)
+    if batched:
+        meta["data"]["results"] = [
+            _strip_detections(entry) if isinstance(entry, dict) else entry for entry in entries
+        ]
+    meta["labels"] = labels
+
+    meta_bytes = json.dumps(meta, ensure_ascii=False).encode("utf-8")
+    padding = b" " * (-len(meta_bytes) % 4)
+
+    arrays = (image_offsets, boxes, scores, class_ids, vertex_offsets, vertices)
+    if sys.byteorder == "big":
+        for values in arrays:
+            values.byteswap()
+
+    payload = b"".join([meta_bytes, padding] + [values.tobytes() for values in arrays])
+    header = FRAME_HEADER.pack(
+        FRAME_MAGIC, FRAME_VERSION, 0,
+        len(meta_bytes), len(image_offsets) - 1, len(scores), len(vertices) // 2,
+        len(payload), 0
+    )
+    return header + payload
+
+
+class ResultStream:
+    """
+    流式请求的分块发送器
+
+    请求携带 "stream": true 时，处理函数每得到一个结果就 add()，
+    首个结果立即以 {"partial": true, "data": {"detections": [...], "offset": n}}
+    发出，之后按数量或时间间隔合并成块发送；finish() 返回尚未发送的结果，
+    由最终响应携带。非流式请求中 add() 只做累积，finish() 返回全部结果。
+    """
+
+    FLUSH_COUNT = 32        # 累积到该数量立即发送
+    FLUSH_INTERVAL = 0.05   # 距上次发送超过该秒数时发送
+
+    def __init__(self, service: "BaseService", request_id=None, binary: bool = False):
+        self._service = service
+        self._request_id = request_id
+        self._binary = binary
+        self._pending = []
+        self._last_flush = time.perf_counter()
+        self.sent = 0
+
+    @property
+    def enabled(self) -> bool:
+        return self._request_id is not None
+
+    @property
+    def total(self) -> int:
+        return self.sent + len(self._pending)
+
+    def add(self, item: Dict[str, Any]):
+        self._pending.append(item)
+        if not self.enabled:
+            return
+        if (self.sent == 0 or len(self._pending) >= self.FLUSH_COUNT
+                or time.perf_counter() - self._last_flush >= self.FLUSH_INTERVAL):
+            self._flush()
+
+    def finish(self) -> list:
+        remaining, self._pending = self._pending, []
+        return remaining
+
+    def _flush(self):
+        chunk = {
+            "success": True,
+            "partial": True,
+            "data": {"detections": self._pending, "offset": self.sent}
+        }
+        self._service.send_response(chunk, self._request_id, binary=self._binary)
+        self.sent += len(self._pending)
+        self._pending = []
+        self._last_flush = time.perf_counter()
+
+
 class BaseService(ABC):
     """深度学习服务基类"""
 
@@ -29,12 +170,15 @@ class BaseService(ABC):
     VERSION = "1.0.0"
     DEFAULT_ENCODING = 'utf-8'
     MAX_REQUEST_SIZE = 10 * 1024 * 1024  # 10MB 最大请求大小
+    MAX_IN_FLIGHT = 8  # 建议客户端同时在途的最大请求数
 
     def __init__(self, service_name: str):
         self.service_name = service_name
         self.running = False
         self.request_count = 0
         self.error_count = 0
+        self._stream_request_id = None
+        self._stream_binary = False
 
     @abstractmethod
     def handle_command(self, command: str, request: Dict[str, Any]) -> Dict[str, Any]:
@@ -105,10 +249,39 @@ class BaseService(ABC):
             response["error_detail"] = error_detail
         return response
 
-    def send_response(self, response: Dict[str, Any]):
-        """发送响应到 stdout"""
+    def send_response(self, response: Dict[str, Any], request_id=None, binary: bool = False):
+        """
+        发送响应到 stdout（带上请求 ID，便于客户端匹配在途请求）
+
+        binary 为 True 且响应是检测结构时以二进制帧发送，否则发送一行 JSON。
+        """
+        if request_id is not None:
+            response["request_id"] = request_id
+
+        if binary:
+            frame = encode_detection_frame(response)
+            if frame is not None:
+                # 先清空文本缓冲；帧前的换行保证 magic 位于行首
+                sys.stdout.flush()
+                sys.stdout.buffer.write(b"\n" + frame)
+                sys.stdout.buffer.flush()
+                return
+
         print(json.dumps(response, ensure_ascii=False), flush=True)
 
+    def _read_requests(self, requests: "queue.Queue"):
+        """
+        stdin 读取线程
+
+        持续读取请求行放入队列，使客户端可以连续写入多个请求，
+        不必等待上一个响应返回。读到 EOF 时放入 None 作为结束标记。
+        """
+        try:
+            for line in sys.stdin:
+                requests.put(line)
+        finally:
+            requests.put(None)
+
     def run(self):
         """运行服务主循环"""
         self.running = True
@@ -118,14 +291,24 @@ class BaseService(ABC):
             message=f"{self.service_name} 服务已启动",
             data={
                 "version": self.VERSION,
+                "max_in_flight": self.MAX_IN_FLIGHT,
+                "response_formats": ["json", "binary"],
                 **self.get_service_info()
             }
         )
         self.send_response(ready_response)
 
+        requests = queue.Queue()
+        reader = threading.Thread(target=self._read_requests, args=(requests,), daemon=True)
+        reader.start()
+
         # 主循环
         try:
-            for line in sys.stdin:
+            while True:
+                line = requests.get()
+                if line is None:
+                    break
+
                 line = line.strip()
                 if not line:
                     continue
@@ -148,28 +331,38 @@ class BaseService(ABC):
                 valid, error_msg = self.validate_request(request)
                 if not valid:
                     self.error_count += 1
-                    self.send_response(self.create_error_response(error_msg))
+                    self.send_response(self.create_error_response(error_msg), request.get("request_id"))
                     continue
 
                 command = request.get("command", "")
+                request_id = request.get("request_id")
 
                 # 处理退出命令
                 if command == "exit":
-                    self.send_response(self.create_success_response("服务已停止"))
+                    self.send_response(self.create_success_response("服务已停止"), request_id)
                     self.running = False
                     break
 
-                # 处理具体命令
+                # 处理具体命令（流式请求需要 request_id 才能匹配分块）
+                binary = request.get("response_format") == "binary"
+                if request.get("stream") and request_id is not None:
+                    self._stream_request_id = request_id
+                    self._stream_binary = binary
+                start_time = time.perf_counter()
                 try:
                     response = self.handle_command(command, request)
-                    self.send_response(response)
                 except Exception as e:
                     self.error_count += 1
                     import traceback
-                    self.send_response(self.create_error_response(
+                    response = self.create_error_response(
                         f"处理错误: {str(e)}",
                         traceback.format_exc()
-                    ))
+                    )
+                finally:
+                    self._stream_request_id = None
+                    self._stream_binary = False
+                response["elapsed_ms"] = round((time.perf_counter() - start_time) * 1000.0, 2)
+                self.send_response(response, request_id, binary=binary)
 
         except KeyboardInterrupt:
             self.send_response(self.create_success_response("服务被中断"))
@@ -182,11 +375,165 @@ class BaseService(ABC):
         finally:
             self.cleanup()
 
+    def open_stream(self) -> ResultStream:
+        """
+        为当前请求创建结果分块发送器
+
+        只有携带 stream 的单图请求会真正分块发送，其余情况退化为普通累积。
+        """
+        return ResultStream(self, self._stream_request_id, self._stream_binary)
+
     def cleanup(self):
         """清理资源，子类可重写"""
         pass
 
 
+class ModelCache:
+    """
+    已加载模型的 LRU 驻留缓存
+
+    以 (真实路径, 修改时间, 文件大小) 为键，文件被覆盖后自动视为新模型。
+    按估算的内存占用（参数 + 缓冲区字节数，无法估算时取文件大小）限制总量，
+    超出预算时淘汰最久未使用的条目，当前使用中的模型永不淘汰。
+    prefetch() 在后台线程加载，acquire() 命中正在预取的条目时等待其完成；
+    预取完成的模型放在最近使用一端，加入时不会被自身触发的淘汰选中。
+    """
+
+    DEFAULT_BUDGET_MB = 2048
+    MAX_ENTRIES = 8
+
+    def __init__(self, loader, budget_mb: int = None):
+        self._loader = loader
+        if budget_mb is None:
+            try:
+                budget_mb = int(os.environ.get("GPCV_MODEL_CACHE_MB", self.DEFAULT_BUDGET_MB))
+            except ValueError:
+                budget_mb = self.DEFAULT_BUDGET_MB
+        self.budget_bytes = max(0, budget_mb) * 1024 * 1024
+        self._entries = OrderedDict()   # key -> (model, size_bytes)
+        self._pending = {}              # key -> threading.Event（正在预取）
+        self._active_key = None
+        self._lock = threading.Lock()
+        self._prefetch_thread = None
+        self._prefetch_queue = queue.Queue()
+
+    @staticmethod
+    def make_key(model_path: str):
+        st = os.stat(model_path)
+        return (os.path.realpath(model_path), st.st_mtime_ns, st.st_size)
+
+    @staticmethod
+    def estimate_size(model, model_path: str) -> int:
+        """估算模型常驻内存字节数"""
+        try:
+            module = getattr(model, "model", model)
+            total = 0
+            for tensor in list(module.parameters()) + list(module.buffers()):
+                total += tensor.numel() * tensor.element_size()
+            if total > 0:
+                return total
+        except Exception:
+            pass
+        return os.path.getsize(model_path)
+
+    def set_budget_mb(self, budget_mb: int):
+        with self._lock:
+            self.budget_bytes = max(0, int(budget_mb)) * 1024 * 1024
+            self._evict_locked()
+
+    def contains(self, model_path: str) -> bool:
+        try:
+            key = self.make_key(model_path)
+        except OSError:
+            return False
+        with self._lock:
+            return key in self._entries
+
+    def acquire(self, model_path: str):
+        """
+        取得模型并标记为当前使用，返回 (model, cached)
+
+        未缓存时同步加载；加载异常原样抛出。
+        """
+        key = self.make_key(model_path)
+        with self._lock:
+            pending = self._pending.get(key)
+        if pending is not None:
+            pending.wait()
+
+        with self._lock:
+            entry = self._entries.get(key)
+            if entry is not None:
+                self._entries.move_to_end(key)
+                self._active_key = key
+                # 预取时为它保留的空间此时才从其它条目中腾出
+                self._evict_locked()
+                return entry[0], True
+
+        model = self._loader(model_path)
+        size = self.estimate_size(model, model_path)
+        with self._lock:
+            self._entries[key] = (model, size)
+            self._entries.move_to_end(key)
+            self._active_key = key
+            self._evict_locked()
+        return model, False
+
+    def prefetch(self, model_path: str) -> bool:
+        """
+        后台预取模型，返回是否新排入了加载任务（已缓存或正在预取时返回 False）
+        """
+        key = self.make_key(model_path)
+        with self._lock:
+            if key in self._entries or key in self._pending:
+                return False
+            self._pending[key] = threading.Event()
+            if self._prefetch_thread is None:
+                self._prefetch_thread = threading.Thread(target=self._prefetch_loop, daemon=True)
+                self._prefetch_thread.start()
+        self._prefetch_queue.put((key, model_path))
+        return True
+
+    def stats(self) -> Dict[str, Any]:
+        with self._lock:
+            return {
+                "cached_models": [key[0] for key in self._entries],
+                "cache_bytes": sum(size for _, size in self._entries.values()),
+                "cache_budget_bytes": self.budget_bytes,
+            }
+
+    def _prefetch_loop(self):
+        while True:
+            key, model_path = self._prefetch_queue.get()
+            try:
+                model = self._loader(model_path)
+                size = self.estimate_size(model, model_path)
+                with self._lock:
+                    self._entries[key] = (model, size)
+                    # 预取的模型即将被使用，放在最近使用一端，本次淘汰也不选它
+                    self._entries.move_to_end(key)
+                    self._evict_locked(keep=key)
+                print(f"模型预取完成: {model_path}", file=sys.stderr)
+            except Exception as e:
+                print(f"警告: 模型预取失败 {model_path}: {e}", file=sys.stderr)
+            finally:
+                with self._lock:
+                    event = self._pending.pop(key, None)
+                if event is not None:
+                    event.set()
+
+    def _evict_locked(self, keep=None):
+        total = sum(size for _, size in self._entries.values())
+        for key in list(self._entries.keys()):
+            if total <= self.budget_bytes and len(self._entries) <= self.MAX_ENTRIES:
+                break
+            if key == self._active_key or key == keep:
+                continue
+            _, size = self._entries.pop(key)
+            total -= size
+            print(f"模型缓存淘汰: {key[0]}", file=sys.stderr)
+
+
 class ModelServiceMixin:
     """模型服务混入类，提供通用的模型加载功能"""
 
@@ -311,6 +658,97 @@ class ImageServiceMixin:
 
         return True, ""
 
+    # 共享内存像素格式 -> 转为 BGR 时的通道顺序（与 ultralytics 的 numpy 输入约定一致）
+    SHARED_PIXEL_FORMATS = {
+        "bgra8888": [0, 1, 2],
+        "rgba8888": [2, 1, 0],
+    }
+
+    def resolve_image_input(self, request: Dict[str, Any]) -> tuple:
+        """
+        解析请求中的输入图像
+
+        请求携带 image_shm 时直接从共享内存读取原始像素，否则按 image_path 读取文件。
+
+        Returns:
+            (图像路径或 BGR numpy 数组, 错误信息)
+        """
+        descriptor = request.get("image_shm")
+        if isinstance(descriptor, dict):
+            return self.read_shared_image(descriptor)
+
+        image_path = request.get("image_path", "")
+        valid, error_msg = self.validate_image_path(image_path)
+        if not valid:
+            return None, error_msg
+        return image_path, ""
+
+    @staticmethod
+    def _open_shared_memory(name: str):
+        """以只读方式附加到 C++ 端创建的共享内存（生命周期由 C++ 端管理）"""
+        from multiprocessing import shared_memory
+        try:
+            return shared_memory.SharedMemory(name=name, create=False, track=False)
+        except TypeError:
+            # Python < 3.13 没有 track 参数，需要手动取消 resource_tracker 登记，
+            # 否则进程退出时会误删或告警
+            shm = shared_memory.SharedMemory(name=name, create=False)
+            if os.name == "posix":
+                from multiprocessing import resource_tracker
+                resource_tracker.unregister(shm._name, "shared_memory")
+            return shm
+
+    def read_shared_image(self, descriptor: Dict[str, Any]) -> tuple:
+        """
+        从共享内存读取 C++ 端写入的 QImage 像素
+
+        descriptor 包含 name、width、height、stride(bytesPerLine)、format。
+        仅做一次通道重排拷贝得到连续的 BGR 数组，不经过任何编解码。
+
+        Returns:
+            (BGR numpy 数组, 错误信息)
+        """
+        try:
+            import numpy as np
+        except ImportError as e:
+            return None, f"缺少 numpy: {e}"
+
+        name = str(descriptor.get("name", ""))
+        pixel_format = str(descriptor.get("format", ""))
+        try:
+            width = int(descriptor.get("width", 0))
+            height = int(descriptor.get("height", 0))
+            stride = int(descriptor.get("stride", 0))
+        except (TypeError, ValueError):
+            return None, "共享图像描述无效"
+
+        channel_order = self.SHARED_PIXEL_FORMATS.get(pixel_format)
+        if channel_order is None:
+            return None, f"不支持的像素格式: {pixel_format}"
+        if not name or width <= 0 or height <= 0 or stride < width * 4:
+            return None, "共享图像描述无效"
+        if width * height > self.MAX_IMAGE_PIXELS:
+            return None, f"图像尺寸过大: {width}x{height}"
+
+        try:
+            shm = self._open_shared_memory(name)
+        except (OSError, ValueError) as e:
+            return None, f"无法打开共享内存 {name}: {e}"
+
+        view = None
+        try:
+            if shm.size < stride * height:
+                return None, "共享内存大小不足"
+            view = np.ndarray((height, width, 4), dtype=np.uint8, buffer=shm.buf,
+                              strides=(stride, 4, 1))
+            image = view[:, :, channel_order]  # 花式索引会产生连续拷贝
+        finally:
+            # 必须先释放对缓冲区的引用才能关闭映射
+            del view
+            shm.close()
+
+        return image, ""
+
     def get_image_info(self, image_path: str) -> Dict[str, Any]:
         """获取图像信息"""
         try:
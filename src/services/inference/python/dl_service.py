@@ -21,13 +21,42 @@
         "labels_path": "path/to/labels.txt"  // 可选
     }
 
+    // 最近加载过且文件未修改的模型保留在内存中（LRU，总量受 cache_budget_mb /
+    // 环境变量 GPCV_MODEL_CACHE_MB 限制），再次 load_model 时直接切换，响应 data.cached 为 true
+
+    {
+        "command": "prefetch_model",    // 后台加载进缓存，立即返回
+        "model_path": "path/to/next_model.pt"
+    }
+
     {
         "command": "detect",
+        "request_id": 42,                // 可选，原样回传于响应中
         "image_path": "path/to/image.jpg",
+        // 或者以共享内存传入原始像素（优先于 image_path）:
+        // "image_shm": {"name": "gpcv_1234_1", "width": 1920, "height": 1080,
+        //               "stride": 7680, "format": "bgra8888"},
         "conf_threshold": 0.25,
         "iou_threshold": 0.45,
         "image_size": 640
     }
+    // detect 请求携带 "raw_candidates": true 时不做 NMS，返回 conf_threshold 以上的全部
+    // 候选框（data.raw_candidates 为 true），客户端调整阈值时在本地重新过滤
+    // detect / segment 及其批量请求携带 "client_nms": true 时跳过跨类别 NMS 保险措施
+    // （模型内置的按类别 NMS 仍执行），由客户端的原生实现完成
+
+    {
+        "command": "detect_batch",      // 另有 segment_batch / classify_batch / keypoint_batch
+        "images": [{"image_path": "a.jpg"}, {"image_shm": {...}}],
+        "batch_size": 8,
+        "conf_threshold": 0.25, "iou_threshold": 0.45, "image_size": 640
+    }
+    // 响应 data.results 为与 images 对应的单图响应数组
+
+    segment / keypoint 请求携带 "stream": true 时，结果在生成过程中分块发出：
+        {"success": true, "partial": true, "request_id": 42,
+         "data": {"detections": [...], "offset": 0}}
+    最终响应的 data.detections 只包含尚未分块发出的结果，data.count 为总数。
 
     {
         "command": "exit"
@@ -37,8 +66,17 @@
     {
         "success": true/false,
         "message": "状态消息",
-        "data": { ... }  // 具体数据
+        "data": { ... },  // 具体数据
+        "request_id": 42,  // 请求携带时回传
+        "elapsed_ms": 12.3  // 服务端处理耗时
     }
+
+    客户端可以不等待响应连续写入多个请求（上限见就绪响应中的
+    max_in_flight），响应按 request_id 匹配。
+
+    检测/分割请求（含批量）携带 "response_format": "binary" 时，响应改为
+    二进制帧：帧头 + JSON 元数据 + float32 框/置信度数组 + 扁平顶点数组，
+    就绪响应的 response_formats 声明是否支持。布局见 base_service.py。
 """
 
 import sys
@@ -48,7 +86,7 @@ from pathlib import Path
 from typing import Dict, Any
 
 # 导入基类
-from base_service import BaseService, ModelServiceMixin, ImageServiceMixin
+from base_service import BaseService, ModelServiceMixin, ImageServiceMixin, ModelCache, ResultStream
 
 # 尝试导入 ultralytics
 try:
@@ -97,10 +135,20 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
     MAX_IMAGE_SIZE = 4096
     MAX_TOP_K = 1000
 
+    # 每张图像的最大检测数（ultralytics 默认 300）；原始候选框未经 NMS，数量多得多
+    DEFAULT_MAX_DETECTIONS = 300
+    RAW_MAX_DETECTIONS = 10000
+
+    # 批量推理限制
+    DEFAULT_BATCH_SIZE = 8
+    MAX_BATCH_SIZE = 64
+    MAX_BATCH_IMAGES = 1024
+
     def __init__(self):
         BaseService.__init__(self, "DL")
         ModelServiceMixin.__init__(self)
         ImageServiceMixin.__init__(self)
+        self.model_cache = ModelCache(YOLO if HAS_ULTRALYTICS else None)
 
     def get_service_info(self) -> Dict[str, Any]:
         """获取服务信息"""
@@ -116,7 +164,8 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
             "device": device,
             "default_conf": self.DEFAULT_CONF_THRESHOLD,
             "default_iou": self.DEFAULT_IOU_THRESHOLD,
-            "default_image_size": self.DEFAULT_IMAGE_SIZE
+            "default_image_size": self.DEFAULT_IMAGE_SIZE,
+            "model_cache_budget_mb": self.model_cache.budget_bytes // (1024 * 1024)
         }
 
     def apply_nms(self, detections: list, iou_threshold: float) -> list:
@@ -196,10 +245,15 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
 
         handlers = {
             "load_model": self._handle_load_model,
+            "prefetch_model": self._handle_prefetch_model,
             "detect": self._handle_detect,
             "segment": self._handle_segment,
             "classify": self._handle_classify,
             "keypoint": self._handle_keypoint,
+            "detect_batch": lambda req: self._handle_batch(req, "detect"),
+            "segment_batch": lambda req: self._handle_batch(req, "segment"),
+            "classify_batch": lambda req: self._handle_batch(req, "classify"),
+            "keypoint_batch": lambda req: self._handle_batch(req, "keypoint"),
         }
 
         handler = handlers.get(command)
@@ -218,9 +272,12 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
         if not valid:
             return self.create_error_response(error_msg)
 
+        if "cache_budget_mb" in request:
+            self.model_cache.set_budget_mb(request["cache_budget_mb"])
+
         try:
-            # 加载模型
-            self.model = YOLO(model_path)
+            # 最近用过且文件未变的模型直接从缓存取出
+            self.model, cached = self.model_cache.acquire(model_path)
             self.model_path = model_path
 
             # 加载类别标签
@@ -231,10 +288,11 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
             self.model_loaded = True
 
             return self.create_success_response(
-                message=f"模型加载成功: {model_path}",
+                message=f"模型{'切换' if cached else '加载'}成功: {model_path}",
                 data={
                     "num_classes": len(self.class_names),
-                    "class_names": self.class_names[:10]  # 只返回前10个
+                    "class_names": self.class_names[:10],  # 只返回前10个
+                    "cached": cached
                 }
             )
 
@@ -243,19 +301,26 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
             import traceback
             return self.create_error_response(f"加载模型失败: {str(e)}", traceback.format_exc())
 
-    def _get_validated_image_params(self, request: Dict[str, Any]) -> tuple:
-        """获取并验证图像处理参数"""
-        image_path = request.get("image_path", "")
+    def _handle_prefetch_model(self, request: Dict[str, Any]) -> Dict[str, Any]:
+        """处理预取模型命令：立即返回，模型在后台线程加载进缓存"""
+        model_path = request.get("model_path", "")
 
-        # 验证图像路径
-        valid, error_msg = self.validate_image_path(image_path)
+        valid, error_msg = self.validate_model_path(model_path)
         if not valid:
-            return None, self.create_error_response(error_msg)
+            return self.create_error_response(error_msg)
 
-        if not self.model_loaded:
-            return None, self.create_error_response("模型未加载")
+        try:
+            started = self.model_cache.prefetch(model_path)
+        except OSError as e:
+            return self.create_error_response(f"预取模型失败: {str(e)}")
+
+        return self.create_success_response(
+            message=f"模型{'开始预取' if started else '已在缓存中'}: {model_path}",
+            data={"started": started, **self.model_cache.stats()}
+        )
 
-        # 获取并验证参数
+    def _get_inference_params(self, request: Dict[str, Any]) -> tuple:
+        """获取并限制推理参数 (conf, iou, image_size)"""
         conf_threshold = float(request.get("conf_threshold", self.DEFAULT_CONF_THRESHOLD))
         iou_threshold = float(request.get("iou_threshold", self.DEFAULT_IOU_THRESHOLD))
         image_size = int(request.get("image_size", self.DEFAULT_IMAGE_SIZE))
@@ -265,8 +330,247 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
         iou_threshold = max(self.MIN_IOU_THRESHOLD, min(self.MAX_IOU_THRESHOLD, iou_threshold))
         image_size = max(self.MIN_IMAGE_SIZE, min(self.MAX_IMAGE_SIZE, image_size))
 
+        return conf_threshold, iou_threshold, image_size
+
+    def _get_validated_image_params(self, request: Dict[str, Any]) -> tuple:
+        """获取并验证图像处理参数"""
+        # 图像来源：文件路径或共享内存中的像素数组
+        image_path, error_msg = self.resolve_image_input(request)
+        if image_path is None:
+            return None, self.create_error_response(error_msg)
+
+        if not self.model_loaded:
+            return None, self.create_error_response("模型未加载")
+
+        conf_threshold, iou_threshold, image_size = self._get_inference_params(request)
         return (image_path, conf_threshold, iou_threshold, image_size), None
 
+    def _label_for(self, cls_id: int) -> str:
+        """类别 ID 对应的标签"""
+        return self.class_names[cls_id] if cls_id < len(self.class_names) else f"class_{cls_id}"
+
+    def _filter_with_nms(self, detections: list, iou_threshold: float, task_name: str,
+                         enabled: bool = True) -> tuple:
+        """应用 NMS 后处理（保险措施），返回 (过滤后结果, 被过滤数量)"""
+        if not enabled:
+            # 请求携带 client_nms：客户端用原生实现完成这一步
+            return detections, 0
+
+        original_count = len(detections)
+        detections = self.apply_nms(detections, iou_threshold)
+        filtered_count = len(detections)
+
+        # 记录 NMS 效果
+        if filtered_count < original_count:
+            print(f"{task_name} NMS 过滤: {original_count} -> {filtered_count} (IOU={iou_threshold})", file=sys.stderr)
+
+        return detections, original_count - filtered_count
+
+    def _build_detect_response(self, results, iou_threshold: float, server_nms: bool = True,
+                               raw: bool = False) -> Dict[str, Any]:
+        """由推理结果构建目标检测响应"""
+        detections = []
+        for result in results:
+            boxes = result.boxes
+            if boxes is not None:
+                for i in range(len(boxes)):
+                    box = boxes.xyxy[i].cpu().numpy()
+                    conf = float(boxes.conf[i].cpu().numpy())
+                    cls_id = int(boxes.cls[i].cpu().numpy())
+
+                    x1, y1, x2, y2 = box
+                    detections.append({
+                        "x": int(x1),
+                        "y": int(y1),
+                        "width": int(x2 - x1),
+                        "height": int(y2 - y1),
+                        "confidence": round(conf, 4),
+                        "class_id": cls_id,
+                        "label": self._label_for(cls_id)
+                    })
+
+        if raw:
+            return self.create_success_response(
+                message=f"检测完成，{len(detections)} 个候选框",
+                data={
+                    "detections": detections,
+                    "count": len(detections),
+                    "raw_candidates": True
+                }
+            )
+
+        detections, nms_filtered = self._filter_with_nms(detections, iou_threshold, "检测", server_nms)
+
+        return self.create_success_response(
+            message=f"检测完成，发现 {len(detections)} 个目标",
+            data={
+                "detections": detections,
+                "count": len(detections),
+                "nms_applied": nms_filtered > 0,
+                "nms_filtered": nms_filtered
+            }
+        )
+
+    def _build_segment_response(self, results, iou_threshold: float,
+                                stream: ResultStream = None, server_nms: bool = True) -> Dict[str, Any]:
+        """
+        由推理结果构建实例分割响应
+
+        先对边界框做 NMS，再只为保留的实例提取掩码多边形（多边形是响应中最耗时的部分），
+        流式请求中每个实例完成即可发出。
+        """
+        if stream is None:
+            stream = ResultStream(self)
+
+        instances = []
+        sources = {}  # id(instance) -> (masks, 序号)
+        for result in results:
+            boxes = result.boxes
+            masks = result.masks
+
+            if boxes is not None:
+                for i in range(len(boxes)):
+                    box = boxes.xyxy[i].cpu().numpy()
+                    conf = float(boxes.conf[i].cpu().numpy())
+                    cls_id = int(boxes.cls[i].cpu().numpy())
+
+                    x1, y1, x2, y2 = box
+
+                    instance = {
+                        "x": int(x1),
+                        "y": int(y1),
+                        "width": int(x2 - x1),
+                        "height": int(y2 - y1),
+                        "confidence": round(conf, 4),
+                        "class_id": cls_id,
+                        "label": self._label_for(cls_id)
+                    }
+                    sources[id(instance)] = (masks, i)
+                    instances.append(instance)
+
+        instances, nms_filtered = self._filter_with_nms(instances, iou_threshold, "分割", server_nms)
+
+        for instance in instances:
+            masks, i = sources[id(instance)]
+
+            # 提取掩码多边形
+            mask_polygon = []
+            if masks is not None and i < len(masks):
+                if hasattr(masks, 'xy') and masks.xy is not None:
+                    polygon = masks.xy[i]
+                    if polygon is not None and len(polygon) > 0:
+                        for pt in polygon:
+                            mask_polygon.append({
+                                "x": float(pt[0]),
+                                "y": float(pt[1])
+                            })
+
+            instance["mask_polygon"] = mask_polygon
+            stream.add(instance)
+
+        count = stream.total
+        return self.create_success_response(
+            message=f"分割完成，发现 {count} 个实例",
+            data={
+                "detections": stream.finish(),
+                "count": count,
+                "streamed": stream.sent,
+                "nms_applied": nms_filtered > 0,
+                "nms_filtered": nms_filtered
+            }
+        )
+
+    def _build_classify_response(self, results, top_k: int) -> Dict[str, Any]:
+        """由推理结果构建图像分类响应"""
+        classifications = []
+        for result in results:
+            probs = result.probs
+            if probs is not None:
+                values, indices = torch.topk(probs.data, min(top_k, len(probs.data)))
+                for i, (val, idx) in enumerate(zip(values, indices)):
+                    cls_id = int(idx.cpu().numpy())
+                    classifications.append({
+                        "rank": i + 1,
+                        "confidence": round(float(val.cpu().numpy()), 4),
+                        "class_id": cls_id,
+                        "label": self._label_for(cls_id)
+                    })
+
+        return self.create_success_response(
+            message=f"分类完成，Top-1: {classifications[0]['label'] if classifications else 'N/A'}",
+            data={
+                "classifications": classifications,
+                "top_prediction": classifications[0] if classifications else None
+            }
+        )
+
+    def _build_keypoint_response(self, results, iou_threshold: float,
+                                 stream: ResultStream = None) -> Dict[str, Any]:
+        """由推理结果构建关键点检测响应（与分割相同，NMS 后再提取关键点并逐个发出）"""
+        if stream is None:
+            stream = ResultStream(self)
+
+        detections = []
+        sources = {}  # id(detection) -> (keypoints, 序号)
+        for result in results:
+            boxes = result.boxes
+            keypoints = result.keypoints
+
+            if boxes is not None:
+                for i in range(len(boxes)):
+                    box = boxes.xyxy[i].cpu().numpy()
+                    conf = float(boxes.conf[i].cpu().numpy())
+                    cls_id = int(boxes.cls[i].cpu().numpy())
+
+                    x1, y1, x2, y2 = box
+
+                    detection = {
+                        "x": int(x1),
+                        "y": int(y1),
+                        "width": int(x2 - x1),
+                        "height": int(y2 - y1),
+                        "confidence": round(conf, 4),
+                        "class_id": cls_id,
+                        "label": self._label_for(cls_id),
+                        "keypoints": []
+                    }
+                    sources[id(detection)] = (keypoints, i)
+                    detections.append(detection)
+
+        detections, nms_filtered = self._filter_with_nms(detections, iou_threshold, "关键点检测")
+
+        for detection in detections:
+            keypoints, i = sources[id(detection)]
+
+            # 提取关键点
+            if keypoints is not None and i < len(keypoints):
+                kps = keypoints.xy[i].cpu().numpy()
+                kps_conf = keypoints.conf[i].cpu().numpy() if keypoints.conf is not None else None
+
+                for j, kp in enumerate(kps):
+                    kp_data = {
+                        "id": j,
+                        "x": float(kp[0]),
+                        "y": float(kp[1])
+                    }
+                    if kps_conf is not None and j < len(kps_conf):
+                        kp_data["confidence"] = round(float(kps_conf[j]), 4)
+                    detection["keypoints"].append(kp_data)
+
+            stream.add(detection)
+
+        count = stream.total
+        return self.create_success_response(
+            message=f"关键点检测完成，发现 {count} 个目标",
+            data={
+                "detections": stream.finish(),
+                "count": count,
+                "streamed": stream.sent,
+                "nms_applied": nms_filtered > 0,
+                "nms_filtered": nms_filtered
+            }
+        )
+
     def _handle_detect(self, request: Dict[str, Any]) -> Dict[str, Any]:
         """处理目标检测命令"""
         params, error = self._get_validated_image_params(request)
@@ -275,55 +579,21 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
 
         image_path, conf_threshold, iou_threshold, image_size = params
 
+        # 原始候选框：跳过 NMS（IOU 取 1.0 时不抑制任何框），由客户端按阈值在本地过滤
+        raw = bool(request.get("raw_candidates", False))
+
         try:
             # 执行推理
             results = self.model(
                 image_path,
                 conf=conf_threshold,
-                iou=iou_threshold,
+                iou=self.MAX_IOU_THRESHOLD if raw else iou_threshold,
                 imgsz=image_size,
+                max_det=self.RAW_MAX_DETECTIONS if raw else self.DEFAULT_MAX_DETECTIONS,
                 verbose=False
             )
-
-            # 解析结果
-            detections = []
-            for result in results:
-                boxes = result.boxes
-                if boxes is not None:
-                    for i in range(len(boxes)):
-                        box = boxes.xyxy[i].cpu().numpy()
-                        conf = float(boxes.conf[i].cpu().numpy())
-                        cls_id = int(boxes.cls[i].cpu().numpy())
-
-                        x1, y1, x2, y2 = box
-                        detections.append({
-                            "x": int(x1),
-                            "y": int(y1),
-                            "width": int(x2 - x1),
-                            "height": int(y2 - y1),
-                            "confidence": round(conf, 4),
-                            "class_id": cls_id,
-                            "label": self.class_names[cls_id] if cls_id < len(self.class_names) else f"class_{cls_id}"
-                        })
-
-            # 应用 NMS 后处理（保险措施）
-            original_count = len(detections)
-            detections = self.apply_nms(detections, iou_threshold)
-            filtered_count = len(detections)
-
-            # 记录 NMS 效果
-            if filtered_count < original_count:
-                print(f"NMS 过滤: {original_count} -> {filtered_count} (IOU={iou_threshold})", file=sys.stderr)
-
-            return self.create_success_response(
-                message=f"检测完成，发现 {len(detections)} 个目标",
-                data={
-                    "detections": detections,
-                    "count": len(detections),
-                    "nms_applied": filtered_count < original_count,
-                    "nms_filtered": original_count - filtered_count
-                }
-            )
+            return self._build_detect_response(results, iou_threshold,
+                                               server_nms=not request.get("client_nms", False), raw=raw)
 
         except Exception as e:
             import traceback
@@ -346,64 +616,8 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
                 imgsz=image_size,
                 verbose=False
             )
-
-            # 解析结果
-            instances = []
-            for result in results:
-                boxes = result.boxes
-                masks = result.masks
-
-                if boxes is not None:
-                    for i in range(len(boxes)):
-                        box = boxes.xyxy[i].cpu().numpy()
-                        conf = float(boxes.conf[i].cpu().numpy())
-                        cls_id = int(boxes.cls[i].cpu().numpy())
-
-                        x1, y1, x2, y2 = box
-
-                        instance = {
-                            "x": int(x1),
-                            "y": int(y1),
-                            "width": int(x2 - x1),
-                            "height": int(y2 - y1),
-                            "confidence": round(conf, 4),
-                            "class_id": cls_id,
-                            "label": self.class_names[cls_id] if cls_id < len(self.class_names) else f"class_{cls_id}"
-                        }
-
-                        # 提取掩码多边形
-                        mask_polygon = []
-                        if masks is not None and i < len(masks):
-                            if hasattr(masks, 'xy') and masks.xy is not None:
-                                polygon = masks.xy[i]
-                                if polygon is not None and len(polygon) > 0:
-                                    for pt in polygon:
-                                        mask_polygon.append({
-                                            "x": float(pt[0]),
-                                            "y": float(pt[1])
-                                        })
-
-                        instance["mask_polygon"] = mask_polygon
-                        instances.append(instance)
-
-            # 应用 NMS 后处理（保险措施）
-            original_count = len(instances)
-            instances = self.apply_nms(instances, iou_threshold)
-            filtered_count = len(instances)
-
-            # 记录 NMS 效果
-            if filtered_count < original_count:
-                print(f"分割 NMS 过滤: {original_count} -> {filtered_count} (IOU={iou_threshold})", file=sys.stderr)
-
-            return self.create_success_response(
-                message=f"分割完成，发现 {len(instances)} 个实例",
-                data={
-                    "detections": instances,
-                    "count": len(instances),
-                    "nms_applied": filtered_count < original_count,
-                    "nms_filtered": original_count - filtered_count
-                }
-            )
+            return self._build_segment_response(results, iou_threshold, self.open_stream(),
+                                                server_nms=not request.get("client_nms", False))
 
         except Exception as e:
             import traceback
@@ -411,11 +625,8 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
 
     def _handle_classify(self, request: Dict[str, Any]) -> Dict[str, Any]:
         """处理图像分类命令"""
-        image_path = request.get("image_path", "")
-
-        # 验证图像路径
-        valid, error_msg = self.validate_image_path(image_path)
-        if not valid:
+        image_path, error_msg = self.resolve_image_input(request)
+        if image_path is None:
             return self.create_error_response(error_msg)
 
         if not self.model_loaded:
@@ -427,28 +638,7 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
         try:
             # 执行推理
             results = self.model(image_path, verbose=False)
-
-            # 解析结果
-            classifications = []
-            for result in results:
-                probs = result.probs
-                if probs is not None:
-                    values, indices = torch.topk(probs.data, min(top_k, len(probs.data)))
-                    for i, (val, idx) in enumerate(zip(values, indices)):
-                        classifications.append({
-                            "rank": i + 1,
-                            "confidence": round(float(val.cpu().numpy()), 4),
-                            "class_id": int(idx.cpu().numpy()),
-                            "label": self.class_names[int(idx.cpu().numpy())] if int(idx.cpu().numpy()) < len(self.class_names) else f"class_{idx}"
-                        })
-
-            return self.create_success_response(
-                message=f"分类完成，Top-1: {classifications[0]['label'] if classifications else 'N/A'}",
-                data={
-                    "classifications": classifications,
-                    "top_prediction": classifications[0] if classifications else None
-                }
-            )
+            return self._build_classify_response(results, top_k)
 
         except Exception as e:
             import traceback
@@ -471,72 +661,95 @@ class DLService(BaseService, ModelServiceMixin, ImageServiceMixin):
                 imgsz=image_size,
                 verbose=False
             )
-
-            # 解析结果
-            detections = []
-            for result in results:
-                boxes = result.boxes
-                keypoints = result.keypoints
-
-                if boxes is not None:
-                    for i in range(len(boxes)):
-                        box = boxes.xyxy[i].cpu().numpy()
-                        conf = float(boxes.conf[i].cpu().numpy())
-                        cls_id = int(boxes.cls[i].cpu().numpy())
-
-                        x1, y1, x2, y2 = box
-
-                        detection = {
-                            "x": int(x1),
-                            "y": int(y1),
-                            "width": int(x2 - x1),
-                            "height": int(y2 - y1),
-                            "confidence": round(conf, 4),
-                            "class_id": cls_id,
-                            "label": self.class_names[cls_id] if cls_id < len(self.class_names) else f"class_{cls_id}",
-                            "keypoints": []
-                        }
-
-                        # 提取关键点
-                        if keypoints is not None and i < len(keypoints):
-                            kps = keypoints.xy[i].cpu().numpy()
-                            kps_conf = keypoints.conf[i].cpu().numpy() if keypoints.conf is not None else None
-
-                            for j, kp in enumerate(kps):
-                                kp_data = {
-                                    "id": j,
-                                    "x": float(kp[0]),
-                                    "y": float(kp[1])
-                                }
-                                if kps_conf is not None and j < len(kps_conf):
-                                    kp_data["confidence"] = round(float(kps_conf[j]), 4)
-                                detection["keypoints"].append(kp_data)
-
-                        detections.append(detection)
-
-            # 应用 NMS 后处理（保险措施）
-            original_count = len(detections)
-            detections = self.apply_nms(detections, iou_threshold)
-            filtered_count = len(detections)
-
-            # 记录 NMS 效果
-            if filtered_count < original_count:
-                print(f"关键点检测 NMS 过滤: {original_count} -> {filtered_count} (IOU={iou_threshold})", file=sys.stderr)
-
-            return self.create_success_response(
-                message=f"关键点检测完成，发现 {len(detections)} 个目标",
-                data={
-                    "detections": detections,
-                    "count": len(detections),
-                    "nms_applied": filtered_count < original_count,
-                    "nms_filtered": original_count - filtered_count
-                }
-            )
+            return self._build_keypoint_response(results, iou_threshold, self.open_stream())
 
         except Exception as e:
             import traceback
             return self.create_error_response(f"关键点检测失败: {str(e)}", traceback.format_exc())
 
+    def _handle_batch(self, request: Dict[str, Any], task: str) -> Dict[str, Any]:
+        """
+        处理批量推理命令 (detect_batch / segment_batch / classify_batch / keypoint_batch)
+
+        images 中每一项是单图请求的图像字段（{"image_path": ...} 或 {"image_shm": ...}，
+        也可以直接是路径字符串）。有效图像按 batch_size 切分为小批次，每个小批次
+        只做一次前向推理；返回的 results 与 images 顺序一一对应，单张失败不影响其它图像。
+        """
+        if not self.model_loaded:
+            return self.create_error_response("模型未加载")
+
+        images = request.get("images")
+        if not isinstance(images, list) or not images:
+            return self.create_error_response("images 必须是非空列表")
+        if len(images) > self.MAX_BATCH_IMAGES:
+            return self.create_error_response(f"单次批量请求最多 {self.MAX_BATCH_IMAGES} 张图像")
+
+        batch_size = int(request.get("batch_size", self.DEFAULT_BATCH_SIZE))
+        batch_size = max(1, min(self.MAX_BATCH_SIZE, batch_size))
+
+        conf_threshold, iou_threshold, image_size = self._get_inference_params(request)
+        top_k = max(1, min(self.MAX_TOP_K, int(request.get("top_k", self.DEFAULT_TOP_K))))
+
+        task_names = {"detect": "检测", "segment": "分割", "classify": "分类", "keypoint": "关键点检测"}
+        server_nms = not request.get("client_nms", False)
+
+        # 先逐张解析输入，无效图像直接记为失败
+        results = [None] * len(images)
+        pending = []
+        for index, item in enumerate(images):
+            image_request = item if isinstance(item, dict) else {"image_path": str(item)}
+            source, error_msg = self.resolve_image_input(image_request)
+            if source is None:
+                results[index] = self.create_error_response(error_msg)
+            else:
+                pending.append((index, source))
+
+        for start in range(0, len(pending), batch_size):
+            chunk = pending[start:start + batch_size]
+            sources = [source for _, source in chunk]
+
+            try:
+                # 传入列表时 ultralytics 会将整个列表作为一个批次前向推理
+                if task == "classify":
+                    outputs = self.model(sources, verbose=False)
+                else:
+                    outputs = self.model(
+                        sources,
+                        conf=conf_threshold,
+                        iou=iou_threshold,
+                        imgsz=image_size,
+                        verbose=False
+                    )
+
+                for (index, _), output in zip(chunk, outputs):
+                    if task == "detect":
+                        results[index] = self._build_detect_response([output], iou_threshold, server_nms)
+                    elif task == "segment":
+                        results[index] = self._build_segment_response([output], iou_threshold,
+                                                                      server_nms=server_nms)
+                    elif task == "classify":
+                        results[index] = self._build_classify_response([output], top_k)
+                    else:
+                        results[index] = self._build_keypoint_response([output], iou_threshold)
+
+            except Exception as e:
+                import traceback
+                error = self.create_error_response(f"{task_names[task]}失败: {str(e)}", traceback.format_exc())
+                for index, _ in chunk:
+                    results[index] = dict(error)
+
+        success_count = sum(1 for result in results if result and result.get("success"))
+
+        return self.create_success_response(
+            message=f"批量{task_names[task]}完成: 成功 {success_count}/{len(images)}",
+            data={
+                "results": results,
+                "count": len(results),
+                "success_count": success_count,
+                "batch_size": batch_size
+            }
+        )
+
     def cleanup(self):
         """清理资源"""
         self.model = None
@@ -232,10 +232,13 @@ class FSLService(BaseService, ModelServiceMixin, ImageServiceMixin):
                                std=[0.229, 0.224, 0.225])
         ])
 
-    def _extract_features(self, image_path: str, image_size: int = 84):
-        """提取图像特征"""
+    def _extract_features(self, image_path, image_size: int = 84):
+        """提取图像特征（image_path 也可以是共享内存读取的 BGR 数组）"""
         transform = self._get_transform(image_size)
-        image = Image.open(image_path).convert('RGB')
+        if isinstance(image_path, np.ndarray):
+            image = Image.fromarray(image_path[:, :, ::-1].copy())
+        else:
+            image = Image.open(image_path).convert('RGB')
         image_tensor = transform(image).unsqueeze(0).to(self.device)
 
         with torch.no_grad():
@@ -245,11 +248,8 @@ class FSLService(BaseService, ModelServiceMixin, ImageServiceMixin):
 
     def _handle_few_shot_classify(self, request: Dict[str, Any]) -> Dict[str, Any]:
         """处理小样本分类命令"""
-        image_path = request.get("image_path", "")
-
-        # 验证图像路径
-        valid, error_msg = self.validate_image_path(image_path)
-        if not valid:
+        image_path, error_msg = self.resolve_image_input(request)
+        if image_path is None:
             return self.create_error_response(error_msg)
 
         if not self.model_loaded:
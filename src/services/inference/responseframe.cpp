@@ -0,0 +1,138 @@
+/**
+ * @file responseframe.cpp
+ * @brief 二进制检测结果帧解码实现
+ */
+
+#include "responseframe.h"
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QtEndian>
+#include <cstring>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+static const char FRAME_MAGIC[4] = {'G', 'P', 'C', 'F'};
+
+// 所有数组元素均为 4 字节，整块拷贝后在大端平台上逐元素翻转
+template <typename T>
+static void readArray(const char *data, int count, QVector<T> &out)
+{
+    static_assert(sizeof(T) == 4, "frame arrays use 4-byte elements");
+    out.resize(count);
+    if (count == 0) {
+        return;
+    }
+    std::memcpy(out.data(), data, static_cast<size_t>(count) * 4);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    quint32 *words = reinterpret_cast<quint32 *>(out.data());
+    for (int i = 0; i < count; ++i) {
+        words[i] = qbswap(words[i]);
+    }
+#endif
+}
+
+// 前缀偏移必须从 0 开始、单调不减、以 total 结束
+static bool validOffsets(const QVector<quint32> &offsets, quint32 total)
+{
+    if (offsets.isEmpty() || offsets.first() != 0 || offsets.last() != total) {
+        return false;
+    }
+    for (int i = 1; i < offsets.size(); ++i) {
+        if (offsets[i] < offsets[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DetectionFrameDecoder::isFrameStart(const QByteArray &buffer)
+{
+    return buffer.size() >= 4 && std::memcmp(buffer.constData(), FRAME_MAGIC, 4) == 0;
+}
+
+DetectionFrameDecoder::Status DetectionFrameDecoder::decode(const QByteArray &buffer,
+                                                            DetectionFrame &frame,
+                                                            qint64 &frameSize,
+                                                            QString &errorMsg)
+{
+    frameSize = 0;
+    if (buffer.size() < HEADER_SIZE) {
+        return Status::Incomplete;
+    }
+
+    const uchar *header = reinterpret_cast<const uchar *>(buffer.constData());
+    if (std::memcmp(header, FRAME_MAGIC, 4) != 0) {
+        errorMsg = "帧标识错误";
+        return Status::Invalid;
+    }
+
+    const quint16 version = qFromLittleEndian<quint16>(header + 4);
+    const quint32 jsonLength = qFromLittleEndian<quint32>(header + 8);
+    const quint32 imageCount = qFromLittleEndian<quint32>(header + 12);
+    const quint32 detectionCount = qFromLittleEndian<quint32>(header + 16);
+    const quint32 vertexCount = qFromLittleEndian<quint32>(header + 20);
+    const quint32 payloadSize = qFromLittleEndian<quint32>(header + 24);
+
+    if (payloadSize > MAX_PAYLOAD_SIZE) {
+        errorMsg = QString("帧负载过大: %1 字节").arg(payloadSize);
+        return Status::Invalid;
+    }
+    frameSize = HEADER_SIZE + static_cast<qint64>(payloadSize);
+
+    if (version != VERSION) {
+        errorMsg = QString("不支持的帧版本: %1").arg(version);
+        return Status::Invalid;
+    }
+
+    // 按计数核对负载长度，防止越界读取
+    const quint64 jsonPadded = (static_cast<quint64>(jsonLength) + 3) & ~quint64(3);
+    const quint64 expected = jsonPadded
+                             + (static_cast<quint64>(imageCount) + 1) * 4
+                             + static_cast<quint64>(detectionCount) * (4 * 4 + 4 + 4 + 4)
+                             + 4
+                             + static_cast<quint64>(vertexCount) * 2 * 4;
+    if (expected != payloadSize) {
+        errorMsg = QString("帧长度不一致: 声明 %1 字节, 实际应为 %2 字节").arg(payloadSize).arg(expected);
+        return Status::Invalid;
+    }
+
+    if (buffer.size() < frameSize) {
+        return Status::Incomplete;
+    }
+
+    const char *cursor = buffer.constData() + HEADER_SIZE;
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(QByteArray(cursor, static_cast<int>(jsonLength)),
+                                                      &parseError);
+    if (!doc.isObject()) {
+        errorMsg = "帧元数据不是有效的 JSON: " + parseError.errorString();
+        return Status::Invalid;
+    }
+    frame.header = doc.object();
+    cursor += jsonPadded;
+
+    readArray(cursor, static_cast<int>(imageCount) + 1, frame.imageOffsets);
+    cursor += (static_cast<qint64>(imageCount) + 1) * 4;
+    readArray(cursor, static_cast<int>(detectionCount) * 4, frame.boxes);
+    cursor += static_cast<qint64>(detectionCount) * 16;
+    readArray(cursor, static_cast<int>(detectionCount), frame.scores);
+    cursor += static_cast<qint64>(detectionCount) * 4;
+    readArray(cursor, static_cast<int>(detectionCount), frame.classIds);
+    cursor += static_cast<qint64>(detectionCount) * 4;
+    readArray(cursor, static_cast<int>(detectionCount) + 1, frame.vertexOffsets);
+    cursor += (static_cast<qint64>(detectionCount) + 1) * 4;
+    readArray(cursor, static_cast<int>(vertexCount) * 2, frame.vertices);
+
+    if (!validOffsets(frame.imageOffsets, detectionCount)
+        || !validOffsets(frame.vertexOffsets, vertexCount)) {
+        errorMsg = "帧偏移表无效";
+        return Status::Invalid;
+    }
+
+    return Status::Complete;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,75 @@
+#ifndef RESPONSEFRAME_H
+#define RESPONSEFRAME_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+/**
+ * @brief 二进制检测结果帧
+ *
+ * 请求携带 response_format=binary 时，后端用定长帧头 + 紧凑数组代替逐点 JSON
+ * 返回检测/分割结果。布局（小端）：
+ *
+ *   帧头 32 字节: magic "GPCF" | u16 版本 | u16 标志 | u32 JSON 长度 | u32 图像数
+ *                | u32 检测数 | u32 顶点数 | u32 负载长度 | u32 保留
+ *   负载: JSON 元数据（补齐到 4 字节）| imageOffsets[图像数+1] | boxes[检测数*4]
+ *        | scores[检测数] | classIds[检测数] | vertexOffsets[检测数+1] | vertices[顶点数*2]
+ *
+ * JSON 元数据即原响应去掉 detections 数组后的内容，另附 labels（class_id -> 名称）。
+ * 第 i 张图像的检测为 [imageOffsets[i], imageOffsets[i+1])，
+ * 第 j 个检测的掩码顶点为 [vertexOffsets[j], vertexOffsets[j+1])。
+ */
+struct DetectionFrame {
+    QJsonObject header;             // JSON 元数据
+    QVector<quint32> imageOffsets;  // 每张图像的检测区间
+    QVector<float> boxes;           // x, y, width, height
+    QVector<float> scores;
+    QVector<qint32> classIds;
+    QVector<quint32> vertexOffsets; // 每个检测的顶点区间
+    QVector<float> vertices;        // x, y 交替
+
+    int imageCount() const { return imageOffsets.isEmpty() ? 0 : imageOffsets.size() - 1; }
+    int detectionCount() const { return scores.size(); }
+};
+
+/**
+ * @brief 二进制帧解码
+ */
+class DetectionFrameDecoder
+{
+public:
+    static constexpr int HEADER_SIZE = 32;
+    static constexpr quint16 VERSION = 1;
+    static constexpr quint32 MAX_PAYLOAD_SIZE = 256u * 1024u * 1024u;
+
+    enum class Status {
+        Incomplete,  // 数据不足，等待更多字节
+        Complete,    // 解码成功
+        Invalid      // 帧格式错误
+    };
+
+    /**
+     * @brief 缓冲区是否以帧 magic 开头
+     */
+    static bool isFrameStart(const QByteArray &buffer);
+
+    /**
+     * @brief 从缓冲区开头解码一帧
+     * @param buffer 以 magic 开头的缓冲区
+     * @param frame 解码结果
+     * @param frameSize 整帧字节数（帧头可读时设置，Invalid 时可据此跳过整帧）
+     * @param errorMsg Invalid 时的错误信息
+     */
+    static Status decode(const QByteArray &buffer, DetectionFrame &frame,
+                         qint64 &frameSize, QString &errorMsg);
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // RESPONSEFRAME_H
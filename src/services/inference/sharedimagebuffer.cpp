@@ -0,0 +1,200 @@
+/**
+ * @file sharedimagebuffer.cpp
+ * @brief 共享内存图像缓冲区实现
+ *
+ * POSIX 平台使用 shm_open + mmap，Windows 使用命名文件映射，
+ * 与 Python multiprocessing.shared_memory 的命名规则保持一致。
+ */
+
+#include "sharedimagebuffer.h"
+#include "tiledimage.h"
+#include <QCoreApplication>
+#include <atomic>
+#include <cstring>
+#include <cerrno>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+// 进程内唯一的共享内存序号（macOS 限制名称不超过 31 个字符，保持名称简短）
+static std::atomic<quint32> s_bufferCounter{0};
+
+SharedImageBuffer::SharedImageBuffer()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_width(0)
+    , m_height(0)
+    , m_stride(0)
+#ifdef Q_OS_WIN
+    , m_handle(nullptr)
+#endif
+{
+}
+
+SharedImageBuffer::~SharedImageBuffer()
+{
+    release();
+}
+
+bool SharedImageBuffer::create(const QImage &image, QString &errorMsg)
+{
+    release();
+
+    if (image.isNull()) {
+        errorMsg = "图像为空";
+        return false;
+    }
+
+    // 选择与 Python 端约定的 32 位格式，常见的 RGB32/ARGB32 无需转换
+    QImage source;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32) {
+        source = image;
+    } else {
+        source = image.convertToFormat(QImage::Format_RGB32);
+    }
+    m_format = "bgra8888";
+#else
+    source = image.convertToFormat(QImage::Format_RGBA8888);
+    m_format = "rgba8888";
+#endif
+
+    void *data = allocate(source.width(), source.height(), static_cast<int>(source.bytesPerLine()), errorMsg);
+    if (!data) {
+        return false;
+    }
+
+    // 行步长与 QImage 一致，整块拷贝即可
+    std::memcpy(data, source.constBits(), static_cast<size_t>(m_size));
+    m_data = data;
+    return true;
+}
+
+bool SharedImageBuffer::create(const TiledImage &image, QString &errorMsg)
+{
+    release();
+
+    // 分块图像总是 RGB32 / ARGB32
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    m_format = "bgra8888";
+#else
+    m_format = "rgba8888";
+#endif
+
+    const int stride = image.width() * 4;
+    void *data = allocate(image.width(), image.height(), stride, errorMsg);
+    if (!data) {
+        return false;
+    }
+
+    // 每次读出一行块，常驻内存的只有一个行条
+    for (int y = 0; y < image.height(); y += TiledImage::TILE_SIZE) {
+        QImage band = image.region(QRect(0, y, image.width(), TiledImage::TILE_SIZE));
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+        band = band.convertToFormat(QImage::Format_RGBA8888);
+#endif
+        for (int row = 0; row < band.height(); ++row) {
+            std::memcpy(static_cast<uchar *>(data) + static_cast<qint64>(y + row) * stride,
+                        band.constScanLine(row), static_cast<size_t>(stride));
+        }
+    }
+    m_data = data;
+    return true;
+}
+
+void *SharedImageBuffer::allocate(int width, int height, int stride, QString &errorMsg)
+{
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+    m_size = static_cast<qint64>(stride) * height;
+    m_name = QString("gpcv_%1_%2")
+                 .arg(QCoreApplication::applicationPid())
+                 .arg(++s_bufferCounter);
+
+#ifdef Q_OS_WIN
+    HANDLE handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(static_cast<quint64>(m_size) >> 32),
+                                       static_cast<DWORD>(static_cast<quint64>(m_size) & 0xFFFFFFFFu),
+                                       reinterpret_cast<const wchar_t *>(m_name.utf16()));
+    if (!handle) {
+        errorMsg = QString("创建共享内存失败 (错误码 %1)").arg(GetLastError());
+        return nullptr;
+    }
+
+    void *data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(m_size));
+    if (!data) {
+        errorMsg = QString("映射共享内存失败 (错误码 %1)").arg(GetLastError());
+        CloseHandle(handle);
+        return nullptr;
+    }
+    m_handle = handle;
+#else
+    const QByteArray posixName = "/" + m_name.toLatin1();
+    int fd = ::shm_open(posixName.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        errorMsg = QString("创建共享内存失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return nullptr;
+    }
+
+    if (::ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+        errorMsg = QString("设置共享内存大小失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        ::close(fd);
+        ::shm_unlink(posixName.constData());
+        return nullptr;
+    }
+
+    void *data = ::mmap(nullptr, static_cast<size_t>(m_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        errorMsg = QString("映射共享内存失败: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        ::shm_unlink(posixName.constData());
+        return nullptr;
+    }
+#endif
+
+    return data;
+}
+
+void SharedImageBuffer::release()
+{
+    if (!m_data) {
+        return;
+    }
+
+#ifdef Q_OS_WIN
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_handle));
+    m_handle = nullptr;
+#else
+    ::munmap(m_data, static_cast<size_t>(m_size));
+    const QByteArray posixName = "/" + m_name.toLatin1();
+    ::shm_unlink(posixName.constData());
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+QJsonObject SharedImageBuffer::descriptor() const
+{
+    QJsonObject obj;
+    obj["name"] = m_name;
+    obj["width"] = m_width;
+    obj["height"] = m_height;
+    obj["stride"] = m_stride;
+    obj["format"] = m_format;
+    return obj;
+}
+
+} // namespace Utils
+} // namespace GenPreCVSystem
@@ -0,0 +1,87 @@
+#ifndef SHAREDIMAGEBUFFER_H
+#define SHAREDIMAGEBUFFER_H
+
+#include <QString>
+#include <QImage>
+#include <QJsonObject>
+
+namespace GenPreCVSystem {
+namespace Utils {
+
+class TiledImage;
+
+/**
+ * @brief 共享内存图像缓冲区
+ *
+ * 将 QImage 的原始像素写入命名共享内存（POSIX shm_open / Windows 命名文件映射），
+ * 推理请求中只携带 descriptor()，Python 端用 multiprocessing.shared_memory
+ * 附加后直接包装为 numpy 数组，省去 PNG 编码、落盘和解码。
+ *
+ * 缓冲区由创建者拥有，析构时解除映射并删除共享内存对象；
+ * 必须保证在后端返回响应之前保持存活。
+ */
+class SharedImageBuffer
+{
+public:
+    SharedImageBuffer();
+    ~SharedImageBuffer();
+
+    SharedImageBuffer(const SharedImageBuffer &) = delete;
+    SharedImageBuffer &operator=(const SharedImageBuffer &) = delete;
+
+    /**
+     * @brief 创建共享内存并拷贝图像像素
+     * @param image 源图像（非 32 位格式会先转换为 RGB32）
+     * @param errorMsg 失败时的错误信息
+     * @return 是否成功
+     */
+    bool create(const QImage &image, QString &errorMsg);
+
+    /**
+     * @brief 创建共享内存并逐行条拷贝分块图像的像素，不在进程内存中组装整幅图像
+     */
+    bool create(const TiledImage &image, QString &errorMsg);
+
+    /**
+     * @brief 释放共享内存
+     */
+    void release();
+
+    /**
+     * @brief 是否已创建
+     */
+    bool isValid() const { return m_data != nullptr; }
+
+    /**
+     * @brief 共享内存名称（不含 POSIX 前导 '/'，与 Python SharedMemory 的 name 一致）
+     */
+    QString name() const { return m_name; }
+
+    /**
+     * @brief 请求中的 image_shm 描述：name、width、height、stride、format
+     */
+    QJsonObject descriptor() const;
+
+private:
+    /**
+     * @brief 按尺寸和行步长创建并映射共享内存
+     * @return 未初始化的像素区，失败时返回 nullptr
+     */
+    void *allocate(int width, int height, int stride, QString &errorMsg);
+
+    QString m_name;
+    void *m_data;
+    qint64 m_size;
+    int m_width;
+    int m_height;
+    int m_stride;
+    QString m_format;   // bgra8888 / rgba8888（按内存字节顺序）
+#ifdef Q_OS_WIN
+    void *m_handle;     // HANDLE，避免在头文件中包含 windows.h
+#endif
+};
+
+} // namespace Utils
+} // namespace GenPreCVSystem
+
+#endif // SHAREDIMAGEBUFFER_H
@@ -282,6 +282,12 @@ void EnvironmentServiceWidget::updateModelStatus()
         return;
     }
 
+    if (m_currentModelPath == m_loadingModelPath) {
+        m_lblModelStatus->setText("⏳ 正在加载模型...");
+        m_lblModelStatus->setStyleSheet("color: #0066cc; font-size: 11px;");
+        return;
+    }
+
     // 检查当前选择的模型是否已加载
     if (m_dlService->isModelLoaded() && m_currentModelPath == m_loadedModelPath) {
         QString modelName = QFileInfo(m_currentModelPath).fileName();
@@ -602,23 +608,36 @@ void EnvironmentServiceWidget::tryAutoLoadModel()
         return;
     }
 
-    m_lblModelStatus->setText("⏳ 正在加载模型...");
-    m_lblModelStatus->setStyleSheet("color: #0066cc; font-size: 11px;");
-    emit logMessage(QString("[环境服务] 正在加载模型: %1").arg(QFileInfo(m_currentModelPath).fileName()));
+    if (m_currentModelPath == m_loadingModelPath) {
+        emit logMessage("[环境服务] 模型正在加载，跳过重复加载");
+        return;
+    }
 
-    bool success = m_dlService->loadModel(m_currentModelPath);
+    const QString modelPath = m_currentModelPath;
+    m_loadingModelPath = modelPath;
+    updateModelStatus();
+    emit logMessage(QString("[环境服务] 正在加载模型: %1").arg(QFileInfo(modelPath).fileName()));
 
-    if (success) {
-        m_loadedModelPath = m_currentModelPath;  // 记录已加载的模型路径
-        updateModelStatus();
-        emit logMessage(QString("[环境服务] 模型加载成功: %1").arg(QFileInfo(m_currentModelPath).fileName()));
-        emit modelLoaded(m_currentModelPath);
-    } else {
-        m_loadedModelPath.clear();  // 加载失败，清除已加载路径
-        m_lblModelStatus->setText("✗ 模型状态: 加载失败");
-        m_lblModelStatus->setStyleSheet("color: #cc3300; font-size: 11px;");
-        emit logMessage("[环境服务] 错误: 模型加载失败");
-    }
+    // 后台加载，界面不等待；加载期间切换了模型时只记录结果，状态以当前选择为准
+    Utils::onFutureFinished(m_dlService->loadModelAsync(modelPath), this, [this, modelPath](bool success) {
+        if (m_loadingModelPath == modelPath) {
+            m_loadingModelPath.clear();
+        }
+
+        if (success) {
+            m_loadedModelPath = modelPath;  // 记录已加载的模型路径
+            updateModelStatus();
+            emit logMessage(QString("[环境服务] 模型加载成功: %1").arg(QFileInfo(modelPath).fileName()));
+            emit modelLoaded(modelPath);
+        } else {
+            m_loadedModelPath.clear();  // 加载失败，清除已加载路径
+            if (modelPath == m_currentModelPath) {
+                m_lblModelStatus->setText("✗ 模型状态: 加载失败");
+                m_lblModelStatus->setStyleSheet("color: #cc3300; font-size: 11px;");
+            }
+            emit logMessage("[环境服务] 错误: 模型加载失败");
+        }
+    });
 }
 
 void EnvironmentServiceWidget::onEnvironmentChanged(int index)
@@ -646,6 +665,7 @@ void EnvironmentServiceWidget::onEnvironmentChanged(int index)
         emit logMessage("[环境服务] 正在停止当前运行的服务...");
         m_dlService->stop();
         m_loadedModelPath.clear();  // 清除已加载的模型路径
+        m_loadingModelPath.clear();
         emit serviceStopped();
         emit logMessage("[环境服务] 服务已停止");
     }
@@ -755,6 +775,7 @@ void EnvironmentServiceWidget::onReloadEnvironments()
         emit logMessage("[环境服务] 停止当前运行的服务...");
         m_dlService->stop();
         m_loadedModelPath.clear();
+        m_loadingModelPath.clear();
         emit serviceStopped();
         emit logMessage("[环境服务] 服务已停止");
     }
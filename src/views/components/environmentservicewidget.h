@@ -133,6 +133,7 @@ private:
     // 当前状态
     QString m_currentModelPath;   // 当前选择的模型路径
     QString m_loadedModelPath;    // 已加载的模型路径
+    QString m_loadingModelPath;   // 正在后台加载的模型路径
     Models::CVTask m_currentTask;
 
     // 保存的环境路径
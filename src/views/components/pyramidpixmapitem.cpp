@@ -0,0 +1,72 @@
+#include "pyramidpixmapitem.h"
+#include "imagepyramid.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+
+namespace GenPreCVSystem {
+namespace Views {
+
+PyramidPixmapItem::PyramidPixmapItem(const QPixmap &pixmap, QGraphicsItem *parent)
+    : QGraphicsPixmapItem(pixmap, parent)
+{
+    // 需要 exposedRect 才能只读取可见区域
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
+
+void PyramidPixmapItem::setLevels(qint64 sourceKey, const QVector<QImage> &levels)
+{
+    m_levels.clear();
+    m_levels.reserve(levels.size());
+    for (const QImage &level : levels) {
+        m_levels.append(QPixmap::fromImage(level));
+    }
+    m_levelsKey = sourceKey;
+    update();
+}
+
+QVector<QImage> PyramidPixmapItem::buildLevels(const QImage &image, const std::atomic<bool> *cancel)
+{
+    QVector<QImage> levels;
+    if (image.width() <= MIN_PYRAMID_SIZE && image.height() <= MIN_PYRAMID_SIZE) {
+        return levels;
+    }
+
+    Utils::ImagePyramid pyramid(image);
+    for (int level = 1; level <= pyramid.maxLevel() && !(cancel && *cancel); ++level) {
+        levels.append(pyramid.level(level));
+    }
+    return levels;
+}
+
+void PyramidPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    const QPixmap source = pixmap();
+    if (m_levels.isEmpty() || source.cacheKey() != m_levelsKey) {
+        QGraphicsPixmapItem::paint(painter, option, widget);
+        return;
+    }
+
+    const QRectF bounds(offset(), source.size());
+    const QRectF exposed = option->exposedRect & bounds;
+    if (exposed.isEmpty()) {
+        return;
+    }
+
+    const double lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const int level = std::min(Utils::ImagePyramid::levelForScale(lod), static_cast<int>(m_levels.size()));
+    const QPixmap &image = level == 0 ? source : m_levels[level - 1];
+
+    // 各层宽高向上取整，按实际尺寸换算可见区域在该层中的位置
+    const double sx = double(image.width()) / source.width();
+    const double sy = double(image.height()) / source.height();
+    const QRectF visible = exposed.translated(-offset());
+    const QRectF sourceRect(visible.x() * sx, visible.y() * sy, visible.width() * sx, visible.height() * sy);
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform,
+                           transformationMode() == Qt::SmoothTransformation);
+    painter->drawPixmap(exposed, image, sourceRect);
+}
+
+} // namespace Views
+} // namespace GenPreCVSystem
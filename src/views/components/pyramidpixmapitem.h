@@ -0,0 +1,54 @@
+#ifndef PYRAMIDPIXMAPITEM_H
+#define PYRAMIDPIXMAPITEM_H
+
+#include <QGraphicsPixmapItem>
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+#include <atomic>
+
+namespace GenPreCVSystem {
+namespace Views {
+
+/**
+ * @brief 按缩放比例选择金字塔层绘制的图片项
+ *
+ * 缩小显示时绘制最接近当前缩放比例的层（分辨率不低于显示比例），而不是每次重绘都
+ * 缩放整幅原图；只读取与可见区域相交的源矩形。各层由调用方在后台生成后通过
+ * setLevels() 设置，设置之前以及 pixmap() 被替换（如预览）后按原图绘制。
+ */
+class PyramidPixmapItem : public QGraphicsPixmapItem
+{
+public:
+    explicit PyramidPixmapItem(const QPixmap &pixmap, QGraphicsItem *parent = nullptr);
+
+    /**
+     * @brief 设置金字塔层
+     * @param sourceKey 生成各层的原图的 cacheKey，只在 pixmap() 为该图时使用这些层
+     * @param levels 第 k 项为缩小 2^(k+1) 倍的图像
+     */
+    void setLevels(qint64 sourceKey, const QVector<QImage> &levels);
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+    /**
+     * @brief 生成 image 的金字塔层（不含原图），可在工作线程中调用
+     * @param cancel 可选的取消标志，置位后在层与层之间返回已生成的层
+     */
+    static QVector<QImage> buildLevels(const QImage &image, const std::atomic<bool> *cancel = nullptr);
+
+    /**
+     * @brief 宽高都不超过该值的图片直接缩放原图绘制，不生成金字塔
+     */
+    static constexpr int MIN_PYRAMID_SIZE = 2048;
+
+private:
+    QVector<QPixmap> m_levels;
+    qint64 m_levelsKey = 0;
+};
+
+} // namespace Views
+} // namespace GenPreCVSystem
+
+#endif // PYRAMIDPIXMAPITEM_H
@@ -0,0 +1,116 @@
+#include "tiledimageitem.h"
+#include "tiledimage.h"
+#include "imagepyramid.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+namespace GenPreCVSystem {
+namespace Views {
+
+TiledImageItem::TiledImageItem(const std::shared_ptr<Utils::TiledImage> &image, QGraphicsItem *parent)
+    : QGraphicsItem(parent)
+    , m_image(image)
+    , m_tiles(PIXMAP_CACHE_TILES)
+{
+    // 需要 exposedRect 才能只绘制可见的块
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+}
+
+void TiledImageItem::invalidate()
+{
+    m_tiles.clear();
+    m_overview = QPixmap();
+    m_cacheKey = 0;
+    update();
+}
+
+void TiledImageItem::setLevels(qint64 sourceKey, const QVector<std::shared_ptr<Utils::TiledImage>> &levels)
+{
+    if (!m_image || sourceKey != m_image->cacheKey()) {
+        return;
+    }
+    m_levels = levels;
+    m_levelsKey = sourceKey;
+    update();
+}
+
+QRectF TiledImageItem::boundingRect() const
+{
+    return m_image ? QRectF(m_image->rect()) : QRectF();
+}
+
+void TiledImageItem::syncCache()
+{
+    const qint64 key = m_image->cacheKey();
+    if (key != m_cacheKey) {
+        m_tiles.clear();
+        m_overview = QPixmap::fromImage(m_image->overview());
+        m_cacheKey = key;
+    }
+    if (key != m_levelsKey) {
+        m_levels.clear();
+    }
+}
+
+void TiledImageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget)
+    if (!m_image) {
+        return;
+    }
+    syncCache();
+
+    const QRectF bounds = boundingRect();
+    const double lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const int level = Utils::ImagePyramid::levelForScale(lod);
+
+    // 缩略图的分辨率已经足够，或所需的层尚未生成时不读取块
+    if (level >= m_image->overviewLevel() || level > m_levels.size()) {
+        painter->drawPixmap(bounds, m_overview, QRectF(m_overview.rect()));
+        return;
+    }
+
+    const QRectF exposed = option->exposedRect & bounds;
+    if (!exposed.isEmpty()) {
+        paintTiles(painter, exposed, level);
+    }
+}
+
+/**
+ * 绘制第 level 层与 exposed（原图坐标）相交的块。该层的块按 2^level 放大到原图坐标，
+ * 右下边缘最多超出原图不到一个屏幕像素。
+ */
+void TiledImageItem::paintTiles(QPainter *painter, const QRectF &exposed, int level)
+{
+    const Utils::TiledImage &image = level == 0 ? *m_image : *m_levels[level - 1];
+    const double factor = 1.0 / Utils::ImagePyramid::levelScale(level);
+    const double tileSize = Utils::TiledImage::TILE_SIZE * factor;
+
+    const int firstColumn = static_cast<int>(std::floor(exposed.left() / tileSize));
+    const int lastColumn = std::min(static_cast<int>(std::ceil(exposed.right() / tileSize)),
+                                    image.columns()) - 1;
+    const int firstRow = static_cast<int>(std::floor(exposed.top() / tileSize));
+    const int lastRow = std::min(static_cast<int>(std::ceil(exposed.bottom() / tileSize)),
+                                 image.rows()) - 1;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const qint64 key = (qint64(level) << 32) | (row * image.columns() + column);
+            QPixmap *tile = m_tiles.object(key);
+            if (!tile) {
+                tile = new QPixmap(QPixmap::fromImage(image.tile(column, row)));
+                m_tiles.insert(key, tile);
+            }
+
+            const QRect source = image.tileRect(column, row);
+            const QRectF target(source.x() * factor, source.y() * factor,
+                                source.width() * factor, source.height() * factor);
+            painter->drawPixmap(target, *tile, QRectF(tile->rect()));
+        }
+    }
+}
+
+} // namespace Views
+} // namespace GenPreCVSystem
@@ -0,0 +1,66 @@
+#ifndef TILEDIMAGEITEM_H
+#define TILEDIMAGEITEM_H
+
+#include <QCache>
+#include <QGraphicsItem>
+#include <QPixmap>
+#include <QVector>
+#include <memory>
+
+namespace GenPreCVSystem {
+namespace Utils {
+class TiledImage;
+}
+
+namespace Views {
+
+/**
+ * @brief 显示分块图像的图形项
+ *
+ * 只绘制与视图可见区域相交的块，块按需从 TiledImage 读取并缓存为 QPixmap；
+ * 缩小时改读最接近当前缩放比例的金字塔层，缩小到缩略图分辨率以下时直接绘制缩略图。
+ * 所需的层尚未生成时也绘制缩略图，避免缩小后每帧读取大量原图块。
+ * 场景坐标以原图像素为单位，与 QGraphicsPixmapItem 一致。
+ */
+class TiledImageItem : public QGraphicsItem
+{
+public:
+    explicit TiledImageItem(const std::shared_ptr<Utils::TiledImage> &image,
+                            QGraphicsItem *parent = nullptr);
+
+    std::shared_ptr<Utils::TiledImage> image() const { return m_image; }
+
+    /**
+     * @brief 图像内容已改变（如处理结果写回），丢弃缓存的块和缩略图
+     */
+    void invalidate();
+
+    /**
+     * @brief 设置后台生成的金字塔层
+     * @param sourceKey 生成各层时原图的 cacheKey，原图之后被修改则不再使用这些层
+     * @param levels 第 k 项为缩小 2^(k+1) 倍的图像，到缩略图对应的层之前为止
+     */
+    void setLevels(qint64 sourceKey, const QVector<std::shared_ptr<Utils::TiledImage>> &levels);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+    static constexpr int PIXMAP_CACHE_TILES = 128;  ///< 缓存的块数，32 位像素时约 32 MB
+
+private:
+    void syncCache();
+    void paintTiles(QPainter *painter, const QRectF &exposed, int level);
+
+    std::shared_ptr<Utils::TiledImage> m_image;
+    QVector<std::shared_ptr<Utils::TiledImage>> m_levels;
+    qint64 m_levelsKey = 0;
+    QCache<qint64, QPixmap> m_tiles;  ///< 键为 (层号 << 32) | 块号
+    QPixmap m_overview;
+    qint64 m_cacheKey = 0;
+};
+
+} // namespace Views
+} // namespace GenPreCVSystem
+
+#endif // TILEDIMAGEITEM_H
@@ -54,6 +54,8 @@ BatchProcessDialog::BatchProcessDialog(QWidget *parent)
     , m_dlService(nullptr)
     , m_taskType(Models::CVTask::ImageClassification)
     , m_currentIndex(0)
+    , m_completedCount(0)
+    , m_inFlightCount(0)
     , m_isProcessing(false)
     , m_stopRequested(false)
     , m_successCount(0)
@@ -142,6 +144,15 @@ void BatchProcessDialog::setupUI()
     m_spinImageSize->setValue(AppSettings::defaultImageSize());
     paramsLayout->addWidget(m_spinImageSize);
 
+    paramsLayout->addSpacing(15);
+
+    paramsLayout->addWidget(new QLabel(tr("批大小:")));
+    m_spinBatchSize = new QSpinBox();
+    m_spinBatchSize->setRange(1, 64);
+    m_spinBatchSize->setValue(AppSettings::batchSize());
+    m_spinBatchSize->setToolTip(tr("每次前向推理处理的图像数，显存不足时请调小"));
+    paramsLayout->addWidget(m_spinBatchSize);
+
     paramsLayout->addStretch();
 
     mainLayout->addWidget(paramsGroup);
@@ -423,6 +434,11 @@ void BatchProcessDialog::onModelSelectionChanged(int index)
         m_currentModelPath = modelPath;
         m_lblModelStatus->setText(tr("✓ 已选择: %1").arg(QFileInfo(modelPath).fileName()));
         m_lblModelStatus->setStyleSheet("color: #0066cc;");
+
+        // 选中即在后台预取，开始处理时加载模型只需切换
+        if (m_dlService) {
+            m_dlService->prefetchModel(modelPath);
+        }
     }
 }
 
@@ -477,30 +493,60 @@ void BatchProcessDialog::onStartProcessing()
     bool needLoadModel = !m_dlService->isModelLoaded() ||
                          m_dlService->modelPath() != m_currentModelPath;
 
-    if (needLoadModel) {
-        m_lblStatus->setText(tr("正在加载模型..."));
-        QCoreApplication::processEvents();
+    if (!needLoadModel) {
+        startProcessing();
+        return;
+    }
 
-        if (!m_dlService->loadModel(m_currentModelPath)) {
+    // 后台加载模型，加载期间禁止重复开始或切换模型，完成后再开始处理
+    m_lblStatus->setText(tr("正在加载模型..."));
+    m_btnStart->setEnabled(false);
+    m_comboModel->setEnabled(false);
+    m_btnBrowseModel->setEnabled(false);
+
+    const QString modelPath = m_currentModelPath;
+    onFutureFinished(m_dlService->loadModelAsync(modelPath), this, [this, modelPath](bool success) {
+        m_btnStart->setEnabled(true);
+        m_comboModel->setEnabled(true);
+        m_btnBrowseModel->setEnabled(true);
+
+        if (!success) {
+            m_lblStatus->clear();
             QMessageBox::warning(this, tr("提示"), tr("模型加载失败"));
             m_lblModelStatus->setText(tr("✗ 模型状态: 加载失败"));
             m_lblModelStatus->setStyleSheet("color: #cc3300;");
             return;
         }
-        m_lblModelStatus->setText(tr("● 已加载: %1").arg(QFileInfo(m_currentModelPath).fileName()));
+        m_lblModelStatus->setText(tr("● 已加载: %1").arg(QFileInfo(modelPath).fileName()));
         m_lblModelStatus->setStyleSheet("color: #0066cc; font-weight: bold;");
-    }
+
+        // 加载期间关闭了对话框则不再开始
+        if (isVisible()) {
+            startProcessing();
+        }
+    });
+}
+
+void BatchProcessDialog::startProcessing()
+{
+    AppSettings::setBatchSize(m_spinBatchSize->value());
 
     // 重置状态
     m_currentIndex = 0;
+    m_completedCount = 0;
+    m_inFlightCount = 0;
     m_stopRequested = false;
     m_isProcessing = true;
     m_successCount = 0;
     m_failCount = 0;
     m_totalTime = 0.0;
+    // 按文件顺序预留结果位置，批次完成的先后不影响导出顺序；未返回结果的位置路径为空
     m_detectionResults.clear();
     m_classificationResults.clear();
     m_keypointResults.clear();
+    m_detectionResults.resize(m_imageFiles.size());
+    m_classificationResults.resize(m_imageFiles.size());
+    m_keypointResults.resize(m_imageFiles.size());
 
     // 更新 UI
     m_btnStart->setEnabled(false);
@@ -520,115 +566,129 @@ void BatchProcessDialog::onStartProcessing()
 
 void BatchProcessDialog::processNextImage()
 {
-    if (m_stopRequested || m_currentIndex >= m_imageFiles.size()) {
-        finishProcessing();
+    if (!m_isProcessing) {
         return;
     }
 
-    QString imagePath = m_imageFiles[m_currentIndex];
-    QFileInfo fileInfo(imagePath);
+    // 按批大小切分后流水线提交：保持所有后端进程的在途窗口都有批次，
+    // 后端处理当前批次时下一批已在管道中
+    const int window = qMax(1, m_dlService->capacity());
+    const int batchSize = m_spinBatchSize->value();
+    while (!m_stopRequested && m_currentIndex < m_imageFiles.size() && m_inFlightCount < window) {
+        const QStringList chunk = m_imageFiles.mid(m_currentIndex, batchSize);
+        submitBatch(m_currentIndex, chunk);
+        m_currentIndex += chunk.size();
+    }
+
+    if (m_inFlightCount == 0 && (m_stopRequested || m_currentIndex >= m_imageFiles.size())) {
+        finishProcessing();
+    }
+}
 
-    m_lblStatus->setText(tr("处理: %1").arg(fileInfo.fileName()));
-    updateProgress();
+void BatchProcessDialog::submitBatch(int start, const QStringList &imagePaths)
+{
+    m_lblStatus->setText(tr("处理: %1 等 %2 张")
+                         .arg(QFileInfo(imagePaths.first()).fileName())
+                         .arg(imagePaths.size()));
+
+    QVector<InferenceImage> images;
+    images.reserve(imagePaths.size());
+    for (const QString &path : imagePaths) {
+        images.append(InferenceImage(path));
+    }
 
-    // 根据任务类型执行不同的推理
+    const int batchSize = imagePaths.size();
+    const float confThreshold = static_cast<float>(m_spinConfThreshold->value());
+    const float iouThreshold = static_cast<float>(m_spinIOUThreshold->value());
+    const int imageSize = m_spinImageSize->value();
+
+    // 根据任务类型提交不同的批量推理，结果在回调中写入各图像在文件列表中的位置
     switch (m_taskType) {
     case Models::CVTask::ObjectDetection:
-        {
-            Utils::DetectionResult result = m_dlService->detect(imagePath,
-                static_cast<float>(m_spinConfThreshold->value()),
-                static_cast<float>(m_spinIOUThreshold->value()),
-                m_spinImageSize->value());
-            m_detectionResults.append({imagePath, result});
-            if (result.success) {
-                m_successCount++;
-                m_totalTime += result.inferenceTime;
-            } else {
-                m_failCount++;
+    case Models::CVTask::RoadDamageDetection:
+    case Models::CVTask::ManholeCoverDamageDetection:
+        m_inFlightCount++;
+        onFutureFinished(m_dlService->detectBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize),
+                         this, [this, start, imagePaths](const QVector<DetectionResult> &results) {
+            for (int i = 0; i < results.size(); ++i) {
+                m_detectionResults[start + i] = {imagePaths[i], results[i]};
+                recordResult(results[i].success, results[i].inferenceTime);
             }
-        }
+            onBatchFinished();
+        });
         break;
 
     case Models::CVTask::SemanticSegmentation:
-        {
-            Utils::DetectionResult result = m_dlService->segment(imagePath,
-                static_cast<float>(m_spinConfThreshold->value()),
-                static_cast<float>(m_spinIOUThreshold->value()),
-                m_spinImageSize->value());
-            m_detectionResults.append({imagePath, result});
-            if (result.success) {
-                m_successCount++;
-                m_totalTime += result.inferenceTime;
-            } else {
-                m_failCount++;
+        m_inFlightCount++;
+        onFutureFinished(m_dlService->segmentBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize),
+                         this, [this, start, imagePaths](const QVector<DetectionResult> &results) {
+            for (int i = 0; i < results.size(); ++i) {
+                m_detectionResults[start + i] = {imagePaths[i], results[i]};
+                recordResult(results[i].success, results[i].inferenceTime);
             }
-        }
+            onBatchFinished();
+        });
         break;
 
     case Models::CVTask::ImageClassification:
-        {
-            Utils::ClassificationResultList result = m_dlService->classify(imagePath);
-            m_classificationResults.append({imagePath, result});
-            if (result.success) {
-                m_successCount++;
-                m_totalTime += result.inferenceTime;
-            } else {
-                m_failCount++;
+        m_inFlightCount++;
+        onFutureFinished(m_dlService->classifyBatchAsync(images, batchSize),
+                         this, [this, start, imagePaths](const QVector<ClassificationResultList> &results) {
+            for (int i = 0; i < results.size(); ++i) {
+                m_classificationResults[start + i] = {imagePaths[i], results[i]};
+                recordResult(results[i].success, results[i].inferenceTime);
             }
-        }
+            onBatchFinished();
+        });
         break;
 
     case Models::CVTask::KeyPointDetection:
-        {
-            Utils::KeypointResult result = m_dlService->keypoint(imagePath,
-                static_cast<float>(m_spinConfThreshold->value()),
-                static_cast<float>(m_spinIOUThreshold->value()),
-                m_spinImageSize->value());
-            m_keypointResults.append({imagePath, result});
-            if (result.success) {
-                m_successCount++;
-                m_totalTime += result.inferenceTime;
-            } else {
-                m_failCount++;
+        m_inFlightCount++;
+        onFutureFinished(m_dlService->keypointBatchAsync(images, batchSize, confThreshold, iouThreshold, imageSize),
+                         this, [this, start, imagePaths](const QVector<KeypointResult> &results) {
+            for (int i = 0; i < results.size(); ++i) {
+                m_keypointResults[start + i] = {imagePaths[i], results[i]};
+                recordResult(results[i].success, results[i].inferenceTime);
             }
-        }
+            onBatchFinished();
+        });
         break;
 
-    case Models::CVTask::RoadDamageDetection:
-    case Models::CVTask::ManholeCoverDamageDetection:
-        {
-            Utils::DetectionResult result = m_dlService->detect(imagePath,
-                static_cast<float>(m_spinConfThreshold->value()),
-                static_cast<float>(m_spinIOUThreshold->value()),
-                m_spinImageSize->value());
-            m_detectionResults.append({imagePath, result});
-            if (result.success) {
-                m_successCount++;
-                m_totalTime += result.inferenceTime;
-            } else {
-                m_failCount++;
-            }
+    default:
+        for (int i = 0; i < imagePaths.size(); ++i) {
+            recordResult(false, 0.0);
         }
+        updateProgress();
         break;
+    }
+}
 
-    default:
+void BatchProcessDialog::recordResult(bool success, double inferenceTime)
+{
+    m_completedCount++;
+
+    if (success) {
+        m_successCount++;
+        m_totalTime += inferenceTime;
+    } else {
         m_failCount++;
-        break;
     }
+}
 
-    m_currentIndex++;
-
-    // 使用单次定时器处理下一个（避免阻塞 UI）
-    QTimer::singleShot(1, this, &BatchProcessDialog::processNextImage);
+void BatchProcessDialog::onBatchFinished()
+{
+    m_inFlightCount--;
+    updateProgress();
+    processNextImage();
 }
 
 void BatchProcessDialog::updateProgress()
 {
     int total = m_imageFiles.size();
     if (total > 0) {
-        int progress = static_cast<int>((m_currentIndex * 100.0) / total);
+        int progress = static_cast<int>((m_completedCount * 100.0) / total);
         m_progressBar->setValue(progress);
-        m_lblProgress->setText(QString("%1 / %2").arg(m_currentIndex).arg(total));
+        m_lblProgress->setText(QString("%1 / %2").arg(m_completedCount).arg(total));
     }
 }
 
@@ -735,7 +795,7 @@ bool BatchProcessDialog::exportAsZip(const QString &zipPath)
             const QString &imagePath = resultPair.first;
             const Utils::DetectionResult &result = resultPair.second;
 
-            if (!result.success) continue;
+            if (imagePath.isEmpty() || !result.success) continue;
 
             QFileInfo imageInfo(imagePath);
             QString baseName = imageInfo.completeBaseName();
@@ -816,7 +876,7 @@ bool BatchProcessDialog::exportAsZip(const QString &zipPath)
             const QString &imagePath = resultPair.first;
             const Utils::DetectionResult &result = resultPair.second;
 
-            if (!result.success) continue;
+            if (imagePath.isEmpty() || !result.success) continue;
 
             QFileInfo imageInfo(imagePath);
             QString baseName = imageInfo.completeBaseName();
@@ -913,7 +973,7 @@ bool BatchProcessDialog::exportAsZip(const QString &zipPath)
                 const QString &imagePath = resultPair.first;
                 const Utils::ClassificationResultList &result = resultPair.second;
 
-                if (!result.success) continue;
+                if (imagePath.isEmpty() || !result.success) continue;
 
                 QFileInfo imageInfo(imagePath);
                 QString baseName = imageInfo.completeBaseName();
@@ -973,7 +1033,7 @@ bool BatchProcessDialog::exportAsZip(const QString &zipPath)
             const QString &imagePath = resultPair.first;
             const Utils::KeypointResult &result = resultPair.second;
 
-            if (!result.success) continue;
+            if (imagePath.isEmpty() || !result.success) continue;
 
             QFileInfo imageInfo(imagePath);
             QString baseName = imageInfo.completeBaseName();
@@ -63,7 +63,11 @@ private:
     void updateModelList();
     void tryAutoLoadFirstModel();
     void populateImageList(const QString &folderPath);
+    void startProcessing();
     void processNextImage();
+    void submitBatch(int start, const QStringList &imagePaths);
+    void recordResult(bool success, double inferenceTime);
+    void onBatchFinished();
     void updateProgress();
     void finishProcessing();
     bool exportAsZip(const QString &zipPath);
@@ -79,6 +83,7 @@ private:
     QDoubleSpinBox *m_spinConfThreshold;
     QDoubleSpinBox *m_spinIOUThreshold;
     QSpinBox *m_spinImageSize;
+    QSpinBox *m_spinBatchSize;
 
     // 输入控件
     QLineEdit *m_editFolder;
@@ -103,7 +108,9 @@ private:
     QString m_currentModelPath;
     QString m_currentFolder;
     QStringList m_imageFiles;
-    int m_currentIndex;
+    int m_currentIndex;      // 下一张待提交的图像
+    int m_completedCount;    // 已返回结果的图像数
+    int m_inFlightCount;     // 已提交、尚未返回的批次数
     bool m_isProcessing;
     bool m_stopRequested;
 
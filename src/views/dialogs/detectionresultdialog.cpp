@@ -55,6 +55,10 @@ DetectionResultDialog::DetectionResultDialog(QWidget *parent)
     , m_processedView(nullptr)
     , m_comparisonSplitter(nullptr)
     , m_currentTaskType(Models::CVTask::ObjectDetection)
+    , m_streamedCount(0)
+    , m_streamMaskAlpha(50)
+    , m_streamShowBoxes(false)
+    , m_streamShowLabels(true)
 {
     setupUI();
     setupClassificationUI();
@@ -503,16 +507,28 @@ void DetectionResultDialog::setKeypointResult(const QPixmap &pixmap, const Utils
     // 绘制带骨架的图像
     QPixmap resultPixmap = pixmap;
     QPainter painter(&resultPixmap);
+    paintKeypointDetections(painter, result.detections, 0, showBoxes, showLabels);
+    painter.end();
+
+    m_imageView->setPixmap(resultPixmap);
+    updateKeypointInfo();
+
+    setWindowTitle(tr("关键点检测结果"));
+}
 
+void DetectionResultDialog::paintKeypointDetections(QPainter &painter,
+                                                    const QVector<Utils::KeypointDetection> &detections,
+                                                    int firstIndex, bool showBoxes, bool showLabels)
+{
     // 预定义的颜色
     static const QVector<QColor> colors = {
         QColor(255, 87, 87), QColor(87, 255, 87), QColor(87, 87, 255),
         QColor(255, 255, 87), QColor(255, 87, 255), QColor(87, 255, 255),
     };
 
-    for (int i = 0; i < result.detections.size(); ++i) {
-        const auto &det = result.detections[i];
-        QColor color = colors[i % colors.size()];
+    for (int i = 0; i < detections.size(); ++i) {
+        const auto &det = detections[i];
+        QColor color = colors[(firstIndex + i) % colors.size()];
 
         // 绘制边界框（如果需要）
         if (showBoxes) {
@@ -543,10 +559,11 @@ void DetectionResultDialog::setKeypointResult(const QPixmap &pixmap, const Utils
             painter.drawText(textRect, Qt::AlignCenter, labelText);
         }
     }
+}
 
-    painter.end();
-
-    m_imageView->setPixmap(resultPixmap);
+void DetectionResultDialog::updateKeypointInfo()
+{
+    const Utils::KeypointResult &result = m_keypointResult;
 
     // 更新信息
     QString infoText = tr("检测到 %1 个目标 | 耗时: %2ms")
@@ -568,10 +585,114 @@ void DetectionResultDialog::setKeypointResult(const QPixmap &pixmap, const Utils
     }
     m_txtDetails->setText(details);
     m_txtDetails->setVisible(true);
+}
+
+void DetectionResultDialog::beginSegmentationStream(const QPixmap &pixmap, int maskAlpha,
+                                                    bool showBoxes, bool showLabels)
+{
+    m_originalPixmap = pixmap;
+    m_currentResult = Utils::DetectionResult();
+    m_currentTaskType = Models::CVTask::SemanticSegmentation;
+    m_streamedCount = 0;
+    m_streamMaskAlpha = maskAlpha;
+    m_streamShowBoxes = showBoxes;
+    m_streamShowLabels = showLabels;
 
+    m_imageView->setVisible(true);
+    m_classificationPanel->setVisible(false);
+    m_comparisonPanel->setVisible(false);
+    m_txtDetails->setVisible(false);
+
+    m_imageView->clearDetections();
+    m_imageView->clearImage();
+    m_imageView->setPixmap(pixmap);
+
+    m_lblInfo->setText(tr("正在接收分割结果..."));
+    setWindowTitle(tr("语义分割结果"));
+}
+
+void DetectionResultDialog::appendSegmentationDetections(const QVector<Utils::Detection> &detections)
+{
+    QVector<DetectionOverlay> overlays;
+    overlays.reserve(detections.size());
+    for (int i = 0; i < detections.size(); ++i) {
+        overlays.append(convertToOverlay(detections[i], m_streamedCount + i));
+    }
+    m_imageView->appendSegmentationOverlays(overlays, m_streamMaskAlpha, m_streamShowBoxes, m_streamShowLabels);
+
+    m_streamedCount += detections.size();
+    m_lblInfo->setText(tr("正在接收分割结果... 已显示 %1 个实例").arg(m_streamedCount));
+}
+
+void DetectionResultDialog::finishSegmentationStream(const Utils::DetectionResult &result)
+{
+    m_currentResult = result;
+
+    // 只绘制流式阶段尚未显示的实例
+    QVector<DetectionOverlay> overlays;
+    for (int i = m_streamedCount; i < result.detections.size(); ++i) {
+        overlays.append(convertToOverlay(result.detections[i], i));
+    }
+    m_imageView->appendSegmentationOverlays(overlays, m_streamMaskAlpha, m_streamShowBoxes, m_streamShowLabels);
+    m_streamedCount = 0;
+
+    m_txtDetails->setVisible(true);
+    updateInfoPanel();
+}
+
+void DetectionResultDialog::beginKeypointStream(const QPixmap &pixmap, bool showBoxes, bool showLabels)
+{
+    m_originalPixmap = pixmap;
+    m_keypointResult = Utils::KeypointResult();
+    m_currentTaskType = Models::CVTask::KeyPointDetection;
+    m_streamedCount = 0;
+    m_streamShowBoxes = showBoxes;
+    m_streamShowLabels = showLabels;
+    m_streamCanvas = pixmap;
+
+    m_imageView->setVisible(true);
+    m_classificationPanel->setVisible(false);
+    m_comparisonPanel->setVisible(false);
+    m_txtDetails->setVisible(false);
+
+    m_imageView->clearDetections();
+    m_imageView->clearImage();
+    m_imageView->setPixmap(pixmap);
+
+    m_lblInfo->setText(tr("正在接收关键点结果..."));
     setWindowTitle(tr("关键点检测结果"));
 }
 
+void DetectionResultDialog::appendKeypointDetections(const QVector<Utils::KeypointDetection> &detections)
+{
+    QPainter painter(&m_streamCanvas);
+    paintKeypointDetections(painter, detections, m_streamedCount, m_streamShowBoxes, m_streamShowLabels);
+    painter.end();
+
+    // 只替换图片内容，保留用户当前的缩放和平移
+    m_imageView->updatePixmap(m_streamCanvas);
+
+    m_streamedCount += detections.size();
+    m_lblInfo->setText(tr("正在接收关键点结果... 已显示 %1 个目标").arg(m_streamedCount));
+}
+
+void DetectionResultDialog::finishKeypointStream(const Utils::KeypointResult &result)
+{
+    m_keypointResult = result;
+
+    if (m_streamedCount < result.detections.size()) {
+        QPainter painter(&m_streamCanvas);
+        paintKeypointDetections(painter, result.detections.mid(m_streamedCount), m_streamedCount,
+                                m_streamShowBoxes, m_streamShowLabels);
+        painter.end();
+        m_imageView->updatePixmap(m_streamCanvas);
+    }
+    m_streamedCount = 0;
+    m_streamCanvas = QPixmap();
+
+    updateKeypointInfo();
+}
+
 void DetectionResultDialog::setImageProcessResult(const QPixmap &originalPixmap, const QPixmap &processedPixmap,
                                                    const QString &processType, double processTime)
 {
@@ -73,6 +73,42 @@ public:
     void setKeypointResult(const QPixmap &pixmap, const Utils::KeypointResult &result,
                            bool showBoxes = true, bool showLabels = true);
 
+    /**
+     * @brief 开始显示流式分割结果
+     *
+     * 显示原始图像并清空覆盖层，之后由 appendSegmentationDetections 逐块追加，
+     * finishSegmentationStream 补齐剩余实例并更新信息面板。
+     */
+    void beginSegmentationStream(const QPixmap &pixmap, int maskAlpha = 50,
+                                 bool showBoxes = false, bool showLabels = true);
+
+    /**
+     * @brief 追加一块流式分割结果
+     */
+    void appendSegmentationDetections(const QVector<Utils::Detection> &detections);
+
+    /**
+     * @brief 结束流式分割显示
+     * @param result 完整结果（前面已追加的实例不会重复绘制）
+     */
+    void finishSegmentationStream(const Utils::DetectionResult &result);
+
+    /**
+     * @brief 开始显示流式关键点结果
+     */
+    void beginKeypointStream(const QPixmap &pixmap, bool showBoxes = true, bool showLabels = true);
+
+    /**
+     * @brief 追加一块流式关键点结果
+     */
+    void appendKeypointDetections(const QVector<Utils::KeypointDetection> &detections);
+
+    /**
+     * @brief 结束流式关键点显示
+     * @param result 完整结果（前面已追加的目标不会重复绘制）
+     */
+    void finishKeypointStream(const Utils::KeypointResult &result);
+
     /**
      * @brief 设置图像处理结果 (增强/去噪/边缘检测)
      */
@@ -104,6 +140,9 @@ private:
     void updateComparisonPanel();
     DetectionOverlay convertToOverlay(const Utils::Detection &det, int index);
     void drawKeypointSkeleton(QPainter &painter, const Utils::KeypointDetection &kp, const QColor &color);
+    void paintKeypointDetections(QPainter &painter, const QVector<Utils::KeypointDetection> &detections,
+                                 int firstIndex, bool showBoxes, bool showLabels);
+    void updateKeypointInfo();
 
     // 主界面控件
     ImageView *m_imageView;
@@ -138,6 +177,13 @@ private:
     QString m_currentImagePath;
     Models::CVTask m_currentTaskType;
     QString m_processType;
+
+    // 流式结果显示状态
+    int m_streamedCount;         // 已显示的检测数
+    int m_streamMaskAlpha;
+    bool m_streamShowBoxes;
+    bool m_streamShowLabels;
+    QPixmap m_streamCanvas;      // 关键点逐块绘制的画布
 };
 
 } // namespace Views
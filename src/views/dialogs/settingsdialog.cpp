@@ -5,6 +5,7 @@
  * 应用程序设置界面，包含：
  * - 目录设置（默认打开/导出目录）
  * - 常规设置（最近文件数量）
+ * - 推理设置（后端进程数、结果缓存）
  */
 
 #include "settingsdialog.h"
@@ -17,9 +18,11 @@
 #include <QPushButton>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QCheckBox>
 #include <QFileDialog>
 #include <QGroupBox>
 #include <QDialogButtonBox>
+#include <QThread>
 
 namespace GenPreCVSystem {
 namespace Views {
@@ -29,6 +32,11 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     , m_editOpenDir(nullptr)
     , m_editExportDir(nullptr)
     , m_spinMaxRecentFiles(nullptr)
+    , m_spinWorkerCount(nullptr)
+    , m_chkResultCache(nullptr)
+    , m_spinResultCacheSize(nullptr)
+    , m_spinProcessingThreads(nullptr)
+    , m_spinUndoMemory(nullptr)
 {
     setupUI();
     applyStyles();
@@ -42,8 +50,8 @@ SettingsDialog::~SettingsDialog()
 void SettingsDialog::setupUI()
 {
     setWindowTitle(tr("⚙ 设置"));
-    setMinimumSize(450, 250);
-    resize(500, 300);
+    setMinimumSize(450, 380);
+    resize(500, 520);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(15);
@@ -95,6 +103,57 @@ void SettingsDialog::setupUI()
 
     mainLayout->addWidget(generalGroup);
 
+    // ========== 推理设置组 ==========
+    QGroupBox *inferenceGroup = new QGroupBox(tr("🧠 推理设置"), this);
+    QFormLayout *inferenceLayout = new QFormLayout(inferenceGroup);
+    inferenceLayout->setSpacing(10);
+
+    // 后端进程数（每个进程各自加载模型，占用相应内存/显存）
+    m_spinWorkerCount = new QSpinBox();
+    m_spinWorkerCount->setRange(1, qMax(1, QThread::idealThreadCount()));
+    m_spinWorkerCount->setValue(1);
+    m_spinWorkerCount->setToolTip(tr("并行推理的后端进程数，重新启动服务后生效"));
+    inferenceLayout->addRow(tr("推理进程数:"), m_spinWorkerCount);
+
+    // 结果缓存（相同图像、模型和参数不再重复推理）
+    m_chkResultCache = new QCheckBox(tr("缓存推理结果"));
+    m_chkResultCache->setToolTip(tr("同一图像使用相同模型和参数再次推理时直接返回缓存结果"));
+    inferenceLayout->addRow(QString(), m_chkResultCache);
+
+    m_spinResultCacheSize = new QSpinBox();
+    m_spinResultCacheSize->setRange(16, 8192);
+    m_spinResultCacheSize->setSingleStep(64);
+    m_spinResultCacheSize->setSuffix(" MB");
+    m_spinResultCacheSize->setValue(256);
+    inferenceLayout->addRow(tr("结果缓存上限:"), m_spinResultCacheSize);
+    connect(m_chkResultCache, &QCheckBox::toggled, m_spinResultCacheSize, &QSpinBox::setEnabled);
+
+    mainLayout->addWidget(inferenceGroup);
+
+    // ========== 图像处理设置组 ==========
+    QGroupBox *processingGroup = new QGroupBox(tr("🖼 图像处理设置"), this);
+    QFormLayout *processingLayout = new QFormLayout(processingGroup);
+    processingLayout->setSpacing(10);
+
+    // 滤波、边缘检测等按行带并行处理所用的线程数
+    m_spinProcessingThreads = new QSpinBox();
+    m_spinProcessingThreads->setRange(0, qMax(1, QThread::idealThreadCount()));
+    m_spinProcessingThreads->setSpecialValueText(tr("自动"));
+    m_spinProcessingThreads->setValue(0);
+    m_spinProcessingThreads->setToolTip(tr("图像滤波、增强和边缘检测使用的线程数，自动时使用全部 CPU 核心"));
+    processingLayout->addRow(tr("处理线程数:"), m_spinProcessingThreads);
+
+    // 所有标签页的撤销历史共用一个内存上限，超出时最旧的记录写入磁盘
+    m_spinUndoMemory = new QSpinBox();
+    m_spinUndoMemory->setRange(64, 65536);
+    m_spinUndoMemory->setSingleStep(256);
+    m_spinUndoMemory->setSuffix(" MB");
+    m_spinUndoMemory->setValue(1024);
+    m_spinUndoMemory->setToolTip(tr("撤销历史占用内存的上限，超出时较早的步骤会暂存到磁盘"));
+    processingLayout->addRow(tr("撤销内存上限:"), m_spinUndoMemory);
+
+    mainLayout->addWidget(processingGroup);
+
     mainLayout->addStretch();
 
     // ========== 按钮区域 ==========
@@ -166,6 +225,12 @@ void SettingsDialog::loadSettings()
     m_editOpenDir->setText(Utils::AppSettings::defaultOpenDirectory());
     m_editExportDir->setText(Utils::AppSettings::defaultExportDirectory());
     m_spinMaxRecentFiles->setValue(Utils::AppSettings::maxRecentFiles());
+    m_spinWorkerCount->setValue(Utils::AppSettings::inferenceWorkerCount());
+    m_chkResultCache->setChecked(Utils::AppSettings::resultCacheEnabled());
+    m_spinResultCacheSize->setValue(Utils::AppSettings::resultCacheSizeMB());
+    m_spinResultCacheSize->setEnabled(m_chkResultCache->isChecked());
+    m_spinProcessingThreads->setValue(Utils::AppSettings::imageProcessingThreadCount());
+    m_spinUndoMemory->setValue(Utils::AppSettings::undoMemoryBudgetMB());
 }
 
 void SettingsDialog::saveSettings()
@@ -173,6 +238,11 @@ void SettingsDialog::saveSettings()
     Utils::AppSettings::setDefaultOpenDirectory(m_editOpenDir->text());
     Utils::AppSettings::setDefaultExportDirectory(m_editExportDir->text());
     Utils::AppSettings::setMaxRecentFiles(m_spinMaxRecentFiles->value());
+    Utils::AppSettings::setInferenceWorkerCount(m_spinWorkerCount->value());
+    Utils::AppSettings::setResultCacheEnabled(m_chkResultCache->isChecked());
+    Utils::AppSettings::setResultCacheSizeMB(m_spinResultCacheSize->value());
+    Utils::AppSettings::setImageProcessingThreadCount(m_spinProcessingThreads->value());
+    Utils::AppSettings::setUndoMemoryBudgetMB(m_spinUndoMemory->value());
 }
 
 void SettingsDialog::onBrowseOpenDirectory()
@@ -5,6 +5,7 @@
 
 class QLineEdit;
 class QSpinBox;
+class QCheckBox;
 
 namespace GenPreCVSystem {
 namespace Views {
@@ -47,6 +48,13 @@ private:
 
     // 常规设置
     QSpinBox *m_spinMaxRecentFiles;
+    QSpinBox *m_spinWorkerCount;
+    QCheckBox *m_chkResultCache;
+    QSpinBox *m_spinResultCacheSize;
+
+    // 图像处理设置
+    QSpinBox *m_spinProcessingThreads;
+    QSpinBox *m_spinUndoMemory;
 };
 
 } // namespace Views
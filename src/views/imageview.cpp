@@ -70,6 +70,16 @@ void ImageView::setPixmap(const QPixmap &pixmap)
     fitToWindow();
 }
 
+void ImageView::updatePixmap(const QPixmap &pixmap)
+{
+    if (!m_pixmapItem || pixmap.isNull()) {
+        setPixmap(pixmap);
+        return;
+    }
+
+    m_pixmapItem->setPixmap(pixmap);
+}
+
 void ImageView::clearImage()
 {
     clearDetections();
@@ -303,7 +313,12 @@ void ImageView::setSegmentationOverlays(const QVector<DetectionOverlay> &detecti
 {
     // 先清除现有的检测结果
     clearDetections();
+    appendSegmentationOverlays(detections, maskAlpha, showBoxes, showLabels);
+}
 
+void ImageView::appendSegmentationOverlays(const QVector<DetectionOverlay> &detections,
+                                            int maskAlpha, bool showBoxes, bool showLabels)
+{
     if (!m_scene || detections.isEmpty()) {
         return;
     }
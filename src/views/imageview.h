@@ -50,6 +50,12 @@ public:
      */
     void setPixmap(const QPixmap &pixmap);
 
+    /**
+     * @brief 替换图片内容，保留当前缩放、平移和覆盖层
+     * @param pixmap 尺寸与当前图片相同的新图片（无图片时等同于 setPixmap）
+     */
+    void updatePixmap(const QPixmap &pixmap);
+
     /**
      * @brief 清空显示的图片
      */
@@ -99,6 +105,16 @@ public:
     void setSegmentationOverlays(const QVector<DetectionOverlay> &detections,
                                   int maskAlpha = 50, bool showBoxes = false, bool showLabels = true);
 
+    /**
+     * @brief 在现有覆盖层之上追加分割结果（用于流式结果逐块显示）
+     * @param detections 新增的检测结果
+     * @param maskAlpha 掩码透明度 (0-100)
+     * @param showBoxes 是否显示边界框
+     * @param showLabels 是否显示标签
+     */
+    void appendSegmentationOverlays(const QVector<DetectionOverlay> &detections,
+                                     int maskAlpha = 50, bool showBoxes = false, bool showLabels = true);
+
     /**
      * @brief 清除检测结果覆盖层
      */
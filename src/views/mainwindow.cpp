@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "taskcontroller.h"
+#include "imagecontroller.h"
 #include "parameterpanelfactory.h"
 #include "recentfilesmanager.h"
 #include "appsettings.h"
@@ -8,6 +9,13 @@
 #include "batchprocessdialog.h"
 #include "environmentcachemanager.h"
 #include "dlservice.h"
+#include "editgraph.h"
+#include "imagehistory.h"
+#include "tiledexecutor.h"
+#include "tiledimage.h"
+#include "imageloader.h"
+#include "tiledimageitem.h"
+#include "pyramidpixmapitem.h"
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDir>
@@ -17,6 +25,7 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileInfo>
+#include <QImageReader>
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <QResizeEvent>
@@ -48,6 +57,7 @@
 #include <QScrollArea>
 #include <QSlider>
 #include <QIcon>
+#include <QtConcurrent>
 #include <cmath>
 
 using namespace GenPreCVSystem::Utils;
@@ -62,8 +72,11 @@ ImageView::ImageView(QWidget *parent)
     : QGraphicsView(parent)
     , m_scene(nullptr)
     , m_pixmapItem(nullptr)
+    , m_tiledItem(nullptr)
+    , m_pyramidItem(nullptr)
     , m_scaleFactor(1.0)
     , m_dragging(false)
+    , m_editPreviewItem(nullptr)
 {
     // 创建图形场景
     m_scene = new QGraphicsScene(this);
@@ -91,35 +104,228 @@ ImageView::ImageView(QWidget *parent)
     setCacheMode(QGraphicsView::CacheBackground);
 }
 
+ImageView::~ImageView()
+{
+    cancelPyramid();
+}
+
 /**
  * @brief 设置要显示的图片
  * @param pixmap 图片数据
  */
 void ImageView::setPixmap(const QPixmap &pixmap)
 {
+    setImage(ImageBuffer(pixmap));
+}
+
+/**
+ * @brief 设置要显示的图片，与调用方共享句柄
+ */
+void ImageView::setImage(const ImageBuffer &image)
+{
+    // 替换解码期间的预览或同尺寸的编辑结果时保持用户已调整的缩放和平移
+    const bool keepView = hasImage() && imageSize() == image.size();
+
     // 清空场景
+    cancelPyramid();
     m_scene->clear();
     m_pixmapItem = nullptr;
-
-    if (pixmap.isNull()) {
+    m_pyramidItem = nullptr;
+    m_tiledItem = nullptr;
+    m_editPreviewItem = nullptr;
+    m_previewSource = QPixmap();
+    m_loadingSize = QSize();
+    m_image = image;
+
+    if (image.isNull()) {
         return;
     }
 
-    // 创建图片项并添加到场景
-    m_pixmapItem = m_scene->addPixmap(pixmap);
+    // 创建图片项并添加到场景（QPixmap 由句柄转换一次后缓存）
+    const QPixmap pixmap = image.pixmap();
+    m_pyramidItem = new GenPreCVSystem::Views::PyramidPixmapItem(pixmap);
+    m_pixmapItem = m_pyramidItem;
+    m_scene->addItem(m_pyramidItem);
     m_scene->setSceneRect(pixmap.rect());
 
     // 自适应窗口大小
+    if (!keepView) {
+        fitToWindow();
+    }
+    buildPyramid();
+}
+
+/**
+ * @brief 设置要显示的分块图像
+ */
+void ImageView::setTiledImage(const std::shared_ptr<GenPreCVSystem::Utils::TiledImage> &image)
+{
+    const bool keepView = image && isLoading() && m_loadingSize == image->size();
+
+    cancelPyramid();
+    m_scene->clear();
+    m_pixmapItem = nullptr;
+    m_pyramidItem = nullptr;
+    m_tiledItem = nullptr;
+    m_editPreviewItem = nullptr;
+    m_previewSource = QPixmap();
+    m_loadingSize = QSize();
+    m_image = ImageBuffer();
+
+    if (!image) {
+        return;
+    }
+
+    m_tiledItem = new GenPreCVSystem::Views::TiledImageItem(image);
+    m_scene->addItem(m_tiledItem);
+    m_scene->setSceneRect(image->rect());
+
+    if (!keepView) {
+        fitToWindow();
+    }
+    buildPyramid();
+}
+
+/**
+ * @brief 原图解码期间显示的低分辨率预览
+ */
+void ImageView::setLoadingPreview(const QPixmap &preview, const QSize &imageSize)
+{
+    cancelPyramid();
+    m_scene->clear();
+    m_pixmapItem = nullptr;
+    m_pyramidItem = nullptr;
+    m_tiledItem = nullptr;
+    m_editPreviewItem = nullptr;
+    m_previewSource = QPixmap();
+    m_loadingSize = QSize();
+    m_image = ImageBuffer();
+
+    if (preview.isNull() || imageSize.isEmpty()) {
+        return;
+    }
+
+    // 与处理预览相同，场景坐标以原图像素为单位
+    m_pixmapItem = m_scene->addPixmap(preview);
+    m_pixmapItem->setTransformationMode(Qt::SmoothTransformation);
+    m_pixmapItem->setTransform(QTransform::fromScale(
+        static_cast<double>(imageSize.width()) / preview.width(),
+        static_cast<double>(imageSize.height()) / preview.height()));
+    m_scene->setSceneRect(QRect(QPoint(0, 0), imageSize));
+    m_loadingSize = imageSize;
+
     fitToWindow();
 }
 
+/**
+ * @brief 当前显示的分块图像
+ */
+std::shared_ptr<GenPreCVSystem::Utils::TiledImage> ImageView::tiledImage() const
+{
+    return m_tiledItem ? m_tiledItem->image() : nullptr;
+}
+
+/**
+ * @brief 原图尺寸
+ */
+QSize ImageView::imageSize() const
+{
+    if (isLoading()) {
+        return m_loadingSize;
+    }
+    if (m_tiledItem) {
+        return m_tiledItem->image()->size();
+    }
+    return pixmap().size();
+}
+
+QGraphicsItem *ImageView::imageItem() const
+{
+    if (m_tiledItem) {
+        return m_tiledItem;
+    }
+    return m_pixmapItem;
+}
+
+/**
+ * @brief 在后台生成金字塔层
+ *
+ * 任务持有取消标志的副本；图片被替换或视图销毁时置位，任务在层与层之间退出，
+ * 已完成的结果也因标志不再是当前标志而被丢弃。
+ */
+void ImageView::buildPyramid()
+{
+    cancelPyramid();
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    m_pyramidCancel = cancel;
+
+    if (m_tiledItem) {
+        const std::shared_ptr<TiledImage> image = m_tiledItem->image();
+        const qint64 sourceKey = image->cacheKey();
+        // 缩略图对应的层及更小的层直接使用缩略图
+        QFuture<QVector<std::shared_ptr<TiledImage>>> future = QtConcurrent::run([image, cancel]() {
+            QVector<std::shared_ptr<TiledImage>> levels;
+            std::shared_ptr<TiledImage> current = image;
+            for (int level = 1; level < image->overviewLevel() && !*cancel; ++level) {
+                current = TiledImage::halve(*current);
+                if (!current) {
+                    break;
+                }
+                levels.append(current);
+            }
+            return levels;
+        });
+        onFutureFinished(future, this, [this, cancel, sourceKey](const QVector<std::shared_ptr<TiledImage>> &levels) {
+            if (cancel == m_pyramidCancel && m_tiledItem) {
+                m_tiledItem->setLevels(sourceKey, levels);
+            }
+        });
+        return;
+    }
+
+    if (!m_pyramidItem) {
+        return;
+    }
+    const QPixmap pixmap = m_pyramidItem->pixmap();
+    if (pixmap.width() <= GenPreCVSystem::Views::PyramidPixmapItem::MIN_PYRAMID_SIZE
+        && pixmap.height() <= GenPreCVSystem::Views::PyramidPixmapItem::MIN_PYRAMID_SIZE) {
+        return;
+    }
+
+    const qint64 sourceKey = pixmap.cacheKey();
+    const QImage image = m_image.image();
+    QFuture<QVector<QImage>> future = QtConcurrent::run([image, cancel]() {
+        return GenPreCVSystem::Views::PyramidPixmapItem::buildLevels(image, cancel.get());
+    });
+    onFutureFinished(future, this, [this, cancel, sourceKey](const QVector<QImage> &levels) {
+        if (cancel == m_pyramidCancel && m_pyramidItem) {
+            m_pyramidItem->setLevels(sourceKey, levels);
+        }
+    });
+}
+
+void ImageView::cancelPyramid()
+{
+    if (m_pyramidCancel) {
+        *m_pyramidCancel = true;
+        m_pyramidCancel.reset();
+    }
+}
+
 /**
  * @brief 清空显示的图片
  */
 void ImageView::clearImage()
 {
+    cancelPyramid();
     m_scene->clear();
     m_pixmapItem = nullptr;
+    m_pyramidItem = nullptr;
+    m_tiledItem = nullptr;
+    m_editPreviewItem = nullptr;
+    m_previewSource = QPixmap();
+    m_loadingSize = QSize();
+    m_image = ImageBuffer();
     m_scaleFactor = 1.0;
     resetTransform();
 }
@@ -130,7 +336,7 @@ void ImageView::clearImage()
  */
 void ImageView::scaleImage(double factor)
 {
-    if (!m_pixmapItem) {
+    if (!hasImage()) {
         return;
     }
 
@@ -149,13 +355,13 @@ void ImageView::scaleImage(double factor)
  */
 void ImageView::fitToWindow()
 {
-    if (!m_pixmapItem) {
+    if (!hasImage()) {
         return;
     }
 
     // 获取视图和图片尺寸
     QSize viewSize = viewport()->size();
-    QSize imageSize = m_pixmapItem->pixmap().size();
+    QSize imageSize = this->imageSize();
 
     if (imageSize.isEmpty()) {
         return;
@@ -172,7 +378,7 @@ void ImageView::fitToWindow()
     m_scaleFactor = scaleFactor;
 
     // 居中显示
-    centerOn(m_pixmapItem);
+    centerOn(imageItem());
 }
 
 /**
@@ -180,13 +386,13 @@ void ImageView::fitToWindow()
  */
 void ImageView::actualSize()
 {
-    if (!m_pixmapItem) {
+    if (!hasImage()) {
         return;
     }
 
     resetTransform();
     m_scaleFactor = 1.0;
-    centerOn(m_pixmapItem);
+    centerOn(imageItem());
 }
 
 /**
@@ -194,10 +400,106 @@ void ImageView::actualSize()
  */
 QPixmap ImageView::pixmap() const
 {
+    return image().pixmap();
+}
+
+/**
+ * @brief 当前显示的图片句柄
+ */
+ImageBuffer ImageView::image() const
+{
+    if (isLoading() || m_tiledItem) {
+        return ImageBuffer();
+    }
+    return m_image;
+}
+
+/**
+ * @brief 临时显示处理预览
+ */
+void ImageView::setPreviewPixmap(const QPixmap &preview)
+{
+    if (!hasImage() || isLoading() || preview.isNull()) {
+        return;
+    }
+
+    // 分块显示时预览作为覆盖在分块图像上的图层，移除图层即恢复原图
+    if (m_tiledItem) {
+        if (!m_pixmapItem) {
+            m_pixmapItem = m_scene->addPixmap(QPixmap());
+            m_pixmapItem->setZValue(1);
+        }
+        const QSize size = imageSize();
+        m_pixmapItem->setPixmap(preview);
+        m_pixmapItem->setTransform(QTransform::fromScale(
+            static_cast<double>(size.width()) / preview.width(),
+            static_cast<double>(size.height()) / preview.height()));
+        return;
+    }
+
+    if (m_previewSource.isNull()) {
+        m_previewSource = m_pixmapItem->pixmap();
+    }
+
+    // 场景坐标仍以原图像素为单位，视图的缩放比例和平移位置不受影响
+    m_pixmapItem->setPixmap(preview);
+    m_pixmapItem->setTransform(QTransform::fromScale(
+        static_cast<double>(m_previewSource.width()) / preview.width(),
+        static_cast<double>(m_previewSource.height()) / preview.height()));
+}
+
+/**
+ * @brief 取消预览，恢复显示原图
+ */
+void ImageView::clearPreview()
+{
+    if (m_tiledItem && m_pixmapItem) {
+        m_scene->removeItem(m_pixmapItem);
+        delete m_pixmapItem;
+        m_pixmapItem = nullptr;
+        return;
+    }
+
+    if (m_previewSource.isNull()) {
+        return;
+    }
+
     if (m_pixmapItem) {
-        return m_pixmapItem->pixmap();
+        m_pixmapItem->setPixmap(m_previewSource);
+        m_pixmapItem->setTransform(QTransform());
     }
-    return QPixmap();
+    m_previewSource = QPixmap();
+}
+
+/**
+ * @brief 在 region 处覆盖显示编辑结果的可见区域
+ */
+void ImageView::setEditPreview(const QPixmap &preview, const QRect &region)
+{
+    if (!hasImage() || isLoading() || preview.isNull() || region.isEmpty()) {
+        return;
+    }
+
+    // 位于原图和处理预览之上，setImage() 清空场景时一并移除
+    if (!m_editPreviewItem) {
+        m_editPreviewItem = m_scene->addPixmap(QPixmap());
+        m_editPreviewItem->setTransformationMode(Qt::SmoothTransformation);
+        m_editPreviewItem->setZValue(2);
+    }
+    m_editPreviewItem->setPixmap(preview);
+    m_editPreviewItem->setPos(region.topLeft());
+    m_editPreviewItem->setTransform(QTransform::fromScale(
+        static_cast<double>(region.width()) / preview.width(),
+        static_cast<double>(region.height()) / preview.height()));
+}
+
+/**
+ * @brief 视口中可见的图像区域
+ */
+QRect ImageView::visibleImageRect() const
+{
+    const QRect visible = mapToScene(viewport()->rect()).boundingRect().toAlignedRect();
+    return visible & QRect(QPoint(0, 0), imageSize());
 }
 
 /**
@@ -205,7 +507,7 @@ QPixmap ImageView::pixmap() const
  */
 void ImageView::wheelEvent(QWheelEvent *event)
 {
-    if (!m_pixmapItem) {
+    if (!hasImage()) {
         return;
     }
 
@@ -238,7 +540,7 @@ void ImageView::mousePressEvent(QMouseEvent *event)
  */
 void ImageView::mouseMoveEvent(QMouseEvent *event)
 {
-    if (m_dragging && m_pixmapItem) {
+    if (m_dragging && hasImage()) {
         QPoint delta = event->pos() - m_lastPanPoint;
         m_lastPanPoint = event->pos();
 
@@ -268,7 +570,7 @@ void ImageView::resizeEvent(QResizeEvent *event)
 {
     QGraphicsView::resizeEvent(event);
     // 窗口大小改变时重新适应窗口
-    if (m_pixmapItem) {
+    if (hasImage()) {
         fitToWindow();
     }
 }
@@ -443,6 +745,7 @@ MainWindow::MainWindow(QWidget *parent)
     , textEditLog(nullptr)
     , taskActionGroup(nullptr)
     , m_currentTask(CVTask::ImageClassification)
+    , m_imageController(nullptr)
     , m_recentFilesManager(nullptr)
     , m_batchProcessDialog(nullptr)
 {
@@ -458,6 +761,13 @@ MainWindow::MainWindow(QWidget *parent)
         }
     }
 
+    // 编辑操作记录到当前标签页的编辑链，切换标签页时重新设置
+    m_imageController = new GenPreCVSystem::Controllers::ImageController(this);
+    connect(m_imageController, &GenPreCVSystem::Controllers::ImageController::imageChanged,
+            this, &MainWindow::onEditResultChanged);
+    connect(m_imageController, &GenPreCVSystem::Controllers::ImageController::operationFailed,
+            this, &MainWindow::logMessage);
+
     // 必须先创建停靠窗口（包括 paramScrollArea），然后才能初始化任务菜单
     setupImageViewer();
     setupDockWidgets();
@@ -469,6 +779,10 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_recentFilesManager, &GenPreCVSystem::Utils::RecentFilesManager::recentFileTriggered,
             this, &MainWindow::onRecentFileTriggered);
 
+    // 所有标签页的撤销历史共用的内存上限
+    GenPreCVSystem::Utils::HistoryStore::instance().setMemoryBudget(
+        qint64(GenPreCVSystem::Utils::AppSettings::undoMemoryBudgetMB()) << 20);
+
     logMessage("应用程序已启动");
     logMessage("提示：使用\"文件\"菜单打开图片，或双击文件浏览器中的图片");
     logMessage("提示：切换到\"任务\"→\"目标检测\"或\"语义分割\"可使用 DL 推理功能");
@@ -479,6 +793,15 @@ MainWindow::MainWindow(QWidget *parent)
  */
 MainWindow::~MainWindow()
 {
+    // 后台解码和编辑结果求值不再需要
+    for (const TabData &tabData : m_tabData) {
+        if (tabData.loading) {
+            *tabData.loading = true;
+        }
+        if (tabData.editCommit) {
+            *tabData.editCommit = true;
+        }
+    }
     delete ui;
 }
 
@@ -513,13 +836,6 @@ void MainWindow::setupImageViewer()
  */
 bool MainWindow::loadImage(const QString &filePath)
 {
-    QPixmap pixmap(filePath);
-
-    if (pixmap.isNull()) {
-        logMessage(QString("加载失败: %1").arg(filePath));
-        return false;
-    }
-
     QFileInfo fileInfo(filePath);
     QString fileName = fileInfo.fileName();
 
@@ -533,34 +849,85 @@ bool MainWindow::loadImage(const QString &filePath)
         }
     }
 
-    // 创建新的标签页
-    ImageView *imageView = new ImageView(tabWidget);
-    imageView->setPixmap(pixmap);
+    // 只读取文件头，无法解码的文件不创建标签页
+    QString errorMsg;
+    if (!ImageLoader::canLoad(filePath, nullptr, &errorMsg)) {
+        logMessage(QString("加载失败: %1 (%2)").arg(filePath, errorMsg));
+        return false;
+    }
 
-    // 添加标签页
+    // 立即创建标签页，图片在后台解码
+    ImageView *imageView = new ImageView(tabWidget);
     int index = tabWidget->addTab(imageView, fileName);
-    tabWidget->setCurrentIndex(index);
 
-    // 初始化标签页数据
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
     TabData tabData;
     tabData.imagePath = filePath;
-    tabData.pixmap = pixmap;
+    tabData.history = std::make_shared<GenPreCVSystem::Utils::ImageHistory>();
+    tabData.history->setMaxSteps(MAX_UNDO_STEPS);
+    tabData.loading = cancel;
     m_tabData[index] = tabData;
 
-    // 更新当前引用
+    tabWidget->setCurrentIndex(index);
     updateCurrentTabRef();
 
+    // 预览与原图同时解码；回调以视图为上下文，标签页关闭后不会被调用
+    onFutureFinished(ImageLoader::loadPreviewAsync(filePath, ImageLoader::PREVIEW_SIZE, cancel), imageView,
+                     [imageView, cancel](const ImageLoadResult &result) {
+        if (!*cancel && !imageView->hasImage() && !result.image.isNull()) {
+            imageView->setLoadingPreview(QPixmap::fromImage(result.image), result.imageSize);
+        }
+    });
+    onFutureFinished(ImageLoader::loadAsync(filePath, cancel), imageView,
+                     [this, imageView](const ImageLoadResult &result) {
+        onImageLoaded(imageView, result);
+    });
+
+    logMessage(QString("正在加载图片: %1").arg(fileName));
+    return true;
+}
+
+/**
+ * @brief 后台解码完成
+ */
+void MainWindow::onImageLoaded(ImageView *imageView, const ImageLoadResult &result)
+{
+    const int index = tabWidget->indexOf(imageView);
+    if (index < 0 || !m_tabData.contains(index) || result.cancelled) {
+        return;
+    }
+
+    TabData &tabData = m_tabData[index];
+    tabData.loading.reset();
+    const QString fileName = QFileInfo(tabData.imagePath).fileName();
+    if (!result.success) {
+        logMessage(QString("加载失败: %1 (%2)").arg(tabData.imagePath, result.message));
+        onTabCloseRequested(index);
+        return;
+    }
+
+    if (result.tiles) {
+        imageView->setTiledImage(result.tiles);
+    } else {
+        tabData.image = ImageBuffer(result.image);
+        imageView->setImage(tabData.image);
+    }
+
     // 添加到最近文件列表
     if (m_recentFilesManager) {
-        m_recentFilesManager->addFile(filePath);
+        m_recentFilesManager->addFile(tabData.imagePath);
     }
 
-    logMessage(QString("已加载图片: %1 [%2x%3]")
-        .arg(fileName)
-        .arg(pixmap.width())
-        .arg(pixmap.height()));
+    if (index == tabWidget->currentIndex()) {
+        updateCurrentTabRef();
+        updateUndoRedoState();
+    }
 
-    return true;
+    logMessage(QString("已加载图片: %1 [%2x%3]%4")
+        .arg(fileName)
+        .arg(result.imageSize.width())
+        .arg(result.imageSize.height())
+        .arg(result.tiles ? " (分块显示)" : ""));
 }
 
 /**
@@ -851,7 +1218,7 @@ void MainWindow::on_actionCloseImage_triggered()
  */
 void MainWindow::on_actionSaveImage_triggered()
 {
-    if (m_currentImagePath.isEmpty() || m_currentPixmap.isNull()) {
+    if (m_currentImagePath.isEmpty() || !ensureCurrentPixmap()) {
         QMessageBox::warning(this, "提示", "没有可保存的图片");
         return;
     }
@@ -871,7 +1238,7 @@ void MainWindow::on_actionSaveImage_triggered()
             return;
         } else if (choice == 1) {
             // 保存副本
-            if (m_currentPixmap.save(previewPath)) {
+            if (m_currentImage.image().save(previewPath)) {
                 logMessage(QString("已保存副本: %1").arg(previewPath));
                 return;
             } else {
@@ -883,7 +1250,7 @@ void MainWindow::on_actionSaveImage_triggered()
     }
 
     // 直接保存到原路径
-    if (m_currentPixmap.save(m_currentImagePath)) {
+    if (m_currentImage.image().save(m_currentImagePath)) {
         logMessage(QString("已保存: %1").arg(m_currentImagePath));
     } else {
         QMessageBox::warning(this, "错误", "保存失败");
@@ -895,7 +1262,7 @@ void MainWindow::on_actionSaveImage_triggered()
  */
 void MainWindow::on_actionSaveImageAs_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureCurrentPixmap()) {
         QMessageBox::warning(this, "提示", "没有可保存的图片");
         return;
     }
@@ -906,7 +1273,7 @@ void MainWindow::on_actionSaveImageAs_triggered()
     );
 
     if (!fileName.isEmpty()) {
-        if (m_currentPixmap.save(fileName)) {
+        if (m_currentImage.image().save(fileName)) {
             logMessage(QString("已保存: %1").arg(fileName));
             m_currentImagePath = fileName;
             if (m_taskController) {
@@ -923,7 +1290,7 @@ void MainWindow::on_actionSaveImageAs_triggered()
  */
 void MainWindow::on_actionExport_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureCurrentPixmap()) {
         QMessageBox::warning(this, "提示", "没有可导出的图片");
         return;
     }
@@ -938,7 +1305,7 @@ void MainWindow::on_actionExport_triggered()
     );
 
     if (!fileName.isEmpty()) {
-        if (m_currentPixmap.save(fileName)) {
+        if (m_currentImage.image().save(fileName)) {
             logMessage(QString("图片已导出: %1").arg(fileName));
             QMessageBox::information(this, "成功", "图片导出成功！");
         } else {
@@ -962,24 +1329,13 @@ void MainWindow::on_actionExit_triggered()
  */
 void MainWindow::on_actionUndo_triggered()
 {
-    if (m_undoStack.isEmpty()) {
-        logMessage("没有可撤销的操作");
+    // 编辑链只移出最后一个操作，上游的缓存仍然可用；
+    // 编辑链撤销到头后由增量历史恢复并入原图之前的原图。显示由 onEditResultChanged() 更新
+    if (!m_imageController->undo()) {
         return;
     }
 
-    // 将当前状态保存到重做栈
-    m_redoStack.push(m_currentPixmap);
-
-    // 从撤销栈弹出上一个状态
-    m_currentPixmap = m_undoStack.pop();
-
-    // 更新显示
-    currentImageView()->setPixmap(m_currentPixmap);
-
-    // 更新按钮状态
-    updateUndoRedoState();
-
-    logMessage(QString("撤销 (剩余步骤: %1)").arg(m_undoStack.size()));
+    logMessage(QString("撤销 (剩余步骤: %1)").arg(m_imageController->undoCount()));
 }
 
 /**
@@ -987,24 +1343,13 @@ void MainWindow::on_actionUndo_triggered()
  */
 void MainWindow::on_actionRedo_triggered()
 {
-    if (m_redoStack.isEmpty()) {
-        logMessage("没有可重做的操作");
+    if (!m_imageController->redo()) {
+        // 重做记录已失效时按钮状态随之改变
+        updateUndoRedoState();
         return;
     }
 
-    // 将当前状态保存到撤销栈
-    m_undoStack.push(m_currentPixmap);
-
-    // 从重做栈弹出状态
-    m_currentPixmap = m_redoStack.pop();
-
-    // 更新显示
-    currentImageView()->setPixmap(m_currentPixmap);
-
-    // 更新按钮状态
-    updateUndoRedoState();
-
-    logMessage(QString("重做 (剩余步骤: %1)").arg(m_redoStack.size()));
+    logMessage(QString("重做 (剩余步骤: %1)").arg(m_imageController->redoCount()));
 }
 
 /**
@@ -1032,7 +1377,7 @@ void MainWindow::on_actionCopyImage_triggered()
         }
     }
 
-    if (m_currentPixmap.isNull()) {
+    if (!ensureCurrentPixmap()) {
         QMessageBox::warning(this, "提示", "没有可复制的图片");
         return;
     }
@@ -1041,7 +1386,7 @@ void MainWindow::on_actionCopyImage_triggered()
     QMimeData *mimeData = new QMimeData();
 
     // 1. 设置图片数据 - 用于在图片编辑器、Word等应用中粘贴图片内容
-    mimeData->setImageData(m_currentPixmap.toImage());
+    mimeData->setImageData(m_currentImage.image());
 
     // 2. 如果有文件路径，同时设置文件引用 - 用于在文件管理器中粘贴文件副本
     if (!m_currentImagePath.isEmpty()) {
@@ -1144,16 +1489,11 @@ void MainWindow::on_actionPaste_triggered()
  */
 void MainWindow::on_actionRotateLeft_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         return;
     }
 
-    saveState();  // 保存当前状态到撤销栈
-
-    QTransform transform;
-    transform.rotate(-90);
-    m_currentPixmap = m_currentPixmap.transformed(transform);
-    currentImageView()->setPixmap(m_currentPixmap);
+    m_imageController->rotateLeft();
     logMessage("向左旋转90°");
 }
 
@@ -1162,16 +1502,11 @@ void MainWindow::on_actionRotateLeft_triggered()
  */
 void MainWindow::on_actionRotateRight_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         return;
     }
 
-    saveState();  // 保存当前状态到撤销栈
-
-    QTransform transform;
-    transform.rotate(90);
-    m_currentPixmap = m_currentPixmap.transformed(transform);
-    currentImageView()->setPixmap(m_currentPixmap);
+    m_imageController->rotateRight();
     logMessage("向右旋转90°");
 }
 
@@ -1180,14 +1515,11 @@ void MainWindow::on_actionRotateRight_triggered()
  */
 void MainWindow::on_actionFlipHorizontal_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         return;
     }
 
-    saveState();  // 保存当前状态到撤销栈
-
-    m_currentPixmap = m_currentPixmap.transformed(QTransform().scale(-1, 1));
-    currentImageView()->setPixmap(m_currentPixmap);
+    m_imageController->flipHorizontal();
     logMessage("水平翻转");
 }
 
@@ -1196,14 +1528,11 @@ void MainWindow::on_actionFlipHorizontal_triggered()
  */
 void MainWindow::on_actionFlipVertical_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         return;
     }
 
-    saveState();  // 保存当前状态到撤销栈
-
-    m_currentPixmap = m_currentPixmap.transformed(QTransform().scale(1, -1));
-    currentImageView()->setPixmap(m_currentPixmap);
+    m_imageController->flipVertical();
     logMessage("垂直翻转");
 }
 
@@ -1276,44 +1605,21 @@ void MainWindow::on_actionShowLogOutput_triggered(bool checked)
  */
 void MainWindow::on_actionGrayscale_triggered(bool checked)
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         QMessageBox::warning(this, "提示", "请先打开图片");
         ui->actionGrayscale->setChecked(false);
         return;
     }
 
     if (checked) {
-        // 应用灰度化
-        saveState();
-
-        // 保存原始图片（如果还没有保存）
-        if (!m_isGrayscale && !m_isInverted) {
-            m_originalPixmap = m_currentPixmap;
-        }
-
-        QImage image = m_currentPixmap.toImage();
-        for (int y = 0; y < image.height(); ++y) {
-            for (int x = 0; x < image.width(); ++x) {
-                QRgb pixel = image.pixel(x, y);
-                int gray = qGray(pixel);
-                image.setPixel(x, y, qRgb(gray, gray, gray));
-            }
-        }
-
-        m_currentPixmap = QPixmap::fromImage(image);
-        currentImageView()->setPixmap(m_currentPixmap);
-        m_isGrayscale = true;
+        m_imageController->toGrayscale();
         logMessage("已转换为灰度图");
     } else {
-        // 取消灰度化 - 恢复原始图片
-        if (!m_originalPixmap.isNull()) {
-            m_currentPixmap = m_originalPixmap;
-            currentImageView()->setPixmap(m_currentPixmap);
-            m_isGrayscale = false;
-            m_isInverted = false;
-            ui->actionInvert->setChecked(false);
-            logMessage("已恢复原始图片");
+        // 只从编辑链中移除灰度化，其后的编辑保留并重新求值
+        if (m_imageController->removeGrayscale()) {
+            logMessage("已取消灰度化");
         }
+        updateUndoRedoState();
     }
 }
 
@@ -1322,38 +1628,21 @@ void MainWindow::on_actionGrayscale_triggered(bool checked)
  */
 void MainWindow::on_actionInvert_triggered(bool checked)
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         QMessageBox::warning(this, "提示", "请先打开图片");
         ui->actionInvert->setChecked(false);
         return;
     }
 
     if (checked) {
-        // 应用反色
-        saveState();
-
-        // 保存原始图片（如果还没有保存）
-        if (!m_isGrayscale && !m_isInverted) {
-            m_originalPixmap = m_currentPixmap;
-        }
-
-        QImage image = m_currentPixmap.toImage();
-        image.invertPixels();
-
-        m_currentPixmap = QPixmap::fromImage(image);
-        currentImageView()->setPixmap(m_currentPixmap);
-        m_isInverted = true;
+        m_imageController->invert();
         logMessage("已反色");
     } else {
-        // 取消反色 - 恢复原始图片
-        if (!m_originalPixmap.isNull()) {
-            m_currentPixmap = m_originalPixmap;
-            currentImageView()->setPixmap(m_currentPixmap);
-            m_isGrayscale = false;
-            m_isInverted = false;
-            ui->actionGrayscale->setChecked(false);
-            logMessage("已恢复原始图片");
+        // 只从编辑链中移除反色，其后的编辑保留并重新求值
+        if (m_imageController->removeInvert()) {
+            logMessage("已取消反色");
         }
+        updateUndoRedoState();
     }
 }
 
@@ -1362,7 +1651,7 @@ void MainWindow::on_actionInvert_triggered(bool checked)
  */
 void MainWindow::on_actionBlur_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         QMessageBox::warning(this, "提示", "请先打开图片");
         return;
     }
@@ -1371,12 +1660,7 @@ void MainWindow::on_actionBlur_triggered()
     int radius = QInputDialog::getInt(this, "模糊处理", "模糊半径:", 3, 1, 20, 1, &ok);
 
     if (ok) {
-        saveState();  // 保存当前状态到撤销栈
-
-        QImage image = m_currentPixmap.toImage();
-        QImage blurred = gaussianBlur(image, radius);
-        m_currentPixmap = QPixmap::fromImage(blurred);
-        currentImageView()->setPixmap(m_currentPixmap);
+        m_imageController->blur(radius);
         logMessage(QString("模糊处理 (半径=%1)").arg(radius));
     }
 }
@@ -1386,7 +1670,7 @@ void MainWindow::on_actionBlur_triggered()
  */
 void MainWindow::on_actionSharpen_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         QMessageBox::warning(this, "提示", "请先打开图片");
         return;
     }
@@ -1395,12 +1679,7 @@ void MainWindow::on_actionSharpen_triggered()
     double strength = QInputDialog::getDouble(this, "锐化处理", "锐化强度:", 1.0, 0.1, 5.0, 1, &ok);
 
     if (ok) {
-        saveState();  // 保存当前状态到撤销栈
-
-        QImage image = m_currentPixmap.toImage();
-        QImage sharpened = sharpenImage(image, strength);
-        m_currentPixmap = QPixmap::fromImage(sharpened);
-        currentImageView()->setPixmap(m_currentPixmap);
+        m_imageController->sharpen(strength);
         logMessage(QString("锐化处理 (强度=%1)").arg(strength));
     }
 }
@@ -1410,7 +1689,7 @@ void MainWindow::on_actionSharpen_triggered()
  */
 void MainWindow::on_actionThreshold_triggered()
 {
-    if (m_currentPixmap.isNull()) {
+    if (!ensureEditGraph()) {
         QMessageBox::warning(this, "提示", "请先打开图片");
         return;
     }
@@ -1419,18 +1698,7 @@ void MainWindow::on_actionThreshold_triggered()
     int threshold = QInputDialog::getInt(this, "二值化", "阈值:", 128, 0, 255, 1, &ok);
 
     if (ok) {
-        saveState();  // 保存当前状态到撤销栈
-
-        QImage image = m_currentPixmap.toImage().convertToFormat(QImage::Format_Grayscale8);
-        for (int y = 0; y < image.height(); ++y) {
-            for (int x = 0; x < image.width(); ++x) {
-                uint8_t pixel = image.bits()[y * image.bytesPerLine() + x];
-                image.bits()[y * image.bytesPerLine() + x] = (pixel >= threshold) ? 255 : 0;
-            }
-        }
-
-        m_currentPixmap = QPixmap::fromImage(image);
-        currentImageView()->setPixmap(m_currentPixmap);
+        m_imageController->threshold(threshold);
         logMessage(QString("二值化 (阈值=%1)").arg(threshold));
     }
 }
@@ -1536,6 +1804,22 @@ void MainWindow::on_actionSettings_triggered()
                     m_currentBrowsePath = defaultDir;
                     labelCurrentPath->setText(defaultDir);
                 }
+
+                // 图像处理线程数立即生效
+                GenPreCVSystem::Utils::TiledExecutor::setThreadCount(
+                    GenPreCVSystem::Utils::AppSettings::imageProcessingThreadCount());
+                GenPreCVSystem::Utils::HistoryStore::instance().setMemoryBudget(
+                    qint64(GenPreCVSystem::Utils::AppSettings::undoMemoryBudgetMB()) << 20);
+
+                // 推理进程数在下次启动服务时生效，结果缓存设置立即生效
+                if (m_taskController && m_taskController->dlService()) {
+                    m_taskController->dlService()->setWorkerCount(
+                        GenPreCVSystem::Utils::AppSettings::inferenceWorkerCount());
+                    m_taskController->dlService()->setResultCacheEnabled(
+                        GenPreCVSystem::Utils::AppSettings::resultCacheEnabled());
+                    m_taskController->dlService()->setResultCacheLimit(
+                        GenPreCVSystem::Utils::AppSettings::resultCacheSizeMB());
+                }
             });
 
     dialog.exec();
@@ -2630,38 +2914,142 @@ void MainWindow::onFolderDropped(const QString &folderPath)
 // ==================== 撤销/重做辅助函数 ====================
 
 /**
- * @brief 保存当前状态到撤销栈
+ * @brief 确保当前图片的像素在内存中
  *
- * 在执行任何修改操作前调用此函数保存当前状态
+ * 分块显示的大图在编辑、保存、复制时才整幅读出，编辑后的结果按普通图片显示。
+ * 完整的编辑结果仍在后台求值时在这里直接求出，保存、复制得到的是最新的结果。
+ * @return 没有图片或读取失败时返回 false
  */
-void MainWindow::saveState()
+bool MainWindow::ensureCurrentPixmap()
 {
-    if (m_currentPixmap.isNull()) {
-        return;
+    const int index = tabWidget->currentIndex();
+    if (m_tabData.contains(index) && m_tabData[index].editCommit) {
+        TabData &tabData = m_tabData[index];
+        *tabData.editCommit = true;
+        tabData.editCommit.reset();
+        setEditResult(currentImageView(), ImageBuffer(tabData.editGraph->result()));
     }
 
-    // 将当前状态压入撤销栈
-    m_undoStack.push(m_currentPixmap);
+    if (m_currentImage.isNull() && m_currentTiles) {
+        m_currentImage = ImageBuffer(m_currentTiles->toImage());
+        if (m_currentImage.isNull()) {
+            logMessage("图片过大，无法整幅读入内存");
+        }
+    }
+    return !m_currentImage.isNull();
+}
 
-    // 限制栈的大小，避免内存占用过大
-    if (m_undoStack.size() > MAX_UNDO_STEPS) {
-        m_undoStack.remove(0);  // 移除最旧的状态
+/**
+ * @brief 确保当前标签页有编辑链
+ *
+ * 编辑链在首次编辑时以当前图片为原图创建；撤销历史只保存已并入原图的操作，
+ * 由图像编辑控制器在编辑链过长时写入。
+ * @return 没有图片或图片仍在解码时返回 false
+ */
+bool MainWindow::ensureEditGraph()
+{
+    const int index = tabWidget->currentIndex();
+    if (!m_tabData.contains(index)) {
+        return false;
     }
 
-    // 清空重做栈（新操作会使之前的重做历史失效）
-    m_redoStack.clear();
+    TabData &tabData = m_tabData[index];
+    if (!tabData.editGraph) {
+        if (!ensureCurrentPixmap()) {
+            return false;
+        }
+        tabData.editGraph = std::make_shared<EditGraph>(m_currentImage.image());
+    }
+    if (m_imageController->editGraph() != tabData.editGraph) {
+        m_imageController->setEditGraph(tabData.editGraph, tabData.history);
+    }
+    return true;
+}
+
+/**
+ * @brief 当前标签页的编辑链改变后更新显示
+ *
+ * 完整结果的求值使用编辑链的副本（缓存的图像隐式共享，复制时不拷贝像素），
+ * 求值完成后连同新的缓存换回标签页，下一次编辑从这些缓存继续。
+ * 求值期间再次编辑、撤销或关闭标签页时结果被丢弃。
+ */
+void MainWindow::onEditResultChanged()
+{
+    ImageView *view = currentImageView();
+    const int index = tabWidget->currentIndex();
+    if (!view || !m_tabData.contains(index) || !m_tabData[index].editGraph) {
+        return;
+    }
 
-    // 更新按钮状态
+    TabData &tabData = m_tabData[index];
+    if (tabData.editCommit) {
+        *tabData.editCommit = true;
+        tabData.editCommit.reset();
+    }
     updateUndoRedoState();
+
+    const std::shared_ptr<EditGraph> graph = tabData.editGraph;
+    // 旋转改变了尺寸，视图要按新图片重新适应，直接求出完整结果
+    const QRect visible = view->visibleImageRect();
+    if (graph->outputSize() != view->imageSize() || visible.isEmpty()) {
+        setEditResult(view, ImageBuffer(graph->result()));
+        return;
+    }
+
+    // 先只计算可见区域，在接近视图比例的金字塔层上求值
+    const QImage region = m_imageController->renderRegion(visible, view->currentScale());
+    view->setEditPreview(QPixmap::fromImage(region), visible);
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    tabData.editCommit = cancel;
+    const EditGraph snapshot = *graph;
+    QFuture<EditGraph> future = QtConcurrent::run([snapshot]() {
+        EditGraph evaluated = snapshot;
+        evaluated.result();
+        return evaluated;
+    });
+    onFutureFinished(future, view, [this, view, graph, cancel](const EditGraph &evaluated) {
+        const int index = tabWidget->indexOf(view);
+        if (*cancel || index < 0 || !m_tabData.contains(index) || m_tabData[index].editGraph != graph) {
+            return;
+        }
+        m_tabData[index].editCommit.reset();
+        *graph = evaluated;
+        setEditResult(view, ImageBuffer(graph->result()));
+    });
+}
+
+/**
+ * @brief 把完整的编辑结果设为标签页的图片
+ *
+ * 尺寸不变时视图保持当前的缩放和平移，区域预览随场景一并移除。
+ */
+void MainWindow::setEditResult(ImageView *imageView, const ImageBuffer &image)
+{
+    const int index = tabWidget->indexOf(imageView);
+    if (index < 0 || !m_tabData.contains(index)) {
+        return;
+    }
+
+    m_tabData[index].image = image;
+    imageView->setImage(image);
+    if (index == tabWidget->currentIndex()) {
+        m_currentImage = image;
+        m_currentTiles.reset();
+    }
 }
 
 /**
  * @brief 更新撤销/重做按钮的启用状态
+ *
+ * 灰度 / 反色的勾选状态跟随编辑链，撤销或切换标签页后保持一致。
  */
 void MainWindow::updateUndoRedoState()
 {
-    ui->actionUndo->setEnabled(!m_undoStack.isEmpty());
-    ui->actionRedo->setEnabled(!m_redoStack.isEmpty());
+    ui->actionUndo->setEnabled(m_imageController->canUndo());
+    ui->actionRedo->setEnabled(m_imageController->canRedo());
+    ui->actionGrayscale->setChecked(m_imageController->hasGrayscale());
+    ui->actionInvert->setChecked(m_imageController->hasInvert());
 }
 
 // ==================== 保存辅助函数 ====================
@@ -2812,113 +3200,6 @@ int MainWindow::showSaveOptionsDialog(const QString &previewFileName)
     return -1; // 取消
 }
 
-// ==================== 图像处理辅助函数 ====================
-
-/**
- * @brief 应用卷积核到图片
- */
-QImage MainWindow::applyConvolution(const QImage &image, const QVector<QVector<int>> &kernel, int divisor, int offset)
-{
-    if (image.isNull() || kernel.isEmpty() || kernel.size() % 2 == 0 || kernel[0].size() % 2 == 0) {
-        return image;
-    }
-
-    int kernelSize = kernel.size();
-    int half = kernelSize / 2;
-
-    QImage result(image.size(), QImage::Format_RGB32);
-    QImage src = image.convertToFormat(QImage::Format_RGB32);
-
-    for (int y = 0; y < image.height(); ++y) {
-        for (int x = 0; x < image.width(); ++x) {
-            int r = 0, g = 0, b = 0;
-
-            for (int ky = 0; ky < kernelSize; ++ky) {
-                for (int kx = 0; kx < kernelSize; ++kx) {
-                    int px = qBound(0, x + kx - half, image.width() - 1);
-                    int py = qBound(0, y + ky - half, image.height() - 1);
-
-                    QColor pixel = src.pixelColor(px, py);
-                    int weight = kernel[ky][kx];
-
-                    r += pixel.red() * weight;
-                    g += pixel.green() * weight;
-                    b += pixel.blue() * weight;
-                }
-            }
-
-            r = qBound(0, r / divisor + offset, 255);
-            g = qBound(0, g / divisor + offset, 255);
-            b = qBound(0, b / divisor + offset, 255);
-
-            result.setPixelColor(x, y, QColor(r, g, b));
-        }
-    }
-
-    return result;
-}
-
-/**
- * @brief 高斯模糊
- */
-QImage MainWindow::gaussianBlur(const QImage &image, int radius)
-{
-    // 使用简单的盒式模糊作为近似
-    QImage result = image;
-    int iterations = radius * 2;
-
-    for (int i = 0; i < iterations; ++i) {
-        QVector<QVector<int>> kernel = {
-            {1, 2, 1},
-            {2, 4, 2},
-            {1, 2, 1}
-        };
-
-        QImage temp(result.size(), QImage::Format_RGB32);
-        for (int y = 0; y < result.height(); ++y) {
-            for (int x = 0; x < result.width(); ++x) {
-                int r = 0, g = 0, b = 0, count = 0;
-
-                for (int ky = -1; ky <= 1; ++ky) {
-                    for (int kx = -1; kx <= 1; ++kx) {
-                        int px = qBound(0, x + kx, result.width() - 1);
-                        int py = qBound(0, y + ky, result.height() - 1);
-                        QColor pixel = result.pixelColor(px, py);
-                        int weight = kernel[ky + 1][kx + 1];
-
-                        r += pixel.red() * weight;
-                        g += pixel.green() * weight;
-                        b += pixel.blue() * weight;
-                        count += weight;
-                    }
-                }
-
-                temp.setPixelColor(x, y, QColor(r / count, g / count, b / count));
-            }
-        }
-
-        result = temp;
-    }
-
-    return result;
-}
-
-/**
- * @brief 锐化图片
- */
-QImage MainWindow::sharpenImage(const QImage &image, double strength)
-{
-    // 锐化卷积核
-    int s = static_cast<int>(strength);
-    QVector<QVector<int>> kernel = {
-        {0,        -s,       0},
-        {-s,   1 + 4*s,    -s},
-        {0,        -s,       0}
-    };
-
-    return applyConvolution(image, kernel, 1);
-}
-
 // ==================== 任务栏和参数面板实现 ====================
 
 /**
@@ -3409,21 +3690,36 @@ void MainWindow::onTabCloseRequested(int index)
         return;
     }
 
-    // 移除标签页数据
+    // 取消仍在进行的解码和编辑结果求值，移除标签页数据
+    if (m_tabData.contains(index)) {
+        const TabData &tabData = m_tabData[index];
+        if (tabData.loading) {
+            *tabData.loading = true;
+        }
+        if (tabData.editCommit) {
+            *tabData.editCommit = true;
+        }
+    }
     m_tabData.remove(index);
 
-    // 移除标签页
+    // 移除并销毁标签页（QTabWidget::removeTab 不会删除页面）
+    QWidget *page = tabWidget->widget(index);
     tabWidget->removeTab(index);
+    if (page) {
+        page->deleteLater();
+    }
 
-    // 重新映射标签页数据索引
+    // 重新映射标签页数据索引：其后的标签页前移一位
     QHash<int, TabData> newTabData;
-    for (int i = 0; i < tabWidget->count(); ++i) {
-        if (m_tabData.contains(i)) {
-            newTabData[i] = m_tabData[i];
-        }
+    for (auto it = m_tabData.cbegin(); it != m_tabData.cend(); ++it) {
+        newTabData[it.key() > index ? it.key() - 1 : it.key()] = it.value();
     }
     m_tabData = newTabData;
 
+    // removeTab() 切换当前标签页时数据尚未重新映射，此时再更新一次
+    updateCurrentTabRef();
+    updateUndoRedoState();
+
     logMessage("已关闭标签页");
 }
 
@@ -3461,16 +3757,23 @@ void MainWindow::updateCurrentTabRef()
 {
     int index = tabWidget->currentIndex();
     if (index >= 0 && m_tabData.contains(index)) {
-        const TabData &tabData = m_tabData[index];
+        TabData &tabData = m_tabData[index];
         m_currentImagePath = tabData.imagePath;
-        m_currentPixmap = tabData.pixmap;
-        m_undoStack = tabData.undoStack;
-        m_redoStack = tabData.redoStack;
+        // 标签页的视图保存着最近一次求出的完整编辑结果（后台求值期间仍为上一次的结果，
+        // 需要最新结果时由 ensureCurrentPixmap() 求出）；标签页数据与视图共享同一个句柄，不复制像素。
+        // 分块显示的大图在需要整幅像素时才由 ensureCurrentPixmap() 读出
+        ImageView *view = currentImageView();
+        m_currentTiles = view ? view->tiledImage() : nullptr;
+        if (view && !view->image().isNull()) {
+            tabData.image = view->image();
+        }
+        m_currentImage = m_currentTiles ? ImageBuffer() : tabData.image;
+        m_imageController->setEditGraph(tabData.editGraph, tabData.history);
     } else {
         m_currentImagePath.clear();
-        m_currentPixmap = QPixmap();
-        m_undoStack.clear();
-        m_redoStack.clear();
+        m_currentImage = ImageBuffer();
+        m_currentTiles.reset();
+        m_imageController->setEditGraph(nullptr);
     }
 
     // 通知任务控制器当前图像路径变化
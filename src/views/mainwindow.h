@@ -17,17 +17,28 @@
 #include <QRegularExpression>
 #include <QMenu>
 #include <QProcess>
+#include <atomic>
+#include <memory>
+
+#include "imagebuffer.h"
 
 // 前向声明
 namespace GenPreCVSystem {
 namespace Controllers {
 class TaskController;
+class ImageController;
 }
 namespace Utils {
 class RecentFilesManager;
+class EditGraph;
+class ImageHistory;
+class TiledImage;
+struct ImageLoadResult;
 }
 namespace Views {
 class BatchProcessDialog;
+class TiledImageItem;
+class PyramidPixmapItem;
 }
 }
 
@@ -64,13 +75,64 @@ class ImageView : public QGraphicsView
 
 public:
     explicit ImageView(QWidget *parent = nullptr);
+    ~ImageView() override;
 
     /**
      * @brief 设置要显示的图片
      * @param pixmap 图片数据
+     *
+     * 大图在后台生成金字塔，生成后缩小显示时绘制最接近当前缩放比例的层。
      */
     void setPixmap(const QPixmap &pixmap);
 
+    /**
+     * @brief 设置要显示的图片，视图与调用方共享同一个句柄
+     *
+     * 之后 image() 返回该句柄，各层取用图片时不再在 QPixmap 与 QImage 之间重复转换。
+     */
+    void setImage(const GenPreCVSystem::Utils::ImageBuffer &image);
+
+    /**
+     * @brief 当前显示的图片句柄（预览期间仍为原图），分块显示或解码期间为空
+     */
+    GenPreCVSystem::Utils::ImageBuffer image() const;
+
+    /**
+     * @brief 设置要显示的分块图像
+     *
+     * 只读取可见区域的块，pixmap() 返回空图；需要整幅像素时由调用方从 tiledImage() 读取。
+     * 缩小显示所需的各层在后台逐层生成。
+     */
+    void setTiledImage(const std::shared_ptr<GenPreCVSystem::Utils::TiledImage> &image);
+
+    /**
+     * @brief 原图解码期间显示的低分辨率预览
+     *
+     * 预览拉伸到原图尺寸显示，可以缩放和平移；随后 setPixmap() / setTiledImage()
+     * 换上原图时保持当前的缩放和平移。预览期间 pixmap() 返回空图。
+     */
+    void setLoadingPreview(const QPixmap &preview, const QSize &imageSize);
+
+    /**
+     * @brief 是否正在显示解码期间的预览
+     */
+    bool isLoading() const { return m_loadingSize.isValid(); }
+
+    /**
+     * @brief 当前显示的分块图像，显示的是普通图片时返回空指针
+     */
+    std::shared_ptr<GenPreCVSystem::Utils::TiledImage> tiledImage() const;
+
+    /**
+     * @brief 是否有图片（普通或分块）
+     */
+    bool hasImage() const { return m_pixmapItem || m_tiledItem; }
+
+    /**
+     * @brief 原图尺寸（普通或分块）
+     */
+    QSize imageSize() const;
+
     /**
      * @brief 清空显示的图片
      */
@@ -100,10 +162,38 @@ public:
 
     /**
      * @brief 获取当前显示的图片
-     * @return 当前图片，如果没有图片则返回空 QPixmap
+     * @return 当前图片（预览期间仍为原图），如果没有图片则返回空 QPixmap
      */
     QPixmap pixmap() const;
 
+    /**
+     * @brief 临时显示处理预览
+     * @param preview 低分辨率的预览图，拉伸到原图大小显示，缩放与平移保持不变
+     */
+    void setPreviewPixmap(const QPixmap &preview);
+
+    /**
+     * @brief 取消预览，恢复显示原图
+     */
+    void clearPreview();
+
+    /**
+     * @brief 是否正在显示预览
+     */
+    bool isPreviewing() const { return !m_previewSource.isNull() || (m_tiledItem && m_pixmapItem); }
+
+    /**
+     * @brief 完整的编辑结果求出前，在 region 处覆盖显示该区域的编辑结果
+     * @param preview 按视图比例计算的区域结果，拉伸到 region 大小显示
+     * @param region 原图坐标系中的区域；下一次 setImage() 时移除
+     */
+    void setEditPreview(const QPixmap &preview, const QRect &region);
+
+    /**
+     * @brief 视口中可见的图像区域（原图坐标）
+     */
+    QRect visibleImageRect() const;
+
 protected:
     /**
      * @brief 鼠标滚轮事件，用于缩放图片
@@ -131,11 +221,33 @@ protected:
     void resizeEvent(QResizeEvent *event) override;
 
 private:
+    /**
+     * @brief 显示原图的图形项（分块显示时为分块图像项）
+     */
+    QGraphicsItem *imageItem() const;
+
+    /**
+     * @brief 在后台为当前图片生成金字塔层，取消仍在进行的上一次生成
+     */
+    void buildPyramid();
+
+    /**
+     * @brief 取消后台的金字塔生成，已完成的结果也不再使用
+     */
+    void cancelPyramid();
+
     QGraphicsScene *m_scene;              ///< 图形场景
-    QGraphicsPixmapItem *m_pixmapItem;    ///< 图片项
+    QGraphicsPixmapItem *m_pixmapItem;    ///< 图片项（分块显示时为预览图层）
+    GenPreCVSystem::Views::TiledImageItem *m_tiledItem;  ///< 分块图像项
+    GenPreCVSystem::Views::PyramidPixmapItem *m_pyramidItem;  ///< 普通图片项（与 m_pixmapItem 相同）
+    std::shared_ptr<std::atomic<bool>> m_pyramidCancel;  ///< 当前金字塔生成任务的取消标志
     double m_scaleFactor;                 ///< 当前缩放比例
     bool m_dragging;                      ///< 是否正在拖拽
     QPoint m_lastPanPoint;                ///< 上一次拖拽位置
+    QPixmap m_previewSource;              ///< 预览期间被替换下的原图
+    QGraphicsPixmapItem *m_editPreviewItem;  ///< 编辑结果的可见区域（完整结果求出前）
+    GenPreCVSystem::Utils::ImageBuffer m_image;  ///< 显示的原图（普通图片时）
+    QSize m_loadingSize;                  ///< 解码期间预览对应的原图尺寸
 };
 
 /**
@@ -380,6 +492,7 @@ private:
     QActionGroup *taskActionGroup; ///< 任务动作组（互斥选择）
     CVTask m_currentTask;          ///< 当前选中的任务
     GenPreCVSystem::Controllers::TaskController *m_taskController; ///< 任务控制器
+    GenPreCVSystem::Controllers::ImageController *m_imageController; ///< 图像编辑控制器（作用于当前标签页的编辑链）
     GenPreCVSystem::Utils::RecentFilesManager *m_recentFilesManager; ///< 最近文件管理器
     GenPreCVSystem::Views::BatchProcessDialog *m_batchProcessDialog; ///< 批量处理对话框
 
@@ -403,27 +516,36 @@ private:
 
     struct TabData {
         QString imagePath;        ///< 图片文件路径
-        QPixmap pixmap;           ///< 图片数据
-        QStack<QPixmap> undoStack;///< 撤销栈
-        QStack<QPixmap> redoStack;///< 重做栈
+        GenPreCVSystem::Utils::ImageBuffer image;  ///< 图片数据（与视图共享同一个句柄）
+        std::shared_ptr<GenPreCVSystem::Utils::ImageHistory> history; ///< 增量撤销/重做历史（已并入编辑链原图的操作）
+        std::shared_ptr<GenPreCVSystem::Utils::EditGraph> editGraph; ///< 编辑链（首次编辑时以当前图片为原图创建）
+        std::shared_ptr<std::atomic<bool>> loading;  ///< 后台解码的取消标志，解码完成后为空
+        std::shared_ptr<std::atomic<bool>> editCommit;  ///< 后台求值完整编辑结果的取消标志，完成后为空
     };
     QHash<int, TabData> m_tabData;  ///< 标签页数据映射（key为tab索引）
 
     // ========== 当前活动标签页引用 ==========
 
     QString m_currentImagePath;   ///< 当前打开的图片路径
-    QPixmap m_currentPixmap;      ///< 当前加载的图片数据
-    QStack<QPixmap> m_undoStack;  ///< 当前标签页撤销栈
-    QStack<QPixmap> m_redoStack;  ///< 当前标签页重做栈
+    GenPreCVSystem::Utils::ImageBuffer m_currentImage;  ///< 当前加载的图片数据
+    std::shared_ptr<GenPreCVSystem::Utils::TiledImage> m_currentTiles; ///< 当前分块显示的图像（普通图片时为空）
     static const int MAX_UNDO_STEPS = 50;  ///< 最大撤销步数
 
     /**
-     * @brief 保存当前状态到撤销栈
+     * @brief 确保当前图片的像素在内存中（分块显示的大图此时才整幅读出，
+     *        仍在后台求值的编辑结果此时求出）
+     * @return 没有图片时返回 false
+     */
+    bool ensureCurrentPixmap();
+
+    /**
+     * @brief 确保当前标签页有编辑链，并设为图像编辑控制器的编辑链
+     * @return 没有图片时返回 false
      */
-    void saveState();
+    bool ensureEditGraph();
 
     /**
-     * @brief 更新撤销/重做按钮状态
+     * @brief 更新撤销/重做按钮和灰度/反色的勾选状态
      */
     void updateUndoRedoState();
 
@@ -577,52 +699,42 @@ private:
 
     /**
      * @brief 加载并显示图片
+     *
+     * 立即创建标签页并在后台解码：先显示低分辨率预览，原图解码完成后替换。
+     * 解码完成前关闭标签页会取消解码。
+     *
      * @param filePath 图片文件路径
-     * @return true 成功加载，false 加载失败
+     * @return true 已打开或开始加载，false 文件无法解码
      */
     bool loadImage(const QString &filePath);
 
     /**
-     * @brief 关闭当前图片
+     * @brief 后台解码完成，把原图放入 imageView 所在的标签页
      */
-    void closeImage();
+    void onImageLoaded(ImageView *imageView, const GenPreCVSystem::Utils::ImageLoadResult &result);
 
     /**
-     * @brief 应用卷积核到图片
-     * @param image 输入图片
-     * @param kernel 卷积核（3x3）
-     * @param divisor 除数
-     * @param offset 偏移量
-     * @return 处理后的图片
+     * @brief 当前标签页的编辑链改变后更新显示
+     *
+     * 尺寸不变时先按视图比例只计算可见区域并覆盖显示，完整结果在后台求值后替换图片；
+     * 旋转等改变尺寸的操作直接求出完整结果。
      */
-    QImage applyConvolution(const QImage &image, const QVector<QVector<int>> &kernel, int divisor = 1, int offset = 0);
+    void onEditResultChanged();
 
     /**
-     * @brief 高斯模糊
-     * @param image 输入图片
-     * @param radius 模糊半径
-     * @return 模糊后的图片
+     * @brief 把完整的编辑结果设为 imageView 所在标签页的图片
      */
-    QImage gaussianBlur(const QImage &image, int radius = 2);
+    void setEditResult(ImageView *imageView, const GenPreCVSystem::Utils::ImageBuffer &image);
 
     /**
-     * @brief 锐化图片
-     * @param image 输入图片
-     * @param strength 锐化强度
-     * @return 锐化后的图片
+     * @brief 关闭当前图片
      */
-    QImage sharpenImage(const QImage &image, double strength = 1.0);
+    void closeImage();
 
     /**
      * @brief 切换任务类型
      */
     void switchTask(CVTask task);
-
-    // ========== 灰度/反色状态追踪 ==========
-
-    QPixmap m_originalPixmap;       ///< 灰度/反色前的原始图片
-    bool m_isGrayscale = false;     ///< 当前是否为灰度状态
-    bool m_isInverted = false;      ///< 当前是否为反色状态
 };
 
 #endif // MAINWINDOW_H
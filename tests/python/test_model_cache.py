@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+ModelCache 单元测试
+
+只依赖标准库：加载器返回占位对象，模型大小取文件大小。
+"""
+
+import os
+import sys
+import tempfile
+import time
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "..", "src", "services", "inference", "python"))
+
+from base_service import ModelCache  # noqa: E402
+
+
+class ModelCacheTest(unittest.TestCase):
+
+    def setUp(self):
+        self._dir = tempfile.TemporaryDirectory()
+        self.loaded = []
+        self.cache = ModelCache(self._load, budget_mb=1024)
+
+    def tearDown(self):
+        self._dir.cleanup()
+
+    def _load(self, model_path):
+        self.loaded.append(model_path)
+        return object()
+
+    def _model(self, name, size=16):
+        path = os.path.join(self._dir.name, name)
+        with open(path, "wb") as f:
+            f.write(b"\0" * size)
+        return path
+
+    def _wait_prefetch(self, timeout=5.0):
+        deadline = time.monotonic() + timeout
+        while self.cache._pending and time.monotonic() < deadline:
+            time.sleep(0.01)
+        self.assertFalse(self.cache._pending, "预取未在限定时间内完成")
+
+    def test_prefetch_survives_full_cache(self):
+        """缓存条目数已满时，预取的模型仍驻留"""
+        for i in range(ModelCache.MAX_ENTRIES):
+            self.cache.acquire(self._model(f"m{i}.pt"))
+
+        prefetched = self._model("next.pt")
+        self.assertTrue(self.cache.prefetch(prefetched))
+        self._wait_prefetch()
+
+        self.assertTrue(self.cache.contains(prefetched))
+        self.assertLessEqual(len(self.cache.stats()["cached_models"]), ModelCache.MAX_ENTRIES)
+
+        loads = len(self.loaded)
+        _, cached = self.cache.acquire(prefetched)
+        self.assertTrue(cached)
+        self.assertEqual(len(self.loaded), loads)
+
+    def test_prefetch_survives_byte_budget(self):
+        """超出内存预算时淘汰旧模型而不是预取的模型，使用中的模型保留"""
+        old = self._model("old.pt", 100)
+        active = self._model("active.pt", 100)
+        self.cache.acquire(old)
+        self.cache.acquire(active)
+        self.cache.budget_bytes = 200
+
+        prefetched = self._model("next.pt", 100)
+        self.cache.prefetch(prefetched)
+        self._wait_prefetch()
+
+        self.assertTrue(self.cache.contains(prefetched))
+        self.assertTrue(self.cache.contains(active))
+        self.assertFalse(self.cache.contains(old))
+
+    def test_acquire_after_prefetch_enforces_budget(self):
+        """预取的模型与使用中的模型超出预算时，切换到预取模型后淘汰旧模型"""
+        active = self._model("active.pt", 150)
+        self.cache.acquire(active)
+        self.cache.budget_bytes = 200
+
+        prefetched = self._model("next.pt", 100)
+        self.cache.prefetch(prefetched)
+        self._wait_prefetch()
+        self.assertTrue(self.cache.contains(prefetched))
+
+        _, cached = self.cache.acquire(prefetched)
+        self.assertTrue(cached)
+        self.assertFalse(self.cache.contains(active))
+        self.assertLessEqual(self.cache.stats()["cache_bytes"], 200)
+
+
+if __name__ == "__main__":
+    unittest.main()
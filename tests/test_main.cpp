@@ -13,6 +13,23 @@
 #include "unit/test_environmentcachemanager.h"
 #include "unit/test_yoloservice.h"
 #include "unit/test_environmentscanner.h"
+#include "unit/test_responseframe.h"
+#include "unit/test_inferenceresultcache.h"
+#include "unit/test_detectionpostprocess.h"
+#include "unit/test_convolution.h"
+#include "unit/test_gaussianblur.h"
+#include "unit/test_medianfilter.h"
+#include "unit/test_denoise.h"
+#include "unit/test_cannydetector.h"
+#include "unit/test_imageenhancer.h"
+#include "unit/test_tiledexecutor.h"
+#include "unit/test_pointoperations.h"
+#include "unit/test_editgraph.h"
+#include "unit/test_imageprocessservice.h"
+#include "unit/test_imagehistory.h"
+#include "unit/test_tiledimage.h"
+#include "unit/test_imageloader.h"
+#include "unit/test_imagebuffer.h"
 #include "integration/test_environmentworkflow.h"
 
 int main(int argc, char *argv[])
@@ -30,7 +47,7 @@ int main(int argc, char *argv[])
     int failedTests = 0;
 
     // 运行环境缓存管理器测试
-    std::cout << "\n[1/4] EnvironmentCacheManager Tests:" << std::endl;
+    std::cout << "\n[1/21] EnvironmentCacheManager Tests:" << std::endl;
     std::cout.flush();
     {
         TestEnvironmentCacheManager cacheTest;
@@ -58,7 +75,7 @@ int main(int argc, char *argv[])
     // }
 
     // 运行 YOLOService 测试
-    std::cout << "\n[2/4] YOLOService Tests:" << std::endl;
+    std::cout << "\n[2/21] YOLOService Tests:" << std::endl;
     std::cout.flush();
     {
         TestYOLOService yoloTest;
@@ -74,7 +91,7 @@ int main(int argc, char *argv[])
     }
 
     // 运行 EnvironmentScanner 测试
-    std::cout << "\n[3/4] EnvironmentScanner Tests:" << std::endl;
+    std::cout << "\n[3/21] EnvironmentScanner Tests:" << std::endl;
     std::cout.flush();
     {
         TestEnvironmentScanner scannerTest;
@@ -89,8 +106,280 @@ int main(int argc, char *argv[])
         }
     }
 
+    // 运行响应帧解码测试
+    std::cout << "\n[4/21] ResponseFrame Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestResponseFrame frameTest;
+        result = QTest::qExec(&frameTest, argc, argv);
+        totalTests += frameTest.testCount();
+        if (result == 0) {
+            passedTests += frameTest.testCount();
+            std::cout << "✓ ResponseFrame tests passed" << std::endl;
+        } else {
+            failedTests += frameTest.testCount();
+            std::cout << "✗ ResponseFrame tests failed" << std::endl;
+        }
+    }
+
+    // 运行推理结果缓存测试
+    std::cout << "\n[5/21] InferenceResultCache Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestInferenceResultCache resultCacheTest;
+        result = QTest::qExec(&resultCacheTest, argc, argv);
+        totalTests += resultCacheTest.testCount();
+        if (result == 0) {
+            passedTests += resultCacheTest.testCount();
+            std::cout << "✓ InferenceResultCache tests passed" << std::endl;
+        } else {
+            failedTests += resultCacheTest.testCount();
+            std::cout << "✗ InferenceResultCache tests failed" << std::endl;
+        }
+    }
+
+    // 运行检测后处理测试
+    std::cout << "\n[6/21] DetectionPostProcess Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestDetectionPostProcess postProcessTest;
+        result = QTest::qExec(&postProcessTest, argc, argv);
+        totalTests += postProcessTest.testCount();
+        if (result == 0) {
+            passedTests += postProcessTest.testCount();
+            std::cout << "✓ DetectionPostProcess tests passed" << std::endl;
+        } else {
+            failedTests += postProcessTest.testCount();
+            std::cout << "✗ DetectionPostProcess tests failed" << std::endl;
+        }
+    }
+
+    // 运行卷积引擎测试
+    std::cout << "\n[7/21] Convolution Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestConvolution convolutionTest;
+        result = QTest::qExec(&convolutionTest, argc, argv);
+        totalTests += convolutionTest.testCount();
+        if (result == 0) {
+            passedTests += convolutionTest.testCount();
+            std::cout << "✓ Convolution tests passed" << std::endl;
+        } else {
+            failedTests += convolutionTest.testCount();
+            std::cout << "✗ Convolution tests failed" << std::endl;
+        }
+    }
+
+    // 运行高斯模糊测试
+    std::cout << "\n[8/21] GaussianBlur Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestGaussianBlur gaussianTest;
+        result = QTest::qExec(&gaussianTest, argc, argv);
+        totalTests += gaussianTest.testCount();
+        if (result == 0) {
+            passedTests += gaussianTest.testCount();
+            std::cout << "✓ GaussianBlur tests passed" << std::endl;
+        } else {
+            failedTests += gaussianTest.testCount();
+            std::cout << "✗ GaussianBlur tests failed" << std::endl;
+        }
+    }
+
+    // 运行中值滤波测试
+    std::cout << "\n[9/21] MedianFilter Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestMedianFilter medianTest;
+        result = QTest::qExec(&medianTest, argc, argv);
+        totalTests += medianTest.testCount();
+        if (result == 0) {
+            passedTests += medianTest.testCount();
+            std::cout << "✓ MedianFilter tests passed" << std::endl;
+        } else {
+            failedTests += medianTest.testCount();
+            std::cout << "✗ MedianFilter tests failed" << std::endl;
+        }
+    }
+
+    // 运行保边去噪测试
+    std::cout << "\n[10/21] Denoise Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestDenoise denoiseTest;
+        result = QTest::qExec(&denoiseTest, argc, argv);
+        totalTests += denoiseTest.testCount();
+        if (result == 0) {
+            passedTests += denoiseTest.testCount();
+            std::cout << "✓ Denoise tests passed" << std::endl;
+        } else {
+            failedTests += denoiseTest.testCount();
+            std::cout << "✗ Denoise tests failed" << std::endl;
+        }
+    }
+
+    // 运行 Canny 边缘检测测试
+    std::cout << "\n[11/21] CannyDetector Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestCannyDetector cannyTest;
+        result = QTest::qExec(&cannyTest, argc, argv);
+        totalTests += cannyTest.testCount();
+        if (result == 0) {
+            passedTests += cannyTest.testCount();
+            std::cout << "✓ CannyDetector tests passed" << std::endl;
+        } else {
+            failedTests += cannyTest.testCount();
+            std::cout << "✗ CannyDetector tests failed" << std::endl;
+        }
+    }
+
+    // 运行融合图像增强测试
+    std::cout << "\n[12/21] ImageEnhancer Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestImageEnhancer enhancerTest;
+        result = QTest::qExec(&enhancerTest, argc, argv);
+        totalTests += enhancerTest.testCount();
+        if (result == 0) {
+            passedTests += enhancerTest.testCount();
+            std::cout << "✓ ImageEnhancer tests passed" << std::endl;
+        } else {
+            failedTests += enhancerTest.testCount();
+            std::cout << "✗ ImageEnhancer tests failed" << std::endl;
+        }
+    }
+
+    // 运行分块并行执行器测试
+    std::cout << "\n[13/21] TiledExecutor Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestTiledExecutor executorTest;
+        result = QTest::qExec(&executorTest, argc, argv);
+        totalTests += executorTest.testCount();
+        if (result == 0) {
+            passedTests += executorTest.testCount();
+            std::cout << "✓ TiledExecutor tests passed" << std::endl;
+        } else {
+            failedTests += executorTest.testCount();
+            std::cout << "✗ TiledExecutor tests failed" << std::endl;
+        }
+    }
+
+    // 运行点运算测试
+    std::cout << "\n[14/21] PointOperations Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestPointOperations pointTest;
+        result = QTest::qExec(&pointTest, argc, argv);
+        totalTests += pointTest.testCount();
+        if (result == 0) {
+            passedTests += pointTest.testCount();
+            std::cout << "✓ PointOperations tests passed" << std::endl;
+        } else {
+            failedTests += pointTest.testCount();
+            std::cout << "✗ PointOperations tests failed" << std::endl;
+        }
+    }
+
+    // 运行编辑链测试
+    std::cout << "\n[15/21] EditGraph Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestEditGraph editGraphTest;
+        result = QTest::qExec(&editGraphTest, argc, argv);
+        totalTests += editGraphTest.testCount();
+        if (result == 0) {
+            passedTests += editGraphTest.testCount();
+            std::cout << "✓ EditGraph tests passed" << std::endl;
+        } else {
+            failedTests += editGraphTest.testCount();
+            std::cout << "✗ EditGraph tests failed" << std::endl;
+        }
+    }
+
+    // 运行图像处理预览测试
+    std::cout << "\n[16/21] ImageProcessService Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestImageProcessService processServiceTest;
+        result = QTest::qExec(&processServiceTest, argc, argv);
+        totalTests += processServiceTest.testCount();
+        if (result == 0) {
+            passedTests += processServiceTest.testCount();
+            std::cout << "✓ ImageProcessService tests passed" << std::endl;
+        } else {
+            failedTests += processServiceTest.testCount();
+            std::cout << "✗ ImageProcessService tests failed" << std::endl;
+        }
+    }
+
+    // 运行增量撤销历史测试
+    std::cout << "\n[17/21] ImageHistory Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestImageHistory historyTest;
+        result = QTest::qExec(&historyTest, argc, argv);
+        totalTests += historyTest.testCount();
+        if (result == 0) {
+            passedTests += historyTest.testCount();
+            std::cout << "✓ ImageHistory tests passed" << std::endl;
+        } else {
+            failedTests += historyTest.testCount();
+            std::cout << "✗ ImageHistory tests failed" << std::endl;
+        }
+    }
+
+    // 运行分块图像测试
+    std::cout << "\n[18/21] TiledImage Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestTiledImage tiledImageTest;
+        result = QTest::qExec(&tiledImageTest, argc, argv);
+        totalTests += tiledImageTest.testCount();
+        if (result == 0) {
+            passedTests += tiledImageTest.testCount();
+            std::cout << "✓ TiledImage tests passed" << std::endl;
+        } else {
+            failedTests += tiledImageTest.testCount();
+            std::cout << "✗ TiledImage tests failed" << std::endl;
+        }
+    }
+
+    // 运行图像解码测试
+    std::cout << "\n[19/21] ImageLoader Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestImageLoader imageLoaderTest;
+        result = QTest::qExec(&imageLoaderTest, argc, argv);
+        totalTests += imageLoaderTest.testCount();
+        if (result == 0) {
+            passedTests += imageLoaderTest.testCount();
+            std::cout << "✓ ImageLoader tests passed" << std::endl;
+        } else {
+            failedTests += imageLoaderTest.testCount();
+            std::cout << "✗ ImageLoader tests failed" << std::endl;
+        }
+    }
+
+    // 运行共享图像句柄测试
+    std::cout << "\n[20/21] ImageBuffer Tests:" << std::endl;
+    std::cout.flush();
+    {
+        TestImageBuffer imageBufferTest;
+        result = QTest::qExec(&imageBufferTest, argc, argv);
+        totalTests += imageBufferTest.testCount();
+        if (result == 0) {
+            passedTests += imageBufferTest.testCount();
+            std::cout << "✓ ImageBuffer tests passed" << std::endl;
+        } else {
+            failedTests += imageBufferTest.testCount();
+            std::cout << "✗ ImageBuffer tests failed" << std::endl;
+        }
+    }
+
     // 运行集成测试
-    std::cout << "\n[4/4] Integration Tests:" << std::endl;
+    std::cout << "\n[21/21] Integration Tests:" << std::endl;
     std::cout.flush();
     {
         TestEnvironmentWorkflow workflowTest;
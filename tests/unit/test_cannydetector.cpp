@@ -0,0 +1,239 @@
+/**
+ * @file test_cannydetector.cpp
+ * @brief CannyDetector 单元测试实现
+ */
+
+#include "test_cannydetector.h"
+#include <QRandomGenerator>
+#include <QtMath>
+#include <vector>
+
+namespace {
+
+QImage makeTexture(int width, int height)
+{
+    QRandomGenerator rng(9);
+    QImage image(width, height, QImage::Format_Grayscale8);
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            const double value = 128 + 90 * qSin(x * 0.07 + y * 0.05) + 60 * ((x / 23 + y / 17) % 2)
+                                 + rng.bounded(21) - 10;
+            line[x] = static_cast<uchar>(qBound(0, static_cast<int>(value), 255));
+        }
+    }
+    return image;
+}
+
+// 按定义逐像素计算的 Canny（二维 Sobel 卷积、四方向非极大值抑制、队列连接）
+QImage referenceCanny(const QImage &gray, double low, double high, int apertureSize, bool l2Gradient)
+{
+    const int width = gray.width();
+    const int height = gray.height();
+    const int radius = apertureSize / 2;
+
+    std::vector<double> smooth = {1};
+    std::vector<double> derivative = {-1, 0, 1};
+    auto extend = [](std::vector<double> &taps) {
+        std::vector<double> out(taps.size() + 1, 0.0);
+        for (size_t i = 0; i < taps.size(); ++i) {
+            out[i] += taps[i];
+            out[i + 1] += taps[i];
+        }
+        taps = out;
+    };
+    for (int i = 1; i < apertureSize; ++i) {
+        extend(smooth);
+    }
+    for (int i = 3; i < apertureSize; ++i) {
+        extend(derivative);
+    }
+
+    std::vector<double> magnitude(static_cast<size_t>(width) * height);
+    std::vector<int> direction(magnitude.size());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double gx = 0;
+            double gy = 0;
+            for (int i = 0; i < apertureSize; ++i) {
+                for (int j = 0; j < apertureSize; ++j) {
+                    const int sx = qBound(0, x + j - radius, width - 1);
+                    const int sy = qBound(0, y + i - radius, height - 1);
+                    const double v = gray.constScanLine(sy)[sx];
+                    gx += derivative[j] * smooth[i] * v;
+                    gy += smooth[j] * derivative[i] * v;
+                }
+            }
+            const double ax = qAbs(gx);
+            const double ay = qAbs(gy);
+            magnitude[y * width + x] = l2Gradient ? gx * gx + gy * gy : ax + ay;
+            direction[y * width + x] = ay < ax * 0.414213562 ? 0
+                                       : ay > ax * 2.414213562 ? 2
+                                       : ((gx < 0) == (gy < 0) ? 1 : 3);
+        }
+    }
+
+    auto at = [&](int x, int y) {
+        return x < 0 || y < 0 || x >= width || y >= height ? 0.0 : magnitude[y * width + x];
+    };
+    if (low > high) {
+        qSwap(low, high);
+    }
+    if (l2Gradient) {
+        low *= low;
+        high *= high;
+    }
+
+    // 0 = 候选, 1 = 非边缘, 2 = 边缘
+    std::vector<int> state(magnitude.size(), 1);
+    QVector<QPoint> queue;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const double m = at(x, y);
+            bool maximum = false;
+            switch (direction[y * width + x]) {
+                case 0: maximum = m > at(x - 1, y) && m >= at(x + 1, y); break;
+                case 2: maximum = m > at(x, y - 1) && m >= at(x, y + 1); break;
+                case 1: maximum = m > at(x - 1, y - 1) && m > at(x + 1, y + 1); break;
+                default: maximum = m > at(x + 1, y - 1) && m > at(x - 1, y + 1); break;
+            }
+            if (!maximum) {
+                continue;
+            }
+            if (m > high) {
+                state[y * width + x] = 2;
+                queue.append(QPoint(x, y));
+            } else if (m > low) {
+                state[y * width + x] = 0;
+            }
+        }
+    }
+    for (int i = 0; i < queue.size(); ++i) {
+        const QPoint p = queue[i];
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const int nx = p.x() + dx;
+                const int ny = p.y() + dy;
+                if (nx >= 0 && ny >= 0 && nx < width && ny < height && state[ny * width + nx] == 0) {
+                    state[ny * width + nx] = 2;
+                    queue.append(QPoint(nx, ny));
+                }
+            }
+        }
+    }
+
+    QImage result(width, height, QImage::Format_Grayscale8);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            result.scanLine(y)[x] = state[y * width + x] == 2 ? 255 : 0;
+        }
+    }
+    return result;
+}
+
+int edgeCount(const QImage &edges, int y0, int y1)
+{
+    int count = 0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = 0; x < edges.width(); ++x) {
+            count += edges.constScanLine(y)[x] != 0;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+void TestCannyDetector::testMatchesReference()
+{
+    // 宽度不是 4 的倍数，覆盖 SIMD 之后的标量尾部
+    const QImage image = makeTexture(203, 77);
+
+    const int apertures[] = {3, 5, 7};
+    for (int aperture : apertures) {
+        // 孔径越大幅值越大，阈值按 Sobel 核的增益放大
+        const double gain = aperture == 3 ? 1 : (aperture == 5 ? 4 : 30);
+        for (bool l2 : {false, true}) {
+            QCOMPARE(CannyDetector::detect(image, 50 * gain, 150 * gain, aperture, l2),
+                     referenceCanny(image, 50 * gain, 150 * gain, aperture, l2));
+            QCOMPARE(CannyDetector::detect(image, 300 * gain, 100 * gain, aperture, l2),
+                     referenceCanny(image, 300 * gain, 100 * gain, aperture, l2));
+        }
+    }
+}
+
+void TestCannyDetector::testStepEdgeIsThin()
+{
+    QImage image(64, 24, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.scanLine(y)[x] = x < 32 ? 40 : 200;
+        }
+    }
+
+    // 阶跃两侧幅值相等，只保留左侧一列
+    for (int aperture = 3; aperture <= 7; aperture += 2) {
+        const QImage edges = CannyDetector::detect(image, 100, 200, aperture);
+        for (int y = 0; y < edges.height(); ++y) {
+            for (int x = 0; x < edges.width(); ++x) {
+                QCOMPARE(int(edges.constScanLine(y)[x]), x == 31 ? 255 : 0);
+            }
+        }
+    }
+}
+
+void TestCannyDetector::testHysteresisLinksWeakEdges()
+{
+    // 第 20 行处的水平边缘左半段对比度高（幅值 400）、右半段低（幅值 120）；
+    // 下方另有一块孤立的低对比度区域
+    QImage image(80, 60, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            int value = 100;
+            if (y >= 20 && y < 40) {
+                value += x < 40 ? 100 : 30;
+            } else if (y >= 48 && y < 56 && x >= 10 && x < 30) {
+                value += 30;
+            }
+            image.scanLine(y)[x] = static_cast<uchar>(value);
+        }
+    }
+
+    const QImage edges = CannyDetector::detect(image, 80, 300);
+
+    // 弱边缘经强边缘连接后整条保留（跳过对比度突变处的拐角）
+    for (int x = 0; x < image.width(); ++x) {
+        if (x < 36 || x >= 44) {
+            QCOMPARE(int(edges.constScanLine(19)[x]), 255);
+        }
+    }
+    // 不与强边缘相连的弱边缘被丢弃
+    QCOMPARE(edgeCount(edges, 44, 60), 0);
+    // 只有高阈值时弱边缘全部消失
+    QCOMPARE(edgeCount(CannyDetector::detect(image, 300, 300), 44, 60), 0);
+    QCOMPARE(int(CannyDetector::detect(image, 300, 300).constScanLine(19)[70]), 0);
+}
+
+void TestCannyDetector::testThresholdReuse()
+{
+    const QImage image = makeTexture(150, 90);
+    const CannyDetector detector(image, 3);
+
+    const double thresholds[][2] = {{20, 60}, {80, 240}, {150, 100}, {0, 0}};
+    for (const auto &pair : thresholds) {
+        QCOMPARE(detector.detect(pair[0], pair[1]), CannyDetector::detect(image, pair[0], pair[1]));
+    }
+}
+
+void TestCannyDetector::benchmarkThresholdSweep()
+{
+    const QImage image = makeTexture(3000, 2000);
+    const CannyDetector detector(image, 3);
+
+    // 梯度只算一次，拖动阈值时每次只做分类与连接
+    QBENCHMARK {
+        for (int high = 100; high <= 400; high += 100) {
+            detector.detect(high / 2, high);
+        }
+    }
+}
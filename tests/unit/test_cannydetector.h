@@ -0,0 +1,28 @@
+#ifndef TEST_CANNYDETECTOR_H
+#define TEST_CANNYDETECTOR_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/cannydetector.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief CannyDetector 单元测试
+ */
+class TestCannyDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void testMatchesReference();
+    void testStepEdgeIsThin();
+    void testHysteresisLinksWeakEdges();
+    void testThresholdReuse();
+    void benchmarkThresholdSweep();
+};
+
+#endif // TEST_CANNYDETECTOR_H
@@ -0,0 +1,176 @@
+/**
+ * @file test_convolution.cpp
+ * @brief ConvolutionEngine 单元测试实现
+ */
+
+#include "test_convolution.h"
+#include "services/image/simdsupport.h"
+#include <QRandomGenerator>
+#include <cmath>
+
+namespace {
+
+QImage makeRandomImage(int width, int height, QImage::Format format)
+{
+    QRandomGenerator rng(7);
+    QImage image(width, height, format);
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        const int bytes = format == QImage::Format_Grayscale8 ? width : width * 4;
+        for (int i = 0; i < bytes; ++i) {
+            line[i] = static_cast<uchar>(rng.bounded(256));
+        }
+    }
+    return image;
+}
+
+// 逐像素钳制坐标的朴素实现，作为对照
+QImage referenceConvolve(const QImage &image, const ConvolutionKernel &kernel,
+                         const ConvolutionOptions &options)
+{
+    const int channels = image.format() == QImage::Format_Grayscale8 ? 1 : 4;
+    QImage result(image.size(), image.format());
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            for (int c = 0; c < channels; ++c) {
+                float acc = 0.0f;
+                for (int ky = 0; ky < kernel.height; ++ky) {
+                    const int sy = qBound(0, y + ky - kernel.height / 2, image.height() - 1);
+                    for (int kx = 0; kx < kernel.width; ++kx) {
+                        const int sx = qBound(0, x + kx - kernel.width / 2, image.width() - 1);
+                        acc += kernel.at(kx, ky) * image.constScanLine(sy)[sx * channels + c];
+                    }
+                }
+                if (options.absolute) {
+                    acc = std::fabs(acc);
+                }
+                const float v = qBound(0.0f, acc * options.scale + options.offset, 255.0f);
+                result.scanLine(y)[x * channels + c] = static_cast<uchar>(std::lrintf(v));
+            }
+        }
+    }
+    return result;
+}
+
+int maxDifference(const QImage &a, const QImage &b)
+{
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uchar *la = a.constScanLine(y);
+        const uchar *lb = b.constScanLine(y);
+        const int bytes = a.format() == QImage::Format_Grayscale8 ? a.width() : a.width() * 4;
+        for (int i = 0; i < bytes; ++i) {
+            diff = qMax(diff, qAbs(la[i] - lb[i]));
+        }
+    }
+    return diff;
+}
+
+} // namespace
+
+void TestConvolution::cleanup()
+{
+    SimdSupport::clearLevelOverride();
+}
+
+void TestConvolution::testDecompose()
+{
+    QVector<float> row;
+    QVector<float> column;
+
+    QVERIFY(ConvolutionEngine::sobelX().decompose(row, column));
+    const ConvolutionKernel rebuilt = ConvolutionKernel::fromSeparable(row, column);
+    for (int i = 0; i < rebuilt.weights.size(); ++i) {
+        QVERIFY(qAbs(rebuilt.weights[i] - ConvolutionEngine::sobelX().weights[i]) < 1e-5f);
+    }
+
+    const ConvolutionKernel laplacian = ConvolutionKernel::fromMatrix(
+        QVector<QVector<int>>{{0, 1, 0}, {1, -4, 1}, {0, 1, 0}});
+    QVERIFY(laplacian.isValid());
+    QVERIFY(!laplacian.decompose(row, column));
+
+    QVERIFY(!ConvolutionKernel::fromMatrix(QVector<QVector<int>>{{1, 1}, {1, 1}}).isValid());
+}
+
+void TestConvolution::testMatchesReferenceAllLevels()
+{
+    // 宽度取奇数，覆盖 SIMD 循环的尾部
+    const QImage rgb = makeRandomImage(37, 19, QImage::Format_ARGB32);
+    const QImage gray = makeRandomImage(37, 19, QImage::Format_Grayscale8);
+    const ConvolutionKernel sharpen = ConvolutionKernel::fromMatrix(
+        QVector<QVector<int>>{{0, -1, 0}, {-1, 5, -1}, {0, -1, 0}});
+
+    ConvolutionOptions options;
+    options.preserveAlpha = false;
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON};
+    for (SimdLevel level : levels) {
+        SimdSupport::setLevelOverride(level);
+        QCOMPARE(maxDifference(ConvolutionEngine::convolve(rgb, sharpen, options),
+                               referenceConvolve(rgb, sharpen, options)), 0);
+
+        ConvolutionOptions absolute = options;
+        absolute.absolute = true;
+        absolute.offset = 3.0f;
+        QCOMPARE(maxDifference(ConvolutionEngine::convolve(gray, ConvolutionEngine::sobelY(), absolute),
+                               referenceConvolve(gray, ConvolutionEngine::sobelY(), absolute)), 0);
+    }
+}
+
+void TestConvolution::testSeparableMatchesDense()
+{
+    const QImage image = makeRandomImage(64, 48, QImage::Format_ARGB32);
+    const QVector<float> taps{1.0f, 4.0f, 6.0f, 4.0f, 1.0f};
+    const ConvolutionKernel separable = ConvolutionKernel::fromSeparable(taps, taps);
+
+    // 加一个极小扰动使核不可分离，走逐行累加路径
+    ConvolutionKernel dense = separable;
+    dense.weights[0] += 1e-3f;
+
+    ConvolutionOptions options;
+    options.scale = 1.0f / 256.0f;
+    options.preserveAlpha = false;
+
+    QVERIFY(maxDifference(ConvolutionEngine::convolve(image, separable, options),
+                          ConvolutionEngine::convolve(image, dense, options)) <= 1);
+    QCOMPARE(maxDifference(ConvolutionEngine::convolve(image, separable, options),
+                           referenceConvolve(image, separable, options)), 0);
+}
+
+void TestConvolution::testPreserveAlpha()
+{
+    QImage image(8, 8, QImage::Format_ARGB32);
+    image.fill(qRgba(100, 150, 200, 77));
+
+    const ConvolutionKernel box = ConvolutionKernel::fromSeparable({1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    ConvolutionOptions options;
+    options.scale = 1.0f / 9.0f;
+
+    const QImage kept = ConvolutionEngine::convolve(image, box, options);
+    QCOMPARE(kept.pixel(4, 4), qRgba(100, 150, 200, 77));
+
+    // RGB32 即使不要求保留，alpha 也保持 0xff
+    options.preserveAlpha = false;
+    const QImage opaque = ConvolutionEngine::convolve(image.convertToFormat(QImage::Format_RGB32), box, options);
+    QCOMPARE(qAlpha(opaque.pixel(0, 0)), 255);
+}
+
+void TestConvolution::testGradientMagnitude()
+{
+    // 左半黑右半白：只有中间两列有水平梯度
+    QImage image(16, 8, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = x < 8 ? 0 : 40;
+        }
+    }
+
+    const QImage magnitude = ConvolutionEngine::gradientMagnitude(
+        image, ConvolutionEngine::sobelX(), ConvolutionEngine::sobelY());
+    QCOMPARE(magnitude.format(), QImage::Format_Grayscale8);
+    QCOMPARE(magnitude.pixelIndex(0, 4), 0);
+    QCOMPARE(magnitude.pixelIndex(7, 4), 160);
+    QCOMPARE(magnitude.pixelIndex(8, 4), 160);
+    QCOMPARE(magnitude.pixelIndex(15, 0), 0);
+}
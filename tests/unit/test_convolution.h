@@ -0,0 +1,30 @@
+#ifndef TEST_CONVOLUTION_H
+#define TEST_CONVOLUTION_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/convolution.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ConvolutionEngine 单元测试
+ */
+class TestConvolution : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void cleanup();
+
+    void testDecompose();
+    void testMatchesReferenceAllLevels();
+    void testSeparableMatchesDense();
+    void testPreserveAlpha();
+    void testGradientMagnitude();
+};
+
+#endif // TEST_CONVOLUTION_H
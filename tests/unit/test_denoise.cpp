@@ -0,0 +1,241 @@
+/**
+ * @file test_denoise.cpp
+ * @brief BilateralFilter 与 NonLocalMeans 单元测试实现
+ */
+
+#include "test_denoise.h"
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+// 左暗右亮的阶跃图像，叠加均匀噪声
+QImage makeNoisyStep(int width, int height, int noise)
+{
+    QRandomGenerator rng(5);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int base = x < width / 2 ? 60 : 190;
+            auto sample = [&](int value) {
+                return qBound(0, value + rng.bounded(2 * noise + 1) - noise, 255);
+            };
+            line[x] = qRgba(sample(base), sample(base - 20), sample(base + 10), 200);
+        }
+    }
+    return image;
+}
+
+QRgb clampedPixel(const QImage &image, int x, int y)
+{
+    return image.pixel(qBound(0, x, image.width() - 1), qBound(0, y, image.height() - 1));
+}
+
+// 按定义逐像素计算的双边滤波（圆形窗口，亮度差作为值域距离）
+QImage referenceBilateral(const QImage &image, double sigmaSpatial, double sigmaRange, int radius)
+{
+    QImage result(image.size(), image.format());
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb center = image.pixel(x, y);
+            double sum[4] = {0, 0, 0, 0};
+            for (int dy = -radius; dy <= radius; ++dy) {
+                for (int dx = -radius; dx <= radius; ++dx) {
+                    if (dx * dx + dy * dy > radius * radius) {
+                        continue;
+                    }
+                    const QRgb pixel = clampedPixel(image, x + dx, y + dy);
+                    const int diff = qGray(pixel) - qGray(center);
+                    const double w = qExp(-(dx * dx + dy * dy) / (2 * sigmaSpatial * sigmaSpatial))
+                                     * qExp(-diff * diff / (2 * sigmaRange * sigmaRange));
+                    sum[0] += w * qRed(pixel);
+                    sum[1] += w * qGreen(pixel);
+                    sum[2] += w * qBlue(pixel);
+                    sum[3] += w;
+                }
+            }
+            result.setPixel(x, y, qRgba(qRound(sum[0] / sum[3]), qRound(sum[1] / sum[3]),
+                                        qRound(sum[2] / sum[3]), qAlpha(center)));
+        }
+    }
+    return result;
+}
+
+// 按定义逐块比较的非局部均值
+QImage referenceNonLocalMeans(const QImage &image, double h, int patchRadius, int searchRadius)
+{
+    const int patchSide = 2 * patchRadius + 1;
+    QImage result(image.size(), image.format());
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            double sum[3] = {0, 0, 0};
+            double weightSum = 0;
+            double weightMax = 0;
+            for (int dy = -searchRadius; dy <= searchRadius; ++dy) {
+                for (int dx = -searchRadius; dx <= searchRadius; ++dx) {
+                    if (dx == 0 && dy == 0) {
+                        continue;
+                    }
+                    double distance = 0;
+                    for (int py = -patchRadius; py <= patchRadius; ++py) {
+                        for (int px = -patchRadius; px <= patchRadius; ++px) {
+                            const QRgb a = clampedPixel(image, x + px, y + py);
+                            const QRgb b = clampedPixel(image, x + px + dx, y + py + dy);
+                            distance += qPow(qRed(a) - qRed(b), 2) + qPow(qGreen(a) - qGreen(b), 2)
+                                        + qPow(qBlue(a) - qBlue(b), 2);
+                        }
+                    }
+                    const double t = distance / (3.0 * patchSide * patchSide * h * h);
+                    if (t >= 8.0) {
+                        continue;
+                    }
+                    const double w = qExp(-t);
+                    const QRgb neighbor = clampedPixel(image, x + dx, y + dy);
+                    sum[0] += w * qRed(neighbor);
+                    sum[1] += w * qGreen(neighbor);
+                    sum[2] += w * qBlue(neighbor);
+                    weightSum += w;
+                    weightMax = qMax(weightMax, w);
+                }
+            }
+            const QRgb center = image.pixel(x, y);
+            if (weightMax <= 0) {
+                result.setPixel(x, y, center);
+                continue;
+            }
+            const double total = weightSum + weightMax;
+            result.setPixel(x, y, qRgba(qRound((sum[0] + weightMax * qRed(center)) / total),
+                                        qRound((sum[1] + weightMax * qGreen(center)) / total),
+                                        qRound((sum[2] + weightMax * qBlue(center)) / total),
+                                        qAlpha(center)));
+        }
+    }
+    return result;
+}
+
+int maxDifference(const QImage &a, const QImage &b)
+{
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uchar *la = a.constScanLine(y);
+        const uchar *lb = b.constScanLine(y);
+        for (int i = 0; i < a.width() * 4; ++i) {
+            diff = qMax(diff, qAbs(la[i] - lb[i]));
+        }
+    }
+    return diff;
+}
+
+// 左半边远离边缘区域红色通道的标准差
+double flatRegionNoise(const QImage &image)
+{
+    double sum = 0;
+    double sum2 = 0;
+    int count = 0;
+    for (int y = 4; y < image.height() - 4; ++y) {
+        for (int x = 4; x < image.width() / 2 - 8; ++x) {
+            const int value = qRed(image.pixel(x, y));
+            sum += value;
+            sum2 += value * value;
+            ++count;
+        }
+    }
+    const double mean = sum / count;
+    return qSqrt(sum2 / count - mean * mean);
+}
+
+// 边缘两侧各一列之外不应出现介于两侧亮度之间的过渡值
+void verifySharpEdge(const QImage &image)
+{
+    const int edge = image.width() / 2;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const int red = qRed(image.pixel(x, y));
+            if (x < edge - 1) {
+                QVERIFY2(red < 100, qPrintable(QString("(%1, %2) = %3").arg(x).arg(y).arg(red)));
+            } else if (x > edge) {
+                QVERIFY2(red > 150, qPrintable(QString("(%1, %2) = %3").arg(x).arg(y).arg(red)));
+            }
+        }
+    }
+}
+
+} // namespace
+
+void TestDenoise::testBilateralMatchesReference()
+{
+    const QImage image = makeNoisyStep(53, 31, 20);
+
+    // 半径不超过 DIRECT_MAX_RADIUS 时为逐像素直接计算，与定义只差舍入
+    const double sigmas[] = {0.8, 1.1, 1.4};
+    for (double sigma : sigmas) {
+        const int radius = qCeil(2 * sigma);
+        QVERIFY(radius <= BilateralFilter::DIRECT_MAX_RADIUS);
+        QVERIFY(maxDifference(BilateralFilter::apply(image, sigma, 30),
+                              referenceBilateral(image, sigma, 30, radius)) <= 1);
+    }
+}
+
+void TestDenoise::testBilateralGridPreservesEdges()
+{
+    const QImage image = makeNoisyStep(96, 48, 20);
+    const QImage filtered = BilateralFilter::apply(image, 3.0, 30);
+
+    QVERIFY(flatRegionNoise(filtered) < flatRegionNoise(image) / 4);
+    verifySharpEdge(filtered);
+
+    // 网格近似与按定义计算的结果平均相差不到 1 个灰度级
+    const QImage reference = referenceBilateral(image, 3.0, 30, 9);
+    qint64 total = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            total += qAbs(qRed(filtered.pixel(x, y)) - qRed(reference.pixel(x, y)));
+        }
+    }
+    QVERIFY(total < image.width() * image.height());
+}
+
+void TestDenoise::testNonLocalMeansMatchesReference()
+{
+    // 宽度超过一个列分块，覆盖分块与行带边界
+    const QImage image = makeNoisyStep(530, 40, 15);
+
+    for (int patchRadius = 1; patchRadius <= 2; ++patchRadius) {
+        QVERIFY(maxDifference(NonLocalMeans::apply(image, 12, patchRadius, 3),
+                              referenceNonLocalMeans(image, 12, patchRadius, 3)) <= 1);
+    }
+}
+
+void TestDenoise::testNonLocalMeansPreservesEdges()
+{
+    const QImage image = makeNoisyStep(96, 48, 20);
+    const QImage filtered = NonLocalMeans::apply(image, 15);
+
+    QVERIFY(flatRegionNoise(filtered) < flatRegionNoise(image) / 3);
+    verifySharpEdge(filtered);
+}
+
+void TestDenoise::testPreservesAlpha()
+{
+    QImage image = makeNoisyStep(40, 40, 10);
+    image.setPixel(7, 9, qRgba(60, 40, 70, 3));
+
+    const QImage bilateral = BilateralFilter::apply(image, 2.5, 20);
+    const QImage nlm = NonLocalMeans::apply(image, 10);
+    QCOMPARE(qAlpha(bilateral.pixel(7, 9)), 3);
+    QCOMPARE(qAlpha(nlm.pixel(7, 9)), 3);
+    QCOMPARE(qAlpha(bilateral.pixel(30, 30)), 200);
+    QCOMPARE(qAlpha(nlm.pixel(30, 30)), 200);
+}
+
+void TestDenoise::benchmarkLargeImage()
+{
+    const QImage image = makeNoisyStep(2000, 1500, 15);
+
+    QBENCHMARK {
+        BilateralFilter::apply(image, 4.0, 20);
+        NonLocalMeans::apply(image, 10);
+    }
+}
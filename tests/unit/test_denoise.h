@@ -0,0 +1,30 @@
+#ifndef TEST_DENOISE_H
+#define TEST_DENOISE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/bilateralfilter.h"
+#include "services/image/nonlocalmeans.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief BilateralFilter 与 NonLocalMeans 单元测试
+ */
+class TestDenoise : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 6; }
+
+private slots:
+    void testBilateralMatchesReference();
+    void testBilateralGridPreservesEdges();
+    void testNonLocalMeansMatchesReference();
+    void testNonLocalMeansPreservesEdges();
+    void testPreservesAlpha();
+    void benchmarkLargeImage();
+};
+
+#endif // TEST_DENOISE_H
@@ -0,0 +1,158 @@
+/**
+ * @file test_detectionpostprocess.cpp
+ * @brief DetectionPostProcess 单元测试实现
+ */
+
+#include "test_detectionpostprocess.h"
+#include <QRandomGenerator>
+
+namespace {
+
+Detection makeDetection(int x, int y, int size, float confidence, int classId)
+{
+    Detection det;
+    det.x = x;
+    det.y = y;
+    det.width = size;
+    det.height = size;
+    det.confidence = confidence;
+    det.classId = classId;
+    det.label = QString("class_%1").arg(classId);
+    return det;
+}
+
+// 10k 个随机框（4000x4000 画布，80 类），用于性能测试
+QVector<Detection> makeRandomDetections(int count)
+{
+    QRandomGenerator rng(1);
+    QVector<Detection> detections;
+    detections.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        detections.append(makeDetection(rng.bounded(4000), rng.bounded(4000), 10 + rng.bounded(190),
+                                        static_cast<float>(rng.generateDouble()), rng.bounded(80)));
+    }
+    return detections;
+}
+
+} // namespace
+
+void TestDetectionPostProcess::testConfidenceFilter()
+{
+    const QVector<Detection> candidates{
+        makeDetection(0, 0, 50, 0.9f, 0),
+        makeDetection(200, 0, 50, 0.3f, 0),
+        makeDetection(400, 0, 50, 0.1f, 0)
+    };
+
+    QCOMPARE(DetectionPostProcess::filterCandidates(candidates, 0.25f, 0.45f).size(), 2);
+    QCOMPARE(DetectionPostProcess::filterCandidates(candidates, 0.05f, 0.45f).size(), 3);
+    QCOMPARE(DetectionPostProcess::filterCandidates(candidates, 0.95f, 0.45f).size(), 0);
+}
+
+void TestDetectionPostProcess::testClassAwareThenAgnostic()
+{
+    // 0 与 1 同类且重叠；2 与 1 完全重合但类别不同
+    const QVector<Detection> candidates{
+        makeDetection(0, 0, 100, 0.9f, 0),
+        makeDetection(5, 5, 100, 0.8f, 0),
+        makeDetection(5, 5, 100, 0.7f, 1)
+    };
+
+    // IoU(0, 1) ≈ 0.82：阈值 0.45 时只保留最高分的框
+    QVector<Detection> kept = DetectionPostProcess::filterCandidates(candidates, 0.25f, 0.45f);
+    QCOMPARE(kept.size(), 1);
+    QCOMPARE(kept[0].confidence, 0.9f);
+
+    // 阈值 0.95 时 0 与 1 都保留；2 与 1 完全重合，跨类别 NMS 将其去除
+    kept = DetectionPostProcess::filterCandidates(candidates, 0.25f, 0.95f);
+    QCOMPARE(kept.size(), 2);
+    QCOMPARE(kept[1].confidence, 0.8f);
+}
+
+void TestDetectionPostProcess::testOrderedByConfidence()
+{
+    const QVector<Detection> candidates{
+        makeDetection(0, 0, 20, 0.3f, 0),
+        makeDetection(100, 0, 20, 0.9f, 1),
+        makeDetection(200, 0, 20, 0.6f, 2)
+    };
+
+    const QVector<Detection> kept = DetectionPostProcess::filterCandidates(candidates, 0.25f, 0.45f);
+    QCOMPARE(kept.size(), 3);
+    QVERIFY(kept[0].confidence >= kept[1].confidence);
+    QVERIFY(kept[1].confidence >= kept[2].confidence);
+}
+
+void TestDetectionPostProcess::testNmsModes()
+{
+    // 两个完全重合的框，类别不同
+    const QVector<Detection> detections{
+        makeDetection(0, 0, 100, 0.9f, 0),
+        makeDetection(0, 0, 100, 0.8f, 1)
+    };
+
+    QCOMPARE(DetectionPostProcess::nms(detections, 0.5f, DetectionPostProcess::NmsMode::ClassAware).size(), 2);
+    QCOMPARE(DetectionPostProcess::nms(detections, 0.5f, DetectionPostProcess::NmsMode::Agnostic).size(), 1);
+    QCOMPARE(DetectionPostProcess::nms(detections, 0.5f, DetectionPostProcess::NmsMode::ClassAware, 1).size(), 1);
+}
+
+void TestDetectionPostProcess::testSoftNms()
+{
+    const QVector<Detection> detections{
+        makeDetection(0, 0, 100, 0.9f, 0),
+        makeDetection(5, 5, 100, 0.8f, 0),
+        makeDetection(500, 500, 100, 0.7f, 0)
+    };
+
+    // 重叠框分数被衰减但不删除，不重叠的框分数不变并排到前面
+    const QVector<Detection> kept = DetectionPostProcess::softNms(detections, 0.3f);
+    QCOMPARE(kept.size(), 3);
+    QCOMPARE(kept[0].confidence, 0.9f);
+    QCOMPARE(kept[1].confidence, 0.7f);
+    QVERIFY(kept[2].confidence < 0.8f);
+    QCOMPARE(kept[2].x, 5);
+
+    // 分数阈值高于衰减后的分数时该框被删除
+    QCOMPARE(DetectionPostProcess::softNms(detections, 0.3f, 0.5f, 0.5f).size(), 2);
+
+    // 线性衰减：完全重合的框分数衰减为 0
+    const QVector<Detection> duplicates{
+        makeDetection(0, 0, 100, 0.9f, 0),
+        makeDetection(0, 0, 100, 0.8f, 0)
+    };
+    QCOMPARE(DetectionPostProcess::softNms(duplicates, 0.3f, 0.5f, 0.001f,
+                                           DetectionPostProcess::SoftNmsMethod::Linear).size(), 1);
+}
+
+void TestDetectionPostProcess::testTopK()
+{
+    const QVector<Detection> detections = makeRandomDetections(1000);
+    const QVector<Detection> top = DetectionPostProcess::topK(detections, 10);
+    QCOMPARE(top.size(), 10);
+
+    const float minTop = top.last().confidence;
+    int higher = 0;
+    for (const Detection &det : detections) {
+        if (det.confidence > minTop) {
+            ++higher;
+        }
+    }
+    QVERIFY(higher < 10);
+    for (int i = 1; i < top.size(); ++i) {
+        QVERIFY(top[i - 1].confidence >= top[i].confidence);
+    }
+
+    QCOMPARE(DetectionPostProcess::topK(detections, 0).size(), 0);
+    QCOMPARE(DetectionPostProcess::topK(detections, 5000).size(), 1000);
+}
+
+void TestDetectionPostProcess::benchmarkNms10k()
+{
+    const QVector<Detection> detections = makeRandomDetections(10000);
+    QVector<Detection> kept;
+    QBENCHMARK {
+        kept = DetectionPostProcess::nms(detections, 0.45f, DetectionPostProcess::NmsMode::ClassAware);
+    }
+    QVERIFY(!kept.isEmpty());
+    QVERIFY(kept.size() <= detections.size());
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_DETECTIONPOSTPROCESS_H
+#define TEST_DETECTIONPOSTPROCESS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/inference/detectionpostprocess.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief DetectionPostProcess 单元测试
+ */
+class TestDetectionPostProcess : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 7; }
+
+private slots:
+    void testConfidenceFilter();
+    void testClassAwareThenAgnostic();
+    void testOrderedByConfidence();
+    void testNmsModes();
+    void testSoftNms();
+    void testTopK();
+    void benchmarkNms10k();
+};
+
+#endif // TEST_DETECTIONPOSTPROCESS_H
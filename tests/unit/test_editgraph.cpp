@@ -0,0 +1,234 @@
+/**
+ * @file test_editgraph.cpp
+ * @brief EditGraph / ImagePyramid 单元测试实现
+ */
+
+#include "test_editgraph.h"
+#include "services/image/imageprocessor.h"
+#include <QRandomGenerator>
+
+namespace {
+
+// 平滑渐变叠加噪声，使模糊、锐化和二值化都有非平凡的结果
+QImage makeImage(int width, int height)
+{
+    QRandomGenerator rng(29);
+    QImage image(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int noise = static_cast<int>(rng.bounded(64));
+            line[x] = qRgb((x * 255 / width + noise) & 0xff,
+                           (y * 255 / height + noise) & 0xff,
+                           ((x + y) * 3 + noise) & 0xff);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+void TestEditGraph::testMatchesSequentialApplication()
+{
+    const QImage source = makeImage(97, 83);
+
+    EditGraph graph(source);
+    graph.append(EditOperation::gaussianBlur(4));
+    graph.append(EditOperation::sharpen(1.5));
+    graph.append(EditOperation::flipHorizontal());
+    graph.append(EditOperation::rotate(90));
+    graph.append(EditOperation::threshold(120));
+
+    QImage expected = ImageProcessor::gaussianBlur(source, 4);
+    expected = ImageProcessor::sharpen(expected, 1.5);
+    expected = ImageProcessor::flipHorizontal(expected);
+    expected = ImageProcessor::rotate(expected, 90);
+    expected = ImageProcessor::threshold(expected, 120);
+
+    const QImage result = graph.result();
+    QCOMPARE(result.size(), QSize(83, 97));
+    QCOMPARE(graph.outputSize(), result.size());
+    QCOMPARE(result, expected);
+
+    // 没有操作时结果就是原图
+    EditGraph empty(source);
+    QCOMPARE(empty.result(), source);
+    QVERIFY(EditGraph().result().isNull());
+}
+
+void TestEditGraph::testRegionMatchesFullResult()
+{
+    const QImage source = makeImage(120, 90);
+
+    EditGraph reference(source);
+    reference.append(EditOperation::gaussianBlur(9));
+    reference.append(EditOperation::sobelEdges());
+    reference.append(EditOperation::invert());
+    const QImage full = reference.result();
+
+    // 内部、贴边、单像素和超出图像的区域
+    const QVector<QRect> regions = {QRect(30, 20, 40, 30), QRect(0, 0, 17, 90),
+                                    QRect(100, 70, 20, 20), QRect(61, 44, 1, 1),
+                                    QRect(110, 80, 50, 50)};
+    for (const QRect &region : regions) {
+        // 每个区域都在新的编辑链上计算，避免命中其它区域的缓存
+        EditGraph graph(source);
+        graph.append(EditOperation::gaussianBlur(9));
+        graph.append(EditOperation::sobelEdges());
+        graph.append(EditOperation::invert());
+
+        const QRect clipped = region & full.rect();
+        const QImage rendered = graph.render(region);
+        QCOMPARE(rendered.size(), clipped.size());
+        QCOMPARE(rendered, full.copy(clipped));
+    }
+
+    QVERIFY(reference.render(QRect(200, 200, 10, 10)).isNull());
+}
+
+void TestEditGraph::testEditReevaluatesOnlyDownstream()
+{
+    EditGraph graph(makeImage(64, 48));
+    graph.append(EditOperation::gaussianBlur(4));
+    graph.append(EditOperation::sharpen(1.0));
+    graph.append(EditOperation::threshold(100));
+    graph.result();
+    QCOMPARE(graph.evaluationCount(), 3);
+
+    // 结果已缓存
+    graph.result();
+    QCOMPARE(graph.evaluationCount(), 3);
+
+    // 只修改最后一个操作：模糊和锐化的结果直接复用
+    graph.replace(2, EditOperation::threshold(160));
+    const QImage changed = graph.result();
+    QCOMPARE(graph.evaluationCount(), 4);
+
+    // 撤销后上游缓存仍在，重做只需重新计算被移出的操作
+    QVERIFY(graph.undo());
+    QCOMPARE(graph.count(), 2);
+    QVERIFY(graph.canRedo());
+    graph.result();
+    QCOMPARE(graph.evaluationCount(), 4);
+    QVERIFY(graph.redo());
+    QCOMPARE(graph.result(), changed);
+    QCOMPARE(graph.evaluationCount(), 5);
+
+    // 新的操作清空重做列表
+    QVERIFY(graph.undo());
+    graph.append(EditOperation::invert());
+    QVERIFY(!graph.canRedo());
+    QVERIFY(!graph.redo());
+
+    // 修改第一个操作使其后全部失效
+    graph.replace(0, EditOperation::gaussianBlur(2));
+    graph.result();
+    QCOMPARE(graph.evaluationCount(), 8);
+}
+
+void TestEditGraph::testImagePyramid()
+{
+    QImage image(5, 3, QImage::Format_Grayscale8);
+    for (int y = 0; y < 3; ++y) {
+        for (int x = 0; x < 5; ++x) {
+            image.scanLine(y)[x] = static_cast<uchar>(x * 10 + y * 100);
+        }
+    }
+
+    const QImage half = ImagePyramid::halve(image);
+    QCOMPARE(half.size(), QSize(3, 2));
+    QCOMPARE(half.format(), QImage::Format_Grayscale8);
+    QCOMPARE(static_cast<int>(half.constScanLine(0)[0]), 55);   // (0+10+100+110)/4
+    QCOMPARE(static_cast<int>(half.constScanLine(0)[2]), 90);   // 奇数列只与自身平均
+    QCOMPARE(static_cast<int>(half.constScanLine(1)[1]), 225);  // 奇数行只与自身平均
+
+    QCOMPARE(ImagePyramid::levelForScale(2.0), 0);
+    QCOMPARE(ImagePyramid::levelForScale(1.0), 0);
+    QCOMPARE(ImagePyramid::levelForScale(0.5), 1);
+    QCOMPARE(ImagePyramid::levelForScale(0.3), 1);
+    QCOMPARE(ImagePyramid::levelForScale(0.25), 2);
+
+    ImagePyramid pyramid(makeImage(200, 100));
+    QCOMPARE(pyramid.maxLevel(), 3);
+    QCOMPARE(pyramid.level(1).size(), QSize(100, 50));
+    QCOMPARE(pyramid.level(10).size(), QSize(25, 13));
+
+    // 缩小显示时在金字塔层上计算，区域随层缩小
+    EditGraph graph(makeImage(200, 100));
+    graph.append(EditOperation::gaussianBlur(16));
+    QCOMPARE(graph.outputSize(2), QSize(50, 25));
+    const QImage preview = graph.renderForScale(QRect(40, 20, 81, 40), 0.3);
+    QCOMPARE(preview.size(), QSize(41, 20));
+}
+
+void TestEditGraph::testCacheBudget()
+{
+    const QImage source = makeImage(80, 60);
+
+    EditGraph unlimited(source);
+    EditGraph limited(source);
+    limited.setCacheBudget(source.sizeInBytes());
+    for (EditGraph *graph : {&unlimited, &limited}) {
+        graph->append(EditOperation::gaussianBlur(4));
+        graph->append(EditOperation::invert());
+        graph->append(EditOperation::sharpen(2.0));
+    }
+
+    QCOMPARE(limited.result(), unlimited.result());
+    QCOMPARE(limited.render(QRect(10, 10, 30, 20)), unlimited.render(QRect(10, 10, 30, 20)));
+    QVERIFY(limited.cachedBytes() <= limited.cacheBudget());
+    QVERIFY(unlimited.cachedBytes() > limited.cachedBytes());
+
+    limited.clearCache();
+    QCOMPARE(limited.cachedBytes(), qint64(0));
+    QCOMPARE(limited.result(), unlimited.result());
+}
+
+void TestEditGraph::testFoldFirst()
+{
+    const QImage source = makeImage(90, 70);
+
+    EditGraph graph(source);
+    graph.append(EditOperation::gaussianBlur(3));
+    graph.append(EditOperation::rotate(90));
+    graph.append(EditOperation::sharpen(1.0));
+    graph.append(EditOperation::threshold(140));
+    QVERIFY(graph.undo());
+    const QImage expected = graph.result();
+    graph.renderForScale(QRect(0, 0, 70, 90), 0.4);
+    const int evaluations = graph.evaluationCount();
+
+    // 并入后结果不变，返回原来的原图，重做列表保留
+    QCOMPARE(graph.foldFirst(), source);
+    QCOMPARE(graph.count(), 2);
+    QCOMPARE(graph.source(), ImageProcessor::gaussianBlur(source, 3));
+    QVERIFY(graph.canRedo());
+
+    // 原分辨率上后续节点的缓存仍然可用
+    QCOMPARE(graph.result(), expected);
+    QCOMPARE(graph.evaluationCount(), evaluations);
+
+    QVERIFY(graph.redo());
+    QCOMPARE(graph.result(), ImageProcessor::threshold(expected, 140));
+
+    EditGraph empty(source);
+    QVERIFY(empty.foldFirst().isNull());
+    QCOMPARE(empty.source(), source);
+}
+
+void TestEditGraph::benchmarkViewportEdit()
+{
+    EditGraph graph(makeImage(6000, 4000));
+    graph.append(EditOperation::gaussianBlur(9));
+    graph.append(EditOperation::sharpen(1.0));
+    graph.append(EditOperation::threshold(128));
+    const QRect viewport(2000, 1500, 1280, 720);
+    graph.render(viewport);
+
+    // 调整最后一个参数后只重新计算可见区域
+    int value = 100;
+    QBENCHMARK {
+        graph.replace(2, EditOperation::threshold(value++));
+        graph.render(viewport);
+    }
+}
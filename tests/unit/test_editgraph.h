@@ -0,0 +1,30 @@
+#ifndef TEST_EDITGRAPH_H
+#define TEST_EDITGRAPH_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/editgraph.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief EditGraph / ImagePyramid 单元测试
+ */
+class TestEditGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 7; }
+
+private slots:
+    void testMatchesSequentialApplication();
+    void testRegionMatchesFullResult();
+    void testEditReevaluatesOnlyDownstream();
+    void testImagePyramid();
+    void testCacheBudget();
+    void testFoldFirst();
+    void benchmarkViewportEdit();
+};
+
+#endif // TEST_EDITGRAPH_H
@@ -0,0 +1,126 @@
+/**
+ * @file test_gaussianblur.cpp
+ * @brief GaussianBlur 单元测试实现
+ */
+
+#include "test_gaussianblur.h"
+#include "services/image/simdsupport.h"
+#include <QRandomGenerator>
+#include <cmath>
+
+namespace {
+
+// 由阶跃边缘的一阶差分估计模糊的标准差
+double measuredSigma(const QImage &blurred, int row)
+{
+    const uchar *line = blurred.constScanLine(row);
+    double total = 0;
+    double mean = 0;
+    for (int x = 1; x < blurred.width(); ++x) {
+        const double d = line[x] - line[x - 1];
+        total += d;
+        mean += d * (x - 0.5);
+    }
+    mean /= total;
+
+    double variance = 0;
+    for (int x = 1; x < blurred.width(); ++x) {
+        const double d = line[x] - line[x - 1];
+        variance += d * (x - 0.5 - mean) * (x - 0.5 - mean);
+    }
+    return std::sqrt(variance / total);
+}
+
+} // namespace
+
+void TestGaussianBlur::cleanup()
+{
+    SimdSupport::clearLevelOverride();
+}
+
+void TestGaussianBlur::testBoxFilterVariance()
+{
+    const double sigmas[] = {0.3, 1.0, 2.5, 7.0, 40.0};
+    for (double sigma : sigmas) {
+        const QVector<BoxFilter> filters = GaussianBlur::boxFilters(sigma);
+        QCOMPARE(filters.size(), 3);
+
+        double variance = 0;
+        for (const BoxFilter &box : filters) {
+            // 权重归一化
+            QVERIFY(qAbs((2 * box.radius + 1) * box.innerWeight + 2 * box.edgeWeight - 1.0f) < 1e-5f);
+            QVERIFY(box.edgeWeight >= 0.0f && box.edgeWeight <= box.innerWeight);
+
+            double boxVariance = 0;
+            for (int i = 1; i <= box.radius; ++i) {
+                boxVariance += 2.0 * i * i * box.innerWeight;
+            }
+            boxVariance += 2.0 * (box.radius + 1) * (box.radius + 1) * box.edgeWeight;
+            variance += boxVariance;
+        }
+        QVERIFY(qAbs(variance - sigma * sigma) < 1e-3 * sigma * sigma);
+    }
+}
+
+void TestGaussianBlur::testConstantImageUnchanged()
+{
+    QImage image(40, 30, QImage::Format_ARGB32);
+    image.fill(qRgba(12, 130, 251, 200));
+
+    const QImage blurred = GaussianBlur::blur(image, 6.0);
+    for (int y = 0; y < blurred.height(); y += 7) {
+        for (int x = 0; x < blurred.width(); x += 5) {
+            QCOMPARE(blurred.pixel(x, y), qRgba(12, 130, 251, 200));
+        }
+    }
+}
+
+void TestGaussianBlur::testStepResponseSigma()
+{
+    QImage image(401, 5, QImage::Format_Grayscale8);
+    for (int y = 0; y < image.height(); ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = x < 200 ? 0 : 255;
+        }
+    }
+
+    const double sigmas[] = {1.0, 3.0, 10.0};
+    for (double sigma : sigmas) {
+        const double measured = measuredSigma(GaussianBlur::blur(image, sigma), 2);
+        QVERIFY2(qAbs(measured - sigma) < 0.05 * sigma,
+                 qPrintable(QString("sigma %1 measured %2").arg(sigma).arg(measured)));
+    }
+}
+
+void TestGaussianBlur::testSimdLevelsAgree()
+{
+    QRandomGenerator rng(3);
+    QImage image(203, 77, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = rng.generate();
+        }
+    }
+
+    SimdSupport::setLevelOverride(SimdLevel::Scalar);
+    const QImage reference = GaussianBlur::blur(image, 3.7);
+
+    const SimdLevel levels[] = {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON};
+    for (SimdLevel level : levels) {
+        SimdSupport::setLevelOverride(level);
+        QCOMPARE(GaussianBlur::blur(image, 3.7), reference);
+    }
+}
+
+void TestGaussianBlur::benchmarkLargeSigma()
+{
+    QImage image(4000, 3000, QImage::Format_ARGB32);
+    image.fill(qRgb(90, 120, 150));
+
+    // 代价与 sigma 无关
+    QBENCHMARK {
+        GaussianBlur::blur(image, 25.0);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_GAUSSIANBLUR_H
+#define TEST_GAUSSIANBLUR_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/gaussianblur.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief GaussianBlur 单元测试
+ */
+class TestGaussianBlur : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void cleanup();
+
+    void testBoxFilterVariance();
+    void testConstantImageUnchanged();
+    void testStepResponseSigma();
+    void testSimdLevelsAgree();
+    void benchmarkLargeSigma();
+};
+
+#endif // TEST_GAUSSIANBLUR_H
@@ -0,0 +1,95 @@
+/**
+ * @file test_imagebuffer.cpp
+ * @brief ImageBuffer 单元测试实现
+ */
+
+#include "test_imagebuffer.h"
+
+namespace {
+
+QImage makeImage(int width, int height)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = qRgb(x & 0xff, y & 0xff, (x + y) & 0xff);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+void TestImageBuffer::testCopiesShareData()
+{
+    const QImage image = makeImage(64, 48);
+    const ImageBuffer buffer(image);
+    QVERIFY(!buffer.isNull());
+    QCOMPARE(buffer.size(), image.size());
+
+    // 句柄的复制不复制像素，各层取到的是同一份数据
+    const ImageBuffer copy = buffer;
+    QVERIFY(copy.isSharedWith(buffer));
+    QCOMPARE(copy.cacheKey(), buffer.cacheKey());
+    QCOMPARE(copy.image().constBits(), image.constBits());
+    QCOMPARE(buffer.image().constBits(), image.constBits());
+
+    // 同样的像素另建的缓冲区是另一个版本
+    const ImageBuffer other(image);
+    QVERIFY(!other.isSharedWith(buffer));
+    QVERIFY(other.cacheKey() != buffer.cacheKey());
+}
+
+void TestImageBuffer::testMutationDetaches()
+{
+    const QImage image = makeImage(64, 48);
+    const ImageBuffer original(image);
+    ImageBuffer edited = original;
+    const qint64 key = original.cacheKey();
+
+    edited.mutableImage().setPixel(3, 4, qRgb(1, 2, 3));
+
+    // 修改只影响自己的句柄
+    QVERIFY(!edited.isSharedWith(original));
+    QVERIFY(edited.cacheKey() != key);
+    QCOMPARE(original.cacheKey(), key);
+    QCOMPARE(original.image(), image);
+    QCOMPARE(edited.image().pixel(3, 4), qRgb(1, 2, 3));
+    QCOMPARE(edited.image().pixel(4, 4), image.pixel(4, 4));
+}
+
+void TestImageBuffer::testMutationWithoutSharing()
+{
+    ImageBuffer buffer(makeImage(32, 32));
+    const qint64 key = buffer.cacheKey();
+
+    // 没有其它句柄和 QImage 引用时原地修改，不复制像素
+    const uchar *bits = buffer.image().constBits();
+    QImage &pixels = buffer.mutableImage();
+    pixels.setPixel(0, 0, qRgb(9, 9, 9));
+    QCOMPARE(buffer.image().constBits(), bits);
+    QCOMPARE(buffer.image().pixel(0, 0), qRgb(9, 9, 9));
+    QVERIFY(buffer.cacheKey() != key);
+
+    // 再次修改版本继续改变
+    const qint64 editedKey = buffer.cacheKey();
+    buffer.mutableImage().setPixel(1, 0, qRgb(8, 8, 8));
+    QVERIFY(buffer.cacheKey() != editedKey);
+}
+
+void TestImageBuffer::testNullBuffer()
+{
+    ImageBuffer buffer;
+    QVERIFY(buffer.isNull());
+    QVERIFY(buffer.image().isNull());
+    QCOMPARE(buffer.cacheKey(), qint64(0));
+    QVERIFY(!buffer.isSharedWith(ImageBuffer()));
+
+    QVERIFY(ImageBuffer(QImage()).isNull());
+
+    // 空缓冲区的可写图像为空图，可以整体赋值
+    buffer.mutableImage() = makeImage(8, 8);
+    QVERIFY(!buffer.isNull());
+    QCOMPARE(buffer.size(), QSize(8, 8));
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_IMAGEBUFFER_H
+#define TEST_IMAGEBUFFER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/imagebuffer.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ImageBuffer 单元测试
+ *
+ * 测试程序使用 QCoreApplication，不能创建 QPixmap，这里只覆盖 CPU 端的共享与分离。
+ */
+class TestImageBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 4; }
+
+private slots:
+    void testCopiesShareData();
+    void testMutationDetaches();
+    void testMutationWithoutSharing();
+    void testNullBuffer();
+};
+
+#endif // TEST_IMAGEBUFFER_H
@@ -0,0 +1,177 @@
+/**
+ * @file test_imageenhancer.cpp
+ * @brief ImageEnhancer 单元测试实现
+ */
+
+#include "test_imageenhancer.h"
+#include <QRandomGenerator>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+QImage makeColorful(int width, int height)
+{
+    QRandomGenerator rng(11);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int r = 128 + static_cast<int>(100 * qSin(x * 0.11)) + rng.bounded(21) - 10;
+            const int g = (x * 7 + y * 3) % 256;
+            const int b = ((x / 9 + y / 5) % 2) ? 230 : 20;
+            line[x] = qRgba(qBound(0, r, 255), g, b, 100 + (x + y) % 156);
+        }
+    }
+    return image;
+}
+
+template <typename Function>
+QImage mapChannels(const QImage &image, Function function)
+{
+    QImage result(image.size(), QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb p = image.pixel(x, y);
+            const int r = qBound(0, function(qRed(p), qRed(p), qGreen(p), qBlue(p)), 255);
+            const int g = qBound(0, function(qGreen(p), qRed(p), qGreen(p), qBlue(p)), 255);
+            const int b = qBound(0, function(qBlue(p), qRed(p), qGreen(p), qBlue(p)), 255);
+            result.setPixel(x, y, qRgba(r, g, b, qAlpha(p)));
+        }
+    }
+    return result;
+}
+
+// 逐步执行的亮度、对比度、饱和度、锐化（每步生成一幅新图像）
+QImage referenceEnhance(const QImage &image, int brightness, int contrast, int saturation,
+                        int sharpness)
+{
+    QImage result = image.convertToFormat(QImage::Format_ARGB32);
+    if (brightness != 0) {
+        result = mapChannels(result, [&](int c, int, int, int) { return c + brightness; });
+    }
+    if (contrast != 0) {
+        const double factor = (259.0 * (contrast + 255)) / (255.0 * (259 - contrast));
+        result = mapChannels(result, [&](int c, int, int, int) {
+            return static_cast<int>(factor * (c - 128) + 128);
+        });
+    }
+    if (saturation != 0) {
+        const double s = 1.0 + saturation / 100.0;
+        result = mapChannels(result, [&](int c, int r, int g, int b) {
+            const double gray = 0.299 * r + 0.587 * g + 0.114 * b;
+            return static_cast<int>(gray + s * (c - gray));
+        });
+    }
+    if (sharpness > 0) {
+        const double f = sharpness / 100.0;
+        const QImage source = result;
+        auto at = [&](int x, int y, int shift) {
+            const QRgb p = source.pixel(qBound(0, x, source.width() - 1),
+                                        qBound(0, y, source.height() - 1));
+            return static_cast<int>((p >> shift) & 0xff);
+        };
+        for (int y = 0; y < source.height(); ++y) {
+            for (int x = 0; x < source.width(); ++x) {
+                QRgb value = source.pixel(x, y) & 0xff000000u;
+                for (int shift = 0; shift <= 16; shift += 8) {
+                    const double v = (1 + 4 * f) * at(x, y, shift)
+                                     - f * (at(x - 1, y, shift) + at(x + 1, y, shift)
+                                            + at(x, y - 1, shift) + at(x, y + 1, shift));
+                    value |= static_cast<QRgb>(qBound(0, static_cast<int>(std::lrint(v)), 255)) << shift;
+                }
+                result.setPixel(x, y, value);
+            }
+        }
+    }
+    return result;
+}
+
+int maxDifference(const QImage &a, const QImage &b)
+{
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uchar *la = a.constScanLine(y);
+        const uchar *lb = b.constScanLine(y);
+        for (int i = 0; i < a.width() * 4; ++i) {
+            diff = qMax(diff, qAbs(la[i] - lb[i]));
+        }
+    }
+    return diff;
+}
+
+} // namespace
+
+void TestImageEnhancer::testMatchesSequentialSteps()
+{
+    // 宽度不是 4 的倍数，高度跨越多个行带
+    const QImage image = makeColorful(67, 150);
+
+    const int parameters[][4] = {
+        {30, 0, 0, 0},  {0, 60, 0, 0},   {0, 0, 50, 0},    {0, 0, 0, 40},
+        {-40, -50, -80, 0}, {20, 40, 30, 25}, {-10, 80, 100, 100}, {0, 0, -100, 7},
+    };
+    for (const auto &p : parameters) {
+        const QImage fused = ImageEnhancer::apply(image, p[0], p[1], p[2], p[3]);
+        QCOMPARE(fused.format(), QImage::Format_ARGB32);
+        QVERIFY2(maxDifference(fused, referenceEnhance(image, p[0], p[1], p[2], p[3])) <= 1,
+                 qPrintable(QString("%1 %2 %3 %4").arg(p[0]).arg(p[1]).arg(p[2]).arg(p[3])));
+    }
+
+    // 单像素宽或高的图像
+    const QImage column = makeColorful(1, 9);
+    const QImage row = makeColorful(9, 1);
+    QVERIFY(maxDifference(ImageEnhancer::apply(column, 10, 20, 30, 50),
+                          referenceEnhance(column, 10, 20, 30, 50)) <= 1);
+    QVERIFY(maxDifference(ImageEnhancer::apply(row, 10, 20, 30, 50),
+                          referenceEnhance(row, 10, 20, 30, 50)) <= 1);
+}
+
+void TestImageEnhancer::testIdentityParameters()
+{
+    const QImage image = makeColorful(40, 30);
+    QCOMPARE(ImageEnhancer::apply(image, 0, 0, 0, 0), image);
+
+    // RGB32 输入直接读取，结果统一为 ARGB32
+    const QImage rgb = image.convertToFormat(QImage::Format_RGB32);
+    QCOMPARE(ImageEnhancer::apply(rgb, 0, 0, 0, 0), rgb.convertToFormat(QImage::Format_ARGB32));
+    QCOMPARE(ImageEnhancer::apply(rgb, 15, 0, 0, 30),
+             ImageEnhancer::apply(rgb.convertToFormat(QImage::Format_ARGB32), 15, 0, 0, 30));
+}
+
+void TestImageEnhancer::testGrayStaysGray()
+{
+    QImage image(256, 4, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixel(x, y, qRgba(x, x, x, 255));
+        }
+    }
+
+    // 灰色像素调整饱和度时不变，定点数舍入不应让它偏暗一级
+    for (int saturation : {-100, -37, 50, 100}) {
+        QCOMPARE(ImageEnhancer::apply(image, 0, 0, saturation, 0), image);
+    }
+}
+
+void TestImageEnhancer::testPreservesAlpha()
+{
+    QImage image = makeColorful(30, 20);
+    image.setPixel(5, 6, qRgba(200, 10, 90, 3));
+
+    const QImage result = ImageEnhancer::apply(image, 25, 40, 60, 80);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            QCOMPARE(qAlpha(result.pixel(x, y)), qAlpha(image.pixel(x, y)));
+        }
+    }
+}
+
+void TestImageEnhancer::benchmarkLargeImage()
+{
+    const QImage image = makeColorful(4000, 3000);
+
+    QBENCHMARK {
+        ImageEnhancer::apply(image, 20, 30, 40, 50);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef TEST_IMAGEENHANCER_H
+#define TEST_IMAGEENHANCER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/imageenhancer.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ImageEnhancer 单元测试
+ */
+class TestImageEnhancer : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void testMatchesSequentialSteps();
+    void testIdentityParameters();
+    void testGrayStaysGray();
+    void testPreservesAlpha();
+    void benchmarkLargeImage();
+};
+
+#endif // TEST_IMAGEENHANCER_H
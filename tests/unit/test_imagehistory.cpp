@@ -0,0 +1,233 @@
+/**
+ * @file test_imagehistory.cpp
+ * @brief ImageHistory / HistoryStore 单元测试实现
+ */
+
+#include "test_imagehistory.h"
+#include <QRandomGenerator>
+#include <QTransform>
+#include <functional>
+
+namespace {
+
+QImage makeImage(int width, int height)
+{
+    QRandomGenerator rng(31);
+    QImage image(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = qRgb(rng.bounded(256), rng.bounded(256), rng.bounded(256));
+        }
+    }
+    return image;
+}
+
+// 模拟局部编辑：把 rect 范围内的像素改为固定值
+QImage paint(QImage image, const QRect &rect, QRgb color)
+{
+    for (int y = rect.top(); y < rect.top() + rect.height(); ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = rect.left(); x < rect.left() + rect.width(); ++x) {
+            if (image.format() == QImage::Format_Grayscale8) {
+                line[x] = static_cast<uchar>(qGray(color));
+            } else {
+                reinterpret_cast<QRgb *>(line)[x] = color;
+            }
+        }
+    }
+    return image;
+}
+
+constexpr qint64 TILE_BYTES = qint64(ImageHistory::TILE_SIZE) * ImageHistory::TILE_SIZE * 4;
+
+} // namespace
+
+void TestImageHistory::testUndoRedoRoundTrip()
+{
+    const QVector<std::function<QImage(const QImage &)>> edits = {
+        [](const QImage &image) { return paint(image, QRect(10, 10, 50, 50), 0xff123456); },
+        [](const QImage &image) { return paint(image, QRect(200, 300, 400, 100), 0xffabcdef); },
+        [](const QImage &image) { return image.transformed(QTransform().rotate(90)); },
+        [](const QImage &image) { return image.convertToFormat(QImage::Format_Grayscale8); },
+        [](const QImage &image) { return paint(image, QRect(0, 0, 530, 20), 0xff808080); },
+    };
+
+    ImageHistory history;
+    QImage image = makeImage(700, 530);
+    QVector<QImage> states;
+    for (const auto &edit : edits) {
+        history.push(image);
+        states.append(image);
+        image = edit(image);
+    }
+    states.append(image);
+    QCOMPARE(history.undoCount(), edits.size());
+    QVERIFY(!history.canRedo());
+
+    // 逐步撤销到最初状态，包括尺寸和格式变化的步骤
+    for (int i = edits.size() - 1; i >= 0; --i) {
+        QVERIFY(history.undo(image));
+        QCOMPARE(image, states[i]);
+    }
+    QVERIFY(!history.undo(image));
+    QCOMPARE(history.redoCount(), edits.size());
+
+    for (int i = 1; i <= edits.size(); ++i) {
+        QVERIFY(history.redo(image));
+        QCOMPARE(image, states[i]);
+    }
+    QVERIFY(!history.redo(image));
+    QCOMPARE(history.undoCount(), edits.size());
+
+    // 重做后再撤销仍然可用
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, states[edits.size() - 1]);
+
+    // 放弃重做只影响重做历史
+    history.discardRedo();
+    QVERIFY(!history.canRedo());
+    QVERIFY(!history.redo(image));
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, states[edits.size() - 2]);
+}
+
+void TestImageHistory::testStoresOnlyChangedTiles()
+{
+    ImageHistory history;
+    QImage image = makeImage(1024, 1024);
+    const QImage original = image;
+
+    history.push(image);
+    image = paint(image, QRect(300, 300, 10, 10), 0xff000000);
+    const QImage first = image;
+    history.push(image);
+    QCOMPARE(history.storedBytes(), TILE_BYTES);
+
+    // 跨越块边界的修改保存两个块
+    image = paint(image, QRect(250, 10, 10, 10), 0xffffffff);
+    history.push(image);
+    QCOMPARE(history.storedBytes(), 3 * TILE_BYTES);
+
+    // 没有改动的一步不保存像素
+    history.push(image);
+    QCOMPARE(history.storedBytes(), 3 * TILE_BYTES);
+    QCOMPARE(history.undoCount(), 4);
+
+    QVERIFY(history.undo(image));
+    QVERIFY(history.undo(image));
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, first);
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, original);
+}
+
+void TestImageHistory::testUnrecordedChange()
+{
+    ImageHistory history;
+    const QImage a = makeImage(600, 400);
+    QImage image = a;
+
+    history.push(image);
+    image = paint(image, QRect(0, 0, 100, 100), 0xff112233);
+    const QImage b = image;
+    history.push(image);
+    image = paint(image, QRect(300, 200, 100, 100), 0xff445566);
+
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, b);
+
+    // 撤销后直接修改图像：撤销先回到修改前，而不是把块写到修改后的图像上
+    image = paint(image, QRect(500, 300, 50, 50), 0xff778899);
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, b);
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, a);
+
+    // 重做记录不再适用时放弃重做，修改本身成为可撤销的一步
+    image = paint(image, QRect(10, 300, 20, 20), 0xff000000);
+    const QImage e = image;
+    QVERIFY(!history.redo(image));
+    QCOMPARE(image, e);
+    QVERIFY(!history.canRedo());
+    QVERIFY(history.undo(image));
+    QCOMPARE(image, a);
+    QVERIFY(history.redo(image));
+    QCOMPARE(image, e);
+}
+
+void TestImageHistory::testMaxSteps()
+{
+    ImageHistory history;
+    history.setMaxSteps(3);
+
+    QImage image = makeImage(300, 300);
+    QVector<QImage> states;
+    for (int i = 0; i < 5; ++i) {
+        history.push(image);
+        states.append(image);
+        image = paint(image, QRect(i * 50, i * 50, 40, 40), 0xff000000 | quint32(i * 40));
+    }
+    QCOMPARE(history.undoCount(), 3);
+
+    for (int i = 4; i >= 2; --i) {
+        QVERIFY(history.undo(image));
+        QCOMPARE(image, states[i]);
+    }
+    QVERIFY(!history.undo(image));
+    QCOMPARE(image, states[2]);
+}
+
+void TestImageHistory::testMemoryBudgetSpillsToDisk()
+{
+    HistoryStore &store = HistoryStore::instance();
+    const qint64 previousBudget = store.memoryBudget();
+    store.setMemoryBudget(0);
+
+    {
+        ImageHistory history;
+        QImage image = makeImage(1024, 1024);
+        QVector<QImage> states;
+        for (int i = 0; i < 12; ++i) {
+            history.push(image);
+            states.append(image);
+            const int tile = i % 16;
+            image = paint(image, QRect((tile % 4) * 256 + 8, (tile / 4) * 256 + 8, 64, 64), 0xff000000);
+        }
+        history.push(image);
+        states.append(image);
+        store.waitForIdle();
+
+        // 最近的记录保留在内存中，更旧的写入交换文件
+        QVERIFY(store.diskUsage() > 0);
+        QVERIFY(store.memoryUsage() <= HistoryStore::HOT_BLOCKS * TILE_BYTES);
+
+        for (int i = states.size() - 1; i >= 0; --i) {
+            QVERIFY(history.undo(image));
+            QCOMPARE(image, states[i]);
+        }
+        store.waitForIdle();
+    }
+
+    // 撤销历史释放后交换文件清空
+    store.waitForIdle();
+    QCOMPARE(store.diskUsage(), qint64(0));
+    store.setMemoryBudget(previousBudget);
+}
+
+void TestImageHistory::benchmarkLocalEditUndo()
+{
+    ImageHistory history;
+    QImage image = makeImage(6000, 4000);
+    history.push(image);
+    image = paint(image, QRect(1000, 1000, 512, 512), 0xff204080);
+    history.push(image);
+
+    // 局部修改只保存覆盖它的几个块，而不是整幅图像
+    QVERIFY(history.storedBytes() <= 9 * TILE_BYTES);
+
+    QBENCHMARK {
+        history.undo(image);
+        history.redo(image);
+    }
+}
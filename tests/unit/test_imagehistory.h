@@ -0,0 +1,29 @@
+#ifndef TEST_IMAGEHISTORY_H
+#define TEST_IMAGEHISTORY_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/imagehistory.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ImageHistory / HistoryStore 单元测试
+ */
+class TestImageHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 6; }
+
+private slots:
+    void testUndoRedoRoundTrip();
+    void testStoresOnlyChangedTiles();
+    void testUnrecordedChange();
+    void testMaxSteps();
+    void testMemoryBudgetSpillsToDisk();
+    void benchmarkLocalEditUndo();
+};
+
+#endif // TEST_IMAGEHISTORY_H
@@ -0,0 +1,123 @@
+/**
+ * @file test_imageloader.cpp
+ * @brief ImageLoader 单元测试实现
+ */
+
+#include "test_imageloader.h"
+#include <QTemporaryDir>
+
+namespace {
+
+QImage makeImage(int width, int height)
+{
+    // 平滑渐变，JPEG 压缩后仍接近原图
+    QImage image(width, height, QImage::Format_RGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = qRgb(x * 255 / width, y * 255 / height, 128);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+void TestImageLoader::testScaledJpegPreview()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("photo.jpg");
+    if (!makeImage(3000, 2000).save(path, "JPEG", 90)) {
+        QSKIP("JPEG 插件不可用");
+    }
+
+    QSize size;
+    QVERIFY(ImageLoader::canLoad(path, &size));
+    QCOMPARE(size, QSize(3000, 2000));
+
+    const ImageLoadResult preview = ImageLoader::loadPreview(path, 500);
+    QVERIFY(preview.success);
+    QCOMPARE(preview.imageSize, QSize(3000, 2000));
+    QVERIFY(!preview.image.isNull());
+    QVERIFY(preview.image.width() <= 500 && preview.image.height() <= 500);
+    QVERIFY(preview.image.width() >= 400);
+}
+
+void TestImageLoader::testNoPreviewWhenNotCheaper()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // PNG 只能整幅解码，预览不会比原图更快
+    const QString png = dir.filePath("large.png");
+    QVERIFY(makeImage(1500, 600).save(png));
+    const ImageLoadResult pngPreview = ImageLoader::loadPreview(png, 500);
+    QVERIFY(pngPreview.success);
+    QVERIFY(pngPreview.image.isNull());
+    QCOMPARE(pngPreview.imageSize, QSize(1500, 600));
+
+    // 原图不超过预览尺寸
+    const QString small = dir.filePath("small.png");
+    QVERIFY(makeImage(300, 200).save(small));
+    const ImageLoadResult smallPreview = ImageLoader::loadPreview(small, 500);
+    QVERIFY(smallPreview.success);
+    QVERIFY(smallPreview.image.isNull());
+}
+
+void TestImageLoader::testLoadFullImage()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("image.png");
+    const QImage image = makeImage(640, 480);
+    QVERIFY(image.save(path));
+
+    const ImageLoadResult result = ImageLoader::load(path);
+    QVERIFY(result.success);
+    QVERIFY(!result.cancelled);
+    QVERIFY(!result.tiles);
+    QCOMPARE(result.imageSize, image.size());
+    QCOMPARE(result.image.convertToFormat(image.format()), image);
+
+    const QString missing = dir.filePath("missing.png");
+    QString errorMsg;
+    QVERIFY(!ImageLoader::canLoad(missing, nullptr, &errorMsg));
+    QVERIFY(!errorMsg.isEmpty());
+    const ImageLoadResult failed = ImageLoader::load(missing);
+    QVERIFY(!failed.success);
+    QVERIFY(!failed.cancelled);
+    QVERIFY(!failed.message.isEmpty());
+}
+
+void TestImageLoader::testCancel()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("image.png");
+    QVERIFY(makeImage(2000, 1500).save(path));
+
+    // 已取消的解码在第一次读文件时中止
+    auto cancel = std::make_shared<std::atomic<bool>>(true);
+    const ImageLoadResult result = ImageLoader::load(path, cancel);
+    QVERIFY(!result.success);
+    QVERIFY(result.cancelled);
+    QVERIFY(result.image.isNull());
+
+    *cancel = false;
+    QVERIFY(ImageLoader::load(path, cancel).success);
+}
+
+void TestImageLoader::testAsyncMatchesSync()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("image.png");
+    QVERIFY(makeImage(800, 600).save(path));
+
+    QFuture<ImageLoadResult> future = ImageLoader::loadAsync(path);
+    future.waitForFinished();
+    const ImageLoadResult result = future.result();
+    QVERIFY(result.success);
+    QCOMPARE(result.image, ImageLoader::load(path).image);
+}
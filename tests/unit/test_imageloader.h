@@ -0,0 +1,28 @@
+#ifndef TEST_IMAGELOADER_H
+#define TEST_IMAGELOADER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/imageloader.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ImageLoader 单元测试
+ */
+class TestImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void testScaledJpegPreview();
+    void testNoPreviewWhenNotCheaper();
+    void testLoadFullImage();
+    void testCancel();
+    void testAsyncMatchesSync();
+};
+
+#endif // TEST_IMAGELOADER_H
@@ -0,0 +1,155 @@
+/**
+ * @file test_imageprocessservice.cpp
+ * @brief ImageProcessService 预览与分段处理单元测试实现
+ */
+
+#include "test_imageprocessservice.h"
+#include <QRandomGenerator>
+
+namespace {
+
+// 渐变叠加噪声，边缘检测和去噪都有非平凡的结果
+QImage makeImage(int width, int height)
+{
+    QRandomGenerator rng(41);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int noise = static_cast<int>(rng.bounded(48));
+            line[x] = qRgba((x * 2 + noise) & 0xff, (y * 3 + noise) & 0xff,
+                            ((x ^ y) + noise) & 0xff, 255);
+        }
+    }
+    return image;
+}
+
+ProcessRequest enhanceRequest()
+{
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::Enhance;
+    request.brightness = 20;
+    request.contrast = 40;
+    request.saturation = -30;
+    request.sharpness = 60;
+    return request;
+}
+
+ProcessRequest denoiseRequest(ImageProcessService::DenoiseMethod method, int kernelSize)
+{
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::Denoise;
+    request.method = static_cast<int>(method);
+    request.kernelSize = kernelSize;
+    request.sigma = 2.0;
+    return request;
+}
+
+ProcessRequest edgeRequest(ImageProcessService::EdgeMethod method)
+{
+    ProcessRequest request;
+    request.type = ProcessRequest::Type::EdgeDetection;
+    request.method = static_cast<int>(method);
+    return request;
+}
+
+} // namespace
+
+void TestImageProcessService::testStripsMatchWholeImage()
+{
+    // 高度足以分为多段，且不是段高的整数倍
+    const QImage image = makeImage(53, 301);
+
+    const QVector<ProcessRequest> requests = {
+        enhanceRequest(),
+        denoiseRequest(ImageProcessService::DenoiseMethod::Gaussian, 7),
+        denoiseRequest(ImageProcessService::DenoiseMethod::Bilateral, 3),
+        denoiseRequest(ImageProcessService::DenoiseMethod::Median, 5),
+        denoiseRequest(ImageProcessService::DenoiseMethod::NLM, 3),
+        edgeRequest(ImageProcessService::EdgeMethod::Sobel),
+        edgeRequest(ImageProcessService::EdgeMethod::Laplacian),
+        edgeRequest(ImageProcessService::EdgeMethod::Canny),
+    };
+
+    for (const ProcessRequest &request : requests) {
+        QVector<int> progress;
+        const QImage strips = ImageProcessService::processInStrips(
+            image, request, [&progress](int percent) { progress.append(percent); });
+        const QImage whole = ImageProcessService::process(image, request);
+
+        QCOMPARE(strips.format(), whole.format());
+        QCOMPARE(strips, whole);
+
+        // 进度单调递增并以 100 结束，局部运算分多段报告
+        QVERIFY(!progress.isEmpty());
+        QCOMPARE(progress.last(), 100);
+        for (int i = 1; i < progress.size(); ++i) {
+            QVERIFY(progress[i] > progress[i - 1]);
+        }
+        QCOMPARE(progress.size() > 1, ImageProcessService::haloFor(request) >= 0);
+    }
+}
+
+void TestImageProcessService::testHalo()
+{
+    QCOMPARE(ImageProcessService::haloFor(enhanceRequest()), 1);
+    ProcessRequest pointOnly = enhanceRequest();
+    pointOnly.sharpness = 0;
+    QCOMPARE(ImageProcessService::haloFor(pointOnly), 0);
+
+    QCOMPARE(ImageProcessService::haloFor(
+                 denoiseRequest(ImageProcessService::DenoiseMethod::Median, 9)), 4);
+    QCOMPARE(ImageProcessService::haloFor(edgeRequest(ImageProcessService::EdgeMethod::Sobel)), 1);
+
+    // 滞后阈值和双边网格不是局部运算
+    QCOMPARE(ImageProcessService::haloFor(edgeRequest(ImageProcessService::EdgeMethod::Canny)), -1);
+    QCOMPARE(ImageProcessService::haloFor(
+                 denoiseRequest(ImageProcessService::DenoiseMethod::Bilateral, 15)), -1);
+
+    // 模糊半径随卷积核增大
+    QVERIFY(ImageProcessService::haloFor(denoiseRequest(ImageProcessService::DenoiseMethod::Gaussian, 15))
+            > ImageProcessService::haloFor(denoiseRequest(ImageProcessService::DenoiseMethod::Gaussian, 3)));
+}
+
+void TestImageProcessService::testPreviewUsesPyramidLevel()
+{
+    ImageProcessService service;
+    const QImage image = makeImage(400, 300);
+    const ProcessRequest request = denoiseRequest(ImageProcessService::DenoiseMethod::Gaussian, 9);
+
+    // 显示比例不低于 1 时按原图处理
+    const ProcessResult full = service.preview(image, request, 1.0);
+    QVERIFY(full.success);
+    QCOMPARE(full.scale, 1.0);
+    QCOMPARE(full.processedImage, ImageProcessService::process(image, request));
+
+    // 缩小显示时选择分辨率不低于显示比例的层
+    const ProcessResult half = service.preview(image, request, 0.3);
+    QVERIFY(half.success);
+    QCOMPARE(half.scale, 0.5);
+    QCOMPARE(half.processedImage.size(), QSize(200, 150));
+
+    const ProcessResult quarter = service.preview(image, enhanceRequest(), 0.25);
+    QCOMPARE(quarter.scale, 0.25);
+    QCOMPARE(quarter.processedImage.size(), QSize(100, 75));
+
+    // 换图后重新建立金字塔
+    const QImage other = makeImage(64, 64);
+    const ProcessResult small = service.preview(other, request, 0.5);
+    QCOMPARE(small.processedImage.size(), QSize(32, 32));
+
+    QVERIFY(!service.preview(QImage(), request, 0.5).success);
+}
+
+void TestImageProcessService::benchmarkPreview()
+{
+    ImageProcessService service;
+    const QImage image = makeImage(6000, 4000);
+    const ProcessRequest request = denoiseRequest(ImageProcessService::DenoiseMethod::Gaussian, 9);
+    service.preview(image, request, 0.15);
+
+    // 拖动滑块时的单次预览：金字塔已建立，只处理缩小层
+    QBENCHMARK {
+        service.preview(image, request, 0.15);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef TEST_IMAGEPROCESSSERVICE_H
+#define TEST_IMAGEPROCESSSERVICE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/imageprocessservice.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief ImageProcessService 预览与分段处理单元测试
+ */
+class TestImageProcessService : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 4; }
+
+private slots:
+    void testStripsMatchWholeImage();
+    void testHalo();
+    void testPreviewUsesPyramidLevel();
+    void benchmarkPreview();
+};
+
+#endif // TEST_IMAGEPROCESSSERVICE_H
@@ -0,0 +1,141 @@
+/**
+ * @file test_inferenceresultcache.cpp
+ * @brief InferenceResultCache 单元测试实现
+ */
+
+#include "test_inferenceresultcache.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+namespace {
+
+QJsonObject makeResult(int count)
+{
+    QJsonArray detections;
+    for (int i = 0; i < count; ++i) {
+        detections.append(QJsonObject{{"x", i}, {"y", i}, {"width", 10}, {"height", 10},
+                                      {"confidence", 0.5}, {"class_id", 0}, {"label", "person"}});
+    }
+    return QJsonObject{{"success", true}, {"data", QJsonObject{{"detections", detections}}}};
+}
+
+} // namespace
+
+void TestInferenceResultCache::testLookupAfterInsert()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    InferenceResultCache cache(dir.path());
+
+    QImage image(64, 48, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    const QString key = InferenceResultCache::makeKey(cache.imageHash(image), "model.pt", "detect",
+                                                      QJsonObject{{"conf_threshold", 0.25}});
+
+    QJsonObject value;
+    QVERIFY(!cache.lookup(key, value));
+
+    cache.insert(key, makeResult(3));
+    QVERIFY(cache.lookup(key, value));
+    QCOMPARE(value["data"].toObject()["detections"].toArray().size(), 3);
+    QCOMPARE(cache.entryCount(), 1);
+}
+
+void TestInferenceResultCache::testKeyDependsOnParameters()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    InferenceResultCache cache(dir.path());
+
+    QImage image(32, 32, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+    const QString hash = cache.imageHash(image);
+
+    // 像素相同的另一份图像得到相同哈希，像素不同则哈希不同
+    QImage copy = image.copy();
+    QCOMPARE(cache.imageHash(copy), hash);
+    copy.setPixel(0, 0, qRgb(0, 0, 0));
+    QVERIFY(cache.imageHash(copy) != hash);
+
+    const QString base = InferenceResultCache::makeKey(hash, "model.pt", "detect",
+                                                       QJsonObject{{"conf_threshold", 0.25}});
+    QCOMPARE(InferenceResultCache::makeKey(hash, "model.pt", "detect",
+                                           QJsonObject{{"conf_threshold", 0.25}}), base);
+    QVERIFY(InferenceResultCache::makeKey(hash, "model.pt", "detect",
+                                          QJsonObject{{"conf_threshold", 0.5}}) != base);
+    QVERIFY(InferenceResultCache::makeKey(hash, "model.pt", "segment",
+                                          QJsonObject{{"conf_threshold", 0.25}}) != base);
+    QVERIFY(InferenceResultCache::makeKey(hash, "other.pt", "detect",
+                                          QJsonObject{{"conf_threshold", 0.25}}) != base);
+}
+
+void TestInferenceResultCache::testPersistence()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString key = InferenceResultCache::makeKey("abc", "model.pt", "detect", QJsonObject());
+
+    {
+        InferenceResultCache cache(dir.path());
+        cache.insert(key, makeResult(2));
+    }
+
+    InferenceResultCache reopened(dir.path());
+    QCOMPARE(reopened.entryCount(), 1);
+    QJsonObject value;
+    QVERIFY(reopened.lookup(key, value));
+    QCOMPARE(value["data"].toObject()["detections"].toArray().size(), 2);
+}
+
+void TestInferenceResultCache::testEviction()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QJsonObject result = makeResult(20);
+    const qint64 entrySize = QJsonDocument(result).toJson(QJsonDocument::Compact).size();
+    InferenceResultCache cache(dir.path(), entrySize * 3);
+
+    QStringList keys;
+    for (int i = 0; i < 5; ++i) {
+        keys.append(InferenceResultCache::makeKey(QString::number(i), "model.pt", "detect", QJsonObject()));
+        cache.insert(keys.last(), result);
+        QTest::qWait(2);  // 保证访问时间有先后
+    }
+
+    QVERIFY(cache.diskUsage() <= cache.maxDiskBytes());
+    QJsonObject value;
+    QVERIFY(!cache.lookup(keys.first(), value));
+    QVERIFY(cache.lookup(keys.last(), value));
+}
+
+void TestInferenceResultCache::testHashMemo()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    InferenceResultCache cache(dir.path());
+
+    QImage image(40, 30, QImage::Format_RGB32);
+    image.fill(Qt::green);
+    const QString memoKey = InferenceResultCache::hashMemoKey(image);
+    QVERIFY(!memoKey.isEmpty());
+    QVERIFY(cache.knownHash(memoKey).isEmpty());
+
+    // 工作线程算出的哈希与同步计算一致，记住后不再读取像素
+    const QString computed = InferenceResultCache::computeImageHash(image);
+    cache.rememberHash(memoKey, computed);
+    QCOMPARE(cache.knownHash(memoKey), computed);
+    QCOMPARE(cache.imageHash(image), computed);
+
+    // 像素修改后记忆表的键随之改变
+    image.setPixel(0, 0, qRgb(0, 0, 0));
+    QVERIFY(InferenceResultCache::hashMemoKey(image) != memoKey);
+    QVERIFY(cache.knownHash(InferenceResultCache::hashMemoKey(image)).isEmpty());
+
+    const QString filePath = dir.filePath("image.png");
+    QVERIFY(image.save(filePath));
+    QCOMPARE(cache.fileHash(filePath), InferenceResultCache::computeFileHash(filePath));
+    QVERIFY(!cache.knownHash(InferenceResultCache::hashMemoKey(filePath)).isEmpty());
+    QVERIFY(InferenceResultCache::hashMemoKey(dir.filePath("missing.png")).isEmpty());
+}
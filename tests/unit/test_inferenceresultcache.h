@@ -0,0 +1,28 @@
+#ifndef TEST_INFERENCERESULTCACHE_H
+#define TEST_INFERENCERESULTCACHE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/inference/inferenceresultcache.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief InferenceResultCache 单元测试
+ */
+class TestInferenceResultCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 5; }
+
+private slots:
+    void testLookupAfterInsert();
+    void testKeyDependsOnParameters();
+    void testPersistence();
+    void testEviction();
+    void testHashMemo();
+};
+
+#endif // TEST_INFERENCERESULTCACHE_H
@@ -0,0 +1,108 @@
+/**
+ * @file test_medianfilter.cpp
+ * @brief MedianFilter 单元测试实现
+ */
+
+#include "test_medianfilter.h"
+#include <QRandomGenerator>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// 逐像素排序的朴素实现，作为对照
+QImage referenceMedian(const QImage &image, int kernelSize)
+{
+    const int channels = image.format() == QImage::Format_Grayscale8 ? 1 : 4;
+    const int half = kernelSize / 2;
+    QImage result = image.copy();
+    std::vector<int> values;
+
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            for (int c = 0; c < (channels == 1 ? 1 : 3); ++c) {
+                values.clear();
+                for (int ky = -half; ky <= half; ++ky) {
+                    const int sy = qBound(0, y + ky, image.height() - 1);
+                    for (int kx = -half; kx <= half; ++kx) {
+                        const int sx = qBound(0, x + kx, image.width() - 1);
+                        values.push_back(image.constScanLine(sy)[sx * channels + c]);
+                    }
+                }
+                std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+                result.scanLine(y)[x * channels + c] = static_cast<uchar>(values[values.size() / 2]);
+            }
+        }
+    }
+    return result;
+}
+
+QImage makeNoisyGradient(int width, int height, QImage::Format format)
+{
+    QRandomGenerator rng(11);
+    QImage image(width, height, format);
+    const int channels = format == QImage::Format_Grayscale8 ? 1 : 4;
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        for (int i = 0; i < width * channels; ++i) {
+            line[i] = rng.bounded(4) == 0 ? static_cast<uchar>(rng.bounded(256))
+                                          : static_cast<uchar>((i / channels) * 255 / width);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+void TestMedianFilter::testMatchesSortedReference()
+{
+    // 宽度超过一个列条带，覆盖条带边界
+    const QImage rgb = makeNoisyGradient(300, 12, QImage::Format_ARGB32);
+    const QImage gray = makeNoisyGradient(300, 12, QImage::Format_Grayscale8);
+
+    const int sizes[] = {3, 7, 15};
+    for (int size : sizes) {
+        QCOMPARE(MedianFilter::apply(rgb, size), referenceMedian(rgb, size));
+        QCOMPARE(MedianFilter::apply(gray, size), referenceMedian(gray, size));
+    }
+
+    // 偶数窗口按加一处理
+    QCOMPARE(MedianFilter::apply(gray, 4), referenceMedian(gray, 5));
+}
+
+void TestMedianFilter::testRemovesImpulseNoise()
+{
+    QImage image(32, 32, QImage::Format_Grayscale8);
+    image.fill(80);
+    image.scanLine(10)[10] = 255;
+    image.scanLine(20)[5] = 0;
+
+    const QImage filtered = MedianFilter::apply(image, 3);
+    for (int y = 0; y < filtered.height(); ++y) {
+        const uchar *line = filtered.constScanLine(y);
+        for (int x = 0; x < filtered.width(); ++x) {
+            QCOMPARE(int(line[x]), 80);
+        }
+    }
+}
+
+void TestMedianFilter::testPreservesAlpha()
+{
+    QImage image(20, 20, QImage::Format_ARGB32);
+    image.fill(qRgba(10, 20, 30, 128));
+    image.setPixel(5, 5, qRgba(250, 250, 250, 7));
+
+    const QImage filtered = MedianFilter::apply(image, 5);
+    QCOMPARE(filtered.pixel(5, 5), qRgba(10, 20, 30, 7));
+    QCOMPARE(filtered.pixel(0, 0), qRgba(10, 20, 30, 128));
+}
+
+void TestMedianFilter::benchmarkLargeKernel()
+{
+    const QImage image = makeNoisyGradient(2000, 1500, QImage::Format_ARGB32);
+
+    // 代价与窗口大小无关
+    QBENCHMARK {
+        MedianFilter::apply(image, 31);
+    }
+}
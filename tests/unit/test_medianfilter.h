@@ -0,0 +1,27 @@
+#ifndef TEST_MEDIANFILTER_H
+#define TEST_MEDIANFILTER_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/medianfilter.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief MedianFilter 单元测试
+ */
+class TestMedianFilter : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 4; }
+
+private slots:
+    void testMatchesSortedReference();
+    void testRemovesImpulseNoise();
+    void testPreservesAlpha();
+    void benchmarkLargeKernel();
+};
+
+#endif // TEST_MEDIANFILTER_H
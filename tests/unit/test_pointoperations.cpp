@@ -0,0 +1,175 @@
+/**
+ * @file test_pointoperations.cpp
+ * @brief PointOperations 单元测试实现
+ */
+
+#include "test_pointoperations.h"
+#include <QRandomGenerator>
+#include <cmath>
+
+namespace {
+
+QImage makeNoise(int width, int height, QImage::Format format)
+{
+    QRandomGenerator rng(17);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            line[x] = rng.generate();
+        }
+    }
+    // 覆盖各通道的极值
+    image.setPixel(0, 0, qRgba(255, 255, 255, 255));
+    image.setPixel(width - 1, height - 1, qRgba(0, 0, 0, 0));
+    return image.convertToFormat(format);
+}
+
+} // namespace
+
+void TestPointOperations::testGrayscaleMatchesQGray()
+{
+    // 宽度覆盖 SIMD 块内、块边界和带尾部的情况，高度跨越多个行带
+    for (int width : {1, 3, 15, 16, 17, 33, 67}) {
+        const QImage image = makeNoise(width, 40, QImage::Format_ARGB32);
+
+        const QImage gray8 = PointOperations::toGray8(image);
+        const QImage gray32 = PointOperations::grayscale(image);
+        QCOMPARE(gray8.format(), QImage::Format_Grayscale8);
+        QCOMPARE(gray32.format(), QImage::Format_ARGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < width; ++x) {
+                const QRgb p = image.pixel(x, y);
+                const int gray = qGray(p);
+                QCOMPARE(static_cast<int>(gray8.constScanLine(y)[x]), gray);
+                QCOMPARE(gray32.pixel(x, y), qRgba(gray, gray, gray, qAlpha(p)));
+            }
+        }
+    }
+
+    // RGB32 保持格式，灰度图输入原样返回
+    const QImage rgb = makeNoise(21, 5, QImage::Format_RGB32);
+    QCOMPARE(PointOperations::grayscale(rgb).format(), QImage::Format_RGB32);
+    const QImage gray = PointOperations::toGray8(rgb);
+    QCOMPARE(PointOperations::toGray8(gray), gray);
+}
+
+void TestPointOperations::testThresholdMatchesReference()
+{
+    const QImage color = makeNoise(37, 45, QImage::Format_ARGB32);
+    const QImage gray = PointOperations::toGray8(color);
+
+    for (int threshold : {-5, 0, 1, 100, 128, 255, 256}) {
+        const QImage fromColor = PointOperations::threshold(color, threshold);
+        const QImage fromGray = PointOperations::threshold(gray, threshold);
+        QImage inPlace = gray.copy();
+        PointOperations::thresholdInPlace(inPlace, threshold);
+
+        QCOMPARE(fromColor.format(), QImage::Format_Grayscale8);
+        for (int y = 0; y < color.height(); ++y) {
+            for (int x = 0; x < color.width(); ++x) {
+                const int expected = qGray(color.pixel(x, y)) >= threshold ? 255 : 0;
+                QCOMPARE(static_cast<int>(fromColor.constScanLine(y)[x]), expected);
+            }
+        }
+        QCOMPARE(fromGray, fromColor);
+        QCOMPARE(inPlace, fromColor);
+    }
+}
+
+void TestPointOperations::testInvertMatchesInvertPixels()
+{
+    for (QImage::Format format : {QImage::Format_ARGB32, QImage::Format_RGB32,
+                                  QImage::Format_Grayscale8, QImage::Format_RGB888}) {
+        const QImage image = makeNoise(29, 33, format);
+        QImage expected = image.copy();
+        expected.invertPixels();
+
+        const QImage inverted = PointOperations::invert(image);
+        QCOMPARE(inverted, expected);
+
+        QImage inPlace = image.copy();
+        PointOperations::invertInPlace(inPlace);
+        QCOMPARE(inPlace, expected);
+        QCOMPARE(PointOperations::invert(inverted), image);
+    }
+}
+
+void TestPointOperations::testToneCurve()
+{
+    const PointOperations::ToneCurve identity = PointOperations::levelsCurve(0, 255);
+    for (int v = 0; v < 256; ++v) {
+        QCOMPARE(static_cast<int>(identity[v]), v);
+    }
+
+    const PointOperations::ToneCurve levels = PointOperations::levelsCurve(50, 200);
+    QCOMPARE(static_cast<int>(levels[0]), 0);
+    QCOMPARE(static_cast<int>(levels[50]), 0);
+    QCOMPARE(static_cast<int>(levels[125]), 128);
+    QCOMPARE(static_cast<int>(levels[200]), 255);
+    QCOMPARE(static_cast<int>(levels[255]), 255);
+    for (int v = 1; v < 256; ++v) {
+        QVERIFY(levels[v] >= levels[v - 1]);
+    }
+
+    // gamma 大于 1 时提亮中间调，端点不变
+    const PointOperations::ToneCurve brighter = PointOperations::levelsCurve(0, 255, 2.2);
+    QVERIFY(brighter[128] > 128);
+    QCOMPARE(static_cast<int>(brighter[0]), 0);
+    QCOMPARE(static_cast<int>(brighter[255]), 255);
+
+    const QImage color = makeNoise(23, 41, QImage::Format_ARGB32);
+    const QImage mapped = PointOperations::applyToneCurve(color, levels);
+    QImage inPlace = color.copy();
+    PointOperations::applyToneCurveInPlace(inPlace, levels);
+    QCOMPARE(inPlace, mapped);
+    for (int y = 0; y < color.height(); ++y) {
+        for (int x = 0; x < color.width(); ++x) {
+            const QRgb p = color.pixel(x, y);
+            QCOMPARE(mapped.pixel(x, y),
+                     qRgba(levels[qRed(p)], levels[qGreen(p)], levels[qBlue(p)], qAlpha(p)));
+        }
+    }
+
+    const QImage gray = PointOperations::toGray8(color);
+    const QImage mappedGray = PointOperations::applyToneCurve(gray, levels);
+    QCOMPARE(mappedGray.format(), QImage::Format_Grayscale8);
+    for (int y = 0; y < gray.height(); ++y) {
+        for (int x = 0; x < gray.width(); ++x) {
+            QCOMPARE(mappedGray.constScanLine(y)[x], levels[gray.constScanLine(y)[x]]);
+        }
+    }
+}
+
+void TestPointOperations::testInPlaceKeepsBuffer()
+{
+    QImage image = makeNoise(64, 48, QImage::Format_ARGB32);
+    const uchar *bits = image.constBits();
+
+    PointOperations::grayscaleInPlace(image);
+    PointOperations::invertInPlace(image);
+    PointOperations::applyToneCurveInPlace(image, PointOperations::levelsCurve(10, 240));
+    QCOMPARE(image.constBits(), bits);
+
+    QImage gray = PointOperations::toGray8(image);
+    const uchar *grayBits = gray.constBits();
+    PointOperations::thresholdInPlace(gray, 90);
+    QCOMPARE(gray.constBits(), grayBits);
+
+    // 共享的图像先分离，其他副本不受影响
+    const QImage shared = image;
+    PointOperations::invertInPlace(image);
+    QCOMPARE(PointOperations::invert(shared), image);
+}
+
+void TestPointOperations::benchmarkPointOperations()
+{
+    const QImage image = makeNoise(6000, 4000, QImage::Format_ARGB32);
+
+    QBENCHMARK {
+        QImage working = image.copy();
+        PointOperations::grayscaleInPlace(working);
+        PointOperations::invertInPlace(working);
+        PointOperations::threshold(working, 128);
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef TEST_POINTOPERATIONS_H
+#define TEST_POINTOPERATIONS_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/pointoperations.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief PointOperations 单元测试
+ */
+class TestPointOperations : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 6; }
+
+private slots:
+    void testGrayscaleMatchesQGray();
+    void testThresholdMatchesReference();
+    void testInvertMatchesInvertPixels();
+    void testToneCurve();
+    void testInPlaceKeepsBuffer();
+    void benchmarkPointOperations();
+};
+
+#endif // TEST_POINTOPERATIONS_H
@@ -0,0 +1,143 @@
+/**
+ * @file test_responseframe.cpp
+ * @brief DetectionFrameDecoder 单元测试实现
+ */
+
+#include "test_responseframe.h"
+#include <QJsonDocument>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+void appendU32(QByteArray &out, quint32 value)
+{
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(reinterpret_cast<const char *>(bytes), 4);
+}
+
+void appendF32(QByteArray &out, float value)
+{
+    quint32 bits;
+    std::memcpy(&bits, &value, 4);
+    appendU32(out, bits);
+}
+
+/**
+ * @brief 构造两张图像的帧：第一张 2 个检测（第二个带 3 个顶点），第二张无检测
+ */
+QByteArray buildFrame()
+{
+    QByteArray json = QJsonDocument(QJsonObject{
+        {"success", true},
+        {"message", "ok"},
+        {"request_id", 42},
+        {"labels", QJsonObject{{"0", "person"}, {"3", "car"}}}
+    }).toJson(QJsonDocument::Compact);
+    const int jsonLength = json.size();
+    while (json.size() % 4 != 0) {
+        json.append(' ');
+    }
+
+    QByteArray payload = json;
+    for (quint32 offset : {0u, 2u, 2u}) {
+        appendU32(payload, offset);
+    }
+    for (float value : {10.0f, 20.0f, 30.0f, 40.0f, 1.0f, 2.0f, 3.0f, 4.0f}) {
+        appendF32(payload, value);
+    }
+    appendF32(payload, 0.9f);
+    appendF32(payload, 0.5f);
+    appendU32(payload, 0);
+    appendU32(payload, 3);
+    for (quint32 offset : {0u, 0u, 3u}) {
+        appendU32(payload, offset);
+    }
+    for (float value : {1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f}) {
+        appendF32(payload, value);
+    }
+
+    QByteArray frame("GPCF");
+    frame.append(char(1)).append(char(0));  // 版本
+    frame.append(char(0)).append(char(0));  // 标志
+    appendU32(frame, static_cast<quint32>(jsonLength));
+    appendU32(frame, 2);   // 图像数
+    appendU32(frame, 2);   // 检测数
+    appendU32(frame, 3);   // 顶点数
+    appendU32(frame, static_cast<quint32>(payload.size()));
+    appendU32(frame, 0);
+    return frame + payload;
+}
+
+} // namespace
+
+void TestResponseFrame::testDecodeFrame()
+{
+    const QByteArray data = buildFrame() + "\n{\"next\":1}\n";
+    QVERIFY(DetectionFrameDecoder::isFrameStart(data));
+    QVERIFY(!DetectionFrameDecoder::isFrameStart(QByteArray("{\"success\":true}")));
+
+    DetectionFrame frame;
+    qint64 frameSize = 0;
+    QString errorMsg;
+    QCOMPARE(DetectionFrameDecoder::decode(data, frame, frameSize, errorMsg),
+             DetectionFrameDecoder::Status::Complete);
+    QCOMPARE(frameSize, static_cast<qint64>(buildFrame().size()));
+
+    QCOMPARE(frame.header["request_id"].toInt(), 42);
+    QCOMPARE(frame.header["labels"].toObject()["3"].toString(), QString("car"));
+    QCOMPARE(frame.imageCount(), 2);
+    QCOMPARE(frame.detectionCount(), 2);
+    QCOMPARE(frame.boxes[4], 1.0f);
+    QCOMPARE(frame.scores[0], 0.9f);
+    QCOMPARE(frame.classIds[1], 3);
+    QCOMPARE(frame.vertexOffsets[2], 3u);
+    QCOMPARE(frame.vertices[5], 6.5f);
+}
+
+void TestResponseFrame::testIncompleteFrame()
+{
+    const QByteArray data = buildFrame();
+    DetectionFrame frame;
+    qint64 frameSize = 0;
+    QString errorMsg;
+
+    // 帧头不完整
+    QCOMPARE(DetectionFrameDecoder::decode(data.left(20), frame, frameSize, errorMsg),
+             DetectionFrameDecoder::Status::Incomplete);
+
+    // 帧头完整但负载不完整时已知整帧长度
+    QCOMPARE(DetectionFrameDecoder::decode(data.left(data.size() - 1), frame, frameSize, errorMsg),
+             DetectionFrameDecoder::Status::Incomplete);
+    QCOMPARE(frameSize, static_cast<qint64>(data.size()));
+}
+
+void TestResponseFrame::testLengthMismatch()
+{
+    QByteArray data = buildFrame();
+    // 声明的检测数与负载长度不一致
+    data[16] = char(5);
+
+    DetectionFrame frame;
+    qint64 frameSize = 0;
+    QString errorMsg;
+    QCOMPARE(DetectionFrameDecoder::decode(data, frame, frameSize, errorMsg),
+             DetectionFrameDecoder::Status::Invalid);
+    QVERIFY(!errorMsg.isEmpty());
+}
+
+void TestResponseFrame::testInvalidOffsets()
+{
+    QByteArray data = buildFrame();
+    // 第一张图像的结束偏移超过检测总数
+    const int jsonLength = static_cast<int>(qFromLittleEndian<quint32>(data.constData() + 8));
+    const int offsetsStart = DetectionFrameDecoder::HEADER_SIZE + ((jsonLength + 3) & ~3);
+    data[offsetsStart + 4] = char(7);
+
+    DetectionFrame frame;
+    qint64 frameSize = 0;
+    QString errorMsg;
+    QCOMPARE(DetectionFrameDecoder::decode(data, frame, frameSize, errorMsg),
+             DetectionFrameDecoder::Status::Invalid);
+}
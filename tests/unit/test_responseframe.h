@@ -0,0 +1,27 @@
+#ifndef TEST_RESPONSEFRAME_H
+#define TEST_RESPONSEFRAME_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/inference/responseframe.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief DetectionFrameDecoder 单元测试
+ */
+class TestResponseFrame : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 4; }
+
+private slots:
+    void testDecodeFrame();
+    void testIncompleteFrame();
+    void testLengthMismatch();
+    void testInvalidOffsets();
+};
+
+#endif // TEST_RESPONSEFRAME_H
@@ -0,0 +1,153 @@
+/**
+ * @file test_tiledexecutor.cpp
+ * @brief TiledExecutor 单元测试实现
+ */
+
+#include "test_tiledexecutor.h"
+#include "services/image/cannydetector.h"
+#include "services/image/convolution.h"
+#include "services/image/gaussianblur.h"
+#include "services/image/imageenhancer.h"
+#include "services/image/medianfilter.h"
+#include <QRandomGenerator>
+#include <QThread>
+#include <QtMath>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+QImage makeScene(int width, int height, QImage::Format format)
+{
+    QRandomGenerator rng(13);
+    QImage image(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int base = 120 + static_cast<int>(80 * qSin(x * 0.05) * qCos(y * 0.04));
+            const int block = ((x / 37 + y / 29) % 2) * 50;
+            line[x] = qRgba(qBound(0, base + block + rng.bounded(15), 255),
+                            qBound(0, base - block + rng.bounded(15), 255),
+                            (x * 3 + y) % 256, 255 - (x + y) % 64);
+        }
+    }
+    return image.convertToFormat(format);
+}
+
+// 依次执行各类按行带并行的运算，结果拼接为一组图像
+QVector<QImage> runOperations(const QImage &image)
+{
+    const QVector<QVector<int>> dense = {{1, 2, 0, -1, 3},
+                                         {0, 1, 4, 1, 0},
+                                         {2, -3, 1, 0, 1},
+                                         {1, 0, 2, 1, -1},
+                                         {0, 1, 0, 3, 1}};
+    ConvolutionOptions options;
+    options.scale = 1.0f / 12;
+
+    QVector<QImage> results;
+    results.append(ConvolutionEngine::convolve(image, ConvolutionKernel::fromMatrix(dense), options));
+    results.append(ConvolutionEngine::gradientMagnitude(image, ConvolutionEngine::sobelX(),
+                                                        ConvolutionEngine::sobelY()));
+    results.append(GaussianBlur::blur(image, 3.5));
+    results.append(MedianFilter::apply(image, 11));
+    results.append(CannyDetector::detect(image, 60, 150));
+    results.append(ImageEnhancer::apply(image, 10, 20, 30, 40));
+    return results;
+}
+
+} // namespace
+
+void TestTiledExecutor::cleanup()
+{
+    TiledExecutor::setThreadCount(0);
+}
+
+void TestTiledExecutor::testVisitsEveryIndexOnce()
+{
+    for (int threads : {1, 3, 8}) {
+        TiledExecutor::setThreadCount(threads);
+        QCOMPARE(TiledExecutor::threadCount(), threads);
+
+        for (int count : {0, 1, 5, 997}) {
+            std::vector<std::atomic<int>> visits(static_cast<size_t>(count));
+            TiledExecutor::forEachIndex(count, [&](int index) { ++visits[index]; });
+            for (int i = 0; i < count; ++i) {
+                QCOMPARE(visits[i].load(), 1);
+            }
+        }
+
+        // 行带覆盖 [0, height) 且互不重叠
+        std::vector<std::atomic<int>> rows(203);
+        std::atomic<int> tallest{0};
+        TiledExecutor::forEachRowBand(203, 16, [&](int y0, int y1) {
+            tallest = qMax(tallest.load(), y1 - y0);
+            for (int y = y0; y < y1; ++y) {
+                ++rows[y];
+            }
+        });
+        QCOMPARE(tallest.load(), 16);
+        for (const std::atomic<int> &row : rows) {
+            QCOMPARE(row.load(), 1);
+        }
+    }
+
+    TiledExecutor::setThreadCount(0);
+    QCOMPARE(TiledExecutor::threadCount(), qMax(1, QThread::idealThreadCount()));
+}
+
+void TestTiledExecutor::testNestedCalls()
+{
+    // 池线程中再次调用也必须完成（调用线程自身参与，不依赖空闲的池线程）
+    TiledExecutor::setThreadCount(4);
+    std::atomic<int> total{0};
+    TiledExecutor::forEachIndex(16, [&](int) {
+        TiledExecutor::forEachIndex(50, [&](int) { ++total; });
+    });
+    QCOMPARE(total.load(), 16 * 50);
+}
+
+void TestTiledExecutor::testResultsIndependentOfThreadCount()
+{
+    // 高度不是行带高度的整数倍，覆盖最后一个不完整的行带和行带间的重叠区域
+    const QImage color = makeScene(157, 211, QImage::Format_ARGB32);
+    const QImage gray = makeScene(157, 211, QImage::Format_Grayscale8);
+
+    TiledExecutor::setThreadCount(1);
+    const QVector<QImage> serialColor = runOperations(color);
+    const QVector<QImage> serialGray = runOperations(gray);
+
+    for (int threads : {2, 5, 16}) {
+        TiledExecutor::setThreadCount(threads);
+        const QVector<QImage> parallelColor = runOperations(color);
+        const QVector<QImage> parallelGray = runOperations(gray);
+        for (int i = 0; i < serialColor.size(); ++i) {
+            QVERIFY2(parallelColor[i] == serialColor[i], qPrintable(QString("color op %1").arg(i)));
+            QVERIFY2(parallelGray[i] == serialGray[i], qPrintable(QString("gray op %1").arg(i)));
+        }
+    }
+}
+
+void TestTiledExecutor::benchmarkEdgeDetectScaling_data()
+{
+    QTest::addColumn<int>("threads");
+    for (int threads = 1; threads < QThread::idealThreadCount(); threads *= 2) {
+        QTest::newRow(qPrintable(QString("%1 threads").arg(threads))) << threads;
+    }
+    QTest::newRow(qPrintable(QString("%1 threads").arg(QThread::idealThreadCount())))
+        << QThread::idealThreadCount();
+}
+
+void TestTiledExecutor::benchmarkEdgeDetectScaling()
+{
+    QFETCH(int, threads);
+    const QImage image = makeScene(6000, 4000, QImage::Format_Grayscale8);
+    TiledExecutor::setThreadCount(threads);
+
+    // 各行数据的耗时之比即为对应线程数的加速比
+    QBENCHMARK {
+        ConvolutionEngine::gradientMagnitude(image, ConvolutionEngine::sobelX(),
+                                             ConvolutionEngine::sobelY());
+        CannyDetector::detect(image, 60, 150);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_TILEDEXECUTOR_H
+#define TEST_TILEDEXECUTOR_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/tiledexecutor.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief TiledExecutor 单元测试
+ */
+class TestTiledExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 4; }
+
+private slots:
+    void cleanup();
+
+    void testVisitsEveryIndexOnce();
+    void testNestedCalls();
+    void testResultsIndependentOfThreadCount();
+    void benchmarkEdgeDetectScaling_data();
+    void benchmarkEdgeDetectScaling();
+};
+
+#endif // TEST_TILEDEXECUTOR_H
@@ -0,0 +1,227 @@
+/**
+ * @file test_tiledimage.cpp
+ * @brief TiledImage 单元测试实现
+ */
+
+#include "test_tiledimage.h"
+#include "services/image/imageprocessservice.h"
+#include "services/image/imagepyramid.h"
+#include "services/inference/inferenceresultcache.h"
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+namespace {
+
+QImage makeImage(int width, int height, QImage::Format format = QImage::Format_RGB32)
+{
+    QRandomGenerator rng(53);
+    QImage image(width, height, format);
+    for (int y = 0; y < height; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int noise = static_cast<int>(rng.bounded(32));
+            line[x] = qRgba((x + noise) & 0xff, (y * 2 + noise) & 0xff, ((x ^ y) + noise) & 0xff,
+                            format == QImage::Format_ARGB32 ? (x * 7) & 0xff : 255);
+        }
+    }
+    return image;
+}
+
+constexpr int TILE = TiledImage::TILE_SIZE;
+
+} // namespace
+
+void TestTiledImage::testRoundTrip()
+{
+    // 尺寸不是块大小的整数倍，边缘块不完整
+    for (QImage::Format format : {QImage::Format_RGB32, QImage::Format_ARGB32}) {
+        const QImage image = makeImage(3 * TILE + 41, 2 * TILE + 7, format);
+        const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+        QVERIFY(tiled);
+        QCOMPARE(tiled->format(), format);
+        QCOMPARE(tiled->columns(), 4);
+        QCOMPARE(tiled->rows(), 3);
+        QCOMPARE(tiled->tileRect(3, 2), QRect(3 * TILE, 2 * TILE, 41, 7));
+
+        QCOMPARE(tiled->toImage(), image);
+        QCOMPARE(tiled->tile(1, 2), image.copy(TILE, 2 * TILE, TILE, 7));
+
+        // 跨越多个块的区域，超出图像的部分被裁掉
+        const QRect area(TILE - 30, TILE / 2, 2 * TILE, 2 * TILE);
+        QCOMPARE(tiled->region(area), image.copy(area & image.rect()));
+    }
+}
+
+void TestTiledImage::testWriteRegion()
+{
+    // 宽度超过 OVERVIEW_SIZE，缩略图至少缩小一级
+    const QImage image = makeImage(TiledImage::OVERVIEW_SIZE + TILE + 30, 2 * TILE + 10);
+    const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+    QVERIFY(tiled);
+
+    // 缩略图按 2 的幂缩小到不超过 OVERVIEW_SIZE，与整幅缩小一致
+    QImage expectedOverview = image;
+    double scale = 1.0;
+    while (expectedOverview.width() > TiledImage::OVERVIEW_SIZE
+           || expectedOverview.height() > TiledImage::OVERVIEW_SIZE) {
+        expectedOverview = ImagePyramid::halve(expectedOverview);
+        scale /= 2;
+    }
+    QVERIFY(scale < 1.0);
+    QCOMPARE(tiled->overviewScale(), scale);
+    QCOMPARE(tiled->overview(), expectedOverview);
+
+    const qint64 key = tiled->cacheKey();
+    const QImage patch = makeImage(300, 200);
+    const QPoint topLeft(TILE - 100, 2 * TILE - 50);
+    tiled->writeRegion(topLeft, patch);
+    QVERIFY(tiled->cacheKey() != key);
+
+    QImage expected = image;
+    for (int y = 0; y < patch.height(); ++y) {
+        for (int x = 0; x < patch.width(); ++x) {
+            expected.setPixel(topLeft.x() + x, topLeft.y() + y, patch.pixel(x, y));
+        }
+    }
+    QCOMPARE(tiled->toImage(), expected);
+
+    // 缩略图随写入的块更新
+    QImage reduced = expected;
+    while (reduced.width() > TiledImage::OVERVIEW_SIZE || reduced.height() > TiledImage::OVERVIEW_SIZE) {
+        reduced = ImagePyramid::halve(reduced);
+    }
+    QCOMPARE(tiled->overview(), reduced);
+
+    // 超出图像的部分被忽略
+    const int right = tiled->width() - 10;
+    tiled->writeRegion(QPoint(right, -10), patch);
+    QCOMPARE(tiled->region(QRect(right, 0, 10, 10)), patch.copy(0, 10, 10, 10));
+}
+
+void TestTiledImage::testResidentTileLimit()
+{
+    const QImage image = makeImage(6 * TILE, 5 * TILE);
+    const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+    QVERIFY(tiled);
+    QVERIFY(tiled->residentTiles() <= TiledImage::DEFAULT_RESIDENT_TILES);
+
+    tiled->setResidentTileLimit(4);
+    QVERIFY(tiled->residentTiles() <= tiled->columns() * tiled->rows());
+
+    // 逐块读取整幅图像，映射的块数不超过上限，内容不受换出影响
+    for (int row = 0; row < tiled->rows(); ++row) {
+        for (int column = 0; column < tiled->columns(); ++column) {
+            QCOMPARE(tiled->tile(column, row), image.copy(tiled->tileRect(column, row)));
+            QVERIFY(tiled->residentTiles() <= 4);
+        }
+    }
+    QCOMPARE(tiled->toImage(), image);
+    QVERIFY(tiled->residentTiles() <= 4);
+}
+
+void TestTiledImage::testLoadFromFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("large.png");
+    const QImage image = makeImage(2 * TILE + 3, TILE + 90);
+    QVERIFY(image.save(path));
+
+    const std::shared_ptr<TiledImage> tiled = TiledImage::load(path);
+    QVERIFY(tiled);
+    QCOMPARE(tiled->toImage(), image);
+
+    QString errorMsg;
+    QVERIFY(!TiledImage::load(dir.filePath("missing.png"), &errorMsg));
+    QVERIFY(!errorMsg.isEmpty());
+
+    QVERIFY(!TiledImage::shouldTile(QSize(4000, 3000)));
+    QVERIFY(TiledImage::shouldTile(QSize(20000, 20000)));
+}
+
+void TestTiledImage::testProcessTiledMatchesWholeImage()
+{
+    // 宽高都跨越多组块，且不是块大小的整数倍
+    const int blockSize = ImageProcessService::BLOCK_TILES * TILE;
+    const QImage image = makeImage(blockSize + 173, blockSize + 61);
+    const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+    QVERIFY(tiled);
+
+    QVector<ProcessRequest> requests;
+    ProcessRequest enhance;
+    enhance.type = ProcessRequest::Type::Enhance;
+    enhance.contrast = 30;
+    enhance.sharpness = 50;
+    requests.append(enhance);
+
+    ProcessRequest blur;
+    blur.type = ProcessRequest::Type::Denoise;
+    blur.method = static_cast<int>(ImageProcessService::DenoiseMethod::Gaussian);
+    blur.kernelSize = 9;
+    blur.sigma = 2.0;
+    requests.append(blur);
+
+    ProcessRequest sobel;
+    sobel.type = ProcessRequest::Type::EdgeDetection;
+    sobel.method = static_cast<int>(ImageProcessService::EdgeMethod::Sobel);
+    requests.append(sobel);
+
+    // 非局部运算整幅处理
+    ProcessRequest canny = sobel;
+    canny.method = static_cast<int>(ImageProcessService::EdgeMethod::Canny);
+    requests.append(canny);
+
+    for (const ProcessRequest &request : requests) {
+        QVector<int> progress;
+        const std::shared_ptr<TiledImage> result = ImageProcessService::processTiled(
+            *tiled, request, [&progress](int percent) { progress.append(percent); });
+        QVERIFY(result);
+        QCOMPARE(result->size(), image.size());
+
+        const QImage whole = ImageProcessService::process(image, request);
+        QCOMPARE(result->toImage(), whole.convertToFormat(result->format()));
+        QVERIFY(!progress.isEmpty());
+        QCOMPARE(progress.last(), 100);
+    }
+}
+
+void TestTiledImage::testContentHashMatchesImage()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    InferenceResultCache cache(dir.path());
+
+    const QImage image = makeImage(2 * TILE + 5, 3 * TILE - 20);
+    const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+    QVERIFY(tiled);
+
+    // 逐行条计算的哈希与整幅图像相同，同一内容的结果缓存可以互相命中
+    const QString hash = cache.imageHash(*tiled);
+    QCOMPARE(hash, cache.imageHash(image));
+
+    // 写入后 cacheKey 改变，不会复用旧的哈希
+    QImage pixel(1, 1, QImage::Format_RGB32);
+    pixel.fill(image.pixel(TILE, TILE) ^ 0x00ffffffu);
+    tiled->writeRegion(QPoint(TILE, TILE), pixel);
+    QVERIFY(cache.imageHash(*tiled) != hash);
+}
+
+void TestTiledImage::testHalveMatchesImagePyramid()
+{
+    // 奇数宽高，边缘的 2x2 块不完整
+    for (QImage::Format format : {QImage::Format_RGB32, QImage::Format_ARGB32}) {
+        const QImage image = makeImage(4 * TILE + 77, 3 * TILE + 13, format);
+        const std::shared_ptr<TiledImage> tiled = TiledImage::fromImage(image);
+        QVERIFY(tiled);
+
+        const std::shared_ptr<TiledImage> half = TiledImage::halve(*tiled);
+        QVERIFY(half);
+        QCOMPARE(half->format(), format);
+        QCOMPARE(half->size(), QSize((image.width() + 1) / 2, (image.height() + 1) / 2));
+        QCOMPARE(half->toImage(), ImagePyramid::halve(image));
+
+        const std::shared_ptr<TiledImage> quarter = TiledImage::halve(*half);
+        QVERIFY(quarter);
+        QCOMPARE(quarter->toImage(), ImagePyramid::halve(ImagePyramid::halve(image)));
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_TILEDIMAGE_H
+#define TEST_TILEDIMAGE_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+#include "services/image/tiledimage.h"
+
+using namespace GenPreCVSystem::Utils;
+
+/**
+ * @brief TiledImage 单元测试
+ */
+class TestTiledImage : public QObject
+{
+    Q_OBJECT
+
+public:
+    int testCount() const { return 7; }
+
+private slots:
+    void testRoundTrip();
+    void testWriteRegion();
+    void testResidentTileLimit();
+    void testLoadFromFile();
+    void testProcessTiledMatchesWholeImage();
+    void testContentHashMatchesImage();
+    void testHalveMatchesImagePyramid();
+};
+
+#endif // TEST_TILEDIMAGE_H
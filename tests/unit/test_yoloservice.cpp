@@ -5,6 +5,8 @@
 
 #include "test_yoloservice.h"
 #include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QImage>
 #include <QDebug>
 
 void TestDLService::initTestCase()
@@ -101,3 +103,85 @@ void TestDLService::testServiceState()
 
     qDebug() << "✓ Service state test passed";
 }
+
+void TestDLService::testBatchResultCache()
+{
+    const QString python = QStandardPaths::findExecutable("python3");
+    if (python.isEmpty()) {
+        QSKIP("python3 not found");
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // 模拟后端：记录收到的命令，批量请求为每张图像返回一个检测框
+    const QString logPath = dir.filePath("commands.log");
+    const QString scriptPath = dir.filePath("fake_service.py");
+    QFile script(scriptPath);
+    QVERIFY(script.open(QIODevice::WriteOnly | QIODevice::Text));
+    script.write(QString(
+        "import json, sys\n"
+        "print(json.dumps({'success': True, 'data': {}}), flush=True)\n"
+        "for line in sys.stdin:\n"
+        "    request = json.loads(line)\n"
+        "    command = request.get('command')\n"
+        "    with open(%1, 'a') as log:\n"
+        "        log.write(command + '\\n')\n"
+        "    if command == 'exit':\n"
+        "        break\n"
+        "    response = {'success': True, 'message': 'ok', 'request_id': request.get('request_id')}\n"
+        "    if command.endswith('_batch'):\n"
+        "        box = {'x': 1, 'y': 2, 'width': 3, 'height': 4, 'confidence': 0.9, 'class_id': 0, 'label': 'a'}\n"
+        "        response['data'] = {'results': [{'success': True, 'data': {'detections': [box]}}\n"
+        "                                        for _ in request['images']]}\n"
+        "    print(json.dumps(response), flush=True)\n")
+        .arg(QString("r'%1'").arg(logPath)).toUtf8());
+    script.close();
+
+    const QString modelPath = dir.filePath("model.pt");
+    QFile model(modelPath);
+    QVERIFY(model.open(QIODevice::WriteOnly));
+    model.write("fake model");
+    model.close();
+
+    QVector<InferenceImage> images;
+    for (int i = 0; i < 3; ++i) {
+        QImage image(16, 16, QImage::Format_RGB32);
+        image.fill(qRgb(i * 40, 0, 0));
+        const QString path = dir.filePath(QString("image%1.png").arg(i));
+        QVERIFY(image.save(path));
+        images.append(InferenceImage(path));
+    }
+
+    QStandardPaths::setTestModeEnabled(true);
+    DLService service;
+    QVERIFY(service.start(python, scriptPath));
+    QVERIFY(service.loadModel(modelPath));
+    service.clearResultCache();
+
+    auto batchRequests = [&logPath]() {
+        QFile log(logPath);
+        if (!log.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return 0;
+        }
+        return QString::fromUtf8(log.readAll()).split('\n').count("detect_batch");
+    };
+
+    const QVector<DetectionResult> first = service.detectBatch(images);
+    QCOMPARE(batchRequests(), 1);
+
+    // 相同图像、模型和参数的第二次批量请求全部命中缓存，不再发送给后端
+    const QVector<DetectionResult> second = service.detectBatch(images);
+    QCOMPARE(batchRequests(), 1);
+    QCOMPARE(second.size(), first.size());
+    for (int i = 0; i < second.size(); ++i) {
+        QVERIFY(second[i].success);
+        QCOMPARE(second[i].detections.size(), first[i].detections.size());
+    }
+
+    service.clearResultCache();
+    service.stop();
+    QStandardPaths::setTestModeEnabled(false);
+
+    qDebug() << "✓ Batch result cache test passed";
+}
@@ -15,7 +15,7 @@ class TestDLService : public QObject
     Q_OBJECT
 
 public:
-    int testCount() const { return 6; }
+    int testCount() const { return 7; }
 
 private slots:
     void initTestCase();
@@ -28,6 +28,7 @@ private slots:
     void testFastStartCheck();
     void testModelOperations();
     void testServiceState();
+    void testBatchResultCache();
 };
 
 #endif // TEST_DLSERVICE_H